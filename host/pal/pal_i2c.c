@@ -0,0 +1,179 @@
+/******************************************************************************
+* File Name:   pal_i2c.c
+*
+* Description: I2C abstraction of the host build, with the bus model of the
+*              simulated chip.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "optiga/pal/pal_i2c.h"
+#include "pal_i2c_sim.h"
+
+/** @brief Bits per transferred byte, including the acknowledge */
+#define PAL_I2C_SIM_BITS_PER_BYTE               (9U)
+
+/**
+ * @brief Bytes added to each frame: slave and register address, data link header and checksum,
+ * network layer header and the I2C state polling of the IFX I2C protocol
+ */
+#define PAL_I2C_SIM_FRAME_OVERHEAD              (16U)
+/** @brief Largest frame payload before the IFX I2C protocol fragments the APDU */
+#define PAL_I2C_SIM_FRAME_PAYLOAD               (0x110U)
+/** @brief APDU header of command (Cmd, Param, Length) and response (Sta, UnDef, Length) */
+#define PAL_I2C_SIM_APDU_HEADER                 (4U)
+/** @brief Bytes added to each direction by the shielded connection (SCTR, sequence number, MAC) */
+#define PAL_I2C_SIM_SHIELDED_OVERHEAD           (13U)
+
+/**
+ * The simulator sits at the optiga_crypt/optiga_util API level, so no frame ever reaches
+ * the I2C PAL and the command and communication layers of the library do not run on the
+ * host. Transfers fail to make any unexpected use visible. The simulator hands each command
+ * to pal_i2c_sim_exchange instead, where the bus time is computed from the frames the
+ * library would send at the bitrate set here, and where the bus and chip time are counted.
+ */
+
+static pthread_mutex_t pal_i2c_sim_mutex = PTHREAD_MUTEX_INITIALIZER;
+static uint16_t pal_i2c_sim_khz = PAL_I2C_SIM_DEFAULT_KHZ;
+static pal_i2c_sim_stats_t pal_i2c_sim_stats;
+
+pal_status_t pal_i2c_init(const pal_i2c_t * p_i2c_context)
+{
+    (void)p_i2c_context;
+    return (PAL_STATUS_SUCCESS);
+}
+
+pal_status_t pal_i2c_deinit(const pal_i2c_t * p_i2c_context)
+{
+    (void)p_i2c_context;
+    return (PAL_STATUS_SUCCESS);
+}
+
+pal_status_t pal_i2c_write(const pal_i2c_t * p_i2c_context, uint8_t * p_data, uint16_t length)
+{
+    (void)p_i2c_context;
+    (void)p_data;
+    (void)length;
+    return (PAL_STATUS_FAILURE);
+}
+
+pal_status_t pal_i2c_read(const pal_i2c_t * p_i2c_context, uint8_t * p_data, uint16_t length)
+{
+    (void)p_i2c_context;
+    (void)p_data;
+    (void)length;
+    return (PAL_STATUS_FAILURE);
+}
+
+pal_status_t pal_i2c_set_bitrate(const pal_i2c_t * p_i2c_context, uint16_t bitrate)
+{
+    (void)p_i2c_context;
+    if (0U == bitrate)
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    pthread_mutex_lock(&pal_i2c_sim_mutex);
+    pal_i2c_sim_khz = bitrate;
+    pthread_mutex_unlock(&pal_i2c_sim_mutex);
+    return (PAL_STATUS_SUCCESS);
+}
+
+/**
+ * Bytes on the bus for an APDU of the given payload length, including the fragmentation into frames.
+ * Must be called with the state locked.
+ */
+static uint32_t pal_i2c_sim_transfer(uint32_t payload_length, bool_t shielded)
+{
+    uint32_t length = payload_length + PAL_I2C_SIM_APDU_HEADER;
+    uint32_t frames;
+
+    if (TRUE == shielded)
+    {
+        length += PAL_I2C_SIM_SHIELDED_OVERHEAD;
+    }
+    frames = (length + PAL_I2C_SIM_FRAME_PAYLOAD - 1U) / PAL_I2C_SIM_FRAME_PAYLOAD;
+    pal_i2c_sim_stats.frames += frames;
+
+    return (length + (frames * PAL_I2C_SIM_FRAME_OVERHEAD));
+}
+
+uint32_t pal_i2c_sim_exchange(uint32_t command_length, uint32_t response_length, bool_t shielded, uint32_t chip_us)
+{
+    uint32_t written;
+    uint32_t read;
+    uint32_t bus_us;
+
+    pthread_mutex_lock(&pal_i2c_sim_mutex);
+    written = pal_i2c_sim_transfer(command_length, shielded);
+    read = pal_i2c_sim_transfer(response_length, shielded);
+    bus_us = (uint32_t)((((uint64_t)written + read) * PAL_I2C_SIM_BITS_PER_BYTE * 1000U) / pal_i2c_sim_khz);
+
+    pal_i2c_sim_stats.exchanges++;
+    pal_i2c_sim_stats.bytes_written += written;
+    pal_i2c_sim_stats.bytes_read += read;
+    pal_i2c_sim_stats.bus_us += bus_us;
+    pal_i2c_sim_stats.chip_us += chip_us;
+    pthread_mutex_unlock(&pal_i2c_sim_mutex);
+
+    return (bus_us + chip_us);
+}
+
+void pal_i2c_sim_get_stats(pal_i2c_sim_stats_t * p_stats)
+{
+    pthread_mutex_lock(&pal_i2c_sim_mutex);
+    *p_stats = pal_i2c_sim_stats;
+    pthread_mutex_unlock(&pal_i2c_sim_mutex);
+}
+
+void pal_i2c_sim_print_stats(void)
+{
+    pal_i2c_sim_stats_t stats;
+
+    if (NULL == getenv(PAL_I2C_SIM_STATS_ENV))
+    {
+        return;
+    }
+    pal_i2c_sim_get_stats(&stats);
+    fprintf(stderr, "exchanges,frames,bytes_written,bytes_read,bus_us,chip_us\n%lu,%lu,%llu,%llu,%llu,%llu\n",
+            (unsigned long)stats.exchanges, (unsigned long)stats.frames,
+            (unsigned long long)stats.bytes_written, (unsigned long long)stats.bytes_read,
+            (unsigned long long)stats.bus_us, (unsigned long long)stats.chip_us);
+}
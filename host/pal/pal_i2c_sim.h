@@ -0,0 +1,105 @@
+/******************************************************************************
+* File Name:   pal_i2c_sim.h
+*
+* Description: Bus model and statistics of the I2C PAL of the host build.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef _PAL_I2C_SIM_H_
+#define _PAL_I2C_SIM_H_
+
+#include "optiga/common/optiga_lib_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Environment variable which, when set, makes pal_deinit print the bus statistics to stderr */
+#define PAL_I2C_SIM_STATS_ENV                   "OPTIGA_SIM_I2C_STATS"
+
+/** @brief Default I2C clock, as configured by the IFX I2C protocol, in kHz */
+#define PAL_I2C_SIM_DEFAULT_KHZ                 (400U)
+
+/** @brief What the I2C PAL saw of the commands of the simulated chip since the start */
+typedef struct pal_i2c_sim_stats
+{
+    /// Commands exchanged, each a command APDU written and a response APDU read
+    uint32_t exchanges;
+    /// IFX I2C frames the APDUs were split into
+    uint32_t frames;
+    /// Bytes on the bus, frame overhead included
+    uint64_t bytes_written;
+    uint64_t bytes_read;
+    /// Time the bus transferred the frames, in microseconds
+    uint64_t bus_us;
+    /// Time the host polled the chip while it executed the commands, in microseconds
+    uint64_t chip_us;
+} pal_i2c_sim_stats_t;
+
+/**
+ * \brief Accounts one command of the simulated chip as the I2C PAL would see it on the kit.
+ *
+ * \details
+ * The command APDU is written in frames, the chip is polled while it executes, and the response APDU
+ * is read in frames. The frame overhead of the IFX I2C protocol and of the shielded connection record
+ * are added here, the APDU payloads are given by the simulator.
+ *
+ * \param[in] command_length    Payload of the command APDU
+ * \param[in] response_length   Payload of the response APDU, 0 for a failing command
+ * \param[in] shielded          TRUE if both APDUs are protected by the shielded connection
+ * \param[in] chip_us           Execution time of the chip, from the latency model of the simulator
+ *
+ * \return Time of the whole exchange, in microseconds
+ */
+uint32_t pal_i2c_sim_exchange(uint32_t command_length, uint32_t response_length, bool_t shielded, uint32_t chip_us);
+
+/**
+ * \brief Copies the statistics of the exchanges since the start.
+ */
+void pal_i2c_sim_get_stats(pal_i2c_sim_stats_t * p_stats);
+
+/**
+ * \brief Prints the statistics to stderr if #PAL_I2C_SIM_STATS_ENV is set.
+ */
+void pal_i2c_sim_print_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PAL_I2C_SIM_H_ */
@@ -0,0 +1,88 @@
+/******************************************************************************
+* File Name:   pal_logger.c
+*
+* Description: Logger abstraction of the host build, backed by stdin and stdout.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "optiga/pal/pal_logger.h"
+
+/**
+ * Console logger of the host build: the shell reads commands from stdin and all the
+ * library and example logs go to stdout.
+ */
+pal_logger_t logger_console =
+{
+    .logger_config_ptr = NULL,
+    .logger_rx_flag = 1,
+    .logger_tx_flag = 1
+};
+
+pal_status_t pal_logger_init(void * p_logger_context)
+{
+    (void)p_logger_context;
+    return (PAL_STATUS_SUCCESS);
+}
+
+pal_status_t pal_logger_deinit(void * p_logger_context)
+{
+    (void)p_logger_context;
+    return (PAL_STATUS_SUCCESS);
+}
+
+pal_status_t pal_logger_write(void * p_logger_context, const uint8_t * p_log_data, uint32_t log_data_length)
+{
+    (void)p_logger_context;
+    if (log_data_length != fwrite(p_log_data, 1U, log_data_length, stdout))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    (void)fflush(stdout);
+    return (PAL_STATUS_SUCCESS);
+}
+
+pal_status_t pal_logger_read(void * p_logger_context, uint8_t * p_log_data, uint32_t log_data_length)
+{
+    (void)p_logger_context;
+    if (log_data_length != fread(p_log_data, 1U, log_data_length, stdin))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    return (PAL_STATUS_SUCCESS);
+}
@@ -0,0 +1,181 @@
+/******************************************************************************
+* File Name:   pal_os_datastore.c
+*
+* Description: Datastore abstraction of the host build, backed by a file.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "optiga/pal/pal_os_datastore.h"
+
+#define PAL_OS_DATASTORE_RECORDS        (8U)
+#define PAL_OS_DATASTORE_RECORD_SIZE    (512U)
+#define PAL_OS_DATASTORE_DEFAULT_FILE   "optiga_host_datastore.bin"
+
+/**
+ * RAM copy of the datastore, mirrored to a file so that the pairing with the simulated
+ * OPTIGA survives a restart of the shell, like the flash backed store of the MCU ports.
+ * The platform binding secret is empty until the pairing example runs.
+ */
+typedef struct pal_os_datastore_record
+{
+    uint16_t datastore_id;
+    uint16_t length;
+    uint8_t data[PAL_OS_DATASTORE_RECORD_SIZE];
+} pal_os_datastore_record_t;
+
+static pal_os_datastore_record_t pal_os_datastore_records[PAL_OS_DATASTORE_RECORDS];
+static bool_t pal_os_datastore_loaded = FALSE;
+
+static const char_t * pal_os_datastore_file(void)
+{
+    const char_t * file_name = getenv("OPTIGA_HOST_DATASTORE");
+
+    return ((NULL == file_name) ? PAL_OS_DATASTORE_DEFAULT_FILE : file_name);
+}
+
+static void pal_os_datastore_load(void)
+{
+    const char_t * file_name = pal_os_datastore_file();
+    FILE * file;
+
+    if (FALSE == pal_os_datastore_loaded)
+    {
+        pal_os_datastore_loaded = TRUE;
+        if ('\0' == file_name[0])
+        {
+            return;
+        }
+        file = fopen(file_name, "rb");
+        if (NULL != file)
+        {
+            if (1U != fread(pal_os_datastore_records, sizeof(pal_os_datastore_records), 1U, file))
+            {
+                memset(pal_os_datastore_records, 0, sizeof(pal_os_datastore_records));
+            }
+            (void)fclose(file);
+        }
+    }
+}
+
+static void pal_os_datastore_save(void)
+{
+    const char_t * file_name = pal_os_datastore_file();
+    FILE * file;
+
+    if ('\0' != file_name[0])
+    {
+        file = fopen(file_name, "wb");
+        if (NULL != file)
+        {
+            (void)fwrite(pal_os_datastore_records, sizeof(pal_os_datastore_records), 1U, file);
+            (void)fclose(file);
+        }
+    }
+}
+
+static pal_os_datastore_record_t * pal_os_datastore_find(uint16_t datastore_id, bool_t create)
+{
+    pal_os_datastore_record_t * free_record = NULL;
+    uint8_t index;
+
+    pal_os_datastore_load();
+    for (index = 0; index < PAL_OS_DATASTORE_RECORDS; index++)
+    {
+        if ((0U != pal_os_datastore_records[index].length) &&
+            (datastore_id == pal_os_datastore_records[index].datastore_id))
+        {
+            return (&pal_os_datastore_records[index]);
+        }
+        if ((NULL == free_record) && (0U == pal_os_datastore_records[index].length))
+        {
+            free_record = &pal_os_datastore_records[index];
+        }
+    }
+    return ((TRUE == create) ? free_record : NULL);
+}
+
+pal_status_t pal_os_datastore_write(uint16_t datastore_id, const uint8_t * p_buffer, uint16_t length)
+{
+    pal_status_t return_status = PAL_STATUS_FAILURE;
+    pal_os_datastore_record_t * record;
+
+    do
+    {
+        if ((NULL == p_buffer) || (0U == length) || (length > PAL_OS_DATASTORE_RECORD_SIZE))
+        {
+            break;
+        }
+        record = pal_os_datastore_find(datastore_id, TRUE);
+        if (NULL == record)
+        {
+            break;
+        }
+        record->datastore_id = datastore_id;
+        record->length = length;
+        memcpy(record->data, p_buffer, length);
+        pal_os_datastore_save();
+        return_status = PAL_STATUS_SUCCESS;
+    } while (FALSE);
+    return (return_status);
+}
+
+pal_status_t pal_os_datastore_read(uint16_t datastore_id, uint8_t * p_buffer, uint16_t * p_buffer_length)
+{
+    pal_status_t return_status = PAL_STATUS_FAILURE;
+    pal_os_datastore_record_t * record;
+
+    do
+    {
+        if ((NULL == p_buffer) || (NULL == p_buffer_length))
+        {
+            break;
+        }
+        record = pal_os_datastore_find(datastore_id, FALSE);
+        if ((NULL == record) || (*p_buffer_length < record->length))
+        {
+            break;
+        }
+        memcpy(p_buffer, record->data, record->length);
+        *p_buffer_length = record->length;
+        return_status = PAL_STATUS_SUCCESS;
+    } while (FALSE);
+    return (return_status);
+}
@@ -0,0 +1,177 @@
+/******************************************************************************
+* File Name:   pal_os_event.c
+*
+* Description: Event abstraction of the host build. The registered callbacks are
+*              invoked from a timer thread after the requested delay.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include "optiga/pal/pal_os_event.h"
+#include "optiga_shell_wait.h"
+
+/**
+ * The event callbacks run in a dedicated thread, which plays the role of the timer interrupt
+ * of the MCU ports: the main context sleeps until the thread notifies it after a callback.
+ */
+static pal_os_event_t pal_os_event_0 = {0};
+
+static pthread_mutex_t pal_os_event_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pal_os_event_condition;
+static pthread_once_t pal_os_event_once = PTHREAD_ONCE_INIT;
+static pthread_t pal_os_event_thread;
+static struct timespec pal_os_event_deadline;
+
+static register_callback pal_os_event_take_callback(void ** callback_args)
+{
+    register_callback callback = pal_os_event_0.callbacks;
+
+    *callback_args = pal_os_event_0.callback_ctx;
+    pal_os_event_0.callbacks = NULL;
+    pal_os_event_0.callback_ctx = NULL;
+    return (callback);
+}
+
+static void * pal_os_event_timer_thread(void * context)
+{
+    register_callback callback;
+    void * callback_args;
+    int wait_status;
+
+    (void)context;
+    pthread_mutex_lock(&pal_os_event_mutex);
+    for (;;)
+    {
+        if (NULL == pal_os_event_0.callbacks)
+        {
+            (void)pthread_cond_wait(&pal_os_event_condition, &pal_os_event_mutex);
+            continue;
+        }
+        wait_status = pthread_cond_timedwait(&pal_os_event_condition, &pal_os_event_mutex, &pal_os_event_deadline);
+        if ((ETIMEDOUT != wait_status) || (NULL == pal_os_event_0.callbacks))
+        {
+            /* Registration changed, evaluate the new deadline */
+            continue;
+        }
+        callback = pal_os_event_take_callback(&callback_args);
+        pthread_mutex_unlock(&pal_os_event_mutex);
+        callback(callback_args);
+        optiga_shell_wait_notify();
+        pthread_mutex_lock(&pal_os_event_mutex);
+    }
+    return (NULL);
+}
+
+static void pal_os_event_init(void)
+{
+    pthread_condattr_t attributes;
+
+    (void)pthread_condattr_init(&attributes);
+    (void)pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    (void)pthread_cond_init(&pal_os_event_condition, &attributes);
+    (void)pthread_condattr_destroy(&attributes);
+    (void)pthread_create(&pal_os_event_thread, NULL, pal_os_event_timer_thread, NULL);
+    (void)pthread_detach(pal_os_event_thread);
+}
+
+pal_os_event_t * pal_os_event_create(register_callback callback, void * callback_args)
+{
+    (void)pthread_once(&pal_os_event_once, pal_os_event_init);
+    if ((NULL != callback) && (NULL != callback_args))
+    {
+        pal_os_event_start(&pal_os_event_0, callback, callback_args);
+    }
+    return (&pal_os_event_0);
+}
+
+void pal_os_event_destroy(pal_os_event_t * pal_os_event)
+{
+    (void)pal_os_event;
+}
+
+void pal_os_event_start(pal_os_event_t * p_pal_os_event, register_callback callback, void * callback_args)
+{
+    if (FALSE == p_pal_os_event->is_event_triggered)
+    {
+        p_pal_os_event->is_event_triggered = TRUE;
+        pal_os_event_register_callback_oneshot(p_pal_os_event, callback, callback_args, 1000);
+    }
+}
+
+void pal_os_event_stop(pal_os_event_t * p_pal_os_event)
+{
+    p_pal_os_event->is_event_triggered = FALSE;
+}
+
+void pal_os_event_register_callback_oneshot(pal_os_event_t * p_pal_os_event,
+                                            register_callback callback,
+                                            void * callback_args,
+                                            uint32_t time_us)
+{
+    (void)pthread_once(&pal_os_event_once, pal_os_event_init);
+    pthread_mutex_lock(&pal_os_event_mutex);
+    p_pal_os_event->callbacks = callback;
+    p_pal_os_event->callback_ctx = callback_args;
+    (void)clock_gettime(CLOCK_MONOTONIC, &pal_os_event_deadline);
+    pal_os_event_deadline.tv_sec += (time_t)(time_us / 1000000U);
+    pal_os_event_deadline.tv_nsec += (long)(time_us % 1000000U) * 1000L;
+    if (pal_os_event_deadline.tv_nsec >= 1000000000L)
+    {
+        pal_os_event_deadline.tv_sec++;
+        pal_os_event_deadline.tv_nsec -= 1000000000L;
+    }
+    (void)pthread_cond_signal(&pal_os_event_condition);
+    pthread_mutex_unlock(&pal_os_event_mutex);
+}
+
+void pal_os_event_trigger_registered_callback(void)
+{
+    register_callback callback;
+    void * callback_args;
+
+    pthread_mutex_lock(&pal_os_event_mutex);
+    callback = pal_os_event_take_callback(&callback_args);
+    pthread_mutex_unlock(&pal_os_event_mutex);
+    if (NULL != callback)
+    {
+        callback(callback_args);
+        optiga_shell_wait_notify();
+    }
+}
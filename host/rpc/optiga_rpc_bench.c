@@ -0,0 +1,258 @@
+/******************************************************************************
+* File Name:   optiga_rpc_bench.c
+*
+* Description: Throughput benchmark of the binary RPC against the text mode
+*              of the OPTIGA shell
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "optiga_rpc_client.h"
+
+#define OPTIGA_RPC_BENCH_DEFAULT_ITERATIONS (100U)
+#define OPTIGA_RPC_BENCH_DEFAULT_SHELL      "build/optiga_shell"
+#define OPTIGA_RPC_BENCH_KEY_OID            (0xE0F0U)
+#define OPTIGA_RPC_BENCH_PING_TIMEOUT_MS    (3000U)
+#define OPTIGA_RPC_BENCH_PING_ATTEMPTS      (3U)
+
+/** @brief One benchmarked operation, in text mode by shell command and in binary mode by RPC */
+typedef struct optiga_rpc_bench_case
+{
+    const char * name;
+    const char * text_command;
+    optiga_rpc_client_result_t (*binary_call)(optiga_rpc_client_t * client);
+} optiga_rpc_bench_case_t;
+
+static const uint8_t optiga_rpc_bench_data[] = "OPTIGA(TM) Trust M binary RPC benchmark data";
+static const uint8_t optiga_rpc_bench_digest[32] =
+{
+    0x61, 0xC7, 0xDE, 0xF9, 0x0F, 0xD5, 0xCD, 0x7A, 0x8B, 0x7A, 0x36, 0x41, 0x04, 0xE0, 0x0D, 0x82,
+    0x38, 0x46, 0xBF, 0xB7, 0x70, 0xEE, 0xBF, 0x8F, 0x40, 0x25, 0x2E, 0x0A, 0x21, 0x42, 0xAF, 0x9C,
+};
+
+static optiga_rpc_client_result_t optiga_rpc_bench_random(optiga_rpc_client_t * client)
+{
+    uint8_t random[32];
+
+    return (optiga_rpc_client_get_random(client, random, sizeof(random)));
+}
+
+static optiga_rpc_client_result_t optiga_rpc_bench_hash(optiga_rpc_client_t * client)
+{
+    uint8_t digest[32];
+
+    return (optiga_rpc_client_hash_sha256(client, optiga_rpc_bench_data, sizeof(optiga_rpc_bench_data), digest));
+}
+
+static optiga_rpc_client_result_t optiga_rpc_bench_sign(optiga_rpc_client_t * client)
+{
+    uint8_t signature[80];
+    uint32_t signature_length = sizeof(signature);
+
+    return (optiga_rpc_client_ecdsa_sign(client, OPTIGA_RPC_BENCH_KEY_OID, optiga_rpc_bench_digest,
+                                         sizeof(optiga_rpc_bench_digest), signature, &signature_length));
+}
+
+static const optiga_rpc_bench_case_t optiga_rpc_bench_cases[] =
+{
+    {"random (32 bytes)",   "random",       optiga_rpc_bench_random},
+    {"sha-256",             "hashsha256",   optiga_rpc_bench_hash},
+    {"ecdsa sign p-256",    "ecdsasign",    optiga_rpc_bench_sign},
+};
+
+static double optiga_rpc_bench_now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((double)now.tv_sec + ((double)now.tv_nsec / 1e9));
+}
+
+/** @brief UART time of the bytes exchanged per operation, 10 bit times per byte (8N1) */
+static uint32_t optiga_rpc_bench_baudrate = 115200;
+
+static void optiga_rpc_bench_report(const char * name,
+                                    const char * mode,
+                                    uint32_t iterations,
+                                    double seconds,
+                                    uint64_t bytes_sent,
+                                    uint64_t bytes_received)
+{
+    double sent = (double)bytes_sent / iterations;
+    double received = (double)bytes_received / iterations;
+
+    printf("%-20s %-7s %10.1f %10.2f %10.1f %10.1f %10.2f\n",
+           name, mode, iterations / seconds, (seconds * 1000.0) / iterations, sent, received,
+           ((sent > received) ? sent : received) * 10.0 * 1000.0 / optiga_rpc_bench_baudrate);
+}
+
+static int optiga_rpc_bench_run(optiga_rpc_client_t * client,
+                                const optiga_rpc_bench_case_t * bench_case,
+                                uint32_t iterations,
+                                int binary)
+{
+    uint64_t bytes_sent = client->bytes_sent;
+    uint64_t bytes_received = client->bytes_received;
+    optiga_rpc_client_result_t result = OPTIGA_RPC_CLIENT_SUCCESS;
+    double start = optiga_rpc_bench_now();
+    uint32_t index;
+
+    for (index = 0; (index < iterations) && (OPTIGA_RPC_CLIENT_SUCCESS == result); index++)
+    {
+        result = (0 != binary) ? bench_case->binary_call(client) :
+                                 optiga_rpc_client_text_command(client, bench_case->text_command);
+    }
+    if (OPTIGA_RPC_CLIENT_SUCCESS != result)
+    {
+        fprintf(stderr, "%s (%s) failed: %d, status 0x%04X\n",
+                bench_case->name, (0 != binary) ? "binary" : "text", (int)result, client->status);
+        return (-1);
+    }
+    optiga_rpc_bench_report(bench_case->name, (0 != binary) ? "binary" : "text", iterations,
+                            optiga_rpc_bench_now() - start,
+                            client->bytes_sent - bytes_sent, client->bytes_received - bytes_received);
+    return (0);
+}
+
+static void optiga_rpc_bench_usage(const char * program)
+{
+    fprintf(stderr,
+            "Usage: %s [--serial <device> [--baud <baudrate>] | --exec <shell>] [--iterations <n>]\n"
+            "Compares the text shell and the binary RPC of the OPTIGA shell. The uart ms column is\n"
+            "the time the bytes of one operation take on a full duplex UART at --baud (115200).\n"
+            "Without --serial the host build (%s) is started.\n",
+            program, OPTIGA_RPC_BENCH_DEFAULT_SHELL);
+}
+
+int main(int argc, char * argv[])
+{
+    optiga_rpc_client_t client;
+    optiga_rpc_client_result_t result;
+    const char * serial = NULL;
+    const char * shell = OPTIGA_RPC_BENCH_DEFAULT_SHELL;
+    uint32_t iterations = OPTIGA_RPC_BENCH_DEFAULT_ITERATIONS;
+    uint32_t timeout_ms;
+    uint32_t index;
+    int argument;
+    int exit_code = EXIT_SUCCESS;
+
+    for (argument = 1; argument < argc; argument++)
+    {
+        if ((0 == strcmp(argv[argument], "--serial")) && ((argument + 1) < argc))
+        {
+            serial = argv[++argument];
+        }
+        else if ((0 == strcmp(argv[argument], "--baud")) && ((argument + 1) < argc))
+        {
+            optiga_rpc_bench_baudrate = (uint32_t)strtoul(argv[++argument], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[argument], "--exec")) && ((argument + 1) < argc))
+        {
+            shell = argv[++argument];
+        }
+        else if ((0 == strcmp(argv[argument], "--iterations")) && ((argument + 1) < argc))
+        {
+            iterations = (uint32_t)strtoul(argv[++argument], NULL, 0);
+        }
+        else
+        {
+            optiga_rpc_bench_usage(argv[0]);
+            return (EXIT_FAILURE);
+        }
+    }
+    if ((0U == iterations) || (0U == optiga_rpc_bench_baudrate))
+    {
+        optiga_rpc_bench_usage(argv[0]);
+        return (EXIT_FAILURE);
+    }
+
+    result = (NULL != serial) ? optiga_rpc_client_open_serial(&client, serial, optiga_rpc_bench_baudrate) :
+                                optiga_rpc_client_open_process(&client, shell);
+    if (OPTIGA_RPC_CLIENT_SUCCESS != result)
+    {
+        perror((NULL != serial) ? serial : shell);
+        return (EXIT_FAILURE);
+    }
+
+    do
+    {
+        /*
+         * After reset the shell on the kit waits for a key press, which takes the first byte
+         * sent. Retry the ping until the shell answers.
+         */
+        timeout_ms = client.timeout_ms;
+        client.timeout_ms = OPTIGA_RPC_BENCH_PING_TIMEOUT_MS;
+        for (index = 0; index < OPTIGA_RPC_BENCH_PING_ATTEMPTS; index++)
+        {
+            result = optiga_rpc_client_call(&client, OPTIGA_SHELL_RPC_PING, NULL, 0, NULL, NULL);
+            if (OPTIGA_RPC_CLIENT_ERROR_TIMEOUT != result)
+            {
+                break;
+            }
+        }
+        client.timeout_ms = timeout_ms;
+        if (OPTIGA_RPC_CLIENT_SUCCESS == result)
+        {
+            result = optiga_rpc_client_run_command(&client, "init");
+        }
+        if (OPTIGA_RPC_CLIENT_SUCCESS != result)
+        {
+            fprintf(stderr, "Initializing OPTIGA failed: %d, status 0x%04X\n", (int)result, client.status);
+            exit_code = EXIT_FAILURE;
+            break;
+        }
+
+        printf("%-20s %-7s %10s %10s %10s %10s %10s\n",
+               "operation", "mode", "ops/s", "ms/op", "tx B/op", "rx B/op", "uart ms");
+        for (index = 0; index < (sizeof(optiga_rpc_bench_cases) / sizeof(optiga_rpc_bench_cases[0])); index++)
+        {
+            if ((0 != optiga_rpc_bench_run(&client, &optiga_rpc_bench_cases[index], iterations, 0)) ||
+                (0 != optiga_rpc_bench_run(&client, &optiga_rpc_bench_cases[index], iterations, 1)))
+            {
+                exit_code = EXIT_FAILURE;
+                break;
+            }
+        }
+    } while (0);
+
+    optiga_rpc_client_close(&client);
+    return (exit_code);
+}
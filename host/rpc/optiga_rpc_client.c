@@ -0,0 +1,570 @@
+/******************************************************************************
+* File Name:   optiga_rpc_client.c
+*
+* Description: Linux client of the binary RPC of the OPTIGA shell, over a serial
+*              port or the pipes of a host build process
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "optiga_rpc_client.h"
+
+#define OPTIGA_RPC_CLIENT_DEFAULT_TIMEOUT_MS    (30000U)
+#define OPTIGA_RPC_CLIENT_TEXT_PREFIX           "optiga --"
+#define OPTIGA_RPC_CLIENT_TEXT_PROMPT           ">>>"
+/** The shell prints a prompt before and after the output of a command */
+#define OPTIGA_RPC_CLIENT_TEXT_PROMPTS          (2U)
+
+static void optiga_rpc_client_reset(optiga_rpc_client_t * client)
+{
+    memset(client, 0, sizeof(*client));
+    client->rx_fd = -1;
+    client->tx_fd = -1;
+    client->child = -1;
+    client->timeout_ms = OPTIGA_RPC_CLIENT_DEFAULT_TIMEOUT_MS;
+}
+
+static uint64_t optiga_rpc_client_now_ms(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (((uint64_t)now.tv_sec * 1000U) + ((uint64_t)now.tv_nsec / 1000000U));
+}
+
+static speed_t optiga_rpc_client_speed(uint32_t baudrate)
+{
+    switch (baudrate)
+    {
+        case 9600: return (B9600);
+        case 19200: return (B19200);
+        case 38400: return (B38400);
+        case 57600: return (B57600);
+        case 115200: return (B115200);
+        case 230400: return (B230400);
+        case 460800: return (B460800);
+        case 921600: return (B921600);
+        case 1000000: return (B1000000);
+        default: return (B0);
+    }
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_open_serial(optiga_rpc_client_t * client,
+                                                         const char * device,
+                                                         uint32_t baudrate)
+{
+    struct termios settings;
+    speed_t speed = optiga_rpc_client_speed(baudrate);
+    int fd;
+
+    optiga_rpc_client_reset(client);
+    if (B0 == speed)
+    {
+        return (OPTIGA_RPC_CLIENT_ERROR_INVALID_INPUT);
+    }
+    fd = open(device, O_RDWR | O_NOCTTY | O_CLOEXEC);
+    if (0 > fd)
+    {
+        return (OPTIGA_RPC_CLIENT_ERROR_IO);
+    }
+    if (0 != tcgetattr(fd, &settings))
+    {
+        close(fd);
+        return (OPTIGA_RPC_CLIENT_ERROR_IO);
+    }
+    cfmakeraw(&settings);
+    settings.c_cflag |= (CLOCAL | CREAD);
+    settings.c_cflag &= ~(CSTOPB | CRTSCTS);
+    cfsetispeed(&settings, speed);
+    cfsetospeed(&settings, speed);
+    if (0 != tcsetattr(fd, TCSANOW, &settings))
+    {
+        close(fd);
+        return (OPTIGA_RPC_CLIENT_ERROR_IO);
+    }
+    tcflush(fd, TCIOFLUSH);
+    client->rx_fd = fd;
+    client->tx_fd = fd;
+    return (OPTIGA_RPC_CLIENT_SUCCESS);
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_open_process(optiga_rpc_client_t * client, const char * path)
+{
+    int to_child[2];
+    int from_child[2];
+    pid_t child;
+
+    optiga_rpc_client_reset(client);
+    if (0 != pipe(to_child))
+    {
+        return (OPTIGA_RPC_CLIENT_ERROR_IO);
+    }
+    if (0 != pipe(from_child))
+    {
+        close(to_child[0]);
+        close(to_child[1]);
+        return (OPTIGA_RPC_CLIENT_ERROR_IO);
+    }
+    child = fork();
+    if (0 > child)
+    {
+        close(to_child[0]);
+        close(to_child[1]);
+        close(from_child[0]);
+        close(from_child[1]);
+        return (OPTIGA_RPC_CLIENT_ERROR_IO);
+    }
+    if (0 == child)
+    {
+        dup2(to_child[0], STDIN_FILENO);
+        dup2(from_child[1], STDOUT_FILENO);
+        close(to_child[0]);
+        close(to_child[1]);
+        close(from_child[0]);
+        close(from_child[1]);
+        execl(path, path, (char *)NULL);
+        _exit(127);
+    }
+    close(to_child[0]);
+    close(from_child[1]);
+    client->tx_fd = to_child[1];
+    client->rx_fd = from_child[0];
+    client->child = child;
+    return (OPTIGA_RPC_CLIENT_SUCCESS);
+}
+
+void optiga_rpc_client_close(optiga_rpc_client_t * client)
+{
+    if (client->tx_fd != client->rx_fd)
+    {
+        close(client->tx_fd);
+    }
+    close(client->rx_fd);
+    if (0 < client->child)
+    {
+        /*
+         * Closing stdin ends the shell, give it the chance to store the simulated chip state
+         */
+        if (0 == waitpid(client->child, NULL, WNOHANG))
+        {
+            sleep(1);
+            if (0 == waitpid(client->child, NULL, WNOHANG))
+            {
+                kill(client->child, SIGTERM);
+                waitpid(client->child, NULL, 0);
+            }
+        }
+    }
+    optiga_rpc_client_reset(client);
+}
+
+static optiga_rpc_client_result_t optiga_rpc_client_write(optiga_rpc_client_t * client,
+                                                          const uint8_t * data,
+                                                          uint32_t length)
+{
+    ssize_t written;
+
+    while (0U < length)
+    {
+        written = write(client->tx_fd, data, length);
+        if (0 > written)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            return (OPTIGA_RPC_CLIENT_ERROR_IO);
+        }
+        client->bytes_sent += (uint64_t)written;
+        data += written;
+        length -= (uint32_t)written;
+    }
+    return (OPTIGA_RPC_CLIENT_SUCCESS);
+}
+
+/**
+ * Reads whatever is available, waiting at most until the deadline
+ */
+static optiga_rpc_client_result_t optiga_rpc_client_read(optiga_rpc_client_t * client,
+                                                         uint8_t * data,
+                                                         uint32_t size,
+                                                         uint32_t * received,
+                                                         uint64_t deadline_ms)
+{
+    struct pollfd descriptor = { .fd = client->rx_fd, .events = POLLIN };
+    uint64_t now_ms = optiga_rpc_client_now_ms();
+    ssize_t read_length;
+    int ready;
+
+    if (now_ms >= deadline_ms)
+    {
+        return (OPTIGA_RPC_CLIENT_ERROR_TIMEOUT);
+    }
+    ready = poll(&descriptor, 1, (int)(deadline_ms - now_ms));
+    if (0 == ready)
+    {
+        return (OPTIGA_RPC_CLIENT_ERROR_TIMEOUT);
+    }
+    if (0 > ready)
+    {
+        return ((EINTR == errno) ? optiga_rpc_client_read(client, data, size, received, deadline_ms) :
+                                   OPTIGA_RPC_CLIENT_ERROR_IO);
+    }
+    read_length = read(client->rx_fd, data, size);
+    if (0 >= read_length)
+    {
+        /*
+         * The process exited or the serial port vanished
+         */
+        return (OPTIGA_RPC_CLIENT_ERROR_IO);
+    }
+    client->bytes_received += (uint64_t)read_length;
+    *received = (uint32_t)read_length;
+    return (OPTIGA_RPC_CLIENT_SUCCESS);
+}
+
+/**
+ * Waits for the response frame of the given request. Text and frames of other requests are skipped.
+ */
+static optiga_rpc_client_result_t optiga_rpc_client_receive(optiga_rpc_client_t * client,
+                                                            uint8_t sequence,
+                                                            uint8_t operation,
+                                                            uint8_t * response,
+                                                            uint32_t * response_length)
+{
+    uint64_t deadline_ms = optiga_rpc_client_now_ms() + client->timeout_ms;
+    uint8_t chunk[256];
+    uint32_t received = 0;
+    uint32_t index;
+    uint32_t message_length;
+    uint32_t payload_length;
+    uint8_t * message = client->frame;
+    optiga_rpc_client_result_t result;
+    int in_frame = 0;
+
+    client->frame_length = 0;
+    for (;;)
+    {
+        result = optiga_rpc_client_read(client, chunk, sizeof(chunk), &received, deadline_ms);
+        if (OPTIGA_RPC_CLIENT_SUCCESS != result)
+        {
+            return (result);
+        }
+        for (index = 0; index < received; index++)
+        {
+            if (OPTIGA_SHELL_RPC_FRAME_DELIMITER != chunk[index])
+            {
+                if ((0 != in_frame) && (sizeof(client->frame) > client->frame_length))
+                {
+                    client->frame[client->frame_length++] = chunk[index];
+                }
+                continue;
+            }
+            if ((0 == in_frame) || (0U == client->frame_length))
+            {
+                in_frame = 1;
+                continue;
+            }
+            in_frame = 0;
+            message_length = optiga_shell_rpc_cobs_decode(message, client->frame_length, message);
+            client->frame_length = 0;
+            if (((OPTIGA_SHELL_RPC_RESPONSE_HEADER_LENGTH + OPTIGA_SHELL_RPC_CRC_LENGTH) > message_length) ||
+                (optiga_shell_rpc_crc16(message, message_length - OPTIGA_SHELL_RPC_CRC_LENGTH) !=
+                 (uint16_t)((message[message_length - 2U] << 8) | message[message_length - 1U])))
+            {
+                continue;
+            }
+            client->status = (uint16_t)((message[2] << 8) | message[3]);
+            if ((0U == message[0]) && (0U == message[1]) &&
+                (OPTIGA_SHELL_RPC_ERROR_INVALID_FRAME == client->status))
+            {
+                /*
+                 * The shell could not read the request
+                 */
+                return (OPTIGA_RPC_CLIENT_ERROR_PROTOCOL);
+            }
+            if ((sequence != message[0]) || ((operation | OPTIGA_SHELL_RPC_RESPONSE) != message[1]))
+            {
+                continue;
+            }
+            payload_length = message_length - OPTIGA_SHELL_RPC_RESPONSE_HEADER_LENGTH - OPTIGA_SHELL_RPC_CRC_LENGTH;
+            if (NULL != response_length)
+            {
+                if (payload_length > *response_length)
+                {
+                    return (OPTIGA_RPC_CLIENT_ERROR_PROTOCOL);
+                }
+                memcpy(response, &message[OPTIGA_SHELL_RPC_RESPONSE_HEADER_LENGTH], payload_length);
+                *response_length = payload_length;
+            }
+            return ((0U == client->status) ? OPTIGA_RPC_CLIENT_SUCCESS : OPTIGA_RPC_CLIENT_ERROR_DEVICE);
+        }
+    }
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_call(optiga_rpc_client_t * client,
+                                                  uint8_t operation,
+                                                  const uint8_t * request,
+                                                  uint32_t request_length,
+                                                  uint8_t * response,
+                                                  uint32_t * response_length)
+{
+    uint8_t message[OPTIGA_SHELL_RPC_MAX_MESSAGE_LENGTH];
+    uint8_t frame[OPTIGA_SHELL_RPC_COBS_LENGTH(OPTIGA_SHELL_RPC_MAX_MESSAGE_LENGTH) + 2U];
+    uint32_t message_length = OPTIGA_SHELL_RPC_REQUEST_HEADER_LENGTH + request_length;
+    uint32_t frame_length;
+    uint16_t crc;
+    optiga_rpc_client_result_t result;
+
+    if (OPTIGA_SHELL_RPC_MAX_PAYLOAD_LENGTH < request_length)
+    {
+        return (OPTIGA_RPC_CLIENT_ERROR_INVALID_INPUT);
+    }
+    client->sequence = (uint8_t)((0xFFU == client->sequence) ? 1U : (client->sequence + 1U));
+    message[0] = client->sequence;
+    message[1] = operation;
+    if (0U != request_length)
+    {
+        memcpy(&message[OPTIGA_SHELL_RPC_REQUEST_HEADER_LENGTH], request, request_length);
+    }
+    crc = optiga_shell_rpc_crc16(message, message_length);
+    message[message_length++] = (uint8_t)(crc >> 8);
+    message[message_length++] = (uint8_t)crc;
+
+    frame[0] = OPTIGA_SHELL_RPC_FRAME_DELIMITER;
+    frame_length = optiga_shell_rpc_cobs_encode(message, message_length, &frame[1]) + 1U;
+    frame[frame_length++] = OPTIGA_SHELL_RPC_FRAME_DELIMITER;
+
+    result = optiga_rpc_client_write(client, frame, frame_length);
+    if (OPTIGA_RPC_CLIENT_SUCCESS != result)
+    {
+        return (result);
+    }
+    return (optiga_rpc_client_receive(client, client->sequence, operation, response, response_length));
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_run_command(optiga_rpc_client_t * client, const char * command)
+{
+    return (optiga_rpc_client_call(client, OPTIGA_SHELL_RPC_RUN_COMMAND,
+                                   (const uint8_t *)command, (uint32_t)strlen(command), NULL, NULL));
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_get_random(optiga_rpc_client_t * client,
+                                                        uint8_t * random,
+                                                        uint16_t length)
+{
+    uint8_t request[2] = { (uint8_t)(length >> 8), (uint8_t)length };
+    uint32_t response_length = length;
+    optiga_rpc_client_result_t result;
+
+    result = optiga_rpc_client_call(client, OPTIGA_SHELL_RPC_GET_RANDOM, request, sizeof(request),
+                                    random, &response_length);
+    if ((OPTIGA_RPC_CLIENT_SUCCESS == result) && (length != response_length))
+    {
+        result = OPTIGA_RPC_CLIENT_ERROR_PROTOCOL;
+    }
+    return (result);
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_hash_sha256(optiga_rpc_client_t * client,
+                                                         const uint8_t * data,
+                                                         uint32_t length,
+                                                         uint8_t digest[32])
+{
+    uint32_t digest_length = 32;
+    optiga_rpc_client_result_t result;
+
+    result = optiga_rpc_client_call(client, OPTIGA_SHELL_RPC_HASH_SHA256, data, length, digest, &digest_length);
+    if ((OPTIGA_RPC_CLIENT_SUCCESS == result) && (32U != digest_length))
+    {
+        result = OPTIGA_RPC_CLIENT_ERROR_PROTOCOL;
+    }
+    return (result);
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_ecc_generate_keypair(optiga_rpc_client_t * client,
+                                                                  uint8_t curve,
+                                                                  uint8_t key_usage,
+                                                                  uint16_t key_oid,
+                                                                  uint8_t * public_key,
+                                                                  uint32_t * public_key_length)
+{
+    uint8_t request[4] = { curve, key_usage, (uint8_t)(key_oid >> 8), (uint8_t)key_oid };
+
+    return (optiga_rpc_client_call(client, OPTIGA_SHELL_RPC_ECC_GENERATE_KEYPAIR, request, sizeof(request),
+                                   public_key, public_key_length));
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_ecdsa_sign(optiga_rpc_client_t * client,
+                                                        uint16_t key_oid,
+                                                        const uint8_t * digest,
+                                                        uint8_t digest_length,
+                                                        uint8_t * signature,
+                                                        uint32_t * signature_length)
+{
+    uint8_t request[2U + 0xFFU];
+
+    request[0] = (uint8_t)(key_oid >> 8);
+    request[1] = (uint8_t)key_oid;
+    memcpy(&request[2], digest, digest_length);
+    return (optiga_rpc_client_call(client, OPTIGA_SHELL_RPC_ECDSA_SIGN, request, 2U + digest_length,
+                                   signature, signature_length));
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_ecdsa_verify(optiga_rpc_client_t * client,
+                                                          uint8_t curve,
+                                                          const uint8_t * public_key,
+                                                          uint16_t public_key_length,
+                                                          const uint8_t * digest,
+                                                          uint8_t digest_length,
+                                                          const uint8_t * signature,
+                                                          uint16_t signature_length)
+{
+    uint8_t request[OPTIGA_SHELL_RPC_MAX_PAYLOAD_LENGTH];
+    uint32_t length = 0;
+
+    if ((4U + (uint32_t)public_key_length + digest_length + signature_length) > sizeof(request))
+    {
+        return (OPTIGA_RPC_CLIENT_ERROR_INVALID_INPUT);
+    }
+    request[length++] = curve;
+    request[length++] = (uint8_t)(public_key_length >> 8);
+    request[length++] = (uint8_t)public_key_length;
+    memcpy(&request[length], public_key, public_key_length);
+    length += public_key_length;
+    request[length++] = digest_length;
+    memcpy(&request[length], digest, digest_length);
+    length += digest_length;
+    memcpy(&request[length], signature, signature_length);
+    length += signature_length;
+    return (optiga_rpc_client_call(client, OPTIGA_SHELL_RPC_ECDSA_VERIFY, request, length, NULL, NULL));
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_read_data(optiga_rpc_client_t * client,
+                                                       uint16_t oid,
+                                                       uint16_t offset,
+                                                       uint8_t * data,
+                                                       uint32_t * length)
+{
+    uint16_t requested = (uint16_t)((OPTIGA_SHELL_RPC_MAX_PAYLOAD_LENGTH < *length) ?
+                                    OPTIGA_SHELL_RPC_MAX_PAYLOAD_LENGTH : *length);
+    uint8_t request[6] = { (uint8_t)(oid >> 8), (uint8_t)oid,
+                           (uint8_t)(offset >> 8), (uint8_t)offset,
+                           (uint8_t)(requested >> 8), (uint8_t)requested };
+
+    return (optiga_rpc_client_call(client, OPTIGA_SHELL_RPC_READ_DATA, request, sizeof(request), data, length));
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_write_data(optiga_rpc_client_t * client,
+                                                        uint16_t oid,
+                                                        uint8_t write_type,
+                                                        uint16_t offset,
+                                                        const uint8_t * data,
+                                                        uint32_t length)
+{
+    uint8_t request[OPTIGA_SHELL_RPC_MAX_PAYLOAD_LENGTH];
+
+    if ((5U + length) > sizeof(request))
+    {
+        return (OPTIGA_RPC_CLIENT_ERROR_INVALID_INPUT);
+    }
+    request[0] = (uint8_t)(oid >> 8);
+    request[1] = (uint8_t)oid;
+    request[2] = write_type;
+    request[3] = (uint8_t)(offset >> 8);
+    request[4] = (uint8_t)offset;
+    memcpy(&request[5], data, length);
+    return (optiga_rpc_client_call(client, OPTIGA_SHELL_RPC_WRITE_DATA, request, 5U + length, NULL, NULL));
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_read_metadata(optiga_rpc_client_t * client,
+                                                           uint16_t oid,
+                                                           uint8_t * metadata,
+                                                           uint32_t * length)
+{
+    uint8_t request[2] = { (uint8_t)(oid >> 8), (uint8_t)oid };
+
+    return (optiga_rpc_client_call(client, OPTIGA_SHELL_RPC_READ_METADATA, request, sizeof(request),
+                                   metadata, length));
+}
+
+optiga_rpc_client_result_t optiga_rpc_client_text_command(optiga_rpc_client_t * client, const char * command)
+{
+    static const char prompt[] = OPTIGA_RPC_CLIENT_TEXT_PROMPT;
+    uint64_t deadline_ms = optiga_rpc_client_now_ms() + client->timeout_ms;
+    uint8_t chunk[256];
+    uint32_t received = 0;
+    uint32_t index;
+    uint32_t matched = 0;
+    uint32_t prompts = 0;
+    optiga_rpc_client_result_t result;
+
+    result = optiga_rpc_client_write(client, (const uint8_t *)OPTIGA_RPC_CLIENT_TEXT_PREFIX,
+                                     sizeof(OPTIGA_RPC_CLIENT_TEXT_PREFIX) - 1U);
+    if (OPTIGA_RPC_CLIENT_SUCCESS == result)
+    {
+        result = optiga_rpc_client_write(client, (const uint8_t *)command, (uint32_t)strlen(command));
+    }
+    if (OPTIGA_RPC_CLIENT_SUCCESS == result)
+    {
+        result = optiga_rpc_client_write(client, (const uint8_t *)"\r", 1U);
+    }
+    while ((OPTIGA_RPC_CLIENT_SUCCESS == result) && (OPTIGA_RPC_CLIENT_TEXT_PROMPTS > prompts))
+    {
+        result = optiga_rpc_client_read(client, chunk, sizeof(chunk), &received, deadline_ms);
+        for (index = 0; (OPTIGA_RPC_CLIENT_SUCCESS == result) && (index < received); index++)
+        {
+            matched = ((uint8_t)prompt[matched] == chunk[index]) ? (matched + 1U) :
+                      (((uint8_t)prompt[0] == chunk[index]) ? 1U : 0U);
+            if ((sizeof(prompt) - 1U) == matched)
+            {
+                matched = 0;
+                prompts++;
+            }
+        }
+    }
+    return (result);
+}
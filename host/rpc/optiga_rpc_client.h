@@ -0,0 +1,198 @@
+/******************************************************************************
+* File Name:   optiga_rpc_client.h
+*
+* Description: Linux client of the binary RPC of the OPTIGA shell
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_RPC_CLIENT_H_
+#define _OPTIGA_RPC_CLIENT_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "optiga_shell_rpc_frame.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Transport and protocol results of the client, device errors come as the status of a call */
+typedef enum optiga_rpc_client_result
+{
+    OPTIGA_RPC_CLIENT_SUCCESS = 0,
+    /** Opening, reading or writing the transport failed, see errno */
+    OPTIGA_RPC_CLIENT_ERROR_IO = -1,
+    /** No valid response within the timeout */
+    OPTIGA_RPC_CLIENT_ERROR_TIMEOUT = -2,
+    /** The response does not fit the response buffer or does not match the request */
+    OPTIGA_RPC_CLIENT_ERROR_PROTOCOL = -3,
+    /** The request payload exceeds OPTIGA_SHELL_RPC_MAX_PAYLOAD_LENGTH */
+    OPTIGA_RPC_CLIENT_ERROR_INVALID_INPUT = -4,
+    /** The call completed, the shell returned a status other than 0x0000 */
+    OPTIGA_RPC_CLIENT_ERROR_DEVICE = -5,
+} optiga_rpc_client_result_t;
+
+/** @brief Connection to the shell, over a serial port or to a host build process */
+typedef struct optiga_rpc_client
+{
+    int rx_fd;
+    int tx_fd;
+    pid_t child;
+    uint8_t sequence;
+    /** Time allowed for one call, in milliseconds */
+    uint32_t timeout_ms;
+    /** Status returned by the shell for the last call */
+    uint16_t status;
+    /** Bytes sent and received on the transport, text and frames */
+    uint64_t bytes_sent;
+    uint64_t bytes_received;
+    uint8_t frame[OPTIGA_SHELL_RPC_COBS_LENGTH(OPTIGA_SHELL_RPC_MAX_MESSAGE_LENGTH)];
+    uint32_t frame_length;
+} optiga_rpc_client_t;
+
+/**
+ * @brief Opens the serial port of the kit, raw 8N1 with the given baudrate (e.g. 115200).
+ */
+optiga_rpc_client_result_t optiga_rpc_client_open_serial(optiga_rpc_client_t * client,
+                                                         const char * device,
+                                                         uint32_t baudrate);
+
+/**
+ * @brief Starts the host build of the shell (host/build/optiga_shell) and talks to it
+ *        through its stdin and stdout.
+ */
+optiga_rpc_client_result_t optiga_rpc_client_open_process(optiga_rpc_client_t * client, const char * path);
+
+/**
+ * @brief Closes the transport, a started process is terminated.
+ */
+void optiga_rpc_client_close(optiga_rpc_client_t * client);
+
+/**
+ * @brief Sends one request and waits for its response. Text output of the shell in between is skipped.
+ *
+ * @param[in]     client           Connection
+ * @param[in]     operation        One of optiga_shell_rpc_operation_t
+ * @param[in]     request          Request payload, may be NULL if request_length is 0
+ * @param[in]     request_length   Length of the request payload
+ * @param[out]    response         Response payload, may be NULL if none is expected
+ * @param[in,out] response_length  Size of the response buffer on input, payload length on output
+ *
+ * @retval OPTIGA_RPC_CLIENT_SUCCESS       The shell returned status 0x0000
+ * @retval OPTIGA_RPC_CLIENT_ERROR_DEVICE  The shell returned another status, see client->status
+ * @retval others                          Transport or protocol failure
+ */
+optiga_rpc_client_result_t optiga_rpc_client_call(optiga_rpc_client_t * client,
+                                                  uint8_t operation,
+                                                  const uint8_t * request,
+                                                  uint32_t request_length,
+                                                  uint8_t * response,
+                                                  uint32_t * response_length);
+
+/** @brief Runs a shell command such as "init" */
+optiga_rpc_client_result_t optiga_rpc_client_run_command(optiga_rpc_client_t * client, const char * command);
+
+/** @brief Reads random bytes from the OPTIGA (up to 256) */
+optiga_rpc_client_result_t optiga_rpc_client_get_random(optiga_rpc_client_t * client,
+                                                        uint8_t * random,
+                                                        uint16_t length);
+
+/** @brief SHA-256 digest of the data, computed by the OPTIGA */
+optiga_rpc_client_result_t optiga_rpc_client_hash_sha256(optiga_rpc_client_t * client,
+                                                         const uint8_t * data,
+                                                         uint32_t length,
+                                                         uint8_t digest[32]);
+
+/** @brief Generates an ECC key pair in a key OID and returns the public key */
+optiga_rpc_client_result_t optiga_rpc_client_ecc_generate_keypair(optiga_rpc_client_t * client,
+                                                                  uint8_t curve,
+                                                                  uint8_t key_usage,
+                                                                  uint16_t key_oid,
+                                                                  uint8_t * public_key,
+                                                                  uint32_t * public_key_length);
+
+/** @brief Signs a digest with the private key in a key OID, the signature is DER encoded */
+optiga_rpc_client_result_t optiga_rpc_client_ecdsa_sign(optiga_rpc_client_t * client,
+                                                        uint16_t key_oid,
+                                                        const uint8_t * digest,
+                                                        uint8_t digest_length,
+                                                        uint8_t * signature,
+                                                        uint32_t * signature_length);
+
+/** @brief Verifies a DER encoded signature with a public key of the host */
+optiga_rpc_client_result_t optiga_rpc_client_ecdsa_verify(optiga_rpc_client_t * client,
+                                                          uint8_t curve,
+                                                          const uint8_t * public_key,
+                                                          uint16_t public_key_length,
+                                                          const uint8_t * digest,
+                                                          uint8_t digest_length,
+                                                          const uint8_t * signature,
+                                                          uint16_t signature_length);
+
+/** @brief Reads a data object */
+optiga_rpc_client_result_t optiga_rpc_client_read_data(optiga_rpc_client_t * client,
+                                                       uint16_t oid,
+                                                       uint16_t offset,
+                                                       uint8_t * data,
+                                                       uint32_t * length);
+
+/** @brief Writes a data object, write_type is OPTIGA_UTIL_WRITE_ONLY (0x00) or OPTIGA_UTIL_ERASE_AND_WRITE (0x40) */
+optiga_rpc_client_result_t optiga_rpc_client_write_data(optiga_rpc_client_t * client,
+                                                        uint16_t oid,
+                                                        uint8_t write_type,
+                                                        uint16_t offset,
+                                                        const uint8_t * data,
+                                                        uint32_t length);
+
+/** @brief Reads the metadata of a data object */
+optiga_rpc_client_result_t optiga_rpc_client_read_metadata(optiga_rpc_client_t * client,
+                                                           uint16_t oid,
+                                                           uint8_t * metadata,
+                                                           uint32_t * length);
+
+/**
+ * @brief Text mode: sends "optiga --<command>" and waits until the shell prompt follows the
+ *        command output. Used to compare the binary RPC against the text shell.
+ */
+optiga_rpc_client_result_t optiga_rpc_client_text_command(optiga_rpc_client_t * client, const char * command);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_RPC_CLIENT_H_ */
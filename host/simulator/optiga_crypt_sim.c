@@ -0,0 +1,2121 @@
+/******************************************************************************
+* File Name:   optiga_crypt_sim.c
+*
+* Description: This file implements the optiga_crypt API of the OPTIGA Trust M host
+*              library on top of the host side simulator. Every request is executed
+*              synchronously and completes through the registered callback.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "optiga/optiga_crypt.h"
+#include "optiga_sim.h"
+
+#define OPTIGA_CRYPT_SIM_AES_BLOCK_SIZE         (16U)
+#define OPTIGA_CRYPT_SIM_SHA256_LENGTH          (32U)
+#define OPTIGA_CRYPT_SIM_MAX_DIGEST_LENGTH      (64U)
+#define OPTIGA_CRYPT_SIM_ECC_PRIVATE_KEY_SIZE   (256U)
+#define OPTIGA_CRYPT_SIM_RSA_PRIVATE_KEY_SIZE   (1300U)
+#define OPTIGA_CRYPT_SIM_MAX_RANDOM_LENGTH      (256U)
+#define OPTIGA_CRYPT_SIM_MIN_RANDOM_LENGTH      (8U)
+#define OPTIGA_CRYPT_SIM_MAX_DERIVED_LENGTH     (256U)
+
+/** @brief Tag and length preceding each parameter of a command or response APDU */
+#define OPTIGA_CRYPT_SIM_TLV_HEADER             (3U)
+/** @brief Parameter referencing a data object: OID and, for data to hash, offset and length */
+#define OPTIGA_CRYPT_SIM_OID_REFERENCE_LENGTH   (6U)
+
+/** @brief Simulated crypt instance. The public optiga_crypt_t must stay the first member. */
+typedef struct optiga_crypt_sim
+{
+    optiga_crypt_t crypt;
+    optiga_sim_instance_t sim;
+    /// HMAC started by #optiga_crypt_hmac_start
+    void * hmac_context;
+    /// Symmetric operation started by optiga_crypt_symmetric_xxxx_start
+    bool_t symmetric_active;
+    bool_t symmetric_encrypt;
+    uint8_t symmetric_mode;
+    uint16_t symmetric_key_oid;
+    uint8_t symmetric_iv[OPTIGA_CRYPT_SIM_AES_BLOCK_SIZE];
+    uint8_t * symmetric_data;
+    uint32_t symmetric_data_length;
+} optiga_crypt_sim_t;
+
+static optiga_lib_status_t optiga_crypt_sim_begin(optiga_crypt_sim_t * me,
+                                                  uint8_t command,
+                                                  optiga_lib_status_t * status)
+{
+    *status = optiga_sim_begin(&me->sim, command, TRUE);
+    return ((OPTIGA_LIB_BUSY == *status) ? OPTIGA_CRYPT_ERROR_INSTANCE_IN_USE : OPTIGA_LIB_SUCCESS);
+}
+
+static bool_t optiga_crypt_sim_is_session(uint16_t oid)
+{
+    return (bool_t)((OPTIGA_KEY_ID_SESSION_BASED == oid) ||
+                    ((oid >= OPTIGA_SIM_SESSION_OID_BASE) && (oid < (OPTIGA_SIM_SESSION_OID_BASE + OPTIGA_SIM_SESSION_CONTEXTS))));
+}
+
+/**
+ * Looks up the object used by a command and evaluates its access condition
+ */
+static optiga_lib_status_t optiga_crypt_sim_get_object(optiga_crypt_sim_t * me,
+                                                       uint16_t oid,
+                                                       uint8_t access_tag,
+                                                       optiga_sim_object_t ** object)
+{
+    if (TRUE == optiga_crypt_sim_is_session(oid))
+    {
+        *object = optiga_sim_get_session(&me->sim);
+        return ((NULL != *object) ? OPTIGA_LIB_SUCCESS :
+                                    OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_COMMAND_OUT_OF_SEQUENCE));
+    }
+    *object = optiga_sim_find_object(oid);
+    if (NULL == *object)
+    {
+        return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_OID));
+    }
+    return (optiga_sim_check_access(*object, access_tag, &me->sim));
+}
+
+/**
+ * Looks up a key for execution, which must hold the expected kind of key
+ */
+static optiga_lib_status_t optiga_crypt_sim_get_key(optiga_crypt_sim_t * me,
+                                                    uint16_t oid,
+                                                    uint8_t content,
+                                                    optiga_sim_object_t ** key)
+{
+    const uint8_t * algorithm;
+    uint8_t algorithm_length;
+    optiga_lib_status_t status = optiga_crypt_sim_get_object(me, oid, OPTIGA_SIM_TAG_EXECUTE, key);
+
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if ((content != (*key)->content) || (0 == (*key)->length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        /* The execution time depends on the curve or key size of the key */
+        algorithm = optiga_sim_get_metadata_tag(*key, OPTIGA_SIM_TAG_ALGORITHM, &algorithm_length);
+        if (NULL != algorithm)
+        {
+            optiga_sim_set_variant(&me->sim, algorithm[0]);
+        }
+    } while (FALSE);
+    return (status);
+}
+
+/**
+ * Looks up a secret (session context or data object of the expected data object type)
+ */
+static optiga_lib_status_t optiga_crypt_sim_get_secret(optiga_crypt_sim_t * me,
+                                                       uint16_t oid,
+                                                       uint8_t data_object_type,
+                                                       optiga_sim_object_t ** secret)
+{
+    const uint8_t * type;
+    uint8_t type_length;
+    optiga_lib_status_t status = optiga_crypt_sim_get_object(me, oid, OPTIGA_SIM_TAG_EXECUTE, secret);
+
+    do
+    {
+        if ((OPTIGA_LIB_SUCCESS != status) || (TRUE == optiga_crypt_sim_is_session(oid)))
+        {
+            break;
+        }
+        type = optiga_sim_get_metadata_tag(*secret, OPTIGA_SIM_TAG_DATA_OBJECT_TYPE, &type_length);
+        if ((NULL == type) || (data_object_type != type[0]) || (0 == (*secret)->length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+        }
+    } while (FALSE);
+
+    return (status);
+}
+
+/**
+ * Stores a generated key into the target key object (or the session context)
+ */
+static optiga_lib_status_t optiga_crypt_sim_store_key(optiga_crypt_sim_t * me,
+                                                      optiga_key_id_t * key_id,
+                                                      uint8_t content,
+                                                      uint8_t algorithm,
+                                                      uint8_t key_usage,
+                                                      const uint8_t * key,
+                                                      uint16_t key_length)
+{
+    optiga_sim_object_t * object;
+    optiga_lib_status_t status = OPTIGA_LIB_SUCCESS;
+
+    do
+    {
+        if (TRUE == optiga_crypt_sim_is_session((uint16_t)*key_id))
+        {
+            object = optiga_sim_acquire_session(&me->sim);
+            if (NULL == object)
+            {
+                status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INSUFFICIENT_MEMORY);
+                break;
+            }
+            *key_id = (optiga_key_id_t)object->oid;
+        }
+        else
+        {
+            object = optiga_sim_find_object((uint16_t)*key_id);
+            if ((NULL == object) || (OPTIGA_SIM_CONTENT_DATA == object->content))
+            {
+                status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_OID);
+                break;
+            }
+            status = optiga_sim_check_access(object, OPTIGA_SIM_TAG_CHANGE, &me->sim);
+            if (OPTIGA_LIB_SUCCESS != status)
+            {
+                break;
+            }
+        }
+        if (key_length > object->max_size)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_DATA_OBJECT_BOUNDARY);
+            break;
+        }
+        optiga_sim_set_object_content(object, content, key, key_length);
+        optiga_sim_set_metadata_tag(object, OPTIGA_SIM_TAG_ALGORITHM, &algorithm, 1);
+        if (FALSE == optiga_crypt_sim_is_session(object->oid))
+        {
+            optiga_sim_set_metadata_tag(object, OPTIGA_SIM_TAG_KEY_USAGE, &key_usage, 1);
+            optiga_sim_store();
+        }
+    } while (FALSE);
+
+    return (status);
+}
+
+/**
+ * Stores a derived or decrypted secret into the session context of the instance
+ */
+static optiga_lib_status_t optiga_crypt_sim_store_session_secret(optiga_crypt_sim_t * me,
+                                                                 const uint8_t * secret,
+                                                                 uint16_t secret_length)
+{
+    optiga_sim_object_t * session = optiga_sim_acquire_session(&me->sim);
+
+    if (NULL == session)
+    {
+        return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INSUFFICIENT_MEMORY));
+    }
+    optiga_sim_set_object_content(session, OPTIGA_SIM_CONTENT_SECRET, secret, secret_length);
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+/**
+ * Resolves the public key given either by the host or as certificate in a data object
+ */
+static optiga_lib_status_t optiga_crypt_sim_get_public_key(optiga_crypt_sim_t * me,
+                                                           uint8_t public_key_source_type,
+                                                           const void * public_key,
+                                                           uint8_t * buffer,
+                                                           uint16_t * buffer_length,
+                                                           uint8_t * key_type)
+{
+    const public_key_from_host_t * host_public_key;
+    optiga_sim_object_t * certificate;
+    optiga_lib_status_t status = OPTIGA_LIB_SUCCESS;
+
+    do
+    {
+        if (OPTIGA_CRYPT_HOST_DATA == public_key_source_type)
+        {
+            host_public_key = (const public_key_from_host_t *)public_key;
+            if (host_public_key->length > *buffer_length)
+            {
+                status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_LENGTH_FIELD);
+                break;
+            }
+            memcpy(buffer, host_public_key->public_key, host_public_key->length);
+            *buffer_length = host_public_key->length;
+            *key_type = host_public_key->key_type;
+            break;
+        }
+        status = optiga_crypt_sim_get_object(me, *(const uint16_t *)public_key, OPTIGA_SIM_TAG_READ, &certificate);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_certificate_public_key(certificate->data, certificate->length,
+                                                              buffer, buffer_length, key_type))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+        }
+    } while (FALSE);
+
+    return (status);
+}
+
+static uint8_t optiga_crypt_sim_digest_length(uint8_t type)
+{
+    switch (type)
+    {
+        case OPTIGA_HMAC_SHA_384: return 48;
+        case OPTIGA_HMAC_SHA_512: return 64;
+        default: return 32;
+    }
+}
+
+optiga_crypt_t * optiga_crypt_create(uint8_t optiga_instance_id,
+                                     callback_handler_t handler,
+                                     void * caller_context)
+{
+    optiga_crypt_sim_t * me = NULL;
+
+    (void)optiga_instance_id;
+    do
+    {
+        if (NULL == handler)
+        {
+            break;
+        }
+        me = (optiga_crypt_sim_t *)calloc(1, sizeof(optiga_crypt_sim_t));
+        if (NULL == me)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_register_instance(&me->sim, handler, caller_context))
+        {
+            free(me);
+            me = NULL;
+            break;
+        }
+        me->crypt.handler = handler;
+        me->crypt.caller_context = caller_context;
+    } while (FALSE);
+
+    return ((optiga_crypt_t *)me);
+}
+
+optiga_lib_status_t optiga_crypt_destroy(optiga_crypt_t * me)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+
+    if (NULL == me)
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    if (TRUE == p_sim->sim.busy)
+    {
+        return (OPTIGA_CRYPT_ERROR_INSTANCE_IN_USE);
+    }
+    optiga_sim_crypto_hmac_free(p_sim->hmac_context);
+    free(p_sim->symmetric_data);
+    optiga_sim_unregister_instance(&p_sim->sim);
+    free(p_sim);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+void optiga_crypt_set_comms_params(optiga_crypt_t * me,
+                                   uint8_t parameter_type,
+                                   uint8_t value)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+
+    if (NULL == me)
+    {
+        return;
+    }
+    if (OPTIGA_COMMS_PROTECTION_LEVEL == parameter_type)
+    {
+        p_sim->sim.protection_level = value;
+    }
+    else if (OPTIGA_COMMS_PROTOCOL_VERSION == parameter_type)
+    {
+        p_sim->sim.protocol_version = value;
+    }
+}
+
+optiga_lib_status_t optiga_crypt_random(optiga_crypt_t * me,
+                                        optiga_rng_type_t rng_type,
+                                        uint8_t * random_data,
+                                        uint16_t random_data_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == random_data))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_GET_RANDOM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if ((random_data_length < OPTIGA_CRYPT_SIM_MIN_RANDOM_LENGTH) ||
+            (random_data_length > OPTIGA_CRYPT_SIM_MAX_RANDOM_LENGTH) ||
+            ((OPTIGA_RNG_TYPE_TRNG != rng_type) && (OPTIGA_RNG_TYPE_DRNG != rng_type)))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, 2, random_data_length, random_data_length);
+        if (FALSE == optiga_sim_crypto_random(random_data, random_data_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INTERNAL_PROCESS);
+        }
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+/**
+ * Feeds the data to hash (from host or from a data object) into the SHA-256 context.
+ * The command carries the exported context when the hash is performed in several steps,
+ * response_length is the length of the returned context or digest.
+ */
+static optiga_lib_status_t optiga_crypt_sim_hash_data(optiga_crypt_sim_t * me,
+                                                      uint8_t * context,
+                                                      uint8_t source_of_data_to_hash,
+                                                      const void * data_to_hash,
+                                                      uint16_t context_length,
+                                                      uint16_t response_length)
+{
+    const hash_data_from_host_t * host_data;
+    const hash_data_in_optiga_t * optiga_data;
+    optiga_sim_object_t * object;
+    optiga_lib_status_t status = OPTIGA_LIB_SUCCESS;
+
+    if (OPTIGA_CRYPT_HOST_DATA == source_of_data_to_hash)
+    {
+        host_data = (const hash_data_from_host_t *)data_to_hash;
+        optiga_sim_crypto_sha256_update(context, host_data->buffer, host_data->length);
+        optiga_sim_set_transfer(&me->sim,
+                                OPTIGA_CRYPT_SIM_TLV_HEADER + host_data->length + context_length,
+                                response_length,
+                                host_data->length);
+        return (status);
+    }
+    optiga_data = (const hash_data_in_optiga_t *)data_to_hash;
+    optiga_sim_set_transfer(&me->sim,
+                            OPTIGA_CRYPT_SIM_TLV_HEADER + OPTIGA_CRYPT_SIM_OID_REFERENCE_LENGTH + context_length,
+                            response_length,
+                            optiga_data->length);
+    status = optiga_crypt_sim_get_object(me, optiga_data->oid, OPTIGA_SIM_TAG_READ, &object);
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        if ((optiga_data->offset + optiga_data->length) > object->length)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_DATA_OBJECT_BOUNDARY);
+        }
+        else
+        {
+            optiga_sim_crypto_sha256_update(context, &object->data[optiga_data->offset], optiga_data->length);
+        }
+    }
+    return (status);
+}
+
+optiga_lib_status_t optiga_crypt_hash(optiga_crypt_t * me,
+                                      optiga_hash_type_t hash_algorithm,
+                                      uint8_t source_of_data_to_hash,
+                                      const void * data_to_hash,
+                                      uint8_t * hash_output)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    uint8_t context[OPTIGA_HASH_CONTEXT_LENGTH_SHA_256];
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == data_to_hash) || (NULL == hash_output))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_CALC_HASH, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (OPTIGA_HASH_TYPE_SHA_256 != hash_algorithm)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_crypto_sha256_start(context);
+        status = optiga_crypt_sim_hash_data(p_sim, context, source_of_data_to_hash, data_to_hash,
+                                            0, OPTIGA_CRYPT_SIM_TLV_HEADER + OPTIGA_CRYPT_SIM_SHA256_LENGTH);
+        if (OPTIGA_LIB_SUCCESS == status)
+        {
+            optiga_sim_crypto_sha256_finalize(context, hash_output);
+        }
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_hash_start(optiga_crypt_t * me, optiga_hash_context_t * hash_ctx)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == hash_ctx) || (NULL == hash_ctx->context_buffer) ||
+        (hash_ctx->context_buffer_length < optiga_sim_crypto_sha256_context_size()))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_CALC_HASH, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        optiga_sim_crypto_sha256_start(hash_ctx->context_buffer);
+        optiga_sim_set_transfer(&p_sim->sim, 0, hash_ctx->context_buffer_length, 0);
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_hash_update(optiga_crypt_t * me,
+                                             optiga_hash_context_t * hash_ctx,
+                                             uint8_t source_of_data_to_hash,
+                                             const void * data_to_hash)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == hash_ctx) || (NULL == hash_ctx->context_buffer) || (NULL == data_to_hash))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_CALC_HASH, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        status = optiga_crypt_sim_hash_data(p_sim, hash_ctx->context_buffer, source_of_data_to_hash,
+                                            data_to_hash, hash_ctx->context_buffer_length,
+                                            hash_ctx->context_buffer_length);
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_hash_finalize(optiga_crypt_t * me,
+                                               optiga_hash_context_t * hash_ctx,
+                                               uint8_t * hash_output)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == hash_ctx) || (NULL == hash_ctx->context_buffer) || (NULL == hash_output))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_CALC_HASH, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        optiga_sim_crypto_sha256_finalize(hash_ctx->context_buffer, hash_output);
+        optiga_sim_set_transfer(&p_sim->sim,
+                                hash_ctx->context_buffer_length,
+                                OPTIGA_CRYPT_SIM_TLV_HEADER + OPTIGA_CRYPT_SIM_SHA256_LENGTH,
+                                0);
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_ecc_generate_keypair(optiga_crypt_t * me,
+                                                      optiga_ecc_curve_t curve_id,
+                                                      uint8_t key_usage,
+                                                      bool_t export_private_key,
+                                                      void * private_key,
+                                                      uint8_t * public_key,
+                                                      uint16_t * public_key_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    uint8_t key[OPTIGA_CRYPT_SIM_ECC_PRIVATE_KEY_SIZE];
+    uint16_t key_length = sizeof(key);
+    uint8_t exported[OPTIGA_CRYPT_SIM_ECC_PRIVATE_KEY_SIZE];
+    uint16_t exported_length = sizeof(exported);
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == private_key) || (NULL == public_key) || (NULL == public_key_length))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_GEN_KEYPAIR, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        optiga_sim_set_variant(&p_sim->sim, (uint8_t)curve_id);
+        if (FALSE == optiga_sim_crypto_ecc_generate((uint8_t)curve_id, key, &key_length, public_key, public_key_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, 8, OPTIGA_CRYPT_SIM_TLV_HEADER + *public_key_length, 0);
+        if (TRUE == export_private_key)
+        {
+            if (FALSE == optiga_sim_crypto_ecc_export_private(key, key_length, exported, &exported_length))
+            {
+                status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INTERNAL_PROCESS);
+                break;
+            }
+            memcpy(private_key, exported, exported_length);
+            optiga_sim_set_transfer(&p_sim->sim, 8,
+                                    (2 * OPTIGA_CRYPT_SIM_TLV_HEADER) + *public_key_length + exported_length, 0);
+            break;
+        }
+        status = optiga_crypt_sim_store_key(p_sim, (optiga_key_id_t *)private_key, OPTIGA_SIM_CONTENT_ECC_KEY,
+                                            (uint8_t)curve_id, key_usage, key, key_length);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_ecdsa_sign(optiga_crypt_t * me,
+                                            const uint8_t * digest,
+                                            uint8_t digest_length,
+                                            optiga_key_id_t private_key,
+                                            uint8_t * signature,
+                                            uint16_t * signature_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_sim_object_t * key;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == digest) || (NULL == signature) || (NULL == signature_length))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_CALC_SIGN, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_crypt_sim_get_key(p_sim, (uint16_t)private_key, OPTIGA_SIM_CONTENT_ECC_KEY, &key);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_ecdsa_sign(key->data, key->length, digest, digest_length,
+                                                  signature, signature_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, (2 * OPTIGA_CRYPT_SIM_TLV_HEADER) + digest_length + 2,
+                                *signature_length, 0);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_ecdsa_verify(optiga_crypt_t * me,
+                                              const uint8_t * digest,
+                                              uint8_t digest_length,
+                                              const uint8_t * signature,
+                                              uint16_t signature_length,
+                                              uint8_t public_key_source_type,
+                                              const void * public_key)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    uint8_t key[OPTIGA_CRYPT_SIM_ECC_PRIVATE_KEY_SIZE];
+    uint16_t key_length = sizeof(key);
+    uint8_t key_type = 0;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == digest) || (NULL == signature) || (NULL == public_key))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_VERIFY_SIGN, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_crypt_sim_get_public_key(p_sim, public_key_source_type, public_key, key, &key_length, &key_type);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        optiga_sim_set_variant(&p_sim->sim, key_type);
+        optiga_sim_set_transfer(&p_sim->sim,
+                                (4 * OPTIGA_CRYPT_SIM_TLV_HEADER) + digest_length + signature_length +
+                                ((OPTIGA_CRYPT_HOST_DATA == public_key_source_type) ? key_length : 2U),
+                                0, 0);
+        if (FALSE == optiga_sim_crypto_ecdsa_verify(key_type, key, key_length, digest, digest_length,
+                                                    signature, signature_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_SIGNATURE_VERIFICATION);
+        }
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_ecdh(optiga_crypt_t * me,
+                                      optiga_key_id_t private_key,
+                                      public_key_from_host_t * public_key,
+                                      bool_t export_to_host,
+                                      uint8_t * shared_secret)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_sim_object_t * key;
+    uint8_t secret[OPTIGA_CRYPT_SIM_MAX_DIGEST_LENGTH + 2];
+    uint16_t secret_length = sizeof(secret);
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == public_key) || ((TRUE == export_to_host) && (NULL == shared_secret)))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_CALC_SSEC, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_crypt_sim_get_key(p_sim, (uint16_t)private_key, OPTIGA_SIM_CONTENT_ECC_KEY, &key);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_ecdh(key->data, key->length, public_key->key_type,
+                                            public_key->public_key, public_key->length,
+                                            secret, &secret_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, (4 * OPTIGA_CRYPT_SIM_TLV_HEADER) + 2 + public_key->length,
+                                (TRUE == export_to_host) ? secret_length : 0U, 0);
+        if (TRUE == export_to_host)
+        {
+            memcpy(shared_secret, secret, secret_length);
+            break;
+        }
+        status = optiga_crypt_sim_store_session_secret(p_sim, secret, secret_length);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_tls_prf(optiga_crypt_t * me,
+                                         optiga_tls_prf_type_t type,
+                                         uint16_t secret,
+                                         const uint8_t * label,
+                                         uint16_t label_length,
+                                         const uint8_t * seed,
+                                         uint16_t seed_length,
+                                         uint16_t derived_key_length,
+                                         bool_t export_to_host,
+                                         uint8_t * derived_key)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_sim_object_t * input_secret;
+    uint8_t derived[OPTIGA_CRYPT_SIM_MAX_DERIVED_LENGTH];
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == seed) || ((TRUE == export_to_host) && (NULL == derived_key)))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_DERIVE_KEY, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if ((0 == derived_key_length) || (derived_key_length > sizeof(derived)))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        status = optiga_crypt_sim_get_secret(p_sim, secret, OPTIGA_SIM_DATA_TYPE_PRESSEC, &input_secret);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_tls_prf((uint8_t)type, input_secret->data, input_secret->length,
+                                               label, label_length, seed, seed_length,
+                                               derived, derived_key_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, (4 * OPTIGA_CRYPT_SIM_TLV_HEADER) + 4 + label_length + seed_length,
+                                (TRUE == export_to_host) ? derived_key_length : 0U, derived_key_length);
+        if (TRUE == export_to_host)
+        {
+            memcpy(derived_key, derived, derived_key_length);
+            break;
+        }
+        status = optiga_crypt_sim_store_session_secret(p_sim, derived, derived_key_length);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_tls_prf_sha256(optiga_crypt_t * me,
+                                                uint16_t secret,
+                                                const uint8_t * label,
+                                                uint16_t label_length,
+                                                const uint8_t * seed,
+                                                uint16_t seed_length,
+                                                uint16_t derived_key_length,
+                                                bool_t export_to_host,
+                                                uint8_t * derived_key)
+{
+    return (optiga_crypt_tls_prf(me, OPTIGA_TLS12_PRF_SHA_256, secret, label, label_length,
+                                 seed, seed_length, derived_key_length, export_to_host, derived_key));
+}
+
+optiga_lib_status_t optiga_crypt_rsa_generate_keypair(optiga_crypt_t * me,
+                                                      optiga_rsa_key_type_t key_type,
+                                                      uint8_t key_usage,
+                                                      bool_t export_private_key,
+                                                      void * private_key,
+                                                      uint8_t * public_key,
+                                                      uint16_t * public_key_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    uint8_t key[OPTIGA_CRYPT_SIM_RSA_PRIVATE_KEY_SIZE];
+    uint16_t key_length = sizeof(key);
+    uint8_t exported[OPTIGA_CRYPT_SIM_RSA_PRIVATE_KEY_SIZE];
+    uint16_t exported_length = sizeof(exported);
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == private_key) || (NULL == public_key) || (NULL == public_key_length))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_GEN_KEYPAIR, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if ((OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL != key_type) && (OPTIGA_RSA_KEY_2048_BIT_EXPONENTIAL != key_type))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_set_variant(&p_sim->sim, (uint8_t)key_type);
+        if (FALSE == optiga_sim_crypto_rsa_generate((OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL == key_type) ? 1024 : 2048,
+                                                    key, &key_length, public_key, public_key_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INTERNAL_PROCESS);
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, 8, OPTIGA_CRYPT_SIM_TLV_HEADER + *public_key_length, 0);
+        if (TRUE == export_private_key)
+        {
+            if (FALSE == optiga_sim_crypto_rsa_export_private(key, key_length, exported, &exported_length))
+            {
+                status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INTERNAL_PROCESS);
+                break;
+            }
+            memcpy(private_key, exported, exported_length);
+            optiga_sim_set_transfer(&p_sim->sim, 8,
+                                    (2 * OPTIGA_CRYPT_SIM_TLV_HEADER) + *public_key_length + exported_length, 0);
+            break;
+        }
+        status = optiga_crypt_sim_store_key(p_sim, (optiga_key_id_t *)private_key, OPTIGA_SIM_CONTENT_RSA_KEY,
+                                            (uint8_t)key_type, key_usage, key, key_length);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_rsa_sign(optiga_crypt_t * me,
+                                          optiga_rsa_signature_scheme_t signature_scheme,
+                                          const uint8_t * digest,
+                                          uint8_t digest_length,
+                                          optiga_key_id_t private_key,
+                                          uint8_t * signature,
+                                          uint16_t * signature_length,
+                                          uint16_t salt_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_sim_object_t * key;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    (void)salt_length;
+    if ((NULL == me) || (NULL == digest) || (NULL == signature) || (NULL == signature_length))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_CALC_SIGN, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_crypt_sim_get_key(p_sim, (uint16_t)private_key, OPTIGA_SIM_CONTENT_RSA_KEY, &key);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_rsa_sign(key->data, key->length, (uint8_t)signature_scheme,
+                                                digest, digest_length, signature, signature_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, (2 * OPTIGA_CRYPT_SIM_TLV_HEADER) + digest_length + 2,
+                                *signature_length, 0);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_rsa_verify(optiga_crypt_t * me,
+                                            optiga_rsa_signature_scheme_t signature_scheme,
+                                            const uint8_t * digest,
+                                            uint8_t digest_length,
+                                            const uint8_t * signature,
+                                            uint16_t signature_length,
+                                            uint8_t public_key_source_type,
+                                            const void * public_key,
+                                            uint16_t salt_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    uint8_t key[OPTIGA_CRYPT_SIM_RSA_PRIVATE_KEY_SIZE];
+    uint16_t key_length = sizeof(key);
+    uint8_t key_type = 0;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    (void)salt_length;
+    if ((NULL == me) || (NULL == digest) || (NULL == signature) || (NULL == public_key))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_VERIFY_SIGN, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_crypt_sim_get_public_key(p_sim, public_key_source_type, public_key, key, &key_length, &key_type);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        optiga_sim_set_variant(&p_sim->sim, key_type);
+        optiga_sim_set_transfer(&p_sim->sim,
+                                (4 * OPTIGA_CRYPT_SIM_TLV_HEADER) + digest_length + signature_length +
+                                ((OPTIGA_CRYPT_HOST_DATA == public_key_source_type) ? key_length : 2U),
+                                0, 0);
+        if (FALSE == optiga_sim_crypto_rsa_verify(key, key_length, (uint8_t)signature_scheme,
+                                                  digest, digest_length, signature, signature_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_SIGNATURE_VERIFICATION);
+        }
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+/**
+ * RSA encryption of a host message or of the session context (pre-master secret)
+ */
+static optiga_lib_status_t optiga_crypt_sim_rsa_encrypt(optiga_crypt_sim_t * me,
+                                                        optiga_rsa_encryption_scheme_t encryption_scheme,
+                                                        const uint8_t * message,
+                                                        uint16_t message_length,
+                                                        uint8_t public_key_source_type,
+                                                        const void * public_key,
+                                                        uint8_t * encrypted_message,
+                                                        uint16_t * encrypted_message_length)
+{
+    optiga_sim_object_t * session = NULL;
+    uint8_t key[OPTIGA_CRYPT_SIM_RSA_PRIVATE_KEY_SIZE];
+    uint16_t key_length = sizeof(key);
+    uint8_t key_type = 0;
+    optiga_lib_status_t status;
+
+    do
+    {
+        if (OPTIGA_RSAES_PKCS1_V15 != encryption_scheme)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        if (NULL == message)
+        {
+            session = optiga_sim_get_session(&me->sim);
+            if (NULL == session)
+            {
+                status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_COMMAND_OUT_OF_SEQUENCE);
+                break;
+            }
+            message = session->data;
+            message_length = session->length;
+        }
+        status = optiga_crypt_sim_get_public_key(me, public_key_source_type, public_key, key, &key_length, &key_type);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_rsa_encrypt(key, key_length, message, message_length,
+                                                   encrypted_message, encrypted_message_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_set_variant(&me->sim, key_type);
+        optiga_sim_set_transfer(&me->sim,
+                                (3 * OPTIGA_CRYPT_SIM_TLV_HEADER) +
+                                ((NULL == session) ? message_length : 2U) +
+                                ((OPTIGA_CRYPT_HOST_DATA == public_key_source_type) ? key_length : 2U),
+                                *encrypted_message_length, 0);
+    } while (FALSE);
+
+    return (status);
+}
+
+optiga_lib_status_t optiga_crypt_rsa_encrypt_message(optiga_crypt_t * me,
+                                                     optiga_rsa_encryption_scheme_t encryption_scheme,
+                                                     const uint8_t * message,
+                                                     uint16_t message_length,
+                                                     const uint8_t * label,
+                                                     uint16_t label_length,
+                                                     uint8_t public_key_source_type,
+                                                     const void * public_key,
+                                                     uint8_t * encrypted_message,
+                                                     uint16_t * encrypted_message_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    (void)label;
+    (void)label_length;
+    if ((NULL == me) || (NULL == message) || (NULL == public_key) ||
+        (NULL == encrypted_message) || (NULL == encrypted_message_length))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_ENCRYPT_ASYM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        status = optiga_crypt_sim_rsa_encrypt(p_sim, encryption_scheme, message, message_length,
+                                              public_key_source_type, public_key,
+                                              encrypted_message, encrypted_message_length);
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_rsa_encrypt_session(optiga_crypt_t * me,
+                                                     optiga_rsa_encryption_scheme_t encryption_scheme,
+                                                     const uint8_t * label,
+                                                     uint16_t label_length,
+                                                     uint8_t public_key_source_type,
+                                                     const void * public_key,
+                                                     uint8_t * encrypted_message,
+                                                     uint16_t * encrypted_message_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    (void)label;
+    (void)label_length;
+    if ((NULL == me) || (NULL == public_key) || (NULL == encrypted_message) || (NULL == encrypted_message_length))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_ENCRYPT_ASYM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        status = optiga_crypt_sim_rsa_encrypt(p_sim, encryption_scheme, NULL, 0,
+                                              public_key_source_type, public_key,
+                                              encrypted_message, encrypted_message_length);
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+/**
+ * RSA decryption with a key object, the message is either returned or kept in the session context
+ */
+static optiga_lib_status_t optiga_crypt_sim_rsa_decrypt(optiga_crypt_sim_t * me,
+                                                        optiga_rsa_encryption_scheme_t encryption_scheme,
+                                                        const uint8_t * encrypted_message,
+                                                        uint16_t encrypted_message_length,
+                                                        optiga_key_id_t private_key,
+                                                        uint8_t * message,
+                                                        uint16_t * message_length)
+{
+    optiga_sim_object_t * key;
+    uint8_t decrypted[OPTIGA_CRYPT_SIM_MAX_DERIVED_LENGTH];
+    uint16_t decrypted_length = sizeof(decrypted);
+    optiga_lib_status_t status;
+
+    do
+    {
+        if (OPTIGA_RSAES_PKCS1_V15 != encryption_scheme)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        status = optiga_crypt_sim_get_key(me, (uint16_t)private_key, OPTIGA_SIM_CONTENT_RSA_KEY, &key);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_rsa_decrypt(key->data, key->length, encrypted_message, encrypted_message_length,
+                                                   decrypted, &decrypted_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_DECRYPTION_FAILURE);
+            break;
+        }
+        optiga_sim_set_transfer(&me->sim, (3 * OPTIGA_CRYPT_SIM_TLV_HEADER) + encrypted_message_length + 2,
+                                (NULL == message) ? 0U : decrypted_length, 0);
+        if (NULL == message)
+        {
+            status = optiga_crypt_sim_store_session_secret(me, decrypted, decrypted_length);
+            break;
+        }
+        if (decrypted_length > *message_length)
+        {
+            status = OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        memcpy(message, decrypted, decrypted_length);
+        *message_length = decrypted_length;
+    } while (FALSE);
+
+    return (status);
+}
+
+optiga_lib_status_t optiga_crypt_rsa_decrypt_and_export(optiga_crypt_t * me,
+                                                        optiga_rsa_encryption_scheme_t encryption_scheme,
+                                                        const uint8_t * encrypted_message,
+                                                        uint16_t encrypted_message_length,
+                                                        const uint8_t * label,
+                                                        uint16_t label_length,
+                                                        optiga_key_id_t private_key,
+                                                        uint8_t * message,
+                                                        uint16_t * message_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    (void)label;
+    (void)label_length;
+    if ((NULL == me) || (NULL == encrypted_message) || (NULL == message) || (NULL == message_length))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_DECRYPT_ASYM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        status = optiga_crypt_sim_rsa_decrypt(p_sim, encryption_scheme, encrypted_message, encrypted_message_length,
+                                              private_key, message, message_length);
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_rsa_decrypt_and_store(optiga_crypt_t * me,
+                                                       optiga_rsa_encryption_scheme_t encryption_scheme,
+                                                       const uint8_t * encrypted_message,
+                                                       uint16_t encrypted_message_length,
+                                                       const uint8_t * label,
+                                                       uint16_t label_length,
+                                                       optiga_key_id_t private_key)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    (void)label;
+    (void)label_length;
+    if ((NULL == me) || (NULL == encrypted_message))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_DECRYPT_ASYM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        status = optiga_crypt_sim_rsa_decrypt(p_sim, encryption_scheme, encrypted_message, encrypted_message_length,
+                                              private_key, NULL, NULL);
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_rsa_generate_pre_master_secret(optiga_crypt_t * me,
+                                                                const uint8_t * optional_data,
+                                                                uint16_t optional_data_length,
+                                                                uint16_t pre_master_secret_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    uint8_t pre_master_secret[OPTIGA_CRYPT_SIM_MAX_DERIVED_LENGTH];
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || ((0 != optional_data_length) && (NULL == optional_data)))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_GET_RANDOM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        /* optional data || random */
+        if ((pre_master_secret_length > sizeof(pre_master_secret)) ||
+            ((optional_data_length + OPTIGA_CRYPT_SIM_MIN_RANDOM_LENGTH) > pre_master_secret_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        if (0 != optional_data_length)
+        {
+            memcpy(pre_master_secret, optional_data, optional_data_length);
+        }
+        (void)optiga_sim_crypto_random(&pre_master_secret[optional_data_length],
+                                       (uint32_t)(pre_master_secret_length - optional_data_length));
+        optiga_sim_set_transfer(&p_sim->sim, OPTIGA_CRYPT_SIM_TLV_HEADER + 2 + optional_data_length, 0,
+                                pre_master_secret_length);
+        status = optiga_crypt_sim_store_session_secret(p_sim, pre_master_secret, pre_master_secret_length);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+/**
+ * Processes a chunk of a symmetric operation. MAC modes only produce output with the last chunk.
+ */
+static optiga_lib_status_t optiga_crypt_sim_symmetric_process(optiga_crypt_sim_t * me,
+                                                              const uint8_t * in,
+                                                              uint32_t in_length,
+                                                              bool_t last,
+                                                              uint8_t * out,
+                                                              uint32_t * out_length)
+{
+    optiga_sim_object_t * key;
+    uint8_t chain[OPTIGA_CRYPT_SIM_AES_BLOCK_SIZE];
+    uint8_t * buffer;
+    optiga_lib_status_t status;
+
+    do
+    {
+        status = optiga_crypt_sim_get_key(me, me->symmetric_key_oid, OPTIGA_SIM_CONTENT_AES_KEY, &key);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (0 != (in_length % OPTIGA_CRYPT_SIM_AES_BLOCK_SIZE))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_LENGTH_FIELD);
+            break;
+        }
+        if ((OPTIGA_SYMMETRIC_ECB == me->symmetric_mode) || (OPTIGA_SYMMETRIC_CBC == me->symmetric_mode))
+        {
+            if (in_length > *out_length)
+            {
+                status = OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT;
+                break;
+            }
+            /*
+             * The last cipher text block of a decryption is taken before the output is written,
+             * OPTIGA receives the whole command first, so the output may overwrite the input
+             */
+            if ((FALSE == me->symmetric_encrypt) && (0 != in_length))
+            {
+                memcpy(chain, &in[in_length - OPTIGA_CRYPT_SIM_AES_BLOCK_SIZE], sizeof(chain));
+            }
+            if (FALSE == optiga_sim_crypto_aes(me->symmetric_mode, me->symmetric_encrypt, key->data, key->length,
+                                               me->symmetric_iv, in, in_length, out))
+            {
+                status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+                break;
+            }
+            if ((OPTIGA_SYMMETRIC_CBC == me->symmetric_mode) && (0 != in_length))
+            {
+                /* Chain the next chunk with the last cipher text block */
+                memcpy(me->symmetric_iv,
+                       (TRUE == me->symmetric_encrypt) ? &out[in_length - OPTIGA_CRYPT_SIM_AES_BLOCK_SIZE] : chain,
+                       OPTIGA_CRYPT_SIM_AES_BLOCK_SIZE);
+            }
+            *out_length = in_length;
+            break;
+        }
+        if ((OPTIGA_SYMMETRIC_CBC_MAC != me->symmetric_mode) && (OPTIGA_SYMMETRIC_CMAC != me->symmetric_mode))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        /* MAC input is collected until the last chunk */
+        buffer = realloc(me->symmetric_data, me->symmetric_data_length + in_length + 1);
+        if (NULL == buffer)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INSUFFICIENT_MEMORY);
+            break;
+        }
+        me->symmetric_data = buffer;
+        if (0 != in_length)
+        {
+            memcpy(&me->symmetric_data[me->symmetric_data_length], in, in_length);
+        }
+        me->symmetric_data_length += in_length;
+        if (FALSE == last)
+        {
+            *out_length = 0;
+            break;
+        }
+        if (OPTIGA_CRYPT_SIM_AES_BLOCK_SIZE > *out_length)
+        {
+            status = OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_aes_mac(me->symmetric_mode, key->data, key->length,
+                                               me->symmetric_data, me->symmetric_data_length, out))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        *out_length = OPTIGA_CRYPT_SIM_AES_BLOCK_SIZE;
+    } while (FALSE);
+
+    if ((TRUE == last) || (OPTIGA_LIB_SUCCESS != status))
+    {
+        me->symmetric_active = FALSE;
+        free(me->symmetric_data);
+        me->symmetric_data = NULL;
+        me->symmetric_data_length = 0;
+    }
+    return (status);
+}
+
+static optiga_lib_status_t optiga_crypt_sim_symmetric_start(optiga_crypt_sim_t * me,
+                                                            bool_t encrypt,
+                                                            optiga_symmetric_encryption_mode_t encryption_mode,
+                                                            optiga_key_id_t symmetric_key_oid,
+                                                            const uint8_t * iv,
+                                                            uint16_t iv_length)
+{
+    if ((FALSE == encrypt) &&
+        ((OPTIGA_SYMMETRIC_CBC_MAC == encryption_mode) || (OPTIGA_SYMMETRIC_CMAC == encryption_mode)))
+    {
+        return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER));
+    }
+    /* The IV is optional for CBC, a zero IV is used if absent */
+    if ((OPTIGA_SYMMETRIC_CBC == encryption_mode) && (NULL != iv) && (OPTIGA_CRYPT_SIM_AES_BLOCK_SIZE != iv_length))
+    {
+        return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER));
+    }
+    free(me->symmetric_data);
+    me->symmetric_data = NULL;
+    me->symmetric_data_length = 0;
+    me->symmetric_active = TRUE;
+    me->symmetric_encrypt = encrypt;
+    me->symmetric_mode = (uint8_t)encryption_mode;
+    me->symmetric_key_oid = (uint16_t)symmetric_key_oid;
+    memset(me->symmetric_iv, 0, sizeof(me->symmetric_iv));
+    if ((OPTIGA_SYMMETRIC_CBC == encryption_mode) && (NULL != iv))
+    {
+        memcpy(me->symmetric_iv, iv, OPTIGA_CRYPT_SIM_AES_BLOCK_SIZE);
+    }
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+/**
+ * Common body of the symmetric encrypt/decrypt APIs. start is TRUE for one shot and start requests,
+ * last is TRUE for one shot and final requests.
+ */
+static optiga_lib_status_t optiga_crypt_sim_symmetric(optiga_crypt_t * me,
+                                                      bool_t encrypt,
+                                                      bool_t start,
+                                                      bool_t last,
+                                                      optiga_symmetric_encryption_mode_t encryption_mode,
+                                                      optiga_key_id_t symmetric_key_oid,
+                                                      const uint8_t * in,
+                                                      uint32_t in_length,
+                                                      const uint8_t * iv,
+                                                      uint16_t iv_length,
+                                                      uint8_t * out,
+                                                      uint32_t * out_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || ((0 != in_length) && (NULL == in)) || (NULL == out_length) ||
+        ((NULL == out) && (0 != *out_length)))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, (TRUE == encrypt) ? OPTIGA_SIM_COMMAND_ENCRYPT_SYM : OPTIGA_SIM_COMMAND_DECRYPT_SYM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (TRUE == start)
+        {
+            status = optiga_crypt_sim_symmetric_start(p_sim, encrypt, encryption_mode, symmetric_key_oid, iv, iv_length);
+        }
+        else if ((FALSE == p_sim->symmetric_active) || (encrypt != p_sim->symmetric_encrypt))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_COMMAND_OUT_OF_SEQUENCE);
+        }
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_crypt_sim_symmetric_process(p_sim, in, in_length, last, out, out_length);
+        optiga_sim_set_transfer(&p_sim->sim,
+                                (2 * OPTIGA_CRYPT_SIM_TLV_HEADER) + 2 + in_length + ((TRUE == start) ? iv_length : 0U),
+                                *out_length,
+                                in_length);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_symmetric_encrypt(optiga_crypt_t * me,
+                                                   optiga_symmetric_encryption_mode_t encryption_mode,
+                                                   optiga_key_id_t symmetric_key_oid,
+                                                   const uint8_t * plain_data,
+                                                   uint32_t plain_data_length,
+                                                   const uint8_t * iv,
+                                                   uint16_t iv_length,
+                                                   const uint8_t * associated_data,
+                                                   uint16_t associated_data_length,
+                                                   uint8_t * encrypted_data,
+                                                   uint32_t * encrypted_data_length)
+{
+    (void)associated_data;
+    (void)associated_data_length;
+    return (optiga_crypt_sim_symmetric(me, TRUE, TRUE, TRUE, encryption_mode, symmetric_key_oid,
+                                       plain_data, plain_data_length, iv, iv_length,
+                                       encrypted_data, encrypted_data_length));
+}
+
+optiga_lib_status_t optiga_crypt_symmetric_decrypt(optiga_crypt_t * me,
+                                                   optiga_symmetric_encryption_mode_t encryption_mode,
+                                                   optiga_key_id_t symmetric_key_oid,
+                                                   const uint8_t * encrypted_data,
+                                                   uint32_t encrypted_data_length,
+                                                   const uint8_t * iv,
+                                                   uint16_t iv_length,
+                                                   const uint8_t * associated_data,
+                                                   uint16_t associated_data_length,
+                                                   uint8_t * plain_data,
+                                                   uint32_t * plain_data_length)
+{
+    (void)associated_data;
+    (void)associated_data_length;
+    return (optiga_crypt_sim_symmetric(me, FALSE, TRUE, TRUE, encryption_mode, symmetric_key_oid,
+                                       encrypted_data, encrypted_data_length, iv, iv_length,
+                                       plain_data, plain_data_length));
+}
+
+optiga_lib_status_t optiga_crypt_symmetric_encrypt_ecb(optiga_crypt_t * me,
+                                                       optiga_key_id_t symmetric_key_oid,
+                                                       const uint8_t * plain_data,
+                                                       uint32_t plain_data_length,
+                                                       uint8_t * encrypted_data,
+                                                       uint32_t * encrypted_data_length)
+{
+    return (optiga_crypt_sim_symmetric(me, TRUE, TRUE, TRUE, OPTIGA_SYMMETRIC_ECB, symmetric_key_oid,
+                                       plain_data, plain_data_length, NULL, 0,
+                                       encrypted_data, encrypted_data_length));
+}
+
+optiga_lib_status_t optiga_crypt_symmetric_decrypt_ecb(optiga_crypt_t * me,
+                                                       optiga_key_id_t symmetric_key_oid,
+                                                       const uint8_t * encrypted_data,
+                                                       uint32_t encrypted_data_length,
+                                                       uint8_t * plain_data,
+                                                       uint32_t * plain_data_length)
+{
+    return (optiga_crypt_sim_symmetric(me, FALSE, TRUE, TRUE, OPTIGA_SYMMETRIC_ECB, symmetric_key_oid,
+                                       encrypted_data, encrypted_data_length, NULL, 0,
+                                       plain_data, plain_data_length));
+}
+
+optiga_lib_status_t optiga_crypt_symmetric_encrypt_start(optiga_crypt_t * me,
+                                                         optiga_symmetric_encryption_mode_t encryption_mode,
+                                                         optiga_key_id_t symmetric_key_oid,
+                                                         const uint8_t * plain_data,
+                                                         uint32_t plain_data_length,
+                                                         const uint8_t * iv,
+                                                         uint16_t iv_length,
+                                                         const uint8_t * associated_data,
+                                                         uint16_t associated_data_length,
+                                                         uint16_t total_plain_data_length,
+                                                         uint8_t * encrypted_data,
+                                                         uint32_t * encrypted_data_length)
+{
+    (void)associated_data;
+    (void)associated_data_length;
+    (void)total_plain_data_length;
+    return (optiga_crypt_sim_symmetric(me, TRUE, TRUE, FALSE, encryption_mode, symmetric_key_oid,
+                                       plain_data, plain_data_length, iv, iv_length,
+                                       encrypted_data, encrypted_data_length));
+}
+
+optiga_lib_status_t optiga_crypt_symmetric_encrypt_continue(optiga_crypt_t * me,
+                                                            const uint8_t * plain_data,
+                                                            uint32_t plain_data_length,
+                                                            uint8_t * encrypted_data,
+                                                            uint32_t * encrypted_data_length)
+{
+    return (optiga_crypt_sim_symmetric(me, TRUE, FALSE, FALSE, OPTIGA_SYMMETRIC_ECB, OPTIGA_KEY_ID_SECRET_BASED,
+                                       plain_data, plain_data_length, NULL, 0,
+                                       encrypted_data, encrypted_data_length));
+}
+
+optiga_lib_status_t optiga_crypt_symmetric_encrypt_final(optiga_crypt_t * me,
+                                                         const uint8_t * plain_data,
+                                                         uint32_t plain_data_length,
+                                                         uint8_t * encrypted_data,
+                                                         uint32_t * encrypted_data_length)
+{
+    return (optiga_crypt_sim_symmetric(me, TRUE, FALSE, TRUE, OPTIGA_SYMMETRIC_ECB, OPTIGA_KEY_ID_SECRET_BASED,
+                                       plain_data, plain_data_length, NULL, 0,
+                                       encrypted_data, encrypted_data_length));
+}
+
+optiga_lib_status_t optiga_crypt_symmetric_decrypt_start(optiga_crypt_t * me,
+                                                         optiga_symmetric_encryption_mode_t encryption_mode,
+                                                         optiga_key_id_t symmetric_key_oid,
+                                                         const uint8_t * encrypted_data,
+                                                         uint32_t encrypted_data_length,
+                                                         const uint8_t * iv,
+                                                         uint16_t iv_length,
+                                                         const uint8_t * associated_data,
+                                                         uint16_t associated_data_length,
+                                                         uint16_t total_plain_data_length,
+                                                         uint8_t * plain_data,
+                                                         uint32_t * plain_data_length)
+{
+    (void)associated_data;
+    (void)associated_data_length;
+    (void)total_plain_data_length;
+    return (optiga_crypt_sim_symmetric(me, FALSE, TRUE, FALSE, encryption_mode, symmetric_key_oid,
+                                       encrypted_data, encrypted_data_length, iv, iv_length,
+                                       plain_data, plain_data_length));
+}
+
+optiga_lib_status_t optiga_crypt_symmetric_decrypt_continue(optiga_crypt_t * me,
+                                                            const uint8_t * encrypted_data,
+                                                            uint32_t encrypted_data_length,
+                                                            uint8_t * plain_data,
+                                                            uint32_t * plain_data_length)
+{
+    return (optiga_crypt_sim_symmetric(me, FALSE, FALSE, FALSE, OPTIGA_SYMMETRIC_ECB, OPTIGA_KEY_ID_SECRET_BASED,
+                                       encrypted_data, encrypted_data_length, NULL, 0,
+                                       plain_data, plain_data_length));
+}
+
+optiga_lib_status_t optiga_crypt_symmetric_decrypt_final(optiga_crypt_t * me,
+                                                         const uint8_t * encrypted_data,
+                                                         uint32_t encrypted_data_length,
+                                                         uint8_t * plain_data,
+                                                         uint32_t * plain_data_length)
+{
+    return (optiga_crypt_sim_symmetric(me, FALSE, FALSE, TRUE, OPTIGA_SYMMETRIC_ECB, OPTIGA_KEY_ID_SECRET_BASED,
+                                       encrypted_data, encrypted_data_length, NULL, 0,
+                                       plain_data, plain_data_length));
+}
+
+optiga_lib_status_t optiga_crypt_symmetric_generate_key(optiga_crypt_t * me,
+                                                        optiga_symmetric_key_type_t key_type,
+                                                        uint8_t key_usage,
+                                                        bool_t export_symmetric_key,
+                                                        void * symmetric_key)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    uint8_t key[32];
+    uint16_t key_length;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == symmetric_key))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_GEN_SYMKEY, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        switch (key_type)
+        {
+            case OPTIGA_SYMMETRIC_AES_128: key_length = 16; break;
+            case OPTIGA_SYMMETRIC_AES_192: key_length = 24; break;
+            case OPTIGA_SYMMETRIC_AES_256: key_length = 32; break;
+            default: key_length = 0; break;
+        }
+        if (0 == key_length)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        (void)optiga_sim_crypto_random(key, key_length);
+        optiga_sim_set_variant(&p_sim->sim, (uint8_t)key_type);
+        optiga_sim_set_transfer(&p_sim->sim, 8, (TRUE == export_symmetric_key) ? key_length : 0U, 0);
+        if (TRUE == export_symmetric_key)
+        {
+            memcpy(symmetric_key, key, key_length);
+            break;
+        }
+        if (OPTIGA_KEY_ID_SECRET_BASED != *(optiga_key_id_t *)symmetric_key)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_OID);
+            break;
+        }
+        status = optiga_crypt_sim_store_key(p_sim, (optiga_key_id_t *)symmetric_key, OPTIGA_SIM_CONTENT_AES_KEY,
+                                            (uint8_t)key_type, key_usage, key, key_length);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_hmac(optiga_crypt_t * me,
+                                      optiga_hmac_type_t type,
+                                      uint16_t secret,
+                                      const uint8_t * input_data,
+                                      uint32_t input_data_length,
+                                      uint8_t * mac,
+                                      uint32_t * mac_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_sim_object_t * input_secret;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == input_data) || (NULL == mac) || (NULL == mac_length))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_ENCRYPT_SYM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_crypt_sim_get_secret(p_sim, secret, OPTIGA_SIM_DATA_TYPE_PRESSEC, &input_secret);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (*mac_length < optiga_crypt_sim_digest_length((uint8_t)type))
+        {
+            status = OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_hmac((uint8_t)type, input_secret->data, input_secret->length,
+                                            input_data, input_data_length, mac, mac_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, (2 * OPTIGA_CRYPT_SIM_TLV_HEADER) + 2 + input_data_length,
+                                *mac_length, input_data_length);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_hmac_start(optiga_crypt_t * me,
+                                            optiga_hmac_type_t type,
+                                            uint16_t secret,
+                                            const uint8_t * input_data,
+                                            uint32_t input_data_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_sim_object_t * input_secret;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || ((0 != input_data_length) && (NULL == input_data)))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_ENCRYPT_SYM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_crypt_sim_get_secret(p_sim, secret, OPTIGA_SIM_DATA_TYPE_PRESSEC, &input_secret);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        optiga_sim_crypto_hmac_free(p_sim->hmac_context);
+        p_sim->hmac_context = optiga_sim_crypto_hmac_start((uint8_t)type, input_secret->data, input_secret->length);
+        if (FALSE == optiga_sim_crypto_hmac_update(p_sim->hmac_context, input_data, input_data_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, (2 * OPTIGA_CRYPT_SIM_TLV_HEADER) + 2 + input_data_length,
+                                0, input_data_length);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_hmac_update(optiga_crypt_t * me,
+                                             const uint8_t * input_data,
+                                             uint32_t input_data_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == input_data))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_ENCRYPT_SYM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    if ((OPTIGA_LIB_SUCCESS == status) &&
+        (FALSE == optiga_sim_crypto_hmac_update(p_sim->hmac_context, input_data, input_data_length)))
+    {
+        status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_COMMAND_OUT_OF_SEQUENCE);
+    }
+    optiga_sim_set_transfer(&p_sim->sim, OPTIGA_CRYPT_SIM_TLV_HEADER + input_data_length, 0, input_data_length);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_hmac_finalize(optiga_crypt_t * me,
+                                               const uint8_t * input_data,
+                                               uint32_t input_data_length,
+                                               uint8_t * mac,
+                                               uint32_t * mac_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == mac) || (NULL == mac_length))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_ENCRYPT_SYM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (NULL == p_sim->hmac_context)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_COMMAND_OUT_OF_SEQUENCE);
+            break;
+        }
+        if ((0 != input_data_length) &&
+            (FALSE == optiga_sim_crypto_hmac_update(p_sim->hmac_context, input_data, input_data_length)))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_hmac_finalize(p_sim->hmac_context, mac, mac_length))
+        {
+            status = OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, OPTIGA_CRYPT_SIM_TLV_HEADER + input_data_length,
+                                *mac_length, input_data_length);
+    } while (FALSE);
+    optiga_sim_crypto_hmac_free(p_sim->hmac_context);
+    p_sim->hmac_context = NULL;
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_hkdf(optiga_crypt_t * me,
+                                      optiga_hkdf_type_t type,
+                                      uint16_t secret,
+                                      const uint8_t * salt,
+                                      uint16_t salt_length,
+                                      const uint8_t * info,
+                                      uint16_t info_length,
+                                      uint16_t derived_key_length,
+                                      bool_t export_to_host,
+                                      uint8_t * derived_key)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_sim_object_t * input_secret;
+    uint8_t derived[OPTIGA_CRYPT_SIM_MAX_DERIVED_LENGTH];
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || ((TRUE == export_to_host) && (NULL == derived_key)))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_DERIVE_KEY, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if ((0 == derived_key_length) || (derived_key_length > sizeof(derived)))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        status = optiga_crypt_sim_get_secret(p_sim, secret, OPTIGA_SIM_DATA_TYPE_PRESSEC, &input_secret);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_hkdf((uint8_t)type, input_secret->data, input_secret->length,
+                                            salt, salt_length, info, info_length,
+                                            derived, derived_key_length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, (4 * OPTIGA_CRYPT_SIM_TLV_HEADER) + 4 + salt_length + info_length,
+                                (TRUE == export_to_host) ? derived_key_length : 0U, derived_key_length);
+        if (TRUE == export_to_host)
+        {
+            memcpy(derived_key, derived, derived_key_length);
+            break;
+        }
+        status = optiga_crypt_sim_store_session_secret(p_sim, derived, derived_key_length);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_generate_auth_code(optiga_crypt_t * me,
+                                                    optiga_rng_type_t rng_type,
+                                                    const uint8_t * optional_data,
+                                                    uint16_t optional_data_length,
+                                                    uint8_t * random_data,
+                                                    uint16_t random_data_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    (void)rng_type;
+    if ((NULL == me) || (NULL == random_data) || ((0 != optional_data_length) && (NULL == optional_data)))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_GET_RANDOM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if ((random_data_length < OPTIGA_CRYPT_SIM_MIN_RANDOM_LENGTH) ||
+            (random_data_length > OPTIGA_CRYPT_SIM_MAX_DIGEST_LENGTH) ||
+            (optional_data_length > OPTIGA_CRYPT_SIM_MAX_DIGEST_LENGTH))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        (void)optiga_sim_crypto_random(random_data, random_data_length);
+        optiga_sim_set_auth_code(optional_data, optional_data_length, random_data, random_data_length);
+        optiga_sim_set_transfer(&p_sim->sim, OPTIGA_CRYPT_SIM_TLV_HEADER + 2 + optional_data_length,
+                                random_data_length, random_data_length);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_hmac_verify(optiga_crypt_t * me,
+                                             optiga_hmac_type_t type,
+                                             uint16_t secret,
+                                             const uint8_t * input_data,
+                                             uint32_t input_data_length,
+                                             const uint8_t * hmac,
+                                             uint32_t hmac_length)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_sim_object_t * input_secret;
+    uint8_t expected[OPTIGA_CRYPT_SIM_MAX_DIGEST_LENGTH];
+    uint32_t expected_length = sizeof(expected);
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == input_data) || (NULL == hmac))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_DECRYPT_SYM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_crypt_sim_get_secret(p_sim, secret, OPTIGA_SIM_DATA_TYPE_AUTOREF, &input_secret);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        optiga_sim_set_transfer(&p_sim->sim, (3 * OPTIGA_CRYPT_SIM_TLV_HEADER) + 2 + input_data_length + hmac_length,
+                                0, input_data_length);
+        status = optiga_sim_verify_auth_code(secret, input_data, input_data_length);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if ((FALSE == optiga_sim_crypto_hmac((uint8_t)type, input_secret->data, input_secret->length,
+                                             input_data, input_data_length, expected, &expected_length)) ||
+            (hmac_length != optiga_crypt_sim_digest_length((uint8_t)type)) ||
+            (0 != memcmp(expected, hmac, hmac_length)))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_AUTHORIZATION_FAILURE);
+            break;
+        }
+        optiga_sim_set_auto_state(secret, TRUE);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_crypt_clear_auto_state(optiga_crypt_t * me, uint16_t secret)
+{
+    optiga_crypt_sim_t * p_sim = (optiga_crypt_sim_t *)me;
+    optiga_sim_object_t * input_secret;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if (NULL == me)
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_crypt_sim_begin(p_sim, OPTIGA_SIM_COMMAND_DECRYPT_SYM, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        status = optiga_crypt_sim_get_secret(p_sim, secret, OPTIGA_SIM_DATA_TYPE_AUTOREF, &input_secret);
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        optiga_sim_set_auto_state(secret, FALSE);
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
@@ -0,0 +1,1200 @@
+/******************************************************************************
+* File Name:   optiga_sim.c
+*
+* Description: This file implements the core of the host side OPTIGA Trust M
+*              simulator: the data object store with metadata and access
+*              conditions, the application/session state and the
+*              asynchronous completion of requests through pal_os_event.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/pal/pal_os_event.h"
+#include "optiga/pal/pal_os_datastore.h"
+#include "optiga_sim.h"
+#include "pal_i2c_sim.h"
+
+/** @brief Environment variable naming the file which keeps the non-volatile image */
+#define OPTIGA_SIM_NVM_ENV                  "OPTIGA_SIM_NVM"
+#define OPTIGA_SIM_NVM_DEFAULT_FILE         "optiga_sim_nvm.bin"
+#define OPTIGA_SIM_NVM_MAGIC                "OTMSIM01"
+
+/** @brief Number of completions which can be outstanding at the same time */
+#define OPTIGA_SIM_COMPLETION_QUEUE_SIZE    (OPTIGA_CMD_MAX_REGISTRATIONS * 2)
+
+/** @brief Access condition identifiers and operators */
+#define OPTIGA_SIM_AC_ALW                   (0x00)
+#define OPTIGA_SIM_AC_CONF                  (0x20)
+#define OPTIGA_SIM_AC_INT                   (0x21)
+#define OPTIGA_SIM_AC_AUTO                  (0x23)
+#define OPTIGA_SIM_AC_LUC                   (0x40)
+#define OPTIGA_SIM_AC_LCSG                  (0x70)
+#define OPTIGA_SIM_AC_SECSTA                (0x90)
+#define OPTIGA_SIM_AC_LCSA                  (0xE0)
+#define OPTIGA_SIM_AC_LCSO                  (0xE1)
+#define OPTIGA_SIM_AC_EQ                    (0xFA)
+#define OPTIGA_SIM_AC_GT                    (0xFB)
+#define OPTIGA_SIM_AC_LT                    (0xFC)
+#define OPTIGA_SIM_AC_AND                   (0xFD)
+#define OPTIGA_SIM_AC_OR                    (0xFE)
+#define OPTIGA_SIM_AC_NEV                   (0xFF)
+
+/** @brief Secrets which can be used as authorization reference */
+#define OPTIGA_SIM_SECRET_OID_FIRST         (0xF1D0)
+#define OPTIGA_SIM_SECRET_OID_LAST          (0xF1DB)
+#define OPTIGA_SIM_SECRETS                  (OPTIGA_SIM_SECRET_OID_LAST - OPTIGA_SIM_SECRET_OID_FIRST + 1)
+
+#define OPTIGA_SIM_PLATFORM_BINDING_OID     (0xE140)
+#define OPTIGA_SIM_CURRENT_LIMIT_OID        (0xE0C4)
+#define OPTIGA_SIM_AUTH_CODE_MAX_LENGTH     (0x40)
+#define OPTIGA_SIM_BINDING_SECRET_MAX       (0x40)
+
+/**
+ * Default metadata of the objects (TLVs without 0x20 header)
+ */
+static const uint8_t optiga_sim_metadata_read_only [] =
+{
+    0xC0, 0x01, 0x07, 0xD0, 0x01, 0xFF, 0xD1, 0x01, 0x00
+};
+static const uint8_t optiga_sim_metadata_configuration [] =
+{
+    0xC0, 0x01, 0x07, 0xD0, 0x01, 0x00, 0xD1, 0x01, 0x00
+};
+static const uint8_t optiga_sim_metadata_data [] =
+{
+    0xC0, 0x01, 0x01, 0xD0, 0x01, 0x00, 0xD1, 0x01, 0x00, 0xD3, 0x01, 0x00
+};
+static const uint8_t optiga_sim_metadata_counter [] =
+{
+    0xC0, 0x01, 0x01, 0xD0, 0x01, 0x00, 0xD1, 0x01, 0x00, 0xD3, 0x01, 0x00, 0xE8, 0x01, 0x01
+};
+static const uint8_t optiga_sim_metadata_binding [] =
+{
+    0xC0, 0x01, 0x01, 0xD0, 0x01, 0x00, 0xD1, 0x01, 0x00, 0xD3, 0x01, 0x00, 0xE8, 0x01, 0x22
+};
+static const uint8_t optiga_sim_metadata_device_key [] =
+{
+    0xC0, 0x01, 0x07, 0xD0, 0x01, 0xFF, 0xD1, 0x01, 0xFF, 0xD3, 0x01, 0x00, 0xE0, 0x01, 0x03, 0xE1, 0x01, 0x11
+};
+static const uint8_t optiga_sim_metadata_key [] =
+{
+    0xC0, 0x01, 0x01, 0xD0, 0x01, 0x00, 0xD1, 0x01, 0xFF, 0xD3, 0x01, 0x00
+};
+
+/**
+ * Default content of the configuration objects
+ */
+static const uint8_t optiga_sim_coprocessor_uid [] =
+{
+    0xCD, 0x16, 0x33, 0x82, 0x01, 0x00, 0x1C, 0x00, 0x05, 0x00, 0x00, 0x0A, 0x09, 0x1B,
+    0x5C, 0x00, 0x07, 0x00, 0x6A, 0x00, 0x23, 0x80, 0x04, 0x08, 0x09, 0x00, 0x00
+};
+static const uint8_t optiga_sim_counter_default [] = { 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF };
+
+typedef struct optiga_sim_object_config
+{
+    uint16_t oid;
+    uint16_t max_size;
+    uint8_t content;
+    const uint8_t * metadata;
+    uint8_t metadata_length;
+} optiga_sim_object_config_t;
+
+#define OPTIGA_SIM_OBJECT(oid, size, content, metadata) {(oid), (size), (content), (metadata), sizeof(metadata)}
+
+static const optiga_sim_object_config_t optiga_sim_object_config [] =
+{
+    OPTIGA_SIM_OBJECT(0xE0C0, 1,    OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_read_only),
+    OPTIGA_SIM_OBJECT(0xE0C1, 1,    OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_read_only),
+    OPTIGA_SIM_OBJECT(0xE0C2, 27,   OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_read_only),
+    OPTIGA_SIM_OBJECT(0xE0C3, 1,    OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_configuration),
+    OPTIGA_SIM_OBJECT(0xE0C4, 1,    OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_configuration),
+    OPTIGA_SIM_OBJECT(0xE0C5, 1,    OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_read_only),
+    OPTIGA_SIM_OBJECT(0xE0C6, 2,    OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_read_only),
+    OPTIGA_SIM_OBJECT(0xE0E0, 1728, OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_read_only),
+    OPTIGA_SIM_OBJECT(0xE0E1, 1728, OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xE0E2, 1728, OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xE0E3, 1728, OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xE0E8, 1200, OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xE0E9, 1200, OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xE0EF, 1200, OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xE0F0, 256,  OPTIGA_SIM_CONTENT_ECC_KEY, optiga_sim_metadata_device_key),
+    OPTIGA_SIM_OBJECT(0xE0F1, 256,  OPTIGA_SIM_CONTENT_ECC_KEY, optiga_sim_metadata_key),
+    OPTIGA_SIM_OBJECT(0xE0F2, 256,  OPTIGA_SIM_CONTENT_ECC_KEY, optiga_sim_metadata_key),
+    OPTIGA_SIM_OBJECT(0xE0F3, 256,  OPTIGA_SIM_CONTENT_ECC_KEY, optiga_sim_metadata_key),
+    OPTIGA_SIM_OBJECT(0xE0FC, 1300, OPTIGA_SIM_CONTENT_RSA_KEY, optiga_sim_metadata_key),
+    OPTIGA_SIM_OBJECT(0xE0FD, 1300, OPTIGA_SIM_CONTENT_RSA_KEY, optiga_sim_metadata_key),
+    OPTIGA_SIM_OBJECT(0xE120, 8,    OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_counter),
+    OPTIGA_SIM_OBJECT(0xE121, 8,    OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_counter),
+    OPTIGA_SIM_OBJECT(0xE122, 8,    OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_counter),
+    OPTIGA_SIM_OBJECT(0xE123, 8,    OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_counter),
+    OPTIGA_SIM_OBJECT(0xE140, 64,   OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_binding),
+    OPTIGA_SIM_OBJECT(0xE200, 32,   OPTIGA_SIM_CONTENT_AES_KEY, optiga_sim_metadata_key),
+    OPTIGA_SIM_OBJECT(0xF1D0, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1D1, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1D2, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1D3, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1D4, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1D5, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1D6, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1D7, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1D8, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1D9, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1DA, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1DB, 140,  OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1E0, 1500, OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+    OPTIGA_SIM_OBJECT(0xF1E1, 1500, OPTIGA_SIM_CONTENT_DATA,    optiga_sim_metadata_data),
+};
+
+#define OPTIGA_SIM_OBJECTS          (sizeof(optiga_sim_object_config) / sizeof(optiga_sim_object_config_t))
+#define OPTIGA_SIM_SESSION_SIZE     (1300)
+
+typedef struct optiga_sim_completion
+{
+    optiga_sim_instance_t * instance;
+    optiga_lib_status_t status;
+    /// Time at which the chip delivers the response
+    uint64_t due_us;
+} optiga_sim_completion_t;
+
+typedef struct optiga_sim_auth_code
+{
+    uint8_t valid;
+    uint16_t optional_data_length;
+    uint16_t random_length;
+    uint8_t optional_data[OPTIGA_SIM_AUTH_CODE_MAX_LENGTH];
+    uint8_t random[OPTIGA_SIM_AUTH_CODE_MAX_LENGTH];
+} optiga_sim_auth_code_t;
+
+typedef struct optiga_sim
+{
+    bool_t initialized;
+    /// Object store
+    optiga_sim_object_t objects[OPTIGA_SIM_OBJECTS];
+    optiga_sim_object_t sessions[OPTIGA_SIM_SESSION_CONTEXTS];
+    optiga_sim_instance_t * session_owner[OPTIGA_SIM_SESSION_CONTEXTS];
+    /// Application state
+    bool_t application_open;
+    bool_t application_hibernated;
+    bool_t auto_state[OPTIGA_SIM_SECRETS];
+    optiga_sim_auth_code_t auth_code;
+    /// Registered instances
+    uint8_t registrations;
+    /// Completions waiting to be signalled through the PAL event
+    optiga_sim_completion_t completions[OPTIGA_SIM_COMPLETION_QUEUE_SIZE];
+    uint8_t completion_head;
+    uint8_t completion_count;
+    pal_os_event_t * os_event;
+    /// Time until which the chip is busy with the queued commands
+    uint64_t busy_until_us;
+    /// Non-volatile image
+    char nvm_file[256];
+} optiga_sim_t;
+
+static optiga_sim_t optiga_sim;
+
+/** @brief Guards the simulator state against the PAL event context */
+static pthread_mutex_t optiga_sim_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** @brief The simulated chip executes one command at a time */
+static pthread_mutex_t optiga_sim_execution_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void optiga_sim_write_uint16(FILE * file, uint16_t value)
+{
+    uint8_t buffer[2] = {(uint8_t)(value >> 8), (uint8_t)value};
+    (void)fwrite(buffer, 1, sizeof(buffer), file);
+}
+
+static bool_t optiga_sim_read_uint16(FILE * file, uint16_t * value)
+{
+    uint8_t buffer[2];
+    if (sizeof(buffer) != fread(buffer, 1, sizeof(buffer), file))
+    {
+        return FALSE;
+    }
+    *value = (uint16_t)((buffer[0] << 8) | buffer[1]);
+    return TRUE;
+}
+
+static void optiga_sim_write_object(FILE * file, const optiga_sim_object_t * object)
+{
+    optiga_sim_write_uint16(file, object->oid);
+    optiga_sim_write_uint16(file, object->length);
+    (void)fputc(object->content, file);
+    (void)fputc(object->metadata_length, file);
+    (void)fwrite(object->metadata, 1, object->metadata_length, file);
+    (void)fwrite(object->data, 1, object->length, file);
+}
+
+static bool_t optiga_sim_read_object(FILE * file, optiga_sim_object_t * object)
+{
+    uint16_t oid;
+    uint16_t length;
+    int content;
+    int metadata_length;
+    uint8_t metadata[OPTIGA_SIM_METADATA_MAX_LENGTH];
+    uint8_t * data;
+    bool_t result = FALSE;
+
+    do
+    {
+        if ((FALSE == optiga_sim_read_uint16(file, &oid)) || (FALSE == optiga_sim_read_uint16(file, &length)))
+        {
+            break;
+        }
+        content = fgetc(file);
+        metadata_length = fgetc(file);
+        if ((EOF == content) || (EOF == metadata_length) || (metadata_length > OPTIGA_SIM_METADATA_MAX_LENGTH))
+        {
+            break;
+        }
+        if ((size_t)metadata_length != fread(metadata, 1, (size_t)metadata_length, file))
+        {
+            break;
+        }
+        data = malloc(length + 1U);
+        if (NULL == data)
+        {
+            break;
+        }
+        if (length != fread(data, 1, length, file))
+        {
+            free(data);
+            break;
+        }
+        /* Objects which are not known (any more) are skipped */
+        if ((NULL != object) && (oid == object->oid) && (length <= object->max_size))
+        {
+            object->length = length;
+            object->content = (uint8_t)content;
+            object->metadata_length = (uint8_t)metadata_length;
+            memcpy(object->metadata, metadata, (size_t)metadata_length);
+            memcpy(object->data, data, length);
+        }
+        free(data);
+        result = TRUE;
+    } while (FALSE);
+
+    return (result);
+}
+
+static bool_t optiga_sim_load(void)
+{
+    FILE * file;
+    char magic[sizeof(OPTIGA_SIM_NVM_MAGIC)];
+    uint16_t count;
+    uint16_t index;
+    uint16_t oid;
+    bool_t result = FALSE;
+
+    if (0 == optiga_sim.nvm_file[0])
+    {
+        return FALSE;
+    }
+    file = fopen(optiga_sim.nvm_file, "rb");
+    if (NULL == file)
+    {
+        return FALSE;
+    }
+    do
+    {
+        if ((sizeof(magic) != fread(magic, 1, sizeof(magic), file)) ||
+            (0 != memcmp(magic, OPTIGA_SIM_NVM_MAGIC, sizeof(magic))))
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_read_uint16(file, &count))
+        {
+            break;
+        }
+        for (index = 0; index < count; index++)
+        {
+            /* Peek the OID to find the matching object */
+            if (FALSE == optiga_sim_read_uint16(file, &oid))
+            {
+                break;
+            }
+            (void)fseek(file, -2, SEEK_CUR);
+            if (FALSE == optiga_sim_read_object(file, optiga_sim_find_object(oid)))
+            {
+                break;
+            }
+        }
+        if (index != count)
+        {
+            break;
+        }
+        /* Hibernated application context, including the session contexts */
+        optiga_sim.application_hibernated = (bool_t)(1 == fgetc(file));
+        for (index = 0; index < OPTIGA_SIM_SESSION_CONTEXTS; index++)
+        {
+            if (FALSE == optiga_sim_read_object(file, &optiga_sim.sessions[index]))
+            {
+                break;
+            }
+        }
+        result = TRUE;
+    } while (FALSE);
+    (void)fclose(file);
+
+    return (result);
+}
+
+void optiga_sim_store(void)
+{
+    FILE * file;
+    uint16_t index;
+
+    if (0 == optiga_sim.nvm_file[0])
+    {
+        return;
+    }
+    file = fopen(optiga_sim.nvm_file, "wb");
+    if (NULL == file)
+    {
+        return;
+    }
+    (void)fwrite(OPTIGA_SIM_NVM_MAGIC, 1, sizeof(OPTIGA_SIM_NVM_MAGIC), file);
+    optiga_sim_write_uint16(file, (uint16_t)OPTIGA_SIM_OBJECTS);
+    for (index = 0; index < OPTIGA_SIM_OBJECTS; index++)
+    {
+        optiga_sim_write_object(file, &optiga_sim.objects[index]);
+    }
+    (void)fputc((TRUE == optiga_sim.application_hibernated) ? 1 : 0, file);
+    for (index = 0; index < OPTIGA_SIM_SESSION_CONTEXTS; index++)
+    {
+        optiga_sim_write_object(file, &optiga_sim.sessions[index]);
+    }
+    (void)fclose(file);
+}
+
+static void optiga_sim_provision(void)
+{
+    optiga_sim_object_t * object;
+    uint8_t certificate[1024];
+    uint16_t certificate_length = sizeof(certificate);
+    uint8_t public_key[160];
+    uint16_t public_key_length = sizeof(public_key);
+    uint8_t value;
+    uint8_t index;
+
+    value = OPTIGA_SIM_LCS_OPERATIONAL;
+    optiga_sim_set_object_content(optiga_sim_find_object(0xE0C0), OPTIGA_SIM_CONTENT_DATA, &value, 1);
+    value = 0x00;
+    optiga_sim_set_object_content(optiga_sim_find_object(0xE0C1), OPTIGA_SIM_CONTENT_DATA, &value, 1);
+    optiga_sim_set_object_content(optiga_sim_find_object(0xE0C2), OPTIGA_SIM_CONTENT_DATA,
+                                  optiga_sim_coprocessor_uid, sizeof(optiga_sim_coprocessor_uid));
+    /* Sleep mode activation delay 20 ms, 6 mA current limitation */
+    value = 0x14;
+    optiga_sim_set_object_content(optiga_sim_find_object(0xE0C3), OPTIGA_SIM_CONTENT_DATA, &value, 1);
+    value = 0x06;
+    optiga_sim_set_object_content(optiga_sim_find_object(OPTIGA_SIM_CURRENT_LIMIT_OID), OPTIGA_SIM_CONTENT_DATA, &value, 1);
+    value = 0x00;
+    optiga_sim_set_object_content(optiga_sim_find_object(0xE0C5), OPTIGA_SIM_CONTENT_DATA, &value, 1);
+    public_key[0] = (uint8_t)(OPTIGA_MAX_COMMS_BUFFER_SIZE >> 8);
+    public_key[1] = (uint8_t)(OPTIGA_MAX_COMMS_BUFFER_SIZE);
+    optiga_sim_set_object_content(optiga_sim_find_object(0xE0C6), OPTIGA_SIM_CONTENT_DATA, public_key, 2);
+
+    for (index = 0; index < 4; index++)
+    {
+        optiga_sim_set_object_content(optiga_sim_find_object((uint16_t)(0xE120 + index)), OPTIGA_SIM_CONTENT_DATA,
+                                      optiga_sim_counter_default, sizeof(optiga_sim_counter_default));
+    }
+
+    /* Device identity : NIST P-256 key in 0xE0F0 with a self signed certificate in 0xE0E0 */
+    object = optiga_sim_find_object(0xE0F0);
+    object->length = object->max_size;
+    if (TRUE == optiga_sim_crypto_ecc_generate((uint8_t)OPTIGA_ECC_CURVE_NIST_P_256,
+                                               object->data, &object->length,
+                                               public_key, &public_key_length))
+    {
+        if (TRUE == optiga_sim_crypto_ecc_self_signed_certificate(object->data, object->length,
+                                                                  certificate, &certificate_length))
+        {
+            optiga_sim_set_object_content(optiga_sim_find_object(0xE0E0), OPTIGA_SIM_CONTENT_DATA,
+                                          certificate, certificate_length);
+        }
+    }
+    else
+    {
+        object->length = 0;
+    }
+}
+
+void optiga_sim_init(void)
+{
+    const char * nvm_file;
+    uint16_t index;
+
+    pthread_mutex_lock(&optiga_sim_mutex);
+    do
+    {
+        if (TRUE == optiga_sim.initialized)
+        {
+            break;
+        }
+        for (index = 0; index < OPTIGA_SIM_OBJECTS; index++)
+        {
+            optiga_sim.objects[index].oid = optiga_sim_object_config[index].oid;
+            optiga_sim.objects[index].max_size = optiga_sim_object_config[index].max_size;
+            optiga_sim.objects[index].content = optiga_sim_object_config[index].content;
+            optiga_sim.objects[index].metadata_length = optiga_sim_object_config[index].metadata_length;
+            memcpy(optiga_sim.objects[index].metadata,
+                   optiga_sim_object_config[index].metadata,
+                   optiga_sim_object_config[index].metadata_length);
+            optiga_sim.objects[index].data = calloc(optiga_sim_object_config[index].max_size, 1);
+        }
+        for (index = 0; index < OPTIGA_SIM_SESSION_CONTEXTS; index++)
+        {
+            optiga_sim.sessions[index].oid = (uint16_t)(OPTIGA_SIM_SESSION_OID_BASE + index);
+            optiga_sim.sessions[index].max_size = OPTIGA_SIM_SESSION_SIZE;
+            optiga_sim.sessions[index].data = calloc(OPTIGA_SIM_SESSION_SIZE, 1);
+        }
+
+        nvm_file = getenv(OPTIGA_SIM_NVM_ENV);
+        if (NULL == nvm_file)
+        {
+            nvm_file = OPTIGA_SIM_NVM_DEFAULT_FILE;
+        }
+        (void)snprintf(optiga_sim.nvm_file, sizeof(optiga_sim.nvm_file), "%s", nvm_file);
+
+        if (FALSE == optiga_sim_load())
+        {
+            optiga_sim_provision();
+            optiga_sim_store();
+        }
+        optiga_sim_latency_init();
+        optiga_sim.os_event = pal_os_event_create(NULL, NULL);
+        optiga_sim.initialized = TRUE;
+    } while (FALSE);
+    pthread_mutex_unlock(&optiga_sim_mutex);
+}
+
+bool_t optiga_sim_register_instance(optiga_sim_instance_t * instance,
+                                    callback_handler_t handler,
+                                    void * caller_context)
+{
+    bool_t result = FALSE;
+
+    optiga_sim_init();
+    pthread_mutex_lock(&optiga_sim_mutex);
+    if (optiga_sim.registrations < OPTIGA_CMD_MAX_REGISTRATIONS)
+    {
+        optiga_sim.registrations++;
+        memset(instance, 0, sizeof(*instance));
+        instance->handler = handler;
+        instance->caller_context = caller_context;
+        instance->protection_level = OPTIGA_COMMS_DEFAULT_PROTECTION_LEVEL;
+        instance->protocol_version = OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET;
+        result = TRUE;
+    }
+    pthread_mutex_unlock(&optiga_sim_mutex);
+
+    return (result);
+}
+
+void optiga_sim_unregister_instance(optiga_sim_instance_t * instance)
+{
+    uint8_t index;
+
+    pthread_mutex_lock(&optiga_sim_mutex);
+    for (index = 0; index < OPTIGA_SIM_SESSION_CONTEXTS; index++)
+    {
+        if (instance == optiga_sim.session_owner[index])
+        {
+            optiga_sim.session_owner[index] = NULL;
+            optiga_sim.sessions[index].length = 0;
+        }
+    }
+    instance->session_oid = 0;
+    if (optiga_sim.registrations > 0)
+    {
+        optiga_sim.registrations--;
+    }
+    pthread_mutex_unlock(&optiga_sim_mutex);
+}
+
+/**
+ * Checks that the host and the simulated chip share the same platform binding secret,
+ * which is what the pre-shared secret based handshake of the shielded connection verifies.
+ */
+static bool_t optiga_sim_binding_matches(uint16_t binding_oid)
+{
+    uint8_t host_secret[OPTIGA_SIM_BINDING_SECRET_MAX];
+    uint16_t host_secret_length = sizeof(host_secret);
+    const optiga_sim_object_t * binding = optiga_sim_find_object(binding_oid);
+
+    if ((NULL == binding) || (0 == binding->length))
+    {
+        return FALSE;
+    }
+    if (PAL_STATUS_SUCCESS != pal_os_datastore_read(OPTIGA_PLATFORM_BINDING_SHARED_SECRET_ID,
+                                                    host_secret,
+                                                    &host_secret_length))
+    {
+        return FALSE;
+    }
+    return (bool_t)((host_secret_length == binding->length) &&
+                    (0 == memcmp(host_secret, binding->data, host_secret_length)));
+}
+
+optiga_lib_status_t optiga_sim_begin(optiga_sim_instance_t * instance,
+                                     uint8_t command,
+                                     bool_t requires_application)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+
+    if (TRUE == instance->busy)
+    {
+        return (OPTIGA_LIB_BUSY);
+    }
+    pthread_mutex_lock(&optiga_sim_execution_mutex);
+    instance->busy = TRUE;
+    memset(&instance->request, 0, sizeof(instance->request));
+    instance->request.command = command;
+    instance->request.shielded = (bool_t)(OPTIGA_COMMS_NO_PROTECTION !=
+                                          (instance->protection_level & OPTIGA_COMMS_FULL_PROTECTION));
+
+    do
+    {
+        if ((TRUE == requires_application) && (FALSE == optiga_sim.application_open))
+        {
+            return_status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_COMMAND_OUT_OF_SEQUENCE);
+            break;
+        }
+        if ((OPTIGA_COMMS_NO_PROTECTION != (instance->protection_level & OPTIGA_COMMS_FULL_PROTECTION)) &&
+            (FALSE == optiga_sim_binding_matches(OPTIGA_SIM_PLATFORM_BINDING_OID)))
+        {
+            return_status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_HANDSHAKE);
+            break;
+        }
+    } while (FALSE);
+
+    return (return_status);
+}
+
+void optiga_sim_set_variant(optiga_sim_instance_t * instance, uint8_t variant)
+{
+    instance->request.variant = variant;
+}
+
+void optiga_sim_set_transfer(optiga_sim_instance_t * instance,
+                             uint32_t command_length,
+                             uint32_t response_length,
+                             uint32_t data_length)
+{
+    instance->request.command_length = command_length;
+    instance->request.response_length = response_length;
+    instance->request.data_length = data_length;
+}
+
+static void optiga_sim_event_handler(void * context);
+
+/**
+ * Arms the PAL event for the completion at the head of the queue. Must be called with the state locked.
+ */
+static void optiga_sim_schedule_completion(void)
+{
+    uint64_t now = optiga_sim_latency_now();
+    uint64_t due = optiga_sim.completions[optiga_sim.completion_head].due_us;
+
+    pal_os_event_register_callback_oneshot(optiga_sim.os_event,
+                                           optiga_sim_event_handler,
+                                           NULL,
+                                           (due > now) ? (uint32_t)(due - now) : 0);
+}
+
+static void optiga_sim_event_handler(void * context)
+{
+    optiga_sim_completion_t completion;
+    bool_t pending = FALSE;
+
+    (void)context;
+    pthread_mutex_lock(&optiga_sim_mutex);
+    if (0 != optiga_sim.completion_count)
+    {
+        completion = optiga_sim.completions[optiga_sim.completion_head];
+        if (completion.due_us > optiga_sim_latency_now())
+        {
+            /* Woken up early (e.g. the event was triggered explicitly), wait for the response */
+            optiga_sim_schedule_completion();
+        }
+        else
+        {
+            optiga_sim.completion_head = (uint8_t)((optiga_sim.completion_head + 1) % OPTIGA_SIM_COMPLETION_QUEUE_SIZE);
+            optiga_sim.completion_count--;
+            pending = TRUE;
+            if (0 != optiga_sim.completion_count)
+            {
+                optiga_sim_schedule_completion();
+            }
+        }
+    }
+    pthread_mutex_unlock(&optiga_sim_mutex);
+
+    if (TRUE == pending)
+    {
+        /* As the library does, the protection level applies to one request only */
+        completion.instance->protection_level = OPTIGA_COMMS_DEFAULT_PROTECTION_LEVEL;
+        completion.instance->busy = FALSE;
+        if (NULL != completion.instance->handler)
+        {
+            completion.instance->handler(completion.instance->caller_context, completion.status);
+        }
+    }
+}
+
+void optiga_sim_complete(optiga_sim_instance_t * instance, optiga_lib_status_t status)
+{
+    const optiga_sim_object_t * current_limit = optiga_sim_find_object(OPTIGA_SIM_CURRENT_LIMIT_OID);
+    uint64_t start;
+    uint32_t latency_us;
+    uint8_t tail;
+
+    instance->request.succeeded = (bool_t)(OPTIGA_LIB_SUCCESS == status);
+
+    pthread_mutex_lock(&optiga_sim_mutex);
+    /* Commands are executed in order: a request starts when the chip is done with the previous ones */
+    start = optiga_sim_latency_now();
+    if (optiga_sim.busy_until_us > start)
+    {
+        start = optiga_sim.busy_until_us;
+    }
+    /* The I2C PAL accounts the frames on the bus and the time the chip executes */
+    latency_us = pal_i2c_sim_exchange(instance->request.command_length,
+                                      (TRUE == instance->request.succeeded) ? instance->request.response_length : 0,
+                                      instance->request.shielded,
+                                      optiga_sim_latency_get(&instance->request,
+                                                             (0 != current_limit->length) ?
+                                                             current_limit->data[0] :
+                                                             OPTIGA_SIM_LATENCY_MIN_CURRENT_MA));
+    optiga_sim.busy_until_us = start + ((TRUE == optiga_sim_latency_is_enabled()) ? latency_us : 0);
+
+    tail = (uint8_t)((optiga_sim.completion_head + optiga_sim.completion_count) % OPTIGA_SIM_COMPLETION_QUEUE_SIZE);
+    optiga_sim.completions[tail].instance = instance;
+    optiga_sim.completions[tail].status = status;
+    optiga_sim.completions[tail].due_us = optiga_sim.busy_until_us;
+    optiga_sim.completion_count++;
+    if (1 == optiga_sim.completion_count)
+    {
+        optiga_sim_schedule_completion();
+    }
+    pthread_mutex_unlock(&optiga_sim_mutex);
+
+    pthread_mutex_unlock(&optiga_sim_execution_mutex);
+}
+
+optiga_sim_object_t * optiga_sim_find_object(uint16_t oid)
+{
+    uint16_t index;
+
+    for (index = 0; index < OPTIGA_SIM_OBJECTS; index++)
+    {
+        if (oid == optiga_sim.objects[index].oid)
+        {
+            return (&optiga_sim.objects[index]);
+        }
+    }
+    return (NULL);
+}
+
+const uint8_t * optiga_sim_get_metadata_tag(const optiga_sim_object_t * object,
+                                            uint8_t tag,
+                                            uint8_t * value_length)
+{
+    uint8_t index = 0;
+
+    while ((index + 1) < object->metadata_length)
+    {
+        if (tag == object->metadata[index])
+        {
+            *value_length = object->metadata[index + 1];
+            return (&object->metadata[index + 2]);
+        }
+        index = (uint8_t)(index + 2 + object->metadata[index + 1]);
+    }
+    return (NULL);
+}
+
+void optiga_sim_set_metadata_tag(optiga_sim_object_t * object,
+                                 uint8_t tag,
+                                 const uint8_t * value,
+                                 uint8_t value_length)
+{
+    uint8_t index = 0;
+    uint8_t tlv_length;
+
+    /* Remove the existing TLV */
+    while ((index + 1) < object->metadata_length)
+    {
+        tlv_length = (uint8_t)(2 + object->metadata[index + 1]);
+        if (tag == object->metadata[index])
+        {
+            memmove(&object->metadata[index],
+                    &object->metadata[index + tlv_length],
+                    (size_t)(object->metadata_length - index - tlv_length));
+            object->metadata_length = (uint8_t)(object->metadata_length - tlv_length);
+            break;
+        }
+        index = (uint8_t)(index + tlv_length);
+    }
+    if ((object->metadata_length + 2 + value_length) <= OPTIGA_SIM_METADATA_MAX_LENGTH)
+    {
+        object->metadata[object->metadata_length++] = tag;
+        object->metadata[object->metadata_length++] = value_length;
+        memcpy(&object->metadata[object->metadata_length], value, value_length);
+        object->metadata_length = (uint8_t)(object->metadata_length + value_length);
+    }
+}
+
+static uint8_t optiga_sim_get_lcso(const optiga_sim_object_t * object)
+{
+    uint8_t length;
+    const uint8_t * lcso = optiga_sim_get_metadata_tag(object, OPTIGA_SIM_TAG_LCSO, &length);
+    return ((NULL != lcso) ? lcso[0] : OPTIGA_SIM_LCS_CREATION);
+}
+
+static bool_t optiga_sim_compare(uint8_t operator, uint8_t current, uint8_t reference)
+{
+    switch (operator)
+    {
+        case OPTIGA_SIM_AC_EQ: return (bool_t)(current == reference);
+        case OPTIGA_SIM_AC_GT: return (bool_t)(current > reference);
+        case OPTIGA_SIM_AC_LT: return (bool_t)(current < reference);
+        default: return FALSE;
+    }
+}
+
+static uint32_t optiga_sim_get_uint32(const uint8_t * buffer)
+{
+    return (((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) | ((uint32_t)buffer[2] << 8) | buffer[3]);
+}
+
+/**
+ * Evaluates one access condition identifier and advances the cursor past it.
+ */
+static bool_t optiga_sim_evaluate_condition(const uint8_t ** cursor,
+                                            const uint8_t * end,
+                                            const optiga_sim_object_t * object,
+                                            uint8_t access_tag,
+                                            const optiga_sim_instance_t * instance)
+{
+    const uint8_t * condition = *cursor;
+    const optiga_sim_object_t * reference;
+    uint16_t reference_oid = 0;
+    uint8_t protection;
+    bool_t result = FALSE;
+
+    switch (condition[0])
+    {
+        case OPTIGA_SIM_AC_ALW:
+            *cursor += 1;
+            return TRUE;
+        case OPTIGA_SIM_AC_NEV:
+            *cursor += 1;
+            return FALSE;
+        default:
+            break;
+    }
+
+    if ((condition + 3) > end)
+    {
+        *cursor = end;
+        return FALSE;
+    }
+    *cursor += 3;
+    reference_oid = (uint16_t)((condition[1] << 8) | condition[2]);
+
+    switch (condition[0])
+    {
+        case OPTIGA_SIM_AC_CONF:
+        {
+            /* Read requires a protected response, change/execute a protected command */
+            protection = (OPTIGA_SIM_TAG_READ == access_tag) ? OPTIGA_COMMS_RESPONSE_PROTECTION :
+                                                               OPTIGA_COMMS_COMMAND_PROTECTION;
+            result = (bool_t)((NULL != instance) &&
+                              (0 != (instance->protection_level & protection)) &&
+                              (TRUE == optiga_sim_binding_matches(reference_oid)));
+        }
+        break;
+        case OPTIGA_SIM_AC_INT:
+        {
+            /* Integrity is only provided by a protected update (see optiga_util_protected_update_xxxx) */
+            result = FALSE;
+        }
+        break;
+        case OPTIGA_SIM_AC_AUTO:
+        {
+            if ((reference_oid >= OPTIGA_SIM_SECRET_OID_FIRST) && (reference_oid <= OPTIGA_SIM_SECRET_OID_LAST))
+            {
+                result = optiga_sim.auto_state[reference_oid - OPTIGA_SIM_SECRET_OID_FIRST];
+            }
+        }
+        break;
+        case OPTIGA_SIM_AC_LUC:
+        {
+            reference = optiga_sim_find_object(reference_oid);
+            result = (bool_t)((NULL != reference) && (8 == reference->length) &&
+                              (optiga_sim_get_uint32(reference->data) < optiga_sim_get_uint32(&reference->data[4])));
+        }
+        break;
+        case OPTIGA_SIM_AC_LCSG:
+        {
+            result = optiga_sim_compare(condition[1], optiga_sim_find_object(0xE0C0)->data[0], condition[2]);
+        }
+        break;
+        case OPTIGA_SIM_AC_SECSTA:
+        {
+            result = optiga_sim_compare(condition[1], optiga_sim_find_object(0xE0C1)->data[0], condition[2]);
+        }
+        break;
+        case OPTIGA_SIM_AC_LCSA:
+        {
+            result = optiga_sim_compare(condition[1], OPTIGA_SIM_LCS_OPERATIONAL, condition[2]);
+        }
+        break;
+        case OPTIGA_SIM_AC_LCSO:
+        {
+            result = optiga_sim_compare(condition[1], optiga_sim_get_lcso(object), condition[2]);
+        }
+        break;
+        default:
+        {
+            *cursor = end;
+            result = FALSE;
+        }
+        break;
+    }
+    return (result);
+}
+
+optiga_lib_status_t optiga_sim_check_access(const optiga_sim_object_t * object,
+                                            uint8_t access_tag,
+                                            const optiga_sim_instance_t * instance)
+{
+    const uint8_t * cursor;
+    const uint8_t * end;
+    uint8_t length;
+    bool_t any_group = FALSE;
+    bool_t this_group = TRUE;
+
+    cursor = optiga_sim_get_metadata_tag(object, access_tag, &length);
+    if ((NULL == cursor) || (0 == length))
+    {
+        /* Access condition not defined: NEV for read of keys, ALW otherwise */
+        if ((OPTIGA_SIM_TAG_READ == access_tag) && (OPTIGA_SIM_CONTENT_DATA != object->content))
+        {
+            return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_ACCESS_CONDITION));
+        }
+        return (OPTIGA_LIB_SUCCESS);
+    }
+    end = cursor + length;
+
+    /* && binds stronger than || */
+    while (cursor < end)
+    {
+        if (FALSE == optiga_sim_evaluate_condition(&cursor, end, object, access_tag, instance))
+        {
+            this_group = FALSE;
+        }
+        if ((cursor < end) && (OPTIGA_SIM_AC_OR == *cursor))
+        {
+            any_group = (bool_t)(any_group || this_group);
+            this_group = TRUE;
+        }
+        if (cursor < end)
+        {
+            cursor++;
+        }
+    }
+    any_group = (bool_t)(any_group || this_group);
+
+    return ((TRUE == any_group) ? OPTIGA_LIB_SUCCESS : OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_ACCESS_CONDITION));
+}
+
+static uint16_t optiga_sim_encode_size_tag(uint8_t tag, uint16_t value, uint8_t * buffer)
+{
+    buffer[0] = tag;
+    if (value > 0xFF)
+    {
+        buffer[1] = 0x02;
+        buffer[2] = (uint8_t)(value >> 8);
+        buffer[3] = (uint8_t)value;
+        return 4;
+    }
+    buffer[1] = 0x01;
+    buffer[2] = (uint8_t)value;
+    return 3;
+}
+
+uint16_t optiga_sim_encode_metadata(const optiga_sim_object_t * object, uint8_t * buffer, uint16_t buffer_length)
+{
+    uint8_t encoded[OPTIGA_SIM_METADATA_MAX_LENGTH + 16];
+    uint16_t length = 2;
+    uint8_t index = 0;
+    uint8_t tlv_length;
+
+    /* The life cycle state is always reported first */
+    encoded[length++] = OPTIGA_SIM_TAG_LCSO;
+    encoded[length++] = 0x01;
+    encoded[length++] = optiga_sim_get_lcso(object);
+    length = (uint16_t)(length + optiga_sim_encode_size_tag(OPTIGA_SIM_TAG_MAX_SIZE, object->max_size, &encoded[length]));
+    length = (uint16_t)(length + optiga_sim_encode_size_tag(OPTIGA_SIM_TAG_USED_SIZE, object->length, &encoded[length]));
+    while ((index + 1) < object->metadata_length)
+    {
+        tlv_length = (uint8_t)(2 + object->metadata[index + 1]);
+        if (OPTIGA_SIM_TAG_LCSO != object->metadata[index])
+        {
+            memcpy(&encoded[length], &object->metadata[index], tlv_length);
+            length = (uint16_t)(length + tlv_length);
+        }
+        index = (uint8_t)(index + tlv_length);
+    }
+    encoded[0] = OPTIGA_SIM_TAG_METADATA;
+    encoded[1] = (uint8_t)(length - 2);
+
+    if (length > buffer_length)
+    {
+        return 0;
+    }
+    memcpy(buffer, encoded, length);
+    return (length);
+}
+
+optiga_lib_status_t optiga_sim_update_metadata(optiga_sim_object_t * object, const uint8_t * metadata, uint8_t length)
+{
+    uint8_t index = 2;
+    uint8_t tag;
+    uint8_t value_length;
+
+    if ((length < 2) || (OPTIGA_SIM_TAG_METADATA != metadata[0]) || ((metadata[1] + 2) != length))
+    {
+        return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER));
+    }
+    /* Validate the complete update before applying anything */
+    while (index < length)
+    {
+        if ((index + 2) > length)
+        {
+            return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER));
+        }
+        tag = metadata[index];
+        value_length = metadata[index + 1];
+        if ((index + 2 + value_length) > length)
+        {
+            return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER));
+        }
+        if ((OPTIGA_SIM_TAG_MAX_SIZE == tag) || (OPTIGA_SIM_TAG_USED_SIZE == tag))
+        {
+            return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER));
+        }
+        if ((OPTIGA_SIM_TAG_LCSO == tag) &&
+            ((1 != value_length) || (metadata[index + 2] < optiga_sim_get_lcso(object))))
+        {
+            /* The life cycle state can only be increased */
+            return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER));
+        }
+        index = (uint8_t)(index + 2 + value_length);
+    }
+
+    index = 2;
+    while (index < length)
+    {
+        optiga_sim_set_metadata_tag(object, metadata[index], &metadata[index + 2], metadata[index + 1]);
+        index = (uint8_t)(index + 2 + metadata[index + 1]);
+    }
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+void optiga_sim_set_object_content(optiga_sim_object_t * object,
+                                   uint8_t content,
+                                   const uint8_t * data,
+                                   uint16_t length)
+{
+    if ((NULL == object) || (length > object->max_size))
+    {
+        return;
+    }
+    if (data != object->data)
+    {
+        memcpy(object->data, data, length);
+    }
+    object->length = length;
+    object->content = content;
+    if ((object->oid >= OPTIGA_SIM_SECRET_OID_FIRST) && (object->oid <= OPTIGA_SIM_SECRET_OID_LAST))
+    {
+        /* A rewritten authorization reference has to be verified again */
+        optiga_sim.auto_state[object->oid - OPTIGA_SIM_SECRET_OID_FIRST] = FALSE;
+    }
+}
+
+optiga_sim_object_t * optiga_sim_acquire_session(optiga_sim_instance_t * instance)
+{
+    optiga_sim_object_t * session = NULL;
+    uint8_t index;
+
+    pthread_mutex_lock(&optiga_sim_mutex);
+    for (index = 0; index < OPTIGA_SIM_SESSION_CONTEXTS; index++)
+    {
+        if (instance == optiga_sim.session_owner[index])
+        {
+            session = &optiga_sim.sessions[index];
+            break;
+        }
+    }
+    for (index = 0; (NULL == session) && (index < OPTIGA_SIM_SESSION_CONTEXTS); index++)
+    {
+        if (NULL == optiga_sim.session_owner[index])
+        {
+            optiga_sim.session_owner[index] = instance;
+            session = &optiga_sim.sessions[index];
+            instance->session_oid = session->oid;
+        }
+    }
+    pthread_mutex_unlock(&optiga_sim_mutex);
+
+    return (session);
+}
+
+optiga_sim_object_t * optiga_sim_get_session(const optiga_sim_instance_t * instance)
+{
+    uint8_t index;
+
+    for (index = 0; index < OPTIGA_SIM_SESSION_CONTEXTS; index++)
+    {
+        if ((instance == optiga_sim.session_owner[index]) && (0 != optiga_sim.sessions[index].length))
+        {
+            return (&optiga_sim.sessions[index]);
+        }
+    }
+    return (NULL);
+}
+
+optiga_lib_status_t optiga_sim_open_application(bool_t perform_restore)
+{
+    uint8_t index;
+
+    if (TRUE == perform_restore)
+    {
+        if (FALSE == optiga_sim.application_hibernated)
+        {
+            return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER));
+        }
+    }
+    else
+    {
+        /* A fresh application context drops the sessions and the authorization states */
+        for (index = 0; index < OPTIGA_SIM_SESSION_CONTEXTS; index++)
+        {
+            optiga_sim.sessions[index].length = 0;
+        }
+        memset(optiga_sim.auto_state, 0, sizeof(optiga_sim.auto_state));
+        optiga_sim.auth_code.valid = FALSE;
+    }
+    optiga_sim.application_hibernated = FALSE;
+    optiga_sim.application_open = TRUE;
+    optiga_sim_store();
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_sim_close_application(bool_t perform_hibernate)
+{
+    if (FALSE == optiga_sim.application_open)
+    {
+        return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_COMMAND_OUT_OF_SEQUENCE));
+    }
+    if ((TRUE == perform_hibernate) && (0 != optiga_sim_find_object(0xE0C5)->data[0]))
+    {
+        /* Hibernate is refused while the security event counter is not zero */
+        return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_COMMAND_OUT_OF_SEQUENCE));
+    }
+    optiga_sim.application_open = FALSE;
+    optiga_sim.application_hibernated = perform_hibernate;
+    optiga_sim_store();
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+void optiga_sim_set_auth_code(const uint8_t * optional_data, uint16_t optional_data_length,
+                              const uint8_t * random, uint16_t random_length)
+{
+    optiga_sim.auth_code.valid = FALSE;
+    if ((optional_data_length <= OPTIGA_SIM_AUTH_CODE_MAX_LENGTH) && (random_length <= OPTIGA_SIM_AUTH_CODE_MAX_LENGTH))
+    {
+        if (0 != optional_data_length)
+        {
+            memcpy(optiga_sim.auth_code.optional_data, optional_data, optional_data_length);
+        }
+        memcpy(optiga_sim.auth_code.random, random, random_length);
+        optiga_sim.auth_code.optional_data_length = optional_data_length;
+        optiga_sim.auth_code.random_length = random_length;
+        optiga_sim.auth_code.valid = TRUE;
+    }
+}
+
+optiga_lib_status_t optiga_sim_verify_auth_code(uint16_t secret_oid, const uint8_t * input_data, uint32_t input_data_length)
+{
+    optiga_sim_auth_code_t * auth_code = &optiga_sim.auth_code;
+    bool_t match;
+
+    (void)secret_oid;
+    if (FALSE == auth_code->valid)
+    {
+        return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_COMMAND_OUT_OF_SEQUENCE));
+    }
+    /* The input must start with optional data || authorization code and the code is usable once */
+    match = (bool_t)((input_data_length >= (uint32_t)(auth_code->optional_data_length + auth_code->random_length)) &&
+                     (0 == memcmp(input_data, auth_code->optional_data, auth_code->optional_data_length)) &&
+                     (0 == memcmp(&input_data[auth_code->optional_data_length], auth_code->random, auth_code->random_length)));
+    auth_code->valid = FALSE;
+
+    return ((TRUE == match) ? OPTIGA_LIB_SUCCESS : OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_AUTHORIZATION_FAILURE));
+}
+
+void optiga_sim_set_auto_state(uint16_t secret_oid, bool_t state)
+{
+    if ((secret_oid >= OPTIGA_SIM_SECRET_OID_FIRST) && (secret_oid <= OPTIGA_SIM_SECRET_OID_LAST))
+    {
+        optiga_sim.auto_state[secret_oid - OPTIGA_SIM_SECRET_OID_FIRST] = state;
+    }
+}
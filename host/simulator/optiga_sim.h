@@ -0,0 +1,360 @@
+/******************************************************************************
+* File Name:   optiga_sim.h
+*
+* Description: This file provides the internal interface of the host side
+*              OPTIGA Trust M simulator. It is shared by the simulated
+*              optiga_crypt and optiga_util implementations.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef _OPTIGA_SIM_H_
+#define _OPTIGA_SIM_H_
+
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga_sim_latency.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Device error as reported by the chip (see Solution Reference Manual, error codes) */
+#define OPTIGA_SIM_DEVICE_ERROR(code)               ((optiga_lib_status_t)(OPTIGA_DEVICE_ERROR | (code)))
+
+#define OPTIGA_SIM_ERROR_INVALID_OID                (0x01)
+#define OPTIGA_SIM_ERROR_INVALID_PARAM_FIELD        (0x03)
+#define OPTIGA_SIM_ERROR_INVALID_LENGTH_FIELD       (0x04)
+#define OPTIGA_SIM_ERROR_INVALID_PARAMETER          (0x05)
+#define OPTIGA_SIM_ERROR_INTERNAL_PROCESS           (0x06)
+#define OPTIGA_SIM_ERROR_ACCESS_CONDITION           (0x07)
+#define OPTIGA_SIM_ERROR_DATA_OBJECT_BOUNDARY       (0x08)
+#define OPTIGA_SIM_ERROR_METADATA_TRUNCATION        (0x09)
+#define OPTIGA_SIM_ERROR_INVALID_COMMAND            (0x0A)
+#define OPTIGA_SIM_ERROR_COMMAND_OUT_OF_SEQUENCE    (0x0B)
+#define OPTIGA_SIM_ERROR_COMMAND_NOT_AVAILABLE      (0x0C)
+#define OPTIGA_SIM_ERROR_INSUFFICIENT_MEMORY        (0x0D)
+#define OPTIGA_SIM_ERROR_COUNTER_THRESHOLD          (0x0E)
+#define OPTIGA_SIM_ERROR_INVALID_MANIFEST           (0x0F)
+#define OPTIGA_SIM_ERROR_INVALID_HANDSHAKE          (0x21)
+#define OPTIGA_SIM_ERROR_SIGNATURE_VERIFICATION     (0x2B)
+#define OPTIGA_SIM_ERROR_INTEGRITY_VALIDATION       (0x2C)
+#define OPTIGA_SIM_ERROR_DECRYPTION_FAILURE         (0x2D)
+#define OPTIGA_SIM_ERROR_AUTHORIZATION_FAILURE      (0x2E)
+
+/** @brief Metadata tags */
+#define OPTIGA_SIM_TAG_METADATA                     (0x20)
+#define OPTIGA_SIM_TAG_LCSO                         (0xC0)
+#define OPTIGA_SIM_TAG_VERSION                      (0xC1)
+#define OPTIGA_SIM_TAG_MAX_SIZE                     (0xC4)
+#define OPTIGA_SIM_TAG_USED_SIZE                    (0xC5)
+#define OPTIGA_SIM_TAG_CHANGE                       (0xD0)
+#define OPTIGA_SIM_TAG_READ                         (0xD1)
+#define OPTIGA_SIM_TAG_EXECUTE                      (0xD3)
+#define OPTIGA_SIM_TAG_ALGORITHM                    (0xE0)
+#define OPTIGA_SIM_TAG_KEY_USAGE                    (0xE1)
+#define OPTIGA_SIM_TAG_DATA_OBJECT_TYPE             (0xE8)
+
+/** @brief Life cycle states */
+#define OPTIGA_SIM_LCS_CREATION                     (0x01)
+#define OPTIGA_SIM_LCS_INITIALIZATION               (0x03)
+#define OPTIGA_SIM_LCS_OPERATIONAL                  (0x07)
+#define OPTIGA_SIM_LCS_TERMINATION                  (0x0F)
+
+/** @brief Data object types (tag 0xE8) */
+#define OPTIGA_SIM_DATA_TYPE_BSTR                   (0x00)
+#define OPTIGA_SIM_DATA_TYPE_UPCTR                  (0x01)
+#define OPTIGA_SIM_DATA_TYPE_TA                     (0x11)
+#define OPTIGA_SIM_DATA_TYPE_PRESSEC                (0x21)
+#define OPTIGA_SIM_DATA_TYPE_PTFBIND                (0x22)
+#define OPTIGA_SIM_DATA_TYPE_UPDATSEC               (0x23)
+#define OPTIGA_SIM_DATA_TYPE_AUTOREF                (0x31)
+
+/** @brief Maximum length of the metadata TLVs stored per object (without the 0x20 header) */
+#define OPTIGA_SIM_METADATA_MAX_LENGTH              (0x40)
+
+/** @brief Number of session contexts (0xE100 - 0xE103) */
+#define OPTIGA_SIM_SESSION_CONTEXTS                 (0x04)
+#define OPTIGA_SIM_SESSION_OID_BASE                 (0xE100)
+
+/** @brief Kind of content held by a data object */
+typedef enum optiga_sim_content
+{
+    OPTIGA_SIM_CONTENT_DATA = 0,
+    OPTIGA_SIM_CONTENT_ECC_KEY,
+    OPTIGA_SIM_CONTENT_RSA_KEY,
+    OPTIGA_SIM_CONTENT_AES_KEY,
+    OPTIGA_SIM_CONTENT_SECRET
+} optiga_sim_content_t;
+
+/** @brief A data object or key object held by the simulated chip */
+typedef struct optiga_sim_object
+{
+    /// Object identifier
+    uint16_t oid;
+    /// Maximum size of the object content
+    uint16_t max_size;
+    /// Currently used size of the object content
+    uint16_t length;
+    /// Kind of content (plain data, private key in DER, raw secret)
+    uint8_t content;
+    /// Length of the stored metadata TLVs
+    uint8_t metadata_length;
+    /// Metadata TLVs, without the 0x20 header
+    uint8_t metadata[OPTIGA_SIM_METADATA_MAX_LENGTH];
+    /// Object content
+    uint8_t * data;
+} optiga_sim_object_t;
+
+/** @brief State shared by every simulated crypt/util instance */
+typedef struct optiga_sim_instance
+{
+    /// Upper layer callback and its context
+    callback_handler_t handler;
+    void * caller_context;
+    /// Set while a request of this instance is waiting for its completion
+    volatile uint8_t busy;
+    /// Shielded connection settings for the next request
+    uint8_t protection_level;
+    uint8_t protocol_version;
+    /// Session context acquired by this instance (0 if none)
+    uint16_t session_oid;
+    /// Cost of the request in flight, used to delay its completion
+    optiga_sim_latency_request_t request;
+} optiga_sim_instance_t;
+
+/**
+ * \brief Initializes the simulator (object store, default keys and certificate) on first use.
+ */
+void optiga_sim_init(void);
+
+/**
+ * \brief Registers a new crypt/util instance against the simulated chip.
+ *
+ * \retval  TRUE  if a command registration slot is available
+ * \retval  FALSE if all #OPTIGA_CMD_MAX_REGISTRATIONS slots are in use
+ */
+bool_t optiga_sim_register_instance(optiga_sim_instance_t * instance,
+                                    callback_handler_t handler,
+                                    void * caller_context);
+
+/**
+ * \brief Releases the registration slot and the session context held by the instance.
+ */
+void optiga_sim_unregister_instance(optiga_sim_instance_t * instance);
+
+/**
+ * \brief Marks the instance busy and validates that the request may be issued.
+ *
+ * \details
+ * Returns #OPTIGA_LIB_BUSY if the instance already has a request in flight.
+ * Otherwise the request is accepted and the returned device status tells whether
+ * the application is open and the shielded connection (if requested) is established.
+ * The caller must always complete an accepted request using #optiga_sim_complete.
+ *
+ * \param[in] command   Command the request is mapped to (#optiga_sim_command_t), selects the latency
+ */
+optiga_lib_status_t optiga_sim_begin(optiga_sim_instance_t * instance,
+                                     uint8_t command,
+                                     bool_t requires_application);
+
+/**
+ * \brief Records the algorithm used by the current request (curve, RSA or AES key type).
+ */
+void optiga_sim_set_variant(optiga_sim_instance_t * instance, uint8_t variant);
+
+/**
+ * \brief Records the APDU payload lengths and the amount of processed data of the current request.
+ */
+void optiga_sim_set_transfer(optiga_sim_instance_t * instance,
+                             uint32_t command_length,
+                             uint32_t response_length,
+                             uint32_t data_length);
+
+/**
+ * \brief Queues the asynchronous completion of the current request of the instance.
+ *
+ * \details
+ * The chip executes one command at a time: the completion is signalled once the chip is done with
+ * the previously queued commands and the latency of this request has elapsed.
+ */
+void optiga_sim_complete(optiga_sim_instance_t * instance, optiga_lib_status_t status);
+
+/**
+ * \brief Stores the object store to the non-volatile image (if persistence is enabled).
+ */
+void optiga_sim_store(void);
+
+/**
+ * \brief Looks up a data/key object. Session contexts are not returned.
+ */
+optiga_sim_object_t * optiga_sim_find_object(uint16_t oid);
+
+/**
+ * \brief Returns the value of a metadata tag of an object, NULL if not present.
+ */
+const uint8_t * optiga_sim_get_metadata_tag(const optiga_sim_object_t * object,
+                                            uint8_t tag,
+                                            uint8_t * value_length);
+
+/**
+ * \brief Adds or replaces a metadata tag of an object.
+ */
+void optiga_sim_set_metadata_tag(optiga_sim_object_t * object,
+                                 uint8_t tag,
+                                 const uint8_t * value,
+                                 uint8_t value_length);
+
+/**
+ * \brief Evaluates the access condition (0xD0, 0xD1 or 0xD3) of an object for the given instance.
+ */
+optiga_lib_status_t optiga_sim_check_access(const optiga_sim_object_t * object,
+                                            uint8_t access_tag,
+                                            const optiga_sim_instance_t * instance);
+
+/**
+ * \brief Builds the metadata as returned by the chip (0x20 header, LcsO first, sizes appended).
+ */
+uint16_t optiga_sim_encode_metadata(const optiga_sim_object_t * object, uint8_t * buffer, uint16_t buffer_length);
+
+/**
+ * \brief Applies a metadata update (0x20 LL TLVs) as written by the host.
+ */
+optiga_lib_status_t optiga_sim_update_metadata(optiga_sim_object_t * object, const uint8_t * metadata, uint8_t length);
+
+/**
+ * \brief Replaces the content of an object, clearing the AUTO state if a secret is rewritten.
+ */
+void optiga_sim_set_object_content(optiga_sim_object_t * object,
+                                   uint8_t content,
+                                   const uint8_t * data,
+                                   uint16_t length);
+
+/**
+ * \brief Session context handling. The session context is owned by one crypt instance.
+ */
+optiga_sim_object_t * optiga_sim_acquire_session(optiga_sim_instance_t * instance);
+optiga_sim_object_t * optiga_sim_get_session(const optiga_sim_instance_t * instance);
+
+/**
+ * \brief Application life cycle (open/close/hibernate) of the simulated chip.
+ */
+optiga_lib_status_t optiga_sim_open_application(bool_t perform_restore);
+optiga_lib_status_t optiga_sim_close_application(bool_t perform_hibernate);
+
+/**
+ * \brief Authorization reference (AUTO) state handling of secrets in 0xF1D0 - 0xF1DB.
+ */
+void optiga_sim_set_auth_code(const uint8_t * optional_data, uint16_t optional_data_length,
+                              const uint8_t * random, uint16_t random_length);
+optiga_lib_status_t optiga_sim_verify_auth_code(uint16_t secret_oid, const uint8_t * input_data, uint32_t input_data_length);
+void optiga_sim_set_auto_state(uint16_t secret_oid, bool_t state);
+
+/**
+ * \brief Crypto primitives of the simulated chip (host crypto library backed).
+ */
+bool_t optiga_sim_crypto_random(uint8_t * buffer, uint32_t length);
+
+uint16_t optiga_sim_crypto_ecc_key_size(uint8_t curve);
+bool_t optiga_sim_crypto_ecc_generate(uint8_t curve,
+                                      uint8_t * private_key, uint16_t * private_key_length,
+                                      uint8_t * public_key, uint16_t * public_key_length);
+bool_t optiga_sim_crypto_ecc_export_private(const uint8_t * private_key, uint16_t private_key_length,
+                                            uint8_t * exported, uint16_t * exported_length);
+bool_t optiga_sim_crypto_ecdsa_sign(const uint8_t * private_key, uint16_t private_key_length,
+                                    const uint8_t * digest, uint8_t digest_length,
+                                    uint8_t * signature, uint16_t * signature_length);
+bool_t optiga_sim_crypto_ecdsa_verify(uint8_t curve, const uint8_t * public_key, uint16_t public_key_length,
+                                      const uint8_t * digest, uint8_t digest_length,
+                                      const uint8_t * signature, uint16_t signature_length);
+bool_t optiga_sim_crypto_ecdh(const uint8_t * private_key, uint16_t private_key_length,
+                              uint8_t curve, const uint8_t * public_key, uint16_t public_key_length,
+                              uint8_t * shared_secret, uint16_t * shared_secret_length);
+bool_t optiga_sim_crypto_ecc_self_signed_certificate(const uint8_t * private_key, uint16_t private_key_length,
+                                                     uint8_t * certificate, uint16_t * certificate_length);
+bool_t optiga_sim_crypto_certificate_public_key(const uint8_t * certificate, uint16_t certificate_length,
+                                                uint8_t * public_key, uint16_t * public_key_length,
+                                                uint8_t * key_type);
+
+bool_t optiga_sim_crypto_rsa_generate(uint16_t bits,
+                                      uint8_t * private_key, uint16_t * private_key_length,
+                                      uint8_t * public_key, uint16_t * public_key_length);
+bool_t optiga_sim_crypto_rsa_export_private(const uint8_t * private_key, uint16_t private_key_length,
+                                            uint8_t * exported, uint16_t * exported_length);
+bool_t optiga_sim_crypto_rsa_sign(const uint8_t * private_key, uint16_t private_key_length, uint8_t scheme,
+                                  const uint8_t * digest, uint8_t digest_length,
+                                  uint8_t * signature, uint16_t * signature_length);
+bool_t optiga_sim_crypto_rsa_verify(const uint8_t * public_key, uint16_t public_key_length, uint8_t scheme,
+                                    const uint8_t * digest, uint8_t digest_length,
+                                    const uint8_t * signature, uint16_t signature_length);
+bool_t optiga_sim_crypto_rsa_encrypt(const uint8_t * public_key, uint16_t public_key_length,
+                                     const uint8_t * message, uint16_t message_length,
+                                     uint8_t * encrypted, uint16_t * encrypted_length);
+bool_t optiga_sim_crypto_rsa_decrypt(const uint8_t * private_key, uint16_t private_key_length,
+                                     const uint8_t * encrypted, uint16_t encrypted_length,
+                                     uint8_t * message, uint16_t * message_length);
+
+bool_t optiga_sim_crypto_aes(uint8_t mode, bool_t encrypt, const uint8_t * key, uint16_t key_length,
+                             const uint8_t * iv, const uint8_t * in, uint32_t length, uint8_t * out);
+bool_t optiga_sim_crypto_aes_mac(uint8_t mode, const uint8_t * key, uint16_t key_length,
+                                 const uint8_t * in, uint32_t length, uint8_t * mac);
+bool_t optiga_sim_crypto_hmac(uint8_t type, const uint8_t * key, uint16_t key_length,
+                              const uint8_t * data, uint32_t data_length, uint8_t * mac, uint32_t * mac_length);
+void * optiga_sim_crypto_hmac_start(uint8_t type, const uint8_t * key, uint16_t key_length);
+bool_t optiga_sim_crypto_hmac_update(void * hmac_context, const uint8_t * data, uint32_t data_length);
+bool_t optiga_sim_crypto_hmac_finalize(void * hmac_context, uint8_t * mac, uint32_t * mac_length);
+void optiga_sim_crypto_hmac_free(void * hmac_context);
+bool_t optiga_sim_crypto_hkdf(uint8_t type, const uint8_t * secret, uint16_t secret_length,
+                              const uint8_t * salt, uint16_t salt_length,
+                              const uint8_t * info, uint16_t info_length,
+                              uint8_t * derived_key, uint16_t derived_key_length);
+bool_t optiga_sim_crypto_tls_prf(uint8_t type, const uint8_t * secret, uint16_t secret_length,
+                                 const uint8_t * label, uint16_t label_length,
+                                 const uint8_t * seed, uint16_t seed_length,
+                                 uint8_t * derived_key, uint16_t derived_key_length);
+
+/** @brief Resumable SHA-256 context as kept in the host supplied optiga_hash_context_t buffer */
+uint16_t optiga_sim_crypto_sha256_context_size(void);
+void optiga_sim_crypto_sha256_start(uint8_t * context);
+void optiga_sim_crypto_sha256_update(uint8_t * context, const uint8_t * data, uint32_t length);
+void optiga_sim_crypto_sha256_finalize(uint8_t * context, uint8_t * digest);
+void optiga_sim_crypto_sha256(const uint8_t * data, uint32_t length, uint8_t * digest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SIM_H_ */
@@ -0,0 +1,983 @@
+/******************************************************************************
+* File Name:   optiga_sim_crypto.c
+*
+* Description: This file implements the crypto primitives of the host side OPTIGA
+*              Trust M simulator on top of the OpenSSL 3 EVP interface.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* The resumable SHA-256 context is kept in the caller supplied buffer, like on the chip */
+#define OPENSSL_SUPPRESS_DEPRECATED
+
+#include <string.h>
+#include <openssl/bn.h>
+#include <openssl/core_names.h>
+#include <openssl/evp.h>
+#include <openssl/kdf.h>
+#include <openssl/params.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+#include <openssl/x509.h>
+
+#include "optiga/optiga_crypt.h"
+#include "optiga_sim.h"
+
+#define OPTIGA_SIM_AES_BLOCK_SIZE           (16U)
+#define OPTIGA_SIM_DER_TAG_BIT_STRING       (0x03)
+#define OPTIGA_SIM_DER_TAG_OCTET_STRING     (0x04)
+#define OPTIGA_SIM_DER_TAG_SEQUENCE         (0x30)
+
+static const char * optiga_sim_crypto_curve_name(uint8_t curve)
+{
+    switch (curve)
+    {
+        case OPTIGA_ECC_CURVE_NIST_P_256: return "P-256";
+        case OPTIGA_ECC_CURVE_NIST_P_384: return "P-384";
+        case OPTIGA_ECC_CURVE_NIST_P_521: return "P-521";
+        case OPTIGA_ECC_CURVE_BRAIN_POOL_P_256R1: return "brainpoolP256r1";
+        case OPTIGA_ECC_CURVE_BRAIN_POOL_P_384R1: return "brainpoolP384r1";
+        case OPTIGA_ECC_CURVE_BRAIN_POOL_P_512R1: return "brainpoolP512r1";
+        default: return NULL;
+    }
+}
+
+static const char * optiga_sim_crypto_digest_name(uint8_t type)
+{
+    switch (type)
+    {
+        /* TLS PRF and RSASSA schemes share the same identifiers */
+        case OPTIGA_HMAC_SHA_384:
+        case OPTIGA_TLS12_PRF_SHA_384:
+        case OPTIGA_HKDF_SHA_384:
+            return "SHA384";
+        case OPTIGA_HMAC_SHA_512:
+        case OPTIGA_TLS12_PRF_SHA_512:
+        case OPTIGA_HKDF_SHA_512:
+            return "SHA512";
+        default:
+            return "SHA256";
+    }
+}
+
+/**
+ * DER length encoding, returns the number of bytes written
+ */
+static uint16_t optiga_sim_crypto_encode_length(uint8_t * buffer, uint16_t length)
+{
+    if (length < 0x80)
+    {
+        buffer[0] = (uint8_t)length;
+        return 1;
+    }
+    if (length <= 0xFF)
+    {
+        buffer[0] = 0x81;
+        buffer[1] = (uint8_t)length;
+        return 2;
+    }
+    buffer[0] = 0x82;
+    buffer[1] = (uint8_t)(length >> 8);
+    buffer[2] = (uint8_t)length;
+    return 3;
+}
+
+/**
+ * Returns the value of a DER TLV and its length, NULL if the tag does not match
+ */
+static const uint8_t * optiga_sim_crypto_decode_tlv(const uint8_t * buffer, uint16_t buffer_length,
+                                                    uint8_t tag, uint16_t * value_length)
+{
+    uint16_t header = 2;
+
+    if ((buffer_length < 2) || (tag != buffer[0]))
+    {
+        return NULL;
+    }
+    if (0x81 == buffer[1])
+    {
+        *value_length = buffer[2];
+        header = 3;
+    }
+    else if (0x82 == buffer[1])
+    {
+        *value_length = (uint16_t)((buffer[2] << 8) | buffer[3]);
+        header = 4;
+    }
+    else
+    {
+        *value_length = buffer[1];
+    }
+    if ((header + *value_length) > buffer_length)
+    {
+        return NULL;
+    }
+    return (&buffer[header]);
+}
+
+/**
+ * Wraps the value into a BIT STRING without unused bits
+ */
+static bool_t optiga_sim_crypto_encode_bit_string(const uint8_t * value, uint16_t value_length,
+                                                  uint8_t * buffer, uint16_t * buffer_length)
+{
+    uint16_t header;
+    uint8_t length[3];
+
+    header = (uint16_t)(1 + optiga_sim_crypto_encode_length(length, (uint16_t)(value_length + 1)));
+    if ((header + 1 + value_length) > *buffer_length)
+    {
+        return FALSE;
+    }
+    buffer[0] = OPTIGA_SIM_DER_TAG_BIT_STRING;
+    memcpy(&buffer[1], length, (size_t)(header - 1));
+    buffer[header] = 0x00;
+    memmove(&buffer[header + 1], value, value_length);
+    *buffer_length = (uint16_t)(header + 1 + value_length);
+    return TRUE;
+}
+
+static const uint8_t * optiga_sim_crypto_decode_bit_string(const uint8_t * buffer, uint16_t buffer_length,
+                                                           uint16_t * value_length)
+{
+    const uint8_t * value = optiga_sim_crypto_decode_tlv(buffer, buffer_length,
+                                                         OPTIGA_SIM_DER_TAG_BIT_STRING, value_length);
+    if ((NULL == value) || (0 == *value_length) || (0x00 != value[0]))
+    {
+        return NULL;
+    }
+    *value_length = (uint16_t)(*value_length - 1);
+    return (&value[1]);
+}
+
+static EVP_PKEY * optiga_sim_crypto_load_private(const uint8_t * private_key, uint16_t private_key_length)
+{
+    const unsigned char * cursor = private_key;
+    return (d2i_AutoPrivateKey(NULL, &cursor, private_key_length));
+}
+
+static EVP_PKEY * optiga_sim_crypto_load_ecc_public(uint8_t curve, const uint8_t * public_key, uint16_t public_key_length)
+{
+    EVP_PKEY * pkey = NULL;
+    EVP_PKEY_CTX * ctx = NULL;
+    OSSL_PARAM params[3];
+    const uint8_t * point;
+    uint16_t point_length;
+    const char * curve_name = optiga_sim_crypto_curve_name(curve);
+
+    point = optiga_sim_crypto_decode_bit_string(public_key, public_key_length, &point_length);
+    if ((NULL == point) || (NULL == curve_name))
+    {
+        return NULL;
+    }
+    params[0] = OSSL_PARAM_construct_utf8_string(OSSL_PKEY_PARAM_GROUP_NAME, (char *)curve_name, 0);
+    params[1] = OSSL_PARAM_construct_octet_string(OSSL_PKEY_PARAM_PUB_KEY, (void *)point, point_length);
+    params[2] = OSSL_PARAM_construct_end();
+
+    ctx = EVP_PKEY_CTX_new_from_name(NULL, "EC", NULL);
+    if ((NULL != ctx) && (0 < EVP_PKEY_fromdata_init(ctx)))
+    {
+        (void)EVP_PKEY_fromdata(ctx, &pkey, EVP_PKEY_PUBLIC_KEY, params);
+    }
+    EVP_PKEY_CTX_free(ctx);
+    return (pkey);
+}
+
+static EVP_PKEY * optiga_sim_crypto_load_rsa_public(const uint8_t * public_key, uint16_t public_key_length)
+{
+    const uint8_t * rsa_public_key;
+    uint16_t rsa_public_key_length;
+
+    rsa_public_key = optiga_sim_crypto_decode_bit_string(public_key, public_key_length, &rsa_public_key_length);
+    if (NULL == rsa_public_key)
+    {
+        return NULL;
+    }
+    return (d2i_PublicKey(EVP_PKEY_RSA, NULL, &rsa_public_key, rsa_public_key_length));
+}
+
+static bool_t optiga_sim_crypto_store_private(EVP_PKEY * pkey, uint8_t * private_key, uint16_t * private_key_length)
+{
+    unsigned char * cursor = private_key;
+    int length = i2d_PrivateKey(pkey, NULL);
+
+    if ((length <= 0) || (length > *private_key_length))
+    {
+        return FALSE;
+    }
+    *private_key_length = (uint16_t)i2d_PrivateKey(pkey, &cursor);
+    return TRUE;
+}
+
+static bool_t optiga_sim_crypto_export_bignum(EVP_PKEY * pkey, const char * name, uint16_t size,
+                                              uint8_t * exported, uint16_t * exported_length)
+{
+    BIGNUM * value = NULL;
+    uint16_t header;
+    bool_t result = FALSE;
+
+    do
+    {
+        if (0 >= EVP_PKEY_get_bn_param(pkey, name, &value))
+        {
+            break;
+        }
+        if (0 == size)
+        {
+            size = (uint16_t)BN_num_bytes(value);
+        }
+        exported[0] = OPTIGA_SIM_DER_TAG_OCTET_STRING;
+        header = (uint16_t)(1 + optiga_sim_crypto_encode_length(&exported[1], size));
+        if ((header + size) > *exported_length)
+        {
+            break;
+        }
+        if (size != BN_bn2binpad(value, &exported[header], size))
+        {
+            break;
+        }
+        *exported_length = (uint16_t)(header + size);
+        result = TRUE;
+    } while (FALSE);
+    BN_clear_free(value);
+
+    return (result);
+}
+
+bool_t optiga_sim_crypto_random(uint8_t * buffer, uint32_t length)
+{
+    return (bool_t)(1 == RAND_bytes(buffer, (int)length));
+}
+
+uint16_t optiga_sim_crypto_ecc_key_size(uint8_t curve)
+{
+    switch (curve)
+    {
+        case OPTIGA_ECC_CURVE_NIST_P_256:
+        case OPTIGA_ECC_CURVE_BRAIN_POOL_P_256R1:
+            return 32;
+        case OPTIGA_ECC_CURVE_NIST_P_384:
+        case OPTIGA_ECC_CURVE_BRAIN_POOL_P_384R1:
+            return 48;
+        case OPTIGA_ECC_CURVE_NIST_P_521:
+            return 66;
+        case OPTIGA_ECC_CURVE_BRAIN_POOL_P_512R1:
+            return 64;
+        default:
+            return 0;
+    }
+}
+
+bool_t optiga_sim_crypto_ecc_generate(uint8_t curve,
+                                      uint8_t * private_key, uint16_t * private_key_length,
+                                      uint8_t * public_key, uint16_t * public_key_length)
+{
+    EVP_PKEY * pkey = NULL;
+    uint8_t point[1 + (2 * 66)];
+    size_t point_length = 0;
+    bool_t result = FALSE;
+    const char * curve_name = optiga_sim_crypto_curve_name(curve);
+
+    do
+    {
+        if (NULL == curve_name)
+        {
+            break;
+        }
+        pkey = EVP_PKEY_Q_keygen(NULL, NULL, "EC", curve_name);
+        if (NULL == pkey)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_store_private(pkey, private_key, private_key_length))
+        {
+            break;
+        }
+        if (0 >= EVP_PKEY_get_octet_string_param(pkey, OSSL_PKEY_PARAM_PUB_KEY, point, sizeof(point), &point_length))
+        {
+            break;
+        }
+        result = optiga_sim_crypto_encode_bit_string(point, (uint16_t)point_length, public_key, public_key_length);
+    } while (FALSE);
+    EVP_PKEY_free(pkey);
+
+    return (result);
+}
+
+bool_t optiga_sim_crypto_ecc_export_private(const uint8_t * private_key, uint16_t private_key_length,
+                                            uint8_t * exported, uint16_t * exported_length)
+{
+    EVP_PKEY * pkey = optiga_sim_crypto_load_private(private_key, private_key_length);
+    bool_t result = FALSE;
+
+    if (NULL != pkey)
+    {
+        result = optiga_sim_crypto_export_bignum(pkey, OSSL_PKEY_PARAM_PRIV_KEY,
+                                                 (uint16_t)((EVP_PKEY_get_bits(pkey) + 7) / 8),
+                                                 exported, exported_length);
+        EVP_PKEY_free(pkey);
+    }
+    return (result);
+}
+
+bool_t optiga_sim_crypto_ecdsa_sign(const uint8_t * private_key, uint16_t private_key_length,
+                                    const uint8_t * digest, uint8_t digest_length,
+                                    uint8_t * signature, uint16_t * signature_length)
+{
+    EVP_PKEY * pkey = optiga_sim_crypto_load_private(private_key, private_key_length);
+    EVP_PKEY_CTX * ctx = NULL;
+    uint8_t der[160];
+    size_t der_length = sizeof(der);
+    const uint8_t * integers;
+    uint16_t integers_length;
+    bool_t result = FALSE;
+
+    do
+    {
+        if (NULL == pkey)
+        {
+            break;
+        }
+        ctx = EVP_PKEY_CTX_new(pkey, NULL);
+        if ((NULL == ctx) || (0 >= EVP_PKEY_sign_init(ctx)) ||
+            (0 >= EVP_PKEY_sign(ctx, der, &der_length, digest, digest_length)))
+        {
+            break;
+        }
+        /* The chip returns the two INTEGERs (r, s) without the SEQUENCE header */
+        integers = optiga_sim_crypto_decode_tlv(der, (uint16_t)der_length, OPTIGA_SIM_DER_TAG_SEQUENCE, &integers_length);
+        if ((NULL == integers) || (integers_length > *signature_length))
+        {
+            break;
+        }
+        memcpy(signature, integers, integers_length);
+        *signature_length = integers_length;
+        result = TRUE;
+    } while (FALSE);
+    EVP_PKEY_CTX_free(ctx);
+    EVP_PKEY_free(pkey);
+
+    return (result);
+}
+
+bool_t optiga_sim_crypto_ecdsa_verify(uint8_t curve, const uint8_t * public_key, uint16_t public_key_length,
+                                      const uint8_t * digest, uint8_t digest_length,
+                                      const uint8_t * signature, uint16_t signature_length)
+{
+    EVP_PKEY * pkey = optiga_sim_crypto_load_ecc_public(curve, public_key, public_key_length);
+    EVP_PKEY_CTX * ctx = NULL;
+    uint8_t der[160];
+    uint16_t header;
+    bool_t result = FALSE;
+
+    do
+    {
+        if ((NULL == pkey) || ((signature_length + 3U) > sizeof(der)))
+        {
+            break;
+        }
+        der[0] = OPTIGA_SIM_DER_TAG_SEQUENCE;
+        header = (uint16_t)(1 + optiga_sim_crypto_encode_length(&der[1], signature_length));
+        memcpy(&der[header], signature, signature_length);
+
+        ctx = EVP_PKEY_CTX_new(pkey, NULL);
+        if ((NULL == ctx) || (0 >= EVP_PKEY_verify_init(ctx)))
+        {
+            break;
+        }
+        result = (bool_t)(1 == EVP_PKEY_verify(ctx, der, (size_t)(header + signature_length), digest, digest_length));
+    } while (FALSE);
+    EVP_PKEY_CTX_free(ctx);
+    EVP_PKEY_free(pkey);
+
+    return (result);
+}
+
+bool_t optiga_sim_crypto_ecdh(const uint8_t * private_key, uint16_t private_key_length,
+                              uint8_t curve, const uint8_t * public_key, uint16_t public_key_length,
+                              uint8_t * shared_secret, uint16_t * shared_secret_length)
+{
+    EVP_PKEY * pkey = optiga_sim_crypto_load_private(private_key, private_key_length);
+    EVP_PKEY * peer = optiga_sim_crypto_load_ecc_public(curve, public_key, public_key_length);
+    EVP_PKEY_CTX * ctx = NULL;
+    size_t length = *shared_secret_length;
+    bool_t result = FALSE;
+
+    do
+    {
+        if ((NULL == pkey) || (NULL == peer))
+        {
+            break;
+        }
+        ctx = EVP_PKEY_CTX_new(pkey, NULL);
+        if ((NULL == ctx) || (0 >= EVP_PKEY_derive_init(ctx)) || (0 >= EVP_PKEY_derive_set_peer(ctx, peer)) ||
+            (0 >= EVP_PKEY_derive(ctx, shared_secret, &length)))
+        {
+            break;
+        }
+        *shared_secret_length = (uint16_t)length;
+        result = TRUE;
+    } while (FALSE);
+    EVP_PKEY_CTX_free(ctx);
+    EVP_PKEY_free(peer);
+    EVP_PKEY_free(pkey);
+
+    return (result);
+}
+
+bool_t optiga_sim_crypto_ecc_self_signed_certificate(const uint8_t * private_key, uint16_t private_key_length,
+                                                     uint8_t * certificate, uint16_t * certificate_length)
+{
+    EVP_PKEY * pkey = optiga_sim_crypto_load_private(private_key, private_key_length);
+    X509 * x509 = NULL;
+    X509_NAME * name;
+    unsigned char * cursor = certificate;
+    int length;
+    bool_t result = FALSE;
+
+    do
+    {
+        x509 = X509_new();
+        if ((NULL == pkey) || (NULL == x509))
+        {
+            break;
+        }
+        (void)X509_set_version(x509, 2);
+        (void)ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+        (void)X509_gmtime_adj(X509_getm_notBefore(x509), 0);
+        (void)X509_gmtime_adj(X509_getm_notAfter(x509), 20L * 365 * 24 * 60 * 60);
+        name = X509_get_subject_name(x509);
+        (void)X509_NAME_add_entry_by_txt(name, "O", MBSTRING_ASC, (const unsigned char *)"Infineon Technologies AG", -1, -1, 0);
+        (void)X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char *)"OPTIGA Trust M Simulator", -1, -1, 0);
+        (void)X509_set_issuer_name(x509, name);
+        (void)X509_set_pubkey(x509, pkey);
+        if (0 >= X509_sign(x509, pkey, EVP_sha256()))
+        {
+            break;
+        }
+        length = i2d_X509(x509, NULL);
+        if ((length <= 0) || (length > *certificate_length))
+        {
+            break;
+        }
+        *certificate_length = (uint16_t)i2d_X509(x509, &cursor);
+        result = TRUE;
+    } while (FALSE);
+    X509_free(x509);
+    EVP_PKEY_free(pkey);
+
+    return (result);
+}
+
+bool_t optiga_sim_crypto_certificate_public_key(const uint8_t * certificate, uint16_t certificate_length,
+                                                uint8_t * public_key, uint16_t * public_key_length,
+                                                uint8_t * key_type)
+{
+    static const struct
+    {
+        const char * group_name;
+        uint8_t curve;
+    } optiga_sim_crypto_groups [] =
+    {
+        {"prime256v1", OPTIGA_ECC_CURVE_NIST_P_256},
+        {"secp384r1", OPTIGA_ECC_CURVE_NIST_P_384},
+        {"secp521r1", OPTIGA_ECC_CURVE_NIST_P_521},
+        {"brainpoolP256r1", OPTIGA_ECC_CURVE_BRAIN_POOL_P_256R1},
+        {"brainpoolP384r1", OPTIGA_ECC_CURVE_BRAIN_POOL_P_384R1},
+        {"brainpoolP512r1", OPTIGA_ECC_CURVE_BRAIN_POOL_P_512R1},
+    };
+    const unsigned char * cursor = certificate;
+    X509 * x509 = NULL;
+    EVP_PKEY * pkey;
+    uint8_t encoded[300];
+    unsigned char * encoded_cursor = encoded;
+    size_t encoded_length = 0;
+    char group_name[32];
+    uint8_t index;
+    bool_t result = FALSE;
+
+    /* Certificates in the identity objects may carry the TLS identity chain header */
+    if ((certificate_length > 9) && (0xC0 == certificate[0]))
+    {
+        cursor += 9;
+        certificate_length = (uint16_t)(certificate_length - 9);
+    }
+    do
+    {
+        x509 = d2i_X509(NULL, &cursor, certificate_length);
+        pkey = (NULL != x509) ? X509_get0_pubkey(x509) : NULL;
+        if (NULL == pkey)
+        {
+            break;
+        }
+        if (EVP_PKEY_RSA == EVP_PKEY_get_base_id(pkey))
+        {
+            *key_type = (EVP_PKEY_get_bits(pkey) > 1024) ? (uint8_t)OPTIGA_RSA_KEY_2048_BIT_EXPONENTIAL :
+                                                           (uint8_t)OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL;
+            if ((i2d_PublicKey(pkey, NULL) <= 0) || ((size_t)i2d_PublicKey(pkey, NULL) > sizeof(encoded)))
+            {
+                break;
+            }
+            encoded_length = (size_t)i2d_PublicKey(pkey, &encoded_cursor);
+        }
+        else
+        {
+            if (0 >= EVP_PKEY_get_utf8_string_param(pkey, OSSL_PKEY_PARAM_GROUP_NAME, group_name, sizeof(group_name), NULL))
+            {
+                break;
+            }
+            for (index = 0; index < (sizeof(optiga_sim_crypto_groups) / sizeof(optiga_sim_crypto_groups[0])); index++)
+            {
+                if (0 == strcmp(group_name, optiga_sim_crypto_groups[index].group_name))
+                {
+                    *key_type = optiga_sim_crypto_groups[index].curve;
+                    break;
+                }
+            }
+            if ((index == (sizeof(optiga_sim_crypto_groups) / sizeof(optiga_sim_crypto_groups[0]))) ||
+                (0 >= EVP_PKEY_get_octet_string_param(pkey, OSSL_PKEY_PARAM_PUB_KEY, encoded, sizeof(encoded), &encoded_length)))
+            {
+                break;
+            }
+        }
+        result = optiga_sim_crypto_encode_bit_string(encoded, (uint16_t)encoded_length, public_key, public_key_length);
+    } while (FALSE);
+    X509_free(x509);
+
+    return (result);
+}
+
+bool_t optiga_sim_crypto_rsa_generate(uint16_t bits,
+                                      uint8_t * private_key, uint16_t * private_key_length,
+                                      uint8_t * public_key, uint16_t * public_key_length)
+{
+    EVP_PKEY * pkey = NULL;
+    uint8_t rsa_public_key[300];
+    unsigned char * cursor = rsa_public_key;
+    int length;
+    bool_t result = FALSE;
+
+    do
+    {
+        pkey = EVP_PKEY_Q_keygen(NULL, NULL, "RSA", (size_t)bits);
+        if (NULL == pkey)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_crypto_store_private(pkey, private_key, private_key_length))
+        {
+            break;
+        }
+        /* RSAPublicKey (PKCS#1) in a BIT STRING */
+        length = i2d_PublicKey(pkey, NULL);
+        if ((length <= 0) || ((size_t)length > sizeof(rsa_public_key)))
+        {
+            break;
+        }
+        length = i2d_PublicKey(pkey, &cursor);
+        result = optiga_sim_crypto_encode_bit_string(rsa_public_key, (uint16_t)length, public_key, public_key_length);
+    } while (FALSE);
+    EVP_PKEY_free(pkey);
+
+    return (result);
+}
+
+bool_t optiga_sim_crypto_rsa_export_private(const uint8_t * private_key, uint16_t private_key_length,
+                                            uint8_t * exported, uint16_t * exported_length)
+{
+    EVP_PKEY * pkey = optiga_sim_crypto_load_private(private_key, private_key_length);
+    bool_t result = FALSE;
+
+    if (NULL != pkey)
+    {
+        /* Private exponent, padded to the modulus length */
+        result = optiga_sim_crypto_export_bignum(pkey, OSSL_PKEY_PARAM_RSA_D,
+                                                 (uint16_t)((EVP_PKEY_get_bits(pkey) + 7) / 8),
+                                                 exported, exported_length);
+        EVP_PKEY_free(pkey);
+    }
+    return (result);
+}
+
+static bool_t optiga_sim_crypto_rsa_operation(EVP_PKEY * pkey, uint8_t operation, const char * digest_name,
+                                              const uint8_t * in, uint16_t in_length,
+                                              uint8_t * out, uint16_t * out_length)
+{
+    EVP_PKEY_CTX * ctx = NULL;
+    size_t length = *out_length;
+    int status = 0;
+    bool_t result = FALSE;
+
+    do
+    {
+        if (NULL == pkey)
+        {
+            break;
+        }
+        ctx = EVP_PKEY_CTX_new(pkey, NULL);
+        if (NULL == ctx)
+        {
+            break;
+        }
+        switch (operation)
+        {
+            case 'S': status = EVP_PKEY_sign_init(ctx); break;
+            case 'E': status = EVP_PKEY_encrypt_init(ctx); break;
+            default: status = EVP_PKEY_decrypt_init(ctx); break;
+        }
+        if ((0 >= status) || (0 >= EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_PADDING)))
+        {
+            break;
+        }
+        if ((NULL != digest_name) && (0 >= EVP_PKEY_CTX_set_signature_md(ctx, EVP_get_digestbyname(digest_name))))
+        {
+            break;
+        }
+        switch (operation)
+        {
+            case 'S': status = EVP_PKEY_sign(ctx, out, &length, in, in_length); break;
+            case 'E': status = EVP_PKEY_encrypt(ctx, out, &length, in, in_length); break;
+            default: status = EVP_PKEY_decrypt(ctx, out, &length, in, in_length); break;
+        }
+        if (0 >= status)
+        {
+            break;
+        }
+        *out_length = (uint16_t)length;
+        result = TRUE;
+    } while (FALSE);
+    EVP_PKEY_CTX_free(ctx);
+
+    return (result);
+}
+
+bool_t optiga_sim_crypto_rsa_sign(const uint8_t * private_key, uint16_t private_key_length, uint8_t scheme,
+                                  const uint8_t * digest, uint8_t digest_length,
+                                  uint8_t * signature, uint16_t * signature_length)
+{
+    EVP_PKEY * pkey = optiga_sim_crypto_load_private(private_key, private_key_length);
+    bool_t result = optiga_sim_crypto_rsa_operation(pkey, 'S', optiga_sim_crypto_digest_name(scheme),
+                                                    digest, digest_length, signature, signature_length);
+    EVP_PKEY_free(pkey);
+    return (result);
+}
+
+bool_t optiga_sim_crypto_rsa_verify(const uint8_t * public_key, uint16_t public_key_length, uint8_t scheme,
+                                    const uint8_t * digest, uint8_t digest_length,
+                                    const uint8_t * signature, uint16_t signature_length)
+{
+    EVP_PKEY * pkey = optiga_sim_crypto_load_rsa_public(public_key, public_key_length);
+    EVP_PKEY_CTX * ctx = NULL;
+    bool_t result = FALSE;
+
+    do
+    {
+        if (NULL == pkey)
+        {
+            break;
+        }
+        ctx = EVP_PKEY_CTX_new(pkey, NULL);
+        if ((NULL == ctx) || (0 >= EVP_PKEY_verify_init(ctx)) ||
+            (0 >= EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_PADDING)) ||
+            (0 >= EVP_PKEY_CTX_set_signature_md(ctx, EVP_get_digestbyname(optiga_sim_crypto_digest_name(scheme)))))
+        {
+            break;
+        }
+        result = (bool_t)(1 == EVP_PKEY_verify(ctx, signature, signature_length, digest, digest_length));
+    } while (FALSE);
+    EVP_PKEY_CTX_free(ctx);
+    EVP_PKEY_free(pkey);
+
+    return (result);
+}
+
+bool_t optiga_sim_crypto_rsa_encrypt(const uint8_t * public_key, uint16_t public_key_length,
+                                     const uint8_t * message, uint16_t message_length,
+                                     uint8_t * encrypted, uint16_t * encrypted_length)
+{
+    EVP_PKEY * pkey = optiga_sim_crypto_load_rsa_public(public_key, public_key_length);
+    bool_t result = optiga_sim_crypto_rsa_operation(pkey, 'E', NULL, message, message_length,
+                                                    encrypted, encrypted_length);
+    EVP_PKEY_free(pkey);
+    return (result);
+}
+
+bool_t optiga_sim_crypto_rsa_decrypt(const uint8_t * private_key, uint16_t private_key_length,
+                                     const uint8_t * encrypted, uint16_t encrypted_length,
+                                     uint8_t * message, uint16_t * message_length)
+{
+    EVP_PKEY * pkey = optiga_sim_crypto_load_private(private_key, private_key_length);
+    bool_t result = optiga_sim_crypto_rsa_operation(pkey, 'D', NULL, encrypted, encrypted_length,
+                                                    message, message_length);
+    EVP_PKEY_free(pkey);
+    return (result);
+}
+
+static const EVP_CIPHER * optiga_sim_crypto_aes_cipher(uint8_t mode, uint16_t key_length)
+{
+    bool_t ecb = (bool_t)(OPTIGA_SYMMETRIC_ECB == mode);
+
+    switch (key_length)
+    {
+        case 16: return ((TRUE == ecb) ? EVP_aes_128_ecb() : EVP_aes_128_cbc());
+        case 24: return ((TRUE == ecb) ? EVP_aes_192_ecb() : EVP_aes_192_cbc());
+        case 32: return ((TRUE == ecb) ? EVP_aes_256_ecb() : EVP_aes_256_cbc());
+        default: return NULL;
+    }
+}
+
+bool_t optiga_sim_crypto_aes(uint8_t mode, bool_t encrypt, const uint8_t * key, uint16_t key_length,
+                             const uint8_t * iv, const uint8_t * in, uint32_t length, uint8_t * out)
+{
+    static const uint8_t zero_iv[OPTIGA_SIM_AES_BLOCK_SIZE] = {0};
+    const EVP_CIPHER * cipher = optiga_sim_crypto_aes_cipher(mode, key_length);
+    EVP_CIPHER_CTX * ctx = NULL;
+    int out_length = 0;
+    bool_t result = FALSE;
+
+    do
+    {
+        if ((NULL == cipher) || (0 != (length % OPTIGA_SIM_AES_BLOCK_SIZE)))
+        {
+            break;
+        }
+        ctx = EVP_CIPHER_CTX_new();
+        if ((NULL == ctx) ||
+            (1 != EVP_CipherInit_ex(ctx, cipher, NULL, key, (NULL != iv) ? iv : zero_iv, (TRUE == encrypt) ? 1 : 0)))
+        {
+            break;
+        }
+        (void)EVP_CIPHER_CTX_set_padding(ctx, 0);
+        if ((0 != length) && (1 != EVP_CipherUpdate(ctx, out, &out_length, in, (int)length)))
+        {
+            break;
+        }
+        result = TRUE;
+    } while (FALSE);
+    EVP_CIPHER_CTX_free(ctx);
+
+    return (result);
+}
+
+bool_t optiga_sim_crypto_aes_mac(uint8_t mode, const uint8_t * key, uint16_t key_length,
+                                 const uint8_t * in, uint32_t length, uint8_t * mac)
+{
+    EVP_MAC * evp_mac = NULL;
+    EVP_MAC_CTX * ctx = NULL;
+    OSSL_PARAM params[2];
+    uint8_t * buffer;
+    size_t mac_length = 0;
+    const char * cipher_name;
+    bool_t result = FALSE;
+
+    if (OPTIGA_SYMMETRIC_CBC_MAC == mode)
+    {
+        /* CBC-MAC is the last block of the CBC encryption with a zero IV */
+        buffer = OPENSSL_malloc((length != 0) ? length : 1);
+        if ((NULL != buffer) && (0 != length) &&
+            (TRUE == optiga_sim_crypto_aes(OPTIGA_SYMMETRIC_CBC, TRUE, key, key_length, NULL, in, length, buffer)))
+        {
+            memcpy(mac, &buffer[length - OPTIGA_SIM_AES_BLOCK_SIZE], OPTIGA_SIM_AES_BLOCK_SIZE);
+            result = TRUE;
+        }
+        OPENSSL_free(buffer);
+        return (result);
+    }
+
+    do
+    {
+        cipher_name = (16 == key_length) ? "AES-128-CBC" : ((24 == key_length) ? "AES-192-CBC" : "AES-256-CBC");
+        params[0] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_CIPHER, (char *)cipher_name, 0);
+        params[1] = OSSL_PARAM_construct_end();
+        evp_mac = EVP_MAC_fetch(NULL, "CMAC", NULL);
+        ctx = (NULL != evp_mac) ? EVP_MAC_CTX_new(evp_mac) : NULL;
+        if ((NULL == ctx) || (1 != EVP_MAC_init(ctx, key, key_length, params)) ||
+            (1 != EVP_MAC_update(ctx, in, length)) ||
+            (1 != EVP_MAC_final(ctx, mac, &mac_length, OPTIGA_SIM_AES_BLOCK_SIZE)))
+        {
+            break;
+        }
+        result = TRUE;
+    } while (FALSE);
+    EVP_MAC_CTX_free(ctx);
+    EVP_MAC_free(evp_mac);
+
+    return (result);
+}
+
+void * optiga_sim_crypto_hmac_start(uint8_t type, const uint8_t * key, uint16_t key_length)
+{
+    EVP_MAC * evp_mac = EVP_MAC_fetch(NULL, "HMAC", NULL);
+    EVP_MAC_CTX * ctx = NULL;
+    OSSL_PARAM params[2];
+
+    if (NULL != evp_mac)
+    {
+        params[0] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST,
+                                                     (char *)optiga_sim_crypto_digest_name(type), 0);
+        params[1] = OSSL_PARAM_construct_end();
+        ctx = EVP_MAC_CTX_new(evp_mac);
+        if ((NULL != ctx) && (1 != EVP_MAC_init(ctx, key, key_length, params)))
+        {
+            EVP_MAC_CTX_free(ctx);
+            ctx = NULL;
+        }
+        EVP_MAC_free(evp_mac);
+    }
+    return (ctx);
+}
+
+bool_t optiga_sim_crypto_hmac_update(void * hmac_context, const uint8_t * data, uint32_t data_length)
+{
+    return (bool_t)((NULL != hmac_context) && (1 == EVP_MAC_update((EVP_MAC_CTX *)hmac_context, data, data_length)));
+}
+
+bool_t optiga_sim_crypto_hmac_finalize(void * hmac_context, uint8_t * mac, uint32_t * mac_length)
+{
+    size_t length = 0;
+
+    if ((NULL == hmac_context) || (1 != EVP_MAC_final((EVP_MAC_CTX *)hmac_context, mac, &length, *mac_length)))
+    {
+        return FALSE;
+    }
+    *mac_length = (uint32_t)length;
+    return TRUE;
+}
+
+void optiga_sim_crypto_hmac_free(void * hmac_context)
+{
+    EVP_MAC_CTX_free((EVP_MAC_CTX *)hmac_context);
+}
+
+bool_t optiga_sim_crypto_hmac(uint8_t type, const uint8_t * key, uint16_t key_length,
+                              const uint8_t * data, uint32_t data_length, uint8_t * mac, uint32_t * mac_length)
+{
+    void * hmac_context = optiga_sim_crypto_hmac_start(type, key, key_length);
+    bool_t result = (bool_t)((TRUE == optiga_sim_crypto_hmac_update(hmac_context, data, data_length)) &&
+                             (TRUE == optiga_sim_crypto_hmac_finalize(hmac_context, mac, mac_length)));
+    optiga_sim_crypto_hmac_free(hmac_context);
+    return (result);
+}
+
+static bool_t optiga_sim_crypto_kdf(const char * kdf_name, OSSL_PARAM * params, uint8_t * derived_key, uint16_t derived_key_length)
+{
+    EVP_KDF * kdf = EVP_KDF_fetch(NULL, kdf_name, NULL);
+    EVP_KDF_CTX * ctx = (NULL != kdf) ? EVP_KDF_CTX_new(kdf) : NULL;
+    bool_t result = (bool_t)((NULL != ctx) && (1 == EVP_KDF_derive(ctx, derived_key, derived_key_length, params)));
+
+    EVP_KDF_CTX_free(ctx);
+    EVP_KDF_free(kdf);
+    return (result);
+}
+
+bool_t optiga_sim_crypto_hkdf(uint8_t type, const uint8_t * secret, uint16_t secret_length,
+                              const uint8_t * salt, uint16_t salt_length,
+                              const uint8_t * info, uint16_t info_length,
+                              uint8_t * derived_key, uint16_t derived_key_length)
+{
+    OSSL_PARAM params[5];
+    uint8_t index = 0;
+
+    params[index++] = OSSL_PARAM_construct_utf8_string(OSSL_KDF_PARAM_DIGEST, (char *)optiga_sim_crypto_digest_name(type), 0);
+    params[index++] = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_KEY, (void *)secret, secret_length);
+    if (0 != salt_length)
+    {
+        params[index++] = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SALT, (void *)salt, salt_length);
+    }
+    if (0 != info_length)
+    {
+        params[index++] = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_INFO, (void *)info, info_length);
+    }
+    params[index] = OSSL_PARAM_construct_end();
+
+    return (optiga_sim_crypto_kdf("HKDF", params, derived_key, derived_key_length));
+}
+
+bool_t optiga_sim_crypto_tls_prf(uint8_t type, const uint8_t * secret, uint16_t secret_length,
+                                 const uint8_t * label, uint16_t label_length,
+                                 const uint8_t * seed, uint16_t seed_length,
+                                 uint8_t * derived_key, uint16_t derived_key_length)
+{
+    OSSL_PARAM params[5];
+    uint8_t index = 0;
+
+    /* P_hash(secret, label || seed) */
+    params[index++] = OSSL_PARAM_construct_utf8_string(OSSL_KDF_PARAM_DIGEST, (char *)optiga_sim_crypto_digest_name(type), 0);
+    params[index++] = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SECRET, (void *)secret, secret_length);
+    params[index++] = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SEED, (void *)label, label_length);
+    params[index++] = OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_SEED, (void *)seed, seed_length);
+    params[index] = OSSL_PARAM_construct_end();
+
+    return (optiga_sim_crypto_kdf("TLS1-PRF", params, derived_key, derived_key_length));
+}
+
+uint16_t optiga_sim_crypto_sha256_context_size(void)
+{
+    return ((uint16_t)sizeof(SHA256_CTX));
+}
+
+void optiga_sim_crypto_sha256_start(uint8_t * context)
+{
+    SHA256_CTX sha256;
+
+    (void)SHA256_Init(&sha256);
+    memcpy(context, &sha256, sizeof(sha256));
+}
+
+void optiga_sim_crypto_sha256_update(uint8_t * context, const uint8_t * data, uint32_t length)
+{
+    SHA256_CTX sha256;
+
+    /* The host buffer has no alignment guarantee */
+    memcpy(&sha256, context, sizeof(sha256));
+    (void)SHA256_Update(&sha256, data, length);
+    memcpy(context, &sha256, sizeof(sha256));
+}
+
+void optiga_sim_crypto_sha256_finalize(uint8_t * context, uint8_t * digest)
+{
+    SHA256_CTX sha256;
+
+    memcpy(&sha256, context, sizeof(sha256));
+    (void)SHA256_Final(digest, &sha256);
+    memset(context, 0, sizeof(sha256));
+}
+
+void optiga_sim_crypto_sha256(const uint8_t * data, uint32_t length, uint8_t * digest)
+{
+    (void)SHA256(data, length, digest);
+}
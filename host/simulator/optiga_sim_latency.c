@@ -0,0 +1,394 @@
+/******************************************************************************
+* File Name:   optiga_sim_latency.c
+*
+* Description: Latency model of the simulated OPTIGA Trust M: execution time per
+*              command, scaled by the current limit. The I2C PAL adds the bus time.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/pal/pal_i2c.h"
+#include "optiga_sim_latency.h"
+
+/** @brief Environment variable naming the file which overrides the built-in latency profile */
+#define OPTIGA_SIM_LATENCY_ENV                  "OPTIGA_SIM_LATENCY"
+
+/** @brief Maximum number of entries in the latency table (built-in and loaded from the profile) */
+#define OPTIGA_SIM_LATENCY_MAX_ENTRIES          (64U)
+
+/** @brief Execution time of one entry of the latency table */
+typedef struct optiga_sim_latency_entry
+{
+    uint8_t command;
+    uint8_t variant;
+    /// Execution time at the maximum current limit, in microseconds
+    uint32_t base_us;
+    /// Additional execution time per kilobyte of processed data, in microseconds
+    uint32_t per_kbyte_us;
+} optiga_sim_latency_entry_t;
+
+typedef struct optiga_sim_latency_command_name
+{
+    uint8_t command;
+    const char * name;
+} optiga_sim_latency_command_name_t;
+
+/**
+ * Built-in profile, approximating an OPTIGA Trust M V3 at 15 mA. The times exclude the I2C transfer,
+ * which the I2C PAL computes from the APDU lengths and its clock.
+ */
+static const optiga_sim_latency_entry_t optiga_sim_latency_default_profile [] =
+{
+    {OPTIGA_SIM_COMMAND_GET_DATA_OBJECT,      OPTIGA_SIM_LATENCY_ANY_VARIANT,          1000,     500},
+    {OPTIGA_SIM_COMMAND_SET_DATA_OBJECT,      OPTIGA_SIM_LATENCY_ANY_VARIANT,          6000,   12000},
+    {OPTIGA_SIM_COMMAND_SET_OBJECT_PROTECTED, OPTIGA_SIM_LATENCY_ANY_VARIANT,         75000,   12000},
+    {OPTIGA_SIM_COMMAND_GET_RANDOM,           OPTIGA_SIM_LATENCY_ANY_VARIANT,          2500,   20000},
+    {OPTIGA_SIM_COMMAND_ENCRYPT_SYM,          OPTIGA_SIM_LATENCY_ANY_VARIANT,          4000,    6000},
+    {OPTIGA_SIM_COMMAND_DECRYPT_SYM,          OPTIGA_SIM_LATENCY_ANY_VARIANT,          4000,    6000},
+    {OPTIGA_SIM_COMMAND_ENCRYPT_ASYM,         OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL,    10000,       0},
+    {OPTIGA_SIM_COMMAND_ENCRYPT_ASYM,         OPTIGA_RSA_KEY_2048_BIT_EXPONENTIAL,    25000,       0},
+    {OPTIGA_SIM_COMMAND_DECRYPT_ASYM,         OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL,    45000,       0},
+    {OPTIGA_SIM_COMMAND_DECRYPT_ASYM,         OPTIGA_RSA_KEY_2048_BIT_EXPONENTIAL,   210000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_HASH,            OPTIGA_SIM_LATENCY_ANY_VARIANT,          1500,    5000},
+    {OPTIGA_SIM_COMMAND_CALC_SIGN,            OPTIGA_ECC_CURVE_NIST_P_256,            60000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SIGN,            OPTIGA_ECC_CURVE_NIST_P_384,           105000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SIGN,            OPTIGA_ECC_CURVE_NIST_P_521,           200000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SIGN,            OPTIGA_ECC_CURVE_BRAIN_POOL_P_256R1,    70000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SIGN,            OPTIGA_ECC_CURVE_BRAIN_POOL_P_384R1,   125000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SIGN,            OPTIGA_ECC_CURVE_BRAIN_POOL_P_512R1,   230000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SIGN,            OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL,    45000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SIGN,            OPTIGA_RSA_KEY_2048_BIT_EXPONENTIAL,   210000,       0},
+    {OPTIGA_SIM_COMMAND_VERIFY_SIGN,          OPTIGA_ECC_CURVE_NIST_P_256,            80000,       0},
+    {OPTIGA_SIM_COMMAND_VERIFY_SIGN,          OPTIGA_ECC_CURVE_NIST_P_384,           140000,       0},
+    {OPTIGA_SIM_COMMAND_VERIFY_SIGN,          OPTIGA_ECC_CURVE_NIST_P_521,           270000,       0},
+    {OPTIGA_SIM_COMMAND_VERIFY_SIGN,          OPTIGA_ECC_CURVE_BRAIN_POOL_P_256R1,    95000,       0},
+    {OPTIGA_SIM_COMMAND_VERIFY_SIGN,          OPTIGA_ECC_CURVE_BRAIN_POOL_P_384R1,   165000,       0},
+    {OPTIGA_SIM_COMMAND_VERIFY_SIGN,          OPTIGA_ECC_CURVE_BRAIN_POOL_P_512R1,   310000,       0},
+    {OPTIGA_SIM_COMMAND_VERIFY_SIGN,          OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL,    10000,       0},
+    {OPTIGA_SIM_COMMAND_VERIFY_SIGN,          OPTIGA_RSA_KEY_2048_BIT_EXPONENTIAL,    25000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SSEC,            OPTIGA_ECC_CURVE_NIST_P_256,            60000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SSEC,            OPTIGA_ECC_CURVE_NIST_P_384,           105000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SSEC,            OPTIGA_ECC_CURVE_NIST_P_521,           200000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SSEC,            OPTIGA_ECC_CURVE_BRAIN_POOL_P_256R1,    70000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SSEC,            OPTIGA_ECC_CURVE_BRAIN_POOL_P_384R1,   125000,       0},
+    {OPTIGA_SIM_COMMAND_CALC_SSEC,            OPTIGA_ECC_CURVE_BRAIN_POOL_P_512R1,   230000,       0},
+    {OPTIGA_SIM_COMMAND_DERIVE_KEY,           OPTIGA_SIM_LATENCY_ANY_VARIANT,         12000,   10000},
+    {OPTIGA_SIM_COMMAND_GEN_KEYPAIR,          OPTIGA_ECC_CURVE_NIST_P_256,            55000,       0},
+    {OPTIGA_SIM_COMMAND_GEN_KEYPAIR,          OPTIGA_ECC_CURVE_NIST_P_384,            95000,       0},
+    {OPTIGA_SIM_COMMAND_GEN_KEYPAIR,          OPTIGA_ECC_CURVE_NIST_P_521,           180000,       0},
+    {OPTIGA_SIM_COMMAND_GEN_KEYPAIR,          OPTIGA_ECC_CURVE_BRAIN_POOL_P_256R1,    65000,       0},
+    {OPTIGA_SIM_COMMAND_GEN_KEYPAIR,          OPTIGA_ECC_CURVE_BRAIN_POOL_P_384R1,   115000,       0},
+    {OPTIGA_SIM_COMMAND_GEN_KEYPAIR,          OPTIGA_ECC_CURVE_BRAIN_POOL_P_512R1,   210000,       0},
+    {OPTIGA_SIM_COMMAND_GEN_KEYPAIR,          OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL,  2500000,       0},
+    {OPTIGA_SIM_COMMAND_GEN_KEYPAIR,          OPTIGA_RSA_KEY_2048_BIT_EXPONENTIAL, 15000000,       0},
+    {OPTIGA_SIM_COMMAND_GEN_SYMKEY,           OPTIGA_SIM_LATENCY_ANY_VARIANT,         15000,       0},
+    {OPTIGA_SIM_COMMAND_OPEN_APPLICATION,     OPTIGA_SIM_LATENCY_ANY_VARIANT,         15000,       0},
+    {OPTIGA_SIM_COMMAND_CLOSE_APPLICATION,    OPTIGA_SIM_LATENCY_ANY_VARIANT,          5000,       0},
+};
+
+static const optiga_sim_latency_command_name_t optiga_sim_latency_command_names [] =
+{
+    {OPTIGA_SIM_COMMAND_GET_DATA_OBJECT,      "get_data_object"},
+    {OPTIGA_SIM_COMMAND_SET_DATA_OBJECT,      "set_data_object"},
+    {OPTIGA_SIM_COMMAND_SET_OBJECT_PROTECTED, "set_object_protected"},
+    {OPTIGA_SIM_COMMAND_GET_RANDOM,           "get_random"},
+    {OPTIGA_SIM_COMMAND_ENCRYPT_SYM,          "encrypt_sym"},
+    {OPTIGA_SIM_COMMAND_DECRYPT_SYM,          "decrypt_sym"},
+    {OPTIGA_SIM_COMMAND_ENCRYPT_ASYM,         "encrypt_asym"},
+    {OPTIGA_SIM_COMMAND_DECRYPT_ASYM,         "decrypt_asym"},
+    {OPTIGA_SIM_COMMAND_CALC_HASH,            "calc_hash"},
+    {OPTIGA_SIM_COMMAND_CALC_SIGN,            "calc_sign"},
+    {OPTIGA_SIM_COMMAND_VERIFY_SIGN,          "verify_sign"},
+    {OPTIGA_SIM_COMMAND_CALC_SSEC,            "calc_ssec"},
+    {OPTIGA_SIM_COMMAND_DERIVE_KEY,           "derive_key"},
+    {OPTIGA_SIM_COMMAND_GEN_KEYPAIR,          "gen_keypair"},
+    {OPTIGA_SIM_COMMAND_GEN_SYMKEY,           "gen_symkey"},
+    {OPTIGA_SIM_COMMAND_OPEN_APPLICATION,     "open_application"},
+    {OPTIGA_SIM_COMMAND_CLOSE_APPLICATION,    "close_application"},
+};
+
+typedef struct optiga_sim_latency
+{
+    bool_t enabled;
+    /// Time the chip needs to reject a command
+    uint32_t error_us;
+    /// Time the chip needs to protect and verify the APDUs of the shielded connection
+    uint32_t shielded_us;
+    optiga_sim_latency_entry_t entries[OPTIGA_SIM_LATENCY_MAX_ENTRIES];
+    uint8_t entry_count;
+} optiga_sim_latency_t;
+
+static optiga_sim_latency_t optiga_sim_latency =
+{
+    .enabled = TRUE,
+    .error_us = 1000,
+    .shielded_us = 1500,
+};
+
+static bool_t optiga_sim_latency_set_entry(uint8_t command, uint8_t variant, uint32_t base_us, uint32_t per_kbyte_us)
+{
+    uint8_t index;
+
+    for (index = 0; index < optiga_sim_latency.entry_count; index++)
+    {
+        if ((command == optiga_sim_latency.entries[index].command) &&
+            (variant == optiga_sim_latency.entries[index].variant))
+        {
+            break;
+        }
+    }
+    if (index >= OPTIGA_SIM_LATENCY_MAX_ENTRIES)
+    {
+        return (FALSE);
+    }
+    if (index == optiga_sim_latency.entry_count)
+    {
+        optiga_sim_latency.entry_count++;
+    }
+    optiga_sim_latency.entries[index].command = command;
+    optiga_sim_latency.entries[index].variant = variant;
+    optiga_sim_latency.entries[index].base_us = base_us;
+    optiga_sim_latency.entries[index].per_kbyte_us = per_kbyte_us;
+    return (TRUE);
+}
+
+static bool_t optiga_sim_latency_find_command(const char * name, uint8_t * command)
+{
+    uint8_t index;
+
+    for (index = 0; index < (sizeof(optiga_sim_latency_command_names) / sizeof(optiga_sim_latency_command_names[0])); index++)
+    {
+        if (0 == strcmp(name, optiga_sim_latency_command_names[index].name))
+        {
+            *command = optiga_sim_latency_command_names[index].command;
+            return (TRUE);
+        }
+    }
+    return (FALSE);
+}
+
+/**
+ * Parses one line of the profile. Supported forms (values in microseconds, '#' starts a comment):
+ *   <command> <variant|*> <base_us> [per_kbyte_us]     e.g. "calc_sign 0x03 60000"
+ *   i2c_clock_khz <kHz>
+ *   error_us <us>
+ *   shielded_us <us>
+ */
+static bool_t optiga_sim_latency_parse_line(char * line)
+{
+    char * fields[4] = {NULL};
+    char * field;
+    char * save = NULL;
+    uint8_t field_count = 0;
+    uint8_t command;
+    uint8_t variant;
+    char * comment = strchr(line, '#');
+
+    if (NULL != comment)
+    {
+        *comment = '\0';
+    }
+    field = strtok_r(line, " \t\r\n", &save);
+    while ((NULL != field) && (field_count < 4))
+    {
+        fields[field_count++] = field;
+        field = strtok_r(NULL, " \t\r\n", &save);
+    }
+    if (NULL != field)
+    {
+        return (FALSE);
+    }
+
+    if (0 == field_count)
+    {
+        return (TRUE);
+    }
+    if (2 == field_count)
+    {
+        if (0 == strcmp(fields[0], "i2c_clock_khz"))
+        {
+            (void)pal_i2c_set_bitrate(NULL, (uint16_t)strtoul(fields[1], NULL, 0));
+            return (TRUE);
+        }
+        if (0 == strcmp(fields[0], "error_us"))
+        {
+            optiga_sim_latency.error_us = (uint32_t)strtoul(fields[1], NULL, 0);
+            return (TRUE);
+        }
+        if (0 == strcmp(fields[0], "shielded_us"))
+        {
+            optiga_sim_latency.shielded_us = (uint32_t)strtoul(fields[1], NULL, 0);
+            return (TRUE);
+        }
+        return (FALSE);
+    }
+    if ((field_count < 3) || (FALSE == optiga_sim_latency_find_command(fields[0], &command)))
+    {
+        return (FALSE);
+    }
+    variant = (0 == strcmp(fields[1], "*")) ? OPTIGA_SIM_LATENCY_ANY_VARIANT : (uint8_t)strtoul(fields[1], NULL, 0);
+    return (optiga_sim_latency_set_entry(command,
+                                         variant,
+                                         (uint32_t)strtoul(fields[2], NULL, 0),
+                                         (4 == field_count) ? (uint32_t)strtoul(fields[3], NULL, 0) : 0));
+}
+
+void optiga_sim_latency_init(void)
+{
+    const char * profile = getenv(OPTIGA_SIM_LATENCY_ENV);
+    char line[128];
+    uint32_t line_number = 0;
+    uint8_t index;
+    FILE * file;
+
+    optiga_sim_latency.entry_count = 0;
+    for (index = 0; index < (sizeof(optiga_sim_latency_default_profile) / sizeof(optiga_sim_latency_default_profile[0])); index++)
+    {
+        (void)optiga_sim_latency_set_entry(optiga_sim_latency_default_profile[index].command,
+                                           optiga_sim_latency_default_profile[index].variant,
+                                           optiga_sim_latency_default_profile[index].base_us,
+                                           optiga_sim_latency_default_profile[index].per_kbyte_us);
+    }
+
+    do
+    {
+        if (NULL == profile)
+        {
+            break;
+        }
+        if ('\0' == profile[0])
+        {
+            optiga_sim_latency.enabled = FALSE;
+            break;
+        }
+        file = fopen(profile, "r");
+        if (NULL == file)
+        {
+            fprintf(stderr, "optiga_sim: cannot open latency profile %s, using the built-in profile\n", profile);
+            break;
+        }
+        while (NULL != fgets(line, sizeof(line), file))
+        {
+            line_number++;
+            if (FALSE == optiga_sim_latency_parse_line(line))
+            {
+                fprintf(stderr, "optiga_sim: %s:%u: invalid latency entry ignored\n", profile, (unsigned)line_number);
+            }
+        }
+        (void)fclose(file);
+    } while (FALSE);
+}
+
+bool_t optiga_sim_latency_is_enabled(void)
+{
+    return (optiga_sim_latency.enabled);
+}
+
+static const optiga_sim_latency_entry_t * optiga_sim_latency_find_entry(uint8_t command, uint8_t variant)
+{
+    const optiga_sim_latency_entry_t * fallback = NULL;
+    uint8_t index;
+
+    for (index = 0; index < optiga_sim_latency.entry_count; index++)
+    {
+        if (command != optiga_sim_latency.entries[index].command)
+        {
+            continue;
+        }
+        if (variant == optiga_sim_latency.entries[index].variant)
+        {
+            return (&optiga_sim_latency.entries[index]);
+        }
+        /* Entries of other variants are used if the table has no generic entry */
+        if ((NULL == fallback) || (OPTIGA_SIM_LATENCY_ANY_VARIANT == optiga_sim_latency.entries[index].variant))
+        {
+            fallback = &optiga_sim_latency.entries[index];
+        }
+    }
+    return (fallback);
+}
+
+uint32_t optiga_sim_latency_get(const optiga_sim_latency_request_t * request, uint8_t current_ma)
+{
+    const optiga_sim_latency_entry_t * entry;
+    uint64_t execution_us;
+
+    if (FALSE == optiga_sim_latency.enabled)
+    {
+        return (0);
+    }
+
+    if (FALSE == request->succeeded)
+    {
+        return (optiga_sim_latency.error_us);
+    }
+
+    entry = optiga_sim_latency_find_entry(request->command, request->variant);
+    execution_us = (NULL == entry) ? optiga_sim_latency.error_us :
+                   (entry->base_us + (((uint64_t)entry->per_kbyte_us * request->data_length) / 1024U));
+    if (TRUE == request->shielded)
+    {
+        execution_us += optiga_sim_latency.shielded_us;
+    }
+
+    /* The crypto engine is throttled to stay within the configured current limit */
+    if (current_ma < OPTIGA_SIM_LATENCY_MIN_CURRENT_MA)
+    {
+        current_ma = OPTIGA_SIM_LATENCY_MIN_CURRENT_MA;
+    }
+    if (current_ma > OPTIGA_SIM_LATENCY_MAX_CURRENT_MA)
+    {
+        current_ma = OPTIGA_SIM_LATENCY_MAX_CURRENT_MA;
+    }
+    execution_us = (execution_us * OPTIGA_SIM_LATENCY_MAX_CURRENT_MA) / current_ma;
+
+    return ((uint32_t)execution_us);
+}
+
+uint64_t optiga_sim_latency_now(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return (((uint64_t)now.tv_sec * 1000000U) + ((uint64_t)now.tv_nsec / 1000U));
+}
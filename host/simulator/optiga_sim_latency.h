@@ -0,0 +1,135 @@
+/******************************************************************************
+* File Name:   optiga_sim_latency.h
+*
+* Description: Latency model of the simulated OPTIGA Trust M.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef _OPTIGA_SIM_LATENCY_H_
+#define _OPTIGA_SIM_LATENCY_H_
+
+#include "optiga/common/optiga_lib_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Command codes of the OPTIGA external interface (see Solution Reference Manual) */
+typedef enum optiga_sim_command
+{
+    OPTIGA_SIM_COMMAND_GET_DATA_OBJECT      = 0x81,
+    OPTIGA_SIM_COMMAND_SET_DATA_OBJECT      = 0x82,
+    OPTIGA_SIM_COMMAND_SET_OBJECT_PROTECTED = 0x83,
+    OPTIGA_SIM_COMMAND_GET_RANDOM           = 0x8C,
+    OPTIGA_SIM_COMMAND_ENCRYPT_SYM          = 0x94,
+    OPTIGA_SIM_COMMAND_DECRYPT_SYM          = 0x95,
+    OPTIGA_SIM_COMMAND_ENCRYPT_ASYM         = 0x9E,
+    OPTIGA_SIM_COMMAND_DECRYPT_ASYM         = 0x9F,
+    OPTIGA_SIM_COMMAND_CALC_HASH            = 0xB0,
+    OPTIGA_SIM_COMMAND_CALC_SIGN            = 0xB1,
+    OPTIGA_SIM_COMMAND_VERIFY_SIGN          = 0xB2,
+    OPTIGA_SIM_COMMAND_CALC_SSEC            = 0xB3,
+    OPTIGA_SIM_COMMAND_DERIVE_KEY           = 0xB4,
+    OPTIGA_SIM_COMMAND_GEN_KEYPAIR          = 0xB8,
+    OPTIGA_SIM_COMMAND_GEN_SYMKEY           = 0xB9,
+    OPTIGA_SIM_COMMAND_OPEN_APPLICATION     = 0xF0,
+    OPTIGA_SIM_COMMAND_CLOSE_APPLICATION    = 0xF1
+} optiga_sim_command_t;
+
+/** @brief Algorithm independent entry of the latency table */
+#define OPTIGA_SIM_LATENCY_ANY_VARIANT          (0x00)
+
+/** @brief Smallest and largest current limit accepted by the chip (0xE0C4), in mA */
+#define OPTIGA_SIM_LATENCY_MIN_CURRENT_MA       (6U)
+#define OPTIGA_SIM_LATENCY_MAX_CURRENT_MA       (15U)
+
+/** @brief Cost of one command, as accumulated by the simulator while executing it */
+typedef struct optiga_sim_latency_request
+{
+    /// Command code (#optiga_sim_command_t)
+    uint8_t command;
+    /// Algorithm used by the command: curve, RSA key type or symmetric key type (0 if not relevant)
+    uint8_t variant;
+    /// TRUE if the command and response are protected by the shielded connection
+    bool_t shielded;
+    /// TRUE if the command succeeded, failing commands only pay the parsing time
+    bool_t succeeded;
+    /// Length of the command and response APDU payloads
+    uint32_t command_length;
+    uint32_t response_length;
+    /// Amount of data processed by the command (hashed, encrypted, written), scales the execution time
+    uint32_t data_length;
+} optiga_sim_latency_request_t;
+
+/**
+ * \brief Loads the latency profile.
+ *
+ * \details
+ * The built-in profile approximates the timings of an OPTIGA Trust M V3 at the maximum current limit.
+ * The file named by the OPTIGA_SIM_LATENCY environment variable (if set) overrides individual entries;
+ * setting the variable to an empty string disables the latency model and all commands complete at once.
+ */
+void optiga_sim_latency_init(void);
+
+/**
+ * \brief Returns FALSE if the latency model is disabled and all commands complete at once.
+ */
+bool_t optiga_sim_latency_is_enabled(void);
+
+/**
+ * \brief Returns the time the chip needs to execute the request, in microseconds.
+ *
+ * \details
+ * The I2C transfer of the command and response is not included, the I2C PAL adds it
+ * (see pal_i2c_sim_exchange).
+ *
+ * \param[in] request       Command to account for
+ * \param[in] current_ma    Current limit configured in 0xE0C4, in mA
+ */
+uint32_t optiga_sim_latency_get(const optiga_sim_latency_request_t * request, uint8_t current_ma);
+
+/**
+ * \brief Monotonic time base of the latency model, in microseconds.
+ */
+uint64_t optiga_sim_latency_now(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SIM_LATENCY_H_ */
@@ -0,0 +1,728 @@
+/******************************************************************************
+* File Name:   optiga_util_sim.c
+*
+* Description: This file implements the optiga_util API of the OPTIGA Trust M host
+*              library on top of the host side simulator (application life cycle,
+*              data object and metadata access, counters and protected update).
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "optiga/optiga_util.h"
+#include "optiga_sim.h"
+
+#define OPTIGA_UTIL_SIM_COUNTER_LENGTH          (8U)
+#define OPTIGA_UTIL_SIM_FRAGMENT_DIGEST_LENGTH  (32U)
+#define OPTIGA_UTIL_SIM_CURRENT_LIMIT_OID       (0xE0C4)
+#define OPTIGA_UTIL_SIM_CURRENT_LIMIT_MIN       (0x06)
+#define OPTIGA_UTIL_SIM_CURRENT_LIMIT_MAX       (0x0F)
+#define OPTIGA_UTIL_SIM_AC_INT                  (0x21)
+#define OPTIGA_UTIL_SIM_CBOR_BSTR_2             (0x42)
+#define OPTIGA_UTIL_SIM_OID_HEADER_LENGTH       (6U)
+#define OPTIGA_UTIL_SIM_APPLICATION_ID_LENGTH   (16U)
+
+/** @brief Simulated util instance. The public optiga_util_t must stay the first member. */
+typedef struct optiga_util_sim
+{
+    optiga_util_t util;
+    optiga_sim_instance_t sim;
+    /// Protected update started by #optiga_util_protected_update_start
+    uint16_t protected_update_oid;
+    uint8_t * protected_update_data;
+    uint32_t protected_update_length;
+} optiga_util_sim_t;
+
+static optiga_lib_status_t optiga_util_sim_begin(optiga_util_sim_t * me,
+                                                 uint8_t command,
+                                                 bool_t requires_application,
+                                                 optiga_lib_status_t * status)
+{
+    *status = optiga_sim_begin(&me->sim, command, requires_application);
+    return ((OPTIGA_LIB_BUSY == *status) ? OPTIGA_UTIL_ERROR_INSTANCE_IN_USE : OPTIGA_LIB_SUCCESS);
+}
+
+static optiga_lib_status_t optiga_util_sim_get_object(optiga_util_sim_t * me,
+                                                      uint16_t oid,
+                                                      uint8_t access_tag,
+                                                      optiga_sim_object_t ** object)
+{
+    *object = optiga_sim_find_object(oid);
+    if (NULL == *object)
+    {
+        return (OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_OID));
+    }
+    return (optiga_sim_check_access(*object, access_tag, &me->sim));
+}
+
+static void optiga_util_sim_protected_update_reset(optiga_util_sim_t * me)
+{
+    free(me->protected_update_data);
+    me->protected_update_data = NULL;
+    me->protected_update_length = 0;
+    me->protected_update_oid = 0;
+}
+
+/**
+ * Searches the manifest for an encoded OID (2 byte CBOR byte string)
+ */
+static bool_t optiga_util_sim_manifest_contains(const uint8_t * manifest, uint16_t manifest_length, uint16_t oid)
+{
+    uint16_t index;
+
+    for (index = 0; (index + 2) < manifest_length; index++)
+    {
+        if ((OPTIGA_UTIL_SIM_CBOR_BSTR_2 == manifest[index]) &&
+            ((uint8_t)(oid >> 8) == manifest[index + 1]) && ((uint8_t)oid == manifest[index + 2]))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * Finds the target object of a manifest: an object named in the manifest whose change
+ * access condition is Int() with a trust anchor that is named in the manifest as well.
+ */
+static uint16_t optiga_util_sim_manifest_target(const uint8_t * manifest, uint16_t manifest_length)
+{
+    optiga_sim_object_t * object;
+    const uint8_t * change;
+    uint8_t change_length;
+    uint16_t trust_anchor;
+    uint16_t index;
+    uint8_t position;
+
+    for (index = 0; (index + 2) < manifest_length; index++)
+    {
+        if (OPTIGA_UTIL_SIM_CBOR_BSTR_2 != manifest[index])
+        {
+            continue;
+        }
+        object = optiga_sim_find_object((uint16_t)((manifest[index + 1] << 8) | manifest[index + 2]));
+        if (NULL == object)
+        {
+            continue;
+        }
+        change = optiga_sim_get_metadata_tag(object, OPTIGA_SIM_TAG_CHANGE, &change_length);
+        for (position = 0; (NULL != change) && ((position + 2) < change_length); position++)
+        {
+            if (OPTIGA_UTIL_SIM_AC_INT != change[position])
+            {
+                continue;
+            }
+            trust_anchor = (uint16_t)((change[position + 1] << 8) | change[position + 2]);
+            if (TRUE == optiga_util_sim_manifest_contains(manifest, manifest_length, trust_anchor))
+            {
+                return (object->oid);
+            }
+        }
+    }
+    return (0);
+}
+
+/**
+ * Applies the payload of a completed protected update to the target object
+ */
+static optiga_lib_status_t optiga_util_sim_protected_update_apply(optiga_util_sim_t * me)
+{
+    optiga_sim_object_t * object = optiga_sim_find_object(me->protected_update_oid);
+    const uint8_t * payload = me->protected_update_data;
+    uint32_t length = me->protected_update_length;
+    optiga_lib_status_t status = OPTIGA_LIB_SUCCESS;
+
+    do
+    {
+        if (NULL == object)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_MANIFEST);
+            break;
+        }
+        if ((length >= 2) && (OPTIGA_SIM_TAG_METADATA == payload[0]) && ((uint32_t)(payload[1] + 2) == length))
+        {
+            /* Metadata update */
+            status = optiga_sim_update_metadata(object, payload, (uint8_t)length);
+            break;
+        }
+        if (OPTIGA_SIM_CONTENT_DATA != object->content)
+        {
+            /* Key payloads are not decoded by the simulator, the key object is left as is */
+            break;
+        }
+        if (length > object->max_size)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_DATA_OBJECT_BOUNDARY);
+            break;
+        }
+        optiga_sim_set_object_content(object, OPTIGA_SIM_CONTENT_DATA, payload, (uint16_t)length);
+    } while (FALSE);
+
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        optiga_sim_store();
+    }
+    return (status);
+}
+
+optiga_util_t * optiga_util_create(uint8_t optiga_instance_id,
+                                   callback_handler_t handler,
+                                   void * caller_context)
+{
+    optiga_util_sim_t * me = NULL;
+
+    (void)optiga_instance_id;
+    do
+    {
+        if (NULL == handler)
+        {
+            break;
+        }
+        me = (optiga_util_sim_t *)calloc(1, sizeof(optiga_util_sim_t));
+        if (NULL == me)
+        {
+            break;
+        }
+        if (FALSE == optiga_sim_register_instance(&me->sim, handler, caller_context))
+        {
+            free(me);
+            me = NULL;
+            break;
+        }
+        me->util.handler = handler;
+        me->util.caller_context = caller_context;
+    } while (FALSE);
+
+    return ((optiga_util_t *)me);
+}
+
+optiga_lib_status_t optiga_util_destroy(optiga_util_t * me)
+{
+    optiga_util_sim_t * p_sim = (optiga_util_sim_t *)me;
+
+    if (NULL == me)
+    {
+        return (OPTIGA_UTIL_ERROR_INVALID_INPUT);
+    }
+    if (TRUE == p_sim->sim.busy)
+    {
+        return (OPTIGA_UTIL_ERROR_INSTANCE_IN_USE);
+    }
+    optiga_util_sim_protected_update_reset(p_sim);
+    optiga_sim_unregister_instance(&p_sim->sim);
+    free(p_sim);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+void optiga_util_set_comms_params(optiga_util_t * me,
+                                  uint8_t parameter_type,
+                                  uint8_t value)
+{
+    optiga_util_sim_t * p_sim = (optiga_util_sim_t *)me;
+
+    if (NULL == me)
+    {
+        return;
+    }
+    if (OPTIGA_COMMS_PROTECTION_LEVEL == parameter_type)
+    {
+        p_sim->sim.protection_level = value;
+    }
+    else if (OPTIGA_COMMS_PROTOCOL_VERSION == parameter_type)
+    {
+        p_sim->sim.protocol_version = value;
+    }
+}
+
+optiga_lib_status_t optiga_util_open_application(optiga_util_t * me,
+                                                 bool_t perform_restore)
+{
+    optiga_util_sim_t * p_sim = (optiga_util_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if (NULL == me)
+    {
+        return (OPTIGA_UTIL_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_util_sim_begin(p_sim, OPTIGA_SIM_COMMAND_OPEN_APPLICATION, FALSE, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        status = optiga_sim_open_application(perform_restore);
+        optiga_sim_set_transfer(&p_sim->sim, OPTIGA_UTIL_SIM_APPLICATION_ID_LENGTH, 0, 0);
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_util_close_application(optiga_util_t * me,
+                                                  bool_t perform_hibernate)
+{
+    optiga_util_sim_t * p_sim = (optiga_util_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if (NULL == me)
+    {
+        return (OPTIGA_UTIL_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_util_sim_begin(p_sim, OPTIGA_SIM_COMMAND_CLOSE_APPLICATION, TRUE, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        status = optiga_sim_close_application(perform_hibernate);
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_util_read_data(optiga_util_t * me,
+                                          uint16_t optiga_oid,
+                                          uint16_t offset,
+                                          uint8_t * buffer,
+                                          uint16_t * length)
+{
+    optiga_util_sim_t * p_sim = (optiga_util_sim_t *)me;
+    optiga_sim_object_t * object;
+    uint16_t bytes_to_read;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == buffer) || (NULL == length))
+    {
+        return (OPTIGA_UTIL_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_util_sim_begin(p_sim, OPTIGA_SIM_COMMAND_GET_DATA_OBJECT, TRUE, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_util_sim_get_object(p_sim, optiga_oid, OPTIGA_SIM_TAG_READ, &object);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (OPTIGA_SIM_CONTENT_DATA != object->content)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_ACCESS_CONDITION);
+            break;
+        }
+        if (offset > object->length)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_DATA_OBJECT_BOUNDARY);
+            break;
+        }
+        bytes_to_read = (uint16_t)(object->length - offset);
+        if (bytes_to_read > *length)
+        {
+            bytes_to_read = *length;
+        }
+        memcpy(buffer, &object->data[offset], bytes_to_read);
+        *length = bytes_to_read;
+        optiga_sim_set_transfer(&p_sim->sim, OPTIGA_UTIL_SIM_OID_HEADER_LENGTH, bytes_to_read, bytes_to_read);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_util_read_metadata(optiga_util_t * me,
+                                              uint16_t optiga_oid,
+                                              uint8_t * buffer,
+                                              uint16_t * length)
+{
+    optiga_util_sim_t * p_sim = (optiga_util_sim_t *)me;
+    optiga_sim_object_t * object;
+    uint16_t metadata_length;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == buffer) || (NULL == length))
+    {
+        return (OPTIGA_UTIL_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_util_sim_begin(p_sim, OPTIGA_SIM_COMMAND_GET_DATA_OBJECT, TRUE, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        object = optiga_sim_find_object(optiga_oid);
+        if (NULL == object)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_OID);
+            break;
+        }
+        metadata_length = optiga_sim_encode_metadata(object, buffer, *length);
+        if (0 == metadata_length)
+        {
+            status = OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        *length = metadata_length;
+        optiga_sim_set_transfer(&p_sim->sim, OPTIGA_UTIL_SIM_OID_HEADER_LENGTH, metadata_length, 0);
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_util_write_data(optiga_util_t * me,
+                                           uint16_t optiga_oid,
+                                           uint8_t write_type,
+                                           uint16_t offset,
+                                           const uint8_t * buffer,
+                                           uint16_t length)
+{
+    optiga_util_sim_t * p_sim = (optiga_util_sim_t *)me;
+    optiga_sim_object_t * object;
+    uint16_t new_length;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == buffer) ||
+        ((OPTIGA_UTIL_WRITE_ONLY != write_type) && (OPTIGA_UTIL_ERASE_AND_WRITE != write_type)))
+    {
+        return (OPTIGA_UTIL_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_util_sim_begin(p_sim, OPTIGA_SIM_COMMAND_SET_DATA_OBJECT, TRUE, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_util_sim_get_object(p_sim, optiga_oid, OPTIGA_SIM_TAG_CHANGE, &object);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (OPTIGA_SIM_CONTENT_DATA != object->content)
+        {
+            /* Keys are only written by key generation or protected update */
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_ACCESS_CONDITION);
+            break;
+        }
+        if ((uint32_t)(offset + length) > object->max_size)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_DATA_OBJECT_BOUNDARY);
+            break;
+        }
+        if ((OPTIGA_UTIL_SIM_CURRENT_LIMIT_OID == optiga_oid) &&
+            ((buffer[0] < OPTIGA_UTIL_SIM_CURRENT_LIMIT_MIN) || (buffer[0] > OPTIGA_UTIL_SIM_CURRENT_LIMIT_MAX)))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        if (OPTIGA_UTIL_ERASE_AND_WRITE == write_type)
+        {
+            memset(object->data, 0, object->max_size);
+            new_length = (uint16_t)(offset + length);
+        }
+        else
+        {
+            if (offset > object->length)
+            {
+                status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_DATA_OBJECT_BOUNDARY);
+                break;
+            }
+            new_length = ((offset + length) > object->length) ? (uint16_t)(offset + length) : object->length;
+        }
+        memcpy(&object->data[offset], buffer, length);
+        optiga_sim_set_object_content(object, OPTIGA_SIM_CONTENT_DATA, object->data, new_length);
+        optiga_sim_set_transfer(&p_sim->sim, OPTIGA_UTIL_SIM_OID_HEADER_LENGTH + length, 0, length);
+        optiga_sim_store();
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_util_write_metadata(optiga_util_t * me,
+                                               uint16_t optiga_oid,
+                                               const uint8_t * buffer,
+                                               uint8_t length)
+{
+    optiga_util_sim_t * p_sim = (optiga_util_sim_t *)me;
+    optiga_sim_object_t * object;
+    const uint8_t * lcso;
+    uint8_t lcso_length;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == buffer))
+    {
+        return (OPTIGA_UTIL_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_util_sim_begin(p_sim, OPTIGA_SIM_COMMAND_SET_DATA_OBJECT, TRUE, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_util_sim_get_object(p_sim, optiga_oid, OPTIGA_SIM_TAG_CHANGE, &object);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        /* Metadata is frozen once the object reached the operational life cycle state */
+        lcso = optiga_sim_get_metadata_tag(object, OPTIGA_SIM_TAG_LCSO, &lcso_length);
+        if ((NULL != lcso) && (lcso[0] >= OPTIGA_SIM_LCS_OPERATIONAL))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_ACCESS_CONDITION);
+            break;
+        }
+        status = optiga_sim_update_metadata(object, buffer, length);
+        if (OPTIGA_LIB_SUCCESS == status)
+        {
+            optiga_sim_set_transfer(&p_sim->sim, OPTIGA_UTIL_SIM_OID_HEADER_LENGTH + length, 0, length);
+            optiga_sim_store();
+        }
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_util_protected_update_start(optiga_util_t * me,
+                                                       uint8_t manifest_version,
+                                                       const uint8_t * manifest,
+                                                       uint16_t manifest_length)
+{
+    optiga_util_sim_t * p_sim = (optiga_util_sim_t *)me;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    (void)manifest_version;
+    if ((NULL == me) || (NULL == manifest))
+    {
+        return (OPTIGA_UTIL_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_util_sim_begin(p_sim, OPTIGA_SIM_COMMAND_SET_OBJECT_PROTECTED, TRUE, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    optiga_util_sim_protected_update_reset(p_sim);
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        p_sim->protected_update_oid = optiga_util_sim_manifest_target(manifest, manifest_length);
+        optiga_sim_set_transfer(&p_sim->sim, manifest_length, 0, 0);
+        if (0 == p_sim->protected_update_oid)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_MANIFEST);
+        }
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+/**
+ * Collects the payload of a fragment. Every fragment but the last one ends with the digest of the next one.
+ */
+static optiga_lib_status_t optiga_util_sim_protected_update_fragment(optiga_util_t * me,
+                                                                     const uint8_t * fragment,
+                                                                     uint16_t fragment_length,
+                                                                     bool_t last)
+{
+    optiga_util_sim_t * p_sim = (optiga_util_sim_t *)me;
+    uint8_t * payload;
+    uint16_t payload_length = fragment_length;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if ((NULL == me) || (NULL == fragment))
+    {
+        return (OPTIGA_UTIL_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_util_sim_begin(p_sim, OPTIGA_SIM_COMMAND_SET_OBJECT_PROTECTED, TRUE, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        if (0 == p_sim->protected_update_oid)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_COMMAND_OUT_OF_SEQUENCE);
+            break;
+        }
+        if (FALSE == last)
+        {
+            if (payload_length < OPTIGA_UTIL_SIM_FRAGMENT_DIGEST_LENGTH)
+            {
+                status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INTEGRITY_VALIDATION);
+                break;
+            }
+            payload_length = (uint16_t)(payload_length - OPTIGA_UTIL_SIM_FRAGMENT_DIGEST_LENGTH);
+        }
+        payload = realloc(p_sim->protected_update_data, p_sim->protected_update_length + payload_length + 1);
+        if (NULL == payload)
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INSUFFICIENT_MEMORY);
+            break;
+        }
+        memcpy(&payload[p_sim->protected_update_length], fragment, payload_length);
+        optiga_sim_set_transfer(&p_sim->sim, fragment_length, 0, fragment_length);
+        p_sim->protected_update_data = payload;
+        p_sim->protected_update_length += payload_length;
+        if (TRUE == last)
+        {
+            status = optiga_util_sim_protected_update_apply(p_sim);
+        }
+    } while (FALSE);
+    if ((TRUE == last) || (OPTIGA_LIB_SUCCESS != status))
+    {
+        optiga_util_sim_protected_update_reset(p_sim);
+    }
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_util_protected_update_continue(optiga_util_t * me,
+                                                          const uint8_t * fragment,
+                                                          uint16_t fragment_length)
+{
+    return (optiga_util_sim_protected_update_fragment(me, fragment, fragment_length, FALSE));
+}
+
+optiga_lib_status_t optiga_util_protected_update_final(optiga_util_t * me,
+                                                       const uint8_t * fragment,
+                                                       uint16_t fragment_length)
+{
+    return (optiga_util_sim_protected_update_fragment(me, fragment, fragment_length, TRUE));
+}
+
+optiga_lib_status_t optiga_util_update_count(optiga_util_t * me,
+                                             uint16_t optiga_counter_oid,
+                                             uint32_t count)
+{
+    optiga_util_sim_t * p_sim = (optiga_util_sim_t *)me;
+    optiga_sim_object_t * object;
+    const uint8_t * type;
+    uint8_t type_length;
+    uint32_t counter;
+    uint32_t threshold;
+    optiga_lib_status_t return_value;
+    optiga_lib_status_t status;
+
+    if (NULL == me)
+    {
+        return (OPTIGA_UTIL_ERROR_INVALID_INPUT);
+    }
+    return_value = optiga_util_sim_begin(p_sim, OPTIGA_SIM_COMMAND_SET_DATA_OBJECT, TRUE, &status);
+    if (OPTIGA_LIB_SUCCESS != return_value)
+    {
+        return (return_value);
+    }
+    do
+    {
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        status = optiga_util_sim_get_object(p_sim, optiga_counter_oid, OPTIGA_SIM_TAG_CHANGE, &object);
+        if (OPTIGA_LIB_SUCCESS != status)
+        {
+            break;
+        }
+        type = optiga_sim_get_metadata_tag(object, OPTIGA_SIM_TAG_DATA_OBJECT_TYPE, &type_length);
+        if ((NULL == type) || (OPTIGA_SIM_DATA_TYPE_UPCTR != type[0]) ||
+            (OPTIGA_UTIL_SIM_COUNTER_LENGTH != object->length))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_INVALID_PARAMETER);
+            break;
+        }
+        counter = ((uint32_t)object->data[0] << 24) | ((uint32_t)object->data[1] << 16) |
+                  ((uint32_t)object->data[2] << 8) | object->data[3];
+        threshold = ((uint32_t)object->data[4] << 24) | ((uint32_t)object->data[5] << 16) |
+                    ((uint32_t)object->data[6] << 8) | object->data[7];
+        if ((count > threshold) || (counter > (threshold - count)))
+        {
+            status = OPTIGA_SIM_DEVICE_ERROR(OPTIGA_SIM_ERROR_COUNTER_THRESHOLD);
+            break;
+        }
+        counter += count;
+        object->data[0] = (uint8_t)(counter >> 24);
+        object->data[1] = (uint8_t)(counter >> 16);
+        object->data[2] = (uint8_t)(counter >> 8);
+        object->data[3] = (uint8_t)counter;
+        optiga_sim_set_transfer(&p_sim->sim, OPTIGA_UTIL_SIM_OID_HEADER_LENGTH + 4, 0, 0);
+        optiga_sim_store();
+    } while (FALSE);
+    optiga_sim_complete(&p_sim->sim, status);
+
+    return (OPTIGA_LIB_SUCCESS);
+}
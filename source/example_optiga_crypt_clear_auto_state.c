@@ -47,6 +47,8 @@
 #include "optiga/pal/pal_os_memory.h"
 #include "optiga/pal/pal_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
 #include "mbedtls/ccm.h"
 #include "mbedtls/md.h"
 #include "mbedtls/ssl.h"
@@ -114,18 +116,10 @@ static uint8_t arbitrary_data[16] = {0x00};
 static uint8_t hmac_buffer[32] = {0x00};
 static const uint32_t hmac_length = sizeof(hmac_buffer);
 /**
- * Callback when optiga_util_xxxx/optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt and util instances, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_lib_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
+static optiga_shell_request_t optiga_util_request;
 
 /**
  * The below example demonstrates of clear auto state functionality.
@@ -153,13 +147,13 @@ void example_optiga_crypt_clear_auto_state(void)
         /**
          * 1. Create OPTIGA crypt and util Instances
          */
-        me_crypt = optiga_crypt_create(0, optiga_lib_callback, NULL);
+        me_crypt = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me_crypt)
         {
             break;
         }
         
-        me_util = optiga_util_create(0, optiga_lib_callback, NULL);
+        me_util = optiga_shell_pool_get_util(&optiga_util_request);
         if (NULL == me_util)
         {
             break;
@@ -176,18 +170,18 @@ void example_optiga_crypt_clear_auto_state(void)
         /**
          * 3. Set the metadata of secret OID(0xF1D0) using optiga_util_write_metadata.
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_write_metadata(me_util,
                                                    0xF1D0,
                                                    secret_oid_metadata,
                                                    sizeof(secret_oid_metadata));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
 
         /**
         *  4. Write shared secret in OID 0xF1D0
         */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_write_data(me_util,
                                                0xF1D0,
                                                OPTIGA_UTIL_ERASE_AND_WRITE,
@@ -195,12 +189,12 @@ void example_optiga_crypt_clear_auto_state(void)
                                                user_secret,
                                                sizeof(user_secret));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
         
         /**
          * 5. Call generate auth code with optional data
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_generate_auth_code(me_crypt,
                                                         OPTIGA_RNG_TYPE_TRNG,
                                                         optional_data,
@@ -208,7 +202,7 @@ void example_optiga_crypt_clear_auto_state(void)
                                                         random_data,
                                                         32);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         /**
          * 6. Calculate HMAC on host
          */
@@ -232,7 +226,7 @@ void example_optiga_crypt_clear_auto_state(void)
         /**
          * 7. Perform HMAC verification using OPTIGA
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_hmac_verify(me_crypt,
                                                  OPTIGA_HMAC_SHA_256,
                                                  0xF1D0,
@@ -240,17 +234,17 @@ void example_optiga_crypt_clear_auto_state(void)
                                                  sizeof(input_data_buffer),
                                                  hmac_buffer,
                                                  hmac_length);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         /**
          * 8. Perform clear auto state using OPTIGA
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
         return_status = optiga_crypt_clear_auto_state(me_crypt,
                                                       0xF1D0);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -270,8 +264,8 @@ void example_optiga_crypt_clear_auto_state(void)
     
     if(me_util)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_util_destroy(me_util);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_util(me_util);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -280,8 +274,8 @@ void example_optiga_crypt_clear_auto_state(void)
     }
     if(me_crypt)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me_crypt);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me_crypt);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
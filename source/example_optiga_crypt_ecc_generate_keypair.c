@@ -45,6 +45,8 @@
 #include "optiga/optiga_util.h"
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
 
 #ifdef OPTIGA_CRYPT_ECC_GENERATE_KEYPAIR_ENABLED
 
@@ -54,27 +56,10 @@ extern void example_optiga_deinit(void);
 #endif
 
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt and util instances, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_util_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
+static optiga_shell_request_t optiga_util_request;
 /**
  * Sample metadata of 0xE0F1 
  */
@@ -113,26 +98,26 @@ void example_optiga_crypt_ecc_generate_keypair(void)
         /**
          * 1. Create OPTIGA Crypt Instance
          */
-        crypt_me = optiga_crypt_create(0, optiga_crypt_callback, NULL);
+        crypt_me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == crypt_me)
         {
             break;
         }
 
-        util_me = optiga_util_create(0, optiga_util_callback, NULL);
+        util_me = optiga_shell_pool_get_util(&optiga_util_request);
         if (NULL == util_me)
         {
             break;
         }
         
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         optiga_oid = 0xE0F1;
         return_status = optiga_util_write_metadata(util_me,
                                                    optiga_oid,
                                                    E0F1_metadata,
                                                    sizeof(E0F1_metadata));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
         
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -143,7 +128,7 @@ void example_optiga_crypt_ecc_generate_keypair(void)
          *       - Store the Private key in OPTIGA Key store
          *       - Export Public Key
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         optiga_key_id = OPTIGA_KEY_ID_E0F1;
         /* for Session based, use OPTIGA_KEY_ID_SESSION_BASED as key id as shown below. */
         /* optiga_key_id = OPTIGA_KEY_ID_SESSION_BASED; */
@@ -154,7 +139,7 @@ void example_optiga_crypt_ecc_generate_keypair(void)
                                                           &optiga_key_id,
                                                           public_key,
                                                           &public_key_length);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -173,8 +158,8 @@ void example_optiga_crypt_ecc_generate_keypair(void)
     
     if (crypt_me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(crypt_me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(crypt_me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -183,8 +168,8 @@ void example_optiga_crypt_ecc_generate_keypair(void)
     }
     if (util_me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_util_destroy(util_me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_util(util_me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -43,6 +43,9 @@
 
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_policy.h"
 
 #ifdef OPTIGA_CRYPT_ECDH_ENABLED
 
@@ -52,18 +55,9 @@ extern void example_optiga_deinit(void);
 #endif
 
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt instance, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
 
 /* Peer public key details for the ECDH operation */
 static uint8_t peer_public_key [] =
@@ -124,7 +118,7 @@ void example_optiga_crypt_ecdh(void)
         /**
          * 1. Create OPTIGA Crypt Instance
          */
-        me = optiga_crypt_create(0, optiga_crypt_callback, NULL);
+        me = optiga_shell_pool_get_session_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -137,11 +131,10 @@ void example_optiga_crypt_ecdh(void)
          *       - Store the Private key with in OPTIGA Session
          *       - Export Public Key
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         optiga_key_id = OPTIGA_KEY_ID_SESSION_BASED;
 
-        OPTIGA_CRYPT_SET_COMMS_PROTECTION_LEVEL(me, OPTIGA_COMMS_COMMAND_PROTECTION);
-        OPTIGA_CRYPT_SET_COMMS_PROTOCOL_VERSION(me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
+        (void)optiga_shell_policy_apply_crypt(me, "ecc_generate_keypair", (uint16_t)optiga_key_id);
         return_status = optiga_crypt_ecc_generate_keypair(me,
                                                           OPTIGA_ECC_CURVE_NIST_P_256,
                                                           (uint8_t)OPTIGA_KEY_USAGE_KEY_AGREEMENT,
@@ -149,7 +142,7 @@ void example_optiga_crypt_ecdh(void)
                                                           &optiga_key_id,
                                                           public_key,
                                                           &public_key_length);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
 
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -159,15 +152,14 @@ void example_optiga_crypt_ecdh(void)
          *       - Provide the peer public key details
          *       - Export the generated shared secret with protected I2C communication
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
-        OPTIGA_CRYPT_SET_COMMS_PROTECTION_LEVEL(me, OPTIGA_COMMS_COMMAND_PROTECTION);
-        OPTIGA_CRYPT_SET_COMMS_PROTOCOL_VERSION(me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
+        optiga_shell_request_start(&optiga_crypt_request);
+        (void)optiga_shell_policy_apply_crypt(me, "ecdh_export", (uint16_t)optiga_key_id);
         return_status = optiga_crypt_ecdh(me,
                                           optiga_key_id,
                                           &peer_public_key_details,
                                           TRUE,
                                           shared_secret);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -187,8 +179,8 @@ void example_optiga_crypt_ecdh(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -43,6 +43,8 @@
 
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
 
 #ifdef OPTIGA_CRYPT_ECDSA_SIGN_ENABLED
 
@@ -52,18 +54,9 @@ extern void example_optiga_deinit(void);
 #endif
 
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt instance, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
 /* SHA-256 Digest to be signed */
 static const uint8_t digest [] =
 {
@@ -105,7 +98,7 @@ void example_optiga_crypt_ecdsa_sign(void)
         /**
          * 1. Create OPTIGA Crypt Instance
          */
-        me = optiga_crypt_create(0, optiga_crypt_callback, NULL);
+        me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -116,7 +109,7 @@ void example_optiga_crypt_ecdsa_sign(void)
         /**
          * 2. Sign the digest using Private key from Key Store ID E0F0
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_ecdsa_sign(me,
                                                 digest,
                                                 sizeof(digest),
@@ -124,7 +117,7 @@ void example_optiga_crypt_ecdsa_sign(void)
                                                 signature,
                                                 &signature_length);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
                                                 
         READ_PERFORMANCE_MEASUREMENT(time_taken);
                                                 
@@ -144,8 +137,8 @@ void example_optiga_crypt_ecdsa_sign(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -44,6 +44,8 @@
 
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
 
 #ifdef OPTIGA_CRYPT_HASH_ENABLED
 
@@ -53,18 +55,9 @@ extern void example_optiga_deinit(void);
 #endif
 
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt instance, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
 
 /**
  * Prepare the hash context
@@ -115,7 +108,7 @@ void example_optiga_crypt_hash(void)
         /**
          * 1. Create OPTIGA Crypt Instance
          */
-        me = optiga_crypt_create(0, optiga_crypt_callback, NULL);
+        me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -128,7 +121,7 @@ void example_optiga_crypt_hash(void)
         OPTIGA_HASH_CONTEXT_INIT(hash_context,hash_context_buffer,  \
                                  sizeof(hash_context_buffer),(uint8_t)OPTIGA_HASH_TYPE_SHA_256);
 
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
 
         /**
          * 3. Initialize the hashing context at OPTIGA
@@ -136,7 +129,7 @@ void example_optiga_crypt_hash(void)
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
         return_status = optiga_crypt_hash_start(me, &hash_context);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
 
         /**
          * 4. Continue hashing the data
@@ -144,22 +137,22 @@ void example_optiga_crypt_hash(void)
         hash_data_host.buffer = data_to_hash;
         hash_data_host.length = sizeof(data_to_hash);
 
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_hash_update(me,
                                                  &hash_context,
                                                  OPTIGA_CRYPT_HOST_DATA,
                                                  &hash_data_host);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
 
         /**
          * 5. Finalize the hash
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_hash_finalize(me,
                                                    &hash_context,
                                                    digest);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -179,8 +172,8 @@ void example_optiga_crypt_hash(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -224,7 +217,7 @@ void example_optiga_crypt_hash_data(void)
         /**
          * 1. Create OPTIGA Crypt Instance
          */
-        me = optiga_crypt_create(0, optiga_crypt_callback, NULL);
+        me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -235,12 +228,12 @@ void example_optiga_crypt_hash_data(void)
          */
         hash_data_host.buffer = data_to_hash;
         hash_data_host.length = sizeof(data_to_hash);
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
         return_status = optiga_crypt_hash(me, OPTIGA_HASH_TYPE_SHA_256, OPTIGA_CRYPT_HOST_DATA, &hash_data_host, digest);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -260,8 +253,8 @@ void example_optiga_crypt_hash_data(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
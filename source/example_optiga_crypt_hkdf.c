@@ -42,6 +42,9 @@
 #include "optiga/optiga_crypt.h"
 #include "optiga/optiga_util.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_policy.h"
 
 #ifdef OPTIGA_CRYPT_HKDF_ENABLED
 
@@ -51,18 +54,10 @@ extern void example_optiga_deinit(void);
 #endif
 
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt and util instances, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_lib_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /*  callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
+static optiga_shell_request_t optiga_util_request;
 
 /**
  * Sample metadata
@@ -133,7 +128,7 @@ void example_optiga_crypt_hkdf(void)
 
         OPTIGA_EXAMPLE_LOG_MESSAGE(__FUNCTION__);
         
-        me_util = optiga_util_create(0, optiga_lib_callback, NULL);
+        me_util = optiga_shell_pool_get_util(&optiga_util_request);
         if (NULL == me_util)
         {
             break;
@@ -146,7 +141,8 @@ void example_optiga_crypt_hkdf(void)
          * 2. Use Erase and Write (OPTIGA_UTIL_ERASE_AND_WRITE) option,
          *    to clear the remaining data in the object
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
+        (void)optiga_shell_policy_apply_util(me_util, "write_data", 0xF1D0);
         return_status = optiga_util_write_data(me_util,
                                                0xF1D0,
                                                OPTIGA_UTIL_ERASE_AND_WRITE ,
@@ -154,26 +150,26 @@ void example_optiga_crypt_hkdf(void)
                                                secret_to_be_written,
                                                sizeof(secret_to_be_written));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
 
         /**
          * 2. Change data object type to PRESSEC
          *
          */
 
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_write_metadata(me_util,
                                                    0xF1D0,
                                                    metadata,
                                                    sizeof(metadata));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
 
         /**
          * 3. Create OPTIGA Crypt Instance
          *
          */
-        me = optiga_crypt_create(0, optiga_lib_callback, NULL);
+        me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -183,9 +179,8 @@ void example_optiga_crypt_hkdf(void)
          * 4. Derive key (e.g. decryption key) using optiga_crypt_hkdf with protected I2C communication.
          *       - Use shared secret from F1D0 data object
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
-        OPTIGA_CRYPT_SET_COMMS_PROTECTION_LEVEL(me, OPTIGA_COMMS_COMMAND_PROTECTION);
-        OPTIGA_CRYPT_SET_COMMS_PROTOCOL_VERSION(me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
+        optiga_shell_request_start(&optiga_crypt_request);
+        (void)optiga_shell_policy_apply_crypt(me, "hkdf_export", 0xF1D0);
 
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -200,7 +195,7 @@ void example_optiga_crypt_hkdf(void)
                                           TRUE,
                                           decryption_key);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -208,13 +203,13 @@ void example_optiga_crypt_hkdf(void)
          * 5. Change meta data to default value
          *
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_write_metadata(me_util,
                                                    0xF1D0,
                                                    default_metadata,
                                                    sizeof(default_metadata));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
         return_status = OPTIGA_LIB_SUCCESS;
 
     } while (FALSE);
@@ -231,8 +226,8 @@ void example_optiga_crypt_hkdf(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -242,8 +237,8 @@ void example_optiga_crypt_hkdf(void)
 
     if (me_util)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_util_destroy(me_util);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_util(me_util);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -44,6 +44,8 @@
 #include "optiga/optiga_util.h"
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
 
 #if defined OPTIGA_CRYPT_HMAC_ENABLED
 
@@ -53,23 +55,14 @@ extern void example_optiga_deinit(void);
 #endif
 
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt and util instances, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
+static optiga_shell_request_t optiga_crypt_request;
+static optiga_shell_request_t optiga_util_request;
 
 static optiga_lib_status_t write_input_secret_to_oid(void);
 static optiga_lib_status_t write_metadata(optiga_util_t * me);
 
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_util_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
-
 /* Write metadata */
 static optiga_lib_status_t write_metadata(optiga_util_t * me)
 {
@@ -77,12 +70,12 @@ static optiga_lib_status_t write_metadata(optiga_util_t * me)
     const uint8_t input_secret_oid_metadata[] = {0x20, 0x06, 0xD3, 0x01, 0x00, 0xE8, 0x01, 0x21};
     do
     {
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_write_metadata(me,
                                                    0xF1D0,
                                                    input_secret_oid_metadata,
                                                    sizeof(input_secret_oid_metadata));
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
     } while (FALSE);
 
     return(return_status);
@@ -99,7 +92,7 @@ static optiga_lib_status_t write_input_secret_to_oid()
                                     0x84,0xa4,0x28,0x3b};
     do
     {
-        me_util = optiga_util_create(0, optiga_util_crypt_callback, NULL);
+        me_util = optiga_shell_pool_get_util(&optiga_util_request);
         if (NULL == me_util)
         {
             break;
@@ -121,7 +114,7 @@ static optiga_lib_status_t write_input_secret_to_oid()
         *  Precondition 2 :
         *  Write secret in OID 0xF1D0
         */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_write_data(me_util,
                                                0xF1D0,
                                                OPTIGA_UTIL_ERASE_AND_WRITE,
@@ -129,12 +122,12 @@ static optiga_lib_status_t write_input_secret_to_oid()
                                                input_secret,
                                                sizeof(input_secret));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
     } while (FALSE);
     if(me_util)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_util_destroy(me_util);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_util(me_util);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -189,7 +182,7 @@ void example_optiga_crypt_hmac(void)
          * 1. Create OPTIGA Crypt Instance
          *
          */
-        me_crypt = optiga_crypt_create(0, optiga_util_crypt_callback, NULL);
+        me_crypt = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me_crypt)
         {
             break;
@@ -208,7 +201,7 @@ void example_optiga_crypt_hmac(void)
         /**
          * 3. Start HMAC operation 
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -218,28 +211,28 @@ void example_optiga_crypt_hmac(void)
                                                 input_data_buffer_start,
                                                 sizeof(input_data_buffer_start));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
 
         /**
          * 4. Continue HMAC operation on input data
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_hmac_update(me_crypt,
                                                  input_data_buffer_update,
                                                  sizeof(input_data_buffer_update));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         /**
          * 5. End HMAC sequence and return the MAC generated
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_hmac_finalize(me_crypt,
                                                    input_data_buffer_final,
                                                    sizeof(input_data_buffer_final),
                                                    mac_buffer,
                                                    &mac_buffer_length);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
                                                    
@@ -259,8 +252,8 @@ void example_optiga_crypt_hmac(void)
     
     if (me_crypt)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me_crypt);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me_crypt);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -42,6 +42,8 @@
 
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
 
 #ifdef OPTIGA_CRYPT_RANDOM_ENABLED
 
@@ -51,18 +53,9 @@ extern void example_optiga_deinit(void);
 #endif
 
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt instance, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
 
 /**
  * The below example demonstrates the generation of random using OPTIGA.
@@ -92,7 +85,7 @@ void example_optiga_crypt_random(void)
          * 1. Create OPTIGA Crypt Instance
          *
          */
-        me = optiga_crypt_create(0, optiga_crypt_callback, NULL);
+        me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -102,7 +95,7 @@ void example_optiga_crypt_random(void)
          * 2. Generate Random -
          * - Specify the Random type as TRNG
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY; 
+        optiga_shell_request_start(&optiga_crypt_request); 
         
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -111,7 +104,7 @@ void example_optiga_crypt_random(void)
                                             random_data_buffer,
                                             sizeof(random_data_buffer));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -131,8 +124,8 @@ void example_optiga_crypt_random(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
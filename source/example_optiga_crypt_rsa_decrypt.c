@@ -43,6 +43,9 @@
 
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_policy.h"
 
 #ifdef OPTIGA_CRYPT_RSA_DECRYPT_ENABLED
 
@@ -52,18 +55,9 @@ extern void example_optiga_deinit(void);
 #endif
 
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt instance, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
 
 /**
  * The below example demonstrates RSA decryption
@@ -104,7 +98,7 @@ void example_optiga_crypt_rsa_decrypt_and_export(void)
          * 1. Create OPTIGA Crypt Instance
          *
          */
-        me = optiga_crypt_create(0, optiga_crypt_callback, NULL);
+        me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -117,7 +111,7 @@ void example_optiga_crypt_rsa_decrypt_and_export(void)
          *       - Store the Private key in OPTIGA Key store
          *       - Export Public Key
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         optiga_key_id = OPTIGA_KEY_ID_E0FC;
         return_status = optiga_crypt_rsa_generate_keypair(me,
                                                           OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL,
@@ -126,7 +120,7 @@ void example_optiga_crypt_rsa_decrypt_and_export(void)
                                                           &optiga_key_id,
                                                           public_key,
                                                           &public_key_length);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         /**
          * 3. RSA encryption
          */
@@ -134,7 +128,7 @@ void example_optiga_crypt_rsa_decrypt_and_export(void)
         public_key_from_host.public_key = public_key;
         public_key_from_host.length = public_key_length;
         public_key_from_host.key_type = (uint8_t)OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL;
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
 
         return_status = optiga_crypt_rsa_encrypt_message(me,
                                                          encryption_scheme,
@@ -147,15 +141,14 @@ void example_optiga_crypt_rsa_decrypt_and_export(void)
                                                          encrypted_message,
                                                          &encrypted_message_length);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         /**
          * 4. RSA decryption
          */
-        /* OPTIGA Comms Shielded connection settings to enable the protection */
-        OPTIGA_CRYPT_SET_COMMS_PROTOCOL_VERSION(me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
-        OPTIGA_CRYPT_SET_COMMS_PROTECTION_LEVEL(me, OPTIGA_COMMS_RESPONSE_PROTECTION);
+        /* OPTIGA Comms Shielded connection protection of the policy table */
+        (void)optiga_shell_policy_apply_crypt(me, "rsa_decrypt_export", (uint16_t)optiga_key_id);
 
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         encryption_scheme = OPTIGA_RSAES_PKCS1_V15;
         
         START_PERFORMANCE_MEASUREMENT(time_taken);
@@ -170,7 +163,7 @@ void example_optiga_crypt_rsa_decrypt_and_export(void)
                                                             decrypted_message,
                                                             &decrypted_message_length);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
 
@@ -190,8 +183,8 @@ void example_optiga_crypt_rsa_decrypt_and_export(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -237,7 +230,7 @@ void example_optiga_crypt_rsa_decrypt_and_store(void)
          * 1. Create OPTIGA Crypt Instance
          *
          */
-        me = optiga_crypt_create(0, optiga_crypt_callback, NULL);
+        me = optiga_shell_pool_get_session_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -250,7 +243,7 @@ void example_optiga_crypt_rsa_decrypt_and_store(void)
          *       - Store the Private key in OPTIGA Key store
          *       - Export Public Key
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         optiga_key_id = OPTIGA_KEY_ID_E0FC;
         return_status = optiga_crypt_rsa_generate_keypair(me,
                                                           OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL,
@@ -259,27 +252,26 @@ void example_optiga_crypt_rsa_decrypt_and_store(void)
                                                           &optiga_key_id,
                                                           public_key,
                                                           &public_key_length);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         /**
          * 3. Generate 0x46 byte RSA Pre master secret which is stored in acquired session OID
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_rsa_generate_pre_master_secret(me,
                                                                     optional_data,
                                                                     sizeof(optional_data),
                                                                     30);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
 
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
 
         /**
          * 4. Encrypt(RSA) the data stored in session OID
          */
 
-        /* OPTIGA Comms Shielded connection settings to enable the protection */
-        OPTIGA_CRYPT_SET_COMMS_PROTOCOL_VERSION(me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
-        OPTIGA_CRYPT_SET_COMMS_PROTECTION_LEVEL(me, OPTIGA_COMMS_COMMAND_PROTECTION);
+        /* OPTIGA Comms Shielded connection protection of the policy table */
+        (void)optiga_shell_policy_apply_crypt(me, "rsa_encrypt_session", (uint16_t)optiga_key_id);
 
         encryption_scheme = OPTIGA_RSAES_PKCS1_V15;
         public_key_from_host.public_key = public_key;
@@ -295,11 +287,11 @@ void example_optiga_crypt_rsa_decrypt_and_store(void)
                                                          encrypted_message,
                                                          &encrypted_message_length);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         /**
          * 5. RSA decryption
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         encryption_scheme = OPTIGA_RSAES_PKCS1_V15;
         
         START_PERFORMANCE_MEASUREMENT(time_taken);
@@ -311,7 +303,7 @@ void example_optiga_crypt_rsa_decrypt_and_store(void)
                                                            NULL,
                                                            0,
                                                            optiga_key_id);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
 
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -331,8 +323,8 @@ void example_optiga_crypt_rsa_decrypt_and_store(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -42,6 +42,8 @@
 
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
 
 #ifdef OPTIGA_CRYPT_RSA_ENCRYPT_ENABLED
 
@@ -58,18 +60,9 @@ void example_util_encode_rsa_public_key_in_bit_string_format(const uint8_t * n_b
                                                         uint16_t * pub_key_length);
                                                         
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt instance, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
 
 /* RSA 1024 public key */
 static const uint8_t rsa_public_key_modulus [] = 
@@ -129,7 +122,7 @@ void example_optiga_crypt_rsa_encrypt_message(void)
          * 1. Create OPTIGA Crypt Instance
          *
          */
-        me = optiga_crypt_create(0, optiga_crypt_callback, NULL);
+        me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -150,7 +143,7 @@ void example_optiga_crypt_rsa_encrypt_message(void)
         public_key_from_host.public_key = rsa_public_key;
         public_key_from_host.length = rsa_public_key_length;
         public_key_from_host.key_type = (uint8_t)OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL;
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -165,7 +158,7 @@ void example_optiga_crypt_rsa_encrypt_message(void)
                                                             encrypted_message,
                                                             &encrypted_message_length);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -185,8 +178,8 @@ void example_optiga_crypt_rsa_encrypt_message(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
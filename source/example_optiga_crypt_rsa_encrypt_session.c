@@ -42,6 +42,9 @@
 
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_policy.h"
 
 #ifdef OPTIGA_CRYPT_RSA_ENCRYPT_ENABLED
 
@@ -51,18 +54,9 @@ extern void example_optiga_deinit(void);
 #endif
 
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt instance, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
 
 
 /**
@@ -103,7 +97,7 @@ void example_optiga_crypt_rsa_encrypt_session(void)
          * 1. Create OPTIGA Crypt Instance
          *
          */
-        me = optiga_crypt_create(0, optiga_crypt_callback, NULL);
+        me = optiga_shell_pool_get_session_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -112,7 +106,7 @@ void example_optiga_crypt_rsa_encrypt_session(void)
         /**
          * 2. Generate 1024 bit RSA Key pair
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         optiga_key_id = OPTIGA_KEY_ID_E0FC;
         OPTIGA_CRYPT_SET_COMMS_PROTECTION_LEVEL(me, OPTIGA_COMMS_NO_PROTECTION);
         return_status = optiga_crypt_rsa_generate_keypair(me,
@@ -122,33 +116,32 @@ void example_optiga_crypt_rsa_encrypt_session(void)
                                                           &optiga_key_id,
                                                           public_key,
                                                           &public_key_length);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
 
         /**
          * 3. Generate 48 byte RSA Pre master secret in acquired session OID
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_rsa_generate_pre_master_secret(me,
                                                                     optional_data,
                                                                     optional_data_length,
                                                                     48);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
 
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
 
         /**
          * 4. Encrypt (RSA) the data in session OID
          */
 
-        /* OPTIGA Comms Shielded connection settings to enable the protection */
-        OPTIGA_CRYPT_SET_COMMS_PROTOCOL_VERSION(me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
+        /* OPTIGA Comms Shielded connection protection of the policy table */
+        (void)optiga_shell_policy_apply_crypt(me, "rsa_encrypt_session", (uint16_t)optiga_key_id);
 
         encryption_scheme = OPTIGA_RSAES_PKCS1_V15;
         public_key_from_host.public_key = public_key;
         public_key_from_host.length = public_key_length;
         public_key_from_host.key_type = (uint8_t)OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL;
-        /* Default protection level for this API is OPTIGA_COMMS_COMMAND_PROTECTION */
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
         return_status = optiga_crypt_rsa_encrypt_session(me,
@@ -160,7 +153,7 @@ void example_optiga_crypt_rsa_encrypt_session(void)
                                                          encrypted_message,
                                                          &encrypted_message_length);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -180,8 +173,8 @@ void example_optiga_crypt_rsa_encrypt_session(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -49,6 +49,8 @@
 
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
 
 #if defined (OPTIGA_CRYPT_SYM_ENCRYPT_ENABLED) && defined (OPTIGA_CRYPT_SYM_DECRYPT_ENABLED)
 
@@ -59,18 +61,9 @@ extern void example_optiga_deinit(void);
 
 extern optiga_lib_status_t generate_symmetric_key(void);
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt instance, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_util_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
 
 /**
  * The below example demonstrates the symmetric encryption and decryption for CBC mode using OPTIGA.
@@ -131,7 +124,7 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_cbc(void)
          * 1. Create OPTIGA Crypt Instance
          *
          */
-        me = optiga_crypt_create(0, optiga_util_crypt_callback, NULL);
+        me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -151,7 +144,7 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_cbc(void)
         /**
          * 3. Start encryption sequence and encrypt the plain data 
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -168,7 +161,7 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_cbc(void)
                                                              encrypted_data_buffer_start,
                                                              &encrypted_data_length_start);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         if (encrypted_data_length_start != sizeof(plain_data_buffer_start))
         {
             /* Encrypted data length is incorrect */
@@ -178,14 +171,14 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_cbc(void)
         /**
          * 4. Continue encrypting the plain data 
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_symmetric_encrypt_continue(me,
                                                                 plain_data_buffer_continue,
                                                                 sizeof(plain_data_buffer_continue),
                                                                 encrypted_data_buffer_continue,
                                                                 &encrypted_data_length_continue);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         if (encrypted_data_length_continue != sizeof(plain_data_buffer_continue))
         {
             /* Encrypted data length is incorrect */
@@ -195,14 +188,14 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_cbc(void)
         /**
          * 5. End encryption sequence and encrypt plain data 
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_symmetric_encrypt_final(me,
                                                              plain_data_buffer_final,
                                                              sizeof(plain_data_buffer_final),
                                                              encrypted_data_buffer_final,
                                                              &encrypted_data_length_final);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         if (encrypted_data_length_final != sizeof(plain_data_buffer_final))
         {
             /* Encrypted data length is incorrect */
@@ -212,7 +205,7 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_cbc(void)
         /**
          * 6. Start decryption sequence and decrypt the encrypted data from step 3
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_symmetric_decrypt_start(me,
                                                              OPTIGA_SYMMETRIC_CBC,
                                                              OPTIGA_KEY_ID_SECRET_BASED,
@@ -226,7 +219,7 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_cbc(void)
                                                              decrypted_data_buffer_start,
                                                              &decrypted_data_length_start);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         /* Compare the decrypted data with plain data */
         if( OPTIGA_LIB_SUCCESS != memcmp(plain_data_buffer_start, decrypted_data_buffer_start, decrypted_data_length_start))
         {
@@ -242,14 +235,14 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_cbc(void)
         /**
          * 7. Continue to decrypt the encrypted data from step 4
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_symmetric_decrypt_continue(me,
                                                                 encrypted_data_buffer_continue,
                                                                 encrypted_data_length_continue,
                                                                 decrypted_data_buffer_continue,
                                                                 &decrypted_data_length_continue);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         /* Compare the decrypted data with plain data */
         if( OPTIGA_LIB_SUCCESS != memcmp(plain_data_buffer_continue, decrypted_data_buffer_continue, decrypted_data_length_continue))
         {
@@ -265,14 +258,14 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_cbc(void)
         /**
          * 8. End decryption sequence and decrypt encrypted data from step 5
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_symmetric_decrypt_final(me,
                                                              encrypted_data_buffer_final,
                                                              encrypted_data_length_final,
                                                              decrypted_data_buffer_final,
                                                              &decrypted_data_length_final);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -305,8 +298,8 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_cbc(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -351,7 +344,7 @@ void example_optiga_crypt_symmetric_encrypt_cbcmac(void)
          * 1. Create OPTIGA Crypt Instance
          *
          */
-        me = optiga_crypt_create(0, optiga_util_crypt_callback, NULL);
+        me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -371,7 +364,7 @@ void example_optiga_crypt_symmetric_encrypt_cbcmac(void)
         /**
          * 3. Encrypt the plain data
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -387,7 +380,7 @@ void example_optiga_crypt_symmetric_encrypt_cbcmac(void)
                                                        encrypted_data_buffer,
                                                        &encrypted_data_length);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
        
         READ_PERFORMANCE_MEASUREMENT(time_taken);
        
@@ -414,8 +407,8 @@ void example_optiga_crypt_symmetric_encrypt_cbcmac(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
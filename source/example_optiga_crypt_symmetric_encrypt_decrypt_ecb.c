@@ -43,6 +43,8 @@
 
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
 
 #if defined (OPTIGA_CRYPT_SYM_ENCRYPT_ENABLED) && defined (OPTIGA_CRYPT_SYM_DECRYPT_ENABLED)
 
@@ -54,18 +56,9 @@ extern void example_optiga_deinit(void);
 extern optiga_lib_status_t generate_symmetric_key(void);
 
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt instance, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_util_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
 
 /**
  * The below example demonstrates the symmetric encryption and decryption for ECB mode using OPTIGA.
@@ -104,7 +97,7 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_ecb(void)
          * 1. Create OPTIGA Crypt Instance
          *
          */
-        me = optiga_crypt_create(0, optiga_util_crypt_callback, NULL);
+        me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me)
         {
             break;
@@ -124,7 +117,7 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_ecb(void)
         /**
          * 3. Encrypt the plain data
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         
         START_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -135,7 +128,7 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_ecb(void)
                                                            encrypted_data_buffer,
                                                            &encrypted_data_length);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         if (encrypted_data_length != plain_data_length)
         {
             /* Encrypted data length is incorrect */
@@ -146,7 +139,7 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_ecb(void)
         /**
          * 4. Decrypt the encrypted data from step 3
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_symmetric_decrypt_ecb(me,
                                                            OPTIGA_KEY_ID_SECRET_BASED,
                                                            encrypted_data_buffer,
@@ -154,7 +147,7 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_ecb(void)
                                                            decrypted_data_buffer,
                                                            &decrypted_data_length);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -186,8 +179,8 @@ void example_optiga_crypt_symmetric_encrypt_decrypt_ecb(void)
     
     if (me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -43,6 +43,8 @@
 #include "optiga/optiga_util.h"
 #include "optiga/optiga_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
 
 #ifdef OPTIGA_CRYPT_SYM_GENERATE_KEY_ENABLED
 
@@ -60,28 +62,10 @@ extern optiga_lib_status_t example_check_tag_in_metadata(const uint8_t * buffer,
                                                          bool_t * tag_available);
 
 /**
- * Callback when optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt and util instances, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_crypt_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
-
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_util_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
+static optiga_shell_request_t optiga_util_request;
 
 /**
  * Sample metadata of 0xE200 
@@ -108,13 +92,13 @@ optiga_lib_status_t generate_symmetric_key(void)
        /**
          * 1. Create OPTIGA Crypt Instance
          */
-        crypt_me = optiga_crypt_create(0, optiga_crypt_callback, NULL);
+        crypt_me = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == crypt_me)
         {
             break;
         }
 
-        util_me = optiga_util_create(0, optiga_util_callback, NULL);
+        util_me = optiga_shell_pool_get_util(&optiga_util_request);
         if (NULL == util_me)
         {
             break;
@@ -126,13 +110,13 @@ optiga_lib_status_t generate_symmetric_key(void)
          */
         optiga_oid = 0xE200;
         bytes_to_read = sizeof(read_data_buffer);
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_read_metadata(util_me,
                                                   optiga_oid,
                                                   read_data_buffer,
                                                   &bytes_to_read);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
         
         return_status = example_check_tag_in_metadata(read_data_buffer,
                                                       bytes_to_read,
@@ -144,14 +128,14 @@ optiga_lib_status_t generate_symmetric_key(void)
             break;
         }
         
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         optiga_oid = 0xE200;
         return_status = optiga_util_write_metadata(util_me,
                                                    optiga_oid,
                                                    E200_metadata,
                                                    sizeof(E200_metadata));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
         
         /**
          * 2. Generate symmetric key
@@ -159,7 +143,7 @@ optiga_lib_status_t generate_symmetric_key(void)
          *       - OPTIGA_KEY_USAGE_ENCRYPTION as a Key Usage
          *       - Store the Symmetric key in OPTIGA Key store OID(E200)
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         symmetric_key = OPTIGA_KEY_ID_SECRET_BASED;
         
         START_PERFORMANCE_MEASUREMENT(time_taken_to_generate_key);
@@ -169,7 +153,7 @@ optiga_lib_status_t generate_symmetric_key(void)
                                                             (uint8_t)OPTIGA_KEY_USAGE_ENCRYPTION,
                                                             FALSE,
                                                             &symmetric_key);
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken_to_generate_key);
         
@@ -179,8 +163,8 @@ optiga_lib_status_t generate_symmetric_key(void)
 
     if (crypt_me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(crypt_me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(crypt_me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -189,8 +173,8 @@ optiga_lib_status_t generate_symmetric_key(void)
     }
     if (util_me)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_util_destroy(util_me);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_util(util_me);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
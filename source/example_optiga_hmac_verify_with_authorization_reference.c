@@ -47,6 +47,8 @@
 #include "optiga/pal/pal_os_memory.h"
 #include "optiga/pal/pal_crypt.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
 #include "mbedtls/ccm.h"
 #include "mbedtls/md.h"
 #include "mbedtls/ssl.h"
@@ -144,18 +146,10 @@ uint8_t input_data_buffer[64] = {0x00};
 uint8_t hmac_buffer[32] = {0x00};
 
 /**
- * Callback when optiga_util_xxxx/optiga_crypt_xxxx operation is completed asynchronously
+ * Completion contexts of the crypt and util instances, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_lib_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_crypt_request;
+static optiga_shell_request_t optiga_util_request;
 
 /* lint --e{818, 715, 830} suppress "argument "p_pal_crypt" is not used in the implementation but kept for future use" */
 /**
@@ -243,18 +237,18 @@ static pal_status_t GetAutoValue(optiga_util_t * me_util, uint16_t secret_oid)
         /**
          * 1. Set the metadata of secret OID(0xF1D0) using optiga_util_write_metadata.
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_write_metadata(me_util,
                                                    secret_oid,
                                                    secret_oid_metadata,
                                                    sizeof(secret_oid_metadata));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
 
         /**
         *  2. Write shared secret in OID 0xF1D0
         */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_write_data(me_util,
                                                secret_oid,
                                                OPTIGA_UTIL_ERASE_AND_WRITE,
@@ -262,7 +256,7 @@ static pal_status_t GetAutoValue(optiga_util_t * me_util, uint16_t secret_oid)
                                                user_secret,
                                                sizeof(user_secret));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
     } while(FALSE);
     
     return return_status;
@@ -296,13 +290,13 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
         /**
          * Create OPTIGA util and crypt Instances
          */
-        me_util = optiga_util_create(0, optiga_lib_callback, NULL);
+        me_util = optiga_shell_pool_get_util(&optiga_util_request);
         if (NULL == me_util)
         {
             break;
         }
 
-        me_crypt = optiga_crypt_create(0, optiga_lib_callback, NULL);
+        me_crypt = optiga_shell_pool_get_crypt(&optiga_crypt_request);
         if (NULL == me_crypt)
         {
             break;
@@ -332,7 +326,7 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
         /**
          * Set the data to 0xF1E0.
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_write_data(me_util,
                                                0xF1E0,
                                                OPTIGA_UTIL_ERASE_AND_WRITE,
@@ -340,18 +334,18 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
                                                read_oid_data,
                                                sizeof(read_oid_data));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
         
         /**
          * Set the metadata of 0xF1E0 to Auto with 0xF1D0.
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_write_metadata(me_util,
                                                    0xF1E0,
                                                    arbitrary_oid_metadata,
                                                    sizeof(arbitrary_oid_metadata));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
         
         /**
          * Read data from a data object using optiga_util_read_data.
@@ -359,7 +353,7 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
          */
         offset = 0x00;
         bytes_to_read = sizeof(read_data_buffer);        
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_read_data(me_util,
                                               0xF1E0,
                                               offset,
@@ -371,12 +365,8 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
             break;
         }
 
-        while (OPTIGA_LIB_BUSY == optiga_lib_status)
-        {
-            /* Wait until the optiga_util_read_data operation is completed */
-        }
-
-        if ((OPTIGA_LIB_SUCCESS == optiga_lib_status) && (0 != bytes_to_read))
+        /* Wait until the optiga_util_read_data operation is completed */
+        if ((OPTIGA_LIB_SUCCESS == optiga_shell_request_wait(&optiga_util_request)) && (0 != bytes_to_read))
         {
             /* Reading successed */
             return_status = !OPTIGA_LIB_SUCCESS;
@@ -386,7 +376,7 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
         /**
          * Generate authorization code with optional data
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_generate_auth_code(me_crypt,
                                                         OPTIGA_RNG_TYPE_TRNG,
                                                         optional_data,
@@ -394,7 +384,7 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
                                                         random_data,
                                                         sizeof(random_data));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
 
         /**
          * Calculate HMAC on host
@@ -420,7 +410,7 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
         /**
          * Perform HMAC verification using OPTIGA
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_crypt_request);
         return_status = optiga_crypt_hmac_verify(me_crypt,
                                                  OPTIGA_HMAC_SHA_256,
                                                  0xF1D0,
@@ -428,7 +418,7 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
                                                  sizeof(input_data_buffer),
                                                  hmac_buffer,
                                                  sizeof(hmac_buffer));
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_crypt_request);
 
         /**
         * PostCondition : Read data from a data object using optiga_util_read_data.
@@ -437,25 +427,25 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
         offset = 0x00;
         bytes_to_read = sizeof(read_data_buffer);        
         
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_read_data(me_util,
                                               0xF1E0,
                                               offset,
                                               read_data_buffer,
                                               &bytes_to_read);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
         
         /**
          * Reset the metadata of 0xF1E0 to default.
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         return_status = optiga_util_write_metadata(me_util,
                                                    0xF1E0,
                                                    arbitrary_oid_metadata_default,
                                                    sizeof(arbitrary_oid_metadata_default));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken);
         
@@ -475,8 +465,8 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
     
     if(me_util)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_util_destroy(me_util);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_util(me_util);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
@@ -485,8 +475,8 @@ void example_optiga_hmac_verify_with_authorization_reference(void)
     }
     if(me_crypt)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me_crypt);
+        /* Return the instance to the pool after the completion of usecase. */
+        return_status = optiga_shell_pool_put_crypt(me_crypt);
         if(OPTIGA_LIB_SUCCESS != return_status)
         {
             /* lint --e{774} suppress This is a generic macro */
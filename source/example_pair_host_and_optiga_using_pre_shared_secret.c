@@ -45,6 +45,9 @@
 
 #include "optiga/pal/pal_os_datastore.h"
 #include "optiga_example.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_random.h"
 #ifdef OPTIGA_COMMS_SHIELDED_CONNECTION 
 
 #ifndef OPTIGA_INIT_DEINIT_DONE_EXCLUSIVELY
@@ -75,18 +78,9 @@ const uint8_t platform_binding_shared_secret_metadata_final [] = {
 };
 
 /**
- * Callback when optiga_util_xxxx/optiga_crypt_xxxx operation is completed asynchronously
+ * Completion context of the util instance, see optiga_shell_request.h
  */
-static volatile optiga_lib_status_t optiga_lib_status;
-/* lint --e{818} suppress "argument "context" is not used in the sample provided" */
-static void optiga_lib_callback(void * context, optiga_lib_status_t return_status)
-{
-    optiga_lib_status = return_status;
-    if (NULL != context)
-    {
-        /* callback to upper layer here */
-    }
-}
+static optiga_shell_request_t optiga_util_request;
 
 optiga_lib_status_t pair_host_and_optiga_using_pre_shared_secret(void)
 {
@@ -94,42 +88,33 @@ optiga_lib_status_t pair_host_and_optiga_using_pre_shared_secret(void)
     uint8_t platform_binding_secret[64];
     uint8_t platform_binding_secret_metadata[44];
     optiga_lib_status_t return_status = !OPTIGA_LIB_SUCCESS;
+    optiga_lib_status_t put_status;
     pal_status_t pal_return_status;
     optiga_util_t * me_util = NULL;
-    optiga_crypt_t * me_crypt = NULL;
 
     do
     {
         /**
-         * 1. Create OPTIGA Util and Crypt Instances
+         * 1. Create OPTIGA Util Instance
          */
-        me_util = optiga_util_create(0, optiga_lib_callback, NULL);
+        me_util = optiga_shell_pool_get_util(&optiga_util_request);
         if (NULL == me_util)
         {
             break;
         }
 
-        me_crypt = optiga_crypt_create(0, optiga_lib_callback, NULL);
-        if (NULL == me_crypt)
-        {
-            break;
-        }
-
         /**
-         * 2. Initialize the protection level and protocol version for the instances
+         * 2. Initialize the protection level and protocol version for the instance
          */
         OPTIGA_UTIL_SET_COMMS_PROTECTION_LEVEL(me_util,OPTIGA_COMMS_NO_PROTECTION);
         OPTIGA_UTIL_SET_COMMS_PROTOCOL_VERSION(me_util,OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
 
-        OPTIGA_CRYPT_SET_COMMS_PROTECTION_LEVEL(me_crypt,OPTIGA_COMMS_NO_PROTECTION);
-        OPTIGA_CRYPT_SET_COMMS_PROTOCOL_VERSION(me_crypt,OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
-
         /**
          * 3. Read Platform Binding Shared secret (0xE140) data object metadata from OPTIGA
          *    using optiga_util_read_metadata.
          */
         bytes_to_read = sizeof(platform_binding_secret_metadata);
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         
         START_PERFORMANCE_MEASUREMENT(time_taken_for_pairing);
         
@@ -138,7 +123,7 @@ optiga_lib_status_t pair_host_and_optiga_using_pre_shared_secret(void)
                                                   platform_binding_secret_metadata,
                                                   &bytes_to_read);
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
 
         /**
          * 4. Validate LcsO in the metadata.
@@ -151,21 +136,23 @@ optiga_lib_status_t pair_host_and_optiga_using_pre_shared_secret(void)
         }
 
         /**
-         * 5. Generate Random using optiga_crypt_random
-         *       - Specify the Random type as TRNG
+         * 5. Generate Random using the TRNG of OPTIGA
          *    a. The maximum supported size of secret is 64 bytes.
          *       The minimum recommended is 32 bytes.
          *    b. If the host platform doesn't support random generation,
          *       use OPTIGA to generate the maximum size chosen.
          *       else choose the appropriate length of random to be generated by OPTIGA
+         *    c. The bytes are taken from the TRNG output prefetched by the shell, see
+         *       optiga_shell_random.h, a command is only sent if the pool is empty
          *
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
-        return_status = optiga_crypt_random(me_crypt,
-                                            OPTIGA_RNG_TYPE_TRNG,
-                                            platform_binding_secret,
-                                            sizeof(platform_binding_secret));
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        return_status = optiga_shell_random_get(OPTIGA_SHELL_RANDOM_SOURCE_POOL,
+                                                platform_binding_secret,
+                                                sizeof(platform_binding_secret));
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
 
         /**
          * 6. Generate random on Host
@@ -176,7 +163,7 @@ optiga_lib_status_t pair_host_and_optiga_using_pre_shared_secret(void)
         /**
          * 7. Write random(secret) to OPTIGA platform Binding shared secret data object (0xE140)
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         OPTIGA_UTIL_SET_COMMS_PROTECTION_LEVEL(me_util,OPTIGA_COMMS_NO_PROTECTION);
         return_status = optiga_util_write_data(me_util,
                                                0xE140,
@@ -184,7 +171,7 @@ optiga_lib_status_t pair_host_and_optiga_using_pre_shared_secret(void)
                                                0,
                                                platform_binding_secret,
                                                sizeof(platform_binding_secret));
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
 
         /**
          * 8. Write/store the random(secret) on the Host platform
@@ -197,7 +184,7 @@ optiga_lib_status_t pair_host_and_optiga_using_pre_shared_secret(void)
         if (PAL_STATUS_SUCCESS != pal_return_status)
         {
             /* Storing of Pre-shared secret on Host failed. */
-            optiga_lib_status = pal_return_status;
+            return_status = pal_return_status;
             break;
         }
 
@@ -206,14 +193,14 @@ optiga_lib_status_t pair_host_and_optiga_using_pre_shared_secret(void)
         /**
          * 9. Update metadata of OPTIGA Platform Binding shared secret data object (0xE140)
          */
-        optiga_lib_status = OPTIGA_LIB_BUSY;
+        optiga_shell_request_start(&optiga_util_request);
         OPTIGA_UTIL_SET_COMMS_PROTECTION_LEVEL(me_util,OPTIGA_COMMS_NO_PROTECTION);
         return_status = optiga_util_write_metadata(me_util,
                                                    0xE140,
                                                    platform_binding_shared_secret_metadata_final,
                                                    sizeof(platform_binding_shared_secret_metadata_final));
 
-        WAIT_AND_CHECK_STATUS(return_status, optiga_lib_status);
+        OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, optiga_util_request);
         
         READ_PERFORMANCE_MEASUREMENT(time_taken_for_pairing);
         
@@ -224,22 +211,12 @@ optiga_lib_status_t pair_host_and_optiga_using_pre_shared_secret(void)
     
     if(me_util)
     {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_util_destroy(me_util);
-        if(OPTIGA_LIB_SUCCESS != return_status)
-        {
-            /* lint --e{774} suppress This is a generic macro */
-            OPTIGA_EXAMPLE_LOG_STATUS(return_status);
-        }
-    }
-    if(me_crypt)
-    {
-        /* Destroy the instance after the completion of usecase if not required. */
-        return_status = optiga_crypt_destroy(me_crypt);
-        if(OPTIGA_LIB_SUCCESS != return_status)
+        /* Return the instance to the pool after the completion of usecase. */
+        put_status = optiga_shell_pool_put_util(me_util);
+        if(OPTIGA_LIB_SUCCESS != put_status)
         {
             /* lint --e{774} suppress This is a generic macro */
-            OPTIGA_EXAMPLE_LOG_STATUS(return_status);
+            OPTIGA_EXAMPLE_LOG_STATUS(put_status);
         }
     }
     return return_status;
@@ -44,7 +44,9 @@
 #ifndef _OPTIGA_LIB_CONFIG_M_V3_H_
 #define _OPTIGA_LIB_CONFIG_M_V3_H_
 
+#ifndef OPTIGA_HOST_SIMULATOR
 #include "cybsp.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -160,6 +162,7 @@ extern "C" {
     #define EXAMPLE_OPTIGA_UTIL_PROTECTED_UPDATE_OBJECT_METADATA_ENABLED    
     
 
+#ifndef OPTIGA_HOST_SIMULATOR
     /* The following GPIO settings are only ModusToolbox and specific PSoC6 family board relevant
      * If you don't have both the Reset and the VCC Power Control connected, please define
      * OPTIGA_COMMS_DEFAULT_RESET_TYPE to be 1
@@ -174,6 +177,7 @@ extern "C" {
 #ifdef CYBSP_TRUSTM_VDD
     #define OPTIGA_TRUSTM_VDD        CYBSP_TRUSTM_VDD
 #endif
+#endif /* OPTIGA_HOST_SIMULATOR */
 
 #ifdef __cplusplus
 }
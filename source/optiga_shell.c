@@ -40,6 +40,9 @@
 
 
 
+#include <stdio.h>
+#include <string.h>
+
 #include "optiga/optiga_crypt.h"
 #include "optiga/optiga_util.h"
 #include "optiga/common/optiga_lib_logger.h"
@@ -49,9 +52,32 @@
 #include "optiga_example.h"
 #include "optiga/pal/pal_logger.h"
 #include "optiga/pal/pal_gpio.h"
+#include "optiga_shell_uart.h"
+#include "optiga_shell_rpc.h"
+#include "optiga_shell_cmds.h"
+#include "optiga_shell_bench.h"
+#include "optiga_shell_pipeline.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_pairing.h"
+#include "optiga_shell_session.h"
+#include "optiga_shell_policy.h"
+#include "optiga_shell_profile.h"
+#include "optiga_shell_hashstream.h"
+#include "optiga_shell_hybrid.h"
+#include "optiga_shell_hashmux.h"
+#include "optiga_shell_batch.h"
+#include "optiga_shell_verify.h"
+#include "optiga_shell_random.h"
+#include "optiga_shell_cbc.h"
+#include "optiga_shell_envelope.h"
 
 #define OPTIGA_SHELL		"optiga --"
 #define OPTIGA_SHELL_MODULE "[optiga shell]  : "
+/* Longest command line including its arguments, e.g. hex encoded data to write */
+#define OPTIGA_SHELL_MAX_LINE_LENGTH	(1280U)
+/* Longest wait for the \n of a \r\n line end, terminals send both together */
+#define OPTIGA_SHELL_LINE_FEED_WAIT_MS	(5U)
 #define OPTIGA_SHELL_LOG_MESSAGE(msg) \
 	optiga_lib_print_message(msg, OPTIGA_SHELL_MODULE, OPTIGA_LIB_LOGGER_COLOR_LIGHT_GREEN);
 
@@ -88,78 +114,65 @@ void example_optiga_crypt_clear_auto_state(void);
 
 extern pal_logger_t logger_console;
 
-/**
- * Copy of pal_logger_read with modified format specifier in sprintf to support capture of \n and \r
- */
-static pal_status_t optiga_shell_pal_logger_read(void * p_logger_context, uint8_t * p_log_data, uint32_t log_data_length)
-{
-    char str[4] = "%";
-    char str_1[4];
-    sprintf(str_1, "%dc", (int)log_data_length);
-    strcat(str, str_1);
-    scanf(str, p_log_data);
-
-    return PAL_STATUS_SUCCESS;
-}
-
-/**
- * Callback when optiga_util_xxxx operation is completed asynchronously
- */
-static volatile optiga_lib_status_t optiga_lib_status;
-static void optiga_util_callback(void * context, optiga_lib_status_t return_status)
-{
-	optiga_lib_status = return_status;
-}
-
-optiga_util_t * me_util = NULL;
-
 typedef struct optiga_example_cmd
 {
 	const char_t * cmd_description;
 	const char_t * cmd_options;
+	/** Runs the example of the command, NULL if it has none and runs its argument handler instead */
 	void (*cmd_handler)();
+	/** Runs the command with arguments, NULL if the command takes none */
+	void (*cmd_args_handler)(optiga_shell_args_t * p_args);
+	const char_t * cmd_args_usage;
+	/** How the command uses the application on OPTIGA, see optiga_shell_session.h */
+	uint8_t cmd_session;
 }optiga_example_cmd_t;
 
+/** The application is opened (or restored) before the command runs */
+#define OPTIGA_SHELL_CMD_SESSION			(0U)
+/** The command does not need the application, e.g. help */
+#define OPTIGA_SHELL_CMD_NO_SESSION			(1U)
+/** The command opens and closes the application on its own */
+#define OPTIGA_SHELL_CMD_OWN_SESSION		(2U)
+
+static void optiga_shell_print_pairing(const optiga_shell_pairing_report_t * p_report)
+{
+	char_t line[120];
+
+	if (OPTIGA_SHELL_PAIRING_VERIFIED == p_report->result)
+	{
+		snprintf(line, sizeof(line), "Pairing record verified in %lu usec, pairing of %lu usec skipped",
+				 (unsigned long)p_report->verify_us, (unsigned long)p_report->pairing_us);
+	}
+	else if (OPTIGA_SHELL_PAIRING_PAIRED == p_report->result)
+	{
+		snprintf(line, sizeof(line), "Paired in %lu usec, %s",
+				 (unsigned long)p_report->pairing_us,
+				 (PAL_STATUS_SUCCESS == p_report->record_status) ? "recorded for the next boot" :
+				 "record not written, the next boot pairs again");
+	}
+	else
+	{
+		return;
+	}
+	OPTIGA_SHELL_LOG_MESSAGE(line);
+}
+
 static void optiga_shell_init()
 {
 	optiga_lib_status_t return_status = !OPTIGA_LIB_SUCCESS;
-	uint16_t optiga_oid = 0xE0C4;
-	uint8_t required_current = 15;
+	optiga_shell_pairing_report_t pairing_report;
 
 	do
 	{
-        if (NULL == me_util)
-        {
-            /*
-             * Create an instance of optiga_util to open the application on OPTIGA.
-             */
-            me_util = optiga_util_create(0, optiga_util_callback, NULL);
-            if (NULL == me_util)
-            {
-                break;
-            }
-        }
 		OPTIGA_EXAMPLE_LOG_MESSAGE("Initializing OPTIGA for example demonstration...\n");
+		optiga_shell_pairing_load_secret();
 		/**
-		 * Open the application on OPTIGA which is a precondition to perform any other operations
-		 * using optiga_util_open_application
+		 * Open the application on OPTIGA which is a precondition to perform any other operations.
+		 * It stays open across commands, see optiga_shell_session.h
 		 */
-		optiga_lib_status = OPTIGA_LIB_BUSY;
-		return_status = optiga_util_open_application(me_util, 0);
-
+		return_status = optiga_shell_session_acquire();
 		if (OPTIGA_LIB_SUCCESS != return_status)
-		{
-			break;
-		}
-		while (optiga_lib_status == OPTIGA_LIB_BUSY)
 		{
-			/*
-			 * Wait until the optiga_util_open_application is completed
-			 */
-		}
-		if (OPTIGA_LIB_SUCCESS != optiga_lib_status)
-		{
-			return_status = optiga_lib_status;
 			/*
 			 * optiga util open application failed
 			 */
@@ -167,42 +180,37 @@ static void optiga_shell_init()
 		}
 
 		OPTIGA_SHELL_LOG_MESSAGE("Initializing OPTIGA completed...\n\n");
-		OPTIGA_SHELL_LOG_MESSAGE("Begin pairing of host and OPTIGA...");
 		/*
-		 * Usercase: Generate the pre-shared secret on host and write it to OPTIGA
+		 * Usercase: Generate the pre-shared secret on host and write it to OPTIGA,
+		 * skipped if the pairing record of an earlier boot still matches or the
+		 * shielded connection was restored with the hibernated application
 		 */
-		example_pair_host_and_optiga_using_pre_shared_secret();
-		OPTIGA_SHELL_LOG_MESSAGE("Pairing of host and OPTIGA completed...");
+		if (TRUE == optiga_shell_session_is_resumed())
+		{
+			OPTIGA_SHELL_LOG_MESSAGE("Application restored from hibernate on boot, pairing not needed");
+		}
+		else
+		{
+			OPTIGA_SHELL_LOG_MESSAGE("Begin pairing of host and OPTIGA...");
+			return_status = optiga_shell_pairing_ensure(&pairing_report);
+			if (OPTIGA_LIB_SUCCESS != return_status)
+			{
+				break;
+			}
+			optiga_shell_print_pairing(&pairing_report);
+			OPTIGA_SHELL_LOG_MESSAGE("Pairing of host and OPTIGA completed...");
+		}
 
 		/*
-		 * Setting current limitation to maximum supported value(15)
+		 * Setting current limitation and I2C clock of the boot profile, see optiga_shell_profile.h
 		 */
-
-		optiga_lib_status = OPTIGA_LIB_BUSY;
-        return_status = optiga_util_write_data(me_util,
-                                               optiga_oid,
-                                               OPTIGA_UTIL_ERASE_AND_WRITE,
-                                               0, &required_current,
-                                               1);
-
-        if (OPTIGA_LIB_SUCCESS != return_status)
-        {
-            break;
-        }
-
-        while (OPTIGA_LIB_BUSY == optiga_lib_status)
-        {
-            /*
-             * Wait until the optiga_util_write_data operation is completed
-             */
-        }
-        if (OPTIGA_LIB_SUCCESS != optiga_lib_status)
-        {
-            return_status = optiga_lib_status;
-            break;
-        }
-        OPTIGA_SHELL_LOG_MESSAGE("Setting current limitation to maximum...");
-        OPTIGA_SHELL_LOG_MESSAGE("Starting OPTIGA example demonstration..\n");
+		return_status = optiga_shell_profile_apply(OPTIGA_SHELL_PROFILE_BOOT);
+		if (OPTIGA_LIB_SUCCESS != return_status)
+		{
+			break;
+		}
+		OPTIGA_SHELL_LOG_MESSAGE("Setting current limitation and I2C clock of the boot profile...");
+		OPTIGA_SHELL_LOG_MESSAGE("Starting OPTIGA example demonstration..\n");
 	}while(FALSE);
 
 	OPTIGA_EXAMPLE_LOG_STATUS(return_status);
@@ -211,47 +219,21 @@ static void optiga_shell_init()
 static void optiga_shell_deinit()
 {
 	optiga_lib_status_t return_status;
-	do
-	{
-		OPTIGA_SHELL_LOG_MESSAGE("Deinitializing OPTIGA for example demonstration...");
-		/**
-		 * Close the application on OPTIGA after all the operations are executed
-		 * using optiga_util_close_application
-		 */
-
-		optiga_lib_status = OPTIGA_LIB_BUSY;
-		return_status = optiga_util_close_application(me_util, 0);
-
-		if (OPTIGA_LIB_SUCCESS != return_status)
-		{
-			break;
-		}
-
-		while (optiga_lib_status == OPTIGA_LIB_BUSY)
-		{
-			/*
-			 * Wait until the optiga_util_close_application is completed
-			 */
-		}
-
-		if (OPTIGA_LIB_SUCCESS != optiga_lib_status)
-		{
-			/*
-			 * optiga util close application failed
-			 */
-			OPTIGA_SHELL_LOG_MESSAGE("OPTIGA util close application failed\n");
-			break;
-		}
 
+	OPTIGA_SHELL_LOG_MESSAGE("Deinitializing OPTIGA for example demonstration...");
+	/**
+	 * Close the application on OPTIGA, the next command opens it again
+	 */
+	return_status = optiga_shell_session_close();
+	if (OPTIGA_LIB_SUCCESS != return_status)
+	{
 		/*
-		 * destroy util and crypt instances if no re-initialisation of optiga trust m is required
-		 * optiga_util_destroy(me_util);
-		 * me_util = NULL;
+		 * optiga util close application failed
 		 */
+		OPTIGA_SHELL_LOG_MESSAGE("OPTIGA util close application failed\n");
+	}
 
-	}while(FALSE);
-
-	OPTIGA_EXAMPLE_LOG_STATUS(optiga_lib_status);
+	OPTIGA_EXAMPLE_LOG_STATUS(return_status);
 	OPTIGA_SHELL_LOG_MESSAGE("Deinitializing OPTIGA completed");
 }
 
@@ -309,7 +291,7 @@ static void optiga_shell_util_hibernate_restore()
 	OPTIGA_SHELL_LOG_MESSAGE("8 Step: Sign prepared data with private key stored in Session Data Object");
 	OPTIGA_SHELL_LOG_MESSAGE("9 Step: Verify the signature with the public key generated previously");
 	OPTIGA_SHELL_LOG_MESSAGE("10 Step: Close Applicaiton on the chip");
-	OPTIGA_SHELL_LOG_MESSAGE("Important note: To continue with other examples you need to call the init parameter once again");
+	OPTIGA_SHELL_LOG_MESSAGE("Note: The shell opens the application again for the next command");
 	example_optiga_util_hibernate_restore();
 }
 static void optiga_shell_util_update_count()
@@ -565,45 +547,111 @@ static void optiga_shell_show_usage();
 
 optiga_example_cmd_t optiga_cmds [] =
 {
-		{"",                                        	    "help",				optiga_shell_show_usage},
-		{"    initialize optiga                        : "OPTIGA_SHELL,"init",			optiga_shell_init},
-		{"    de-initialize optiga                     : "OPTIGA_SHELL,"deinit",		optiga_shell_deinit},
-		{"    run all tests at once                    : "OPTIGA_SHELL,"selftest",		optiga_shell_selftest},
-		{"    read data                                : "OPTIGA_SHELL,"readdata",		optiga_shell_util_read_data},
-		{"    write data                               : "OPTIGA_SHELL,"writedata",	   	optiga_shell_util_write_data},
-		{"    read coprocessor id                      : "OPTIGA_SHELL,"coprocid",		optiga_shell_util_read_coprocessor_id},
-
-		{"    binding host with optiga                 : "OPTIGA_SHELL,"bind",			optiga_shell_pair_host_optiga},
-		{"    hibernate and restore                    : "OPTIGA_SHELL,"hibernate",		optiga_shell_util_hibernate_restore},
-		{"    update counter                           : "OPTIGA_SHELL,"counter",		optiga_shell_util_update_count},
-		{"    protected update                         : "OPTIGA_SHELL,"protected",		optiga_shell_util_protected_update},
-
-		{"    hashing of data                          : "OPTIGA_SHELL,"hash",			optiga_shell_crypt_hash},
-		{"    hash single function                     : "OPTIGA_SHELL,"hashsha256",		optiga_shell_crypt_hash_data},
-		{"    tls pfr sha256                           : "OPTIGA_SHELL,"prf",			optiga_shell_crypt_tls_prf_sha256},
-		{"    random number generation                 : "OPTIGA_SHELL,"random",		optiga_shell_crypt_random},
-
-		{"    ecc key pair generation                  : "OPTIGA_SHELL,"ecckeygen",		optiga_shell_crypt_ecc_generate_keypair},
-		{"    ecdsa sign                               : "OPTIGA_SHELL,"ecdsasign",		optiga_shell_crypt_ecdsa_sign},
-		{"    ecdsa verify sign                        : "OPTIGA_SHELL,"ecdsaverify",		optiga_shell_crypt_ecdsa_verify},
-		{"    ecc diffie hellman                       : "OPTIGA_SHELL,"ecdh",			optiga_shell_crypt_ecdh},
-
-		{"    rsa key pair generation                  : "OPTIGA_SHELL,"rsakeygen",		optiga_shell_rsa_generate_keypair},
-		{"    rsa sign                                 : "OPTIGA_SHELL,"rsasign",		optiga_shell_crypt_rsa_sign},
-		{"    rsa verify sign                          : "OPTIGA_SHELL,"rsaverify",		optiga_shell_crypt_rsa_verify},
-		{"    rsa encrypt message                      : "OPTIGA_SHELL,"rsaencmsg",		optiga_shell_crypt_rsa_encrypt_message},
-		{"    rsa encrypt session                      : "OPTIGA_SHELL,"rsaencsession",		optiga_shell_crypt_rsa_encrypt_session},
-		{"    rsa decrypt and store                    : "OPTIGA_SHELL,"rsadecstore",		optiga_shell_crypt_rsa_decrypt_and_store},
-		{"    rsa decrypt and export                   : "OPTIGA_SHELL,"rsadecexp",		optiga_shell_crypt_rsa_decrypt_and_export},
-
-		{"    symmetric ecb encrypt and decrypt        : "OPTIGA_SHELL,"ecbencdec",	 	optiga_shell_crypt_symmetric_encrypt_decrypt_ecb},
-		{"    symmetric cbc encrypt and decrypt        : "OPTIGA_SHELL,"cbcencdec",		optiga_shell_crypt_symmetric_encrypt_decrypt_cbc},
-		{"    symmetric cbcmac encrypt                 : "OPTIGA_SHELL,"cbcmacenc",		optiga_shell_crypt_symmetric_encrypt_cbcmac},
-		{"    hmac-sha256 generation                   : "OPTIGA_SHELL,"hmac",			optiga_shell_crypt_hmac},
-		{"    hkdf-sha256 key derivation               : "OPTIGA_SHELL,"hkdf",			optiga_shell_crypt_hkdf},
-		{"    generate symmetric aes-128 key           : "OPTIGA_SHELL,"aeskeygen",		optiga_shell_crypt_symmetric_generate_key},
-		{"    clear auto state                         : "OPTIGA_SHELL,"clrautostate",		optiga_shell_crypt_clear_auto_state},
-		{"    hmac verify                              : "OPTIGA_SHELL,"hmacverify",		 optiga_shell_crypt_hmac_verify_with_authorization_reference},
+		{"",                                        	    "help",				optiga_shell_show_usage,
+																					NULL, NULL, OPTIGA_SHELL_CMD_NO_SESSION},
+		{"    initialize optiga                        : "OPTIGA_SHELL,"init",			optiga_shell_init,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    de-initialize optiga                     : "OPTIGA_SHELL,"deinit",		optiga_shell_deinit,
+																					NULL, NULL, OPTIGA_SHELL_CMD_NO_SESSION},
+		{"    run all tests at once                    : "OPTIGA_SHELL,"selftest",		optiga_shell_selftest,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    benchmark latency of operations          : "OPTIGA_SHELL,"bench",			NULL,
+																					optiga_shell_cmd_bench, OPTIGA_SHELL_BENCH_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    throughput of operations in flight       : "OPTIGA_SHELL,"pipeline",		NULL,
+																					optiga_shell_cmd_pipeline, OPTIGA_SHELL_PIPELINE_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    application state and idle hibernate     : "OPTIGA_SHELL,"session",		NULL,
+																					optiga_shell_cmd_session, OPTIGA_SHELL_SESSION_USAGE, OPTIGA_SHELL_CMD_NO_SESSION},
+		{"    boot from scratch vs. from hibernate     : "OPTIGA_SHELL,"bootbench",		NULL,
+																					optiga_shell_cmd_boot_bench, OPTIGA_SHELL_SESSION_BOOT_BENCH_USAGE, OPTIGA_SHELL_CMD_NO_SESSION},
+		{"    reuse of crypt and util instances        : "OPTIGA_SHELL,"pool",			NULL,
+																					optiga_shell_cmd_pool, OPTIGA_SHELL_POOL_USAGE, OPTIGA_SHELL_CMD_NO_SESSION},
+		{"    shielded connection protection policy    : "OPTIGA_SHELL,"policy",		NULL,
+																					optiga_shell_cmd_policy, OPTIGA_SHELL_POLICY_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    current limit and i2c clock profiles     : "OPTIGA_SHELL,"perfprofile",	NULL,
+																					optiga_shell_cmd_perfprofile, OPTIGA_SHELL_PROFILE_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    streaming sha256 of data from the link   : "OPTIGA_SHELL,"hashstream",		NULL,
+																					optiga_shell_cmd_hashstream, OPTIGA_SHELL_HASHSTREAM_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    sha256 on the host or on optiga          : "OPTIGA_SHELL,"hybridhash",		NULL,
+																					optiga_shell_cmd_hybridhash, OPTIGA_SHELL_HYBRID_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    many concurrent sha256 streams           : "OPTIGA_SHELL,"hashmux",		NULL,
+																					optiga_shell_cmd_hashmux, OPTIGA_SHELL_HASHMUX_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    read data                                : "OPTIGA_SHELL,"readdata",		optiga_shell_util_read_data,
+																					optiga_shell_cmd_read_data, OPTIGA_SHELL_CMD_READ_DATA_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    write data                               : "OPTIGA_SHELL,"writedata",		optiga_shell_util_write_data,
+																					optiga_shell_cmd_write_data, OPTIGA_SHELL_CMD_WRITE_DATA_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    read coprocessor id                      : "OPTIGA_SHELL,"coprocid",		optiga_shell_util_read_coprocessor_id,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+
+		{"    binding host with optiga                 : "OPTIGA_SHELL,"bind",			optiga_shell_pair_host_optiga,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    hibernate and restore                    : "OPTIGA_SHELL,"hibernate",		optiga_shell_util_hibernate_restore,
+																					NULL, NULL, OPTIGA_SHELL_CMD_OWN_SESSION},
+		{"    update counter                           : "OPTIGA_SHELL,"counter",		optiga_shell_util_update_count,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    protected update                         : "OPTIGA_SHELL,"protected",		optiga_shell_util_protected_update,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+
+		{"    hashing of data                          : "OPTIGA_SHELL,"hash",			optiga_shell_crypt_hash,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    hash single function                     : "OPTIGA_SHELL,"hashsha256",		optiga_shell_crypt_hash_data,
+																					optiga_shell_cmd_hash, OPTIGA_SHELL_CMD_HASH_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    tls pfr sha256                           : "OPTIGA_SHELL,"prf",			optiga_shell_crypt_tls_prf_sha256,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    random number generation                 : "OPTIGA_SHELL,"random",		optiga_shell_crypt_random,
+																					optiga_shell_cmd_random, OPTIGA_SHELL_CMD_RANDOM_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    random from optiga, prefetch pool or drbg: "OPTIGA_SHELL,"randbench",		NULL,
+																					optiga_shell_cmd_randbench, OPTIGA_SHELL_RANDOM_BENCH_USAGE, OPTIGA_SHELL_CMD_SESSION},
+
+		{"    ecc key pair generation                  : "OPTIGA_SHELL,"ecckeygen",		optiga_shell_crypt_ecc_generate_keypair,
+																					optiga_shell_cmd_ecc_generate_keypair, OPTIGA_SHELL_CMD_ECC_KEYGEN_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    ecdsa sign                               : "OPTIGA_SHELL,"ecdsasign",		optiga_shell_crypt_ecdsa_sign,
+																					optiga_shell_cmd_ecdsa_sign, OPTIGA_SHELL_CMD_ECDSA_SIGN_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    ecdsa verify sign                        : "OPTIGA_SHELL,"ecdsaverify",		optiga_shell_crypt_ecdsa_verify,
+																					optiga_shell_cmd_ecdsa_verify, OPTIGA_SHELL_CMD_ECDSA_VERIFY_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    ecdsa sign of a batch of digests         : "OPTIGA_SHELL,"signbatch",		NULL,
+																					optiga_shell_cmd_signbatch, OPTIGA_SHELL_BATCH_SIGN_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    ecc diffie hellman                       : "OPTIGA_SHELL,"ecdh",			optiga_shell_crypt_ecdh,
+																					optiga_shell_cmd_ecdh, OPTIGA_SHELL_CMD_ECDH_USAGE, OPTIGA_SHELL_CMD_SESSION},
+
+		{"    rsa key pair generation                  : "OPTIGA_SHELL,"rsakeygen",		optiga_shell_rsa_generate_keypair,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    rsa sign                                 : "OPTIGA_SHELL,"rsasign",		optiga_shell_crypt_rsa_sign,
+																					optiga_shell_cmd_rsa_sign, OPTIGA_SHELL_CMD_RSA_SIGN_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    rsa verify sign                          : "OPTIGA_SHELL,"rsaverify",		optiga_shell_crypt_rsa_verify,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    verify on the host and on optiga compared: "OPTIGA_SHELL,"verifybench",	NULL,
+																					optiga_shell_cmd_verifybench, OPTIGA_SHELL_VERIFY_BENCH_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    rsa encrypt message                      : "OPTIGA_SHELL,"rsaencmsg",		optiga_shell_crypt_rsa_encrypt_message,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    rsa encrypt session                      : "OPTIGA_SHELL,"rsaencsession",		optiga_shell_crypt_rsa_encrypt_session,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    rsa decrypt and store                    : "OPTIGA_SHELL,"rsadecstore",		optiga_shell_crypt_rsa_decrypt_and_store,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    rsa decrypt and export                   : "OPTIGA_SHELL,"rsadecexp",		optiga_shell_crypt_rsa_decrypt_and_export,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+
+		{"    symmetric ecb encrypt and decrypt        : "OPTIGA_SHELL,"ecbencdec",	 	optiga_shell_crypt_symmetric_encrypt_decrypt_ecb,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    symmetric ecb of a batch of blocks       : "OPTIGA_SHELL,"ecbbatch",		NULL,
+																					optiga_shell_cmd_ecbbatch, OPTIGA_SHELL_BATCH_ECB_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    symmetric cbc encrypt and decrypt        : "OPTIGA_SHELL,"cbcencdec",		optiga_shell_crypt_symmetric_encrypt_decrypt_cbc,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    streaming cbc throughput by chunk size   : "OPTIGA_SHELL,"cbcbench",		NULL,
+																					optiga_shell_cmd_cbcbench, OPTIGA_SHELL_CBC_BENCH_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    envelope encryption vs optiga cbc        : "OPTIGA_SHELL,"envelope",		NULL,
+																					optiga_shell_cmd_envelope, OPTIGA_SHELL_ENVELOPE_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    symmetric cbcmac encrypt                 : "OPTIGA_SHELL,"cbcmacenc",		optiga_shell_crypt_symmetric_encrypt_cbcmac,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    hmac-sha256 generation                   : "OPTIGA_SHELL,"hmac",			optiga_shell_crypt_hmac,
+																					optiga_shell_cmd_hmac, OPTIGA_SHELL_CMD_HMAC_USAGE, OPTIGA_SHELL_CMD_SESSION},
+		{"    hkdf-sha256 key derivation               : "OPTIGA_SHELL,"hkdf",			optiga_shell_crypt_hkdf,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    generate symmetric aes-128 key           : "OPTIGA_SHELL,"aeskeygen",		optiga_shell_crypt_symmetric_generate_key,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    clear auto state                         : "OPTIGA_SHELL,"clrautostate",		optiga_shell_crypt_clear_auto_state,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
+		{"    hmac verify                              : "OPTIGA_SHELL,"hmacverify",		 optiga_shell_crypt_hmac_verify_with_authorization_reference,
+																					NULL, NULL, OPTIGA_SHELL_CMD_SESSION},
 };
 
 #define OPTIGA_SIZE_OF_CMDS			(sizeof(optiga_cmds)/sizeof(optiga_example_cmd_t))
@@ -623,66 +671,242 @@ static void optiga_shell_show_usage()
 		{
 			optiga_lib_print_string(current_cmd->cmd_description);
 			optiga_lib_print_string_with_newline(current_cmd->cmd_options);
+			if(NULL != current_cmd->cmd_args_usage)
+			{
+				optiga_lib_print_string("                                               ");
+				optiga_lib_print_string_with_newline(current_cmd->cmd_args_usage);
+			}
 		}
 	}
 	optiga_lib_print_string_with_newline("");
-	optiga_lib_print_string_with_newline("Initialize OPTIGA before the 1st crypto functionality (not required for self-test)");
+	optiga_lib_print_string_with_newline("OPTIGA is opened by the 1st crypto functionality and hibernated when idle, init also pairs the host");
+	optiga_lib_print_string_with_newline("Without arguments a command runs its example, curves are p256|p384|p521|bp256|bp384|bp512");
+
+}
+
+/**
+ * Command lookup order, the indexes into optiga_cmds sorted by command name. It is sorted once
+ * when the shell starts, the lookup is then a binary search of at most log2 of the commands
+ * compares, with no seed or table size to tune as commands are added.
+ */
+static uint8_t optiga_shell_cmd_order[OPTIGA_SIZE_OF_CMDS];
 
+/*
+ * Compares the command name of the input, which is not terminated, with a terminated name
+ */
+static int32_t optiga_shell_compare_cmd(const char_t * cmd, uint32_t cmd_length, const char_t * name)
+{
+	int32_t result = strncmp(cmd, name, cmd_length);
+
+	if((0 == result) && (0 != name[cmd_length]))
+	{
+		/* The input is a prefix of the name */
+		result = -1;
+	}
+	return (result);
 }
 
-static void optiga_shell_trim_cmd(char_t * user_cmd)
+static void optiga_shell_sort_cmds(void)
 {
-	char_t* i = user_cmd;
-	char_t* j = user_cmd;
-	while(*j != 0)
+	uint8_t index;
+	uint8_t position;
+	uint8_t cmd_index;
+
+	/*
+	 * Insertion sort, a fixed and small number of compares for the few commands of the table
+	 */
+	for(index = 0; index < OPTIGA_SIZE_OF_CMDS; index++)
 	{
-		*i = *j++;
-		if(*i != ' ')
-			i++;
+		cmd_index = index;
+		for(position = index; position > 0; position--)
+		{
+			if(0 <= strcmp(optiga_cmds[cmd_index].cmd_options,
+						   optiga_cmds[optiga_shell_cmd_order[position - 1]].cmd_options))
+			{
+				break;
+			}
+			optiga_shell_cmd_order[position] = optiga_shell_cmd_order[position - 1];
+		}
+		optiga_shell_cmd_order[position] = cmd_index;
 	}
-	*i = 0;
-	if(strlen(user_cmd)>strlen(OPTIGA_SHELL))
+}
+
+static optiga_example_cmd_t * optiga_shell_find_cmd(const char_t * cmd, uint32_t cmd_length)
+{
+	optiga_example_cmd_t * current_cmd;
+	uint8_t low = 0;
+	uint8_t high = OPTIGA_SIZE_OF_CMDS;
+	uint8_t middle;
+	int32_t result;
+
+	while(low < high)
 	{
-		strcpy(user_cmd,user_cmd+strlen(OPTIGA_SHELL)-1);
+		middle = (uint8_t)(low + ((high - low) / 2U));
+		current_cmd = &optiga_cmds[optiga_shell_cmd_order[middle]];
+		result = optiga_shell_compare_cmd(cmd, cmd_length, current_cmd->cmd_options);
+		if(0 == result)
+		{
+			return (current_cmd);
+		}
+		if(result < 0)
+		{
+			high = middle;
+		}
+		else
+		{
+			low = (uint8_t)(middle + 1U);
+		}
 	}
+	return (NULL);
 }
 
-#include <stdio.h>
-static void optiga_shell_execute_example(char_t * user_cmd)
+/**
+ * Runs a command with its example handler if no arguments are given, otherwise parses the
+ * arguments in place and runs its argument handler. A command without example runs its argument
+ * handler with no arguments, i.e. all defaults. Returns FALSE if the arguments are rejected.
+ */
+static bool_t optiga_shell_dispatch_cmd(const optiga_example_cmd_t * current_cmd, char_t * args)
 {
-	uint8_t number_of_cmds = OPTIGA_SIZE_OF_CMDS;
-	uint8_t index = 0,cmd_found = 0;
+	optiga_shell_args_t cmd_args;
+	optiga_lib_status_t return_status;
+
+	memset(&cmd_args, 0, sizeof(cmd_args));
+	if((0 != *args) && (NULL == current_cmd->cmd_args_handler))
+	{
+		optiga_shell_args_print_error("This command takes no arguments", current_cmd->cmd_options);
+		return (FALSE);
+	}
+	if((0 != *args) && (FALSE == optiga_shell_args_parse(args, &cmd_args)))
+	{
+		return (FALSE);
+	}
+	if(OPTIGA_SHELL_CMD_SESSION == current_cmd->cmd_session)
+	{
+		return_status = optiga_shell_session_acquire();
+		if(OPTIGA_LIB_SUCCESS != return_status)
+		{
+			OPTIGA_SHELL_LOG_MESSAGE("Opening the application on OPTIGA failed");
+			OPTIGA_EXAMPLE_LOG_STATUS(return_status);
+			return (TRUE);
+		}
+	}
+
+	if((0 == *args) && (NULL != current_cmd->cmd_handler))
+	{
+		current_cmd->cmd_handler();
+	}
+	else
+	{
+		current_cmd->cmd_args_handler(&cmd_args);
+	}
+
+	if(OPTIGA_SHELL_CMD_SESSION == current_cmd->cmd_session)
+	{
+		optiga_shell_session_release();
+	}
+	else if(OPTIGA_SHELL_CMD_OWN_SESSION == current_cmd->cmd_session)
+	{
+		optiga_shell_session_forget();
+	}
+	return (TRUE);
+}
+
+/**
+ * Splits a line into the command name and its arguments in place, surrounding spaces are skipped.
+ * Returns the length of the name, the name itself is not terminated.
+ */
+static uint32_t optiga_shell_split_cmd(char_t * line, const char_t ** cmd, char_t ** args)
+{
+	uint32_t cmd_length = 0;
+
+	while(' ' == *line)
+	{
+		line++;
+	}
+	*cmd = line;
+	while((0 != line[cmd_length]) && (' ' != line[cmd_length]))
+	{
+		cmd_length++;
+	}
+	line += cmd_length;
+	while(' ' == *line)
+	{
+		line++;
+	}
+	*args = line;
+	return (cmd_length);
+}
+
+/**
+ * Runs the shell command line "<name> [--arg value ...]" without any console output of the
+ * shell itself, used by the binary RPC. Returns FALSE if there is no such command.
+ */
+bool_t optiga_shell_run_cmd(const char_t * cmd, uint32_t cmd_length)
+{
+	static char_t line[OPTIGA_SHELL_MAX_LINE_LENGTH];
 	optiga_example_cmd_t * current_cmd;
+	const char_t * name;
+	char_t * args;
+	uint32_t name_length;
+
+	if(cmd_length >= sizeof(line))
+	{
+		return (FALSE);
+	}
+	memcpy(line, cmd, cmd_length);
+	line[cmd_length] = 0;
+
+	name_length = optiga_shell_split_cmd(line, &name, &args);
+	if(0 == name_length)
+	{
+		return (FALSE);
+	}
+	current_cmd = optiga_shell_find_cmd(name, name_length);
+	if((NULL == current_cmd) ||
+	   ((NULL == current_cmd->cmd_handler) && (NULL == current_cmd->cmd_args_handler)))
+	{
+		return (FALSE);
+	}
+	(void)optiga_shell_dispatch_cmd(current_cmd, args);
+	return (TRUE);
+}
+
+static void optiga_shell_execute_example(char_t * user_cmd)
+{
+	optiga_example_cmd_t * current_cmd = NULL;
+	const char_t * cmd = NULL;
+	char_t * args = NULL;
+	uint32_t cmd_length;
+	uint8_t cmd_found = 0;
 
 	do
 	{
-		if (0 != strncmp(user_cmd,OPTIGA_SHELL,9))
+		if (0 != strncmp(user_cmd, OPTIGA_SHELL, sizeof(OPTIGA_SHELL) - 1))
+		{
+			break;
+		}
+		cmd_length = optiga_shell_split_cmd(user_cmd + sizeof(OPTIGA_SHELL) - 1, &cmd, &args);
+		if (0 == cmd_length)
 		{
 		    break;
 		}
-		optiga_shell_trim_cmd(user_cmd);
 
-		for(index = 0; index < number_of_cmds; index++)
+		current_cmd = optiga_shell_find_cmd(cmd, cmd_length);
+		if (NULL == current_cmd)
 		{
-			current_cmd = &optiga_cmds[index];
-			if((0 == strcmp(user_cmd,current_cmd->cmd_options)))
-			{
-				if(NULL != current_cmd->cmd_handler)
-				{
-					optiga_lib_print_string_with_newline("");
-					current_cmd->cmd_handler();
-					optiga_lib_print_string_with_newline("");
-					cmd_found = 1;
-					break;
-				}
-				else
-				{
-					optiga_lib_print_string_with_newline("No example exists for this request");
-					break;
-				}
-			}
+			break;
+		}
+		if((NULL != current_cmd->cmd_handler) || (NULL != current_cmd->cmd_args_handler))
+		{
+			optiga_lib_print_string_with_newline("");
+			(void)optiga_shell_dispatch_cmd(current_cmd, args);
+			optiga_lib_print_string_with_newline("");
+			cmd_found = 1;
+		}
+		else
+		{
+			optiga_lib_print_string_with_newline("No example exists for this request");
 		}
-
 	}while(FALSE);
 
 	if(cmd_found == 0)
@@ -700,71 +924,171 @@ static void optiga_shell_show_prompt()
 	optiga_lib_print_string_with_newline(">>>");
 }
 
+#if (0U != OPTIGA_SHELL_SESSION_RESUME_ON_BOOT)
+static void optiga_shell_resume()
+{
+	optiga_shell_session_stats_t stats;
+	optiga_lib_status_t return_status;
+	char_t line[100];
+
+	return_status = optiga_shell_session_resume();
+	if (TRUE == optiga_shell_session_is_resumed())
+	{
+		optiga_shell_session_get_stats(&stats);
+		snprintf(line, sizeof(line), "Application restored from hibernate in %lu usec, no open and pairing needed",
+				 (unsigned long)stats.restore_us);
+		OPTIGA_SHELL_LOG_MESSAGE(line);
+	}
+	else if (OPTIGA_LIB_SUCCESS != return_status)
+	{
+		OPTIGA_SHELL_LOG_MESSAGE("Opening the application on OPTIGA failed");
+		OPTIGA_EXAMPLE_LOG_STATUS(return_status);
+	}
+}
+#endif
+
+/*
+ * Takes the \n of a \r\n line end before the command runs, so a command reading raw data from
+ * the link (optiga --hashstream) gets it from the first byte after the line end
+ */
+static void optiga_shell_skip_line_feed(void)
+{
+	uint32_t start_ms = pal_os_timer_get_time_in_milliseconds();
+	uint32_t elapsed_ms = 0;
+	uint8_t ch;
+
+	while (elapsed_ms < OPTIGA_SHELL_LINE_FEED_WAIT_MS)
+	{
+		if (TRUE == optiga_shell_uart_peek(&ch))
+		{
+			if (ch == (uint8_t)'\n')
+			{
+				(void)optiga_shell_uart_read(&ch);
+			}
+			break;
+		}
+		if (TRUE == optiga_shell_uart_is_closed())
+		{
+			break;
+		}
+		optiga_shell_uart_wait_timeout(OPTIGA_SHELL_LINE_FEED_WAIT_MS - elapsed_ms);
+		elapsed_ms = pal_os_timer_get_time_in_milliseconds() - start_ms;
+	}
+}
+
 void optiga_shell_begin(void)
 {
+	static char_t user_cmd[OPTIGA_SHELL_MAX_LINE_LENGTH];
+	uint32_t idle_timeout_ms;
+	uint32_t refill_timeout_ms;
 	uint8_t ch = 0;
-	char_t user_cmd[50];
-	uint8_t index = 0;
+	uint32_t index = 0;
+
+	if (PAL_STATUS_SUCCESS != optiga_shell_uart_init())
+	{
+		optiga_lib_print_message("Console input not available!", "[error] : ", OPTIGA_LIB_LOGGER_COLOR_LIGHT_RED);
+		return;
+	}
 
+	optiga_shell_sort_cmds();
 	optiga_shell_show_usage();
+#if (0U != OPTIGA_SHELL_SESSION_RESUME_ON_BOOT)
+	optiga_shell_resume();
+#endif
 	optiga_lib_print_string_with_newline("");
 	optiga_shell_show_prompt();
 
 	while(TRUE)
 	{
-		if (0 == optiga_shell_pal_logger_read(&logger_console,&ch,1))
+		if (FALSE == optiga_shell_uart_read(&ch))
+		{
+			if (TRUE == optiga_shell_uart_is_closed())
+			{
+				/* Input stream closed, e.g. commands piped into the host build */
+				break;
+			}
+			/*
+			 * Nothing received, sleep until the UART interrupt fills the ring, the refill of the
+			 * random pool in flight completes or the application on OPTIGA is idle long enough
+			 * to be hibernated. It is not hibernated while a refill is in flight.
+			 */
+			refill_timeout_ms = optiga_shell_random_poll();
+			idle_timeout_ms = (OPTIGA_SHELL_RANDOM_NO_DEADLINE == refill_timeout_ms) ?
+							  optiga_shell_session_poll() : refill_timeout_ms;
+			optiga_shell_uart_wait_timeout((OPTIGA_SHELL_SESSION_NO_DEADLINE == idle_timeout_ms) ?
+										   OPTIGA_SHELL_UART_WAIT_FOREVER : idle_timeout_ms);
+			continue;
+		}
+		if (TRUE == optiga_shell_rpc_receive(ch))
 		{
 			/*
-			 * Check if carriage return \r or line feed \n is received, indicating the end of command input
-			 * */
-			if(ch == (uint8_t)'\r' || ch == (uint8_t)'\n')
+			 * Binary RPC frame, a partially typed text command is discarded
+			 */
+			index = 0;
+			continue;
+		}
+		/*
+		 * Check if carriage return \r or line feed \n is received, indicating the end of command input
+		 * */
+		if(ch == (uint8_t)'\r' || ch == (uint8_t)'\n')
+		{
+			if(index != 0)
 			{
-				if(index != 0)
-				{
-					user_cmd[index++] = 0;
-					index = 0;
-					optiga_shell_show_prompt();
-					/*
-					 * start cmd parsing
-					 */
-					optiga_shell_execute_example((char_t * )&user_cmd);
-					optiga_lib_print_string_with_newline("");
-					optiga_shell_show_prompt();
-				}
-				else
+				user_cmd[index++] = 0;
+				index = 0;
+				if (ch == (uint8_t)'\r')
 				{
-					/* If index is 0, it means the serial console (E.g. Tera Term) sends both \r and \n
-					 * In this case, ignore the second character received and move the command pointer back to beginning
-					 * as we only need to break at \r or \n
-					 */
-					user_cmd[index] = 0;
+					optiga_shell_skip_line_feed();
 				}
+				optiga_shell_show_prompt();
+				/*
+				 * start cmd parsing
+				 */
+				optiga_shell_execute_example((char_t * )&user_cmd);
+				optiga_lib_print_string_with_newline("");
+				optiga_shell_show_prompt();
 			}
 			else
 			{
-				/*
-				 * keep adding
+				/* If index is 0, it means the serial console (E.g. Tera Term) sends both \r and \n
+				 * In this case, ignore the second character received and move the command pointer back to beginning
+				 * as we only need to break at \r or \n
 				 */
-				pal_logger_write(&logger_console, &ch, 1);
-				user_cmd[index++] = ch;
+				user_cmd[index] = 0;
 			}
 		}
+		else if(index < (sizeof(user_cmd) - 1))
+		{
+			/*
+			 * keep adding, characters beyond the command buffer are dropped
+			 */
+			pal_logger_write(&logger_console, &ch, 1);
+			user_cmd[index++] = ch;
+		}
 	}
+#if (0U != OPTIGA_SHELL_SESSION_RESUME_ON_BOOT)
+	/*
+	 * Save the context of the application for the next boot
+	 */
+	optiga_shell_session_suspend();
+#endif
 }
 
 void optiga_shell_wait_for_user(void)
 {
-	pal_status_t pal = PAL_STATUS_FAILURE;
 	uint8_t ch = 0;
 
+	if (PAL_STATUS_SUCCESS != optiga_shell_uart_init())
+	{
+		return;
+	}
+
 	while(1U)
 	{
 		optiga_lib_print_string_with_newline(" Please press ENTER key to start optiga mini shell");
 		pal_os_timer_delay_in_milliseconds(2000);
 
-		pal = optiga_shell_pal_logger_read(&logger_console,&ch,1);
-
-		if(pal == PAL_STATUS_SUCCESS)
+		if(TRUE == optiga_shell_uart_read(&ch))
 		{
 			break;
 		}
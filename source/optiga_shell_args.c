@@ -0,0 +1,283 @@
+/******************************************************************************
+* File Name:   optiga_shell_args.c
+*
+* Description: Argument parsing of the parameterized shell commands. The command
+*              line is split in place, values are converted on request.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga_shell_args.h"
+
+#define OPTIGA_SHELL_ARGS_PREFIX        "--"
+#define OPTIGA_SHELL_ARGS_ERROR_MODULE  "[error] : "
+
+void optiga_shell_args_print_error(const char_t * p_message, const char_t * p_name)
+{
+    char_t buffer[80];
+
+    snprintf(buffer, sizeof(buffer), "%s%s%s", p_message,
+             (NULL != p_name) ? " --" : "", (NULL != p_name) ? p_name : "");
+    optiga_lib_print_message(buffer, OPTIGA_SHELL_ARGS_ERROR_MODULE, OPTIGA_LIB_LOGGER_COLOR_LIGHT_RED);
+}
+
+static char_t * optiga_shell_args_next_token(char_t ** p_cursor)
+{
+    char_t * token = *p_cursor;
+
+    while (' ' == *token)
+    {
+        token++;
+    }
+    if (0 == *token)
+    {
+        *p_cursor = token;
+        return (NULL);
+    }
+    *p_cursor = token;
+    while ((0 != **p_cursor) && (' ' != **p_cursor))
+    {
+        (*p_cursor)++;
+    }
+    if (0 != **p_cursor)
+    {
+        **p_cursor = 0;
+        (*p_cursor)++;
+    }
+    return (token);
+}
+
+bool_t optiga_shell_args_parse(char_t * p_line, optiga_shell_args_t * p_args)
+{
+    char_t * cursor = p_line;
+    char_t * name;
+    char_t * value;
+
+    memset(p_args, 0, sizeof(*p_args));
+    while (NULL != (name = optiga_shell_args_next_token(&cursor)))
+    {
+        if (0 != strncmp(name, OPTIGA_SHELL_ARGS_PREFIX, sizeof(OPTIGA_SHELL_ARGS_PREFIX) - 1))
+        {
+            optiga_shell_args_print_error("Arguments are given as --name value, unexpected", NULL);
+            return (FALSE);
+        }
+        name += sizeof(OPTIGA_SHELL_ARGS_PREFIX) - 1;
+        value = optiga_shell_args_next_token(&cursor);
+        if (NULL == value)
+        {
+            optiga_shell_args_print_error("Missing value of", name);
+            return (FALSE);
+        }
+        if (OPTIGA_SHELL_ARGS_MAX_COUNT == p_args->count)
+        {
+            optiga_shell_args_print_error("Too many arguments", NULL);
+            return (FALSE);
+        }
+        p_args->name[p_args->count] = name;
+        p_args->value[p_args->count] = value;
+        p_args->count++;
+    }
+    return (TRUE);
+}
+
+static int8_t optiga_shell_args_find(const optiga_shell_args_t * p_args, const char_t * p_name)
+{
+    uint8_t index;
+
+    for (index = 0; index < p_args->count; index++)
+    {
+        if (0 == strcmp(p_args->name[index], p_name))
+        {
+            return ((int8_t)index);
+        }
+    }
+    return (-1);
+}
+
+/**
+ * Returns the value of an argument and marks it as read, NULL if it is not given
+ */
+static const char_t * optiga_shell_args_take(optiga_shell_args_t * p_args, const char_t * p_name)
+{
+    int8_t index = optiga_shell_args_find(p_args, p_name);
+
+    if (0 > index)
+    {
+        return (NULL);
+    }
+    p_args->used |= (uint8_t)(1U << (uint8_t)index);
+    return (p_args->value[index]);
+}
+
+bool_t optiga_shell_args_has(const optiga_shell_args_t * p_args, const char_t * p_name)
+{
+    return ((0 <= optiga_shell_args_find(p_args, p_name)) ? TRUE : FALSE);
+}
+
+bool_t optiga_shell_args_get_number(optiga_shell_args_t * p_args,
+                                    const char_t * p_name,
+                                    uint32_t default_value,
+                                    uint32_t min,
+                                    uint32_t max,
+                                    uint32_t * p_value)
+{
+    const char_t * value = optiga_shell_args_take(p_args, p_name);
+    char_t * end = NULL;
+    unsigned long number;
+
+    *p_value = default_value;
+    if (NULL == value)
+    {
+        return (TRUE);
+    }
+    number = strtoul(value, &end, 0);
+    if ((0 != *end) || ('-' == *value) || (number < min) || (number > max))
+    {
+        optiga_shell_args_print_error("Invalid or out of range value of", p_name);
+        return (FALSE);
+    }
+    *p_value = (uint32_t)number;
+    return (TRUE);
+}
+
+static int8_t optiga_shell_args_nibble(char_t digit)
+{
+    if (('0' <= digit) && ('9' >= digit))
+    {
+        return ((int8_t)(digit - '0'));
+    }
+    if (('a' <= digit) && ('f' >= digit))
+    {
+        return ((int8_t)(digit - 'a' + 10));
+    }
+    if (('A' <= digit) && ('F' >= digit))
+    {
+        return ((int8_t)(digit - 'A' + 10));
+    }
+    return (-1);
+}
+
+bool_t optiga_shell_args_get_hex(optiga_shell_args_t * p_args,
+                                 const char_t * p_name,
+                                 uint8_t * p_buffer,
+                                 uint16_t size,
+                                 uint16_t * p_length)
+{
+    const char_t * value = optiga_shell_args_take(p_args, p_name);
+    uint32_t digits;
+    uint16_t index;
+    int8_t high;
+    int8_t low;
+
+    *p_length = 0;
+    if (NULL == value)
+    {
+        return (TRUE);
+    }
+    digits = strlen(value);
+    if ((0U == digits) || (0U != (digits % 2U)) || ((digits / 2U) > size))
+    {
+        optiga_shell_args_print_error("Expecting an even number of hex digits, within the size limit, for", p_name);
+        return (FALSE);
+    }
+    for (index = 0; index < (digits / 2U); index++)
+    {
+        high = optiga_shell_args_nibble(value[2U * index]);
+        low = optiga_shell_args_nibble(value[(2U * index) + 1U]);
+        if ((0 > high) || (0 > low))
+        {
+            optiga_shell_args_print_error("Invalid hex digit in", p_name);
+            return (FALSE);
+        }
+        p_buffer[index] = (uint8_t)(((uint8_t)high << 4) | (uint8_t)low);
+    }
+    *p_length = (uint16_t)(digits / 2U);
+    return (TRUE);
+}
+
+bool_t optiga_shell_args_get_choice(optiga_shell_args_t * p_args,
+                                    const char_t * p_name,
+                                    const optiga_shell_args_choice_t * p_choices,
+                                    uint8_t choice_count,
+                                    uint32_t default_value,
+                                    uint32_t * p_value)
+{
+    const char_t * value = optiga_shell_args_take(p_args, p_name);
+    uint8_t index;
+
+    *p_value = default_value;
+    if (NULL == value)
+    {
+        return (TRUE);
+    }
+    for (index = 0; index < choice_count; index++)
+    {
+        if (0 == strcmp(value, p_choices[index].name))
+        {
+            *p_value = p_choices[index].value;
+            return (TRUE);
+        }
+    }
+    optiga_shell_args_print_error("Unknown value of", p_name);
+    optiga_lib_print_string("    choices:");
+    for (index = 0; index < choice_count; index++)
+    {
+        optiga_lib_print_string(" ");
+        optiga_lib_print_string(p_choices[index].name);
+    }
+    optiga_lib_print_string_with_newline("");
+    return (FALSE);
+}
+
+bool_t optiga_shell_args_all_used(const optiga_shell_args_t * p_args)
+{
+    uint8_t index;
+
+    for (index = 0; index < p_args->count; index++)
+    {
+        if (0U == (p_args->used & (1U << index)))
+        {
+            optiga_shell_args_print_error("Unknown argument", p_args->name[index]);
+            return (FALSE);
+        }
+    }
+    return (TRUE);
+}
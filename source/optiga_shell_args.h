@@ -0,0 +1,152 @@
+/******************************************************************************
+* File Name:   optiga_shell_args.h
+*
+* Description: Argument parsing of the parameterized shell commands
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_ARGS_H_
+#define _OPTIGA_SHELL_ARGS_H_
+
+#include "optiga/common/optiga_lib_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of "--name value" pairs of one command */
+#define OPTIGA_SHELL_ARGS_MAX_COUNT     (8U)
+
+/** @brief Arguments of a shell command, names and values point into the command line */
+typedef struct optiga_shell_args
+{
+    uint8_t count;
+    /** Bit n is set once argument n has been read by a getter */
+    uint8_t used;
+    const char_t * name[OPTIGA_SHELL_ARGS_MAX_COUNT];
+    const char_t * value[OPTIGA_SHELL_ARGS_MAX_COUNT];
+} optiga_shell_args_t;
+
+/** @brief Symbolic value of an argument, e.g. "p256" for a curve */
+typedef struct optiga_shell_args_choice
+{
+    const char_t * name;
+    uint32_t value;
+} optiga_shell_args_choice_t;
+
+/**
+ * @brief Splits "--name value --name value" in place. The names are stored without "--".
+ *
+ * @retval TRUE   The arguments are well formed
+ * @retval FALSE  A value is missing or there are too many arguments, the error is printed
+ */
+bool_t optiga_shell_args_parse(char_t * p_line, optiga_shell_args_t * p_args);
+
+/**
+ * @brief Tells whether an argument is given.
+ */
+bool_t optiga_shell_args_has(const optiga_shell_args_t * p_args, const char_t * p_name);
+
+/**
+ * @brief Reads a decimal or 0x prefixed hexadecimal number in the range [min, max].
+ *
+ * @param[in,out] p_args         Arguments
+ * @param[in]     p_name         Argument name without "--"
+ * @param[in]     default_value  Value if the argument is not given
+ * @param[in]     min            Smallest value accepted
+ * @param[in]     max            Largest value accepted
+ * @param[out]    p_value        Value read
+ *
+ * @retval TRUE   The value is valid or the argument not given
+ * @retval FALSE  The value is invalid, the error is printed
+ */
+bool_t optiga_shell_args_get_number(optiga_shell_args_t * p_args,
+                                    const char_t * p_name,
+                                    uint32_t default_value,
+                                    uint32_t min,
+                                    uint32_t max,
+                                    uint32_t * p_value);
+
+/**
+ * @brief Reads a hexadecimal byte string such as "0a1b2c".
+ *
+ * @param[in,out] p_args    Arguments
+ * @param[in]     p_name    Argument name without "--"
+ * @param[out]    p_buffer  Bytes read
+ * @param[in]     size      Size of the buffer
+ * @param[out]    p_length  Number of bytes read, 0 if the argument is not given
+ *
+ * @retval TRUE   The value is valid or the argument not given
+ * @retval FALSE  The value is invalid or too long, the error is printed
+ */
+bool_t optiga_shell_args_get_hex(optiga_shell_args_t * p_args,
+                                 const char_t * p_name,
+                                 uint8_t * p_buffer,
+                                 uint16_t size,
+                                 uint16_t * p_length);
+
+/**
+ * @brief Reads a symbolic value out of a list of choices.
+ *
+ * @retval TRUE   The value is one of the choices or the argument not given
+ * @retval FALSE  The value is unknown, the error lists the choices
+ */
+bool_t optiga_shell_args_get_choice(optiga_shell_args_t * p_args,
+                                    const char_t * p_name,
+                                    const optiga_shell_args_choice_t * p_choices,
+                                    uint8_t choice_count,
+                                    uint32_t default_value,
+                                    uint32_t * p_value);
+
+/**
+ * @brief Checks that every argument was read, to catch misspelled names.
+ *
+ * @retval TRUE   All arguments are known
+ * @retval FALSE  An argument was not read by any getter, the error is printed
+ */
+bool_t optiga_shell_args_all_used(const optiga_shell_args_t * p_args);
+
+/**
+ * @brief Prints an argument error in the style of the shell errors.
+ */
+void optiga_shell_args_print_error(const char_t * p_message, const char_t * p_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_ARGS_H_ */
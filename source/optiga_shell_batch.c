@@ -0,0 +1,516 @@
+/******************************************************************************
+* File Name:   optiga_shell_batch.c
+*
+* Description: Batches of operations on OPTIGA with amortized setup
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "mbedtls/md.h"
+#include "optiga/optiga_crypt.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_example.h"
+#include "optiga_shell_batch.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_queue.h"
+#include "optiga_shell_request.h"
+
+/** @brief Room left in front of the signature for the SEQUENCE header, tag and up to two length bytes */
+#define OPTIGA_SHELL_BATCH_SEQUENCE_HEADER      (3U)
+#define OPTIGA_SHELL_BATCH_SEQUENCE_TAG         (0x30U)
+/** @brief Shortest content length needing the long form of a DER length */
+#define OPTIGA_SHELL_BATCH_DER_LONG_LENGTH      (0x80U)
+
+#define OPTIGA_SHELL_BATCH_DIGEST_LENGTH        (32U)
+/** @brief Size of a telemetry record of optiga --signbatch */
+#define OPTIGA_SHELL_BATCH_RECORD_LENGTH        (64U)
+
+/** @brief A batch of signatures in progress */
+typedef struct optiga_shell_batch_sign_run
+{
+    const uint8_t * p_digests;
+    uint8_t digest_length;
+    optiga_key_id_t key_oid;
+    uint8_t format;
+    optiga_shell_batch_signature_t * p_signatures;
+    /// Digests submitted
+    uint32_t submitted;
+    optiga_lib_status_t first_error;
+    /// Digest signed on each slot of the queue
+    uint32_t items[OPTIGA_SHELL_QUEUE_MAX_DEPTH];
+} optiga_shell_batch_sign_run_t;
+
+/** @brief A batch of AES-ECB blocks in progress */
+typedef struct optiga_shell_batch_ecb_run
+{
+    bool_t encrypt;
+    optiga_key_id_t key_oid;
+    const uint8_t * p_input;
+    uint8_t * p_output;
+    uint32_t count;
+    /// Blocks submitted
+    uint32_t submitted;
+    /// Commands submitted
+    uint32_t commands;
+    optiga_lib_status_t first_error;
+    /// First block and blocks of the command on each slot of the queue
+    uint32_t items[OPTIGA_SHELL_QUEUE_MAX_DEPTH];
+    uint32_t lengths[OPTIGA_SHELL_QUEUE_MAX_DEPTH];
+} optiga_shell_batch_ecb_run_t;
+
+/** @brief Key update of the symmetric examples, see example_optiga_crypt_symmetric_generate_key.c */
+extern optiga_lib_status_t generate_symmetric_key(void);
+
+static optiga_shell_queue_t optiga_shell_batch_queue;
+static optiga_shell_request_t optiga_shell_batch_request;
+
+/** @brief Digests and signatures of optiga --signbatch */
+static uint8_t optiga_shell_batch_digests[OPTIGA_SHELL_BATCH_MAX_COUNT][OPTIGA_SHELL_BATCH_DIGEST_LENGTH];
+static optiga_shell_batch_signature_t optiga_shell_batch_signatures[OPTIGA_SHELL_BATCH_MAX_COUNT];
+
+/** @brief Plain blocks of optiga --ecbbatch, their cipher blocks one by one and as a batch */
+static uint8_t optiga_shell_batch_plain_blocks[OPTIGA_SHELL_BATCH_ECB_MAX_COUNT][OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE];
+static uint8_t optiga_shell_batch_single_blocks[OPTIGA_SHELL_BATCH_ECB_MAX_COUNT][OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE];
+static uint8_t optiga_shell_batch_blocks[OPTIGA_SHELL_BATCH_ECB_MAX_COUNT][OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE];
+
+static optiga_lib_status_t optiga_shell_batch_sign_issue(optiga_crypt_t * me, uint8_t slot, void * context)
+{
+    optiga_shell_batch_sign_run_t * p_run = (optiga_shell_batch_sign_run_t *)context;
+    optiga_shell_batch_signature_t * p_signature;
+    uint8_t offset;
+
+    p_run->items[slot] = p_run->submitted++;
+    p_signature = &p_run->p_signatures[p_run->items[slot]];
+    offset = (OPTIGA_SHELL_BATCH_FORMAT_SEQUENCE == p_run->format) ? OPTIGA_SHELL_BATCH_SEQUENCE_HEADER : 0U;
+    p_signature->length = (uint16_t)(sizeof(p_signature->signature) - offset);
+    p_signature->status = OPTIGA_LIB_BUSY;
+    return (optiga_crypt_ecdsa_sign(me,
+                                    &p_run->p_digests[p_run->items[slot] * p_run->digest_length],
+                                    p_run->digest_length,
+                                    p_run->key_oid,
+                                    &p_signature->signature[offset],
+                                    &p_signature->length));
+}
+
+/**
+ * Collects a signature while the next ones are signed. OPTIGA wrote it behind the room of the
+ * SEQUENCE header, so only the header is added and the signature moved by at most one byte.
+ */
+static void optiga_shell_batch_sign_done(uint8_t slot, optiga_lib_status_t status, void * context)
+{
+    optiga_shell_batch_sign_run_t * p_run = (optiga_shell_batch_sign_run_t *)context;
+    optiga_shell_batch_signature_t * p_signature = &p_run->p_signatures[p_run->items[slot]];
+    uint8_t header_length;
+
+    p_signature->status = status;
+    if (OPTIGA_LIB_SUCCESS != status)
+    {
+        p_run->first_error = (OPTIGA_LIB_SUCCESS == p_run->first_error) ? status : p_run->first_error;
+        return;
+    }
+    if (OPTIGA_SHELL_BATCH_FORMAT_SEQUENCE != p_run->format)
+    {
+        return;
+    }
+    header_length = (p_signature->length < OPTIGA_SHELL_BATCH_DER_LONG_LENGTH) ? 2U : 3U;
+    memmove(&p_signature->signature[header_length], &p_signature->signature[OPTIGA_SHELL_BATCH_SEQUENCE_HEADER],
+            p_signature->length);
+    p_signature->signature[0] = OPTIGA_SHELL_BATCH_SEQUENCE_TAG;
+    if (2U == header_length)
+    {
+        p_signature->signature[1] = (uint8_t)p_signature->length;
+    }
+    else
+    {
+        p_signature->signature[1] = OPTIGA_SHELL_BATCH_DER_LONG_LENGTH | 1U;
+        p_signature->signature[2] = (uint8_t)p_signature->length;
+    }
+    p_signature->length += header_length;
+}
+
+optiga_lib_status_t optiga_shell_batch_ecdsa_sign(const uint8_t * p_digests,
+                                                  uint8_t digest_length,
+                                                  uint32_t count,
+                                                  optiga_key_id_t key_oid,
+                                                  uint8_t format,
+                                                  uint8_t depth,
+                                                  optiga_shell_batch_signature_t * p_signatures)
+{
+    optiga_shell_batch_sign_run_t run;
+    optiga_lib_status_t return_status;
+    uint32_t index;
+
+    memset(&run, 0, sizeof(run));
+    run.p_digests = p_digests;
+    run.digest_length = digest_length;
+    run.key_oid = key_oid;
+    run.format = format;
+    run.p_signatures = p_signatures;
+    run.first_error = OPTIGA_LIB_SUCCESS;
+
+    return_status = optiga_shell_queue_open(&optiga_shell_batch_queue, depth);
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        while ((run.submitted < count) && (OPTIGA_LIB_SUCCESS == run.first_error))
+        {
+            (void)optiga_shell_queue_submit(&optiga_shell_batch_queue, optiga_shell_batch_sign_issue,
+                                            optiga_shell_batch_sign_done, &run);
+        }
+        optiga_shell_queue_close(&optiga_shell_batch_queue);
+        return_status = run.first_error;
+    }
+    for (index = run.submitted; index < count; index++)
+    {
+        p_signatures[index].length = 0;
+        p_signatures[index].status = return_status;
+    }
+    return (return_status);
+}
+
+static optiga_lib_status_t optiga_shell_batch_ecb_issue(optiga_crypt_t * me, uint8_t slot, void * context)
+{
+    optiga_shell_batch_ecb_run_t * p_run = (optiga_shell_batch_ecb_run_t *)context;
+    uint32_t blocks = p_run->count - p_run->submitted;
+    uint32_t offset = p_run->submitted * OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE;
+
+    blocks = (blocks < OPTIGA_SHELL_BATCH_ECB_MAX_BLOCKS) ? blocks : OPTIGA_SHELL_BATCH_ECB_MAX_BLOCKS;
+    p_run->items[slot] = p_run->submitted;
+    p_run->lengths[slot] = blocks * OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE;
+    p_run->submitted += blocks;
+    p_run->commands++;
+    return ((TRUE == p_run->encrypt) ?
+            optiga_crypt_symmetric_encrypt_ecb(me, p_run->key_oid, &p_run->p_input[offset], p_run->lengths[slot],
+                                               &p_run->p_output[offset], &p_run->lengths[slot]) :
+            optiga_crypt_symmetric_decrypt_ecb(me, p_run->key_oid, &p_run->p_input[offset], p_run->lengths[slot],
+                                               &p_run->p_output[offset], &p_run->lengths[slot]));
+}
+
+static void optiga_shell_batch_ecb_done(uint8_t slot, optiga_lib_status_t status, void * context)
+{
+    optiga_shell_batch_ecb_run_t * p_run = (optiga_shell_batch_ecb_run_t *)context;
+    uint32_t blocks = p_run->count - p_run->items[slot];
+
+    blocks = (blocks < OPTIGA_SHELL_BATCH_ECB_MAX_BLOCKS) ? blocks : OPTIGA_SHELL_BATCH_ECB_MAX_BLOCKS;
+    if ((OPTIGA_LIB_SUCCESS == status) && ((blocks * OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE) != p_run->lengths[slot]))
+    {
+        status = OPTIGA_CRYPT_ERROR;
+    }
+    if (OPTIGA_LIB_SUCCESS != status)
+    {
+        p_run->first_error = (OPTIGA_LIB_SUCCESS == p_run->first_error) ? status : p_run->first_error;
+    }
+}
+
+/**
+ * Runs a batch of blocks prepared in p_run, the number of commands sent is left in it
+ */
+static optiga_lib_status_t optiga_shell_batch_ecb(optiga_shell_batch_ecb_run_t * p_run, uint8_t depth)
+{
+    optiga_lib_status_t return_status;
+
+    p_run->submitted = 0;
+    p_run->commands = 0;
+    p_run->first_error = OPTIGA_LIB_SUCCESS;
+    return_status = optiga_shell_queue_open(&optiga_shell_batch_queue, depth);
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        while ((p_run->submitted < p_run->count) && (OPTIGA_LIB_SUCCESS == p_run->first_error))
+        {
+            (void)optiga_shell_queue_submit(&optiga_shell_batch_queue, optiga_shell_batch_ecb_issue,
+                                            optiga_shell_batch_ecb_done, p_run);
+        }
+        optiga_shell_queue_close(&optiga_shell_batch_queue);
+        return_status = p_run->first_error;
+    }
+    return (return_status);
+}
+
+optiga_lib_status_t optiga_shell_batch_aes_ecb(bool_t encrypt,
+                                               optiga_key_id_t key_oid,
+                                               const uint8_t * p_input,
+                                               uint8_t * p_output,
+                                               uint32_t count,
+                                               uint8_t depth)
+{
+    optiga_shell_batch_ecb_run_t run;
+
+    memset(&run, 0, sizeof(run));
+    run.encrypt = encrypt;
+    run.key_oid = key_oid;
+    run.p_input = p_input;
+    run.p_output = p_output;
+    run.count = count;
+    return (optiga_shell_batch_ecb(&run, depth));
+}
+
+/**
+ * Signs the digests one by one, each with the steps of example_optiga_crypt_ecdsa_sign
+ */
+static optiga_lib_status_t optiga_shell_batch_sign_single(uint32_t count, optiga_key_id_t key_oid)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    optiga_shell_batch_signature_t * p_signature;
+    optiga_crypt_t * me;
+    uint32_t index;
+
+    for (index = 0; (index < count) && (OPTIGA_LIB_SUCCESS == return_status); index++)
+    {
+        me = optiga_shell_pool_get_crypt(&optiga_shell_batch_request);
+        if (NULL == me)
+        {
+            return (OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT);
+        }
+        p_signature = &optiga_shell_batch_signatures[index];
+        p_signature->length = sizeof(p_signature->signature);
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_batch_request,
+                                                 optiga_crypt_ecdsa_sign(me, optiga_shell_batch_digests[index],
+                                                                         OPTIGA_SHELL_BATCH_DIGEST_LENGTH, key_oid,
+                                                                         p_signature->signature,
+                                                                         &p_signature->length));
+        p_signature->status = return_status;
+        (void)optiga_shell_pool_put_crypt(me);
+    }
+    return (return_status);
+}
+
+/**
+ * Encrypts the blocks one by one, each with the steps of example_optiga_crypt_symmetric_encrypt_decrypt_ecb
+ */
+static optiga_lib_status_t optiga_shell_batch_ecb_single(uint32_t count)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    optiga_crypt_t * me;
+    uint32_t length;
+    uint32_t index;
+
+    for (index = 0; (index < count) && (OPTIGA_LIB_SUCCESS == return_status); index++)
+    {
+        me = optiga_shell_pool_get_crypt(&optiga_shell_batch_request);
+        if (NULL == me)
+        {
+            return (OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT);
+        }
+        length = OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE;
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_batch_request,
+                                                 optiga_crypt_symmetric_encrypt_ecb(me, OPTIGA_KEY_ID_SECRET_BASED,
+                                                                                    optiga_shell_batch_plain_blocks[index],
+                                                                                    OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE,
+                                                                                    optiga_shell_batch_single_blocks[index],
+                                                                                    &length));
+        (void)optiga_shell_pool_put_crypt(me);
+    }
+    return (return_status);
+}
+
+static void optiga_shell_batch_print(const char_t * p_path, uint32_t count, uint32_t elapsed_us,
+                                     optiga_lib_status_t status)
+{
+    uint32_t rate = (0U != elapsed_us) ? (uint32_t)(((uint64_t)count * 1000000000ULL) / elapsed_us) : 0U;
+    char_t line[80];
+
+    snprintf(line, sizeof(line), "%s,%lu,%lu,%lu.%03lu,0x%04X", p_path, (unsigned long)count,
+             (unsigned long)(elapsed_us / 1000U), (unsigned long)(rate / 1000U), (unsigned long)(rate % 1000U),
+             (unsigned int)status);
+    optiga_lib_print_string_with_newline(line);
+}
+
+void optiga_shell_cmd_signbatch(optiga_shell_args_t * p_args)
+{
+    static const optiga_shell_args_choice_t formats[] =
+    {
+        {"optiga",      OPTIGA_SHELL_BATCH_FORMAT_OPTIGA},
+        {"sequence",    OPTIGA_SHELL_BATCH_FORMAT_SEQUENCE},
+    };
+    optiga_lib_status_t return_status;
+    uint8_t record[OPTIGA_SHELL_BATCH_RECORD_LENGTH];
+    uint32_t count;
+    uint32_t oid;
+    uint32_t depth;
+    uint32_t format;
+    uint32_t single_us;
+    uint32_t batch_us;
+    uint32_t index;
+    uint32_t offset;
+    char_t line[80];
+
+    if ((FALSE == optiga_shell_args_get_number(p_args, "count", OPTIGA_SHELL_BATCH_DEFAULT_COUNT, 1,
+                                               OPTIGA_SHELL_BATCH_MAX_COUNT, &count)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "oid", OPTIGA_KEY_ID_E0F0, OPTIGA_KEY_ID_E0F0,
+                                               OPTIGA_KEY_ID_E0F3, &oid)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "depth", OPTIGA_SHELL_BATCH_DEFAULT_DEPTH, 1,
+                                               OPTIGA_SHELL_QUEUE_MAX_DEPTH, &depth)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "format", formats,
+                                               (uint8_t)(sizeof(formats) / sizeof(formats[0])),
+                                               OPTIGA_SHELL_BATCH_FORMAT_SEQUENCE, &format)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+
+    /*
+     * Telemetry records with a sequence number, each hashed on the host
+     */
+    for (index = 0; index < count; index++)
+    {
+        for (offset = 0; offset < sizeof(record); offset++)
+        {
+            record[offset] = (uint8_t)(index + (offset * 13U));
+        }
+        (void)mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), record, sizeof(record),
+                         optiga_shell_batch_digests[index]);
+    }
+
+    optiga_lib_print_string_with_newline("path,signatures,elapsed_ms,signatures_per_s,status");
+    single_us = pal_os_timer_get_time_in_microseconds();
+    return_status = optiga_shell_batch_sign_single(count, (optiga_key_id_t)oid);
+    single_us = pal_os_timer_get_time_in_microseconds() - single_us;
+    optiga_shell_batch_print("single", count, single_us, return_status);
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return;
+    }
+
+    batch_us = pal_os_timer_get_time_in_microseconds();
+    return_status = optiga_shell_batch_ecdsa_sign(&optiga_shell_batch_digests[0][0], OPTIGA_SHELL_BATCH_DIGEST_LENGTH,
+                                                  count, (optiga_key_id_t)oid, (uint8_t)format, (uint8_t)depth,
+                                                  optiga_shell_batch_signatures);
+    batch_us = pal_os_timer_get_time_in_microseconds() - batch_us;
+    optiga_shell_batch_print("batch", count, batch_us, return_status);
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return;
+    }
+
+    snprintf(line, sizeof(line), "Speedup of the batch with depth %lu: %lu.%02lux", (unsigned long)depth,
+             (unsigned long)((0U != batch_us) ? (single_us / batch_us) : 0U),
+             (unsigned long)((0U != batch_us) ? (((single_us % batch_us) * 100U) / batch_us) : 0U));
+    optiga_lib_print_string_with_newline(line);
+    OPTIGA_EXAMPLE_LOG_HEX_DATA(optiga_shell_batch_signatures[count - 1U].signature,
+                                optiga_shell_batch_signatures[count - 1U].length);
+}
+
+static void optiga_shell_batch_ecb_print(const char_t * p_path, uint32_t count, uint32_t commands,
+                                         uint32_t elapsed_us, bool_t match, optiga_lib_status_t status)
+{
+    uint32_t rate = (0U != elapsed_us) ? (uint32_t)(((uint64_t)count * 1000000000ULL) / elapsed_us) : 0U;
+    char_t line[96];
+
+    snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu.%03lu,%s,0x%04X", p_path, (unsigned long)count,
+             (unsigned long)commands, (unsigned long)(elapsed_us / 1000U), (unsigned long)(rate / 1000U),
+             (unsigned long)(rate % 1000U), (TRUE == match) ? "yes" : "no", (unsigned int)status);
+    optiga_lib_print_string_with_newline(line);
+}
+
+void optiga_shell_cmd_ecbbatch(optiga_shell_args_t * p_args)
+{
+    optiga_shell_batch_ecb_run_t run;
+    optiga_lib_status_t return_status;
+    uint32_t count;
+    uint32_t depth;
+    uint32_t single_us;
+    uint32_t batch_us;
+    uint32_t length;
+    uint32_t index;
+    uint32_t offset;
+    bool_t match;
+    char_t line[80];
+
+    if ((FALSE == optiga_shell_args_get_number(p_args, "count", OPTIGA_SHELL_BATCH_ECB_DEFAULT_COUNT, 1,
+                                               OPTIGA_SHELL_BATCH_ECB_MAX_COUNT, &count)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "depth", OPTIGA_SHELL_BATCH_DEFAULT_DEPTH, 1,
+                                               OPTIGA_SHELL_QUEUE_MAX_DEPTH, &depth)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+
+    return_status = generate_symmetric_key();
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        OPTIGA_EXAMPLE_LOG_STATUS(return_status);
+        return;
+    }
+
+    /*
+     * Independent blocks, e.g. counters or tokens, each with its own index
+     */
+    for (index = 0; index < count; index++)
+    {
+        for (offset = 0; offset < OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE; offset++)
+        {
+            optiga_shell_batch_plain_blocks[index][offset] = (uint8_t)((index >> (8U * (offset & 3U))) + (offset * 29U));
+        }
+    }
+    length = count * OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE;
+
+    optiga_lib_print_string_with_newline("path,blocks,commands,elapsed_ms,blocks_per_s,match,status");
+    single_us = pal_os_timer_get_time_in_microseconds();
+    return_status = optiga_shell_batch_ecb_single(count);
+    single_us = pal_os_timer_get_time_in_microseconds() - single_us;
+    optiga_shell_batch_ecb_print("single", count, count, single_us, TRUE, return_status);
+
+    memset(&run, 0, sizeof(run));
+    run.encrypt = TRUE;
+    run.key_oid = OPTIGA_KEY_ID_SECRET_BASED;
+    run.p_input = &optiga_shell_batch_plain_blocks[0][0];
+    run.p_output = &optiga_shell_batch_blocks[0][0];
+    run.count = count;
+    batch_us = pal_os_timer_get_time_in_microseconds();
+    return_status = optiga_shell_batch_ecb(&run, (uint8_t)depth);
+    batch_us = pal_os_timer_get_time_in_microseconds() - batch_us;
+    match = (0 == memcmp(optiga_shell_batch_blocks, optiga_shell_batch_single_blocks, length)) ? TRUE : FALSE;
+    optiga_shell_batch_ecb_print("batch", count, run.commands, batch_us, match, return_status);
+
+    snprintf(line, sizeof(line), "Speedup of the batch with depth %lu: %lu.%02lux", (unsigned long)depth,
+             (unsigned long)((0U != batch_us) ? (single_us / batch_us) : 0U),
+             (unsigned long)((0U != batch_us) ? (((single_us % batch_us) * 100U) / batch_us) : 0U));
+    optiga_lib_print_string_with_newline(line);
+
+    /*
+     * Decrypts the batch back in place
+     */
+    run.encrypt = FALSE;
+    run.p_input = &optiga_shell_batch_blocks[0][0];
+    batch_us = pal_os_timer_get_time_in_microseconds();
+    return_status = optiga_shell_batch_ecb(&run, (uint8_t)depth);
+    batch_us = pal_os_timer_get_time_in_microseconds() - batch_us;
+    match = (0 == memcmp(optiga_shell_batch_blocks, optiga_shell_batch_plain_blocks, length)) ? TRUE : FALSE;
+    optiga_shell_batch_ecb_print("batch_decrypt", count, run.commands, batch_us, match, return_status);
+}
@@ -0,0 +1,190 @@
+/******************************************************************************
+* File Name:   optiga_shell_batch.h
+*
+* Description: Batches of operations on OPTIGA with amortized setup
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_BATCH_H_
+#define _OPTIGA_SHELL_BATCH_H_
+
+#include "optiga/optiga_crypt.h"
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Largest ECDSA signature: the R and S integers of NIST P-521 as returned by OPTIGA,
+ * with the SEQUENCE header of #OPTIGA_SHELL_BATCH_FORMAT_SEQUENCE
+ */
+#define OPTIGA_SHELL_BATCH_MAX_SIGNATURE_LENGTH (3U + (2U * (2U + 67U)))
+
+/** @brief Signature formats of #optiga_shell_batch_ecdsa_sign */
+/// R and S as two DER INTEGERs, as returned by OPTIGA
+#define OPTIGA_SHELL_BATCH_FORMAT_OPTIGA        (0U)
+/// ECDSA-Sig-Value, the two INTEGERs in a DER SEQUENCE as used by X.509 and mbedTLS
+#define OPTIGA_SHELL_BATCH_FORMAT_SEQUENCE      (1U)
+
+/** @brief Default and largest number of digests signed by optiga --signbatch */
+#define OPTIGA_SHELL_BATCH_DEFAULT_COUNT        (32U)
+#define OPTIGA_SHELL_BATCH_MAX_COUNT            (64U)
+
+/** @brief Default number of signatures in flight of optiga --signbatch */
+#define OPTIGA_SHELL_BATCH_DEFAULT_DEPTH        (3U)
+
+/** @brief Argument usage of the signbatch command, as shown by help */
+#define OPTIGA_SHELL_BATCH_SIGN_USAGE           "[--count <n>] [--oid <key>] [--depth <1..5>] [--format optiga|sequence]"
+
+/** @brief AES block, the unit of an ECB batch */
+#define OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE       (16U)
+
+/** @brief Bytes of a symmetric encrypt or decrypt command besides the data: command header and data TLV */
+#define OPTIGA_SHELL_BATCH_ECB_APDU_OVERHEAD    (4U + 3U)
+
+/**
+ * @brief Blocks of one ECB command of a batch, as many as fit the communication buffer, so the
+ * library never splits a command
+ */
+#ifndef OPTIGA_SHELL_BATCH_ECB_MAX_BLOCKS
+#define OPTIGA_SHELL_BATCH_ECB_MAX_BLOCKS       ((OPTIGA_MAX_COMMS_BUFFER_SIZE - OPTIGA_SHELL_BATCH_ECB_APDU_OVERHEAD) / \
+                                                 OPTIGA_SHELL_BATCH_AES_BLOCK_SIZE)
+#endif
+
+/** @brief Default and largest number of blocks of optiga --ecbbatch */
+#define OPTIGA_SHELL_BATCH_ECB_DEFAULT_COUNT    (256U)
+#define OPTIGA_SHELL_BATCH_ECB_MAX_COUNT        (512U)
+
+/** @brief Argument usage of the ecbbatch command, as shown by help */
+#define OPTIGA_SHELL_BATCH_ECB_USAGE            "[--count <n>] [--depth <1..5>]"
+
+/** @brief Signature of one digest of a batch */
+typedef struct optiga_shell_batch_signature
+{
+    uint8_t signature[OPTIGA_SHELL_BATCH_MAX_SIGNATURE_LENGTH];
+    uint16_t length;
+    /// Result of the signature, the other fields are only valid on #OPTIGA_LIB_SUCCESS
+    optiga_lib_status_t status;
+} optiga_shell_batch_signature_t;
+
+/**
+ * @brief Signs an array of digests with one key.
+ *
+ * The crypt instances are taken from the pool once for the whole batch, and up to depth
+ * signatures are in flight through #optiga_shell_queue_t. While OPTIGA signs one digest, the
+ * host collects and formats the previous signature. The signatures are written in place, in
+ * the order of the digests. After an error the remaining digests are not signed; their status
+ * is the error.
+ *
+ * OPTIGA still signs one digest at a time, so a batch is never faster than the chip time of
+ * its signatures. What it saves is the host time between two signatures, which the next
+ * command in flight hides. With depth 1 nothing is hidden.
+ *
+ * @param[in]  p_digests      count digests of digest_length bytes each, one after the other
+ * @param[in]  digest_length  Length of each digest, e.g. 32 for SHA-256
+ * @param[in]  count          Number of digests
+ * @param[in]  key_oid        Key of the signatures, e.g. OPTIGA_KEY_ID_E0F0
+ * @param[in]  format         #OPTIGA_SHELL_BATCH_FORMAT_OPTIGA or #OPTIGA_SHELL_BATCH_FORMAT_SEQUENCE
+ * @param[in]  depth          Number of signatures in flight, 1 to #OPTIGA_SHELL_QUEUE_MAX_DEPTH
+ * @param[out] p_signatures   count signatures
+ *
+ * @retval #OPTIGA_LIB_SUCCESS  All digests are signed
+ * @retval The first error otherwise
+ */
+optiga_lib_status_t optiga_shell_batch_ecdsa_sign(const uint8_t * p_digests,
+                                                  uint8_t digest_length,
+                                                  uint32_t count,
+                                                  optiga_key_id_t key_oid,
+                                                  uint8_t format,
+                                                  uint8_t depth,
+                                                  optiga_shell_batch_signature_t * p_signatures);
+
+/**
+ * @brief Encrypts or decrypts an array of independent AES blocks with one key in ECB mode.
+ *
+ * Up to #OPTIGA_SHELL_BATCH_ECB_MAX_BLOCKS blocks go in one command instead of one command per
+ * block, and up to depth commands are in flight through #optiga_shell_queue_t. OPTIGA writes the
+ * result of each block straight into its place in the output array, which may be the input
+ * array. After an error the remaining commands are not sent.
+ *
+ * @param[in]  encrypt   TRUE to encrypt, FALSE to decrypt
+ * @param[in]  key_oid   AES key, e.g. OPTIGA_KEY_ID_SECRET_BASED
+ * @param[in]  p_input   count blocks, one after the other
+ * @param[out] p_output  count blocks, p_input to work in place
+ * @param[in]  count     Number of blocks
+ * @param[in]  depth     Number of commands in flight, 1 to #OPTIGA_SHELL_QUEUE_MAX_DEPTH
+ *
+ * @retval #OPTIGA_LIB_SUCCESS  All blocks are processed
+ * @retval The first error otherwise
+ */
+optiga_lib_status_t optiga_shell_batch_aes_ecb(bool_t encrypt,
+                                               optiga_key_id_t key_oid,
+                                               const uint8_t * p_input,
+                                               uint8_t * p_output,
+                                               uint32_t count,
+                                               uint8_t depth);
+
+/**
+ * @brief Signs --count SHA-256 digests of telemetry records with the --oid key, once one by one
+ * and once as a batch.
+ *
+ * The one by one path does what example_optiga_crypt_ecdsa_sign does per digest: it takes an
+ * instance from the pool, signs, waits and returns the instance. One CSV line per path gives the
+ * signatures per second, and a last line the speedup of the batch.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_signbatch(optiga_shell_args_t * p_args);
+
+/**
+ * @brief Encrypts --count blocks with the key of the symmetric examples, once one block per
+ * command as example_optiga_crypt_symmetric_encrypt_decrypt_ecb does, and once as a batch.
+ *
+ * The batch result is compared with the one by one result and decrypted back as a batch. One
+ * CSV line per path gives the commands and the blocks per second, and a last line the speedup
+ * of the batch.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_ecbbatch(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_BATCH_H_ */
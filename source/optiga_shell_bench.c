@@ -0,0 +1,584 @@
+/******************************************************************************
+* File Name:   optiga_shell_bench.c
+*
+* Description: Latency benchmark of OPTIGA operations for the shell. Each operation
+*              is prepared once, warmed up and then timed without logging or delays.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/optiga_util.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_bench.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_wait.h"
+
+#define OPTIGA_SHELL_BENCH_FORMAT_CSV       (0U)
+#define OPTIGA_SHELL_BENCH_FORMAT_JSON      (1U)
+
+#define OPTIGA_SHELL_BENCH_ECDSA_KEY_OID    (0xE0F2U)
+#define OPTIGA_SHELL_BENCH_ECDH_KEY_OID     (0xE0F3U)
+#define OPTIGA_SHELL_BENCH_RSA_KEY_OID      (0xE0FCU)
+#define OPTIGA_SHELL_BENCH_SECRET_OID       (0xF1D0U)
+#define OPTIGA_SHELL_BENCH_AES_KEY_OID      (0xE200U)
+#define OPTIGA_SHELL_BENCH_CERTIFICATE_OID  (0xE0E0U)
+#define OPTIGA_SHELL_BENCH_DATA_OID         (0xF1D1U)
+
+/**
+ * Runs an asynchronous crypt or util call and waits for its completion
+ */
+#define OPTIGA_SHELL_BENCH_CRYPT(call)  OPTIGA_SHELL_REQUEST_RUN(optiga_shell_bench_crypt_request, call)
+#define OPTIGA_SHELL_BENCH_UTIL(call)   OPTIGA_SHELL_REQUEST_RUN(optiga_shell_bench_util_request, call)
+
+/** @brief One benchmarked operation */
+typedef struct optiga_shell_bench_case
+{
+    const char_t * name;
+    /** Untimed preparation, run once before the warm-up, NULL if none */
+    optiga_lib_status_t (*setup)(void);
+    /** Timed operation */
+    optiga_lib_status_t (*operation)(void);
+    /** The setup or the operation writes data objects or keys to NVM, only run with --nvm on */
+    bool_t writes_nvm;
+} optiga_shell_bench_case_t;
+
+static optiga_crypt_t * optiga_shell_bench_crypt = NULL;
+static optiga_util_t * optiga_shell_bench_util = NULL;
+static optiga_shell_request_t optiga_shell_bench_crypt_request;
+static optiga_shell_request_t optiga_shell_bench_util_request;
+
+static uint32_t optiga_shell_bench_samples[OPTIGA_SHELL_BENCH_MAX_ITERATIONS];
+static uint8_t optiga_shell_bench_data[64];
+static uint8_t optiga_shell_bench_output[1024];
+static uint8_t optiga_shell_bench_public_key[150];
+static uint16_t optiga_shell_bench_public_key_length;
+static uint8_t optiga_shell_bench_signature[80];
+static uint16_t optiga_shell_bench_signature_length;
+
+static optiga_lib_status_t optiga_shell_bench_generate_ecc_key(uint16_t oid, uint8_t key_usage)
+{
+    optiga_key_id_t key_id = (optiga_key_id_t)oid;
+
+    optiga_shell_bench_public_key_length = sizeof(optiga_shell_bench_public_key);
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_ecc_generate_keypair(optiga_shell_bench_crypt,
+                                                                       OPTIGA_ECC_CURVE_NIST_P_256,
+                                                                       key_usage,
+                                                                       FALSE,
+                                                                       &key_id,
+                                                                       optiga_shell_bench_public_key,
+                                                                       &optiga_shell_bench_public_key_length)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_setup_ecdsa(void)
+{
+    optiga_lib_status_t return_status;
+
+    return_status = optiga_shell_bench_generate_ecc_key(OPTIGA_SHELL_BENCH_ECDSA_KEY_OID, OPTIGA_KEY_USAGE_SIGN);
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return (return_status);
+    }
+    optiga_shell_bench_signature_length = sizeof(optiga_shell_bench_signature);
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_ecdsa_sign(optiga_shell_bench_crypt,
+                                                             optiga_shell_bench_data,
+                                                             32,
+                                                             (optiga_key_id_t)OPTIGA_SHELL_BENCH_ECDSA_KEY_OID,
+                                                             optiga_shell_bench_signature,
+                                                             &optiga_shell_bench_signature_length)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_setup_ecdh(void)
+{
+    /*
+     * The public key of the same key pair serves as the peer public key
+     */
+    return (optiga_shell_bench_generate_ecc_key(OPTIGA_SHELL_BENCH_ECDH_KEY_OID, OPTIGA_KEY_USAGE_KEY_AGREEMENT));
+}
+
+static optiga_lib_status_t optiga_shell_bench_setup_rsa(void)
+{
+    optiga_key_id_t key_id = (optiga_key_id_t)OPTIGA_SHELL_BENCH_RSA_KEY_OID;
+
+    optiga_shell_bench_public_key_length = sizeof(optiga_shell_bench_public_key);
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_rsa_generate_keypair(optiga_shell_bench_crypt,
+                                                                       OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL,
+                                                                       OPTIGA_KEY_USAGE_SIGN,
+                                                                       FALSE,
+                                                                       &key_id,
+                                                                       optiga_shell_bench_public_key,
+                                                                       &optiga_shell_bench_public_key_length)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_setup_hmac(void)
+{
+    /*
+     * Execute access condition = Always, data object type = Pre-shared secret
+     */
+    const uint8_t metadata[] = {0x20, 0x06, 0xD3, 0x01, 0x00, 0xE8, 0x01, 0x21};
+    optiga_lib_status_t return_status;
+
+    return_status = OPTIGA_SHELL_BENCH_UTIL(optiga_util_write_metadata(optiga_shell_bench_util,
+                                                                       OPTIGA_SHELL_BENCH_SECRET_OID,
+                                                                       metadata,
+                                                                       sizeof(metadata)));
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return (return_status);
+    }
+    return (OPTIGA_SHELL_BENCH_UTIL(optiga_util_write_data(optiga_shell_bench_util,
+                                                          OPTIGA_SHELL_BENCH_SECRET_OID,
+                                                          OPTIGA_UTIL_ERASE_AND_WRITE,
+                                                          0,
+                                                          optiga_shell_bench_data,
+                                                          32)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_setup_aes(void)
+{
+    /*
+     * Change and execute access condition = Always
+     */
+    const uint8_t metadata[] = {0x20, 0x06, 0xD0, 0x01, 0x00, 0xD3, 0x01, 0x00};
+    optiga_key_id_t key_id = (optiga_key_id_t)OPTIGA_SHELL_BENCH_AES_KEY_OID;
+    optiga_lib_status_t return_status;
+
+    return_status = OPTIGA_SHELL_BENCH_UTIL(optiga_util_write_metadata(optiga_shell_bench_util,
+                                                                       OPTIGA_SHELL_BENCH_AES_KEY_OID,
+                                                                       metadata,
+                                                                       sizeof(metadata)));
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return (return_status);
+    }
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_symmetric_generate_key(optiga_shell_bench_crypt,
+                                                                         OPTIGA_SYMMETRIC_AES_128,
+                                                                         OPTIGA_KEY_USAGE_ENCRYPTION,
+                                                                         FALSE,
+                                                                         &key_id)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_random(void)
+{
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_random(optiga_shell_bench_crypt,
+                                                         OPTIGA_RNG_TYPE_TRNG,
+                                                         optiga_shell_bench_output,
+                                                         32)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_hash(void)
+{
+    hash_data_from_host_t hash_data;
+
+    hash_data.buffer = optiga_shell_bench_data;
+    hash_data.length = sizeof(optiga_shell_bench_data);
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_hash(optiga_shell_bench_crypt,
+                                                       OPTIGA_HASH_TYPE_SHA_256,
+                                                       OPTIGA_CRYPT_HOST_DATA,
+                                                       &hash_data,
+                                                       optiga_shell_bench_output)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_ecc_generate_keypair(void)
+{
+    /*
+     * The key goes to the session context, repeated key generation does not wear the NVM
+     */
+    optiga_key_id_t key_id = OPTIGA_KEY_ID_SESSION_BASED;
+    uint16_t public_key_length = sizeof(optiga_shell_bench_output);
+
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_ecc_generate_keypair(optiga_shell_bench_crypt,
+                                                                       OPTIGA_ECC_CURVE_NIST_P_256,
+                                                                       OPTIGA_KEY_USAGE_KEY_AGREEMENT,
+                                                                       FALSE,
+                                                                       &key_id,
+                                                                       optiga_shell_bench_output,
+                                                                       &public_key_length)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_ecdsa_sign(void)
+{
+    uint16_t signature_length = sizeof(optiga_shell_bench_output);
+
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_ecdsa_sign(optiga_shell_bench_crypt,
+                                                             optiga_shell_bench_data,
+                                                             32,
+                                                             (optiga_key_id_t)OPTIGA_SHELL_BENCH_ECDSA_KEY_OID,
+                                                             optiga_shell_bench_output,
+                                                             &signature_length)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_ecdsa_verify(void)
+{
+    public_key_from_host_t public_key;
+
+    public_key.public_key = optiga_shell_bench_public_key;
+    public_key.length = optiga_shell_bench_public_key_length;
+    public_key.key_type = (uint8_t)OPTIGA_ECC_CURVE_NIST_P_256;
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_ecdsa_verify(optiga_shell_bench_crypt,
+                                                               optiga_shell_bench_data,
+                                                               32,
+                                                               optiga_shell_bench_signature,
+                                                               optiga_shell_bench_signature_length,
+                                                               OPTIGA_CRYPT_HOST_DATA,
+                                                               &public_key)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_ecdh(void)
+{
+    public_key_from_host_t public_key;
+
+    public_key.public_key = optiga_shell_bench_public_key;
+    public_key.length = optiga_shell_bench_public_key_length;
+    public_key.key_type = (uint8_t)OPTIGA_ECC_CURVE_NIST_P_256;
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_ecdh(optiga_shell_bench_crypt,
+                                                       (optiga_key_id_t)OPTIGA_SHELL_BENCH_ECDH_KEY_OID,
+                                                       &public_key,
+                                                       TRUE,
+                                                       optiga_shell_bench_output)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_rsa_sign(void)
+{
+    uint16_t signature_length = sizeof(optiga_shell_bench_output);
+
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_rsa_sign(optiga_shell_bench_crypt,
+                                                           OPTIGA_RSASSA_PKCS1_V15_SHA256,
+                                                           optiga_shell_bench_data,
+                                                           32,
+                                                           (optiga_key_id_t)OPTIGA_SHELL_BENCH_RSA_KEY_OID,
+                                                           optiga_shell_bench_output,
+                                                           &signature_length,
+                                                           0)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_hmac(void)
+{
+    uint32_t mac_length = sizeof(optiga_shell_bench_output);
+
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_hmac(optiga_shell_bench_crypt,
+                                                       OPTIGA_HMAC_SHA_256,
+                                                       OPTIGA_SHELL_BENCH_SECRET_OID,
+                                                       optiga_shell_bench_data,
+                                                       sizeof(optiga_shell_bench_data),
+                                                       optiga_shell_bench_output,
+                                                       &mac_length)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_aes_ecb(void)
+{
+    uint32_t encrypted_length = sizeof(optiga_shell_bench_output);
+
+    return (OPTIGA_SHELL_BENCH_CRYPT(optiga_crypt_symmetric_encrypt_ecb(optiga_shell_bench_crypt,
+                                                                        (optiga_key_id_t)OPTIGA_SHELL_BENCH_AES_KEY_OID,
+                                                                        optiga_shell_bench_data,
+                                                                        16,
+                                                                        optiga_shell_bench_output,
+                                                                        &encrypted_length)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_read_data(void)
+{
+    uint16_t length = sizeof(optiga_shell_bench_output);
+
+    return (OPTIGA_SHELL_BENCH_UTIL(optiga_util_read_data(optiga_shell_bench_util,
+                                                         OPTIGA_SHELL_BENCH_CERTIFICATE_OID,
+                                                         0,
+                                                         optiga_shell_bench_output,
+                                                         &length)));
+}
+
+static optiga_lib_status_t optiga_shell_bench_write_data(void)
+{
+    return (OPTIGA_SHELL_BENCH_UTIL(optiga_util_write_data(optiga_shell_bench_util,
+                                                          OPTIGA_SHELL_BENCH_DATA_OID,
+                                                          OPTIGA_UTIL_ERASE_AND_WRITE,
+                                                          0,
+                                                          optiga_shell_bench_data,
+                                                          32)));
+}
+
+static const optiga_shell_bench_case_t optiga_shell_bench_cases[] =
+{
+    {"random",      NULL,                           optiga_shell_bench_random,                  FALSE},
+    {"hashsha256",  NULL,                           optiga_shell_bench_hash,                    FALSE},
+    {"ecckeygen",   NULL,                           optiga_shell_bench_ecc_generate_keypair,    FALSE},
+    {"ecdsasign",   optiga_shell_bench_setup_ecdsa, optiga_shell_bench_ecdsa_sign,              TRUE},
+    {"ecdsaverify", optiga_shell_bench_setup_ecdsa, optiga_shell_bench_ecdsa_verify,            TRUE},
+    {"ecdh",        optiga_shell_bench_setup_ecdh,  optiga_shell_bench_ecdh,                    TRUE},
+    {"rsasign",     optiga_shell_bench_setup_rsa,   optiga_shell_bench_rsa_sign,                TRUE},
+    {"hmac",        optiga_shell_bench_setup_hmac,  optiga_shell_bench_hmac,                    TRUE},
+    {"aesecb",      optiga_shell_bench_setup_aes,   optiga_shell_bench_aes_ecb,                 TRUE},
+    {"readdata",    NULL,                           optiga_shell_bench_read_data,               FALSE},
+    {"writedata",   NULL,                           optiga_shell_bench_write_data,              TRUE},
+};
+
+#define OPTIGA_SHELL_BENCH_CASE_COUNT   (sizeof(optiga_shell_bench_cases) / sizeof(optiga_shell_bench_cases[0]))
+
+static int optiga_shell_bench_compare(const void * first, const void * second)
+{
+    uint32_t a = *(const uint32_t *)first;
+    uint32_t b = *(const uint32_t *)second;
+
+    return ((a > b) - (a < b));
+}
+
+/**
+ * Nearest rank percentile of the sorted samples
+ */
+static uint32_t optiga_shell_bench_percentile(uint32_t count, uint32_t percent)
+{
+    uint32_t rank = ((count * percent) + 99U) / 100U;
+
+    return (optiga_shell_bench_samples[(0U == rank) ? 0U : (rank - 1U)]);
+}
+
+static void optiga_shell_bench_print(const char_t * name,
+                                     uint32_t iterations,
+                                     uint32_t warmup,
+                                     const optiga_shell_wait_stats_t * p_wait_stats,
+                                     optiga_lib_status_t return_status,
+                                     uint8_t format,
+                                     bool_t first)
+{
+    static const char_t * const wait_modes[] = {"sleep", "spin"};
+    char_t line[280];
+    uint64_t total_us = 0;
+    uint32_t min_us = 0;
+    uint32_t mean_us = 0;
+    uint32_t p50_us = 0;
+    uint32_t p99_us = 0;
+    uint32_t max_us = 0;
+    uint32_t idle_permille = 0;
+    uint32_t energy_nj = 0;
+    uint32_t index;
+
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        qsort(optiga_shell_bench_samples, iterations, sizeof(optiga_shell_bench_samples[0]), optiga_shell_bench_compare);
+        for (index = 0; index < iterations; index++)
+        {
+            total_us += optiga_shell_bench_samples[index];
+        }
+        min_us = optiga_shell_bench_samples[0];
+        mean_us = (uint32_t)(total_us / iterations);
+        p50_us = optiga_shell_bench_percentile(iterations, 50);
+        p99_us = optiga_shell_bench_percentile(iterations, 99);
+        max_us = optiga_shell_bench_samples[iterations - 1U];
+        if ((0U != p_wait_stats->wait_us) && (p_wait_stats->busy_us < p_wait_stats->wait_us))
+        {
+            idle_permille = (uint32_t)(((p_wait_stats->wait_us - p_wait_stats->busy_us) * 1000U) / p_wait_stats->wait_us);
+        }
+        energy_nj = (uint32_t)(optiga_shell_wait_get_energy_nj(p_wait_stats) / iterations);
+    }
+
+    if (OPTIGA_SHELL_BENCH_FORMAT_JSON == format)
+    {
+        snprintf(line, sizeof(line),
+                 "%s{\"operation\":\"%s\",\"iterations\":%lu,\"warmup\":%lu,\"min_us\":%lu,\"mean_us\":%lu,"
+                 "\"p50_us\":%lu,\"p99_us\":%lu,\"max_us\":%lu,\"wait\":\"%s\",\"cpu_idle_pct\":%lu.%lu,"
+                 "\"wait_energy_uj\":%lu.%03lu,\"status\":\"0x%04X\"}",
+                 (TRUE == first) ? " " : ",", name, (unsigned long)iterations, (unsigned long)warmup,
+                 (unsigned long)min_us, (unsigned long)mean_us, (unsigned long)p50_us, (unsigned long)p99_us,
+                 (unsigned long)max_us, wait_modes[optiga_shell_wait_get_mode()], (unsigned long)(idle_permille / 10U),
+                 (unsigned long)(idle_permille % 10U), (unsigned long)(energy_nj / 1000U),
+                 (unsigned long)(energy_nj % 1000U), (unsigned int)return_status);
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%s,%lu.%lu,%lu.%03lu,0x%04X",
+                 name, (unsigned long)iterations, (unsigned long)warmup, (unsigned long)min_us,
+                 (unsigned long)mean_us, (unsigned long)p50_us, (unsigned long)p99_us, (unsigned long)max_us,
+                 wait_modes[optiga_shell_wait_get_mode()], (unsigned long)(idle_permille / 10U),
+                 (unsigned long)(idle_permille % 10U), (unsigned long)(energy_nj / 1000U),
+                 (unsigned long)(energy_nj % 1000U), (unsigned int)return_status);
+    }
+    optiga_lib_print_string_with_newline(line);
+}
+
+/**
+ * Prepares, warms up and times one operation, stops at the first failure. The wait statistics
+ * cover the timed runs only.
+ */
+static optiga_lib_status_t optiga_shell_bench_case(const optiga_shell_bench_case_t * bench_case,
+                                                   uint32_t iterations,
+                                                   uint32_t warmup,
+                                                   optiga_shell_wait_stats_t * p_wait_stats)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    uint32_t start_us;
+    uint32_t index;
+
+    if (NULL != bench_case->setup)
+    {
+        return_status = bench_case->setup();
+    }
+    for (index = 0; (OPTIGA_LIB_SUCCESS == return_status) && (index < warmup); index++)
+    {
+        return_status = bench_case->operation();
+    }
+    optiga_shell_wait_take_stats(p_wait_stats);
+    for (index = 0; (OPTIGA_LIB_SUCCESS == return_status) && (index < iterations); index++)
+    {
+        start_us = pal_os_timer_get_time_in_microseconds();
+        return_status = bench_case->operation();
+        optiga_shell_bench_samples[index] = pal_os_timer_get_time_in_microseconds() - start_us;
+    }
+    optiga_shell_wait_take_stats(p_wait_stats);
+    return (return_status);
+}
+
+void optiga_shell_cmd_bench(optiga_shell_args_t * p_args)
+{
+    static const optiga_shell_args_choice_t formats[] =
+    {
+        {"csv",     OPTIGA_SHELL_BENCH_FORMAT_CSV},
+        {"json",    OPTIGA_SHELL_BENCH_FORMAT_JSON},
+    };
+    static const optiga_shell_args_choice_t wait_modes[] =
+    {
+        {"sleep",   OPTIGA_SHELL_WAIT_SLEEP},
+        {"spin",    OPTIGA_SHELL_WAIT_SPIN},
+    };
+    static const optiga_shell_args_choice_t nvm_modes[] =
+    {
+        {"off",     FALSE},
+        {"on",      TRUE},
+    };
+    optiga_shell_wait_stats_t wait_stats;
+    uint8_t previous_wait_mode = optiga_shell_wait_get_mode();
+    uint32_t wait_mode;
+    optiga_shell_args_choice_t operations[OPTIGA_SHELL_BENCH_CASE_COUNT + 1U];
+    optiga_lib_status_t return_status;
+    uint32_t operation;
+    uint32_t iterations;
+    uint32_t warmup;
+    uint32_t format;
+    uint32_t nvm;
+    uint32_t index;
+    bool_t first = TRUE;
+
+    for (index = 0; index < OPTIGA_SHELL_BENCH_CASE_COUNT; index++)
+    {
+        operations[index].name = optiga_shell_bench_cases[index].name;
+        operations[index].value = index;
+    }
+    operations[index].name = "all";
+    operations[index].value = index;
+
+    if ((FALSE == optiga_shell_args_get_choice(p_args, "op", operations, (uint8_t)(OPTIGA_SHELL_BENCH_CASE_COUNT + 1U),
+                                               OPTIGA_SHELL_BENCH_CASE_COUNT, &operation)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "iterations", OPTIGA_SHELL_BENCH_DEFAULT_ITERATIONS, 1,
+                                               OPTIGA_SHELL_BENCH_MAX_ITERATIONS, &iterations)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "warmup", OPTIGA_SHELL_BENCH_DEFAULT_WARMUP, 0,
+                                               OPTIGA_SHELL_BENCH_MAX_ITERATIONS, &warmup)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "format", formats, (uint8_t)(sizeof(formats) / sizeof(formats[0])),
+                                               OPTIGA_SHELL_BENCH_FORMAT_CSV, &format)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "wait", wait_modes, (uint8_t)(sizeof(wait_modes) / sizeof(wait_modes[0])),
+                                               OPTIGA_SHELL_WAIT_SLEEP, &wait_mode)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "nvm", nvm_modes, (uint8_t)(sizeof(nvm_modes) / sizeof(nvm_modes[0])),
+                                               FALSE, &nvm)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    if ((OPTIGA_SHELL_BENCH_CASE_COUNT != operation) && (FALSE == nvm) &&
+        (TRUE == optiga_shell_bench_cases[operation].writes_nvm))
+    {
+        optiga_lib_print_string_with_newline("This operation writes to NVM, add --nvm on to run it");
+        return;
+    }
+
+    for (index = 0; index < sizeof(optiga_shell_bench_data); index++)
+    {
+        optiga_shell_bench_data[index] = (uint8_t)index;
+    }
+    optiga_shell_wait_set_mode((uint8_t)wait_mode);
+    /* The key generation case uses a session context */
+    optiga_shell_bench_crypt = optiga_shell_pool_get_session_crypt(&optiga_shell_bench_crypt_request);
+    optiga_shell_bench_util = optiga_shell_pool_get_util(&optiga_shell_bench_util_request);
+
+    if (OPTIGA_SHELL_BENCH_FORMAT_JSON == format)
+    {
+        optiga_lib_print_string_with_newline("[");
+    }
+    else
+    {
+        optiga_lib_print_string_with_newline("operation,iterations,warmup,min_us,mean_us,p50_us,p99_us,max_us,"
+                                             "wait,cpu_idle_pct,wait_energy_uj,status");
+    }
+    for (index = 0; index < OPTIGA_SHELL_BENCH_CASE_COUNT; index++)
+    {
+        if (((operation != index) && (OPTIGA_SHELL_BENCH_CASE_COUNT != operation)) ||
+            ((FALSE == nvm) && (TRUE == optiga_shell_bench_cases[index].writes_nvm)))
+        {
+            continue;
+        }
+        if ((NULL == optiga_shell_bench_crypt) || (NULL == optiga_shell_bench_util))
+        {
+            return_status = OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT;
+        }
+        else
+        {
+            return_status = optiga_shell_bench_case(&optiga_shell_bench_cases[index], iterations, warmup, &wait_stats);
+        }
+        optiga_shell_bench_print(optiga_shell_bench_cases[index].name, iterations, warmup, &wait_stats,
+                                 return_status, (uint8_t)format, first);
+        first = FALSE;
+    }
+    if (OPTIGA_SHELL_BENCH_FORMAT_JSON == format)
+    {
+        optiga_lib_print_string_with_newline("]");
+    }
+
+    if (NULL != optiga_shell_bench_util)
+    {
+        (void)optiga_shell_pool_put_util(optiga_shell_bench_util);
+        optiga_shell_bench_util = NULL;
+    }
+    if (NULL != optiga_shell_bench_crypt)
+    {
+        (void)optiga_shell_pool_put_crypt(optiga_shell_bench_crypt);
+        optiga_shell_bench_crypt = NULL;
+    }
+    optiga_shell_wait_set_mode(previous_wait_mode);
+}
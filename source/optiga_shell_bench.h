@@ -0,0 +1,87 @@
+/******************************************************************************
+* File Name:   optiga_shell_bench.h
+*
+* Description: Latency benchmark of OPTIGA operations for the shell
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_BENCH_H_
+#define _OPTIGA_SHELL_BENCH_H_
+
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Largest number of timed runs per operation, each sample takes 4 bytes of RAM */
+#define OPTIGA_SHELL_BENCH_MAX_ITERATIONS       (1000U)
+
+/** @brief Default number of timed runs per operation */
+#define OPTIGA_SHELL_BENCH_DEFAULT_ITERATIONS   (100U)
+
+/** @brief Default number of untimed runs per operation before the timed runs */
+#define OPTIGA_SHELL_BENCH_DEFAULT_WARMUP       (3U)
+
+/** @brief Argument usage of the bench command, as shown by help */
+#define OPTIGA_SHELL_BENCH_USAGE                "[--op <operation>|all] [--iterations <n>] [--warmup <n>] [--format csv|json]" \
+                                                " [--wait sleep|spin] [--nvm on|off]"
+
+/**
+ * @brief Measures the latency distribution of OPTIGA operations.
+ *
+ * Every operation is prepared once (key generation, metadata and secret writes), run
+ * --warmup times and then timed --iterations times. Only the OPTIGA call itself is inside the
+ * timed region, without logging or delays. One line per operation with the min, mean, p50,
+ * p99 and max time in microseconds is printed as CSV (default) or JSON, together with the share
+ * of the completion waits the core was idle and the estimated energy it spent waiting per
+ * operation. --wait spin polls the completion instead of sleeping, to compare both.
+ *
+ * Operations whose setup or timed call writes data objects or keys to NVM (ecdsasign,
+ * ecdsaverify, ecdh, rsasign, hmac, aesecb and writedata) only run with --nvm on, to spare the
+ * NVM of the device and the keys in its slots. Without it, all runs random, hashsha256,
+ * ecckeygen (session context) and readdata. The shell opens the application before the command runs.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_bench(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_BENCH_H_ */
@@ -0,0 +1,442 @@
+/******************************************************************************
+* File Name:   optiga_shell_cbc.c
+*
+* Description: Streaming AES-CBC encryption and decryption of large payloads on OPTIGA
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_cbc.h"
+#include "optiga_shell_pool.h"
+
+/** @brief Key update of the symmetric examples, see example_optiga_crypt_symmetric_generate_key.c */
+extern optiga_lib_status_t generate_symmetric_key(void);
+
+/** @brief Payload of optiga --cbcbench with room for a padding block, and the plain text to compare with */
+static uint8_t optiga_shell_cbc_bench_data[OPTIGA_SHELL_CBC_BENCH_MAX_SIZE + OPTIGA_SHELL_CBC_BLOCK_SIZE];
+static uint8_t optiga_shell_cbc_bench_plain[OPTIGA_SHELL_CBC_BENCH_MAX_SIZE];
+
+/**
+ * Ends the stream, the crypt instance goes back to the pool. A sequence left open by an error
+ * is closed first, and the instance is destroyed.
+ */
+static void optiga_shell_cbc_end(optiga_shell_cbc_t * p_cbc)
+{
+    uint8_t block[OPTIGA_SHELL_CBC_BLOCK_SIZE];
+    uint32_t block_length = sizeof(block);
+    optiga_lib_status_t return_status;
+
+    if (NULL == p_cbc->me)
+    {
+        return;
+    }
+    if (FALSE == p_cbc->open)
+    {
+        (void)optiga_shell_pool_put_crypt(p_cbc->me);
+        p_cbc->me = NULL;
+        return;
+    }
+
+    /*
+     * The stream already failed, the status and output of the closing final are dropped
+     */
+    memset(block, 0, sizeof(block));
+    optiga_shell_request_start(&p_cbc->request);
+    return_status = (TRUE == p_cbc->encrypt) ?
+        optiga_crypt_symmetric_encrypt_final(p_cbc->me, block, sizeof(block), block, &block_length) :
+        optiga_crypt_symmetric_decrypt_final(p_cbc->me, block, sizeof(block), block, &block_length);
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        (void)optiga_shell_request_wait(&p_cbc->request);
+    }
+    memset(block, 0, sizeof(block));
+    p_cbc->open = FALSE;
+    (void)optiga_shell_pool_discard_crypt(p_cbc->me);
+    p_cbc->me = NULL;
+}
+
+/**
+ * Sends one chunk as start, continue or final command, or as one shot if it is the whole stream.
+ */
+static optiga_lib_status_t optiga_shell_cbc_send(optiga_shell_cbc_t * p_cbc,
+                                                 uint8_t * p_chunk,
+                                                 uint32_t length,
+                                                 bool_t last,
+                                                 uint32_t * p_output_length)
+{
+    optiga_lib_status_t return_status;
+
+    optiga_shell_request_start(&p_cbc->request);
+    if ((FALSE == p_cbc->started) && (TRUE == last))
+    {
+        return_status = (TRUE == p_cbc->encrypt) ?
+            optiga_crypt_symmetric_encrypt(p_cbc->me, OPTIGA_SYMMETRIC_CBC, p_cbc->key_oid, p_chunk, length,
+                                           p_cbc->iv, sizeof(p_cbc->iv), NULL, 0, p_chunk, p_output_length) :
+            optiga_crypt_symmetric_decrypt(p_cbc->me, OPTIGA_SYMMETRIC_CBC, p_cbc->key_oid, p_chunk, length,
+                                           p_cbc->iv, sizeof(p_cbc->iv), NULL, 0, p_chunk, p_output_length);
+    }
+    else if (FALSE == p_cbc->started)
+    {
+        return_status = (TRUE == p_cbc->encrypt) ?
+            optiga_crypt_symmetric_encrypt_start(p_cbc->me, OPTIGA_SYMMETRIC_CBC, p_cbc->key_oid, p_chunk, length,
+                                                 p_cbc->iv, sizeof(p_cbc->iv), NULL, 0, 0, p_chunk, p_output_length) :
+            optiga_crypt_symmetric_decrypt_start(p_cbc->me, OPTIGA_SYMMETRIC_CBC, p_cbc->key_oid, p_chunk, length,
+                                                 p_cbc->iv, sizeof(p_cbc->iv), NULL, 0, 0, p_chunk, p_output_length);
+    }
+    else if (TRUE == last)
+    {
+        return_status = (TRUE == p_cbc->encrypt) ?
+            optiga_crypt_symmetric_encrypt_final(p_cbc->me, p_chunk, length, p_chunk, p_output_length) :
+            optiga_crypt_symmetric_decrypt_final(p_cbc->me, p_chunk, length, p_chunk, p_output_length);
+    }
+    else
+    {
+        return_status = (TRUE == p_cbc->encrypt) ?
+            optiga_crypt_symmetric_encrypt_continue(p_cbc->me, p_chunk, length, p_chunk, p_output_length) :
+            optiga_crypt_symmetric_decrypt_continue(p_cbc->me, p_chunk, length, p_chunk, p_output_length);
+    }
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        p_cbc->open = (TRUE == last) ? FALSE : TRUE;
+        p_cbc->started = TRUE;
+        p_cbc->commands++;
+    }
+    return (return_status);
+}
+
+/**
+ * Returns the length of the PKCS#7 padding ending the block, 0 if it is not valid.
+ */
+static uint32_t optiga_shell_cbc_padding_length(const uint8_t * p_block)
+{
+    uint8_t pad = p_block[OPTIGA_SHELL_CBC_BLOCK_SIZE - 1U];
+    uint8_t mismatch = 0;
+    uint32_t index;
+
+    if ((0U == pad) || (OPTIGA_SHELL_CBC_BLOCK_SIZE < pad))
+    {
+        return (0);
+    }
+    for (index = OPTIGA_SHELL_CBC_BLOCK_SIZE - pad; index < OPTIGA_SHELL_CBC_BLOCK_SIZE; index++)
+    {
+        mismatch |= (uint8_t)(p_block[index] ^ pad);
+    }
+    return ((0U == mismatch) ? pad : 0U);
+}
+
+/**
+ * Runs the data through OPTIGA chunk by chunk, the last chunk of a final as final command.
+ * The sink takes the output of a chunk while OPTIGA processes the next one.
+ */
+static optiga_lib_status_t optiga_shell_cbc_process(optiga_shell_cbc_t * p_cbc,
+                                                    uint8_t * p_data,
+                                                    uint32_t length,
+                                                    bool_t last)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    optiga_lib_status_t sink_status;
+    const uint8_t * p_pending = NULL;
+    uint32_t pending_length = 0;
+    uint32_t offset = 0;
+    uint32_t chunk_length;
+    uint32_t output_length;
+    uint32_t pad_length;
+    bool_t last_chunk;
+
+    /*
+     * A final sends a command even without data, it ends the sequence on OPTIGA
+     */
+    while ((offset < length) || ((TRUE == last) && (TRUE == p_cbc->started) && (0U == offset)))
+    {
+        chunk_length = ((length - offset) < p_cbc->chunk_size) ? (length - offset) : p_cbc->chunk_size;
+        last_chunk = ((TRUE == last) && ((offset + chunk_length) == length)) ? TRUE : FALSE;
+        output_length = chunk_length;
+        return_status = optiga_shell_cbc_send(p_cbc, &p_data[offset], chunk_length, last_chunk, &output_length);
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        sink_status = OPTIGA_LIB_SUCCESS;
+        if ((NULL != p_cbc->sink) && (0U != pending_length))
+        {
+            sink_status = p_cbc->sink(p_cbc->p_sink_context, p_pending, pending_length);
+        }
+        return_status = optiga_shell_request_wait(&p_cbc->request);
+        return_status = (OPTIGA_LIB_SUCCESS != return_status) ? return_status : sink_status;
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        if (output_length != chunk_length)
+        {
+            return_status = OPTIGA_SHELL_CBC_ERROR_LENGTH;
+            break;
+        }
+        if ((TRUE == last_chunk) && (FALSE == p_cbc->encrypt) &&
+            (OPTIGA_SHELL_CBC_PADDING_PKCS7 == p_cbc->padding))
+        {
+            pad_length = optiga_shell_cbc_padding_length(&p_data[length - OPTIGA_SHELL_CBC_BLOCK_SIZE]);
+            if (0U == pad_length)
+            {
+                return_status = OPTIGA_SHELL_CBC_ERROR_PADDING;
+                break;
+            }
+            output_length -= pad_length;
+        }
+        p_pending = &p_data[offset];
+        pending_length = output_length;
+        p_cbc->output_length += output_length;
+        offset += chunk_length;
+        if (TRUE == last_chunk)
+        {
+            break;
+        }
+    }
+    if ((OPTIGA_LIB_SUCCESS == return_status) && (NULL != p_cbc->sink) && (0U != pending_length))
+    {
+        return_status = p_cbc->sink(p_cbc->p_sink_context, p_pending, pending_length);
+    }
+    return (return_status);
+}
+
+optiga_lib_status_t optiga_shell_cbc_start(optiga_shell_cbc_t * p_cbc,
+                                           bool_t encrypt,
+                                           optiga_key_id_t key_oid,
+                                           const uint8_t * p_iv,
+                                           uint8_t padding,
+                                           uint32_t chunk_size,
+                                           optiga_shell_cbc_sink_t sink,
+                                           void * p_sink_context)
+{
+    memset(p_cbc, 0, sizeof(*p_cbc));
+    if (0U == chunk_size)
+    {
+        chunk_size = OPTIGA_SHELL_CBC_CHUNK_SIZE;
+    }
+    if ((0U != (chunk_size % OPTIGA_SHELL_CBC_BLOCK_SIZE)) || (OPTIGA_SHELL_CBC_CHUNK_SIZE < chunk_size))
+    {
+        return (OPTIGA_SHELL_CBC_ERROR_LENGTH);
+    }
+    p_cbc->me = optiga_shell_pool_get_crypt(&p_cbc->request);
+    if (NULL == p_cbc->me)
+    {
+        return (OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT);
+    }
+    p_cbc->sink = sink;
+    p_cbc->p_sink_context = p_sink_context;
+    p_cbc->key_oid = key_oid;
+    memcpy(p_cbc->iv, p_iv, sizeof(p_cbc->iv));
+    p_cbc->chunk_size = chunk_size;
+    p_cbc->encrypt = encrypt;
+    p_cbc->padding = padding;
+
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_shell_cbc_update(optiga_shell_cbc_t * p_cbc, uint8_t * p_data, uint32_t length)
+{
+    optiga_lib_status_t return_status = OPTIGA_SHELL_CBC_ERROR_LENGTH;
+
+    if (0U == (length % OPTIGA_SHELL_CBC_BLOCK_SIZE))
+    {
+        return_status = optiga_shell_cbc_process(p_cbc, p_data, length, FALSE);
+    }
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        optiga_shell_cbc_end(p_cbc);
+    }
+    return (return_status);
+}
+
+optiga_lib_status_t optiga_shell_cbc_final(optiga_shell_cbc_t * p_cbc,
+                                           uint8_t * p_data,
+                                           uint32_t length,
+                                           uint32_t buffer_length,
+                                           uint32_t * p_output_length)
+{
+    optiga_lib_status_t return_status = OPTIGA_SHELL_CBC_ERROR_LENGTH;
+    uint32_t output_length = p_cbc->output_length;
+    uint32_t pad_length = 0;
+
+    do
+    {
+        if ((TRUE == p_cbc->encrypt) && (OPTIGA_SHELL_CBC_PADDING_PKCS7 == p_cbc->padding))
+        {
+            pad_length = OPTIGA_SHELL_CBC_BLOCK_SIZE - (length % OPTIGA_SHELL_CBC_BLOCK_SIZE);
+            if ((length + pad_length) > buffer_length)
+            {
+                break;
+            }
+            memset(&p_data[length], (int)pad_length, pad_length);
+        }
+        else if ((0U != (length % OPTIGA_SHELL_CBC_BLOCK_SIZE)) ||
+                 ((FALSE == p_cbc->encrypt) && (OPTIGA_SHELL_CBC_PADDING_PKCS7 == p_cbc->padding) &&
+                  (0U == length)))
+        {
+            break;
+        }
+        return_status = optiga_shell_cbc_process(p_cbc, p_data, length + pad_length, TRUE);
+    } while (FALSE);
+    optiga_shell_cbc_end(p_cbc);
+
+    if (NULL != p_output_length)
+    {
+        *p_output_length = (OPTIGA_LIB_SUCCESS == return_status) ? (p_cbc->output_length - output_length) : 0U;
+    }
+    return (return_status);
+}
+
+void optiga_shell_cbc_abort(optiga_shell_cbc_t * p_cbc)
+{
+    optiga_shell_cbc_end(p_cbc);
+}
+
+/**
+ * Encrypts or decrypts the bench payload with one chunk size, returns the elapsed time.
+ */
+static optiga_lib_status_t optiga_shell_cbc_bench_run(bool_t encrypt,
+                                                      uint8_t padding,
+                                                      uint32_t chunk_size,
+                                                      uint32_t length,
+                                                      uint32_t * p_output_length,
+                                                      uint32_t * p_commands,
+                                                      uint32_t * p_elapsed_us)
+{
+    static const uint8_t iv[OPTIGA_SHELL_CBC_BLOCK_SIZE] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                                            0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+    optiga_shell_cbc_t cbc;
+    optiga_lib_status_t return_status;
+    uint32_t start_us;
+
+    start_us = pal_os_timer_get_time_in_microseconds();
+    return_status = optiga_shell_cbc_start(&cbc, encrypt, OPTIGA_KEY_ID_SECRET_BASED, iv, padding, chunk_size,
+                                           NULL, NULL);
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        return_status = optiga_shell_cbc_final(&cbc, optiga_shell_cbc_bench_data, length,
+                                               sizeof(optiga_shell_cbc_bench_data), p_output_length);
+    }
+    *p_elapsed_us = pal_os_timer_get_time_in_microseconds() - start_us;
+    *p_commands = cbc.commands;
+
+    return (return_status);
+}
+
+void optiga_shell_cmd_cbcbench(optiga_shell_args_t * p_args)
+{
+    static const uint32_t chunk_sizes[] = {OPTIGA_SHELL_CBC_BLOCK_SIZE, 64, 256, 512, 1024, OPTIGA_SHELL_CBC_CHUNK_SIZE};
+    static const optiga_shell_args_choice_t paddings[] =
+    {
+        {"none",    OPTIGA_SHELL_CBC_PADDING_NONE},
+        {"pkcs7",   OPTIGA_SHELL_CBC_PADDING_PKCS7},
+    };
+    optiga_lib_status_t return_status;
+    uint32_t size;
+    uint32_t padding;
+    uint32_t size_index;
+    uint32_t cipher_length = 0;
+    uint32_t plain_length = 0;
+    uint32_t encrypt_commands = 0;
+    uint32_t decrypt_commands = 0;
+    uint32_t encrypt_us = 0;
+    uint32_t decrypt_us = 0;
+    uint64_t encrypt_rate;
+    uint64_t decrypt_rate;
+    uint32_t index;
+    bool_t match;
+    char_t line[160];
+
+    if ((FALSE == optiga_shell_args_get_number(p_args, "size", OPTIGA_SHELL_CBC_BENCH_DEFAULT_SIZE, 1,
+                                               OPTIGA_SHELL_CBC_BENCH_MAX_SIZE, &size)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "padding", paddings,
+                                               (uint8_t)(sizeof(paddings) / sizeof(paddings[0])),
+                                               OPTIGA_SHELL_CBC_PADDING_NONE, &padding)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    if ((OPTIGA_SHELL_CBC_PADDING_NONE == padding) && (0U != (size % OPTIGA_SHELL_CBC_BLOCK_SIZE)))
+    {
+        optiga_shell_args_print_error("Without padding, expecting a multiple of 16 bytes for", "size");
+        return;
+    }
+
+    for (index = 0; index < size; index++)
+    {
+        optiga_shell_cbc_bench_plain[index] = (uint8_t)(index * 7U);
+    }
+    return_status = generate_symmetric_key();
+
+    optiga_lib_print_string_with_newline("chunk_size,bytes,encrypt_commands,encrypt_us,encrypt_mb_per_s,"
+                                         "decrypt_commands,decrypt_us,decrypt_mb_per_s,match,status");
+    for (size_index = 0; size_index < (sizeof(chunk_sizes) / sizeof(chunk_sizes[0])); size_index++)
+    {
+        memcpy(optiga_shell_cbc_bench_data, optiga_shell_cbc_bench_plain, size);
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            return_status = optiga_shell_cbc_bench_run(TRUE, (uint8_t)padding, chunk_sizes[size_index], size,
+                                                       &cipher_length, &encrypt_commands, &encrypt_us);
+        }
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            return_status = optiga_shell_cbc_bench_run(FALSE, (uint8_t)padding, chunk_sizes[size_index],
+                                                       cipher_length, &plain_length, &decrypt_commands,
+                                                       &decrypt_us);
+        }
+        match = ((OPTIGA_LIB_SUCCESS == return_status) && (plain_length == size) &&
+                 (0 == memcmp(optiga_shell_cbc_bench_data, optiga_shell_cbc_bench_plain, size))) ? TRUE : FALSE;
+
+        /*
+         * Bytes per second is MB/s with six decimals
+         */
+        encrypt_rate = (0U != encrypt_us) ? (((uint64_t)size * 1000000U) / encrypt_us) : 0U;
+        decrypt_rate = (0U != decrypt_us) ? (((uint64_t)size * 1000000U) / decrypt_us) : 0U;
+        (void)snprintf(line, sizeof(line), "%lu,%lu,%lu,%lu,%lu.%06lu,%lu,%lu,%lu.%06lu,%s,0x%04X",
+                       (unsigned long)chunk_sizes[size_index], (unsigned long)size,
+                       (unsigned long)encrypt_commands, (unsigned long)encrypt_us,
+                       (unsigned long)(encrypt_rate / 1000000U), (unsigned long)(encrypt_rate % 1000000U),
+                       (unsigned long)decrypt_commands, (unsigned long)decrypt_us,
+                       (unsigned long)(decrypt_rate / 1000000U), (unsigned long)(decrypt_rate % 1000000U),
+                       (TRUE == match) ? "yes" : "no", (unsigned int)return_status);
+        optiga_lib_print_string_with_newline(line);
+    }
+}
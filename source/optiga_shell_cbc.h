@@ -0,0 +1,212 @@
+/******************************************************************************
+* File Name:   optiga_shell_cbc.h
+*
+* Description: Streaming AES-CBC encryption and decryption of large payloads on OPTIGA
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_CBC_H_
+#define _OPTIGA_SHELL_CBC_H_
+
+#include "optiga/optiga_crypt.h"
+#include "optiga_shell_args.h"
+#include "optiga_shell_request.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OPTIGA_SHELL_CBC_BLOCK_SIZE             (16U)
+
+/**
+ * @brief Bytes of a symmetric encrypt or decrypt command besides the data: command header,
+ * data TLV and the IV TLV of the first command
+ */
+#define OPTIGA_SHELL_CBC_APDU_OVERHEAD          (4U + 3U + (3U + OPTIGA_SHELL_CBC_BLOCK_SIZE))
+
+/**
+ * @brief Largest data of one command, whole blocks filling the communication buffer, so the
+ * library never splits a chunk
+ */
+#ifndef OPTIGA_SHELL_CBC_CHUNK_SIZE
+#define OPTIGA_SHELL_CBC_CHUNK_SIZE             (((OPTIGA_MAX_COMMS_BUFFER_SIZE - OPTIGA_SHELL_CBC_APDU_OVERHEAD) / \
+                                                  OPTIGA_SHELL_CBC_BLOCK_SIZE) * OPTIGA_SHELL_CBC_BLOCK_SIZE)
+#endif
+
+/** @brief Paddings of #optiga_shell_cbc_start */
+/// The data is a multiple of the block size
+#define OPTIGA_SHELL_CBC_PADDING_NONE           (0U)
+/// PKCS#7, 1 to 16 bytes of the pad length are added on encryption and checked on decryption
+#define OPTIGA_SHELL_CBC_PADDING_PKCS7          (1U)
+
+/** @brief The data is not a multiple of the block size or does not fit the buffer with padding */
+#define OPTIGA_SHELL_CBC_ERROR_LENGTH           (0xF601)
+/** @brief The padding of the decrypted data is not valid */
+#define OPTIGA_SHELL_CBC_ERROR_PADDING          (0xF602)
+
+/** @brief Default and largest payload of optiga --cbcbench, in bytes */
+#define OPTIGA_SHELL_CBC_BENCH_DEFAULT_SIZE     (8192U)
+#define OPTIGA_SHELL_CBC_BENCH_MAX_SIZE         (16384U)
+
+/** @brief Argument usage of the cbcbench command, as shown by help */
+#define OPTIGA_SHELL_CBC_BENCH_USAGE            "[--size <bytes>] [--padding none|pkcs7]"
+
+/**
+ * @brief Takes the output of a chunk, right where OPTIGA wrote it. Called while OPTIGA already
+ * processes the next chunk. An error ends the stream.
+ */
+typedef optiga_lib_status_t (*optiga_shell_cbc_sink_t)(void * p_context, const uint8_t * p_data, uint32_t length);
+
+/** @brief State of one CBC stream, owned by the caller from start to final */
+typedef struct optiga_shell_cbc
+{
+    optiga_crypt_t * me;
+    optiga_shell_request_t request;
+    optiga_shell_cbc_sink_t sink;
+    void * p_sink_context;
+    optiga_key_id_t key_oid;
+    uint8_t iv[OPTIGA_SHELL_CBC_BLOCK_SIZE];
+    uint32_t chunk_size;
+    bool_t encrypt;
+    uint8_t padding;
+    /// The first command was sent, the next ones continue it
+    bool_t started;
+    /// A start or continue command was sent and no final yet, OPTIGA holds the sequence
+    bool_t open;
+    /// Commands sent and bytes of output so far
+    uint32_t commands;
+    uint32_t output_length;
+} optiga_shell_cbc_t;
+
+/**
+ * @brief Starts an AES-CBC encryption or decryption of a stream of any length.
+ *
+ * No command is sent yet, the data of the first update or final goes with the start command.
+ * The stream takes a crypt instance from the pool until #optiga_shell_cbc_final or
+ * #optiga_shell_cbc_abort, or until an update fails.
+ *
+ * @param[out] p_cbc           State of the stream
+ * @param[in]  encrypt         TRUE to encrypt, FALSE to decrypt
+ * @param[in]  key_oid         AES key, e.g. OPTIGA_KEY_ID_SECRET_BASED
+ * @param[in]  p_iv            Initialization vector of #OPTIGA_SHELL_CBC_BLOCK_SIZE bytes
+ * @param[in]  padding         #OPTIGA_SHELL_CBC_PADDING_NONE or #OPTIGA_SHELL_CBC_PADDING_PKCS7
+ * @param[in]  chunk_size      Data per command, whole blocks up to #OPTIGA_SHELL_CBC_CHUNK_SIZE,
+ *                             0 for #OPTIGA_SHELL_CBC_CHUNK_SIZE
+ * @param[in]  sink            Called with the output of each chunk, NULL to only write in place
+ * @param[in]  p_sink_context  Passed to the sink
+ *
+ * @retval #OPTIGA_LIB_SUCCESS                  The stream is started
+ * @retval #OPTIGA_SHELL_CBC_ERROR_LENGTH       The chunk size is not valid
+ * @retval #OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT  The pool has no crypt instance left
+ */
+optiga_lib_status_t optiga_shell_cbc_start(optiga_shell_cbc_t * p_cbc,
+                                           bool_t encrypt,
+                                           optiga_key_id_t key_oid,
+                                           const uint8_t * p_iv,
+                                           uint8_t padding,
+                                           uint32_t chunk_size,
+                                           optiga_shell_cbc_sink_t sink,
+                                           void * p_sink_context);
+
+/**
+ * @brief Encrypts or decrypts whole blocks in place, in chunks of the chunk size.
+ *
+ * OPTIGA receives a chunk before it returns the output, so the output overwrites the input in
+ * the buffer of the caller without any copy on the host.
+ *
+ * @param[in,out] p_cbc     State of the stream
+ * @param[in,out] p_data    Data, replaced by the output
+ * @param[in]     length    Length of the data, a multiple of #OPTIGA_SHELL_CBC_BLOCK_SIZE
+ *
+ * @retval #OPTIGA_LIB_SUCCESS              The data is processed
+ * @retval #OPTIGA_SHELL_CBC_ERROR_LENGTH   The length is not a multiple of the block size
+ * @retval Error of optiga_crypt or of the sink otherwise, the stream is ended as by
+ *         #optiga_shell_cbc_abort
+ */
+optiga_lib_status_t optiga_shell_cbc_update(optiga_shell_cbc_t * p_cbc, uint8_t * p_data, uint32_t length);
+
+/**
+ * @brief Processes the last data of the stream in place and ends it.
+ *
+ * An encryption with #OPTIGA_SHELL_CBC_PADDING_PKCS7 takes any length and writes the padding
+ * after the data, the buffer needs room for up to one more block. A decryption with it takes
+ * at least one block and leaves the padding out of the output length and the sink.
+ *
+ * @param[in,out] p_cbc            State of the stream
+ * @param[in,out] p_data           Data, replaced by the output
+ * @param[in]     length           Length of the data
+ * @param[in]     buffer_length    Size of the buffer at p_data
+ * @param[out]    p_output_length  Bytes of output at p_data, may be NULL
+ *
+ * @retval #OPTIGA_LIB_SUCCESS                  The stream is complete
+ * @retval #OPTIGA_SHELL_CBC_ERROR_LENGTH       The length does not fit the padding or the buffer
+ * @retval #OPTIGA_SHELL_CBC_ERROR_PADDING      The decrypted padding is not valid
+ * @retval Error of optiga_crypt or of the sink otherwise
+ */
+optiga_lib_status_t optiga_shell_cbc_final(optiga_shell_cbc_t * p_cbc,
+                                           uint8_t * p_data,
+                                           uint32_t length,
+                                           uint32_t buffer_length,
+                                           uint32_t * p_output_length);
+
+/**
+ * @brief Ends a stream before its final, e.g. when the input failed. Nothing is done if the
+ * stream already ended.
+ *
+ * If a sequence is open on OPTIGA, it is closed with a final command of one dummy block whose
+ * output is dropped, and the crypt instance is destroyed instead of going back to the pool, so
+ * the next user of the pool does not continue a sequence it did not start.
+ */
+void optiga_shell_cbc_abort(optiga_shell_cbc_t * p_cbc);
+
+/**
+ * @brief Encrypts and decrypts --size bytes in place with the key generated by the symmetric
+ * examples, once per chunk size from one block to #OPTIGA_SHELL_CBC_CHUNK_SIZE.
+ *
+ * Prints one CSV line per chunk size with the commands sent, the time and rate in MB/s of
+ * each direction and whether the decrypted data matches. One block per command is what
+ * example_optiga_crypt_symmetric_encrypt_decrypt_cbc does.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_cbcbench(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_CBC_H_ */
@@ -0,0 +1,684 @@
+/******************************************************************************
+* File Name:   optiga_shell_cmds.c
+*
+* Description: Parameterized crypto and data object commands of the shell. Each
+*              command repeats one OPTIGA operation with the given arguments and
+*              reports the time per operation.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/optiga_util.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_example.h"
+#include "optiga_shell_cmds.h"
+#include "optiga_shell_policy.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_verify.h"
+
+#define OPTIGA_SHELL_CMDS_SHA256_LENGTH         (32U)
+#define OPTIGA_SHELL_CMDS_DEFAULT_DIGEST_LENGTH (32U)
+#define OPTIGA_SHELL_CMDS_MAX_DIGEST_LENGTH     (64U)
+#define OPTIGA_SHELL_CMDS_MAX_RANDOM_LENGTH     (256U)
+#define OPTIGA_SHELL_CMDS_MAX_OID               (0xFFFFU)
+/** @brief oid of a command which names no object, e.g. random; 0 is the session based key id */
+#define OPTIGA_SHELL_CMDS_NO_OID                (0xFFFFFFFFU)
+
+/** @brief An OPTIGA operation to repeat, reading its inputs from optiga_shell_cmds_params */
+typedef optiga_lib_status_t (*optiga_shell_cmds_operation_t)(void);
+
+/** @brief Inputs and result of the running command */
+typedef struct optiga_shell_cmds_params
+{
+    uint32_t oid;
+    uint32_t type;
+    uint32_t option;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t mac_length;
+    uint16_t input_length;
+    uint16_t key_length;
+    uint16_t signature_length;
+    uint16_t output_length;
+    uint8_t input[OPTIGA_SHELL_CMDS_MAX_INPUT_LENGTH];
+    uint8_t key[OPTIGA_SHELL_CMDS_MAX_INPUT_LENGTH];
+    uint8_t signature[OPTIGA_SHELL_CMDS_MAX_INPUT_LENGTH];
+    uint8_t output[OPTIGA_SHELL_CMDS_MAX_OUTPUT_LENGTH];
+} optiga_shell_cmds_params_t;
+
+static optiga_shell_cmds_params_t optiga_shell_cmds_params;
+static optiga_crypt_t * optiga_shell_cmds_crypt = NULL;
+static optiga_util_t * optiga_shell_cmds_util = NULL;
+static optiga_shell_request_t optiga_shell_cmds_crypt_request;
+static optiga_shell_request_t optiga_shell_cmds_util_request;
+
+static const optiga_shell_args_choice_t optiga_shell_cmds_curves[] =
+{
+    {"p256",    OPTIGA_ECC_CURVE_NIST_P_256},
+    {"p384",    OPTIGA_ECC_CURVE_NIST_P_384},
+    {"p521",    OPTIGA_ECC_CURVE_NIST_P_521},
+    {"bp256",   OPTIGA_ECC_CURVE_BRAIN_POOL_P_256R1},
+    {"bp384",   OPTIGA_ECC_CURVE_BRAIN_POOL_P_384R1},
+    {"bp512",   OPTIGA_ECC_CURVE_BRAIN_POOL_P_512R1},
+};
+
+static const optiga_shell_args_choice_t optiga_shell_cmds_rng_types[] =
+{
+    {"trng",    OPTIGA_RNG_TYPE_TRNG},
+    {"drng",    OPTIGA_RNG_TYPE_DRNG},
+};
+
+static const optiga_shell_args_choice_t optiga_shell_cmds_key_usages[] =
+{
+    {"sign",        OPTIGA_KEY_USAGE_SIGN},
+    {"keyagree",    OPTIGA_KEY_USAGE_KEY_AGREEMENT},
+    {"auth",        OPTIGA_KEY_USAGE_AUTHENTICATION},
+};
+
+static const optiga_shell_args_choice_t optiga_shell_cmds_rsa_schemes[] =
+{
+    {"sha256",  OPTIGA_RSASSA_PKCS1_V15_SHA256},
+    {"sha384",  OPTIGA_RSASSA_PKCS1_V15_SHA384},
+    {"sha512",  OPTIGA_RSASSA_PKCS1_V15_SHA512},
+};
+
+static const optiga_shell_args_choice_t optiga_shell_cmds_hmac_types[] =
+{
+    {"sha256",  OPTIGA_HMAC_SHA_256},
+    {"sha384",  OPTIGA_HMAC_SHA_384},
+    {"sha512",  OPTIGA_HMAC_SHA_512},
+};
+
+static const optiga_shell_args_choice_t optiga_shell_cmds_verify_engines[] =
+{
+    {"host",    OPTIGA_SHELL_VERIFY_ENGINE_HOST},
+    {"optiga",  OPTIGA_SHELL_VERIFY_ENGINE_OPTIGA},
+};
+
+static const optiga_shell_args_choice_t optiga_shell_cmds_write_modes[] =
+{
+    {"erase",   OPTIGA_UTIL_ERASE_AND_WRITE},
+    {"write",   OPTIGA_UTIL_WRITE_ONLY},
+};
+
+#define OPTIGA_SHELL_CMDS_CHOICES(choices)  (choices), (uint8_t)(sizeof(choices) / sizeof((choices)[0]))
+
+/**
+ * Runs an asynchronous crypt or util call and waits for its completion
+ */
+#define OPTIGA_SHELL_CMDS_CRYPT(call)   OPTIGA_SHELL_REQUEST_RUN(optiga_shell_cmds_crypt_request, call)
+#define OPTIGA_SHELL_CMDS_UTIL(call)    OPTIGA_SHELL_REQUEST_RUN(optiga_shell_cmds_util_request, call)
+
+/**
+ * Sets the inputs back to their defaults, a command only sets the fields it uses
+ */
+static void optiga_shell_cmds_reset(void)
+{
+    memset(&optiga_shell_cmds_params, 0, sizeof(optiga_shell_cmds_params));
+    optiga_shell_cmds_params.oid = OPTIGA_SHELL_CMDS_NO_OID;
+}
+
+static bool_t optiga_shell_cmds_get_iterations(optiga_shell_args_t * p_args, uint32_t * p_iterations)
+{
+    return (optiga_shell_args_get_number(p_args, "iterations", 1, 1, OPTIGA_SHELL_CMDS_MAX_ITERATIONS, p_iterations));
+}
+
+static bool_t optiga_shell_cmds_get_oid(optiga_shell_args_t * p_args, uint16_t default_oid)
+{
+    return (optiga_shell_args_get_number(p_args, "oid", default_oid, 1, OPTIGA_SHELL_CMDS_MAX_OID,
+                                         &optiga_shell_cmds_params.oid));
+}
+
+static bool_t optiga_shell_cmds_require(const optiga_shell_args_t * p_args, const char_t * p_name)
+{
+    if (FALSE == optiga_shell_args_has(p_args, p_name))
+    {
+        optiga_shell_args_print_error("Missing argument", p_name);
+        return (FALSE);
+    }
+    return (TRUE);
+}
+
+/**
+ * Reads the input of a command either as hex bytes (--<name>) or as a length (--length) of
+ * generated bytes, which allows to sweep input sizes without typing the data.
+ */
+static bool_t optiga_shell_cmds_get_input(optiga_shell_args_t * p_args,
+                                          const char_t * p_name,
+                                          uint16_t default_length,
+                                          uint16_t max_length)
+{
+    uint32_t length;
+    uint16_t index;
+
+    if (TRUE == optiga_shell_args_has(p_args, p_name))
+    {
+        if (TRUE == optiga_shell_args_has(p_args, "length"))
+        {
+            optiga_shell_args_print_error("Use either --length or", p_name);
+            return (FALSE);
+        }
+        return (optiga_shell_args_get_hex(p_args, p_name, optiga_shell_cmds_params.input, max_length,
+                                          &optiga_shell_cmds_params.input_length));
+    }
+    if (FALSE == optiga_shell_args_get_number(p_args, "length", default_length, 1, max_length, &length))
+    {
+        return (FALSE);
+    }
+    for (index = 0; index < length; index++)
+    {
+        optiga_shell_cmds_params.input[index] = (uint8_t)index;
+    }
+    optiga_shell_cmds_params.input_length = (uint16_t)length;
+    return (TRUE);
+}
+
+/**
+ * Repeats the operation, then prints its status, the result of the last run and the timing
+ */
+static void optiga_shell_cmds_run(optiga_shell_cmds_operation_t operation, uint32_t iterations)
+{
+    optiga_lib_status_t return_status = !OPTIGA_LIB_SUCCESS;
+    uint32_t total_us = 0;
+    uint32_t min_us = 0xFFFFFFFFU;
+    uint32_t max_us = 0;
+    uint32_t elapsed_us;
+    uint32_t index;
+    char_t buffer[100];
+
+    do
+    {
+        /* A key in a session context, e.g. --oid 0xE100, keeps the instance out of the pool */
+        optiga_shell_cmds_crypt = OPTIGA_SHELL_POOL_IS_SESSION_OID(optiga_shell_cmds_params.oid) ?
+                                  optiga_shell_pool_get_session_crypt(&optiga_shell_cmds_crypt_request) :
+                                  optiga_shell_pool_get_crypt(&optiga_shell_cmds_crypt_request);
+        optiga_shell_cmds_util = optiga_shell_pool_get_util(&optiga_shell_cmds_util_request);
+        if ((NULL == optiga_shell_cmds_crypt) || (NULL == optiga_shell_cmds_util))
+        {
+            break;
+        }
+
+        for (index = 0; index < iterations; index++)
+        {
+            optiga_shell_cmds_params.output_length = 0;
+            elapsed_us = pal_os_timer_get_time_in_microseconds();
+            return_status = operation();
+            elapsed_us = pal_os_timer_get_time_in_microseconds() - elapsed_us;
+            if (OPTIGA_LIB_SUCCESS != return_status)
+            {
+                break;
+            }
+            total_us += elapsed_us;
+            min_us = (elapsed_us < min_us) ? elapsed_us : min_us;
+            max_us = (elapsed_us > max_us) ? elapsed_us : max_us;
+        }
+    } while (FALSE);
+
+    if (NULL != optiga_shell_cmds_util)
+    {
+        (void)optiga_shell_pool_put_util(optiga_shell_cmds_util);
+        optiga_shell_cmds_util = NULL;
+    }
+    if (NULL != optiga_shell_cmds_crypt)
+    {
+        (void)optiga_shell_pool_put_crypt(optiga_shell_cmds_crypt);
+        optiga_shell_cmds_crypt = NULL;
+    }
+
+    OPTIGA_EXAMPLE_LOG_STATUS(return_status);
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return;
+    }
+    if (0U != optiga_shell_cmds_params.output_length)
+    {
+        OPTIGA_EXAMPLE_LOG_HEX_DATA(optiga_shell_cmds_params.output, optiga_shell_cmds_params.output_length);
+    }
+    sprintf(buffer, "Iterations: %u, input: %u bytes, average: %u usec, min: %u usec, max: %u usec",
+            (unsigned int)iterations, (unsigned int)optiga_shell_cmds_params.input_length,
+            (unsigned int)(total_us / iterations), (unsigned int)min_us, (unsigned int)max_us);
+    OPTIGA_EXAMPLE_LOG_MESSAGE(buffer);
+}
+
+static optiga_lib_status_t optiga_shell_cmds_random(void)
+{
+    optiga_shell_cmds_params.output_length = (uint16_t)optiga_shell_cmds_params.length;
+    return (OPTIGA_SHELL_CMDS_CRYPT(optiga_crypt_random(optiga_shell_cmds_crypt,
+                                                        (optiga_rng_type_t)optiga_shell_cmds_params.type,
+                                                        optiga_shell_cmds_params.output,
+                                                        (uint16_t)optiga_shell_cmds_params.length)));
+}
+
+void optiga_shell_cmd_random(optiga_shell_args_t * p_args)
+{
+    uint32_t iterations;
+
+    optiga_shell_cmds_reset();
+    if ((FALSE == optiga_shell_args_get_number(p_args, "length", 32, 1, OPTIGA_SHELL_CMDS_MAX_RANDOM_LENGTH,
+                                               &optiga_shell_cmds_params.length)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "type", OPTIGA_SHELL_CMDS_CHOICES(optiga_shell_cmds_rng_types),
+                                               OPTIGA_RNG_TYPE_TRNG, &optiga_shell_cmds_params.type)) ||
+        (FALSE == optiga_shell_cmds_get_iterations(p_args, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_cmds_params.input_length = 0;
+    optiga_shell_cmds_run(optiga_shell_cmds_random, iterations);
+}
+
+static optiga_lib_status_t optiga_shell_cmds_hash(void)
+{
+    hash_data_from_host_t host_data;
+    hash_data_in_optiga_t optiga_data;
+    const void * data = &host_data;
+    uint8_t source = OPTIGA_CRYPT_HOST_DATA;
+
+    if (OPTIGA_SHELL_CMDS_NO_OID != optiga_shell_cmds_params.oid)
+    {
+        optiga_data.oid = (uint16_t)optiga_shell_cmds_params.oid;
+        optiga_data.offset = optiga_shell_cmds_params.offset;
+        optiga_data.length = optiga_shell_cmds_params.length;
+        data = &optiga_data;
+        source = OPTIGA_CRYPT_OID_DATA;
+    }
+    else
+    {
+        host_data.buffer = optiga_shell_cmds_params.input;
+        host_data.length = optiga_shell_cmds_params.input_length;
+    }
+    optiga_shell_cmds_params.output_length = OPTIGA_SHELL_CMDS_SHA256_LENGTH;
+    return (OPTIGA_SHELL_CMDS_CRYPT(optiga_crypt_hash(optiga_shell_cmds_crypt,
+                                                      OPTIGA_HASH_TYPE_SHA_256, source, data,
+                                                      optiga_shell_cmds_params.output)));
+}
+
+void optiga_shell_cmd_hash(optiga_shell_args_t * p_args)
+{
+    uint32_t iterations;
+    bool_t valid;
+
+    optiga_shell_cmds_reset();
+    if (TRUE == optiga_shell_args_has(p_args, "oid"))
+    {
+        /*
+         * Hash of (a part of) a data object, --length limits the hashed data
+         */
+        valid = ((TRUE == optiga_shell_cmds_get_oid(p_args, 0)) &&
+                 (TRUE == optiga_shell_args_get_number(p_args, "offset", 0, 0, OPTIGA_SHELL_CMDS_MAX_OID,
+                                                       &optiga_shell_cmds_params.offset)) &&
+                 (TRUE == optiga_shell_args_get_number(p_args, "length", OPTIGA_SHELL_CMDS_MAX_OID, 1,
+                                                       OPTIGA_SHELL_CMDS_MAX_OID,
+                                                       &optiga_shell_cmds_params.length)));
+        optiga_shell_cmds_params.input_length = 0;
+    }
+    else
+    {
+        valid = optiga_shell_cmds_get_input(p_args, "data", OPTIGA_SHELL_CMDS_MAX_INPUT_LENGTH / 2U,
+                                            OPTIGA_SHELL_CMDS_MAX_INPUT_LENGTH);
+    }
+    if ((FALSE == valid) ||
+        (FALSE == optiga_shell_cmds_get_iterations(p_args, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_cmds_run(optiga_shell_cmds_hash, iterations);
+}
+
+static optiga_lib_status_t optiga_shell_cmds_ecc_generate_keypair(void)
+{
+    optiga_key_id_t key_id = (optiga_key_id_t)optiga_shell_cmds_params.oid;
+
+    optiga_shell_cmds_params.output_length = sizeof(optiga_shell_cmds_params.output);
+    return (OPTIGA_SHELL_CMDS_CRYPT(optiga_crypt_ecc_generate_keypair(optiga_shell_cmds_crypt,
+                                                                      (optiga_ecc_curve_t)optiga_shell_cmds_params.type,
+                                                                      (uint8_t)optiga_shell_cmds_params.option,
+                                                                      FALSE,
+                                                                      &key_id,
+                                                                      optiga_shell_cmds_params.output,
+                                                                      &optiga_shell_cmds_params.output_length)));
+}
+
+void optiga_shell_cmd_ecc_generate_keypair(optiga_shell_args_t * p_args)
+{
+    uint32_t iterations;
+
+    optiga_shell_cmds_reset();
+    if ((FALSE == optiga_shell_args_get_choice(p_args, "curve", OPTIGA_SHELL_CMDS_CHOICES(optiga_shell_cmds_curves),
+                                               OPTIGA_ECC_CURVE_NIST_P_256, &optiga_shell_cmds_params.type)) ||
+        (FALSE == optiga_shell_cmds_get_oid(p_args, OPTIGA_KEY_ID_E0F1)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "usage", OPTIGA_SHELL_CMDS_CHOICES(optiga_shell_cmds_key_usages),
+                                               OPTIGA_KEY_USAGE_SIGN, &optiga_shell_cmds_params.option)) ||
+        (FALSE == optiga_shell_cmds_get_iterations(p_args, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_cmds_params.input_length = 0;
+    optiga_shell_cmds_run(optiga_shell_cmds_ecc_generate_keypair, iterations);
+}
+
+static optiga_lib_status_t optiga_shell_cmds_ecdsa_sign(void)
+{
+    optiga_shell_cmds_params.output_length = sizeof(optiga_shell_cmds_params.output);
+    return (OPTIGA_SHELL_CMDS_CRYPT(optiga_crypt_ecdsa_sign(optiga_shell_cmds_crypt,
+                                                            optiga_shell_cmds_params.input,
+                                                            (uint8_t)optiga_shell_cmds_params.input_length,
+                                                            (optiga_key_id_t)optiga_shell_cmds_params.oid,
+                                                            optiga_shell_cmds_params.output,
+                                                            &optiga_shell_cmds_params.output_length)));
+}
+
+void optiga_shell_cmd_ecdsa_sign(optiga_shell_args_t * p_args)
+{
+    uint32_t iterations;
+
+    optiga_shell_cmds_reset();
+    if ((FALSE == optiga_shell_cmds_get_oid(p_args, OPTIGA_KEY_ID_E0F0)) ||
+        (FALSE == optiga_shell_cmds_get_input(p_args, "digest", OPTIGA_SHELL_CMDS_DEFAULT_DIGEST_LENGTH,
+                                              OPTIGA_SHELL_CMDS_MAX_DIGEST_LENGTH)) ||
+        (FALSE == optiga_shell_cmds_get_iterations(p_args, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_cmds_run(optiga_shell_cmds_ecdsa_sign, iterations);
+}
+
+static optiga_lib_status_t optiga_shell_cmds_ecdsa_verify(void)
+{
+    public_key_from_host_t public_key;
+    uint16_t public_key_oid = (uint16_t)optiga_shell_cmds_params.oid;
+
+    public_key.public_key = optiga_shell_cmds_params.key;
+    public_key.length = optiga_shell_cmds_params.key_length;
+    public_key.key_type = (uint8_t)optiga_shell_cmds_params.type;
+    if (OPTIGA_SHELL_VERIFY_ENGINE_HOST == optiga_shell_cmds_params.option)
+    {
+        return (optiga_shell_verify_ecdsa(optiga_shell_cmds_params.input,
+                                          (uint8_t)optiga_shell_cmds_params.input_length,
+                                          optiga_shell_cmds_params.signature,
+                                          optiga_shell_cmds_params.signature_length,
+                                          &public_key,
+                                          OPTIGA_SHELL_VERIFY_ENGINE_HOST));
+    }
+    return (OPTIGA_SHELL_CMDS_CRYPT(optiga_crypt_ecdsa_verify(optiga_shell_cmds_crypt,
+                                                              optiga_shell_cmds_params.input,
+                                                              (uint8_t)optiga_shell_cmds_params.input_length,
+                                                              optiga_shell_cmds_params.signature,
+                                                              optiga_shell_cmds_params.signature_length,
+                                                              (0U != public_key_oid) ? OPTIGA_CRYPT_OID_DATA : OPTIGA_CRYPT_HOST_DATA,
+                                                              (0U != public_key_oid) ? (const void *)&public_key_oid :
+                                                                                       (const void *)&public_key)));
+}
+
+void optiga_shell_cmd_ecdsa_verify(optiga_shell_args_t * p_args)
+{
+    uint32_t iterations;
+    bool_t valid;
+
+    optiga_shell_cmds_reset();
+    /*
+     * The certificate of --oid is read by OPTIGA, a public key from the host is verified on the
+     * --engine given
+     */
+    if (TRUE == optiga_shell_args_has(p_args, "oid"))
+    {
+        valid = optiga_shell_cmds_get_oid(p_args, 0);
+        optiga_shell_cmds_params.key_length = 0;
+        optiga_shell_cmds_params.option = OPTIGA_SHELL_VERIFY_ENGINE_OPTIGA;
+    }
+    else
+    {
+        optiga_shell_cmds_params.oid = 0;
+        valid = ((TRUE == optiga_shell_cmds_require(p_args, "pubkey")) &&
+                 (TRUE == optiga_shell_args_get_choice(p_args, "engine",
+                                                       OPTIGA_SHELL_CMDS_CHOICES(optiga_shell_cmds_verify_engines),
+                                                       OPTIGA_SHELL_VERIFY_DEFAULT_ENGINE,
+                                                       &optiga_shell_cmds_params.option)) &&
+                 (TRUE == optiga_shell_args_get_hex(p_args, "pubkey", optiga_shell_cmds_params.key,
+                                                    sizeof(optiga_shell_cmds_params.key),
+                                                    &optiga_shell_cmds_params.key_length)) &&
+                 (TRUE == optiga_shell_args_get_choice(p_args, "curve",
+                                                       OPTIGA_SHELL_CMDS_CHOICES(optiga_shell_cmds_curves),
+                                                       OPTIGA_ECC_CURVE_NIST_P_256, &optiga_shell_cmds_params.type)));
+    }
+    if ((FALSE == valid) ||
+        (FALSE == optiga_shell_cmds_require(p_args, "digest")) ||
+        (FALSE == optiga_shell_args_get_hex(p_args, "digest", optiga_shell_cmds_params.input,
+                                            OPTIGA_SHELL_CMDS_MAX_DIGEST_LENGTH,
+                                            &optiga_shell_cmds_params.input_length)) ||
+        (FALSE == optiga_shell_cmds_require(p_args, "signature")) ||
+        (FALSE == optiga_shell_args_get_hex(p_args, "signature", optiga_shell_cmds_params.signature,
+                                            sizeof(optiga_shell_cmds_params.signature),
+                                            &optiga_shell_cmds_params.signature_length)) ||
+        (FALSE == optiga_shell_cmds_get_iterations(p_args, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_cmds_run(optiga_shell_cmds_ecdsa_verify, iterations);
+}
+
+static uint16_t optiga_shell_cmds_shared_secret_length(uint32_t curve)
+{
+    switch (curve)
+    {
+        case OPTIGA_ECC_CURVE_NIST_P_384:
+        case OPTIGA_ECC_CURVE_BRAIN_POOL_P_384R1:
+            return (48);
+        case OPTIGA_ECC_CURVE_NIST_P_521:
+            return (66);
+        case OPTIGA_ECC_CURVE_BRAIN_POOL_P_512R1:
+            return (64);
+        default:
+            return (32);
+    }
+}
+
+static optiga_lib_status_t optiga_shell_cmds_ecdh(void)
+{
+    public_key_from_host_t public_key;
+
+    public_key.public_key = optiga_shell_cmds_params.key;
+    public_key.length = optiga_shell_cmds_params.key_length;
+    public_key.key_type = (uint8_t)optiga_shell_cmds_params.type;
+    optiga_shell_cmds_params.output_length = optiga_shell_cmds_shared_secret_length(optiga_shell_cmds_params.type);
+    (void)optiga_shell_policy_apply_crypt(optiga_shell_cmds_crypt, "ecdh_export", (uint16_t)optiga_shell_cmds_params.oid);
+    return (OPTIGA_SHELL_CMDS_CRYPT(optiga_crypt_ecdh(optiga_shell_cmds_crypt,
+                                                      (optiga_key_id_t)optiga_shell_cmds_params.oid,
+                                                      &public_key,
+                                                      TRUE,
+                                                      optiga_shell_cmds_params.output)));
+}
+
+void optiga_shell_cmd_ecdh(optiga_shell_args_t * p_args)
+{
+    uint32_t iterations;
+
+    optiga_shell_cmds_reset();
+    if ((FALSE == optiga_shell_cmds_require(p_args, "pubkey")) ||
+        (FALSE == optiga_shell_args_get_hex(p_args, "pubkey", optiga_shell_cmds_params.key,
+                                            sizeof(optiga_shell_cmds_params.key),
+                                            &optiga_shell_cmds_params.key_length)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "curve", OPTIGA_SHELL_CMDS_CHOICES(optiga_shell_cmds_curves),
+                                               OPTIGA_ECC_CURVE_NIST_P_256, &optiga_shell_cmds_params.type)) ||
+        (FALSE == optiga_shell_cmds_get_oid(p_args, OPTIGA_KEY_ID_E0F1)) ||
+        (FALSE == optiga_shell_cmds_get_iterations(p_args, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_cmds_params.input_length = 0;
+    optiga_shell_cmds_run(optiga_shell_cmds_ecdh, iterations);
+}
+
+static optiga_lib_status_t optiga_shell_cmds_rsa_sign(void)
+{
+    optiga_shell_cmds_params.output_length = sizeof(optiga_shell_cmds_params.output);
+    return (OPTIGA_SHELL_CMDS_CRYPT(optiga_crypt_rsa_sign(optiga_shell_cmds_crypt,
+                                                          (optiga_rsa_signature_scheme_t)optiga_shell_cmds_params.type,
+                                                          optiga_shell_cmds_params.input,
+                                                          (uint8_t)optiga_shell_cmds_params.input_length,
+                                                          (optiga_key_id_t)optiga_shell_cmds_params.oid,
+                                                          optiga_shell_cmds_params.output,
+                                                          &optiga_shell_cmds_params.output_length,
+                                                          0)));
+}
+
+void optiga_shell_cmd_rsa_sign(optiga_shell_args_t * p_args)
+{
+    uint32_t iterations;
+
+    optiga_shell_cmds_reset();
+    if ((FALSE == optiga_shell_cmds_get_oid(p_args, OPTIGA_KEY_ID_E0FC)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "scheme", OPTIGA_SHELL_CMDS_CHOICES(optiga_shell_cmds_rsa_schemes),
+                                               OPTIGA_RSASSA_PKCS1_V15_SHA256, &optiga_shell_cmds_params.type)) ||
+        (FALSE == optiga_shell_cmds_get_input(p_args, "digest", OPTIGA_SHELL_CMDS_DEFAULT_DIGEST_LENGTH,
+                                              OPTIGA_SHELL_CMDS_MAX_DIGEST_LENGTH)) ||
+        (FALSE == optiga_shell_cmds_get_iterations(p_args, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_cmds_run(optiga_shell_cmds_rsa_sign, iterations);
+}
+
+static optiga_lib_status_t optiga_shell_cmds_read_data(void)
+{
+    optiga_shell_cmds_params.output_length = (uint16_t)optiga_shell_cmds_params.length;
+    (void)optiga_shell_policy_apply_util(optiga_shell_cmds_util, "read_data", (uint16_t)optiga_shell_cmds_params.oid);
+    return (OPTIGA_SHELL_CMDS_UTIL(optiga_util_read_data(optiga_shell_cmds_util,
+                                                         (uint16_t)optiga_shell_cmds_params.oid,
+                                                         (uint16_t)optiga_shell_cmds_params.offset,
+                                                         optiga_shell_cmds_params.output,
+                                                         &optiga_shell_cmds_params.output_length)));
+}
+
+void optiga_shell_cmd_read_data(optiga_shell_args_t * p_args)
+{
+    uint32_t iterations;
+
+    optiga_shell_cmds_reset();
+    if ((FALSE == optiga_shell_cmds_get_oid(p_args, 0xE0E0)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "offset", 0, 0, OPTIGA_SHELL_CMDS_MAX_OID,
+                                               &optiga_shell_cmds_params.offset)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "length", OPTIGA_SHELL_CMDS_MAX_OUTPUT_LENGTH, 1,
+                                               OPTIGA_SHELL_CMDS_MAX_OUTPUT_LENGTH, &optiga_shell_cmds_params.length)) ||
+        (FALSE == optiga_shell_cmds_get_iterations(p_args, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_cmds_params.input_length = 0;
+    optiga_shell_cmds_run(optiga_shell_cmds_read_data, iterations);
+}
+
+static optiga_lib_status_t optiga_shell_cmds_write_data(void)
+{
+    (void)optiga_shell_policy_apply_util(optiga_shell_cmds_util, "write_data", (uint16_t)optiga_shell_cmds_params.oid);
+    return (OPTIGA_SHELL_CMDS_UTIL(optiga_util_write_data(optiga_shell_cmds_util,
+                                                          (uint16_t)optiga_shell_cmds_params.oid,
+                                                          (uint8_t)optiga_shell_cmds_params.option,
+                                                          (uint16_t)optiga_shell_cmds_params.offset,
+                                                          optiga_shell_cmds_params.input,
+                                                          optiga_shell_cmds_params.input_length)));
+}
+
+void optiga_shell_cmd_write_data(optiga_shell_args_t * p_args)
+{
+    uint32_t iterations;
+
+    optiga_shell_cmds_reset();
+    if ((FALSE == optiga_shell_cmds_require(p_args, "oid")) ||
+        (FALSE == optiga_shell_cmds_get_oid(p_args, 0)) ||
+        (FALSE == optiga_shell_cmds_require(p_args, "data")) ||
+        (FALSE == optiga_shell_args_get_hex(p_args, "data", optiga_shell_cmds_params.input,
+                                            sizeof(optiga_shell_cmds_params.input),
+                                            &optiga_shell_cmds_params.input_length)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "offset", 0, 0, OPTIGA_SHELL_CMDS_MAX_OID,
+                                               &optiga_shell_cmds_params.offset)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "mode", OPTIGA_SHELL_CMDS_CHOICES(optiga_shell_cmds_write_modes),
+                                               OPTIGA_UTIL_ERASE_AND_WRITE, &optiga_shell_cmds_params.option)) ||
+        (FALSE == optiga_shell_cmds_get_iterations(p_args, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_cmds_run(optiga_shell_cmds_write_data, iterations);
+}
+
+static optiga_lib_status_t optiga_shell_cmds_hmac(void)
+{
+    optiga_lib_status_t return_status;
+
+    /*
+     * The MAC length is updated on completion, so it lives in the request rather than on the stack
+     */
+    optiga_shell_cmds_crypt_request.result_length_32 = sizeof(optiga_shell_cmds_params.output);
+    return_status = OPTIGA_SHELL_CMDS_CRYPT(optiga_crypt_hmac(optiga_shell_cmds_crypt,
+                                                              (optiga_hmac_type_t)optiga_shell_cmds_params.type,
+                                                              (uint16_t)optiga_shell_cmds_params.oid,
+                                                              optiga_shell_cmds_params.input,
+                                                              optiga_shell_cmds_params.input_length,
+                                                              optiga_shell_cmds_params.output,
+                                                              &optiga_shell_cmds_crypt_request.result_length_32));
+    optiga_shell_cmds_params.output_length = (uint16_t)optiga_shell_cmds_crypt_request.result_length_32;
+    return (return_status);
+}
+
+void optiga_shell_cmd_hmac(optiga_shell_args_t * p_args)
+{
+    uint32_t iterations;
+
+    optiga_shell_cmds_reset();
+    if ((FALSE == optiga_shell_cmds_get_oid(p_args, 0xF1D0)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "type", OPTIGA_SHELL_CMDS_CHOICES(optiga_shell_cmds_hmac_types),
+                                               OPTIGA_HMAC_SHA_256, &optiga_shell_cmds_params.type)) ||
+        (FALSE == optiga_shell_cmds_get_input(p_args, "data", 32, OPTIGA_SHELL_CMDS_MAX_INPUT_LENGTH)) ||
+        (FALSE == optiga_shell_cmds_get_iterations(p_args, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_cmds_run(optiga_shell_cmds_hmac, iterations);
+}
@@ -0,0 +1,99 @@
+/******************************************************************************
+* File Name:   optiga_shell_cmds.h
+*
+* Description: Parameterized crypto and data object commands of the shell
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_CMDS_H_
+#define _OPTIGA_SHELL_CMDS_H_
+
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Largest data, digest, key or signature given as hex argument */
+#define OPTIGA_SHELL_CMDS_MAX_INPUT_LENGTH      (512U)
+
+/** @brief Largest result of a command */
+#define OPTIGA_SHELL_CMDS_MAX_OUTPUT_LENGTH     (1024U)
+
+/** @brief Largest number of repetitions of one command */
+#define OPTIGA_SHELL_CMDS_MAX_ITERATIONS        (10000U)
+
+/**
+ * Parameterized variants of the shell examples. Each runs one OPTIGA operation with the
+ * given arguments --iterations times, then prints the status, the result of the last run
+ * and the minimum, average and maximum time per operation.
+ */
+void optiga_shell_cmd_random(optiga_shell_args_t * p_args);
+void optiga_shell_cmd_hash(optiga_shell_args_t * p_args);
+void optiga_shell_cmd_ecc_generate_keypair(optiga_shell_args_t * p_args);
+void optiga_shell_cmd_ecdsa_sign(optiga_shell_args_t * p_args);
+void optiga_shell_cmd_ecdsa_verify(optiga_shell_args_t * p_args);
+void optiga_shell_cmd_ecdh(optiga_shell_args_t * p_args);
+void optiga_shell_cmd_rsa_sign(optiga_shell_args_t * p_args);
+void optiga_shell_cmd_read_data(optiga_shell_args_t * p_args);
+void optiga_shell_cmd_write_data(optiga_shell_args_t * p_args);
+void optiga_shell_cmd_hmac(optiga_shell_args_t * p_args);
+
+/** @brief Argument usage of the commands above, as shown by help */
+#define OPTIGA_SHELL_CMD_ITERATIONS_USAGE       " [--iterations <n>]"
+#define OPTIGA_SHELL_CMD_RANDOM_USAGE           "[--length <1..256>] [--type trng|drng]" OPTIGA_SHELL_CMD_ITERATIONS_USAGE
+#define OPTIGA_SHELL_CMD_HASH_USAGE             "[--data <hex> | --length <n> | --oid <oid> [--offset <n>] [--length <n>]]" \
+                                                OPTIGA_SHELL_CMD_ITERATIONS_USAGE
+#define OPTIGA_SHELL_CMD_ECC_KEYGEN_USAGE       "[--curve <curve>] [--oid <key oid>] [--usage sign|keyagree|auth]" \
+                                                OPTIGA_SHELL_CMD_ITERATIONS_USAGE
+#define OPTIGA_SHELL_CMD_ECDSA_SIGN_USAGE       "[--oid <key oid>] [--digest <hex> | --length <n>]" OPTIGA_SHELL_CMD_ITERATIONS_USAGE
+#define OPTIGA_SHELL_CMD_ECDSA_VERIFY_USAGE     "--pubkey <hex> [--curve <curve>] [--engine host|optiga] | " \
+                                                "--oid <certificate oid>, --digest <hex> --signature <hex>" OPTIGA_SHELL_CMD_ITERATIONS_USAGE
+#define OPTIGA_SHELL_CMD_ECDH_USAGE             "--pubkey <hex> [--curve <curve>] [--oid <key oid>]" OPTIGA_SHELL_CMD_ITERATIONS_USAGE
+#define OPTIGA_SHELL_CMD_RSA_SIGN_USAGE         "[--oid <key oid>] [--scheme sha256|sha384|sha512] [--digest <hex> | --length <n>]" \
+                                                OPTIGA_SHELL_CMD_ITERATIONS_USAGE
+#define OPTIGA_SHELL_CMD_READ_DATA_USAGE        "[--oid <oid>] [--offset <n>] [--length <n>]" OPTIGA_SHELL_CMD_ITERATIONS_USAGE
+#define OPTIGA_SHELL_CMD_WRITE_DATA_USAGE       "--oid <oid> --data <hex> [--offset <n>] [--mode erase|write]" \
+                                                OPTIGA_SHELL_CMD_ITERATIONS_USAGE
+#define OPTIGA_SHELL_CMD_HMAC_USAGE             "[--oid <secret oid>] [--type sha256|sha384|sha512] [--data <hex> | --length <n>]" \
+                                                OPTIGA_SHELL_CMD_ITERATIONS_USAGE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_CMDS_H_ */
@@ -0,0 +1,828 @@
+/******************************************************************************
+* File Name:   optiga_shell_envelope.c
+*
+* Description: Envelope encryption: data key from OPTIGA, bulk AES on the host
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "mbedtls/aes.h"
+#include "mbedtls/md.h"
+#include "mbedtls/platform_util.h"
+#include "optiga/optiga_crypt.h"
+#include "optiga/optiga_util.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_cbc.h"
+#include "optiga_shell_envelope.h"
+#include "optiga_shell_policy.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_random.h"
+#include "optiga_shell_request.h"
+
+/** @brief Offsets in the header */
+#define OPTIGA_SHELL_ENVELOPE_HEADER_SOURCE     (0U)
+#define OPTIGA_SHELL_ENVELOPE_HEADER_MATERIAL   (1U)
+#define OPTIGA_SHELL_ENVELOPE_HEADER_IV         (OPTIGA_SHELL_ENVELOPE_HEADER_MATERIAL + \
+                                                 OPTIGA_SHELL_ENVELOPE_WRAPPED_LENGTH)
+
+/** @brief Length of the secret written by #optiga_shell_envelope_provision */
+#define OPTIGA_SHELL_ENVELOPE_SECRET_LENGTH     (32U)
+
+/** @brief Largest public key of the wrap key, as encoded by the RSA 2048 key generation */
+#define OPTIGA_SHELL_ENVELOPE_PUBLIC_KEY_LENGTH (300U)
+
+/** @brief Change access condition in the metadata, never once the provisioning is done */
+#define OPTIGA_SHELL_ENVELOPE_TAG_CHANGE        (0xD0U)
+#define OPTIGA_SHELL_ENVELOPE_ACCESS_NEVER      (0xFFU)
+
+/** @brief Info of the key derivation, binds the derived data and MAC keys to this use of the secret */
+static const uint8_t optiga_shell_envelope_info[] = "optiga shell envelope";
+
+/**
+ * Metadata of the secret: data object type PRESSEC, change never, read never, execute always
+ */
+static const uint8_t optiga_shell_envelope_secret_metadata[] =
+{
+    0x20, 0x0C,
+    0xE8, 0x01, 0x21,
+    0xD0, 0x01, 0xFF,
+    0xD1, 0x01, 0xFF,
+    0xD3, 0x01, 0x00,
+};
+
+/**
+ * Metadata of the wrap key pair: change never, so the key is not generated again
+ */
+static const uint8_t optiga_shell_envelope_wrap_key_metadata[] =
+{
+    0x20, 0x03,
+    0xD0, 0x01, 0xFF,
+};
+
+/**
+ * Metadata of the public key of the wrap key: change never, read always
+ */
+static const uint8_t optiga_shell_envelope_public_key_metadata[] =
+{
+    0x20, 0x06,
+    0xD0, 0x01, 0xFF,
+    0xD1, 0x01, 0x00,
+};
+
+static optiga_shell_request_t optiga_shell_envelope_request;
+
+/** @brief Public key of the wrap key, read from OPTIGA by the first seal, no bytes until then */
+static uint8_t optiga_shell_envelope_public_key[OPTIGA_SHELL_ENVELOPE_PUBLIC_KEY_LENGTH];
+static uint16_t optiga_shell_envelope_public_key_length = 0;
+
+/** @brief Payload of optiga --envelope with room for a padding block and the tag, and the plain text to compare with */
+static uint8_t optiga_shell_envelope_bench_data[OPTIGA_SHELL_ENVELOPE_BENCH_MAX_SIZE +
+                                                OPTIGA_SHELL_ENVELOPE_BLOCK_SIZE + OPTIGA_SHELL_ENVELOPE_TAG_LENGTH];
+static uint8_t optiga_shell_envelope_bench_plain[OPTIGA_SHELL_ENVELOPE_BENCH_MAX_SIZE];
+
+/**
+ * Reads the metadata of a data object and returns the value of a tag of one byte, p_value is left
+ * as it is if the tag is missing
+ */
+static optiga_lib_status_t optiga_shell_envelope_get_tag(uint16_t oid, uint8_t tag, uint8_t * p_value)
+{
+    optiga_lib_status_t return_status = OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT;
+    optiga_util_t * me = NULL;
+    uint8_t metadata[64];
+    uint16_t length = sizeof(metadata);
+    uint16_t index;
+
+    do
+    {
+        me = optiga_shell_pool_get_util(&optiga_shell_envelope_request);
+        if (NULL == me)
+        {
+            break;
+        }
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_envelope_request,
+                                                 optiga_util_read_metadata(me, oid, metadata, &length));
+        if ((OPTIGA_LIB_SUCCESS != return_status) || (2U > length) || (0x20U != metadata[0]))
+        {
+            break;
+        }
+        /*
+         * Tag, length and value of each entry
+         */
+        if (length > (uint16_t)(2U + metadata[1]))
+        {
+            length = (uint16_t)(2U + metadata[1]);
+        }
+        for (index = 2; (index + 2U) < length; index = (uint16_t)(index + 2U + metadata[index + 1U]))
+        {
+            if ((tag == metadata[index]) && (0x01U == metadata[index + 1U]))
+            {
+                *p_value = metadata[index + 2U];
+                break;
+            }
+        }
+    } while (FALSE);
+    (void)optiga_shell_pool_put_util(me);
+
+    return (return_status);
+}
+
+/**
+ * Reads the public key of the wrap key once. It is only used once the provisioning locked it.
+ */
+static optiga_lib_status_t optiga_shell_envelope_load_public_key(void)
+{
+    optiga_lib_status_t return_status;
+    optiga_util_t * me = NULL;
+    uint16_t length = sizeof(optiga_shell_envelope_public_key);
+    uint8_t change = 0;
+
+    if (0U != optiga_shell_envelope_public_key_length)
+    {
+        return (OPTIGA_LIB_SUCCESS);
+    }
+    do
+    {
+        return_status = optiga_shell_envelope_get_tag(OPTIGA_SHELL_ENVELOPE_WRAP_PUBLIC_KEY_OID,
+                                                      OPTIGA_SHELL_ENVELOPE_TAG_CHANGE, &change);
+        if ((OPTIGA_LIB_SUCCESS != return_status) || (OPTIGA_SHELL_ENVELOPE_ACCESS_NEVER != change))
+        {
+            return_status = OPTIGA_SHELL_ENVELOPE_ERROR_PROVISION;
+            break;
+        }
+        me = optiga_shell_pool_get_util(&optiga_shell_envelope_request);
+        if (NULL == me)
+        {
+            return_status = OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_envelope_request,
+                                                 optiga_util_read_data(me, OPTIGA_SHELL_ENVELOPE_WRAP_PUBLIC_KEY_OID, 0,
+                                                                       optiga_shell_envelope_public_key, &length));
+        if ((OPTIGA_LIB_SUCCESS != return_status) || (0U == length))
+        {
+            return_status = OPTIGA_SHELL_ENVELOPE_ERROR_PROVISION;
+            break;
+        }
+        optiga_shell_envelope_public_key_length = length;
+    } while (FALSE);
+    (void)optiga_shell_pool_put_util(me);
+
+    return (return_status);
+}
+
+/**
+ * Gets the data key and the MAC key of the header from OPTIGA, #OPTIGA_SHELL_ENVELOPE_MATERIAL_LENGTH
+ * bytes with the data key first. With create, the salt or the keys are new and written to the
+ * header first.
+ */
+static optiga_lib_status_t optiga_shell_envelope_get_key(uint8_t * p_header, bool_t create, uint8_t * p_key)
+{
+    optiga_lib_status_t return_status = OPTIGA_SHELL_ENVELOPE_ERROR_HEADER;
+    optiga_crypt_t * me = NULL;
+    uint8_t * p_material = &p_header[OPTIGA_SHELL_ENVELOPE_HEADER_MATERIAL];
+    uint8_t key_source = p_header[OPTIGA_SHELL_ENVELOPE_HEADER_SOURCE];
+    public_key_from_host_t public_key;
+    uint16_t expected_length = OPTIGA_SHELL_ENVELOPE_MATERIAL_LENGTH;
+    uint16_t length = OPTIGA_SHELL_ENVELOPE_MATERIAL_LENGTH;
+
+    do
+    {
+        if ((OPTIGA_SHELL_ENVELOPE_KEY_HKDF != key_source) && (OPTIGA_SHELL_ENVELOPE_KEY_WRAP != key_source))
+        {
+            break;
+        }
+        if (TRUE == create)
+        {
+            /*
+             * A new salt, or the new data key and MAC key to be wrapped
+             */
+            memset(p_material, 0, OPTIGA_SHELL_ENVELOPE_WRAPPED_LENGTH);
+            return_status = optiga_shell_random_get(OPTIGA_SHELL_RANDOM_SOURCE_POOL,
+                                                    (OPTIGA_SHELL_ENVELOPE_KEY_HKDF == key_source) ? p_material : p_key,
+                                                    (OPTIGA_SHELL_ENVELOPE_KEY_HKDF == key_source) ?
+                                                    OPTIGA_SHELL_ENVELOPE_SALT_LENGTH : OPTIGA_SHELL_ENVELOPE_MATERIAL_LENGTH);
+            if ((OPTIGA_LIB_SUCCESS == return_status) && (OPTIGA_SHELL_ENVELOPE_KEY_WRAP == key_source))
+            {
+                return_status = optiga_shell_envelope_load_public_key();
+            }
+            if (OPTIGA_LIB_SUCCESS != return_status)
+            {
+                break;
+            }
+        }
+        me = optiga_shell_pool_get_crypt(&optiga_shell_envelope_request);
+        if (NULL == me)
+        {
+            return_status = OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+
+        if (OPTIGA_SHELL_ENVELOPE_KEY_HKDF == key_source)
+        {
+            /*
+             * The derived keys are returned to the host, under a protected response if the shielded
+             * connection is used
+             */
+            (void)optiga_shell_policy_apply_crypt(me, "hkdf_export", OPTIGA_SHELL_ENVELOPE_SECRET_OID);
+            return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_envelope_request,
+                                                     optiga_crypt_hkdf(me, OPTIGA_HKDF_SHA_256,
+                                                                       OPTIGA_SHELL_ENVELOPE_SECRET_OID,
+                                                                       p_material, OPTIGA_SHELL_ENVELOPE_SALT_LENGTH,
+                                                                       optiga_shell_envelope_info,
+                                                                       sizeof(optiga_shell_envelope_info) - 1U,
+                                                                       OPTIGA_SHELL_ENVELOPE_MATERIAL_LENGTH, TRUE, p_key));
+        }
+        else if (TRUE == create)
+        {
+            /*
+             * OPTIGA encrypts the data key and the MAC key with the public key of the wrap key for
+             * the header, only the private key in OPTIGA gets them back
+             */
+            public_key.public_key = optiga_shell_envelope_public_key;
+            public_key.length = optiga_shell_envelope_public_key_length;
+            public_key.key_type = (uint8_t)OPTIGA_RSA_KEY_2048_BIT_EXPONENTIAL;
+            expected_length = OPTIGA_SHELL_ENVELOPE_WRAPPED_LENGTH;
+            length = OPTIGA_SHELL_ENVELOPE_WRAPPED_LENGTH;
+            (void)optiga_shell_policy_apply_crypt(me, "envelope_wrap", OPTIGA_SHELL_ENVELOPE_WRAP_KEY_OID);
+            return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_envelope_request,
+                                                     optiga_crypt_rsa_encrypt_message(me, OPTIGA_RSAES_PKCS1_V15,
+                                                                                      p_key,
+                                                                                      OPTIGA_SHELL_ENVELOPE_MATERIAL_LENGTH,
+                                                                                      NULL, 0, OPTIGA_CRYPT_HOST_DATA,
+                                                                                      &public_key, p_material, &length));
+        }
+        else
+        {
+            (void)optiga_shell_policy_apply_crypt(me, "envelope_unwrap", OPTIGA_SHELL_ENVELOPE_WRAP_KEY_OID);
+            return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_envelope_request,
+                                                     optiga_crypt_rsa_decrypt_and_export(me, OPTIGA_RSAES_PKCS1_V15,
+                                                                                         p_material,
+                                                                                         OPTIGA_SHELL_ENVELOPE_WRAPPED_LENGTH,
+                                                                                         NULL, 0,
+                                                                                         OPTIGA_SHELL_ENVELOPE_WRAP_KEY_OID,
+                                                                                         p_key, &length));
+        }
+        if ((OPTIGA_LIB_SUCCESS == return_status) && (expected_length != length))
+        {
+            return_status = OPTIGA_SHELL_ENVELOPE_ERROR_LENGTH;
+        }
+    } while (FALSE);
+    (void)optiga_shell_pool_put_crypt(me);
+
+    return (return_status);
+}
+
+/**
+ * AES-128-CBC of whole blocks in place with mbedTLS, the key schedule is wiped afterwards.
+ */
+static optiga_lib_status_t optiga_shell_envelope_host_cbc(bool_t encrypt,
+                                                          const uint8_t * p_key,
+                                                          const uint8_t * p_iv,
+                                                          uint8_t * p_data,
+                                                          uint32_t length)
+{
+    mbedtls_aes_context aes;
+    uint8_t iv[OPTIGA_SHELL_ENVELOPE_BLOCK_SIZE];
+    int result;
+
+    memcpy(iv, p_iv, sizeof(iv));
+    mbedtls_aes_init(&aes);
+    result = (TRUE == encrypt) ? mbedtls_aes_setkey_enc(&aes, p_key, OPTIGA_SHELL_ENVELOPE_KEY_LENGTH * 8U) :
+                                 mbedtls_aes_setkey_dec(&aes, p_key, OPTIGA_SHELL_ENVELOPE_KEY_LENGTH * 8U);
+    if (0 == result)
+    {
+        result = mbedtls_aes_crypt_cbc(&aes, (TRUE == encrypt) ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT,
+                                       length, iv, p_data, p_data);
+    }
+    mbedtls_aes_free(&aes);
+
+    return ((0 == result) ? OPTIGA_LIB_SUCCESS : OPTIGA_SHELL_ENVELOPE_ERROR_HOST);
+}
+
+/**
+ * HMAC-SHA256 with the MAC key over the header, which holds the IV, and the cipher text
+ */
+static optiga_lib_status_t optiga_shell_envelope_mac(const uint8_t * p_mac_key,
+                                                     const uint8_t * p_header,
+                                                     const uint8_t * p_data,
+                                                     uint32_t length,
+                                                     uint8_t * p_tag)
+{
+    mbedtls_md_context_t md;
+    int result;
+
+    mbedtls_md_init(&md);
+    result = mbedtls_md_setup(&md, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 1);
+    if (0 == result)
+    {
+        result = mbedtls_md_hmac_starts(&md, p_mac_key, OPTIGA_SHELL_ENVELOPE_MAC_KEY_LENGTH);
+    }
+    if (0 == result)
+    {
+        result = mbedtls_md_hmac_update(&md, p_header, OPTIGA_SHELL_ENVELOPE_HEADER_LENGTH);
+    }
+    if (0 == result)
+    {
+        result = mbedtls_md_hmac_update(&md, p_data, length);
+    }
+    if (0 == result)
+    {
+        result = mbedtls_md_hmac_finish(&md, p_tag);
+    }
+    mbedtls_md_free(&md);
+
+    return ((0 == result) ? OPTIGA_LIB_SUCCESS : OPTIGA_SHELL_ENVELOPE_ERROR_HOST);
+}
+
+optiga_lib_status_t optiga_shell_envelope_seal(uint8_t key_source,
+                                               uint8_t * p_data,
+                                               uint32_t length,
+                                               uint32_t buffer_length,
+                                               uint8_t * p_header,
+                                               uint32_t * p_sealed_length)
+{
+    optiga_lib_status_t return_status = OPTIGA_SHELL_ENVELOPE_ERROR_LENGTH;
+    uint8_t key[OPTIGA_SHELL_ENVELOPE_MATERIAL_LENGTH];
+    uint32_t pad_length = OPTIGA_SHELL_ENVELOPE_BLOCK_SIZE - (length % OPTIGA_SHELL_ENVELOPE_BLOCK_SIZE);
+
+    *p_sealed_length = 0;
+    do
+    {
+        if ((length + pad_length + OPTIGA_SHELL_ENVELOPE_TAG_LENGTH) > buffer_length)
+        {
+            break;
+        }
+        p_header[OPTIGA_SHELL_ENVELOPE_HEADER_SOURCE] = key_source;
+        return_status = optiga_shell_random_get(OPTIGA_SHELL_RANDOM_SOURCE_POOL,
+                                                &p_header[OPTIGA_SHELL_ENVELOPE_HEADER_IV],
+                                                OPTIGA_SHELL_ENVELOPE_BLOCK_SIZE);
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        return_status = optiga_shell_envelope_get_key(p_header, TRUE, key);
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        memset(&p_data[length], (int)pad_length, pad_length);
+        return_status = optiga_shell_envelope_host_cbc(TRUE, key, &p_header[OPTIGA_SHELL_ENVELOPE_HEADER_IV],
+                                                       p_data, length + pad_length);
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        /*
+         * Encrypt then MAC, the tag follows the cipher text
+         */
+        return_status = optiga_shell_envelope_mac(&key[OPTIGA_SHELL_ENVELOPE_KEY_LENGTH], p_header, p_data,
+                                                  length + pad_length, &p_data[length + pad_length]);
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            *p_sealed_length = length + pad_length + OPTIGA_SHELL_ENVELOPE_TAG_LENGTH;
+        }
+    } while (FALSE);
+    mbedtls_platform_zeroize(key, sizeof(key));
+
+    return (return_status);
+}
+
+optiga_lib_status_t optiga_shell_envelope_open(const uint8_t * p_header,
+                                               uint8_t * p_data,
+                                               uint32_t length,
+                                               uint32_t * p_plain_length)
+{
+    optiga_lib_status_t return_status = OPTIGA_SHELL_ENVELOPE_ERROR_OPEN;
+    uint8_t header[OPTIGA_SHELL_ENVELOPE_HEADER_LENGTH];
+    uint8_t key[OPTIGA_SHELL_ENVELOPE_MATERIAL_LENGTH];
+    uint8_t tag[OPTIGA_SHELL_ENVELOPE_TAG_LENGTH];
+    uint32_t cipher_length;
+    uint8_t pad_length;
+    uint8_t mismatch = 0;
+    uint32_t index;
+
+    *p_plain_length = 0;
+    do
+    {
+        if ((length < (OPTIGA_SHELL_ENVELOPE_BLOCK_SIZE + OPTIGA_SHELL_ENVELOPE_TAG_LENGTH)) ||
+            (0U != ((length - OPTIGA_SHELL_ENVELOPE_TAG_LENGTH) % OPTIGA_SHELL_ENVELOPE_BLOCK_SIZE)))
+        {
+            break;
+        }
+        cipher_length = length - OPTIGA_SHELL_ENVELOPE_TAG_LENGTH;
+        memcpy(header, p_header, sizeof(header));
+        if ((OPTIGA_LIB_SUCCESS != optiga_shell_envelope_get_key(header, FALSE, key)) ||
+            (OPTIGA_LIB_SUCCESS != optiga_shell_envelope_mac(&key[OPTIGA_SHELL_ENVELOPE_KEY_LENGTH], header,
+                                                             p_data, cipher_length, tag)))
+        {
+            break;
+        }
+        /*
+         * The whole tag is compared whatever byte differs, nothing is decrypted unless it matches
+         */
+        for (index = 0; index < OPTIGA_SHELL_ENVELOPE_TAG_LENGTH; index++)
+        {
+            mismatch |= (uint8_t)(tag[index] ^ p_data[cipher_length + index]);
+        }
+        if ((0U != mismatch) ||
+            (OPTIGA_LIB_SUCCESS != optiga_shell_envelope_host_cbc(FALSE, key, &header[OPTIGA_SHELL_ENVELOPE_HEADER_IV],
+                                                                  p_data, cipher_length)))
+        {
+            break;
+        }
+        pad_length = p_data[cipher_length - 1U];
+        if ((0U == pad_length) || (OPTIGA_SHELL_ENVELOPE_BLOCK_SIZE < pad_length))
+        {
+            break;
+        }
+        for (index = cipher_length - pad_length; index < cipher_length; index++)
+        {
+            mismatch |= (uint8_t)(p_data[index] ^ pad_length);
+        }
+        if (0U != mismatch)
+        {
+            break;
+        }
+        *p_plain_length = cipher_length - pad_length;
+        return_status = OPTIGA_LIB_SUCCESS;
+    } while (FALSE);
+    mbedtls_platform_zeroize(key, sizeof(key));
+
+    return (return_status);
+}
+
+/**
+ * Generates the wrap key pair and stores its public key, unless a provisioning locked them already.
+ * The public key is locked last, so a wrap key is only used once all steps are done.
+ */
+static optiga_lib_status_t optiga_shell_envelope_provision_wrap_key(void)
+{
+    optiga_lib_status_t return_status;
+    optiga_crypt_t * p_crypt = NULL;
+    optiga_util_t * p_util = NULL;
+    optiga_key_id_t key_id = (optiga_key_id_t)OPTIGA_SHELL_ENVELOPE_WRAP_KEY_OID;
+    uint16_t length = sizeof(optiga_shell_envelope_public_key);
+    uint8_t change = 0;
+
+    do
+    {
+        return_status = optiga_shell_envelope_get_tag(OPTIGA_SHELL_ENVELOPE_WRAP_PUBLIC_KEY_OID,
+                                                      OPTIGA_SHELL_ENVELOPE_TAG_CHANGE, &change);
+        if ((OPTIGA_LIB_SUCCESS != return_status) || (OPTIGA_SHELL_ENVELOPE_ACCESS_NEVER == change))
+        {
+            break;
+        }
+        optiga_shell_envelope_public_key_length = 0;
+        p_crypt = optiga_shell_pool_get_crypt(&optiga_shell_envelope_request);
+        if (NULL == p_crypt)
+        {
+            return_status = OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_envelope_request,
+                                                 optiga_crypt_rsa_generate_keypair(p_crypt,
+                                                                                   OPTIGA_RSA_KEY_2048_BIT_EXPONENTIAL,
+                                                                                   (uint8_t)OPTIGA_KEY_USAGE_ENCRYPTION,
+                                                                                   FALSE, &key_id,
+                                                                                   optiga_shell_envelope_public_key,
+                                                                                   &length));
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        p_util = optiga_shell_pool_get_util(&optiga_shell_envelope_request);
+        if (NULL == p_util)
+        {
+            return_status = OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_envelope_request,
+                                                 optiga_util_write_data(p_util, OPTIGA_SHELL_ENVELOPE_WRAP_PUBLIC_KEY_OID,
+                                                                        OPTIGA_UTIL_ERASE_AND_WRITE, 0x00,
+                                                                        optiga_shell_envelope_public_key, length));
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_envelope_request,
+                                                 optiga_util_write_metadata(p_util, OPTIGA_SHELL_ENVELOPE_WRAP_KEY_OID,
+                                                                            optiga_shell_envelope_wrap_key_metadata,
+                                                                            sizeof(optiga_shell_envelope_wrap_key_metadata)));
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_envelope_request,
+                                                 optiga_util_write_metadata(p_util, OPTIGA_SHELL_ENVELOPE_WRAP_PUBLIC_KEY_OID,
+                                                                            optiga_shell_envelope_public_key_metadata,
+                                                                            sizeof(optiga_shell_envelope_public_key_metadata)));
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            optiga_shell_envelope_public_key_length = length;
+        }
+    } while (FALSE);
+    (void)optiga_shell_pool_put_crypt(p_crypt);
+    (void)optiga_shell_pool_put_util(p_util);
+
+    return (return_status);
+}
+
+optiga_lib_status_t optiga_shell_envelope_provision(void)
+{
+    optiga_lib_status_t return_status;
+    optiga_util_t * me = NULL;
+    uint8_t secret[OPTIGA_SHELL_ENVELOPE_SECRET_LENGTH];
+    uint8_t change = 0;
+
+    do
+    {
+        /*
+         * A locked secret stays, so the envelopes sealed with it can still be opened
+         */
+        return_status = optiga_shell_envelope_get_tag(OPTIGA_SHELL_ENVELOPE_SECRET_OID,
+                                                      OPTIGA_SHELL_ENVELOPE_TAG_CHANGE, &change);
+        if ((OPTIGA_LIB_SUCCESS != return_status) || (OPTIGA_SHELL_ENVELOPE_ACCESS_NEVER == change))
+        {
+            break;
+        }
+        return_status = optiga_shell_random_get(OPTIGA_SHELL_RANDOM_SOURCE_POOL, secret, sizeof(secret));
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        me = optiga_shell_pool_get_util(&optiga_shell_envelope_request);
+        if (NULL == me)
+        {
+            return_status = OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        (void)optiga_shell_policy_apply_util(me, "write_data", OPTIGA_SHELL_ENVELOPE_SECRET_OID);
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_envelope_request,
+                                                 optiga_util_write_data(me, OPTIGA_SHELL_ENVELOPE_SECRET_OID,
+                                                                        OPTIGA_UTIL_ERASE_AND_WRITE, 0x00,
+                                                                        secret, sizeof(secret)));
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_envelope_request,
+                                                 optiga_util_write_metadata(me, OPTIGA_SHELL_ENVELOPE_SECRET_OID,
+                                                                            optiga_shell_envelope_secret_metadata,
+                                                                            sizeof(optiga_shell_envelope_secret_metadata)));
+    } while (FALSE);
+    (void)optiga_shell_pool_put_util(me);
+    mbedtls_platform_zeroize(secret, sizeof(secret));
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        return_status = optiga_shell_envelope_provision_wrap_key();
+    }
+
+    return (return_status);
+}
+
+/**
+ * Checks that #optiga_shell_envelope_provision locked the secret and the public key of the wrap key
+ */
+static optiga_lib_status_t optiga_shell_envelope_get_provisioned(bool_t * p_secret, bool_t * p_wrap_key)
+{
+    optiga_lib_status_t return_status;
+    uint8_t secret_change = 0;
+    uint8_t public_key_change = 0;
+
+    return_status = optiga_shell_envelope_get_tag(OPTIGA_SHELL_ENVELOPE_SECRET_OID,
+                                                  OPTIGA_SHELL_ENVELOPE_TAG_CHANGE, &secret_change);
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        return_status = optiga_shell_envelope_get_tag(OPTIGA_SHELL_ENVELOPE_WRAP_PUBLIC_KEY_OID,
+                                                      OPTIGA_SHELL_ENVELOPE_TAG_CHANGE, &public_key_change);
+    }
+    *p_secret = (OPTIGA_SHELL_ENVELOPE_ACCESS_NEVER == secret_change) ? TRUE : FALSE;
+    *p_wrap_key = (OPTIGA_SHELL_ENVELOPE_ACCESS_NEVER == public_key_change) ? TRUE : FALSE;
+
+    return (return_status);
+}
+
+/**
+ * Encrypts and decrypts the bench payload on one path, returns the commands and times of each direction.
+ */
+static optiga_lib_status_t optiga_shell_envelope_bench_run(uint32_t path,
+                                                           uint32_t size,
+                                                           uint32_t * p_commands,
+                                                           uint32_t * p_encrypt_us,
+                                                           uint32_t * p_decrypt_us,
+                                                           uint32_t * p_plain_length)
+{
+    static const uint8_t iv[OPTIGA_SHELL_CBC_BLOCK_SIZE] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                                                            0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+    optiga_lib_status_t return_status;
+    optiga_shell_cbc_t cbc;
+    uint8_t header[OPTIGA_SHELL_ENVELOPE_HEADER_LENGTH];
+    uint32_t sealed_length = 0;
+    uint32_t start_us;
+
+    *p_commands = 0;
+    *p_decrypt_us = 0;
+    start_us = pal_os_timer_get_time_in_microseconds();
+    if (OPTIGA_SHELL_ENVELOPE_KEY_WRAP < path)
+    {
+        /*
+         * The bulk data through OPTIGA, as optiga --cbcbench with the largest chunks
+         */
+        return_status = optiga_shell_cbc_start(&cbc, TRUE, OPTIGA_KEY_ID_SECRET_BASED, iv,
+                                               OPTIGA_SHELL_CBC_PADDING_PKCS7, 0, NULL, NULL);
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            return_status = optiga_shell_cbc_final(&cbc, optiga_shell_envelope_bench_data, size,
+                                                   sizeof(optiga_shell_envelope_bench_data), &sealed_length);
+            *p_commands += cbc.commands;
+        }
+        *p_encrypt_us = pal_os_timer_get_time_in_microseconds() - start_us;
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            return (return_status);
+        }
+        start_us = pal_os_timer_get_time_in_microseconds();
+        return_status = optiga_shell_cbc_start(&cbc, FALSE, OPTIGA_KEY_ID_SECRET_BASED, iv,
+                                               OPTIGA_SHELL_CBC_PADDING_PKCS7, 0, NULL, NULL);
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            return_status = optiga_shell_cbc_final(&cbc, optiga_shell_envelope_bench_data, sealed_length,
+                                                   sizeof(optiga_shell_envelope_bench_data), p_plain_length);
+            *p_commands += cbc.commands;
+        }
+        *p_decrypt_us = pal_os_timer_get_time_in_microseconds() - start_us;
+
+        return (return_status);
+    }
+
+    return_status = optiga_shell_envelope_seal((uint8_t)path, optiga_shell_envelope_bench_data, size,
+                                               sizeof(optiga_shell_envelope_bench_data), header, &sealed_length);
+    *p_encrypt_us = pal_os_timer_get_time_in_microseconds() - start_us;
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return (return_status);
+    }
+    start_us = pal_os_timer_get_time_in_microseconds();
+    return_status = optiga_shell_envelope_open(header, optiga_shell_envelope_bench_data, sealed_length,
+                                               p_plain_length);
+    *p_decrypt_us = pal_os_timer_get_time_in_microseconds() - start_us;
+    /* One command per direction gets the data key */
+    *p_commands = 2;
+
+    return (return_status);
+}
+
+void optiga_shell_cmd_envelope(optiga_shell_args_t * p_args)
+{
+    static const char_t * const path_names[] = {"envelope_hkdf", "envelope_wrap", "optiga_cbc"};
+    static const uint32_t sizes[] = {256, 1024, 4096, OPTIGA_SHELL_ENVELOPE_BENCH_MAX_SIZE};
+    static const optiga_shell_args_choice_t provision_modes[] =
+    {
+        {"off",     FALSE},
+        {"on",      TRUE},
+    };
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    uint32_t provision;
+    bool_t provisioned = FALSE;
+    bool_t wrap_key_provisioned = FALSE;
+    uint32_t path;
+    uint32_t size_index;
+    uint32_t commands;
+    uint32_t encrypt_us;
+    uint32_t decrypt_us;
+    uint32_t plain_length;
+    uint64_t encrypt_rate;
+    uint64_t decrypt_rate;
+    uint32_t index;
+    bool_t match;
+    char_t line[160];
+
+    if ((FALSE == optiga_shell_args_get_choice(p_args, "provision", provision_modes,
+                                               (uint8_t)(sizeof(provision_modes) / sizeof(provision_modes[0])),
+                                               FALSE, &provision)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+
+    for (index = 0; index < sizeof(optiga_shell_envelope_bench_plain); index++)
+    {
+        optiga_shell_envelope_bench_plain[index] = (uint8_t)(index * 7U);
+    }
+    /*
+     * The secret and the wrap key are only provisioned on request, and once
+     */
+    if (TRUE == provision)
+    {
+        return_status = optiga_shell_envelope_provision();
+    }
+    /*
+     * The wrap key is never generated here, the OPTIGA path uses the AES key as it is
+     */
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        return_status = optiga_shell_envelope_get_provisioned(&provisioned, &wrap_key_provisioned);
+    }
+    if ((OPTIGA_LIB_SUCCESS == return_status) && (FALSE == wrap_key_provisioned))
+    {
+        return_status = OPTIGA_SHELL_ENVELOPE_ERROR_PROVISION;
+    }
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        (void)snprintf(line, sizeof(line), "envelope setup failed with 0x%04X%s", (unsigned int)return_status,
+                       (OPTIGA_SHELL_ENVELOPE_ERROR_PROVISION == return_status) ?
+                       ", the wrap key is not provisioned, see optiga --envelope --provision on" : "");
+        optiga_lib_print_string_with_newline(line);
+        return;
+    }
+    if (FALSE == provisioned)
+    {
+        optiga_lib_print_string_with_newline("envelope_hkdf skipped, the secret is not provisioned, "
+                                             "see optiga --envelope --provision on");
+    }
+
+    optiga_lib_print_string_with_newline("path,bytes,optiga_commands,encrypt_us,encrypt_mb_per_s,"
+                                         "decrypt_us,decrypt_mb_per_s,match,status");
+    for (path = 0; path < (sizeof(path_names) / sizeof(path_names[0])); path++)
+    {
+        if ((OPTIGA_SHELL_ENVELOPE_KEY_HKDF == path) && (FALSE == provisioned))
+        {
+            continue;
+        }
+        for (size_index = 0; size_index < (sizeof(sizes) / sizeof(sizes[0])); size_index++)
+        {
+            commands = 0;
+            encrypt_us = 0;
+            decrypt_us = 0;
+            plain_length = 0;
+            memcpy(optiga_shell_envelope_bench_data, optiga_shell_envelope_bench_plain, sizes[size_index]);
+            return_status = optiga_shell_envelope_bench_run(path, sizes[size_index], &commands,
+                                                            &encrypt_us, &decrypt_us, &plain_length);
+            match = ((OPTIGA_LIB_SUCCESS == return_status) && (plain_length == sizes[size_index]) &&
+                     (0 == memcmp(optiga_shell_envelope_bench_data, optiga_shell_envelope_bench_plain,
+                                  sizes[size_index]))) ? TRUE : FALSE;
+
+            if (OPTIGA_LIB_SUCCESS != return_status)
+            {
+                /*
+                 * A path stops at its first error with one row, the next path still runs
+                 */
+                (void)snprintf(line, sizeof(line), "%s,%lu,%lu,-,-,-,-,no,0x%04X",
+                               path_names[path], (unsigned long)sizes[size_index], (unsigned long)commands,
+                               (unsigned int)return_status);
+                optiga_lib_print_string_with_newline(line);
+                break;
+            }
+            /*
+             * Bytes per second is MB/s with six decimals
+             */
+            encrypt_rate = (0U != encrypt_us) ? (((uint64_t)sizes[size_index] * 1000000U) / encrypt_us) : 0U;
+            decrypt_rate = (0U != decrypt_us) ? (((uint64_t)sizes[size_index] * 1000000U) / decrypt_us) : 0U;
+            (void)snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu.%06lu,%lu,%lu.%06lu,%s,0x%04X",
+                           path_names[path], (unsigned long)sizes[size_index], (unsigned long)commands,
+                           (unsigned long)encrypt_us,
+                           (unsigned long)(encrypt_rate / 1000000U), (unsigned long)(encrypt_rate % 1000000U),
+                           (unsigned long)decrypt_us,
+                           (unsigned long)(decrypt_rate / 1000000U), (unsigned long)(decrypt_rate % 1000000U),
+                           (TRUE == match) ? "yes" : "no", (unsigned int)return_status);
+            optiga_lib_print_string_with_newline(line);
+        }
+    }
+}
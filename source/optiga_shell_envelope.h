@@ -0,0 +1,203 @@
+/******************************************************************************
+* File Name:   optiga_shell_envelope.h
+*
+* Description: Envelope encryption: data key from OPTIGA, bulk AES on the host
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_ENVELOPE_H_
+#define _OPTIGA_SHELL_ENVELOPE_H_
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga/common/optiga_lib_return_codes.h"
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Sources of the data key of an envelope */
+/// HKDF-SHA256 on OPTIGA of #OPTIGA_SHELL_ENVELOPE_SECRET_OID with a random salt kept in the header
+#define OPTIGA_SHELL_ENVELOPE_KEY_HKDF          (0U)
+/// Random keys of the host, wrapped by the RSA key pair #OPTIGA_SHELL_ENVELOPE_WRAP_KEY_OID of OPTIGA
+#define OPTIGA_SHELL_ENVELOPE_KEY_WRAP          (1U)
+
+/**
+ * @brief Data object with the secret of #OPTIGA_SHELL_ENVELOPE_KEY_HKDF, of type PRESSEC and locked
+ * against change. 0xF1D0 and 0xF1D1 are written by the examples and by optiga --bench.
+ */
+#ifndef OPTIGA_SHELL_ENVELOPE_SECRET_OID
+#define OPTIGA_SHELL_ENVELOPE_SECRET_OID        (0xF1D2U)
+#endif
+
+/**
+ * @brief RSA 2048 key pair of #OPTIGA_SHELL_ENVELOPE_KEY_WRAP, generated once by
+ * #optiga_shell_envelope_provision. The only AES key object, 0xE200, is regenerated by the
+ * symmetric examples and benches, so the keys are wrapped in a key object nothing else writes.
+ */
+#ifndef OPTIGA_SHELL_ENVELOPE_WRAP_KEY_OID
+#define OPTIGA_SHELL_ENVELOPE_WRAP_KEY_OID      (0xE0FDU)
+#endif
+
+/** @brief Data object with the public key of #OPTIGA_SHELL_ENVELOPE_WRAP_KEY_OID, as returned by its generation */
+#ifndef OPTIGA_SHELL_ENVELOPE_WRAP_PUBLIC_KEY_OID
+#define OPTIGA_SHELL_ENVELOPE_WRAP_PUBLIC_KEY_OID   (0xF1E1U)
+#endif
+
+/** @brief AES-128 data key, HMAC-SHA256 key and tag, salt of the derivation and AES block */
+#define OPTIGA_SHELL_ENVELOPE_KEY_LENGTH        (16U)
+#define OPTIGA_SHELL_ENVELOPE_MAC_KEY_LENGTH    (32U)
+#define OPTIGA_SHELL_ENVELOPE_TAG_LENGTH        (32U)
+#define OPTIGA_SHELL_ENVELOPE_SALT_LENGTH       (32U)
+#define OPTIGA_SHELL_ENVELOPE_BLOCK_SIZE        (16U)
+
+/** @brief The data key and the MAC key together, as derived or wrapped */
+#define OPTIGA_SHELL_ENVELOPE_MATERIAL_LENGTH   (OPTIGA_SHELL_ENVELOPE_KEY_LENGTH + \
+                                                 OPTIGA_SHELL_ENVELOPE_MAC_KEY_LENGTH)
+
+/** @brief Keys wrapped with RSAES-PKCS1-v1_5 by the 2048 bit wrap key, the salt takes its first bytes */
+#define OPTIGA_SHELL_ENVELOPE_WRAPPED_LENGTH    (256U)
+
+/**
+ * @brief Bytes of the header stored with the cipher text: the key source, the salt or the
+ * wrapped keys and the IV. It holds no secret.
+ */
+#define OPTIGA_SHELL_ENVELOPE_HEADER_LENGTH     (1U + OPTIGA_SHELL_ENVELOPE_WRAPPED_LENGTH + \
+                                                 OPTIGA_SHELL_ENVELOPE_BLOCK_SIZE)
+
+/** @brief mbedTLS failed to encrypt or decrypt on the host */
+#define OPTIGA_SHELL_ENVELOPE_ERROR_HOST        (0xF701)
+/** @brief The buffer has no room for the padding and the tag */
+#define OPTIGA_SHELL_ENVELOPE_ERROR_LENGTH      (0xF702)
+/**
+ * @brief The envelope is not opened: whatever the cause, the tag, the padding, the length, the
+ * header or OPTIGA, so that a failure tells nothing about the data
+ */
+#define OPTIGA_SHELL_ENVELOPE_ERROR_OPEN        (0xF703)
+/** @brief The header names no known key source */
+#define OPTIGA_SHELL_ENVELOPE_ERROR_HEADER      (0xF704)
+/** @brief The wrap key is not provisioned, see #optiga_shell_envelope_provision */
+#define OPTIGA_SHELL_ENVELOPE_ERROR_PROVISION   (0xF705)
+
+/** @brief Largest payload of optiga --envelope */
+#define OPTIGA_SHELL_ENVELOPE_BENCH_MAX_SIZE    (16384U)
+
+/** @brief Argument usage of the envelope command, as shown by help */
+#define OPTIGA_SHELL_ENVELOPE_USAGE             "[--provision on|off]"
+
+/**
+ * @brief Encrypts data in place with AES-128-CBC on the host under a new data key, then
+ * appends an HMAC-SHA256 tag over the header and the cipher text.
+ *
+ * The data key, MAC key and IV are new per call. The keys come from OPTIGA in one command and
+ * are wiped from host memory before the function returns; only the header is needed, on the same
+ * OPTIGA, to get them back. The host AES of mbedTLS runs on the crypto block of the PSoC 6 where the
+ * application adds its mbedTLS acceleration, and on AES-NI where mbedTLS finds it.
+ *
+ * @param[in]     key_source      #OPTIGA_SHELL_ENVELOPE_KEY_HKDF or #OPTIGA_SHELL_ENVELOPE_KEY_WRAP
+ * @param[in,out] p_data          Plain text, replaced by the cipher text with PKCS#7 padding and the tag
+ * @param[in]     length          Length of the plain text
+ * @param[in]     buffer_length   Size of the buffer at p_data, one block and #OPTIGA_SHELL_ENVELOPE_TAG_LENGTH
+ *                                more than length at most
+ * @param[out]    p_header        #OPTIGA_SHELL_ENVELOPE_HEADER_LENGTH bytes to keep with the cipher text
+ * @param[out]    p_sealed_length Length of the cipher text with the tag
+ *
+ * @retval #OPTIGA_LIB_SUCCESS                  The data is encrypted
+ * @retval #OPTIGA_SHELL_ENVELOPE_ERROR_LENGTH  The buffer has no room for the padding and the tag
+ * @retval #OPTIGA_SHELL_ENVELOPE_ERROR_HOST    mbedTLS failed
+ * @retval #OPTIGA_SHELL_ENVELOPE_ERROR_PROVISION  The wrap key is not provisioned
+ * @retval Error of optiga_crypt otherwise
+ */
+optiga_lib_status_t optiga_shell_envelope_seal(uint8_t key_source,
+                                               uint8_t * p_data,
+                                               uint32_t length,
+                                               uint32_t buffer_length,
+                                               uint8_t * p_header,
+                                               uint32_t * p_sealed_length);
+
+/**
+ * @brief Decrypts data sealed by #optiga_shell_envelope_seal in place.
+ *
+ * The tag is checked in constant time before anything is decrypted, so a changed header or
+ * cipher text is never decrypted, and every failure returns the same status.
+ *
+ * @param[in]     p_header        Header written by the seal
+ * @param[in,out] p_data          Cipher text with the tag, replaced by the plain text
+ * @param[in]     length          Length of the cipher text with the tag
+ * @param[out]    p_plain_length  Length of the plain text
+ *
+ * @retval #OPTIGA_LIB_SUCCESS                  The data is authentic and decrypted
+ * @retval #OPTIGA_SHELL_ENVELOPE_ERROR_OPEN    The envelope is not opened, for any reason
+ */
+optiga_lib_status_t optiga_shell_envelope_open(const uint8_t * p_header,
+                                               uint8_t * p_data,
+                                               uint32_t length,
+                                               uint32_t * p_plain_length);
+
+/**
+ * @brief Writes a random secret to #OPTIGA_SHELL_ENVELOPE_SECRET_OID and makes it a PRESSEC object
+ * which is never read or changed again, unless a provisioning locked it already.
+ *
+ * In the same way, generates the wrap key pair in
+ * #OPTIGA_SHELL_ENVELOPE_WRAP_KEY_OID, stores its public key in
+ * #OPTIGA_SHELL_ENVELOPE_WRAP_PUBLIC_KEY_OID and locks both against change, so the wrap key is
+ * generated only once.
+ */
+optiga_lib_status_t optiga_shell_envelope_provision(void);
+
+/**
+ * @brief Seals and opens payloads of 256 bytes to #OPTIGA_SHELL_ENVELOPE_BENCH_MAX_SIZE with
+ * each key source, and runs the same payloads through AES-CBC on OPTIGA with optiga_shell_cbc.
+ *
+ * --provision on writes the secret, which #OPTIGA_SHELL_ENVELOPE_KEY_HKDF needs, and the wrap key
+ * if they are missing. Without it, the HKDF path is skipped with a note while the
+ * secret is not provisioned, and the command fails while the wrap key is not. The OPTIGA path
+ * uses the AES key of optiga --aeskeygen as it is, no key is generated.
+ * Prints one CSV line per path and size with the OPTIGA commands, the time and MB/s of each
+ * direction and whether the opened data matches. A path stops at its first error, with one
+ * line holding the status and no times.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_envelope(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_ENVELOPE_H_ */
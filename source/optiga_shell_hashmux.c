@@ -0,0 +1,482 @@
+/******************************************************************************
+* File Name:   optiga_shell_hashmux.c
+*
+* Description: Many SHA-256 streams on OPTIGA at the same time, with the contexts held by the host
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "mbedtls/md.h"
+#include "optiga/optiga_crypt.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_hashmux.h"
+#include "optiga_shell_hashstream.h"
+#include "optiga_shell_queue.h"
+
+#define OPTIGA_SHELL_HASHMUX_DIGEST_LENGTH      (32U)
+
+/** @brief Commands of a stream, in the order they are sent */
+#define OPTIGA_SHELL_HASHMUX_OP_NONE            (0U)
+#define OPTIGA_SHELL_HASHMUX_OP_START           (1U)
+#define OPTIGA_SHELL_HASHMUX_OP_UPDATE          (2U)
+#define OPTIGA_SHELL_HASHMUX_OP_FINALIZE        (3U)
+
+/** @brief A hash stream and the context OPTIGA exported for it */
+typedef struct optiga_shell_hashmux_stream
+{
+    optiga_hash_context_t hash_context;
+    uint8_t context_buffer[OPTIGA_HASH_CONTEXT_LENGTH_SHA_256];
+    uint8_t digest[OPTIGA_SHELL_HASHMUX_DIGEST_LENGTH];
+    /// Data queued by the application and not sent yet
+    const uint8_t * p_queued;
+    uint32_t queued_length;
+    /// Data of the update in flight
+    hash_data_from_host_t chunk;
+    /// First error of the stream
+    optiga_lib_status_t status;
+    uint32_t start_us;
+    optiga_shell_hashmux_stats_t stats;
+    bool_t used;
+    bool_t started;
+    bool_t finish_queued;
+    bool_t finished;
+    /// Command in flight, #OPTIGA_SHELL_HASHMUX_OP_NONE if none
+    uint8_t op;
+} optiga_shell_hashmux_stream_t;
+
+static optiga_shell_hashmux_stream_t optiga_shell_hashmux_streams[OPTIGA_SHELL_HASHMUX_MAX_STREAMS];
+static optiga_shell_queue_t optiga_shell_hashmux_queue;
+static bool_t optiga_shell_hashmux_is_open = FALSE;
+/** @brief Stream the round robin looks at first */
+static uint8_t optiga_shell_hashmux_next;
+
+/** @brief Data of optiga --hashmux, stream n hashes the messages starting at byte n */
+static uint8_t optiga_shell_hashmux_pattern[OPTIGA_SHELL_HASHMUX_MESSAGE_LENGTH + OPTIGA_SHELL_HASHMUX_MAX_STREAMS];
+
+static optiga_lib_status_t optiga_shell_hashmux_issue(optiga_crypt_t * me, uint8_t slot, void * context)
+{
+    optiga_shell_hashmux_stream_t * p_stream = (optiga_shell_hashmux_stream_t *)context;
+
+    (void)slot;
+    switch (p_stream->op)
+    {
+        case OPTIGA_SHELL_HASHMUX_OP_START:
+        {
+            return (optiga_crypt_hash_start(me, &p_stream->hash_context));
+        }
+        case OPTIGA_SHELL_HASHMUX_OP_UPDATE:
+        {
+            return (optiga_crypt_hash_update(me, &p_stream->hash_context, OPTIGA_CRYPT_HOST_DATA,
+                                             &p_stream->chunk));
+        }
+        default:
+        {
+            return (optiga_crypt_hash_finalize(me, &p_stream->hash_context, p_stream->digest));
+        }
+    }
+}
+
+static void optiga_shell_hashmux_done(uint8_t slot, optiga_lib_status_t status, void * context)
+{
+    optiga_shell_hashmux_stream_t * p_stream = (optiga_shell_hashmux_stream_t *)context;
+
+    (void)slot;
+    p_stream->stats.commands++;
+    if (OPTIGA_LIB_SUCCESS != status)
+    {
+        p_stream->status = status;
+    }
+    else if (OPTIGA_SHELL_HASHMUX_OP_START == p_stream->op)
+    {
+        p_stream->started = TRUE;
+    }
+    else if (OPTIGA_SHELL_HASHMUX_OP_UPDATE == p_stream->op)
+    {
+        p_stream->stats.bytes += p_stream->chunk.length;
+    }
+    else
+    {
+        p_stream->finished = TRUE;
+        p_stream->stats.elapsed_us = pal_os_timer_get_time_in_microseconds() - p_stream->start_us;
+    }
+    p_stream->op = OPTIGA_SHELL_HASHMUX_OP_NONE;
+}
+
+/**
+ * Picks the next command of the stream, #OPTIGA_SHELL_HASHMUX_OP_NONE if it has to wait
+ */
+static uint8_t optiga_shell_hashmux_pick(const optiga_shell_hashmux_stream_t * p_stream)
+{
+    if ((FALSE == p_stream->used) || (OPTIGA_SHELL_HASHMUX_OP_NONE != p_stream->op) ||
+        (OPTIGA_LIB_SUCCESS != p_stream->status) || (TRUE == p_stream->finished))
+    {
+        return (OPTIGA_SHELL_HASHMUX_OP_NONE);
+    }
+    if (FALSE == p_stream->started)
+    {
+        return (OPTIGA_SHELL_HASHMUX_OP_START);
+    }
+    if (0U != p_stream->queued_length)
+    {
+        return (OPTIGA_SHELL_HASHMUX_OP_UPDATE);
+    }
+    return ((TRUE == p_stream->finish_queued) ? OPTIGA_SHELL_HASHMUX_OP_FINALIZE : OPTIGA_SHELL_HASHMUX_OP_NONE);
+}
+
+/**
+ * Sends the next command of the next stream round robin, or completes the oldest command in
+ * flight if no stream has one to send. Returns FALSE once nothing is left.
+ */
+static bool_t optiga_shell_hashmux_step(void)
+{
+    optiga_shell_hashmux_stream_t * p_stream;
+    uint8_t index;
+    uint8_t op;
+
+    for (index = 0; index < OPTIGA_SHELL_HASHMUX_MAX_STREAMS; index++)
+    {
+        p_stream = &optiga_shell_hashmux_streams[(optiga_shell_hashmux_next + index) % OPTIGA_SHELL_HASHMUX_MAX_STREAMS];
+        op = optiga_shell_hashmux_pick(p_stream);
+        if (OPTIGA_SHELL_HASHMUX_OP_NONE == op)
+        {
+            continue;
+        }
+        if (OPTIGA_SHELL_HASHMUX_OP_UPDATE == op)
+        {
+            p_stream->chunk.buffer = p_stream->p_queued;
+            p_stream->chunk.length = (p_stream->queued_length < OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE) ?
+                                     p_stream->queued_length : OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE;
+            p_stream->p_queued += p_stream->chunk.length;
+            p_stream->queued_length -= p_stream->chunk.length;
+        }
+        p_stream->op = op;
+        optiga_shell_hashmux_next = (uint8_t)((optiga_shell_hashmux_next + index + 1U) %
+                                              OPTIGA_SHELL_HASHMUX_MAX_STREAMS);
+        (void)optiga_shell_queue_submit(&optiga_shell_hashmux_queue, optiga_shell_hashmux_issue,
+                                        optiga_shell_hashmux_done, p_stream);
+        return (TRUE);
+    }
+    if (0U == optiga_shell_hashmux_queue.count)
+    {
+        return (FALSE);
+    }
+    (void)optiga_shell_queue_retire(&optiga_shell_hashmux_queue);
+    return (TRUE);
+}
+
+/**
+ * Returns the stream if it is open
+ */
+static optiga_shell_hashmux_stream_t * optiga_shell_hashmux_get(uint8_t stream)
+{
+    if ((FALSE == optiga_shell_hashmux_is_open) || (stream >= OPTIGA_SHELL_HASHMUX_MAX_STREAMS) ||
+        (FALSE == optiga_shell_hashmux_streams[stream].used))
+    {
+        return (NULL);
+    }
+    return (&optiga_shell_hashmux_streams[stream]);
+}
+
+optiga_lib_status_t optiga_shell_hashmux_open(uint8_t depth)
+{
+    optiga_lib_status_t return_status;
+
+    if (TRUE == optiga_shell_hashmux_is_open)
+    {
+        optiga_shell_hashmux_close();
+    }
+    return_status = optiga_shell_queue_open(&optiga_shell_hashmux_queue, depth);
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        memset(optiga_shell_hashmux_streams, 0, sizeof(optiga_shell_hashmux_streams));
+        optiga_shell_hashmux_next = 0;
+        optiga_shell_hashmux_is_open = TRUE;
+    }
+    return (return_status);
+}
+
+void optiga_shell_hashmux_close(void)
+{
+    if (TRUE == optiga_shell_hashmux_is_open)
+    {
+        optiga_shell_queue_close(&optiga_shell_hashmux_queue);
+        memset(optiga_shell_hashmux_streams, 0, sizeof(optiga_shell_hashmux_streams));
+        optiga_shell_hashmux_is_open = FALSE;
+    }
+}
+
+optiga_lib_status_t optiga_shell_hashmux_start(uint8_t * p_stream)
+{
+    optiga_shell_hashmux_stream_t * p_free;
+    uint8_t index;
+
+    if (FALSE == optiga_shell_hashmux_is_open)
+    {
+        return (OPTIGA_SHELL_HASHMUX_ERROR_NOT_OPEN);
+    }
+    for (index = 0; index < OPTIGA_SHELL_HASHMUX_MAX_STREAMS; index++)
+    {
+        p_free = &optiga_shell_hashmux_streams[index];
+        if (FALSE == p_free->used)
+        {
+            memset(p_free, 0, sizeof(*p_free));
+            p_free->hash_context.context_buffer = p_free->context_buffer;
+            p_free->hash_context.context_buffer_length = sizeof(p_free->context_buffer);
+            p_free->hash_context.hash_algo = (uint8_t)OPTIGA_HASH_TYPE_SHA_256;
+            p_free->status = OPTIGA_LIB_SUCCESS;
+            p_free->start_us = pal_os_timer_get_time_in_microseconds();
+            p_free->used = TRUE;
+            *p_stream = index;
+            return (OPTIGA_LIB_SUCCESS);
+        }
+    }
+    return (OPTIGA_SHELL_HASHMUX_ERROR_NO_STREAM);
+}
+
+optiga_lib_status_t optiga_shell_hashmux_update(uint8_t stream, const uint8_t * p_data, uint32_t length)
+{
+    optiga_shell_hashmux_stream_t * p_stream = optiga_shell_hashmux_get(stream);
+
+    if ((NULL == p_stream) || (TRUE == p_stream->finish_queued))
+    {
+        return (OPTIGA_SHELL_HASHMUX_ERROR_NO_STREAM);
+    }
+    while ((0U != p_stream->queued_length) && (OPTIGA_LIB_SUCCESS == p_stream->status))
+    {
+        (void)optiga_shell_hashmux_step();
+    }
+    if (OPTIGA_LIB_SUCCESS == p_stream->status)
+    {
+        p_stream->p_queued = p_data;
+        p_stream->queued_length = length;
+    }
+    return (p_stream->status);
+}
+
+optiga_lib_status_t optiga_shell_hashmux_finish(uint8_t stream)
+{
+    optiga_shell_hashmux_stream_t * p_stream = optiga_shell_hashmux_get(stream);
+
+    if (NULL == p_stream)
+    {
+        return (OPTIGA_SHELL_HASHMUX_ERROR_NO_STREAM);
+    }
+    p_stream->finish_queued = TRUE;
+    return (p_stream->status);
+}
+
+optiga_lib_status_t optiga_shell_hashmux_run(void)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    uint8_t index;
+
+    if (FALSE == optiga_shell_hashmux_is_open)
+    {
+        return (OPTIGA_SHELL_HASHMUX_ERROR_NOT_OPEN);
+    }
+    while (TRUE == optiga_shell_hashmux_step())
+    {
+    }
+    for (index = 0; (index < OPTIGA_SHELL_HASHMUX_MAX_STREAMS) && (OPTIGA_LIB_SUCCESS == return_status); index++)
+    {
+        if (TRUE == optiga_shell_hashmux_streams[index].used)
+        {
+            return_status = optiga_shell_hashmux_streams[index].status;
+        }
+    }
+    return (return_status);
+}
+
+optiga_lib_status_t optiga_shell_hashmux_release(uint8_t stream, uint8_t * p_digest,
+                                                 optiga_shell_hashmux_stats_t * p_stats)
+{
+    optiga_shell_hashmux_stream_t * p_stream = optiga_shell_hashmux_get(stream);
+    optiga_lib_status_t return_status;
+
+    if (NULL == p_stream)
+    {
+        return (OPTIGA_SHELL_HASHMUX_ERROR_NO_STREAM);
+    }
+    /*
+     * A command in flight still writes into the stream
+     */
+    while (OPTIGA_SHELL_HASHMUX_OP_NONE != p_stream->op)
+    {
+        (void)optiga_shell_queue_retire(&optiga_shell_hashmux_queue);
+    }
+    return_status = p_stream->status;
+    if ((OPTIGA_LIB_SUCCESS == return_status) && (FALSE == p_stream->finished))
+    {
+        return_status = OPTIGA_SHELL_HASHMUX_ERROR_NO_STREAM;
+    }
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        memcpy(p_digest, p_stream->digest, sizeof(p_stream->digest));
+    }
+    if (NULL != p_stats)
+    {
+        *p_stats = p_stream->stats;
+    }
+    p_stream->used = FALSE;
+    return (return_status);
+}
+
+/**
+ * Host SHA-256 of the data optiga --hashmux gives to a stream
+ */
+static bool_t optiga_shell_hashmux_check(uint8_t stream, uint32_t length, const uint8_t * p_digest)
+{
+    const mbedtls_md_info_t * p_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    mbedtls_md_context_t md_context;
+    uint8_t digest[OPTIGA_SHELL_HASHMUX_DIGEST_LENGTH];
+    uint32_t message_length;
+    int result;
+
+    mbedtls_md_init(&md_context);
+    result = mbedtls_md_setup(&md_context, p_info, 0);
+    result = (0 == result) ? mbedtls_md_starts(&md_context) : result;
+    while ((0 == result) && (0U != length))
+    {
+        message_length = (length < OPTIGA_SHELL_HASHMUX_MESSAGE_LENGTH) ? length : OPTIGA_SHELL_HASHMUX_MESSAGE_LENGTH;
+        result = mbedtls_md_update(&md_context, &optiga_shell_hashmux_pattern[stream], message_length);
+        length -= message_length;
+    }
+    result = (0 == result) ? mbedtls_md_finish(&md_context, digest) : result;
+    mbedtls_md_free(&md_context);
+    return (((0 == result) && (0 == memcmp(digest, p_digest, sizeof(digest)))) ? TRUE : FALSE);
+}
+
+void optiga_shell_cmd_hashmux(optiga_shell_args_t * p_args)
+{
+    optiga_lib_status_t return_status;
+    optiga_lib_status_t stream_status;
+    optiga_shell_hashmux_stats_t stats;
+    uint8_t digest[OPTIGA_SHELL_HASHMUX_DIGEST_LENGTH];
+    uint8_t streams[OPTIGA_SHELL_HASHMUX_MAX_STREAMS];
+    uint32_t stream_count;
+    uint32_t opened = 0;
+    uint32_t length;
+    uint32_t depth;
+    uint32_t offset;
+    uint32_t message_length;
+    uint32_t elapsed_us;
+    uint32_t total_bytes = 0;
+    uint32_t matches = 0;
+    uint32_t rate;
+    uint32_t index;
+    bool_t match;
+    char_t line[120];
+
+    if ((FALSE == optiga_shell_args_get_number(p_args, "streams", OPTIGA_SHELL_HASHMUX_MAX_STREAMS, 1,
+                                               OPTIGA_SHELL_HASHMUX_MAX_STREAMS, &stream_count)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "length", OPTIGA_SHELL_HASHMUX_DEFAULT_LENGTH, 0,
+                                               OPTIGA_SHELL_HASHMUX_MAX_LENGTH, &length)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "depth", OPTIGA_SHELL_HASHMUX_DEFAULT_DEPTH, 1,
+                                               OPTIGA_SHELL_QUEUE_MAX_DEPTH, &depth)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    for (index = 0; index < sizeof(optiga_shell_hashmux_pattern); index++)
+    {
+        optiga_shell_hashmux_pattern[index] = (uint8_t)(index * 7U);
+    }
+
+    elapsed_us = pal_os_timer_get_time_in_microseconds();
+    return_status = optiga_shell_hashmux_open((uint8_t)depth);
+    for (opened = 0; (opened < stream_count) && (OPTIGA_LIB_SUCCESS == return_status); opened++)
+    {
+        return_status = optiga_shell_hashmux_start(&streams[opened]);
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+    }
+    /*
+     * The messages arrive for all streams in turn, as on a gateway
+     */
+    for (offset = 0; (offset < length) && (OPTIGA_LIB_SUCCESS == return_status); offset += message_length)
+    {
+        message_length = ((length - offset) < OPTIGA_SHELL_HASHMUX_MESSAGE_LENGTH) ?
+                         (length - offset) : OPTIGA_SHELL_HASHMUX_MESSAGE_LENGTH;
+        for (index = 0; (index < stream_count) && (OPTIGA_LIB_SUCCESS == return_status); index++)
+        {
+            return_status = optiga_shell_hashmux_update(streams[index], &optiga_shell_hashmux_pattern[index],
+                                                        message_length);
+        }
+    }
+    for (index = 0; (index < stream_count) && (OPTIGA_LIB_SUCCESS == return_status); index++)
+    {
+        return_status = optiga_shell_hashmux_finish(streams[index]);
+    }
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        return_status = optiga_shell_hashmux_run();
+    }
+    elapsed_us = pal_os_timer_get_time_in_microseconds() - elapsed_us;
+
+    optiga_lib_print_string_with_newline("stream,bytes,commands,elapsed_ms,kb_per_s,digest_match,status");
+    for (index = 0; index < opened; index++)
+    {
+        memset(&stats, 0, sizeof(stats));
+        stream_status = optiga_shell_hashmux_release(streams[index], digest, &stats);
+        match = ((OPTIGA_LIB_SUCCESS == stream_status) &&
+                 (TRUE == optiga_shell_hashmux_check((uint8_t)index, length, digest))) ? TRUE : FALSE;
+        matches += (TRUE == match) ? 1U : 0U;
+        total_bytes += stats.bytes;
+        rate = (0U != stats.elapsed_us) ? (uint32_t)(((uint64_t)stats.bytes * 1000000U) / stats.elapsed_us) : 0U;
+        snprintf(line, sizeof(line), "%lu,%lu,%lu,%lu,%lu.%03lu,%s,0x%04X", (unsigned long)index,
+                 (unsigned long)stats.bytes, (unsigned long)stats.commands, (unsigned long)(stats.elapsed_us / 1000U),
+                 (unsigned long)(rate / 1000U), (unsigned long)(rate % 1000U), (TRUE == match) ? "yes" : "no",
+                 (unsigned int)stream_status);
+        optiga_lib_print_string_with_newline(line);
+    }
+    optiga_shell_hashmux_close();
+
+    rate = (0U != elapsed_us) ? (uint32_t)(((uint64_t)total_bytes * 1000000U) / elapsed_us) : 0U;
+    optiga_lib_print_string_with_newline("streams,depth,bytes_per_stream,host_bytes_per_stream,host_bytes,"
+                                         "elapsed_ms,kb_per_s,digests_matched,status");
+    snprintf(line, sizeof(line), "%lu,%lu,%lu,%lu,%lu,%lu,%lu.%03lu,%lu,0x%04X", (unsigned long)stream_count,
+             (unsigned long)depth, (unsigned long)length, (unsigned long)sizeof(optiga_shell_hashmux_stream_t),
+             (unsigned long)sizeof(optiga_shell_hashmux_streams), (unsigned long)(elapsed_us / 1000U),
+             (unsigned long)(rate / 1000U), (unsigned long)(rate % 1000U), (unsigned long)matches,
+             (unsigned int)return_status);
+    optiga_lib_print_string_with_newline(line);
+}
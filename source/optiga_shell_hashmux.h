@@ -0,0 +1,168 @@
+/******************************************************************************
+* File Name:   optiga_shell_hashmux.h
+*
+* Description: Many SHA-256 streams on OPTIGA at the same time, with the contexts held by the host
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_HASHMUX_H_
+#define _OPTIGA_SHELL_HASHMUX_H_
+
+#include "optiga/optiga_crypt.h"
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of hash streams the host keeps open at the same time. Each stream holds the
+ * SHA-256 context exported by OPTIGA (#OPTIGA_HASH_CONTEXT_LENGTH_SHA_256 bytes) and its state.
+ */
+#ifndef OPTIGA_SHELL_HASHMUX_MAX_STREAMS
+#define OPTIGA_SHELL_HASHMUX_MAX_STREAMS        (32U)
+#endif
+
+/** @brief Default number of updates in flight, see optiga_shell_queue.h */
+#define OPTIGA_SHELL_HASHMUX_DEFAULT_DEPTH      (2U)
+
+/** @brief Default and largest data per stream of optiga --hashmux */
+#define OPTIGA_SHELL_HASHMUX_DEFAULT_LENGTH     (4096U)
+#define OPTIGA_SHELL_HASHMUX_MAX_LENGTH         (16384U)
+/** @brief Data given to #optiga_shell_hashmux_update per message by optiga --hashmux */
+#define OPTIGA_SHELL_HASHMUX_MESSAGE_LENGTH     (512U)
+
+/** @brief No stream is free, or the stream is not open */
+#define OPTIGA_SHELL_HASHMUX_ERROR_NO_STREAM    (0xF301)
+/** @brief The manager is not open */
+#define OPTIGA_SHELL_HASHMUX_ERROR_NOT_OPEN     (0xF302)
+
+/** @brief Argument usage of the hashmux command, as shown by help */
+#define OPTIGA_SHELL_HASHMUX_USAGE              "[--streams <n>] [--length <bytes>] [--depth <1..5>]"
+
+/** @brief Statistics of one stream */
+typedef struct optiga_shell_hashmux_stats
+{
+    /// Bytes hashed
+    uint32_t bytes;
+    /// Commands sent to OPTIGA: start, updates and finalize
+    uint32_t commands;
+    /// Time from the start to the digest, in microseconds
+    uint32_t elapsed_us;
+} optiga_shell_hashmux_stats_t;
+
+/**
+ * @brief Takes depth crypt instances from the pool to run the commands of all streams.
+ *
+ * OPTIGA keeps no state of a stream between commands: each update imports the context held by
+ * the host and exports it again, so the updates of all streams can be interleaved freely. A
+ * stream has one command in flight at most, up to depth streams have one at the same time.
+ *
+ * @param[in] depth  Number of commands in flight, 1 to #OPTIGA_SHELL_QUEUE_MAX_DEPTH
+ *
+ * @retval #OPTIGA_LIB_SUCCESS  The manager is open, all streams are free
+ * @retval Error of #optiga_shell_queue_open otherwise
+ */
+optiga_lib_status_t optiga_shell_hashmux_open(uint8_t depth);
+
+/**
+ * @brief Completes the commands in flight, frees all streams and returns the crypt instances.
+ */
+void optiga_shell_hashmux_close(void);
+
+/**
+ * @brief Takes a free stream and queues the start of its hash.
+ *
+ * @param[out] p_stream  Stream number
+ *
+ * @retval #OPTIGA_LIB_SUCCESS                    The stream is taken
+ * @retval #OPTIGA_SHELL_HASHMUX_ERROR_NO_STREAM  All #OPTIGA_SHELL_HASHMUX_MAX_STREAMS are open
+ */
+optiga_lib_status_t optiga_shell_hashmux_start(uint8_t * p_stream);
+
+/**
+ * @brief Queues data of a stream. The data is sent in chunks of
+ * #OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE, interleaved with the other streams, and must stay in
+ * place until #optiga_shell_hashmux_run returns. If data of the stream is still queued, the
+ * commands run until it is sent.
+ *
+ * @retval #OPTIGA_LIB_SUCCESS  The data is queued
+ * @retval Error of the stream otherwise, the stream stays failed until released
+ */
+optiga_lib_status_t optiga_shell_hashmux_update(uint8_t stream, const uint8_t * p_data, uint32_t length);
+
+/**
+ * @brief Queues the finalization of a stream, after its queued data.
+ */
+optiga_lib_status_t optiga_shell_hashmux_finish(uint8_t stream);
+
+/**
+ * @brief Runs the queued commands of all streams round robin until none is left.
+ *
+ * @return #OPTIGA_LIB_SUCCESS, or the first error of a stream
+ */
+optiga_lib_status_t optiga_shell_hashmux_run(void);
+
+/**
+ * @brief Returns the digest and statistics of a finished stream and frees it.
+ *
+ * @param[in]  stream    Stream number
+ * @param[out] p_digest  SHA-256, 32 bytes
+ * @param[out] p_stats   Statistics of the stream, may be NULL
+ *
+ * @return #OPTIGA_LIB_SUCCESS, or the error of the stream. The stream is freed in any case.
+ */
+optiga_lib_status_t optiga_shell_hashmux_release(uint8_t stream, uint8_t * p_digest,
+                                                 optiga_shell_hashmux_stats_t * p_stats);
+
+/**
+ * @brief Hashes --length bytes on each of --streams streams at the same time.
+ *
+ * Each stream gets its own data in messages of #OPTIGA_SHELL_HASHMUX_MESSAGE_LENGTH, given
+ * to the streams in turn. One CSV line per stream gives its bytes, commands, time, throughput
+ * and whether the digest matches the one computed on the host. A last line gives the host
+ * memory of the streams and the aggregate throughput.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_hashmux(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_HASHMUX_H_ */
@@ -0,0 +1,276 @@
+/******************************************************************************
+* File Name:   optiga_shell_hashstream.c
+*
+* Description: Streaming SHA-256 of data received on the link
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_hashstream.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_uart.h"
+
+#define OPTIGA_SHELL_HASHSTREAM_DIGEST_LENGTH   (32U)
+/** @brief Buffers the chunks are received into, one is hashed while the other fills */
+#define OPTIGA_SHELL_HASHSTREAM_BUFFERS         (2U)
+
+/** @brief Input side of a stream */
+typedef struct optiga_shell_hashstream_input
+{
+    /// Bytes of the stream, 0 if it ends on the timeout
+    uint32_t length;
+    uint32_t timeout_ms;
+    /// Bytes received so far
+    uint32_t received;
+    /// No more bytes are taken: all were received, the link was idle or it is closed
+    bool_t ended;
+    /// Time the core waited for the link, in microseconds
+    uint64_t wait_us;
+    /// Part of wait_us spent on the timeout which ended the stream
+    uint32_t timeout_us;
+} optiga_shell_hashstream_input_t;
+
+static optiga_shell_request_t optiga_shell_hashstream_request;
+static uint8_t optiga_shell_hashstream_buffers[OPTIGA_SHELL_HASHSTREAM_BUFFERS][OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE];
+static uint8_t optiga_shell_hashstream_context[OPTIGA_HASH_CONTEXT_LENGTH_SHA_256];
+
+/**
+ * Fills the buffer with the next chunk of the stream. Returns the bytes received, less than a
+ * chunk at the end of the stream and 0 once it ended.
+ */
+static uint32_t optiga_shell_hashstream_fill(optiga_shell_hashstream_input_t * p_input, uint8_t * p_buffer)
+{
+    uint32_t chunk_length = OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE;
+    uint32_t filled = 0;
+    uint32_t idle_start_us = 0;
+    uint32_t idle_ms;
+    uint32_t wait_start_us;
+    uint32_t received;
+    bool_t idle = FALSE;
+
+    if ((0U != p_input->length) && ((p_input->length - p_input->received) < chunk_length))
+    {
+        chunk_length = p_input->length - p_input->received;
+        p_input->ended = (0U == chunk_length) ? TRUE : p_input->ended;
+    }
+    while ((FALSE == p_input->ended) && (filled < chunk_length))
+    {
+        received = optiga_shell_uart_read_block(&p_buffer[filled], chunk_length - filled);
+        if (0U != received)
+        {
+            filled += received;
+            idle = FALSE;
+            continue;
+        }
+        if (TRUE == optiga_shell_uart_is_closed())
+        {
+            p_input->ended = TRUE;
+            break;
+        }
+        if (FALSE == idle)
+        {
+            idle_start_us = pal_os_timer_get_time_in_microseconds();
+            idle = TRUE;
+        }
+        idle_ms = (pal_os_timer_get_time_in_microseconds() - idle_start_us) / 1000U;
+        if (idle_ms >= p_input->timeout_ms)
+        {
+            p_input->timeout_us = pal_os_timer_get_time_in_microseconds() - idle_start_us;
+            p_input->ended = TRUE;
+            break;
+        }
+        wait_start_us = pal_os_timer_get_time_in_microseconds();
+        optiga_shell_uart_wait_timeout(p_input->timeout_ms - idle_ms);
+        p_input->wait_us += pal_os_timer_get_time_in_microseconds() - wait_start_us;
+    }
+    p_input->received += filled;
+    if ((0U != p_input->length) && (p_input->received == p_input->length))
+    {
+        p_input->ended = TRUE;
+    }
+    return (filled);
+}
+
+void optiga_shell_cmd_hashstream(optiga_shell_args_t * p_args)
+{
+    optiga_lib_status_t return_status = !OPTIGA_LIB_SUCCESS;
+    optiga_shell_hashstream_input_t input;
+    optiga_hash_context_t hash_context;
+    hash_data_from_host_t hash_data_host;
+    optiga_crypt_t * me = NULL;
+    uint8_t digest[OPTIGA_SHELL_HASHSTREAM_DIGEST_LENGTH];
+    uint32_t filled[OPTIGA_SHELL_HASHSTREAM_BUFFERS] = {0};
+    uint32_t overflow_count = optiga_shell_uart_get_overflow_count();
+    uint32_t current = 0;
+    uint32_t next;
+    uint32_t chunks = 0;
+    uint32_t hashed = 0;
+    uint32_t last_us;
+    uint32_t now_us;
+    uint64_t elapsed_us = 0;
+    uint64_t chip_wait_us = 0;
+    uint64_t rate;
+    uint32_t index;
+    size_t offset;
+    char_t line[200];
+
+    memset(&input, 0, sizeof(input));
+    if ((FALSE == optiga_shell_args_get_number(p_args, "length", 0, 0, 0xFFFFFFFFU, &input.length)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "timeout", OPTIGA_SHELL_HASHSTREAM_DEFAULT_TIMEOUT_MS, 1,
+                                               OPTIGA_SHELL_HASHSTREAM_MAX_TIMEOUT_MS, &input.timeout_ms)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    memset(digest, 0, sizeof(digest));
+
+    last_us = pal_os_timer_get_time_in_microseconds();
+    do
+    {
+        me = optiga_shell_pool_get_crypt(&optiga_shell_hashstream_request);
+        if (NULL == me)
+        {
+            return_status = OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+        hash_context.context_buffer = optiga_shell_hashstream_context;
+        hash_context.context_buffer_length = sizeof(optiga_shell_hashstream_context);
+        hash_context.hash_algo = (uint8_t)OPTIGA_HASH_TYPE_SHA_256;
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_hashstream_request,
+                                                 optiga_crypt_hash_start(me, &hash_context));
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+
+        filled[current] = optiga_shell_hashstream_fill(&input, optiga_shell_hashstream_buffers[current]);
+        while (0U != filled[current])
+        {
+            next = (current + 1U) % OPTIGA_SHELL_HASHSTREAM_BUFFERS;
+            hash_data_host.buffer = optiga_shell_hashstream_buffers[current];
+            hash_data_host.length = filled[current];
+            optiga_shell_request_start(&optiga_shell_hashstream_request);
+            return_status = optiga_crypt_hash_update(me, &hash_context, OPTIGA_CRYPT_HOST_DATA, &hash_data_host);
+            if (OPTIGA_LIB_SUCCESS != return_status)
+            {
+                break;
+            }
+            /*
+             * The next chunk comes in over the link while OPTIGA hashes this one, the buffer in
+             * flight is not touched until its update completed
+             */
+            filled[next] = optiga_shell_hashstream_fill(&input, optiga_shell_hashstream_buffers[next]);
+            now_us = pal_os_timer_get_time_in_microseconds();
+            return_status = optiga_shell_request_wait(&optiga_shell_hashstream_request);
+            chip_wait_us += pal_os_timer_get_time_in_microseconds() - now_us;
+            if (OPTIGA_LIB_SUCCESS != return_status)
+            {
+                break;
+            }
+            hashed += filled[current];
+            chunks++;
+            current = next;
+
+            /*
+             * The microsecond timer wraps after 71 minutes, the time is summed up per chunk
+             */
+            now_us = pal_os_timer_get_time_in_microseconds();
+            elapsed_us += now_us - last_us;
+            last_us = now_us;
+        }
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_hashstream_request,
+                                                 optiga_crypt_hash_finalize(me, &hash_context, digest));
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        if ((0U != input.length) && (input.received != input.length))
+        {
+            return_status = OPTIGA_SHELL_HASHSTREAM_ERROR_INPUT_ENDED;
+        }
+        else if (overflow_count != optiga_shell_uart_get_overflow_count())
+        {
+            return_status = OPTIGA_SHELL_HASHSTREAM_ERROR_OVERFLOW;
+        }
+    } while (FALSE);
+    elapsed_us += pal_os_timer_get_time_in_microseconds() - last_us;
+    (void)optiga_shell_pool_put_crypt(me);
+
+    /*
+     * The timeout which ended a stream without --length is not part of the rate
+     */
+    elapsed_us -= (input.timeout_us < elapsed_us) ? input.timeout_us : elapsed_us;
+    input.wait_us -= (input.timeout_us < input.wait_us) ? input.timeout_us : input.wait_us;
+
+    /*
+     * Drop the rest of the stream, it must not reach the command line
+     */
+    while (FALSE == input.ended)
+    {
+        (void)optiga_shell_hashstream_fill(&input, optiga_shell_hashstream_buffers[0]);
+    }
+
+    /*
+     * Bytes per second is MB/s with six decimals
+     */
+    rate = (0U != elapsed_us) ? (((uint64_t)hashed * 1000000U) / elapsed_us) : 0U;
+    optiga_lib_print_string_with_newline("bytes,chunks,chunk_size,elapsed_us,mb_per_s,link_wait_us,chip_wait_us,"
+                                         "overflows,status,sha256");
+    offset = (size_t)snprintf(line, sizeof(line), "%lu,%lu,%u,%llu,%lu.%06lu,%llu,%llu,%lu,0x%04X,",
+                              (unsigned long)hashed, (unsigned long)chunks,
+                              (unsigned int)OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE, (unsigned long long)elapsed_us,
+                              (unsigned long)(rate / 1000000U), (unsigned long)(rate % 1000000U),
+                              (unsigned long long)input.wait_us, (unsigned long long)chip_wait_us,
+                              (unsigned long)(optiga_shell_uart_get_overflow_count() - overflow_count),
+                              (unsigned int)return_status);
+    for (index = 0; (OPTIGA_LIB_SUCCESS == return_status) && (index < sizeof(digest)); index++)
+    {
+        offset += (size_t)snprintf(&line[offset], sizeof(line) - offset, "%02X", digest[index]);
+    }
+    optiga_lib_print_string_with_newline(line);
+}
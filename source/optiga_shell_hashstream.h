@@ -0,0 +1,99 @@
+/******************************************************************************
+* File Name:   optiga_shell_hashstream.h
+*
+* Description: Streaming SHA-256 of data received on the link
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_HASHSTREAM_H_
+#define _OPTIGA_SHELL_HASHSTREAM_H_
+
+#include "optiga/optiga_crypt.h"
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Bytes of a hash update command besides the data: command header, data TLV, context
+ * import TLV with the SHA-256 context and context export TLV
+ */
+#define OPTIGA_SHELL_HASHSTREAM_APDU_OVERHEAD   (4U + 3U + (3U + OPTIGA_HASH_CONTEXT_LENGTH_SHA_256) + 3U)
+
+/**
+ * @brief Data given to one optiga_crypt_hash_update. The default fills the communication buffer,
+ * so each chunk is one command and the library never splits it.
+ */
+#ifndef OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE
+#define OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE      (OPTIGA_MAX_COMMS_BUFFER_SIZE - OPTIGA_SHELL_HASHSTREAM_APDU_OVERHEAD)
+#endif
+
+/** @brief Default and largest time without input after which the stream ends, in milliseconds */
+#define OPTIGA_SHELL_HASHSTREAM_DEFAULT_TIMEOUT_MS  (2000U)
+#define OPTIGA_SHELL_HASHSTREAM_MAX_TIMEOUT_MS      (60000U)
+
+/** @brief The input ended before --length bytes were received */
+#define OPTIGA_SHELL_HASHSTREAM_ERROR_INPUT_ENDED   (0xF101)
+/** @brief The receive ring of the UART dropped bytes, the digest does not cover all data sent */
+#define OPTIGA_SHELL_HASHSTREAM_ERROR_OVERFLOW      (0xF102)
+
+/** @brief Argument usage of the hashstream command, as shown by help */
+#define OPTIGA_SHELL_HASHSTREAM_USAGE           "[--length <bytes>] [--timeout <ms>]"
+
+/**
+ * @brief SHA-256 on OPTIGA of raw data sent on the link right after the command line.
+ *
+ * The data is hashed in chunks of #OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE from two buffers: while
+ * OPTIGA hashes one chunk, the next one is received into the other buffer. With --length the
+ * stream is that many bytes, without it the stream ends when no byte was received for --timeout
+ * milliseconds. On failure the rest of the stream is read and dropped, so it is not taken as
+ * commands.
+ *
+ * Prints one CSV line: the bytes and chunks hashed, the time from the start to the digest and
+ * the sustained rate in MB/s, the time spent waiting for the link and for OPTIGA, the bytes the
+ * UART ring dropped, the status and the digest.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_hashstream(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_HASHSTREAM_H_ */
@@ -0,0 +1,439 @@
+/******************************************************************************
+* File Name:   optiga_shell_hybrid.c
+*
+* Description: SHA-256 on the host or on OPTIGA, selected from the data length
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "mbedtls/md.h"
+#include "optiga/optiga_crypt.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_hashstream.h"
+#include "optiga_shell_hybrid.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_request.h"
+
+/** @brief Shortest data of the crossover benchmark, each next length is twice as long */
+#define OPTIGA_SHELL_HYBRID_BENCH_MIN_LENGTH    (16U)
+#define OPTIGA_SHELL_HYBRID_BENCH_STEP          (2U)
+/** @brief Threshold of #OPTIGA_SHELL_HYBRID_ENGINE_AUTO hashing everything on OPTIGA */
+#define OPTIGA_SHELL_HYBRID_OPTIGA_ONLY         (0xFFFFFFFFU)
+/** @brief Period of the counting pattern of the command */
+#define OPTIGA_SHELL_HYBRID_PATTERN_PERIOD      (256U)
+
+static optiga_shell_request_t optiga_shell_hybrid_request;
+static uint32_t optiga_shell_hybrid_threshold = OPTIGA_SHELL_HYBRID_THRESHOLD;
+/// The threshold is measured or set, #OPTIGA_SHELL_HYBRID_CALIBRATE has nothing left to do
+static bool_t optiga_shell_hybrid_measured = (0U == OPTIGA_SHELL_HYBRID_CALIBRATE) ? TRUE : FALSE;
+static uint8_t optiga_shell_hybrid_context[OPTIGA_HASH_CONTEXT_LENGTH_SHA_256];
+/// One chunk of the counting pattern starting at any offset, see #optiga_shell_hybrid_chunk
+static uint8_t optiga_shell_hybrid_pattern[OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE + OPTIGA_SHELL_HYBRID_PATTERN_PERIOD];
+
+static const char_t * const optiga_shell_hybrid_engine_names[] = {"auto", "host", "optiga"};
+
+/**
+ * Returns the data at the offset. A period of 0 means the data is contiguous, otherwise it repeats
+ * with that period and the buffer holds one chunk plus one period, so every chunk is a slice of it.
+ */
+static const uint8_t * optiga_shell_hybrid_chunk(const uint8_t * p_data, uint32_t period, uint32_t offset)
+{
+    return ((0U == period) ? &p_data[offset] : &p_data[offset % period]);
+}
+
+static uint32_t optiga_shell_hybrid_chunk_length(uint32_t length, uint32_t offset)
+{
+    return (((length - offset) < OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE) ? (length - offset) :
+                                                                        OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE);
+}
+
+static optiga_lib_status_t optiga_shell_hybrid_hash_host(const uint8_t * p_data, uint32_t period, uint32_t length,
+                                                         uint8_t * p_digest)
+{
+    const mbedtls_md_info_t * p_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    mbedtls_md_context_t md_context;
+    uint32_t chunk_length;
+    uint32_t offset = 0;
+    int result;
+
+    mbedtls_md_init(&md_context);
+    result = (NULL == p_info) ? -1 : mbedtls_md_setup(&md_context, p_info, 0);
+    if (0 == result)
+    {
+        result = mbedtls_md_starts(&md_context);
+    }
+    while ((0 == result) && (offset < length))
+    {
+        chunk_length = optiga_shell_hybrid_chunk_length(length, offset);
+        result = mbedtls_md_update(&md_context, optiga_shell_hybrid_chunk(p_data, period, offset), chunk_length);
+        offset += chunk_length;
+    }
+    if (0 == result)
+    {
+        result = mbedtls_md_finish(&md_context, p_digest);
+    }
+    mbedtls_md_free(&md_context);
+    return ((0 == result) ? OPTIGA_LIB_SUCCESS : OPTIGA_SHELL_HYBRID_ERROR_HOST_HASH);
+}
+
+/**
+ * Data fitting into one command is hashed with optiga_crypt_hash, longer data is given to
+ * optiga_crypt_hash_update in chunks
+ */
+static optiga_lib_status_t optiga_shell_hybrid_hash_optiga(const uint8_t * p_data, uint32_t period, uint32_t length,
+                                                           uint8_t * p_digest)
+{
+    optiga_lib_status_t return_status;
+    optiga_hash_context_t hash_context;
+    hash_data_from_host_t hash_data_host;
+    optiga_crypt_t * me;
+    uint32_t offset = 0;
+
+    me = optiga_shell_pool_get_crypt(&optiga_shell_hybrid_request);
+    if (NULL == me)
+    {
+        return (OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT);
+    }
+    do
+    {
+        if (length <= OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE)
+        {
+            hash_data_host.buffer = p_data;
+            hash_data_host.length = length;
+            return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_hybrid_request,
+                                                     optiga_crypt_hash(me, OPTIGA_HASH_TYPE_SHA_256,
+                                                                       OPTIGA_CRYPT_HOST_DATA, &hash_data_host,
+                                                                       p_digest));
+            break;
+        }
+
+        hash_context.context_buffer = optiga_shell_hybrid_context;
+        hash_context.context_buffer_length = sizeof(optiga_shell_hybrid_context);
+        hash_context.hash_algo = (uint8_t)OPTIGA_HASH_TYPE_SHA_256;
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_hybrid_request,
+                                                 optiga_crypt_hash_start(me, &hash_context));
+        while ((OPTIGA_LIB_SUCCESS == return_status) && (offset < length))
+        {
+            hash_data_host.buffer = optiga_shell_hybrid_chunk(p_data, period, offset);
+            hash_data_host.length = optiga_shell_hybrid_chunk_length(length, offset);
+            return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_hybrid_request,
+                                                     optiga_crypt_hash_update(me, &hash_context,
+                                                                              OPTIGA_CRYPT_HOST_DATA,
+                                                                              &hash_data_host));
+            offset += hash_data_host.length;
+        }
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_hybrid_request,
+                                                 optiga_crypt_hash_finalize(me, &hash_context, p_digest));
+    } while (FALSE);
+    (void)optiga_shell_pool_put_crypt(me);
+    return (return_status);
+}
+
+static optiga_lib_status_t optiga_shell_hybrid_run(const uint8_t * p_data, uint32_t period, uint32_t length,
+                                                   uint8_t engine, uint8_t * p_digest)
+{
+    if (OPTIGA_SHELL_HYBRID_ENGINE_HOST == engine)
+    {
+        return (optiga_shell_hybrid_hash_host(p_data, period, length, p_digest));
+    }
+    return (optiga_shell_hybrid_hash_optiga(p_data, period, length, p_digest));
+}
+
+/**
+ * Hashes the counting pattern of the given length on one engine the given number of times and
+ * returns the average time
+ */
+static optiga_lib_status_t optiga_shell_hybrid_time(uint32_t length, uint8_t engine, uint32_t iterations,
+                                                    uint8_t * p_digest, uint32_t * p_average_us)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    uint32_t total_us = 0;
+    uint32_t start_us;
+    uint32_t index;
+
+    for (index = 0; (index < iterations) && (OPTIGA_LIB_SUCCESS == return_status); index++)
+    {
+        start_us = pal_os_timer_get_time_in_microseconds();
+        return_status = optiga_shell_hybrid_run(optiga_shell_hybrid_pattern, OPTIGA_SHELL_HYBRID_PATTERN_PERIOD,
+                                                length, engine, p_digest);
+        total_us += pal_os_timer_get_time_in_microseconds() - start_us;
+    }
+    *p_average_us = total_us / iterations;
+    return (return_status);
+}
+
+static void optiga_shell_hybrid_fill_pattern(void)
+{
+    uint32_t index;
+
+    for (index = 0; index < sizeof(optiga_shell_hybrid_pattern); index++)
+    {
+        optiga_shell_hybrid_pattern[index] = (uint8_t)index;
+    }
+}
+
+/**
+ * Measures both engines from the shortest length of the benchmark to the given one, optionally
+ * printing one CSV line per length, and returns the shortest length from which the host stays
+ * faster. A row with an error ends the measurement, its digests are not compared.
+ */
+static optiga_lib_status_t optiga_shell_hybrid_crossover(uint32_t max_length, uint32_t iterations, bool_t print,
+                                                         uint32_t * p_threshold)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    uint8_t host_digest[OPTIGA_SHELL_HYBRID_DIGEST_LENGTH];
+    uint8_t optiga_digest[OPTIGA_SHELL_HYBRID_DIGEST_LENGTH];
+    uint32_t threshold = OPTIGA_SHELL_HYBRID_OPTIGA_ONLY;
+    uint32_t length;
+    uint32_t host_us;
+    uint32_t optiga_us;
+    const char_t * match;
+    char_t line[100];
+
+    optiga_shell_hybrid_fill_pattern();
+    if (TRUE == print)
+    {
+        optiga_lib_print_string_with_newline("length,host_us,optiga_us,faster,digests_match,status");
+    }
+    for (length = OPTIGA_SHELL_HYBRID_BENCH_MIN_LENGTH; length <= max_length;
+         length *= OPTIGA_SHELL_HYBRID_BENCH_STEP)
+    {
+        host_us = 0;
+        optiga_us = 0;
+        match = "-";
+        return_status = optiga_shell_hybrid_time(length, OPTIGA_SHELL_HYBRID_ENGINE_HOST, iterations,
+                                                 host_digest, &host_us);
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            return_status = optiga_shell_hybrid_time(length, OPTIGA_SHELL_HYBRID_ENGINE_OPTIGA, iterations,
+                                                     optiga_digest, &optiga_us);
+        }
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            match = "yes";
+            if (0 != memcmp(host_digest, optiga_digest, sizeof(host_digest)))
+            {
+                match = "no";
+                return_status = OPTIGA_SHELL_HYBRID_ERROR_MISMATCH;
+            }
+        }
+        if (TRUE == print)
+        {
+            snprintf(line, sizeof(line), "%lu,%lu,%lu,%s,%s,0x%04X", (unsigned long)length, (unsigned long)host_us,
+                     (unsigned long)optiga_us,
+                     (OPTIGA_LIB_SUCCESS != return_status) ? "-" : ((host_us <= optiga_us) ? "host" : "optiga"),
+                     match, (unsigned int)return_status);
+            optiga_lib_print_string_with_newline(line);
+        }
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            return (return_status);
+        }
+        if (host_us > optiga_us)
+        {
+            threshold = OPTIGA_SHELL_HYBRID_OPTIGA_ONLY;
+        }
+        else if (OPTIGA_SHELL_HYBRID_OPTIGA_ONLY == threshold)
+        {
+            /*
+             * The host is faster from here on, so far. If it already is on the shortest length,
+             * all data goes to the host.
+             */
+            threshold = (OPTIGA_SHELL_HYBRID_BENCH_MIN_LENGTH == length) ? 0U : length;
+        }
+    }
+    *p_threshold = threshold;
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+/**
+ * Resolves #OPTIGA_SHELL_HYBRID_ENGINE_AUTO from the length, measuring the threshold first if
+ * #OPTIGA_SHELL_HYBRID_CALIBRATE asks for it
+ */
+static uint8_t optiga_shell_hybrid_select(uint32_t length, uint8_t engine)
+{
+    uint32_t threshold;
+
+    if (OPTIGA_SHELL_HYBRID_ENGINE_AUTO == engine)
+    {
+        if (FALSE == optiga_shell_hybrid_measured)
+        {
+            /*
+             * Measured once, a failed measurement keeps #OPTIGA_SHELL_HYBRID_THRESHOLD
+             */
+            optiga_shell_hybrid_measured = TRUE;
+            if (OPTIGA_LIB_SUCCESS == optiga_shell_hybrid_crossover(OPTIGA_SHELL_HYBRID_CALIBRATE_MAX_LENGTH, 1, FALSE,
+                                                                   &threshold))
+            {
+                optiga_shell_hybrid_threshold = threshold;
+            }
+        }
+        engine = (length >= optiga_shell_hybrid_threshold) ? OPTIGA_SHELL_HYBRID_ENGINE_HOST :
+                                                             OPTIGA_SHELL_HYBRID_ENGINE_OPTIGA;
+    }
+    return (engine);
+}
+
+optiga_lib_status_t optiga_shell_hybrid_hash(const uint8_t * p_data,
+                                             uint32_t length,
+                                             uint8_t engine,
+                                             uint8_t * p_digest,
+                                             uint8_t * p_used)
+{
+    engine = optiga_shell_hybrid_select(length, engine);
+    if (NULL != p_used)
+    {
+        *p_used = engine;
+    }
+    return (optiga_shell_hybrid_run(p_data, 0, length, engine, p_digest));
+}
+
+void optiga_shell_hybrid_set_threshold(uint32_t threshold)
+{
+    optiga_shell_hybrid_threshold = threshold;
+    optiga_shell_hybrid_measured = TRUE;
+}
+
+uint32_t optiga_shell_hybrid_get_threshold(void)
+{
+    return (optiga_shell_hybrid_threshold);
+}
+
+/**
+ * Measures both engines and sets the threshold to the shortest length from which the host stays
+ * faster
+ */
+static void optiga_shell_hybrid_bench(uint32_t iterations)
+{
+    uint32_t threshold;
+    char_t line[100];
+
+    if (OPTIGA_LIB_SUCCESS != optiga_shell_hybrid_crossover(OPTIGA_SHELL_HYBRID_BENCH_MAX_LENGTH, iterations, TRUE,
+                                                               &threshold))
+    {
+        optiga_lib_print_string_with_newline("Threshold unchanged");
+        return;
+    }
+    optiga_shell_hybrid_set_threshold(threshold);
+    if (0U == threshold)
+    {
+        snprintf(line, sizeof(line), "Threshold: 0, all data is hashed on the host");
+    }
+    else if (OPTIGA_SHELL_HYBRID_OPTIGA_ONLY == threshold)
+    {
+        snprintf(line, sizeof(line), "Threshold: 0x%08lX, all data is hashed on OPTIGA", (unsigned long)threshold);
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "Threshold: %lu bytes, shorter data is hashed on OPTIGA",
+                 (unsigned long)threshold);
+    }
+    optiga_lib_print_string_with_newline(line);
+}
+
+void optiga_shell_cmd_hybridhash(optiga_shell_args_t * p_args)
+{
+    static const optiga_shell_args_choice_t engines[] =
+    {
+        {"auto",    OPTIGA_SHELL_HYBRID_ENGINE_AUTO},
+        {"host",    OPTIGA_SHELL_HYBRID_ENGINE_HOST},
+        {"optiga",  OPTIGA_SHELL_HYBRID_ENGINE_OPTIGA},
+    };
+    static const optiga_shell_args_choice_t bench_modes[] =
+    {
+        {"off",     FALSE},
+        {"on",      TRUE},
+    };
+    optiga_lib_status_t return_status;
+    uint8_t digest[OPTIGA_SHELL_HYBRID_DIGEST_LENGTH];
+    uint32_t length;
+    uint32_t engine;
+    uint32_t bench;
+    uint32_t iterations;
+    uint32_t elapsed_us;
+    uint32_t index;
+    uint8_t used;
+    size_t offset;
+    char_t line[160];
+
+    if ((FALSE == optiga_shell_args_get_number(p_args, "length", 32, 0, OPTIGA_SHELL_HYBRID_MAX_LENGTH, &length)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "engine", engines,
+                                               (uint8_t)(sizeof(engines) / sizeof(engines[0])),
+                                               OPTIGA_SHELL_HYBRID_ENGINE_AUTO, &engine)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "bench", bench_modes,
+                                               (uint8_t)(sizeof(bench_modes) / sizeof(bench_modes[0])),
+                                               FALSE, &bench)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "iterations", OPTIGA_SHELL_HYBRID_BENCH_ITERATIONS, 1,
+                                               OPTIGA_SHELL_HYBRID_BENCH_MAX_ITERATIONS, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+
+    if (TRUE == bench)
+    {
+        optiga_shell_hybrid_bench(iterations);
+        return;
+    }
+
+    /*
+     * The engine is selected first, so a calibration is not part of the time
+     */
+    used = optiga_shell_hybrid_select(length, (uint8_t)engine);
+    optiga_shell_hybrid_fill_pattern();
+    elapsed_us = pal_os_timer_get_time_in_microseconds();
+    return_status = optiga_shell_hybrid_run(optiga_shell_hybrid_pattern, OPTIGA_SHELL_HYBRID_PATTERN_PERIOD, length,
+                                            used, digest);
+    elapsed_us = pal_os_timer_get_time_in_microseconds() - elapsed_us;
+
+    optiga_lib_print_string_with_newline("length,engine,threshold,elapsed_us,status,sha256");
+    offset = (size_t)snprintf(line, sizeof(line), "%lu,%s,%lu,%lu,0x%04X,", (unsigned long)length,
+                              optiga_shell_hybrid_engine_names[used], (unsigned long)optiga_shell_hybrid_threshold,
+                              (unsigned long)elapsed_us, (unsigned int)return_status);
+    for (index = 0; (OPTIGA_LIB_SUCCESS == return_status) && (index < sizeof(digest)); index++)
+    {
+        offset += (size_t)snprintf(&line[offset], sizeof(line) - offset, "%02X", digest[index]);
+    }
+    optiga_lib_print_string_with_newline(line);
+}
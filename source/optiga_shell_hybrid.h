@@ -0,0 +1,161 @@
+/******************************************************************************
+* File Name:   optiga_shell_hybrid.h
+*
+* Description: SHA-256 on the host or on OPTIGA, selected from the data length
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_HYBRID_H_
+#define _OPTIGA_SHELL_HYBRID_H_
+
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga/common/optiga_lib_return_codes.h"
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Engines of #optiga_shell_hybrid_hash */
+/// Selected from the length of the data, see #optiga_shell_hybrid_set_threshold
+#define OPTIGA_SHELL_HYBRID_ENGINE_AUTO         (0U)
+/// SHA-256 of mbedTLS on the host core
+#define OPTIGA_SHELL_HYBRID_ENGINE_HOST         (1U)
+/// SHA-256 on OPTIGA, for digests which must come from the chip
+#define OPTIGA_SHELL_HYBRID_ENGINE_OPTIGA       (2U)
+
+/** @brief Length of a SHA-256 digest */
+#define OPTIGA_SHELL_HYBRID_DIGEST_LENGTH       (32U)
+
+/**
+ * @brief Measure the crossover of both engines on the first #OPTIGA_SHELL_HYBRID_ENGINE_AUTO hash
+ * and use it as threshold, one run per length of the benchmark up to
+ * #OPTIGA_SHELL_HYBRID_CALIBRATE_MAX_LENGTH. 0 uses #OPTIGA_SHELL_HYBRID_THRESHOLD as it is.
+ */
+#ifndef OPTIGA_SHELL_HYBRID_CALIBRATE
+#define OPTIGA_SHELL_HYBRID_CALIBRATE           (1U)
+#endif
+#ifndef OPTIGA_SHELL_HYBRID_CALIBRATE_MAX_LENGTH
+#define OPTIGA_SHELL_HYBRID_CALIBRATE_MAX_LENGTH    (4096U)
+#endif
+
+/**
+ * @brief Data from this length on is hashed on the host by #OPTIGA_SHELL_HYBRID_ENGINE_AUTO,
+ * shorter data on OPTIGA. 0 hashes everything on the host, 0xFFFFFFFF everything on OPTIGA.
+ * Replaced by the measured crossover, see #OPTIGA_SHELL_HYBRID_CALIBRATE, and kept if the
+ * measurement fails. The host simulator measures 0, the host is faster at every length.
+ */
+#ifndef OPTIGA_SHELL_HYBRID_THRESHOLD
+#define OPTIGA_SHELL_HYBRID_THRESHOLD           (0U)
+#endif
+
+/** @brief Largest data of optiga --hybridhash, both engines get it in chunks as optiga --hashstream */
+#define OPTIGA_SHELL_HYBRID_MAX_LENGTH          (0xFFFFFFFFU)
+
+/** @brief Longest data of the crossover benchmark */
+#ifndef OPTIGA_SHELL_HYBRID_BENCH_MAX_LENGTH
+#define OPTIGA_SHELL_HYBRID_BENCH_MAX_LENGTH    (65536U)
+#endif
+
+/** @brief Default and largest number of runs per length and engine of the crossover benchmark */
+#define OPTIGA_SHELL_HYBRID_BENCH_ITERATIONS        (5U)
+#define OPTIGA_SHELL_HYBRID_BENCH_MAX_ITERATIONS    (100U)
+
+/** @brief mbedTLS failed to hash on the host */
+#define OPTIGA_SHELL_HYBRID_ERROR_HOST_HASH     (0xF201)
+/** @brief The engines computed different digests for the same data */
+#define OPTIGA_SHELL_HYBRID_ERROR_MISMATCH      (0xF202)
+
+/** @brief Argument usage of the hybridhash command, as shown by help */
+#define OPTIGA_SHELL_HYBRID_USAGE               "[--length <bytes>] [--engine auto|host|optiga] [--bench on|off] " \
+                                                "[--iterations <n>]"
+
+/**
+ * @brief SHA-256 of host data on the engine given, or selected from the length of the data.
+ *
+ * Both engines get the data in chunks of #OPTIGA_SHELL_HASHSTREAM_CHUNK_SIZE, OPTIGA one command
+ * per chunk. Both engines give the same digest for the same data. The first
+ * #OPTIGA_SHELL_HYBRID_ENGINE_AUTO hash may measure the threshold first, see
+ * #OPTIGA_SHELL_HYBRID_CALIBRATE.
+ *
+ * @param[in]  p_data     Data to hash
+ * @param[in]  length     Length of the data
+ * @param[in]  engine     #OPTIGA_SHELL_HYBRID_ENGINE_AUTO, #OPTIGA_SHELL_HYBRID_ENGINE_HOST or
+ *                        #OPTIGA_SHELL_HYBRID_ENGINE_OPTIGA
+ * @param[out] p_digest   Digest, #OPTIGA_SHELL_HYBRID_DIGEST_LENGTH bytes
+ * @param[out] p_used     Engine which computed the digest, may be NULL
+ *
+ * @retval #OPTIGA_LIB_SUCCESS                   The digest is computed
+ * @retval #OPTIGA_SHELL_HYBRID_ERROR_HOST_HASH  mbedTLS failed
+ * @retval Error of optiga_crypt otherwise
+ */
+optiga_lib_status_t optiga_shell_hybrid_hash(const uint8_t * p_data,
+                                             uint32_t length,
+                                             uint8_t engine,
+                                             uint8_t * p_digest,
+                                             uint8_t * p_used);
+
+/**
+ * @brief Sets the length from which #OPTIGA_SHELL_HYBRID_ENGINE_AUTO hashes on the host, until
+ * the next reset.
+ */
+void optiga_shell_hybrid_set_threshold(uint32_t threshold);
+
+/**
+ * @brief Returns the length from which #OPTIGA_SHELL_HYBRID_ENGINE_AUTO hashes on the host.
+ */
+uint32_t optiga_shell_hybrid_get_threshold(void);
+
+/**
+ * @brief Hashes --length bytes of a counting pattern on the --engine given, or measures the
+ * crossover of both engines.
+ *
+ * --bench on hashes 16 to #OPTIGA_SHELL_HYBRID_BENCH_MAX_LENGTH bytes, doubling the length, on
+ * both engines --iterations times each and prints one CSV line per length with the average time
+ * of each engine and whether the digests match. A row where an engine failed is not compared and
+ * ends the benchmark. The threshold of #OPTIGA_SHELL_HYBRID_ENGINE_AUTO is then set to the
+ * shortest length from which the host is faster for all longer lengths measured.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_hybridhash(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_HYBRID_H_ */
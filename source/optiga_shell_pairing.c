@@ -0,0 +1,240 @@
+/******************************************************************************
+* File Name:   optiga_shell_pairing.c
+*
+* Description: Host and OPTIGA pairing which is recorded in the shell store and
+*              verified with one UID read on the next boots instead of pairing again.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+
+#include "optiga/optiga_util.h"
+#include "optiga/pal/pal_os_datastore.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "mbedtls/md.h"
+#include "optiga_shell_pairing.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_store.h"
+
+#define OPTIGA_SHELL_PAIRING_RECORD_VERSION (0x50520001U)
+#define OPTIGA_SHELL_PAIRING_UID_OID        (0xE0C2U)
+#define OPTIGA_SHELL_PAIRING_UID_LENGTH     (27U)
+#define OPTIGA_SHELL_PAIRING_SECRET_LENGTH  (64U)
+#define OPTIGA_SHELL_PAIRING_DIGEST_LENGTH  (32U)
+
+/** @brief Pairing record kept in the shell store */
+typedef struct optiga_shell_pairing_record
+{
+    uint32_t version;
+    /// SHA-256 of the coprocessor UID followed by the binding secret
+    uint8_t fingerprint[OPTIGA_SHELL_PAIRING_DIGEST_LENGTH];
+    uint32_t pairing_us;
+} optiga_shell_pairing_record_t;
+
+#ifdef OPTIGA_COMMS_SHIELDED_CONNECTION
+extern optiga_lib_status_t pair_host_and_optiga_using_pre_shared_secret(void);
+
+static optiga_shell_request_t optiga_shell_pairing_request;
+static bool_t optiga_shell_pairing_done = FALSE;
+static optiga_shell_pairing_report_t optiga_shell_pairing_report;
+
+/**
+ * Computes the fingerprint of this OPTIGA and the binding secret stored on the host
+ */
+static optiga_lib_status_t optiga_shell_pairing_fingerprint(uint8_t * p_fingerprint)
+{
+    uint8_t buffer[OPTIGA_SHELL_PAIRING_UID_LENGTH + OPTIGA_SHELL_PAIRING_SECRET_LENGTH];
+    uint16_t uid_length = OPTIGA_SHELL_PAIRING_UID_LENGTH;
+    uint16_t secret_length = OPTIGA_SHELL_PAIRING_SECRET_LENGTH;
+    optiga_lib_status_t return_status;
+    optiga_util_t * me;
+
+    me = optiga_shell_pool_get_util(&optiga_shell_pairing_request);
+    if (NULL == me)
+    {
+        return (OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT);
+    }
+    return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_pairing_request,
+                                             optiga_util_read_data(me, OPTIGA_SHELL_PAIRING_UID_OID, 0,
+                                                                   buffer, &uid_length));
+    (void)optiga_shell_pool_put_util(me);
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return (return_status);
+    }
+    if (PAL_STATUS_SUCCESS != pal_os_datastore_read(OPTIGA_PLATFORM_BINDING_SHARED_SECRET_ID,
+                                                    &buffer[uid_length], &secret_length))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    if (0 != mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), buffer,
+                        (size_t)uid_length + secret_length, p_fingerprint))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+/**
+ * Tells whether the stored record belongs to this OPTIGA and to the stored binding secret
+ */
+static bool_t optiga_shell_pairing_verify(const optiga_shell_pairing_record_t * p_record)
+{
+    uint8_t fingerprint[OPTIGA_SHELL_PAIRING_DIGEST_LENGTH];
+
+    if ((OPTIGA_SHELL_PAIRING_RECORD_VERSION != p_record->version) ||
+        (OPTIGA_LIB_SUCCESS != optiga_shell_pairing_fingerprint(fingerprint)))
+    {
+        return (FALSE);
+    }
+    return ((0 == memcmp(fingerprint, p_record->fingerprint, sizeof(fingerprint))) ? TRUE : FALSE);
+}
+
+/**
+ * Keeps the binding secret of the last pairing in the shell store, the PAL of the platform holds
+ * it in RAM only
+ */
+static pal_status_t optiga_shell_pairing_save_secret(void)
+{
+    uint8_t secret[OPTIGA_SHELL_PAIRING_SECRET_LENGTH];
+    uint16_t secret_length = sizeof(secret);
+
+    if (PAL_STATUS_SUCCESS != pal_os_datastore_read(OPTIGA_PLATFORM_BINDING_SHARED_SECRET_ID, secret,
+                                                    &secret_length))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    return (optiga_shell_store_write(OPTIGA_PLATFORM_BINDING_SHARED_SECRET_ID, secret, secret_length));
+}
+#endif
+
+void optiga_shell_pairing_load_secret(void)
+{
+#ifdef OPTIGA_COMMS_SHIELDED_CONNECTION
+    uint8_t stored[OPTIGA_SHELL_PAIRING_SECRET_LENGTH];
+    uint8_t current[OPTIGA_SHELL_PAIRING_SECRET_LENGTH];
+    uint16_t stored_length = sizeof(stored);
+    uint16_t current_length = sizeof(current);
+
+    if (PAL_STATUS_SUCCESS != optiga_shell_store_read(OPTIGA_PLATFORM_BINDING_SHARED_SECRET_ID, stored,
+                                                      &stored_length))
+    {
+        return;
+    }
+    if ((PAL_STATUS_SUCCESS == pal_os_datastore_read(OPTIGA_PLATFORM_BINDING_SHARED_SECRET_ID, current,
+                                                     &current_length)) &&
+        (stored_length == current_length) && (0 == memcmp(stored, current, stored_length)))
+    {
+        return;
+    }
+    /*
+     * If the PAL refuses it, the record does not verify and the shell pairs again
+     */
+    (void)pal_os_datastore_write(OPTIGA_PLATFORM_BINDING_SHARED_SECRET_ID, stored, stored_length);
+#endif
+}
+
+optiga_lib_status_t optiga_shell_pairing_ensure(optiga_shell_pairing_report_t * p_report)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+#ifdef OPTIGA_COMMS_SHIELDED_CONNECTION
+    optiga_shell_pairing_record_t record;
+    uint16_t record_length = sizeof(record);
+    uint32_t start_us;
+
+    do
+    {
+        if (TRUE == optiga_shell_pairing_done)
+        {
+            break;
+        }
+
+        start_us = pal_os_timer_get_time_in_microseconds();
+        if ((PAL_STATUS_SUCCESS == optiga_shell_store_read(OPTIGA_SHELL_PAIRING_RECORD_ID, (uint8_t *)&record,
+                                                           &record_length)) &&
+            (sizeof(record) == record_length) && (TRUE == optiga_shell_pairing_verify(&record)))
+        {
+            optiga_shell_pairing_report.result = OPTIGA_SHELL_PAIRING_VERIFIED;
+            optiga_shell_pairing_report.pairing_us = record.pairing_us;
+            optiga_shell_pairing_report.verify_us = pal_os_timer_get_time_in_microseconds() - start_us;
+            optiga_shell_pairing_report.record_status = PAL_STATUS_SUCCESS;
+            optiga_shell_pairing_done = TRUE;
+            break;
+        }
+
+        /*
+         * No record, another OPTIGA or another secret: pair and record the result
+         */
+        start_us = pal_os_timer_get_time_in_microseconds();
+        return_status = pair_host_and_optiga_using_pre_shared_secret();
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        optiga_shell_pairing_report.result = OPTIGA_SHELL_PAIRING_PAIRED;
+        optiga_shell_pairing_report.pairing_us = pal_os_timer_get_time_in_microseconds() - start_us;
+        optiga_shell_pairing_report.verify_us = 0;
+        optiga_shell_pairing_done = TRUE;
+
+        /*
+         * Without the secret and the record the next boot pairs again, which is reported but
+         * not an error of the pairing
+         */
+        record.version = OPTIGA_SHELL_PAIRING_RECORD_VERSION;
+        record.pairing_us = optiga_shell_pairing_report.pairing_us;
+        optiga_shell_pairing_report.record_status = PAL_STATUS_FAILURE;
+        if ((PAL_STATUS_SUCCESS == optiga_shell_pairing_save_secret()) &&
+            (OPTIGA_LIB_SUCCESS == optiga_shell_pairing_fingerprint(record.fingerprint)))
+        {
+            optiga_shell_pairing_report.record_status =
+                optiga_shell_store_write(OPTIGA_SHELL_PAIRING_RECORD_ID, (const uint8_t *)&record, sizeof(record));
+        }
+    } while (FALSE);
+
+    if (NULL != p_report)
+    {
+        *p_report = optiga_shell_pairing_report;
+    }
+#else
+    if (NULL != p_report)
+    {
+        memset(p_report, 0, sizeof(*p_report));
+    }
+#endif
+    return (return_status);
+}
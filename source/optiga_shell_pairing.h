@@ -0,0 +1,106 @@
+/******************************************************************************
+* File Name:   optiga_shell_pairing.h
+*
+* Description: Pairing record to skip the host and OPTIGA pairing on boot
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_PAIRING_H_
+#define _OPTIGA_SHELL_PAIRING_H_
+
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga/common/optiga_lib_return_codes.h"
+#include "optiga/pal/pal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Id of the pairing record in the shell store, see optiga_shell_store.h. The binding secret
+ * is kept there as well, under #OPTIGA_PLATFORM_BINDING_SHARED_SECRET_ID.
+ */
+#ifndef OPTIGA_SHELL_PAIRING_RECORD_ID
+#define OPTIGA_SHELL_PAIRING_RECORD_ID      (0x20U)
+#endif
+
+/** @brief Result of #optiga_shell_pairing_ensure */
+#define OPTIGA_SHELL_PAIRING_NONE           (0U)
+#define OPTIGA_SHELL_PAIRING_VERIFIED       (1U)
+#define OPTIGA_SHELL_PAIRING_PAIRED         (2U)
+
+/** @brief Outcome of the last #optiga_shell_pairing_ensure */
+typedef struct optiga_shell_pairing_report
+{
+    /// #OPTIGA_SHELL_PAIRING_VERIFIED if the record matched, #OPTIGA_SHELL_PAIRING_PAIRED otherwise
+    uint8_t result;
+    /// Time of the pairing which wrote the record, in microseconds
+    uint32_t pairing_us;
+    /// Time of checking the record, in microseconds
+    uint32_t verify_us;
+    /// #PAL_STATUS_SUCCESS if the record is kept for the next boot
+    pal_status_t record_status;
+} optiga_shell_pairing_report_t;
+
+/**
+ * @brief Makes sure the host and OPTIGA share the platform binding secret, pairing only if needed.
+ *
+ * The record written after a pairing holds a SHA-256 fingerprint of the coprocessor UID (0xE0C2)
+ * and of the binding secret, both kept in the shell store. If the record matches, the pairing
+ * round trips (metadata read, TRNG, secret and metadata writes) are skipped and only the UID is
+ * read. Once verified, later calls return right away until the next reset. The application must
+ * be open.
+ *
+ * @param[out] p_report  Outcome and times, may be NULL
+ *
+ * @retval #OPTIGA_LIB_SUCCESS  The host and OPTIGA are paired
+ * @retval Error of the pairing otherwise
+ */
+optiga_lib_status_t optiga_shell_pairing_ensure(optiga_shell_pairing_report_t * p_report);
+
+/**
+ * @brief Hands the binding secret of the last pairing from the shell store to the PAL.
+ *
+ * Called on boot before the first shielded command. Without a stored secret the PAL keeps its own.
+ */
+void optiga_shell_pairing_load_secret(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_PAIRING_H_ */
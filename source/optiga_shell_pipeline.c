@@ -0,0 +1,323 @@
+/******************************************************************************
+* File Name:   optiga_shell_pipeline.c
+*
+* Description: Throughput of a mixed sign, hash and random workload run one operation
+*              at a time and through the command queue of the shell.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "mbedtls/md.h"
+#include "optiga_shell_pipeline.h"
+#include "optiga_shell_queue.h"
+
+#define OPTIGA_SHELL_PIPELINE_SIGN          (0U)
+#define OPTIGA_SHELL_PIPELINE_HASH          (1U)
+#define OPTIGA_SHELL_PIPELINE_RANDOM        (2U)
+#define OPTIGA_SHELL_PIPELINE_KINDS         (3U)
+
+#define OPTIGA_SHELL_PIPELINE_DIGEST_LENGTH (32U)
+#define OPTIGA_SHELL_PIPELINE_RANDOM_LENGTH (64U)
+
+/** @brief Inputs and result of the operation of one queue slot */
+typedef struct optiga_shell_pipeline_job
+{
+    uint32_t number;
+    uint8_t kind;
+    uint16_t output_length;
+    hash_data_from_host_t hash_data;
+    uint8_t digest[OPTIGA_SHELL_PIPELINE_DIGEST_LENGTH];
+    uint8_t output[OPTIGA_SHELL_PIPELINE_RANDOM_LENGTH + 16U];
+    uint8_t message[OPTIGA_SHELL_PIPELINE_MAX_PAYLOAD];
+} optiga_shell_pipeline_job_t;
+
+/** @brief State of one run of the workload */
+typedef struct optiga_shell_pipeline_run
+{
+    uint32_t payload_length;
+    uint32_t work_us;
+    bool_t log;
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t failed;
+    uint32_t mismatches;
+    /// Time the host spent preparing operations and consuming results
+    uint32_t host_us;
+    optiga_lib_status_t first_error;
+} optiga_shell_pipeline_run_t;
+
+static const char_t * const optiga_shell_pipeline_kind_names[OPTIGA_SHELL_PIPELINE_KINDS] =
+{
+    "sign", "hash", "random"
+};
+
+static optiga_shell_queue_t optiga_shell_pipeline_queue;
+static optiga_shell_pipeline_job_t optiga_shell_pipeline_jobs[OPTIGA_SHELL_QUEUE_MAX_DEPTH];
+static char_t optiga_shell_pipeline_text[2U * (OPTIGA_SHELL_PIPELINE_RANDOM_LENGTH + 16U) + 32U];
+
+/**
+ * Host side preparation: the message of the job and its SHA-256
+ */
+static void optiga_shell_pipeline_prepare(optiga_shell_pipeline_job_t * p_job, uint32_t payload_length)
+{
+    uint32_t index;
+
+    for (index = 0; index < payload_length; index++)
+    {
+        p_job->message[index] = (uint8_t)(p_job->number + (index * 31U));
+    }
+    (void)mbedtls_md(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), p_job->message, payload_length, p_job->digest);
+}
+
+static optiga_lib_status_t optiga_shell_pipeline_issue(optiga_crypt_t * me, uint8_t slot, void * context)
+{
+    optiga_shell_pipeline_run_t * p_run = (optiga_shell_pipeline_run_t *)context;
+    optiga_shell_pipeline_job_t * p_job = &optiga_shell_pipeline_jobs[slot];
+    optiga_lib_status_t return_status;
+    uint32_t start_us = pal_os_timer_get_time_in_microseconds();
+
+    p_job->number = p_run->submitted++;
+    p_job->kind = (uint8_t)(p_job->number % OPTIGA_SHELL_PIPELINE_KINDS);
+    p_job->output_length = sizeof(p_job->output);
+
+    switch (p_job->kind)
+    {
+        case OPTIGA_SHELL_PIPELINE_SIGN:
+        {
+            optiga_shell_pipeline_prepare(p_job, p_run->payload_length);
+            p_run->host_us += pal_os_timer_get_time_in_microseconds() - start_us;
+            return_status = optiga_crypt_ecdsa_sign(me,
+                                                    p_job->digest,
+                                                    sizeof(p_job->digest),
+                                                    OPTIGA_KEY_ID_E0F0,
+                                                    p_job->output,
+                                                    &p_job->output_length);
+            break;
+        }
+        case OPTIGA_SHELL_PIPELINE_HASH:
+        {
+            optiga_shell_pipeline_prepare(p_job, p_run->payload_length);
+            p_job->hash_data.buffer = p_job->message;
+            p_job->hash_data.length = p_run->payload_length;
+            p_job->output_length = OPTIGA_SHELL_PIPELINE_DIGEST_LENGTH;
+            p_run->host_us += pal_os_timer_get_time_in_microseconds() - start_us;
+            return_status = optiga_crypt_hash(me,
+                                              OPTIGA_HASH_TYPE_SHA_256,
+                                              OPTIGA_CRYPT_HOST_DATA,
+                                              &p_job->hash_data,
+                                              p_job->output);
+            break;
+        }
+        default:
+        {
+            p_job->output_length = OPTIGA_SHELL_PIPELINE_RANDOM_LENGTH;
+            p_run->host_us += pal_os_timer_get_time_in_microseconds() - start_us;
+            return_status = optiga_crypt_random(me,
+                                                OPTIGA_RNG_TYPE_TRNG,
+                                                p_job->output,
+                                                OPTIGA_SHELL_PIPELINE_RANDOM_LENGTH);
+            break;
+        }
+    }
+    return (return_status);
+}
+
+static void optiga_shell_pipeline_done(uint8_t slot, optiga_lib_status_t status, void * context)
+{
+    optiga_shell_pipeline_run_t * p_run = (optiga_shell_pipeline_run_t *)context;
+    const optiga_shell_pipeline_job_t * p_job = &optiga_shell_pipeline_jobs[slot];
+    uint32_t start_us = pal_os_timer_get_time_in_microseconds();
+    uint32_t length;
+    uint16_t index;
+
+    p_run->completed++;
+    if (OPTIGA_LIB_SUCCESS != status)
+    {
+        if (0U == p_run->failed)
+        {
+            p_run->first_error = status;
+        }
+        p_run->failed++;
+        return;
+    }
+    if ((OPTIGA_SHELL_PIPELINE_HASH == p_job->kind) &&
+        (0 != memcmp(p_job->output, p_job->digest, OPTIGA_SHELL_PIPELINE_DIGEST_LENGTH)))
+    {
+        p_run->mismatches++;
+    }
+
+    length = (uint32_t)sprintf(optiga_shell_pipeline_text, "%lu %s ",
+                               (unsigned long)p_job->number, optiga_shell_pipeline_kind_names[p_job->kind]);
+    for (index = 0; index < p_job->output_length; index++)
+    {
+        length += (uint32_t)sprintf(&optiga_shell_pipeline_text[length], "%02X", p_job->output[index]);
+    }
+    if (TRUE == p_run->log)
+    {
+        optiga_lib_print_string_with_newline(optiga_shell_pipeline_text);
+    }
+
+    /*
+     * Further processing of the result by the application, e.g. sending it over a slow link
+     */
+    while ((pal_os_timer_get_time_in_microseconds() - start_us) < p_run->work_us)
+    {
+    }
+    p_run->host_us += pal_os_timer_get_time_in_microseconds() - start_us;
+}
+
+/**
+ * Runs the workload with the given number of operations in flight
+ */
+static optiga_lib_status_t optiga_shell_pipeline_run(optiga_shell_pipeline_run_t * p_run,
+                                                     uint32_t jobs,
+                                                     uint8_t depth,
+                                                     uint32_t * p_elapsed_us)
+{
+    optiga_lib_status_t return_status;
+    uint32_t start_us;
+
+    p_run->submitted = 0;
+    p_run->completed = 0;
+    p_run->failed = 0;
+    p_run->mismatches = 0;
+    p_run->host_us = 0;
+    p_run->first_error = OPTIGA_LIB_SUCCESS;
+
+    return_status = optiga_shell_queue_open(&optiga_shell_pipeline_queue, depth);
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return (return_status);
+    }
+    start_us = pal_os_timer_get_time_in_microseconds();
+    while ((p_run->submitted < jobs) && (0U == p_run->failed))
+    {
+        (void)optiga_shell_queue_submit(&optiga_shell_pipeline_queue,
+                                        optiga_shell_pipeline_issue,
+                                        optiga_shell_pipeline_done,
+                                        p_run);
+    }
+    optiga_shell_queue_drain(&optiga_shell_pipeline_queue);
+    *p_elapsed_us = pal_os_timer_get_time_in_microseconds() - start_us;
+    optiga_shell_queue_close(&optiga_shell_pipeline_queue);
+
+    return (p_run->first_error);
+}
+
+static void optiga_shell_pipeline_print(const optiga_shell_pipeline_run_t * p_run,
+                                        uint8_t depth,
+                                        uint32_t elapsed_us,
+                                        optiga_lib_status_t return_status)
+{
+    char_t line[120];
+    uint32_t rate = (0U != elapsed_us) ? (uint32_t)(((uint64_t)p_run->completed * 1000000000ULL) / elapsed_us) : 0U;
+
+    snprintf(line, sizeof(line), "%u,%lu,%lu,%lu,%lu.%03lu,%lu,0x%04X",
+             (unsigned int)depth, (unsigned long)p_run->completed, (unsigned long)(elapsed_us / 1000U),
+             (unsigned long)(p_run->host_us / 1000U), (unsigned long)(rate / 1000U), (unsigned long)(rate % 1000U),
+             (unsigned long)p_run->mismatches, (unsigned int)return_status);
+    optiga_lib_print_string_with_newline(line);
+}
+
+void optiga_shell_cmd_pipeline(optiga_shell_args_t * p_args)
+{
+    static const optiga_shell_args_choice_t log_modes[] =
+    {
+        {"off",     FALSE},
+        {"on",      TRUE},
+    };
+    optiga_shell_pipeline_run_t run;
+    optiga_lib_status_t return_status;
+    uint32_t elapsed_us[2] = {0, 0};
+    uint32_t bound_us;
+    uint32_t jobs;
+    uint32_t depth;
+    uint32_t log;
+    char_t line[80];
+
+    if ((FALSE == optiga_shell_args_get_number(p_args, "jobs", OPTIGA_SHELL_PIPELINE_DEFAULT_JOBS, 1,
+                                               OPTIGA_SHELL_PIPELINE_MAX_JOBS, &jobs)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "depth", OPTIGA_SHELL_PIPELINE_DEFAULT_DEPTH, 1,
+                                               OPTIGA_SHELL_QUEUE_MAX_DEPTH, &depth)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "payload", OPTIGA_SHELL_PIPELINE_DEFAULT_PAYLOAD, 1,
+                                               OPTIGA_SHELL_PIPELINE_MAX_PAYLOAD, &run.payload_length)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "work", 0, 0, OPTIGA_SHELL_PIPELINE_MAX_WORK_US, &run.work_us)) ||
+        (FALSE == optiga_shell_args_get_choice(p_args, "log", log_modes, (uint8_t)(sizeof(log_modes) / sizeof(log_modes[0])),
+                                               FALSE, &log)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    run.log = (bool_t)log;
+
+    optiga_lib_print_string_with_newline("depth,jobs,elapsed_ms,host_ms,jobs_per_s,mismatches,status");
+    /*
+     * One operation at a time as the reference, then the requested depth
+     */
+    return_status = optiga_shell_pipeline_run(&run, jobs, 1U, &elapsed_us[0]);
+    optiga_shell_pipeline_print(&run, 1U, elapsed_us[0], return_status);
+    if ((OPTIGA_LIB_SUCCESS != return_status) || (1U == depth))
+    {
+        return;
+    }
+    /*
+     * Operations in flight only hide the host time, the run takes at least the longer of the
+     * chip time and the host time
+     */
+    bound_us = ((elapsed_us[0] - run.host_us) > run.host_us) ? (elapsed_us[0] - run.host_us) : run.host_us;
+    return_status = optiga_shell_pipeline_run(&run, jobs, (uint8_t)depth, &elapsed_us[1]);
+    optiga_shell_pipeline_print(&run, (uint8_t)depth, elapsed_us[1], return_status);
+    if ((OPTIGA_LIB_SUCCESS == return_status) && (0U != elapsed_us[1]))
+    {
+        snprintf(line, sizeof(line), "Speedup of depth %u: %lu.%02lux",
+                 (unsigned int)depth, (unsigned long)(elapsed_us[0] / elapsed_us[1]),
+                 (unsigned long)((((uint64_t)elapsed_us[0] * 100U) / elapsed_us[1]) % 100U));
+        optiga_lib_print_string_with_newline(line);
+    }
+    if (0U != bound_us)
+    {
+        snprintf(line, sizeof(line), "Expected speedup with all host time hidden: %lu.%02lux",
+                 (unsigned long)(elapsed_us[0] / bound_us),
+                 (unsigned long)((((uint64_t)elapsed_us[0] * 100U) / bound_us) % 100U));
+        optiga_lib_print_string_with_newline(line);
+    }
+}
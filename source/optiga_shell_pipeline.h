@@ -0,0 +1,91 @@
+/******************************************************************************
+* File Name:   optiga_shell_pipeline.h
+*
+* Description: Throughput of a mixed workload with several OPTIGA operations in flight
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_PIPELINE_H_
+#define _OPTIGA_SHELL_PIPELINE_H_
+
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Default and largest number of operations of the workload */
+#define OPTIGA_SHELL_PIPELINE_DEFAULT_JOBS      (60U)
+#define OPTIGA_SHELL_PIPELINE_MAX_JOBS          (10000U)
+
+/** @brief Default number of operations in flight */
+#define OPTIGA_SHELL_PIPELINE_DEFAULT_DEPTH     (4U)
+
+/** @brief Default and largest message size of the sign and hash operations, in bytes */
+#define OPTIGA_SHELL_PIPELINE_DEFAULT_PAYLOAD   (1024U)
+#define OPTIGA_SHELL_PIPELINE_MAX_PAYLOAD       (2048U)
+
+/** @brief Largest time of the application processing of each result, in microseconds */
+#define OPTIGA_SHELL_PIPELINE_MAX_WORK_US       (1000000U)
+
+/** @brief Argument usage of the pipeline command, as shown by help */
+#define OPTIGA_SHELL_PIPELINE_USAGE             "[--jobs <n>] [--depth <1..5>] [--payload <bytes>] [--work <usec>] [--log on|off]"
+
+/**
+ * @brief Measures the throughput of a mixed workload with several operations in flight.
+ *
+ * The workload cycles through ECDSA sign (E0F0) of the host computed SHA-256 of a message,
+ * SHA-256 of the message on OPTIGA and 64 bytes of TRNG. The host prepares each message and
+ * hashes it, then checks the OPTIGA digests against its own, hex encodes the results and logs
+ * them with --log on. --work adds the given time of application processing per result, e.g.
+ * a 115200 baud link takes about 13 msec for a logged signature. The workload runs once with
+ * one operation at a time and once through #optiga_shell_queue_t with --depth crypt instances,
+ * so the host work overlaps with the execution on the chip. Elapsed time, host time, operations
+ * per second and the speedup are printed, with the speedup expected if all the host time were
+ * hidden. Without --work the host time is small and so is the gain.
+ *
+ * The shell opens the application before the command runs.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_pipeline(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_PIPELINE_H_ */
@@ -0,0 +1,287 @@
+/******************************************************************************
+* File Name:   optiga_shell_policy.c
+*
+* Description: Per command protection policy of the shielded connection. Each exchange gets
+*              the cheapest protection level meeting the rules of its command and OID.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga_shell_envelope.h"
+#include "optiga_shell_policy.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_request.h"
+
+/** @brief Largest length read from the measured data object */
+#define OPTIGA_SHELL_POLICY_MEASURE_LENGTH  (64U)
+
+/** @brief One rule of the policy table */
+typedef struct optiga_shell_policy_rule
+{
+    const char_t * command;
+    /// Key or data object the rule applies to, #OPTIGA_SHELL_POLICY_ANY_OID for all
+    uint16_t oid;
+    /// Protection the exchange needs, combined with the other matching rules
+    uint8_t level;
+} optiga_shell_policy_rule_t;
+
+/**
+ * Secrets leaving the OPTIGA need a protected response, secrets sent to it and commands whose
+ * parameters must not be swapped need a protected command. Everything else goes in clear, as
+ * protecting it would only add bytes and time.
+ */
+static const optiga_shell_policy_rule_t optiga_shell_policy_table[] =
+{
+    /* Shared secret, derived key and decrypted message exported to the host */
+    {"ecdh_export",             OPTIGA_SHELL_POLICY_ANY_OID,    OPTIGA_COMMS_RESPONSE_PROTECTION},
+    {"hkdf_export",             OPTIGA_SHELL_POLICY_ANY_OID,    OPTIGA_COMMS_RESPONSE_PROTECTION},
+    {"tls_prf_export",          OPTIGA_SHELL_POLICY_ANY_OID,    OPTIGA_COMMS_RESPONSE_PROTECTION},
+    {"rsa_decrypt_export",      OPTIGA_SHELL_POLICY_ANY_OID,    OPTIGA_COMMS_RESPONSE_PROTECTION},
+    /* The host public key the session secret is encrypted for */
+    {"rsa_encrypt_session",     OPTIGA_SHELL_POLICY_ANY_OID,    OPTIGA_COMMS_COMMAND_PROTECTION},
+    /* Pre-shared secret of the key derivation examples */
+    {"write_data",              0xF1D0U,                        OPTIGA_COMMS_COMMAND_PROTECTION},
+    {"read_data",               0xF1D0U,                        OPTIGA_COMMS_RESPONSE_PROTECTION},
+    /* Data key of an envelope sent to be wrapped and unwrapped back, and the secret it is derived from */
+    {"envelope_wrap",           OPTIGA_SHELL_POLICY_ANY_OID,    OPTIGA_COMMS_COMMAND_PROTECTION},
+    {"envelope_unwrap",         OPTIGA_SHELL_POLICY_ANY_OID,    OPTIGA_COMMS_RESPONSE_PROTECTION},
+    {"write_data",              OPTIGA_SHELL_ENVELOPE_SECRET_OID, OPTIGA_COMMS_COMMAND_PROTECTION},
+};
+
+#define OPTIGA_SHELL_POLICY_RULES   (sizeof(optiga_shell_policy_table) / sizeof(optiga_shell_policy_table[0]))
+
+static const char_t * const optiga_shell_policy_level_names[] = {"none", "command", "response", "full"};
+
+/// Protected exchanges made by each rule since boot
+static uint32_t optiga_shell_policy_exchanges[OPTIGA_SHELL_POLICY_RULES];
+
+/**
+ * Bytes one exchange adds at the given protection level
+ */
+static uint32_t optiga_shell_policy_overhead(uint8_t level)
+{
+    uint32_t overhead = 0;
+
+    if (0U != (level & OPTIGA_COMMS_COMMAND_PROTECTION))
+    {
+        overhead += OPTIGA_SHELL_POLICY_PROTECTED_OVERHEAD;
+    }
+    if (0U != (level & OPTIGA_COMMS_RESPONSE_PROTECTION))
+    {
+        overhead += OPTIGA_SHELL_POLICY_PROTECTED_OVERHEAD;
+    }
+    return (overhead);
+}
+
+static bool_t optiga_shell_policy_matches(const optiga_shell_policy_rule_t * p_rule, const char_t * p_command,
+                                          uint16_t oid)
+{
+    return ((bool_t)((0 == strcmp(p_rule->command, p_command)) &&
+                     ((OPTIGA_SHELL_POLICY_ANY_OID == p_rule->oid) || (oid == p_rule->oid))));
+}
+
+/**
+ * Combines the matching rules, counting the exchange for those which require protection
+ */
+static uint8_t optiga_shell_policy_lookup(const char_t * p_command, uint16_t oid, bool_t count)
+{
+    uint8_t level = OPTIGA_COMMS_NO_PROTECTION;
+    uint8_t index;
+
+    for (index = 0; index < OPTIGA_SHELL_POLICY_RULES; index++)
+    {
+        if (TRUE == optiga_shell_policy_matches(&optiga_shell_policy_table[index], p_command, oid))
+        {
+            level |= optiga_shell_policy_table[index].level;
+            if ((TRUE == count) && (OPTIGA_COMMS_NO_PROTECTION != optiga_shell_policy_table[index].level))
+            {
+                optiga_shell_policy_exchanges[index]++;
+            }
+        }
+    }
+    return (level);
+}
+
+uint8_t optiga_shell_policy_get_level(const char_t * p_command, uint16_t oid)
+{
+    return (optiga_shell_policy_lookup(p_command, oid, FALSE));
+}
+
+uint8_t optiga_shell_policy_apply_crypt(optiga_crypt_t * me, const char_t * p_command, uint16_t oid)
+{
+#ifdef OPTIGA_COMMS_SHIELDED_CONNECTION
+    uint8_t level = optiga_shell_policy_lookup(p_command, oid, TRUE);
+
+    OPTIGA_CRYPT_SET_COMMS_PROTOCOL_VERSION(me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
+    OPTIGA_CRYPT_SET_COMMS_PROTECTION_LEVEL(me, level);
+    return (level);
+#else
+    (void)me;
+    (void)p_command;
+    (void)oid;
+    return (OPTIGA_COMMS_NO_PROTECTION);
+#endif
+}
+
+uint8_t optiga_shell_policy_apply_util(optiga_util_t * me, const char_t * p_command, uint16_t oid)
+{
+#ifdef OPTIGA_COMMS_SHIELDED_CONNECTION
+    uint8_t level = optiga_shell_policy_lookup(p_command, oid, TRUE);
+
+    OPTIGA_UTIL_SET_COMMS_PROTOCOL_VERSION(me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
+    OPTIGA_UTIL_SET_COMMS_PROTECTION_LEVEL(me, level);
+    return (level);
+#else
+    (void)me;
+    (void)p_command;
+    (void)oid;
+    return (OPTIGA_COMMS_NO_PROTECTION);
+#endif
+}
+
+#ifdef OPTIGA_COMMS_SHIELDED_CONNECTION
+static optiga_shell_request_t optiga_shell_policy_request;
+
+/**
+ * Reads the measured data object at each protection level and prints what protection adds
+ */
+static void optiga_shell_policy_measure(uint32_t iterations)
+{
+    uint8_t buffer[OPTIGA_SHELL_POLICY_MEASURE_LENGTH];
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    uint64_t sum_us[4] = {0, 0, 0, 0};
+    uint32_t avg_us[4] = {0, 0, 0, 0};
+    uint32_t done[4] = {0, 0, 0, 0};
+    uint16_t length;
+    uint8_t level;
+    optiga_util_t * me;
+    char_t line[80];
+
+    me = optiga_shell_pool_get_util(&optiga_shell_policy_request);
+    if (NULL == me)
+    {
+        optiga_lib_print_string_with_newline("Failed to get a util instance");
+        return;
+    }
+
+    for (level = 0; (level < 4U) && (OPTIGA_LIB_SUCCESS == return_status); level++)
+    {
+        while ((done[level] < iterations) && (OPTIGA_LIB_SUCCESS == return_status))
+        {
+            length = sizeof(buffer);
+            OPTIGA_UTIL_SET_COMMS_PROTOCOL_VERSION(me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
+            OPTIGA_UTIL_SET_COMMS_PROTECTION_LEVEL(me, level);
+            return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_policy_request,
+                                                     optiga_util_read_data(me, OPTIGA_SHELL_POLICY_MEASURE_OID, 0,
+                                                                           buffer, &length));
+            if (OPTIGA_LIB_SUCCESS == return_status)
+            {
+                sum_us[level] += optiga_shell_request_get_latency_us(&optiga_shell_policy_request);
+                done[level]++;
+            }
+        }
+        avg_us[level] = (0U == done[level]) ? 0U : (uint32_t)(sum_us[level] / done[level]);
+    }
+    (void)optiga_shell_pool_put_util(me);
+
+    optiga_lib_print_string_with_newline("level,iterations,extra_bytes,avg_us,extra_us,status");
+    for (level = 0; level < 4U; level++)
+    {
+        snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu,0x%04X", optiga_shell_policy_level_names[level],
+                 (unsigned long)done[level], (unsigned long)optiga_shell_policy_overhead(level),
+                 (unsigned long)avg_us[level],
+                 (unsigned long)(((0U != done[level]) && (avg_us[level] > avg_us[0])) ? (avg_us[level] - avg_us[0]) : 0U),
+                 (unsigned int)((done[level] < iterations) ? return_status : OPTIGA_LIB_SUCCESS));
+        optiga_lib_print_string_with_newline(line);
+    }
+}
+#endif
+
+void optiga_shell_cmd_policy(optiga_shell_args_t * p_args)
+{
+    static const optiga_shell_args_choice_t measure_modes[] =
+    {
+        {"off",     FALSE},
+        {"on",      TRUE},
+    };
+    const optiga_shell_policy_rule_t * p_rule;
+    uint32_t iterations;
+    uint32_t measure;
+    uint8_t index;
+    char_t line[100];
+
+    if ((FALSE == optiga_shell_args_get_choice(p_args, "measure", measure_modes,
+                                               (uint8_t)(sizeof(measure_modes) / sizeof(measure_modes[0])), FALSE,
+                                               &measure)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "iterations", OPTIGA_SHELL_POLICY_MEASURE_ITERATIONS, 1,
+                                               OPTIGA_SHELL_POLICY_MEASURE_MAX_ITERATIONS, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+
+    optiga_lib_print_string_with_newline("command,oid,level,extra_bytes,exchanges,total_extra_bytes");
+    for (index = 0; index < OPTIGA_SHELL_POLICY_RULES; index++)
+    {
+        p_rule = &optiga_shell_policy_table[index];
+        if (OPTIGA_SHELL_POLICY_ANY_OID == p_rule->oid)
+        {
+            snprintf(line, sizeof(line), "%s,any,", p_rule->command);
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "%s,0x%04X,", p_rule->command, (unsigned int)p_rule->oid);
+        }
+        snprintf(&line[strlen(line)], sizeof(line) - strlen(line), "%s,%lu,%lu,%lu",
+                 optiga_shell_policy_level_names[p_rule->level], (unsigned long)optiga_shell_policy_overhead(p_rule->level),
+                 (unsigned long)optiga_shell_policy_exchanges[index],
+                 (unsigned long)(optiga_shell_policy_exchanges[index] * optiga_shell_policy_overhead(p_rule->level)));
+        optiga_lib_print_string_with_newline(line);
+    }
+
+    if (TRUE == measure)
+    {
+#ifdef OPTIGA_COMMS_SHIELDED_CONNECTION
+        optiga_shell_policy_measure(iterations);
+#else
+        optiga_lib_print_string_with_newline("The shielded connection is disabled, nothing to measure");
+#endif
+    }
+}
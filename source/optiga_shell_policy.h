@@ -0,0 +1,119 @@
+/******************************************************************************
+* File Name:   optiga_shell_policy.h
+*
+* Description: Shielded connection protection policy of the commands
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_POLICY_H_
+#define _OPTIGA_SHELL_POLICY_H_
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/optiga_util.h"
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Rule of the policy table which applies to all OIDs of its command */
+#define OPTIGA_SHELL_POLICY_ANY_OID         (0x0000U)
+
+/**
+ * @brief Bytes the shielded connection adds to each protected direction: SCTR, sequence number
+ * and MAC of the presentation layer
+ */
+#define OPTIGA_SHELL_POLICY_PROTECTED_OVERHEAD  (13U)
+
+/** @brief Data object read by optiga --policy --measure to time each protection level */
+#define OPTIGA_SHELL_POLICY_MEASURE_OID     (0xE0C2U)
+
+/** @brief Default and largest number of reads per protection level of optiga --policy --measure */
+#define OPTIGA_SHELL_POLICY_MEASURE_ITERATIONS      (10U)
+#define OPTIGA_SHELL_POLICY_MEASURE_MAX_ITERATIONS  (100U)
+
+/** @brief Argument usage of the policy command, as shown by help */
+#define OPTIGA_SHELL_POLICY_USAGE           "[--measure on|off] [--iterations <n>]"
+
+/**
+ * @brief Protection level the policy table requires for one exchange.
+ *
+ * All rules of the command which name the OID or #OPTIGA_SHELL_POLICY_ANY_OID are combined, the
+ * result is the cheapest of OPTIGA_COMMS_NO_PROTECTION, OPTIGA_COMMS_COMMAND_PROTECTION,
+ * OPTIGA_COMMS_RESPONSE_PROTECTION and OPTIGA_COMMS_FULL_PROTECTION meeting all of them.
+ * Commands without a rule are not protected.
+ *
+ * @param[in] p_command  Name of the exchange in the policy table, e.g. "ecdh_export"
+ * @param[in] oid        Key or data object of the exchange
+ *
+ * @return The protection level
+ */
+uint8_t optiga_shell_policy_get_level(const char_t * p_command, uint16_t oid);
+
+/**
+ * @brief Sets the protection level of the policy table for the next operation of a crypt instance.
+ *
+ * The library applies a protection level to one operation only, so it is set right before each
+ * call. The exchange is counted for optiga --policy. Without OPTIGA_COMMS_SHIELDED_CONNECTION
+ * nothing is set.
+ *
+ * @return The protection level set
+ */
+uint8_t optiga_shell_policy_apply_crypt(optiga_crypt_t * me, const char_t * p_command, uint16_t oid);
+
+/**
+ * @brief Sets the protection level of the policy table for the next operation of a util instance,
+ * see #optiga_shell_policy_apply_crypt.
+ */
+uint8_t optiga_shell_policy_apply_util(optiga_util_t * me, const char_t * p_command, uint16_t oid);
+
+/**
+ * @brief Prints the policy table as CSV with the protected exchanges made by each rule and the
+ * bytes they added.
+ *
+ * --measure on reads #OPTIGA_SHELL_POLICY_MEASURE_OID at each protection level and prints the
+ * bytes and microseconds a protected exchange adds to an unprotected one.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_policy(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_POLICY_H_ */
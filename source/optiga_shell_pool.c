@@ -0,0 +1,346 @@
+/******************************************************************************
+* File Name:   optiga_shell_pool.c
+*
+* Description: Pool of OPTIGA crypt and util instances. Instances stay registered once
+*              created and are handed out again to the next user instead of being
+*              created and destroyed by every example and command.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga_shell_pool.h"
+
+/** @brief A pooled instance and the request of its current user */
+typedef struct optiga_shell_pool_slot
+{
+    void * me;
+    optiga_shell_request_t * p_request;
+    bool_t in_use;
+} optiga_shell_pool_slot_t;
+
+static optiga_shell_pool_slot_t optiga_shell_pool_crypt_slots[OPTIGA_SHELL_POOL_CRYPT_SIZE];
+static optiga_shell_pool_slot_t optiga_shell_pool_util_slots[OPTIGA_SHELL_POOL_UTIL_SIZE];
+static optiga_shell_pool_stats_t optiga_shell_pool_stats[OPTIGA_SHELL_POOL_KINDS];
+
+/**
+ * The callback context of an instance is fixed at create time, so pooled instances are created
+ * with their slot as context and forward the completion to the request of the current user.
+ */
+static void optiga_shell_pool_callback(void * context, optiga_lib_status_t return_status)
+{
+    optiga_shell_request_callback(((optiga_shell_pool_slot_t *)context)->p_request, return_status);
+}
+
+static optiga_shell_pool_slot_t * optiga_shell_pool_slots(uint8_t kind, uint8_t * p_size)
+{
+    if (OPTIGA_SHELL_POOL_CRYPT == kind)
+    {
+        *p_size = (uint8_t)OPTIGA_SHELL_POOL_CRYPT_SIZE;
+        return (optiga_shell_pool_crypt_slots);
+    }
+    *p_size = (uint8_t)OPTIGA_SHELL_POOL_UTIL_SIZE;
+    return (optiga_shell_pool_util_slots);
+}
+
+static void * optiga_shell_pool_create(uint8_t kind, callback_handler_t handler, void * context)
+{
+    if (OPTIGA_SHELL_POOL_CRYPT == kind)
+    {
+        return (optiga_crypt_create(0, handler, context));
+    }
+    return (optiga_util_create(0, handler, context));
+}
+
+static optiga_lib_status_t optiga_shell_pool_destroy(uint8_t kind, void * me)
+{
+    if (OPTIGA_SHELL_POOL_CRYPT == kind)
+    {
+        return (optiga_crypt_destroy((optiga_crypt_t *)me));
+    }
+    return (optiga_util_destroy((optiga_util_t *)me));
+}
+
+/**
+ * Destroys the idle pooled instances of all kinds to free their command registrations
+ */
+static void optiga_shell_pool_evict(void)
+{
+    optiga_shell_pool_slot_t * p_slots;
+    uint8_t kind;
+    uint8_t size;
+    uint8_t index;
+
+    for (kind = 0; kind < OPTIGA_SHELL_POOL_KINDS; kind++)
+    {
+        p_slots = optiga_shell_pool_slots(kind, &size);
+        for (index = 0; index < size; index++)
+        {
+            if ((NULL != p_slots[index].me) && (FALSE == p_slots[index].in_use) &&
+                (OPTIGA_LIB_SUCCESS == optiga_shell_pool_destroy(kind, p_slots[index].me)))
+            {
+                p_slots[index].me = NULL;
+                optiga_shell_pool_stats[kind].pooled--;
+                optiga_shell_pool_stats[kind].evictions++;
+            }
+        }
+    }
+}
+
+static void * optiga_shell_pool_create_or_evict(uint8_t kind, callback_handler_t handler, void * context)
+{
+    void * me;
+
+    me = optiga_shell_pool_create(kind, handler, context);
+    if (NULL == me)
+    {
+        optiga_shell_pool_evict();
+        me = optiga_shell_pool_create(kind, handler, context);
+    }
+    return (me);
+}
+
+static void * optiga_shell_pool_get(uint8_t kind, optiga_shell_request_t * p_request)
+{
+    optiga_shell_pool_stats_t * p_stats = &optiga_shell_pool_stats[kind];
+    optiga_shell_pool_slot_t * p_slots;
+    optiga_shell_pool_slot_t * p_free = NULL;
+    void * me = NULL;
+    uint8_t size;
+    uint8_t index;
+
+    p_slots = optiga_shell_pool_slots(kind, &size);
+    for (index = 0; index < size; index++)
+    {
+        if ((NULL != p_slots[index].me) && (FALSE == p_slots[index].in_use))
+        {
+            p_slots[index].p_request = p_request;
+            p_slots[index].in_use = TRUE;
+            me = p_slots[index].me;
+            p_stats->hits++;
+            break;
+        }
+        if ((NULL == p_slots[index].me) && (NULL == p_free))
+        {
+            p_free = &p_slots[index];
+        }
+    }
+
+    if ((NULL == me) && (NULL != p_free))
+    {
+        p_free->p_request = p_request;
+        me = optiga_shell_pool_create_or_evict(kind, optiga_shell_pool_callback, p_free);
+        if (NULL != me)
+        {
+            p_free->me = me;
+            p_free->in_use = TRUE;
+            p_stats->pooled++;
+            p_stats->misses++;
+        }
+    }
+    else if (NULL == me)
+    {
+        /*
+         * All pooled instances are handed out, this one is destroyed when returned
+         */
+        me = optiga_shell_pool_create_or_evict(kind, optiga_shell_request_callback, p_request);
+        if (NULL != me)
+        {
+            p_stats->overflows++;
+            p_stats->misses++;
+        }
+    }
+    if (NULL == me)
+    {
+        return (NULL);
+    }
+
+    p_stats->in_use++;
+    if (OPTIGA_SHELL_POOL_CRYPT == kind)
+    {
+        OPTIGA_CRYPT_SET_COMMS_PROTECTION_LEVEL((optiga_crypt_t *)me, OPTIGA_COMMS_DEFAULT_PROTECTION_LEVEL);
+        OPTIGA_CRYPT_SET_COMMS_PROTOCOL_VERSION((optiga_crypt_t *)me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
+    }
+    else
+    {
+        OPTIGA_UTIL_SET_COMMS_PROTECTION_LEVEL((optiga_util_t *)me, OPTIGA_COMMS_DEFAULT_PROTECTION_LEVEL);
+        OPTIGA_UTIL_SET_COMMS_PROTOCOL_VERSION((optiga_util_t *)me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
+    }
+    return (me);
+}
+
+static optiga_lib_status_t optiga_shell_pool_put(uint8_t kind, void * me)
+{
+    optiga_shell_pool_slot_t * p_slots;
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    uint8_t size;
+    uint8_t index;
+
+    if (NULL == me)
+    {
+        return (return_status);
+    }
+    p_slots = optiga_shell_pool_slots(kind, &size);
+    for (index = 0; index < size; index++)
+    {
+        if (me == p_slots[index].me)
+        {
+            p_slots[index].in_use = FALSE;
+            p_slots[index].p_request = NULL;
+            break;
+        }
+    }
+    if (size == index)
+    {
+        return_status = optiga_shell_pool_destroy(kind, me);
+    }
+    optiga_shell_pool_stats[kind].in_use--;
+    return (return_status);
+}
+
+optiga_crypt_t * optiga_shell_pool_get_crypt(optiga_shell_request_t * p_request)
+{
+    return ((optiga_crypt_t *)optiga_shell_pool_get(OPTIGA_SHELL_POOL_CRYPT, p_request));
+}
+
+optiga_crypt_t * optiga_shell_pool_get_session_crypt(optiga_shell_request_t * p_request)
+{
+    optiga_crypt_t * me;
+
+    /*
+     * Not kept in a slot, so the put destroys it together with its session context
+     */
+    me = (optiga_crypt_t *)optiga_shell_pool_create_or_evict(OPTIGA_SHELL_POOL_CRYPT, optiga_shell_request_callback,
+                                                             p_request);
+    if (NULL == me)
+    {
+        return (NULL);
+    }
+    optiga_shell_pool_stats[OPTIGA_SHELL_POOL_CRYPT].sessions++;
+    optiga_shell_pool_stats[OPTIGA_SHELL_POOL_CRYPT].in_use++;
+    OPTIGA_CRYPT_SET_COMMS_PROTECTION_LEVEL(me, OPTIGA_COMMS_DEFAULT_PROTECTION_LEVEL);
+    OPTIGA_CRYPT_SET_COMMS_PROTOCOL_VERSION(me, OPTIGA_COMMS_PROTOCOL_VERSION_PRE_SHARED_SECRET);
+    return (me);
+}
+
+optiga_lib_status_t optiga_shell_pool_put_crypt(optiga_crypt_t * me)
+{
+    return (optiga_shell_pool_put(OPTIGA_SHELL_POOL_CRYPT, me));
+}
+
+optiga_lib_status_t optiga_shell_pool_discard_crypt(optiga_crypt_t * me)
+{
+    optiga_shell_pool_slot_t * p_slots;
+    uint8_t size;
+    uint8_t index;
+
+    if (NULL == me)
+    {
+        return (OPTIGA_LIB_SUCCESS);
+    }
+    p_slots = optiga_shell_pool_slots(OPTIGA_SHELL_POOL_CRYPT, &size);
+    for (index = 0; index < size; index++)
+    {
+        if (me == p_slots[index].me)
+        {
+            p_slots[index].me = NULL;
+            p_slots[index].in_use = FALSE;
+            p_slots[index].p_request = NULL;
+            optiga_shell_pool_stats[OPTIGA_SHELL_POOL_CRYPT].pooled--;
+            break;
+        }
+    }
+    optiga_shell_pool_stats[OPTIGA_SHELL_POOL_CRYPT].in_use--;
+    return (optiga_shell_pool_destroy(OPTIGA_SHELL_POOL_CRYPT, me));
+}
+
+optiga_util_t * optiga_shell_pool_get_util(optiga_shell_request_t * p_request)
+{
+    return ((optiga_util_t *)optiga_shell_pool_get(OPTIGA_SHELL_POOL_UTIL, p_request));
+}
+
+optiga_lib_status_t optiga_shell_pool_put_util(optiga_util_t * me)
+{
+    return (optiga_shell_pool_put(OPTIGA_SHELL_POOL_UTIL, me));
+}
+
+void optiga_shell_pool_get_stats(uint8_t kind, optiga_shell_pool_stats_t * p_stats)
+{
+    *p_stats = optiga_shell_pool_stats[kind];
+}
+
+void optiga_shell_cmd_pool(optiga_shell_args_t * p_args)
+{
+    static const optiga_shell_args_choice_t reset_modes[] =
+    {
+        {"off",     FALSE},
+        {"on",      TRUE},
+    };
+    static const char_t * const kind_names[] = {"crypt", "util"};
+    optiga_shell_pool_stats_t * p_stats;
+    uint32_t reset;
+    uint8_t kind;
+    char_t line[80];
+
+    if ((FALSE == optiga_shell_args_get_choice(p_args, "reset", reset_modes,
+                                               (uint8_t)(sizeof(reset_modes) / sizeof(reset_modes[0])), FALSE, &reset)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+
+    optiga_lib_print_string_with_newline("kind,pooled,in_use,hits,misses,overflows,evictions,sessions");
+    for (kind = 0; kind < OPTIGA_SHELL_POOL_KINDS; kind++)
+    {
+        p_stats = &optiga_shell_pool_stats[kind];
+        snprintf(line, sizeof(line), "%s,%u,%u,%lu,%lu,%lu,%lu,%lu", kind_names[kind],
+                 (unsigned int)p_stats->pooled, (unsigned int)p_stats->in_use, (unsigned long)p_stats->hits,
+                 (unsigned long)p_stats->misses, (unsigned long)p_stats->overflows,
+                 (unsigned long)p_stats->evictions, (unsigned long)p_stats->sessions);
+        optiga_lib_print_string_with_newline(line);
+        if (TRUE == reset)
+        {
+            p_stats->hits = 0;
+            p_stats->misses = 0;
+            p_stats->overflows = 0;
+            p_stats->evictions = 0;
+            p_stats->sessions = 0;
+        }
+    }
+}
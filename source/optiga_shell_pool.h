@@ -0,0 +1,170 @@
+/******************************************************************************
+* File Name:   optiga_shell_pool.h
+*
+* Description: Pool of reusable OPTIGA crypt and util instances
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_POOL_H_
+#define _OPTIGA_SHELL_POOL_H_
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/optiga_util.h"
+#include "optiga_shell_args.h"
+#include "optiga_shell_request.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of crypt instances kept registered for reuse */
+#ifndef OPTIGA_SHELL_POOL_CRYPT_SIZE
+#define OPTIGA_SHELL_POOL_CRYPT_SIZE        (OPTIGA_CMD_MAX_REGISTRATIONS - 1U)
+#endif
+
+/** @brief Number of util instances kept registered for reuse */
+#ifndef OPTIGA_SHELL_POOL_UTIL_SIZE
+#define OPTIGA_SHELL_POOL_UTIL_SIZE         (2U)
+#endif
+
+/** @brief Kinds of pooled instances, index of #optiga_shell_pool_stats_t */
+#define OPTIGA_SHELL_POOL_CRYPT             (0U)
+#define OPTIGA_SHELL_POOL_UTIL              (1U)
+#define OPTIGA_SHELL_POOL_KINDS             (2U)
+
+/** @brief Keys in a session context, OPTIGA_KEY_ID_SESSION_BASED or one of 0xE100-0xE103 */
+#define OPTIGA_SHELL_POOL_IS_SESSION_OID(oid)   ((OPTIGA_KEY_ID_SESSION_BASED == (oid)) || \
+                                                 (0xE100U == ((oid) & 0xFFFCU)))
+
+/** @brief Argument usage of the pool command, as shown by help */
+#define OPTIGA_SHELL_POOL_USAGE             "[--reset on|off]"
+
+/** @brief Usage counters of one kind of instances */
+typedef struct optiga_shell_pool_stats
+{
+    /// Instances handed out from the pool without being created
+    uint32_t hits;
+    /// Instances created because none was idle in the pool
+    uint32_t misses;
+    /// Instances created and destroyed again because the pool was full
+    uint32_t overflows;
+    /// Idle pooled instances destroyed to free a command registration
+    uint32_t evictions;
+    /// Crypt instances for session context operations, created and destroyed again
+    uint32_t sessions;
+    /// Instances currently registered by the pool and handed out
+    uint8_t pooled;
+    uint8_t in_use;
+} optiga_shell_pool_stats_t;
+
+/**
+ * @brief Hands out a crypt instance reporting its completions into p_request.
+ *
+ * An idle pooled instance is reused if there is one, otherwise an instance is created and kept
+ * in the pool once it is returned. If the command registrations run out, idle pooled instances
+ * of the other kind are destroyed to make room. The instance is reset to the default
+ * protection level and protocol version of the shielded connection, so settings of its
+ * previous user do not carry over.
+ *
+ * @param[in] p_request  Completion context of the operations, must outlive the use
+ *
+ * @return The instance, NULL if none could be created
+ */
+optiga_crypt_t * optiga_shell_pool_get_crypt(optiga_shell_request_t * p_request);
+
+/**
+ * @brief Creates a crypt instance for operations acquiring a session context (0xE100-0xE103),
+ * e.g. a key generated with OPTIGA_KEY_ID_SESSION_BASED or a pre-master secret.
+ *
+ * The instance keeps the session context until it is destroyed, with the secret in it. It is
+ * therefore never pooled: #optiga_shell_pool_put_crypt destroys it, which releases the session
+ * context, so no later user of a pooled instance inherits it and the four contexts are not held
+ * by idle instances.
+ *
+ * @param[in] p_request  Completion context of the operations, must outlive the use
+ *
+ * @return The instance, NULL if none could be created
+ */
+optiga_crypt_t * optiga_shell_pool_get_session_crypt(optiga_shell_request_t * p_request);
+
+/**
+ * @brief Returns a crypt instance of #optiga_shell_pool_get_crypt or
+ * #optiga_shell_pool_get_session_crypt, no operation may be in flight.
+ *
+ * @retval #OPTIGA_LIB_SUCCESS  The instance is back in the pool or destroyed
+ * @retval Error of optiga_crypt_destroy() otherwise
+ */
+optiga_lib_status_t optiga_shell_pool_put_crypt(optiga_crypt_t * me);
+
+/**
+ * @brief Destroys a crypt instance of the pool instead of returning it, e.g. when it was used
+ * for a sequence which ended on an error. Its slot gets a new instance on the next get.
+ *
+ * @retval #OPTIGA_LIB_SUCCESS  The instance is destroyed
+ * @retval Error of optiga_crypt_destroy() otherwise
+ */
+optiga_lib_status_t optiga_shell_pool_discard_crypt(optiga_crypt_t * me);
+
+/**
+ * @brief Hands out a util instance, see #optiga_shell_pool_get_crypt.
+ */
+optiga_util_t * optiga_shell_pool_get_util(optiga_shell_request_t * p_request);
+
+/**
+ * @brief Returns a util instance of #optiga_shell_pool_get_util, see #optiga_shell_pool_put_crypt.
+ */
+optiga_lib_status_t optiga_shell_pool_put_util(optiga_util_t * me);
+
+/**
+ * @brief Copies the counters of one kind of instances, e.g. #OPTIGA_SHELL_POOL_CRYPT.
+ */
+void optiga_shell_pool_get_stats(uint8_t kind, optiga_shell_pool_stats_t * p_stats);
+
+/**
+ * @brief Prints the counters of the pool as CSV, one line per kind of instances.
+ *
+ * --reset on clears the hit, miss, overflow, eviction and session counters after printing.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_pool(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_POOL_H_ */
@@ -0,0 +1,314 @@
+/******************************************************************************
+* File Name:   optiga_shell_profile.c
+*
+* Description: Performance profiles which set the current limit of OPTIGA and the clock of the
+*              I2C bus together, and their comparison on a standard op mix.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/optiga_util.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_i2c.h"
+#include "optiga/pal/pal_ifx_i2c_config.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_profile.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_wait.h"
+
+#define OPTIGA_SHELL_PROFILE_CURRENT_LIMIT_OID  (0xE0C4U)
+#define OPTIGA_SHELL_PROFILE_UID_OID            (0xE0C2U)
+#define OPTIGA_SHELL_PROFILE_UID_LENGTH         (27U)
+#define OPTIGA_SHELL_PROFILE_HASH_LENGTH        (256U)
+#define OPTIGA_SHELL_PROFILE_RANDOM_LENGTH      (32U)
+/** @brief Operations of the op mix, run in turn */
+#define OPTIGA_SHELL_PROFILE_MIX_OPERATIONS     (4U)
+
+/** @brief Settings of one performance profile */
+typedef struct optiga_shell_profile
+{
+    const char_t * name;
+    /// Current limit of OPTIGA, in mA
+    uint8_t current_ma;
+    /// Clock of the I2C bus, in kHz
+    uint16_t i2c_khz;
+} optiga_shell_profile_t;
+
+static const optiga_shell_profile_t optiga_shell_profiles[OPTIGA_SHELL_PROFILE_COUNT] =
+{
+    {"low-power",       OPTIGA_SHELL_PROFILE_LOW_POWER_MA,      OPTIGA_SHELL_PROFILE_LOW_POWER_KHZ},
+    {"balanced",        OPTIGA_SHELL_PROFILE_BALANCED_MA,       OPTIGA_SHELL_PROFILE_BALANCED_KHZ},
+    {"max-throughput",  OPTIGA_SHELL_PROFILE_MAX_THROUGHPUT_MA, OPTIGA_SHELL_PROFILE_MAX_THROUGHPUT_KHZ},
+};
+
+static optiga_shell_request_t optiga_shell_profile_crypt_request;
+static optiga_shell_request_t optiga_shell_profile_util_request;
+static uint8_t optiga_shell_profile_active = OPTIGA_SHELL_PROFILE_NONE;
+
+/** @brief Input and output buffers of the op mix */
+static uint8_t optiga_shell_profile_data[OPTIGA_SHELL_PROFILE_HASH_LENGTH];
+static uint8_t optiga_shell_profile_output[80];
+
+optiga_lib_status_t optiga_shell_profile_apply(uint8_t profile)
+{
+    optiga_lib_status_t return_status;
+    optiga_util_t * me;
+    uint8_t current_ma;
+    uint16_t i2c_khz;
+
+    if ((profile >= OPTIGA_SHELL_PROFILE_COUNT) && (OPTIGA_SHELL_PROFILE_NONE != profile))
+    {
+        return (OPTIGA_UTIL_ERROR_INVALID_INPUT);
+    }
+    me = optiga_shell_pool_get_util(&optiga_shell_profile_util_request);
+    if (NULL == me)
+    {
+        return (OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT);
+    }
+    current_ma = (OPTIGA_SHELL_PROFILE_NONE == profile) ? (uint8_t)OPTIGA_SHELL_PROFILE_NONE_MA :
+                                                          optiga_shell_profiles[profile].current_ma;
+    i2c_khz = (OPTIGA_SHELL_PROFILE_NONE == profile) ? (uint16_t)OPTIGA_SHELL_PROFILE_NONE_KHZ :
+                                                       optiga_shell_profiles[profile].i2c_khz;
+    return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_profile_util_request,
+                                             optiga_util_write_data(me, OPTIGA_SHELL_PROFILE_CURRENT_LIMIT_OID,
+                                                                    OPTIGA_UTIL_ERASE_AND_WRITE, 0, &current_ma, 1));
+    (void)optiga_shell_pool_put_util(me);
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return (return_status);
+    }
+    if (PAL_STATUS_SUCCESS != pal_i2c_set_bitrate(&optiga_pal_i2c_context_0, i2c_khz))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    optiga_shell_profile_active = profile;
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+void optiga_shell_profile_restore_i2c(void)
+{
+    if (OPTIGA_SHELL_PROFILE_NONE != optiga_shell_profile_active)
+    {
+        (void)pal_i2c_set_bitrate(&optiga_pal_i2c_context_0, optiga_shell_profiles[optiga_shell_profile_active].i2c_khz);
+    }
+}
+
+uint8_t optiga_shell_profile_get_active(void)
+{
+    return (optiga_shell_profile_active);
+}
+
+/**
+ * Runs one operation of the op mix and returns the time OPTIGA took for it
+ */
+static optiga_lib_status_t optiga_shell_profile_run_operation(optiga_crypt_t * me_crypt, optiga_util_t * me_util,
+                                                              uint32_t index, uint32_t * p_latency_us)
+{
+    optiga_shell_request_t * p_request = &optiga_shell_profile_crypt_request;
+    hash_data_from_host_t hash_data;
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    uint16_t length = sizeof(optiga_shell_profile_output);
+
+    switch (index % OPTIGA_SHELL_PROFILE_MIX_OPERATIONS)
+    {
+        case 0:
+        {
+            return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_profile_crypt_request,
+                                                     optiga_crypt_ecdsa_sign(me_crypt, optiga_shell_profile_data, 32,
+                                                                             OPTIGA_KEY_ID_E0F0,
+                                                                             optiga_shell_profile_output, &length));
+            break;
+        }
+        case 1:
+        {
+            hash_data.buffer = optiga_shell_profile_data;
+            hash_data.length = sizeof(optiga_shell_profile_data);
+            return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_profile_crypt_request,
+                                                     optiga_crypt_hash(me_crypt, OPTIGA_HASH_TYPE_SHA_256,
+                                                                       OPTIGA_CRYPT_HOST_DATA, &hash_data,
+                                                                       optiga_shell_profile_output));
+            break;
+        }
+        case 2:
+        {
+            return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_profile_crypt_request,
+                                                     optiga_crypt_random(me_crypt, OPTIGA_RNG_TYPE_TRNG,
+                                                                         optiga_shell_profile_output,
+                                                                         OPTIGA_SHELL_PROFILE_RANDOM_LENGTH));
+            break;
+        }
+        default:
+        {
+            p_request = &optiga_shell_profile_util_request;
+            length = OPTIGA_SHELL_PROFILE_UID_LENGTH;
+            return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_profile_util_request,
+                                                     optiga_util_read_data(me_util, OPTIGA_SHELL_PROFILE_UID_OID, 0,
+                                                                           optiga_shell_profile_output, &length));
+            break;
+        }
+    }
+    *p_latency_us = optiga_shell_request_get_latency_us(p_request);
+    return (return_status);
+}
+
+/**
+ * Applies the profile, runs the op mix and prints one CSV line
+ */
+static optiga_lib_status_t optiga_shell_profile_measure(uint8_t profile, uint32_t jobs)
+{
+    const optiga_shell_profile_t * p_profile = &optiga_shell_profiles[profile];
+    optiga_shell_wait_stats_t wait_stats;
+    optiga_lib_status_t return_status;
+    optiga_crypt_t * me_crypt = NULL;
+    optiga_util_t * me_util = NULL;
+    uint64_t busy_us = 0;
+    uint64_t chip_nj;
+    uint64_t host_nj;
+    uint32_t elapsed_us = 0;
+    uint32_t latency_us;
+    uint32_t done = 0;
+    uint32_t rate;
+    char_t line[140];
+
+    do
+    {
+        return_status = optiga_shell_profile_apply(profile);
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        me_crypt = optiga_shell_pool_get_crypt(&optiga_shell_profile_crypt_request);
+        me_util = optiga_shell_pool_get_util(&optiga_shell_profile_util_request);
+        if ((NULL == me_crypt) || (NULL == me_util))
+        {
+            return_status = OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT;
+            break;
+        }
+
+        optiga_shell_wait_take_stats(&wait_stats);
+        elapsed_us = pal_os_timer_get_time_in_microseconds();
+        while ((done < jobs) && (OPTIGA_LIB_SUCCESS == return_status))
+        {
+            return_status = optiga_shell_profile_run_operation(me_crypt, me_util, done, &latency_us);
+            if (OPTIGA_LIB_SUCCESS == return_status)
+            {
+                busy_us += latency_us;
+                done++;
+            }
+        }
+        elapsed_us = pal_os_timer_get_time_in_microseconds() - elapsed_us;
+        optiga_shell_wait_take_stats(&wait_stats);
+    } while (FALSE);
+    (void)optiga_shell_pool_put_crypt(me_crypt);
+    (void)optiga_shell_pool_put_util(me_util);
+
+    /*
+     * OPTIGA draws up to its current limit while busy, mA x mV x usec gives pJ
+     */
+    chip_nj = (busy_us * p_profile->current_ma * OPTIGA_SHELL_WAIT_SUPPLY_MV) / 1000U;
+    host_nj = (0U != done) ? optiga_shell_wait_get_energy_nj(&wait_stats) : 0U;
+    rate = (0U != elapsed_us) ? (uint32_t)(((uint64_t)done * 1000000000ULL) / elapsed_us) : 0U;
+    chip_nj = (0U != done) ? (chip_nj / done) : 0U;
+    host_nj = (0U != done) ? (host_nj / done) : 0U;
+    snprintf(line, sizeof(line), "%s,%u,%u,%lu,%lu,%lu.%03lu,%lu.%03lu,%lu.%03lu,%lu.%03lu,0x%04X",
+             p_profile->name, (unsigned int)p_profile->current_ma, (unsigned int)p_profile->i2c_khz,
+             (unsigned long)done, (unsigned long)(elapsed_us / 1000U),
+             (unsigned long)(rate / 1000U), (unsigned long)(rate % 1000U),
+             (unsigned long)(chip_nj / 1000U), (unsigned long)(chip_nj % 1000U),
+             (unsigned long)(host_nj / 1000U), (unsigned long)(host_nj % 1000U),
+             (unsigned long)((chip_nj + host_nj) / 1000U), (unsigned long)((chip_nj + host_nj) % 1000U),
+             (unsigned int)return_status);
+    optiga_lib_print_string_with_newline(line);
+    return (return_status);
+}
+
+void optiga_shell_cmd_perfprofile(optiga_shell_args_t * p_args)
+{
+    static const optiga_shell_args_choice_t profile_names[] =
+    {
+        {"low-power",       OPTIGA_SHELL_PROFILE_LOW_POWER},
+        {"balanced",        OPTIGA_SHELL_PROFILE_BALANCED},
+        {"max-throughput",  OPTIGA_SHELL_PROFILE_MAX_THROUGHPUT},
+    };
+    optiga_lib_status_t return_status;
+    uint8_t previous = optiga_shell_profile_active;
+    uint32_t profile;
+    uint32_t jobs;
+    uint8_t index;
+    char_t line[80];
+
+    if ((FALSE == optiga_shell_args_get_choice(p_args, "set", profile_names,
+                                               (uint8_t)(sizeof(profile_names) / sizeof(profile_names[0])),
+                                               OPTIGA_SHELL_PROFILE_NONE, &profile)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "jobs", OPTIGA_SHELL_PROFILE_DEFAULT_JOBS, 1,
+                                               OPTIGA_SHELL_PROFILE_MAX_JOBS, &jobs)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+
+    if (OPTIGA_SHELL_PROFILE_NONE != profile)
+    {
+        return_status = optiga_shell_profile_apply((uint8_t)profile);
+        snprintf(line, sizeof(line), "Profile %s: %u mA, %u kHz, status 0x%04X", optiga_shell_profiles[profile].name,
+                 (unsigned int)optiga_shell_profiles[profile].current_ma,
+                 (unsigned int)optiga_shell_profiles[profile].i2c_khz, (unsigned int)return_status);
+        optiga_lib_print_string_with_newline(line);
+        return;
+    }
+
+    memset(optiga_shell_profile_data, 0xA5, sizeof(optiga_shell_profile_data));
+    optiga_lib_print_string_with_newline("profile,current_ma,i2c_khz,ops,elapsed_ms,ops_per_s,chip_uj_per_op,"
+                                         "host_uj_per_op,energy_uj_per_op,status");
+    for (index = 0; index < OPTIGA_SHELL_PROFILE_COUNT; index++)
+    {
+        (void)optiga_shell_profile_measure(index, jobs);
+    }
+
+    /*
+     * Leave the profile of the application in place
+     */
+    return_status = optiga_shell_profile_apply(previous);
+    snprintf(line, sizeof(line), "Active profile: %s, status 0x%04X",
+             (OPTIGA_SHELL_PROFILE_NONE == optiga_shell_profile_active) ? "none" :
+             optiga_shell_profiles[optiga_shell_profile_active].name, (unsigned int)return_status);
+    optiga_lib_print_string_with_newline(line);
+}
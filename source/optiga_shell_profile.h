@@ -0,0 +1,158 @@
+/******************************************************************************
+* File Name:   optiga_shell_profile.h
+*
+* Description: Performance profiles setting the OPTIGA current limit and the I2C clock together
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_PROFILE_H_
+#define _OPTIGA_SHELL_PROFILE_H_
+
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga/common/optiga_lib_return_codes.h"
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Performance profiles, see #optiga_shell_profile_apply */
+#define OPTIGA_SHELL_PROFILE_LOW_POWER          (0U)
+#define OPTIGA_SHELL_PROFILE_BALANCED           (1U)
+#define OPTIGA_SHELL_PROFILE_MAX_THROUGHPUT     (2U)
+#define OPTIGA_SHELL_PROFILE_COUNT              (3U)
+/**
+ * @brief No profile: the current limit init always wrote and the I2C clock the library opens the
+ * application with
+ */
+#define OPTIGA_SHELL_PROFILE_NONE               (0xFFU)
+
+/**
+ * @brief Current limit of OPTIGA (0xE0C4, 6..15 mA) and I2C clock (kHz) of each profile.
+ *
+ * Check the clock of max-throughput against the pull-ups and the wiring of the board, 1000 kHz
+ * is the Fast-mode Plus of the I2C specification.
+ */
+#ifndef OPTIGA_SHELL_PROFILE_LOW_POWER_MA
+#define OPTIGA_SHELL_PROFILE_LOW_POWER_MA       (6U)
+#endif
+#ifndef OPTIGA_SHELL_PROFILE_LOW_POWER_KHZ
+#define OPTIGA_SHELL_PROFILE_LOW_POWER_KHZ      (100U)
+#endif
+#ifndef OPTIGA_SHELL_PROFILE_BALANCED_MA
+#define OPTIGA_SHELL_PROFILE_BALANCED_MA        (10U)
+#endif
+#ifndef OPTIGA_SHELL_PROFILE_BALANCED_KHZ
+#define OPTIGA_SHELL_PROFILE_BALANCED_KHZ       (400U)
+#endif
+#ifndef OPTIGA_SHELL_PROFILE_MAX_THROUGHPUT_MA
+#define OPTIGA_SHELL_PROFILE_MAX_THROUGHPUT_MA  (15U)
+#endif
+#ifndef OPTIGA_SHELL_PROFILE_MAX_THROUGHPUT_KHZ
+#define OPTIGA_SHELL_PROFILE_MAX_THROUGHPUT_KHZ (1000U)
+#endif
+
+/**
+ * @brief Current limit (mA) and I2C clock (kHz) of #OPTIGA_SHELL_PROFILE_NONE. The clock is the
+ * one of the library, which sets it again each time it opens the application.
+ */
+#ifndef OPTIGA_SHELL_PROFILE_NONE_MA
+#define OPTIGA_SHELL_PROFILE_NONE_MA            (15U)
+#endif
+#ifndef OPTIGA_SHELL_PROFILE_NONE_KHZ
+#define OPTIGA_SHELL_PROFILE_NONE_KHZ           (400U)
+#endif
+
+/**
+ * @brief Profile applied by optiga --init. Set it to one of the profiles to run with it from
+ * boot, e.g. #OPTIGA_SHELL_PROFILE_MAX_THROUGHPUT once the board is known to run its clock.
+ */
+#ifndef OPTIGA_SHELL_PROFILE_BOOT
+#define OPTIGA_SHELL_PROFILE_BOOT               (OPTIGA_SHELL_PROFILE_NONE)
+#endif
+
+/** @brief Default and largest number of operations of the op mix run per profile */
+#define OPTIGA_SHELL_PROFILE_DEFAULT_JOBS       (40U)
+#define OPTIGA_SHELL_PROFILE_MAX_JOBS           (1000U)
+
+/** @brief Argument usage of the perfprofile command, as shown by help */
+#define OPTIGA_SHELL_PROFILE_USAGE              "[--set low-power|balanced|max-throughput] [--jobs <n>]"
+
+/**
+ * @brief Writes the current limit of the profile to 0xE0C4 and sets the I2C clock of the PAL.
+ *
+ * The application must be open. The host library sets its own I2C clock each time it opens the
+ * application, so the session sets the clock of the profile again, see
+ * #optiga_shell_profile_restore_i2c.
+ *
+ * @param[in] profile  #OPTIGA_SHELL_PROFILE_LOW_POWER, #OPTIGA_SHELL_PROFILE_BALANCED,
+ *                     #OPTIGA_SHELL_PROFILE_MAX_THROUGHPUT or #OPTIGA_SHELL_PROFILE_NONE
+ *
+ * @retval #OPTIGA_LIB_SUCCESS  The profile is active
+ * @retval Error of the write or of the PAL otherwise
+ */
+optiga_lib_status_t optiga_shell_profile_apply(uint8_t profile);
+
+/**
+ * @brief Sets the I2C clock of the active profile again, after the application was opened.
+ */
+void optiga_shell_profile_restore_i2c(void);
+
+/**
+ * @brief Returns the active profile, #OPTIGA_SHELL_PROFILE_NONE if none is applied.
+ */
+uint8_t optiga_shell_profile_get_active(void);
+
+/**
+ * @brief Compares the performance profiles on a standard op mix, or applies one.
+ *
+ * Without --set, each profile is applied in turn and runs --jobs operations cycling through
+ * ECDSA P-256 sign (E0F0), SHA-256 of 256 bytes, 32 bytes of TRNG and a read of the UID (E0C2).
+ * One CSV line per profile gives the operations per second and the estimated energy per
+ * operation: OPTIGA drawing its current limit while busy, and the host core waiting for it
+ * (see optiga_shell_wait.h). The profile active before is applied again afterwards.
+ * --set applies the named profile until the next reset.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_perfprofile(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_PROFILE_H_ */
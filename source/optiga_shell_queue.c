@@ -0,0 +1,144 @@
+/******************************************************************************
+* File Name:   optiga_shell_queue.c
+*
+* Description: Command queue keeping several OPTIGA crypt instances in flight. The
+*              chip executes the queued commands one after the other while the host
+*              prepares the next operation and consumes the completed ones.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+
+#include "optiga_shell_pool.h"
+#include "optiga_shell_queue.h"
+
+optiga_lib_status_t optiga_shell_queue_open(optiga_shell_queue_t * p_queue, uint8_t depth)
+{
+    uint8_t index;
+
+    memset(p_queue, 0, sizeof(*p_queue));
+    if ((0U == depth) || (OPTIGA_SHELL_QUEUE_MAX_DEPTH < depth))
+    {
+        return (OPTIGA_CRYPT_ERROR_INVALID_INPUT);
+    }
+    p_queue->depth = depth;
+    for (index = 0; index < depth; index++)
+    {
+        p_queue->slots[index].me = optiga_shell_pool_get_crypt(&p_queue->slots[index].request);
+        if (NULL == p_queue->slots[index].me)
+        {
+            optiga_shell_queue_close(p_queue);
+            return (OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT);
+        }
+    }
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+void optiga_shell_queue_close(optiga_shell_queue_t * p_queue)
+{
+    uint8_t index;
+
+    optiga_shell_queue_drain(p_queue);
+    for (index = 0; index < p_queue->depth; index++)
+    {
+        if (NULL != p_queue->slots[index].me)
+        {
+            (void)optiga_shell_pool_put_crypt(p_queue->slots[index].me);
+            p_queue->slots[index].me = NULL;
+        }
+    }
+    p_queue->depth = 0;
+}
+
+optiga_lib_status_t optiga_shell_queue_submit(optiga_shell_queue_t * p_queue,
+                                              optiga_shell_queue_issue_t issue,
+                                              optiga_shell_queue_done_t done,
+                                              void * context)
+{
+    optiga_shell_queue_slot_t * p_slot;
+    optiga_lib_status_t return_status;
+    uint8_t slot;
+
+    if (p_queue->depth == p_queue->count)
+    {
+        (void)optiga_shell_queue_retire(p_queue);
+    }
+    slot = (uint8_t)((p_queue->head + p_queue->count) % p_queue->depth);
+    p_slot = &p_queue->slots[slot];
+    p_slot->done = done;
+    p_slot->context = context;
+
+    optiga_shell_request_start(&p_slot->request);
+    return_status = issue(p_slot->me, slot, context);
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        /*
+         * Nothing is in flight on this slot, it is reused by the next submission
+         */
+        done(slot, return_status, context);
+        return (return_status);
+    }
+    p_queue->count++;
+    return (return_status);
+}
+
+optiga_lib_status_t optiga_shell_queue_retire(optiga_shell_queue_t * p_queue)
+{
+    optiga_shell_queue_slot_t * p_slot;
+    optiga_lib_status_t return_status;
+    uint8_t slot;
+
+    if (0U == p_queue->count)
+    {
+        return (OPTIGA_LIB_SUCCESS);
+    }
+    slot = p_queue->head;
+    p_slot = &p_queue->slots[slot];
+    return_status = optiga_shell_request_wait(&p_slot->request);
+    p_queue->head = (uint8_t)((p_queue->head + 1U) % p_queue->depth);
+    p_queue->count--;
+    p_slot->done(slot, return_status, p_slot->context);
+    return (return_status);
+}
+
+void optiga_shell_queue_drain(optiga_shell_queue_t * p_queue)
+{
+    while (0U != p_queue->count)
+    {
+        (void)optiga_shell_queue_retire(p_queue);
+    }
+}
@@ -0,0 +1,146 @@
+/******************************************************************************
+* File Name:   optiga_shell_queue.h
+*
+* Description: Command queue keeping several OPTIGA crypt instances in flight
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_QUEUE_H_
+#define _OPTIGA_SHELL_QUEUE_H_
+
+#include "optiga/optiga_crypt.h"
+#include "optiga_shell_request.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Largest number of crypt instances of a queue. One command registration of
+ * #OPTIGA_CMD_MAX_REGISTRATIONS is left for the util instance of the shell.
+ */
+#define OPTIGA_SHELL_QUEUE_MAX_DEPTH        (OPTIGA_CMD_MAX_REGISTRATIONS - 1U)
+
+/**
+ * @brief Starts an operation on the crypt instance of a slot.
+ *
+ * Prepares the inputs of the operation (in the memory of the slot, as the previous operation of
+ * the slot is retired already) and calls one optiga_crypt_xxx function with me.
+ *
+ * @return Return value of the optiga_crypt_xxx call
+ */
+typedef optiga_lib_status_t (*optiga_shell_queue_issue_t)(optiga_crypt_t * me, uint8_t slot, void * context);
+
+/**
+ * @brief Consumes the result of an operation, called in submission order from the shell thread.
+ */
+typedef void (*optiga_shell_queue_done_t)(uint8_t slot, optiga_lib_status_t status, void * context);
+
+/** @brief A crypt instance of the queue and the operation it runs */
+typedef struct optiga_shell_queue_slot
+{
+    optiga_crypt_t * me;
+    optiga_shell_request_t request;
+    optiga_shell_queue_done_t done;
+    void * context;
+} optiga_shell_queue_slot_t;
+
+/**
+ * @brief Keeps several crypt instances registered and their operations in flight.
+ *
+ * The library queues the commands of all registered instances for the chip, which executes
+ * them one after the other. While the chip runs the submitted operations, the host prepares
+ * the next one and consumes the results of the completed ones. Slots are used round robin and
+ * retired in submission order.
+ */
+typedef struct optiga_shell_queue
+{
+    optiga_shell_queue_slot_t slots[OPTIGA_SHELL_QUEUE_MAX_DEPTH];
+    /// Number of crypt instances, 1 runs the operations one by one
+    uint8_t depth;
+    /// Oldest operation in flight
+    uint8_t head;
+    /// Number of operations in flight
+    uint8_t count;
+} optiga_shell_queue_t;
+
+/**
+ * @brief Takes the crypt instances of the queue from the pool, see optiga_shell_pool.h.
+ *
+ * @param[out] p_queue  Queue, must stay in place until closed as the slots are callback contexts
+ * @param[in]  depth    Number of operations in flight, 1 to #OPTIGA_SHELL_QUEUE_MAX_DEPTH
+ *
+ * @retval #OPTIGA_LIB_SUCCESS                      All instances are taken
+ * @retval #OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT  Out of command registrations, nothing is kept
+ */
+optiga_lib_status_t optiga_shell_queue_open(optiga_shell_queue_t * p_queue, uint8_t depth);
+
+/**
+ * @brief Retires the operations in flight and returns the crypt instances to the pool.
+ */
+void optiga_shell_queue_close(optiga_shell_queue_t * p_queue);
+
+/**
+ * @brief Starts an operation on the next slot.
+ *
+ * If all slots are in flight, the oldest operation is retired first. If issue fails, done is
+ * called right away with its return value.
+ *
+ * @return Return value of issue
+ */
+optiga_lib_status_t optiga_shell_queue_submit(optiga_shell_queue_t * p_queue,
+                                              optiga_shell_queue_issue_t issue,
+                                              optiga_shell_queue_done_t done,
+                                              void * context);
+
+/**
+ * @brief Waits for the oldest operation in flight and calls its done function.
+ *
+ * @return Result of the operation, #OPTIGA_LIB_SUCCESS if none is in flight
+ */
+optiga_lib_status_t optiga_shell_queue_retire(optiga_shell_queue_t * p_queue);
+
+/**
+ * @brief Retires all operations in flight.
+ */
+void optiga_shell_queue_drain(optiga_shell_queue_t * p_queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_QUEUE_H_ */
@@ -0,0 +1,417 @@
+/******************************************************************************
+* File Name:   optiga_shell_random.c
+*
+* Description: Random service with a prefetched TRNG pool and a CTR-DRBG seeded from it
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "mbedtls/ctr_drbg.h"
+#include "optiga/optiga_crypt.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_random.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_session.h"
+
+/** @brief Longest TRNG output of one optiga_crypt_random */
+#define OPTIGA_SHELL_RANDOM_MAX_REQUEST         (256U)
+/** @brief Request lengths of optiga --randbench, the longest sizes its buffer */
+#define OPTIGA_SHELL_RANDOM_BENCH_MAX_LENGTH    (1024U)
+
+static const char_t optiga_shell_random_personalization[] = "optiga shell random";
+
+static optiga_shell_request_t optiga_shell_random_request;
+/// Crypt instance of the background refill in flight, NULL if none is
+static optiga_crypt_t * optiga_shell_random_crypt = NULL;
+
+/** @brief Prefetched TRNG output, level bytes from head on, wrapping around */
+static uint8_t optiga_shell_random_ring[OPTIGA_SHELL_RANDOM_POOL_SIZE];
+static uint32_t optiga_shell_random_head = 0;
+static uint32_t optiga_shell_random_level = 0;
+/** @brief TRNG output of a refill, added to the ring as a whole once the command completed */
+static uint8_t optiga_shell_random_refill[OPTIGA_SHELL_RANDOM_REFILL_LENGTH];
+/// Set by a failed background refill, cleared by the next request
+static bool_t optiga_shell_random_paused = FALSE;
+
+static mbedtls_ctr_drbg_context optiga_shell_random_drbg;
+static bool_t optiga_shell_random_seeded = FALSE;
+static uint32_t optiga_shell_random_reseed_interval = OPTIGA_SHELL_RANDOM_RESEED_INTERVAL;
+
+static optiga_shell_random_stats_t optiga_shell_random_stats;
+static uint8_t optiga_shell_random_bench_buffer[OPTIGA_SHELL_RANDOM_BENCH_MAX_LENGTH];
+
+static void optiga_shell_random_store(const uint8_t * p_data, uint32_t length)
+{
+    uint32_t tail = (optiga_shell_random_head + optiga_shell_random_level) % OPTIGA_SHELL_RANDOM_POOL_SIZE;
+    uint32_t first = OPTIGA_SHELL_RANDOM_POOL_SIZE - tail;
+
+    first = (length < first) ? length : first;
+    memcpy(&optiga_shell_random_ring[tail], p_data, first);
+    memcpy(optiga_shell_random_ring, &p_data[first], length - first);
+    optiga_shell_random_level += length;
+}
+
+/**
+ * Takes up to length bytes from the ring and returns how many it took. The bytes are cleared
+ * in the ring, each is handed out once.
+ */
+static uint32_t optiga_shell_random_take(uint8_t * p_data, uint32_t length)
+{
+    uint32_t taken = (length < optiga_shell_random_level) ? length : optiga_shell_random_level;
+    uint32_t first = OPTIGA_SHELL_RANDOM_POOL_SIZE - optiga_shell_random_head;
+
+    first = (taken < first) ? taken : first;
+    memcpy(p_data, &optiga_shell_random_ring[optiga_shell_random_head], first);
+    memset(&optiga_shell_random_ring[optiga_shell_random_head], 0, first);
+    memcpy(&p_data[first], optiga_shell_random_ring, taken - first);
+    memset(optiga_shell_random_ring, 0, taken - first);
+    optiga_shell_random_head = (optiga_shell_random_head + taken) % OPTIGA_SHELL_RANDOM_POOL_SIZE;
+    optiga_shell_random_level -= taken;
+    return (taken);
+}
+
+/**
+ * Waits for the background refill in flight, if any, and adds its output to the ring
+ */
+static optiga_lib_status_t optiga_shell_random_collect(void)
+{
+    optiga_lib_status_t return_status;
+
+    if (NULL == optiga_shell_random_crypt)
+    {
+        return (OPTIGA_LIB_SUCCESS);
+    }
+    return_status = optiga_shell_request_wait(&optiga_shell_random_request);
+    (void)optiga_shell_pool_put_crypt(optiga_shell_random_crypt);
+    optiga_shell_random_crypt = NULL;
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        optiga_shell_random_stats.refill_errors++;
+        optiga_shell_random_paused = TRUE;
+        return (return_status);
+    }
+    optiga_shell_random_store(optiga_shell_random_refill, sizeof(optiga_shell_random_refill));
+    memset(optiga_shell_random_refill, 0, sizeof(optiga_shell_random_refill));
+    optiga_shell_random_stats.background_refills++;
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+/**
+ * Refills the empty pool for a request, from the background refill in flight if there is one
+ */
+static optiga_lib_status_t optiga_shell_random_refill_now(void)
+{
+    optiga_lib_status_t return_status;
+    optiga_crypt_t * me;
+
+    if ((NULL != optiga_shell_random_crypt) && (OPTIGA_LIB_SUCCESS == optiga_shell_random_collect()))
+    {
+        return (OPTIGA_LIB_SUCCESS);
+    }
+    me = optiga_shell_pool_get_crypt(&optiga_shell_random_request);
+    if (NULL == me)
+    {
+        return (OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT);
+    }
+    return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_random_request,
+                                             optiga_crypt_random(me, OPTIGA_RNG_TYPE_TRNG, optiga_shell_random_refill,
+                                                                 sizeof(optiga_shell_random_refill)));
+    (void)optiga_shell_pool_put_crypt(me);
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        optiga_shell_random_stats.refill_errors++;
+        return (return_status);
+    }
+    optiga_shell_random_store(optiga_shell_random_refill, sizeof(optiga_shell_random_refill));
+    memset(optiga_shell_random_refill, 0, sizeof(optiga_shell_random_refill));
+    optiga_shell_random_stats.foreground_refills++;
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+static optiga_lib_status_t optiga_shell_random_get_pool(uint8_t * p_data, uint32_t length)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    uint32_t served = 0;
+
+    optiga_shell_random_paused = FALSE;
+    while (served < length)
+    {
+        if (0U == optiga_shell_random_level)
+        {
+            return_status = optiga_shell_random_refill_now();
+            if (OPTIGA_LIB_SUCCESS != return_status)
+            {
+                break;
+            }
+        }
+        served += optiga_shell_random_take(&p_data[served], length - served);
+    }
+    return (return_status);
+}
+
+static optiga_lib_status_t optiga_shell_random_get_optiga(uint8_t * p_data, uint32_t length)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    optiga_crypt_t * me;
+    uint32_t offset;
+    uint16_t chunk;
+
+    me = optiga_shell_pool_get_crypt(&optiga_shell_random_request);
+    if (NULL == me)
+    {
+        return (OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT);
+    }
+    for (offset = 0; (offset < length) && (OPTIGA_LIB_SUCCESS == return_status); offset += chunk)
+    {
+        chunk = (uint16_t)(((length - offset) < OPTIGA_SHELL_RANDOM_MAX_REQUEST) ? (length - offset) :
+                                                                                  OPTIGA_SHELL_RANDOM_MAX_REQUEST);
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_random_request,
+                                                 optiga_crypt_random(me, OPTIGA_RNG_TYPE_TRNG, &p_data[offset], chunk));
+    }
+    (void)optiga_shell_pool_put_crypt(me);
+    return (return_status);
+}
+
+/**
+ * Entropy source of the CTR-DRBG
+ */
+static int optiga_shell_random_entropy(void * p_context, unsigned char * p_output, size_t length)
+{
+    (void)p_context;
+    optiga_shell_random_stats.seeds++;
+    if (OPTIGA_LIB_SUCCESS != optiga_shell_random_get_pool(p_output, (uint32_t)length))
+    {
+        return (MBEDTLS_ERR_CTR_DRBG_ENTROPY_SOURCE_FAILED);
+    }
+    return (0);
+}
+
+static optiga_lib_status_t optiga_shell_random_get_drbg(uint8_t * p_data, uint32_t length)
+{
+    uint32_t offset;
+    uint32_t chunk;
+
+    if (FALSE == optiga_shell_random_seeded)
+    {
+        mbedtls_ctr_drbg_init(&optiga_shell_random_drbg);
+        if (0 != mbedtls_ctr_drbg_seed(&optiga_shell_random_drbg, optiga_shell_random_entropy, NULL,
+                                       (const unsigned char *)optiga_shell_random_personalization,
+                                       sizeof(optiga_shell_random_personalization) - 1U))
+        {
+            mbedtls_ctr_drbg_free(&optiga_shell_random_drbg);
+            return (OPTIGA_SHELL_RANDOM_ERROR_DRBG);
+        }
+        mbedtls_ctr_drbg_set_reseed_interval(&optiga_shell_random_drbg, (int)optiga_shell_random_reseed_interval);
+        optiga_shell_random_seeded = TRUE;
+    }
+    for (offset = 0; offset < length; offset += chunk)
+    {
+        chunk = ((length - offset) < MBEDTLS_CTR_DRBG_MAX_REQUEST) ? (length - offset) : MBEDTLS_CTR_DRBG_MAX_REQUEST;
+        if (0 != mbedtls_ctr_drbg_random(&optiga_shell_random_drbg, &p_data[offset], chunk))
+        {
+            return (OPTIGA_SHELL_RANDOM_ERROR_DRBG);
+        }
+    }
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+optiga_lib_status_t optiga_shell_random_get(uint8_t source, uint8_t * p_data, uint32_t length)
+{
+    switch (source)
+    {
+        case OPTIGA_SHELL_RANDOM_SOURCE_POOL:
+            return (optiga_shell_random_get_pool(p_data, length));
+        case OPTIGA_SHELL_RANDOM_SOURCE_DRBG:
+            return (optiga_shell_random_get_drbg(p_data, length));
+        default:
+            return (optiga_shell_random_get_optiga(p_data, length));
+    }
+}
+
+uint32_t optiga_shell_random_poll(void)
+{
+    optiga_lib_status_t return_status;
+    optiga_crypt_t * me;
+
+    if (NULL != optiga_shell_random_crypt)
+    {
+        if (FALSE == optiga_shell_request_is_done(&optiga_shell_random_request))
+        {
+            return (OPTIGA_SHELL_RANDOM_POLL_MS);
+        }
+        (void)optiga_shell_random_collect();
+    }
+    if ((TRUE == optiga_shell_random_paused) || (OPTIGA_SHELL_SESSION_OPEN != optiga_shell_session_get_state()) ||
+        ((optiga_shell_random_level + OPTIGA_SHELL_RANDOM_REFILL_LENGTH) > OPTIGA_SHELL_RANDOM_POOL_SIZE))
+    {
+        return (OPTIGA_SHELL_RANDOM_NO_DEADLINE);
+    }
+
+    me = optiga_shell_pool_get_crypt(&optiga_shell_random_request);
+    if (NULL == me)
+    {
+        return (OPTIGA_SHELL_RANDOM_NO_DEADLINE);
+    }
+    optiga_shell_request_start(&optiga_shell_random_request);
+    return_status = optiga_crypt_random(me, OPTIGA_RNG_TYPE_TRNG, optiga_shell_random_refill,
+                                        sizeof(optiga_shell_random_refill));
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        (void)optiga_shell_pool_put_crypt(me);
+        optiga_shell_random_stats.refill_errors++;
+        optiga_shell_random_paused = TRUE;
+        return (OPTIGA_SHELL_RANDOM_NO_DEADLINE);
+    }
+    optiga_shell_random_crypt = me;
+    return (OPTIGA_SHELL_RANDOM_POLL_MS);
+}
+
+void optiga_shell_random_set_reseed_interval(uint32_t interval)
+{
+    optiga_shell_random_reseed_interval = interval;
+    if (TRUE == optiga_shell_random_seeded)
+    {
+        mbedtls_ctr_drbg_set_reseed_interval(&optiga_shell_random_drbg, (int)interval);
+    }
+}
+
+void optiga_shell_random_get_stats(optiga_shell_random_stats_t * p_stats)
+{
+    *p_stats = optiga_shell_random_stats;
+    p_stats->level = optiga_shell_random_level;
+}
+
+/**
+ * Time between two requests of an application: the pool gets one background refill
+ */
+static void optiga_shell_random_bench_idle(void)
+{
+    if (OPTIGA_SHELL_RANDOM_NO_DEADLINE != optiga_shell_random_poll())
+    {
+        (void)optiga_shell_random_collect();
+    }
+}
+
+void optiga_shell_cmd_randbench(optiga_shell_args_t * p_args)
+{
+    static const char_t * const source_names[] = {"optiga", "pool", "drbg"};
+    static const uint32_t lengths[] = {16, 32, OPTIGA_SHELL_RANDOM_BENCH_MAX_LENGTH};
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    optiga_shell_random_stats_t stats;
+    uint32_t iterations;
+    uint32_t reseed;
+    uint32_t source;
+    uint32_t length_index;
+    uint32_t index;
+    uint32_t foreground_refills;
+    uint32_t total_us;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint32_t elapsed_us;
+    char_t line[120];
+
+    if ((FALSE == optiga_shell_args_get_number(p_args, "iterations", OPTIGA_SHELL_RANDOM_BENCH_ITERATIONS, 1,
+                                               OPTIGA_SHELL_RANDOM_BENCH_MAX_ITERATIONS, &iterations)) ||
+        (FALSE == optiga_shell_args_get_number(p_args, "reseed", optiga_shell_random_reseed_interval, 1,
+                                               0x7FFFFFFFU, &reseed)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_random_set_reseed_interval(reseed);
+
+    /*
+     * Start from a full pool, as after the shell waited for input for a while
+     */
+    optiga_shell_random_paused = FALSE;
+    while ((OPTIGA_LIB_SUCCESS == return_status) &&
+           ((optiga_shell_random_level + OPTIGA_SHELL_RANDOM_REFILL_LENGTH) <= OPTIGA_SHELL_RANDOM_POOL_SIZE))
+    {
+        return_status = optiga_shell_random_refill_now();
+    }
+
+    optiga_lib_print_string_with_newline("source,length,iterations,avg_us,min_us,max_us,foreground_refills,status");
+    for (source = 0; source < (sizeof(source_names) / sizeof(source_names[0])); source++)
+    {
+        /*
+         * Not timed: the pooled crypt instance is created and the CTR-DRBG is seeded
+         */
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            return_status = optiga_shell_random_get((uint8_t)source, optiga_shell_random_bench_buffer, lengths[0]);
+        }
+        for (length_index = 0; length_index < (sizeof(lengths) / sizeof(lengths[0])); length_index++)
+        {
+            foreground_refills = optiga_shell_random_stats.foreground_refills;
+            total_us = 0;
+            min_us = 0xFFFFFFFFU;
+            max_us = 0;
+            for (index = 0; (index < iterations) && (OPTIGA_LIB_SUCCESS == return_status); index++)
+            {
+                optiga_shell_random_bench_idle();
+                elapsed_us = pal_os_timer_get_time_in_microseconds();
+                return_status = optiga_shell_random_get((uint8_t)source, optiga_shell_random_bench_buffer,
+                                                        lengths[length_index]);
+                elapsed_us = pal_os_timer_get_time_in_microseconds() - elapsed_us;
+                total_us += elapsed_us;
+                min_us = (elapsed_us < min_us) ? elapsed_us : min_us;
+                max_us = (elapsed_us > max_us) ? elapsed_us : max_us;
+            }
+            snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu,%lu,%lu,0x%04X", source_names[source],
+                     (unsigned long)lengths[length_index], (unsigned long)index,
+                     (unsigned long)((0U != index) ? (total_us / index) : 0U),
+                     (unsigned long)((0U != index) ? min_us : 0U), (unsigned long)max_us,
+                     (unsigned long)(optiga_shell_random_stats.foreground_refills - foreground_refills),
+                     (unsigned int)return_status);
+            optiga_lib_print_string_with_newline(line);
+        }
+    }
+    memset(optiga_shell_random_bench_buffer, 0, sizeof(optiga_shell_random_bench_buffer));
+
+    optiga_shell_random_get_stats(&stats);
+    optiga_lib_print_string_with_newline("pool_level,background_refills,foreground_refills,refill_errors,drbg_seeds,"
+                                         "reseed_interval");
+    snprintf(line, sizeof(line), "%lu,%lu,%lu,%lu,%lu,%lu", (unsigned long)stats.level,
+             (unsigned long)stats.background_refills, (unsigned long)stats.foreground_refills,
+             (unsigned long)stats.refill_errors, (unsigned long)stats.seeds,
+             (unsigned long)optiga_shell_random_reseed_interval);
+    optiga_lib_print_string_with_newline(line);
+}
@@ -0,0 +1,163 @@
+/******************************************************************************
+* File Name:   optiga_shell_random.h
+*
+* Description: Random service with a prefetched TRNG pool and a CTR-DRBG seeded from it
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_RANDOM_H_
+#define _OPTIGA_SHELL_RANDOM_H_
+
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga/common/optiga_lib_return_codes.h"
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Sources of #optiga_shell_random_get */
+/// One TRNG command per request, like example_optiga_crypt_random
+#define OPTIGA_SHELL_RANDOM_SOURCE_OPTIGA       (0U)
+/// TRNG output of OPTIGA prefetched into a ring on the host
+#define OPTIGA_SHELL_RANDOM_SOURCE_POOL         (1U)
+/// CTR-DRBG of mbedTLS on the host, seeded and reseeded from the pool
+#define OPTIGA_SHELL_RANDOM_SOURCE_DRBG         (2U)
+
+/** @brief Bytes of TRNG output the host keeps prefetched */
+#ifndef OPTIGA_SHELL_RANDOM_POOL_SIZE
+#define OPTIGA_SHELL_RANDOM_POOL_SIZE           (1024U)
+#endif
+
+/** @brief Bytes of one TRNG command refilling the pool, OPTIGA returns up to 256 */
+#ifndef OPTIGA_SHELL_RANDOM_REFILL_LENGTH
+#define OPTIGA_SHELL_RANDOM_REFILL_LENGTH       (256U)
+#endif
+
+/** @brief Requests the CTR-DRBG serves before it takes new entropy from the pool */
+#ifndef OPTIGA_SHELL_RANDOM_RESEED_INTERVAL
+#define OPTIGA_SHELL_RANDOM_RESEED_INTERVAL     (1000U)
+#endif
+
+/** @brief Returned by #optiga_shell_random_poll if no refill is in flight */
+#define OPTIGA_SHELL_RANDOM_NO_DEADLINE         (0xFFFFFFFFU)
+/** @brief Milliseconds after which #optiga_shell_random_poll looks at a refill in flight again */
+#define OPTIGA_SHELL_RANDOM_POLL_MS             (2U)
+
+/** @brief The CTR-DRBG of mbedTLS failed, e.g. the pool gave no entropy */
+#define OPTIGA_SHELL_RANDOM_ERROR_DRBG          (0xF501)
+
+/** @brief Default and largest number of requests per source and length of optiga --randbench */
+#define OPTIGA_SHELL_RANDOM_BENCH_ITERATIONS        (10U)
+#define OPTIGA_SHELL_RANDOM_BENCH_MAX_ITERATIONS    (100U)
+
+/** @brief Argument usage of the randbench command, as shown by help */
+#define OPTIGA_SHELL_RANDOM_BENCH_USAGE         "[--iterations <n>] [--reseed <requests>]"
+
+/** @brief Counters of the random service since start */
+typedef struct optiga_shell_random_stats
+{
+    /// Bytes in the pool
+    uint32_t level;
+    /// TRNG commands sent while the shell waited for input, and by requests finding the pool empty
+    uint32_t background_refills;
+    uint32_t foreground_refills;
+    /// Failed refills, the background ones pause until the next request
+    uint32_t refill_errors;
+    /// Times the CTR-DRBG took entropy from the pool, the first one is its seed
+    uint32_t seeds;
+} optiga_shell_random_stats_t;
+
+/**
+ * @brief Fills the buffer with random bytes of the source given.
+ *
+ * #OPTIGA_SHELL_RANDOM_SOURCE_POOL takes the bytes from the pool and refills it with one TRNG
+ * command whenever it runs empty, waiting for a background refill in flight first.
+ * #OPTIGA_SHELL_RANDOM_SOURCE_DRBG seeds the CTR-DRBG from the pool on first use. The pool and
+ * the CTR-DRBG must only be used from the shell task, and a refill needs the application on
+ * OPTIGA to be open.
+ *
+ * @param[in]  source   #OPTIGA_SHELL_RANDOM_SOURCE_OPTIGA, #OPTIGA_SHELL_RANDOM_SOURCE_POOL or
+ *                      #OPTIGA_SHELL_RANDOM_SOURCE_DRBG
+ * @param[out] p_data   Buffer to fill
+ * @param[in]  length   Length of the buffer, at least 8 bytes for #OPTIGA_SHELL_RANDOM_SOURCE_OPTIGA
+ *
+ * @retval #OPTIGA_LIB_SUCCESS              The buffer is filled
+ * @retval #OPTIGA_SHELL_RANDOM_ERROR_DRBG  The CTR-DRBG failed
+ * @retval Error of optiga_crypt otherwise
+ */
+optiga_lib_status_t optiga_shell_random_get(uint8_t source, uint8_t * p_data, uint32_t length);
+
+/**
+ * @brief Refills the pool in the background. To be called while the shell waits for input.
+ *
+ * Collects a completed refill and sends the next TRNG command without waiting for it while the
+ * pool has room for #OPTIGA_SHELL_RANDOM_REFILL_LENGTH bytes. Nothing is sent while the
+ * application on OPTIGA is not open, the pool does not wake a hibernated application.
+ *
+ * @return Milliseconds until the refill in flight should be looked at again,
+ *         #OPTIGA_SHELL_RANDOM_NO_DEADLINE if none is in flight
+ */
+uint32_t optiga_shell_random_poll(void);
+
+/**
+ * @brief Sets the requests the CTR-DRBG serves between two reseeds, until the next reset.
+ */
+void optiga_shell_random_set_reseed_interval(uint32_t interval);
+
+/**
+ * @brief Copies the counters of the random service.
+ */
+void optiga_shell_random_get_stats(optiga_shell_random_stats_t * p_stats);
+
+/**
+ * @brief Measures the latency of 16, 32 and 1024 byte requests from each source.
+ *
+ * The pool is filled first. Between two requests the pool gets one background refill, as it
+ * would while an application waits for input. Prints one CSV line per source and length with
+ * the average, min and max time and the refills the requests had to wait for, then the counters
+ * of the service. --reseed sets the reseed interval of the CTR-DRBG until the next reset.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_randbench(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_RANDOM_H_ */
@@ -0,0 +1,90 @@
+/******************************************************************************
+* File Name:   optiga_shell_request.c
+*
+* Description: Completion context of asynchronous OPTIGA operations, one per crypt or
+*              util instance
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_wait.h"
+
+void optiga_shell_request_callback(void * context, optiga_lib_status_t return_status)
+{
+    optiga_shell_request_t * p_request = (optiga_shell_request_t *)context;
+
+    if (NULL == p_request)
+    {
+        return;
+    }
+    p_request->complete_us = pal_os_timer_get_time_in_microseconds();
+    p_request->status = return_status;
+}
+
+void optiga_shell_request_start(optiga_shell_request_t * p_request)
+{
+    p_request->status = OPTIGA_LIB_BUSY;
+    p_request->complete_us = 0;
+    p_request->start_us = pal_os_timer_get_time_in_microseconds();
+}
+
+bool_t optiga_shell_request_is_done(const optiga_shell_request_t * p_request)
+{
+    return ((OPTIGA_LIB_BUSY != p_request->status) ? TRUE : FALSE);
+}
+
+optiga_lib_status_t optiga_shell_request_wait(optiga_shell_request_t * p_request)
+{
+    optiga_shell_wait_for_completion(&p_request->status);
+    return (p_request->status);
+}
+
+optiga_lib_status_t optiga_shell_request_complete(optiga_shell_request_t * p_request,
+                                                  optiga_lib_status_t return_status)
+{
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        return (return_status);
+    }
+    return (optiga_shell_request_wait(p_request));
+}
+
+uint32_t optiga_shell_request_get_latency_us(const optiga_shell_request_t * p_request)
+{
+    return (p_request->complete_us - p_request->start_us);
+}
@@ -0,0 +1,138 @@
+/******************************************************************************
+* File Name:   optiga_shell_request.h
+*
+* Description: Completion context of asynchronous OPTIGA operations, one per crypt or
+*              util instance
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_REQUEST_H_
+#define _OPTIGA_SHELL_REQUEST_H_
+
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga/common/optiga_lib_return_codes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Completion context of the asynchronous operations of one crypt or util instance.
+ *
+ * The request is given as context to optiga_crypt_create() or optiga_util_create() together
+ * with #optiga_shell_request_callback, so each instance reports into its own request and
+ * several instances can have an operation in flight at the same time. A request must outlive
+ * the instance it is registered with.
+ */
+typedef struct optiga_shell_request
+{
+    /// #OPTIGA_LIB_BUSY while the operation runs, its result afterwards
+    volatile optiga_lib_status_t status;
+    /// Result length for operations taking a uint16_t length, e.g. signatures and data objects
+    uint16_t result_length;
+    /// Result length for operations taking a uint32_t length, e.g. HMAC and symmetric encryption
+    uint32_t result_length_32;
+    /// Time the operation was started and completed, in microseconds
+    uint32_t start_us;
+    volatile uint32_t complete_us;
+} optiga_shell_request_t;
+
+/**
+ * @brief Completion callback of the crypt and util instances, the context is the request.
+ */
+void optiga_shell_request_callback(void * context, optiga_lib_status_t return_status);
+
+/**
+ * @brief Marks the request as in flight, to be called right before the operation is started.
+ */
+void optiga_shell_request_start(optiga_shell_request_t * p_request);
+
+/**
+ * @brief Tells whether the operation is completed, without waiting.
+ */
+bool_t optiga_shell_request_is_done(const optiga_shell_request_t * p_request);
+
+/**
+ * @brief Waits until the operation is completed, see #optiga_shell_wait_for_completion.
+ *
+ * @return Result of the operation
+ */
+optiga_lib_status_t optiga_shell_request_wait(optiga_shell_request_t * p_request);
+
+/**
+ * @brief Waits for the operation only if it was accepted by optiga_crypt or optiga_util.
+ *
+ * @param p_request     Request of the instance the operation was started on
+ * @param return_status Return value of the optiga_crypt_xxx or optiga_util_xxx call
+ *
+ * @return return_status if the call failed, the result of the operation otherwise
+ */
+optiga_lib_status_t optiga_shell_request_complete(optiga_shell_request_t * p_request,
+                                                  optiga_lib_status_t return_status);
+
+/**
+ * @brief Time from the start to the completion of the operation, in microseconds.
+ */
+uint32_t optiga_shell_request_get_latency_us(const optiga_shell_request_t * p_request);
+
+/**
+ * Waits for the completion of the request and leaves the enclosing do {} while (FALSE) on
+ * failure. Replaces WAIT_AND_CHECK_STATUS of optiga_example.h, which spins on a status global.
+ */
+#define OPTIGA_SHELL_REQUEST_WAIT_AND_CHECK(return_status, request)\
+    if (OPTIGA_LIB_SUCCESS != return_status)\
+    {\
+        break;\
+    }\
+    return_status = optiga_shell_request_wait(&(request));\
+    if (OPTIGA_LIB_SUCCESS != return_status)\
+    {\
+        break;\
+    }
+
+/**
+ * Starts the request, runs the asynchronous crypt or util call and waits for its completion.
+ * Evaluates to the result of the operation.
+ */
+#define OPTIGA_SHELL_REQUEST_RUN(request, call)\
+    (optiga_shell_request_start(&(request)), optiga_shell_request_complete(&(request), (call)))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_REQUEST_H_ */
@@ -0,0 +1,428 @@
+/******************************************************************************
+* File Name:   optiga_shell_rpc.c
+*
+* Description: Binary framed RPC on the shell console. Executes the requests
+*              with dedicated optiga_crypt and optiga_util instances and answers
+*              with the raw result bytes.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/optiga_util.h"
+#include "optiga_shell_rpc.h"
+#include "optiga_shell_uart.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_policy.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_session.h"
+#include "optiga_shell_verify.h"
+
+#define OPTIGA_SHELL_RPC_MAX_RANDOM_LENGTH      (0x100U)
+#define OPTIGA_SHELL_RPC_SHA256_LENGTH          (32U)
+#define OPTIGA_SHELL_RPC_MAX_ECC_PUBLIC_KEY     (150U)
+#define OPTIGA_SHELL_RPC_MAX_ECC_SIGNATURE      (150U)
+
+#define OPTIGA_SHELL_RPC_READ_U16(p_data)       ((uint16_t)(((uint16_t)(p_data)[0] << 8) | (p_data)[1]))
+
+extern bool_t optiga_shell_run_cmd(const char_t * cmd, uint32_t cmd_length);
+
+/** @brief Request under reception, decoded in place once the closing delimiter arrives */
+static uint8_t optiga_shell_rpc_frame[OPTIGA_SHELL_RPC_COBS_LENGTH(OPTIGA_SHELL_RPC_MAX_MESSAGE_LENGTH)];
+static uint32_t optiga_shell_rpc_frame_length = 0;
+static bool_t optiga_shell_rpc_in_frame = FALSE;
+static bool_t optiga_shell_rpc_frame_overflow = FALSE;
+
+static uint8_t optiga_shell_rpc_response[OPTIGA_SHELL_RPC_MAX_MESSAGE_LENGTH];
+static uint8_t optiga_shell_rpc_encoded[OPTIGA_SHELL_RPC_COBS_LENGTH(OPTIGA_SHELL_RPC_MAX_MESSAGE_LENGTH) + 2U];
+
+static optiga_crypt_t * optiga_shell_rpc_crypt = NULL;
+static optiga_util_t * optiga_shell_rpc_util = NULL;
+static optiga_shell_request_t optiga_shell_rpc_crypt_request;
+static optiga_shell_request_t optiga_shell_rpc_util_request;
+
+/**
+ * Runs an asynchronous crypt or util call and waits for its completion
+ */
+#define OPTIGA_SHELL_RPC_CRYPT(call)    OPTIGA_SHELL_REQUEST_RUN(optiga_shell_rpc_crypt_request, call)
+#define OPTIGA_SHELL_RPC_UTIL(call)     OPTIGA_SHELL_REQUEST_RUN(optiga_shell_rpc_util_request, call)
+
+/**
+ * Takes a crypt and a util instance from the pool for one request. A request with a key in a
+ * session context, e.g. a key pair generated to 0xE100, gets a session crypt instance, which is
+ * never pooled, so the context it acquires is released with the instance after the request.
+ */
+static optiga_lib_status_t optiga_shell_rpc_get_instances(uint8_t operation,
+                                                          const uint8_t * p_request,
+                                                          uint32_t request_length)
+{
+    bool_t session_oid = FALSE;
+
+    if ((OPTIGA_SHELL_RPC_ECC_GENERATE_KEYPAIR == operation) && (4U == request_length))
+    {
+        session_oid = OPTIGA_SHELL_POOL_IS_SESSION_OID(OPTIGA_SHELL_RPC_READ_U16(&p_request[2]));
+    }
+    else if ((OPTIGA_SHELL_RPC_ECDSA_SIGN == operation) && (2U < request_length))
+    {
+        session_oid = OPTIGA_SHELL_POOL_IS_SESSION_OID(OPTIGA_SHELL_RPC_READ_U16(p_request));
+    }
+    optiga_shell_rpc_crypt = (TRUE == session_oid) ?
+                             optiga_shell_pool_get_session_crypt(&optiga_shell_rpc_crypt_request) :
+                             optiga_shell_pool_get_crypt(&optiga_shell_rpc_crypt_request);
+    optiga_shell_rpc_util = optiga_shell_pool_get_util(&optiga_shell_rpc_util_request);
+    return (((NULL == optiga_shell_rpc_crypt) || (NULL == optiga_shell_rpc_util)) ?
+            OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT : OPTIGA_LIB_SUCCESS);
+}
+
+static void optiga_shell_rpc_put_instances(void)
+{
+    (void)optiga_shell_pool_put_crypt(optiga_shell_rpc_crypt);
+    (void)optiga_shell_pool_put_util(optiga_shell_rpc_util);
+    optiga_shell_rpc_crypt = NULL;
+    optiga_shell_rpc_util = NULL;
+}
+
+/**
+ * Executes one request. The response payload is written to p_response and its length
+ * returned through p_response_length.
+ */
+static uint16_t optiga_shell_rpc_execute(uint8_t operation,
+                                         const uint8_t * p_request,
+                                         uint32_t request_length,
+                                         uint8_t * p_response,
+                                         uint16_t * p_response_length)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    hash_data_from_host_t hash_data;
+    public_key_from_host_t public_key;
+    optiga_key_id_t key_id;
+    uint16_t length;
+    uint8_t digest_length;
+
+    *p_response_length = 0;
+    if (OPTIGA_SHELL_RPC_MAX_PAYLOAD_LENGTH < request_length)
+    {
+        return (OPTIGA_SHELL_RPC_ERROR_INVALID_PAYLOAD);
+    }
+
+    switch (operation)
+    {
+        case OPTIGA_SHELL_RPC_PING:
+        {
+            memcpy(p_response, p_request, request_length);
+            *p_response_length = (uint16_t)request_length;
+            break;
+        }
+        case OPTIGA_SHELL_RPC_RUN_COMMAND:
+        {
+            if (FALSE == optiga_shell_run_cmd((const char_t *)p_request, request_length))
+            {
+                return_status = OPTIGA_SHELL_RPC_ERROR_UNKNOWN_COMMAND;
+            }
+            break;
+        }
+        case OPTIGA_SHELL_RPC_GET_RANDOM:
+        {
+            if ((2U != request_length) ||
+                (OPTIGA_SHELL_RPC_MAX_RANDOM_LENGTH < OPTIGA_SHELL_RPC_READ_U16(p_request)))
+            {
+                return_status = OPTIGA_SHELL_RPC_ERROR_INVALID_PAYLOAD;
+                break;
+            }
+            length = OPTIGA_SHELL_RPC_READ_U16(p_request);
+            return_status = OPTIGA_SHELL_RPC_CRYPT(optiga_crypt_random(optiga_shell_rpc_crypt,
+                                                                       OPTIGA_RNG_TYPE_TRNG,
+                                                                       p_response,
+                                                                       length));
+            *p_response_length = length;
+            break;
+        }
+        case OPTIGA_SHELL_RPC_HASH_SHA256:
+        {
+            hash_data.buffer = p_request;
+            hash_data.length = request_length;
+            return_status = OPTIGA_SHELL_RPC_CRYPT(optiga_crypt_hash(optiga_shell_rpc_crypt,
+                                                                     OPTIGA_HASH_TYPE_SHA_256,
+                                                                     OPTIGA_CRYPT_HOST_DATA,
+                                                                     &hash_data,
+                                                                     p_response));
+            *p_response_length = OPTIGA_SHELL_RPC_SHA256_LENGTH;
+            break;
+        }
+        case OPTIGA_SHELL_RPC_ECC_GENERATE_KEYPAIR:
+        {
+            if (4U != request_length)
+            {
+                return_status = OPTIGA_SHELL_RPC_ERROR_INVALID_PAYLOAD;
+                break;
+            }
+            key_id = (optiga_key_id_t)OPTIGA_SHELL_RPC_READ_U16(&p_request[2]);
+            length = OPTIGA_SHELL_RPC_MAX_ECC_PUBLIC_KEY;
+            return_status = OPTIGA_SHELL_RPC_CRYPT(optiga_crypt_ecc_generate_keypair(optiga_shell_rpc_crypt,
+                                                                                     (optiga_ecc_curve_t)p_request[0],
+                                                                                     p_request[1],
+                                                                                     FALSE,
+                                                                                     &key_id,
+                                                                                     p_response,
+                                                                                     &length));
+            *p_response_length = length;
+            break;
+        }
+        case OPTIGA_SHELL_RPC_ECDSA_SIGN:
+        {
+            if ((2U >= request_length) || ((2U + 0xFFU) < request_length))
+            {
+                return_status = OPTIGA_SHELL_RPC_ERROR_INVALID_PAYLOAD;
+                break;
+            }
+            length = OPTIGA_SHELL_RPC_MAX_ECC_SIGNATURE;
+            return_status = OPTIGA_SHELL_RPC_CRYPT(optiga_crypt_ecdsa_sign(optiga_shell_rpc_crypt,
+                                                                           &p_request[2],
+                                                                           (uint8_t)(request_length - 2U),
+                                                                           (optiga_key_id_t)OPTIGA_SHELL_RPC_READ_U16(p_request),
+                                                                           p_response,
+                                                                           &length));
+            *p_response_length = length;
+            break;
+        }
+        case OPTIGA_SHELL_RPC_ECDSA_VERIFY:
+        {
+            if (3U > request_length)
+            {
+                return_status = OPTIGA_SHELL_RPC_ERROR_INVALID_PAYLOAD;
+                break;
+            }
+            length = OPTIGA_SHELL_RPC_READ_U16(&p_request[1]);
+            if ((3U + length + 1U) > request_length)
+            {
+                return_status = OPTIGA_SHELL_RPC_ERROR_INVALID_PAYLOAD;
+                break;
+            }
+            digest_length = p_request[3U + length];
+            if ((3U + length + 1U + digest_length) >= request_length)
+            {
+                return_status = OPTIGA_SHELL_RPC_ERROR_INVALID_PAYLOAD;
+                break;
+            }
+            public_key.public_key = (uint8_t *)&p_request[3];
+            public_key.length = length;
+            public_key.key_type = p_request[0];
+            return_status = optiga_shell_verify_ecdsa(&p_request[3U + length + 1U],
+                                                      digest_length,
+                                                      &p_request[3U + length + 1U + digest_length],
+                                                      (uint16_t)(request_length - (3U + length + 1U + digest_length)),
+                                                      &public_key,
+                                                      OPTIGA_SHELL_VERIFY_DEFAULT_ENGINE);
+            break;
+        }
+        case OPTIGA_SHELL_RPC_READ_DATA:
+        {
+            if ((6U != request_length) ||
+                (OPTIGA_SHELL_RPC_MAX_PAYLOAD_LENGTH < OPTIGA_SHELL_RPC_READ_U16(&p_request[4])))
+            {
+                return_status = OPTIGA_SHELL_RPC_ERROR_INVALID_PAYLOAD;
+                break;
+            }
+            length = OPTIGA_SHELL_RPC_READ_U16(&p_request[4]);
+            (void)optiga_shell_policy_apply_util(optiga_shell_rpc_util, "read_data", OPTIGA_SHELL_RPC_READ_U16(p_request));
+            return_status = OPTIGA_SHELL_RPC_UTIL(optiga_util_read_data(optiga_shell_rpc_util,
+                                                                        OPTIGA_SHELL_RPC_READ_U16(p_request),
+                                                                        OPTIGA_SHELL_RPC_READ_U16(&p_request[2]),
+                                                                        p_response,
+                                                                        &length));
+            *p_response_length = length;
+            break;
+        }
+        case OPTIGA_SHELL_RPC_WRITE_DATA:
+        {
+            if (5U > request_length)
+            {
+                return_status = OPTIGA_SHELL_RPC_ERROR_INVALID_PAYLOAD;
+                break;
+            }
+            (void)optiga_shell_policy_apply_util(optiga_shell_rpc_util, "write_data", OPTIGA_SHELL_RPC_READ_U16(p_request));
+            return_status = OPTIGA_SHELL_RPC_UTIL(optiga_util_write_data(optiga_shell_rpc_util,
+                                                                         OPTIGA_SHELL_RPC_READ_U16(p_request),
+                                                                         p_request[2],
+                                                                         OPTIGA_SHELL_RPC_READ_U16(&p_request[3]),
+                                                                         &p_request[5],
+                                                                         (uint16_t)(request_length - 5U)));
+            break;
+        }
+        case OPTIGA_SHELL_RPC_READ_METADATA:
+        {
+            if (2U != request_length)
+            {
+                return_status = OPTIGA_SHELL_RPC_ERROR_INVALID_PAYLOAD;
+                break;
+            }
+            length = OPTIGA_SHELL_RPC_MAX_PAYLOAD_LENGTH;
+            return_status = OPTIGA_SHELL_RPC_UTIL(optiga_util_read_metadata(optiga_shell_rpc_util,
+                                                                            OPTIGA_SHELL_RPC_READ_U16(p_request),
+                                                                            p_response,
+                                                                            &length));
+            *p_response_length = length;
+            break;
+        }
+        default:
+        {
+            return_status = OPTIGA_SHELL_RPC_ERROR_UNKNOWN_OPERATION;
+            break;
+        }
+    }
+
+    if (OPTIGA_LIB_SUCCESS != return_status)
+    {
+        *p_response_length = 0;
+    }
+    return ((uint16_t)return_status);
+}
+
+static void optiga_shell_rpc_send(uint8_t sequence, uint8_t operation, uint16_t status, uint16_t payload_length)
+{
+    uint32_t message_length = OPTIGA_SHELL_RPC_RESPONSE_HEADER_LENGTH + payload_length;
+    uint32_t encoded_length;
+    uint16_t crc;
+
+    optiga_shell_rpc_response[0] = sequence;
+    optiga_shell_rpc_response[1] = operation | OPTIGA_SHELL_RPC_RESPONSE;
+    optiga_shell_rpc_response[2] = (uint8_t)(status >> 8);
+    optiga_shell_rpc_response[3] = (uint8_t)status;
+    crc = optiga_shell_rpc_crc16(optiga_shell_rpc_response, message_length);
+    optiga_shell_rpc_response[message_length++] = (uint8_t)(crc >> 8);
+    optiga_shell_rpc_response[message_length++] = (uint8_t)crc;
+
+    optiga_shell_rpc_encoded[0] = OPTIGA_SHELL_RPC_FRAME_DELIMITER;
+    encoded_length = optiga_shell_rpc_cobs_encode(optiga_shell_rpc_response,
+                                                  message_length,
+                                                  &optiga_shell_rpc_encoded[1]);
+    optiga_shell_rpc_encoded[encoded_length + 1U] = OPTIGA_SHELL_RPC_FRAME_DELIMITER;
+    (void)optiga_shell_uart_write(optiga_shell_rpc_encoded, encoded_length + 2U);
+}
+
+static void optiga_shell_rpc_process_frame(void)
+{
+    uint8_t * p_message = optiga_shell_rpc_frame;
+    uint32_t message_length;
+    uint16_t response_length = 0;
+    uint16_t status;
+    bool_t session;
+
+    message_length = optiga_shell_rpc_cobs_decode(p_message, optiga_shell_rpc_frame_length, p_message);
+    if ((TRUE == optiga_shell_rpc_frame_overflow) ||
+        ((OPTIGA_SHELL_RPC_REQUEST_HEADER_LENGTH + OPTIGA_SHELL_RPC_CRC_LENGTH) > message_length) ||
+        (optiga_shell_rpc_crc16(p_message, message_length - OPTIGA_SHELL_RPC_CRC_LENGTH) !=
+         OPTIGA_SHELL_RPC_READ_U16(&p_message[message_length - OPTIGA_SHELL_RPC_CRC_LENGTH])))
+    {
+        /*
+         * The sequence number of a corrupted frame cannot be trusted, report it as 0
+         */
+        optiga_shell_rpc_send(0, 0, OPTIGA_SHELL_RPC_ERROR_INVALID_FRAME, 0);
+        return;
+    }
+
+    /*
+     * Shell commands open the application through the dispatcher, ping does not need it
+     */
+    status = OPTIGA_LIB_SUCCESS;
+    session = ((OPTIGA_SHELL_RPC_PING != p_message[1]) && (OPTIGA_SHELL_RPC_RUN_COMMAND != p_message[1]));
+    if (TRUE == session)
+    {
+        status = optiga_shell_session_acquire();
+        if (OPTIGA_LIB_SUCCESS == status)
+        {
+            status = optiga_shell_rpc_get_instances(p_message[1],
+                                                    &p_message[OPTIGA_SHELL_RPC_REQUEST_HEADER_LENGTH],
+                                                    message_length - OPTIGA_SHELL_RPC_REQUEST_HEADER_LENGTH -
+                                                    OPTIGA_SHELL_RPC_CRC_LENGTH);
+        }
+    }
+    if (OPTIGA_LIB_SUCCESS == status)
+    {
+        status = optiga_shell_rpc_execute(p_message[1],
+                                          &p_message[OPTIGA_SHELL_RPC_REQUEST_HEADER_LENGTH],
+                                          message_length - OPTIGA_SHELL_RPC_REQUEST_HEADER_LENGTH -
+                                          OPTIGA_SHELL_RPC_CRC_LENGTH,
+                                          &optiga_shell_rpc_response[OPTIGA_SHELL_RPC_RESPONSE_HEADER_LENGTH],
+                                          &response_length);
+    }
+    if (TRUE == session)
+    {
+        optiga_shell_rpc_put_instances();
+        optiga_shell_session_release();
+    }
+    optiga_shell_rpc_send(p_message[0], p_message[1], status, response_length);
+}
+
+bool_t optiga_shell_rpc_receive(uint8_t data)
+{
+    if (FALSE == optiga_shell_rpc_in_frame)
+    {
+        if (OPTIGA_SHELL_RPC_FRAME_DELIMITER != data)
+        {
+            return (FALSE);
+        }
+        optiga_shell_rpc_in_frame = TRUE;
+        optiga_shell_rpc_frame_length = 0;
+        optiga_shell_rpc_frame_overflow = FALSE;
+        return (TRUE);
+    }
+
+    if (OPTIGA_SHELL_RPC_FRAME_DELIMITER != data)
+    {
+        if (sizeof(optiga_shell_rpc_frame) > optiga_shell_rpc_frame_length)
+        {
+            optiga_shell_rpc_frame[optiga_shell_rpc_frame_length++] = data;
+        }
+        else
+        {
+            optiga_shell_rpc_frame_overflow = TRUE;
+        }
+        return (TRUE);
+    }
+
+    /*
+     * Consecutive delimiters are idle line, a frame needs at least one byte
+     */
+    if (0U != optiga_shell_rpc_frame_length)
+    {
+        optiga_shell_rpc_process_frame();
+        optiga_shell_rpc_in_frame = FALSE;
+    }
+    return (TRUE);
+}
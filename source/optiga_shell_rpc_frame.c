@@ -0,0 +1,119 @@
+/******************************************************************************
+* File Name:   optiga_shell_rpc_frame.c
+*
+* Description: COBS encoding and CRC-16 of the binary RPC frames of the shell
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include "optiga_shell_rpc_frame.h"
+
+#define OPTIGA_SHELL_RPC_CRC16_POLYNOMIAL   (0x1021U)
+#define OPTIGA_SHELL_RPC_CRC16_INIT         (0xFFFFU)
+#define OPTIGA_SHELL_RPC_COBS_MAX_BLOCK     (0xFFU)
+
+uint16_t optiga_shell_rpc_crc16(const uint8_t * p_data, uint32_t length)
+{
+    uint16_t crc = OPTIGA_SHELL_RPC_CRC16_INIT;
+    uint32_t index;
+    uint8_t bit;
+
+    for (index = 0; index < length; index++)
+    {
+        crc ^= (uint16_t)((uint16_t)p_data[index] << 8);
+        for (bit = 0; bit < 8U; bit++)
+        {
+            crc = (0U != (crc & 0x8000U)) ? (uint16_t)((crc << 1) ^ OPTIGA_SHELL_RPC_CRC16_POLYNOMIAL) :
+                                            (uint16_t)(crc << 1);
+        }
+    }
+    return (crc);
+}
+
+uint32_t optiga_shell_rpc_cobs_encode(const uint8_t * p_input, uint32_t length, uint8_t * p_output)
+{
+    uint32_t code_index = 0;
+    uint32_t output_index = 1;
+    uint32_t index;
+    uint8_t code = 1;
+
+    for (index = 0; index < length; index++)
+    {
+        if (OPTIGA_SHELL_RPC_FRAME_DELIMITER == p_input[index])
+        {
+            p_output[code_index] = code;
+            code_index = output_index++;
+            code = 1;
+            continue;
+        }
+        p_output[output_index++] = p_input[index];
+        code++;
+        if (OPTIGA_SHELL_RPC_COBS_MAX_BLOCK == code)
+        {
+            p_output[code_index] = code;
+            code_index = output_index++;
+            code = 1;
+        }
+    }
+    p_output[code_index] = code;
+    return (output_index);
+}
+
+uint32_t optiga_shell_rpc_cobs_decode(const uint8_t * p_input, uint32_t length, uint8_t * p_output)
+{
+    uint32_t input_index = 0;
+    uint32_t output_index = 0;
+    uint8_t code;
+    uint8_t index;
+
+    while (input_index < length)
+    {
+        code = p_input[input_index++];
+        if ((OPTIGA_SHELL_RPC_FRAME_DELIMITER == code) || ((input_index + code - 1U) > length))
+        {
+            return (0);
+        }
+        for (index = 1; index < code; index++)
+        {
+            p_output[output_index++] = p_input[input_index++];
+        }
+        if ((OPTIGA_SHELL_RPC_COBS_MAX_BLOCK != code) && (input_index < length))
+        {
+            p_output[output_index++] = OPTIGA_SHELL_RPC_FRAME_DELIMITER;
+        }
+    }
+    return (output_index);
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+* File Name:   optiga_shell_rpc_frame.h
+*
+* Description: Framing of the binary RPC of the shell: COBS encoding, CRC and
+*              the operation codes shared with the host client
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_RPC_FRAME_H_
+#define _OPTIGA_SHELL_RPC_FRAME_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Binary RPC framing shared by the shell and the host client. A frame travels as
+ * 0x00 | COBS(message | CRC) | 0x00, the delimiters never occur in the shell text input.
+ *
+ * Request message  : sequence | operation | payload
+ * Response message : sequence | operation | status (2 bytes) | payload
+ *
+ * The response operation has OPTIGA_SHELL_RPC_RESPONSE set. All multi-byte fields, the CRC
+ * included, are big endian.
+ */
+#define OPTIGA_SHELL_RPC_FRAME_DELIMITER        (0x00U)
+#define OPTIGA_SHELL_RPC_CRC_LENGTH             (2U)
+#define OPTIGA_SHELL_RPC_REQUEST_HEADER_LENGTH  (2U)
+#define OPTIGA_SHELL_RPC_RESPONSE_HEADER_LENGTH (4U)
+#define OPTIGA_SHELL_RPC_RESPONSE               (0x80U)
+
+/** @brief Largest request or response payload */
+#define OPTIGA_SHELL_RPC_MAX_PAYLOAD_LENGTH     (1024U)
+
+/** @brief Largest message including header and CRC */
+#define OPTIGA_SHELL_RPC_MAX_MESSAGE_LENGTH     (OPTIGA_SHELL_RPC_RESPONSE_HEADER_LENGTH + \
+                                                 OPTIGA_SHELL_RPC_MAX_PAYLOAD_LENGTH + \
+                                                 OPTIGA_SHELL_RPC_CRC_LENGTH)
+
+/** @brief Worst case COBS encoded length of a message of the given length */
+#define OPTIGA_SHELL_RPC_COBS_LENGTH(length)    ((length) + ((length) / 254U) + 1U)
+
+/** @brief Operations of the binary RPC */
+typedef enum optiga_shell_rpc_operation
+{
+    /** Returns the payload unchanged */
+    OPTIGA_SHELL_RPC_PING = 0x01,
+    /** Runs a shell command, payload is the command name e.g. "init" */
+    OPTIGA_SHELL_RPC_RUN_COMMAND = 0x02,
+    /** length (2) -> random bytes */
+    OPTIGA_SHELL_RPC_GET_RANDOM = 0x10,
+    /** data -> SHA-256 digest */
+    OPTIGA_SHELL_RPC_HASH_SHA256 = 0x11,
+    /** curve (1) | key usage (1) | key OID (2) -> public key */
+    OPTIGA_SHELL_RPC_ECC_GENERATE_KEYPAIR = 0x12,
+    /** key OID (2) | digest -> DER encoded signature */
+    OPTIGA_SHELL_RPC_ECDSA_SIGN = 0x13,
+    /** curve (1) | public key length (2) | public key | digest length (1) | digest | signature */
+    OPTIGA_SHELL_RPC_ECDSA_VERIFY = 0x14,
+    /** OID (2) | offset (2) | length (2) -> data */
+    OPTIGA_SHELL_RPC_READ_DATA = 0x20,
+    /** OID (2) | write type (1) | offset (2) | data */
+    OPTIGA_SHELL_RPC_WRITE_DATA = 0x21,
+    /** OID (2) -> metadata */
+    OPTIGA_SHELL_RPC_READ_METADATA = 0x22,
+} optiga_shell_rpc_operation_t;
+
+/** @brief Status codes of the RPC layer, all other codes are optiga_lib_status_t values */
+#define OPTIGA_SHELL_RPC_ERROR_INVALID_FRAME        (0xF001)
+#define OPTIGA_SHELL_RPC_ERROR_UNKNOWN_OPERATION    (0xF002)
+#define OPTIGA_SHELL_RPC_ERROR_INVALID_PAYLOAD      (0xF003)
+#define OPTIGA_SHELL_RPC_ERROR_UNKNOWN_COMMAND      (0xF004)
+
+/**
+ * @brief CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) of the given data.
+ */
+uint16_t optiga_shell_rpc_crc16(const uint8_t * p_data, uint32_t length);
+
+/**
+ * @brief COBS encodes the input, the output holds up to OPTIGA_SHELL_RPC_COBS_LENGTH(length) bytes.
+ *
+ * @return Length of the encoded data, without delimiters
+ */
+uint32_t optiga_shell_rpc_cobs_encode(const uint8_t * p_input, uint32_t length, uint8_t * p_output);
+
+/**
+ * @brief COBS decodes the input, decoding in place (p_output == p_input) is allowed.
+ *
+ * @return Length of the decoded data, 0 if the input is no valid COBS data
+ */
+uint32_t optiga_shell_rpc_cobs_decode(const uint8_t * p_input, uint32_t length, uint8_t * p_output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_RPC_FRAME_H_ */
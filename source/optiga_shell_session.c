@@ -0,0 +1,418 @@
+/******************************************************************************
+* File Name:   optiga_shell_session.c
+*
+* Description: Application on OPTIGA kept open across commands. It is opened on first
+*              use, hibernated after the configured idle time and restored on the next
+*              use, so the latency of a command excludes the open and close.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+
+#include "optiga/optiga_util.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_profile.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_session.h"
+#include "optiga_shell_store.h"
+
+static optiga_shell_request_t optiga_shell_session_request;
+static uint8_t optiga_shell_session_state = OPTIGA_SHELL_SESSION_CLOSED;
+static uint32_t optiga_shell_session_idle_ms = OPTIGA_SHELL_SESSION_IDLE_MS;
+static uint32_t optiga_shell_session_last_use_ms = 0;
+static optiga_shell_session_stats_t optiga_shell_session_stats;
+/// Value of the resume record in the shell store, written only when it changes
+static bool_t optiga_shell_session_saved = FALSE;
+static bool_t optiga_shell_session_resumed = FALSE;
+
+/**
+ * Records whether the next boot tries to restore a hibernated context of this host. The record
+ * is only written when it changes, not on every hibernate and restore, see
+ * #optiga_shell_session_open.
+ */
+static void optiga_shell_session_set_saved(bool_t saved)
+{
+    uint8_t record[OPTIGA_SHELL_SESSION_RECORD_LENGTH];
+
+    if (saved != optiga_shell_session_saved)
+    {
+        record[0] = OPTIGA_SHELL_SESSION_RECORD_VERSION;
+        record[1] = saved;
+        /*
+         * Without the record the next boot opens the application from scratch, which is not an
+         * error. The cache is kept on a failure, so the next change tries the write again.
+         */
+        if (PAL_STATUS_SUCCESS == optiga_shell_store_write(OPTIGA_SHELL_SESSION_RECORD_ID, record, sizeof(record)))
+        {
+            optiga_shell_session_saved = saved;
+        }
+    }
+}
+
+/**
+ * Runs open or close application on a util instance of the pool, which is returned right after
+ * so the session holds no command registration while the application is open
+ */
+static optiga_lib_status_t optiga_shell_session_run(bool_t open_application, bool_t perform_context_op)
+{
+    optiga_util_t * me;
+    optiga_lib_status_t return_status;
+
+    me = optiga_shell_pool_get_util(&optiga_shell_session_request);
+    if (NULL == me)
+    {
+        return (OPTIGA_UTIL_ERROR_MEMORY_INSUFFICIENT);
+    }
+    if (TRUE == open_application)
+    {
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_session_request,
+                                                 optiga_util_open_application(me, perform_context_op));
+    }
+    else
+    {
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_session_request,
+                                                 optiga_util_close_application(me, perform_context_op));
+    }
+    (void)optiga_shell_pool_put_util(me);
+    return (return_status);
+}
+
+static optiga_lib_status_t optiga_shell_session_open(bool_t perform_restore)
+{
+    optiga_lib_status_t return_status;
+
+    return_status = optiga_shell_session_run(TRUE, perform_restore);
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        optiga_shell_session_state = OPTIGA_SHELL_SESSION_OPEN;
+        /*
+         * Opening the application also sets the I2C clock of the host library
+         */
+        optiga_shell_profile_restore_i2c();
+    }
+    if ((OPTIGA_LIB_SUCCESS != return_status) && (TRUE == perform_restore))
+    {
+        /*
+         * The saved context is not there anymore. After a successful restore the record stays
+         * set, as the idle hibernate follows: a reset while open costs one failed restore on the
+         * next boot instead of two record writes per idle cycle.
+         */
+        optiga_shell_session_set_saved(FALSE);
+    }
+    return (return_status);
+}
+
+static optiga_lib_status_t optiga_shell_session_close_application(bool_t perform_hibernate)
+{
+    optiga_lib_status_t return_status;
+
+    return_status = optiga_shell_session_run(FALSE, perform_hibernate);
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        optiga_shell_session_state = (TRUE == perform_hibernate) ? OPTIGA_SHELL_SESSION_HIBERNATED :
+                                                                   OPTIGA_SHELL_SESSION_CLOSED;
+        optiga_shell_session_set_saved(perform_hibernate);
+    }
+    return (return_status);
+}
+
+optiga_lib_status_t optiga_shell_session_acquire(void)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+
+    if (OPTIGA_SHELL_SESSION_HIBERNATED == optiga_shell_session_state)
+    {
+        return_status = optiga_shell_session_open(TRUE);
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            optiga_shell_session_stats.restores++;
+            optiga_shell_session_stats.restore_us = optiga_shell_request_get_latency_us(&optiga_shell_session_request);
+        }
+        else
+        {
+            /*
+             * The saved context is gone (e.g. the chip was reset), start over with a fresh one
+             */
+            optiga_shell_session_state = OPTIGA_SHELL_SESSION_CLOSED;
+        }
+    }
+    if (OPTIGA_SHELL_SESSION_CLOSED == optiga_shell_session_state)
+    {
+        return_status = optiga_shell_session_open(FALSE);
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            optiga_shell_session_stats.opens++;
+            optiga_shell_session_stats.open_us = optiga_shell_request_get_latency_us(&optiga_shell_session_request);
+        }
+    }
+    optiga_shell_session_last_use_ms = pal_os_timer_get_time_in_milliseconds();
+    return (return_status);
+}
+
+void optiga_shell_session_release(void)
+{
+    optiga_shell_session_last_use_ms = pal_os_timer_get_time_in_milliseconds();
+}
+
+optiga_lib_status_t optiga_shell_session_close(void)
+{
+    optiga_lib_status_t return_status;
+
+    if (OPTIGA_SHELL_SESSION_OPEN != optiga_shell_session_state)
+    {
+        /*
+         * A hibernated context is dropped by the next open without restore
+         */
+        optiga_shell_session_state = OPTIGA_SHELL_SESSION_CLOSED;
+        optiga_shell_session_set_saved(FALSE);
+        return (OPTIGA_LIB_SUCCESS);
+    }
+    return_status = optiga_shell_session_close_application(FALSE);
+    if (OPTIGA_LIB_SUCCESS == return_status)
+    {
+        optiga_shell_session_stats.closes++;
+    }
+    return (return_status);
+}
+
+void optiga_shell_session_forget(void)
+{
+    optiga_shell_session_state = OPTIGA_SHELL_SESSION_CLOSED;
+    optiga_shell_session_set_saved(FALSE);
+}
+
+/**
+ * Hibernates the open application, or closes it if OPTIGA refuses the hibernate
+ */
+static void optiga_shell_session_hibernate(void)
+{
+    if (OPTIGA_LIB_SUCCESS == optiga_shell_session_close_application(TRUE))
+    {
+        optiga_shell_session_stats.hibernates++;
+    }
+    else if (OPTIGA_LIB_SUCCESS == optiga_shell_session_close_application(FALSE))
+    {
+        optiga_shell_session_stats.closes++;
+    }
+    else
+    {
+        /*
+         * The application is not open anymore, the next use opens it again
+         */
+        optiga_shell_session_state = OPTIGA_SHELL_SESSION_CLOSED;
+    }
+}
+
+uint32_t optiga_shell_session_poll(void)
+{
+    uint32_t idle_ms;
+
+    if ((OPTIGA_SHELL_SESSION_OPEN != optiga_shell_session_state) || (0U == optiga_shell_session_idle_ms))
+    {
+        return (OPTIGA_SHELL_SESSION_NO_DEADLINE);
+    }
+    idle_ms = pal_os_timer_get_time_in_milliseconds() - optiga_shell_session_last_use_ms;
+    if (idle_ms < optiga_shell_session_idle_ms)
+    {
+        return (optiga_shell_session_idle_ms - idle_ms);
+    }
+    optiga_shell_session_hibernate();
+    return (OPTIGA_SHELL_SESSION_NO_DEADLINE);
+}
+
+optiga_lib_status_t optiga_shell_session_resume(void)
+{
+    uint8_t record[OPTIGA_SHELL_SESSION_RECORD_LENGTH];
+    uint16_t record_length = sizeof(record);
+    uint32_t restores = optiga_shell_session_stats.restores;
+    optiga_lib_status_t return_status;
+
+    if ((PAL_STATUS_SUCCESS != optiga_shell_store_read(OPTIGA_SHELL_SESSION_RECORD_ID, record, &record_length)) ||
+        (sizeof(record) != record_length) || (OPTIGA_SHELL_SESSION_RECORD_VERSION != record[0]) ||
+        (TRUE != record[1]))
+    {
+        return (OPTIGA_LIB_SUCCESS);
+    }
+    optiga_shell_session_saved = TRUE;
+    optiga_shell_session_state = OPTIGA_SHELL_SESSION_HIBERNATED;
+    return_status = optiga_shell_session_acquire();
+    optiga_shell_session_resumed = (restores != optiga_shell_session_stats.restores) ? TRUE : FALSE;
+    return (return_status);
+}
+
+void optiga_shell_session_suspend(void)
+{
+    if (OPTIGA_SHELL_SESSION_OPEN == optiga_shell_session_state)
+    {
+        optiga_shell_session_hibernate();
+    }
+}
+
+bool_t optiga_shell_session_is_resumed(void)
+{
+    return (optiga_shell_session_resumed);
+}
+
+void optiga_shell_session_set_idle_ms(uint32_t idle_ms)
+{
+    optiga_shell_session_idle_ms = idle_ms;
+}
+
+uint32_t optiga_shell_session_get_idle_ms(void)
+{
+    return (optiga_shell_session_idle_ms);
+}
+
+uint8_t optiga_shell_session_get_state(void)
+{
+    return (optiga_shell_session_state);
+}
+
+void optiga_shell_session_get_stats(optiga_shell_session_stats_t * p_stats)
+{
+    *p_stats = optiga_shell_session_stats;
+}
+
+void optiga_shell_cmd_session(optiga_shell_args_t * p_args)
+{
+    static const char_t * const state_names[] = {"closed", "open", "hibernated"};
+    optiga_shell_session_stats_t stats;
+    uint32_t idle_ms;
+    char_t line[120];
+
+    if ((FALSE == optiga_shell_args_get_number(p_args, "idle", optiga_shell_session_idle_ms, 0,
+                                               OPTIGA_SHELL_SESSION_MAX_IDLE_MS, &idle_ms)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+    optiga_shell_session_idle_ms = idle_ms;
+    optiga_shell_session_get_stats(&stats);
+
+    snprintf(line, sizeof(line), "Application: %s, hibernate after %lu ms idle%s",
+             state_names[optiga_shell_session_state], (unsigned long)optiga_shell_session_idle_ms,
+             (0U == optiga_shell_session_idle_ms) ? " (never)" : "");
+    optiga_lib_print_string_with_newline(line);
+    snprintf(line, sizeof(line), "opens,restores,hibernates,closes,open_us,restore_us,store_writes");
+    optiga_lib_print_string_with_newline(line);
+    snprintf(line, sizeof(line), "%lu,%lu,%lu,%lu,%lu,%lu,%lu",
+             (unsigned long)stats.opens, (unsigned long)stats.restores, (unsigned long)stats.hibernates,
+             (unsigned long)stats.closes, (unsigned long)stats.open_us, (unsigned long)stats.restore_us,
+             (unsigned long)optiga_shell_store_get_writes());
+    optiga_lib_print_string_with_newline(line);
+}
+
+void optiga_shell_cmd_boot_bench(optiga_shell_args_t * p_args)
+{
+    static const char_t * const path_names[] = {"cold_open", "restore"};
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    uint32_t min_us[2] = {0xFFFFFFFFU, 0xFFFFFFFFU};
+    uint32_t max_us[2] = {0, 0};
+    uint64_t sum_us[2] = {0, 0};
+    uint32_t latency_us;
+    uint32_t iterations;
+    uint32_t done = 0;
+    uint8_t path;
+    char_t line[100];
+
+    if ((FALSE == optiga_shell_args_get_number(p_args, "iterations", OPTIGA_SHELL_SESSION_BOOT_BENCH_ITERATIONS, 1,
+                                               OPTIGA_SHELL_SESSION_BOOT_BENCH_MAX_ITERATIONS, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+
+    /*
+     * Each iteration boots once from scratch and once from a hibernated context, the open
+     * or restore is timed from the request to the completion
+     */
+    return_status = optiga_shell_session_close();
+    while ((OPTIGA_LIB_SUCCESS == return_status) && (done < iterations))
+    {
+        for (path = 0; path < 2U; path++)
+        {
+            return_status = optiga_shell_session_open((0U == path) ? FALSE : TRUE);
+            if (OPTIGA_LIB_SUCCESS != return_status)
+            {
+                break;
+            }
+            latency_us = optiga_shell_request_get_latency_us(&optiga_shell_session_request);
+            min_us[path] = (latency_us < min_us[path]) ? latency_us : min_us[path];
+            max_us[path] = (latency_us > max_us[path]) ? latency_us : max_us[path];
+            sum_us[path] += latency_us;
+
+            /*
+             * Hibernate before the restore, close before the next cold open
+             */
+            return_status = optiga_shell_session_close_application((0U == path) ? TRUE : FALSE);
+            if (OPTIGA_LIB_SUCCESS != return_status)
+            {
+                break;
+            }
+        }
+        if (OPTIGA_LIB_SUCCESS == return_status)
+        {
+            done++;
+        }
+    }
+
+    optiga_lib_print_string_with_newline("boot,iterations,min_us,avg_us,max_us,status");
+    for (path = 0; path < 2U; path++)
+    {
+        snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu,0x%04X", path_names[path], (unsigned long)done,
+                 (unsigned long)((0U == done) ? 0U : min_us[path]),
+                 (unsigned long)((0U == done) ? 0U : (uint32_t)(sum_us[path] / done)),
+                 (unsigned long)max_us[path], (unsigned int)return_status);
+        optiga_lib_print_string_with_newline(line);
+    }
+    if ((0U != done) && (0U != sum_us[1]))
+    {
+        snprintf(line, sizeof(line), "Restore saves %lu usec per boot: %lu.%02lux faster than a cold open",
+                 (unsigned long)((sum_us[0] > sum_us[1]) ? (uint32_t)((sum_us[0] - sum_us[1]) / done) : 0U),
+                 (unsigned long)(sum_us[0] / sum_us[1]), (unsigned long)(((sum_us[0] * 100U) / sum_us[1]) % 100U));
+        optiga_lib_print_string_with_newline(line);
+        optiga_lib_print_string_with_newline("A cold boot also pairs or checks the pairing record, a restore does not");
+    }
+
+    /*
+     * Leave the application open for the next command, as the other commands do
+     */
+    (void)optiga_shell_session_acquire();
+    optiga_shell_session_release();
+}
@@ -0,0 +1,212 @@
+/******************************************************************************
+* File Name:   optiga_shell_session.h
+*
+* Description: Application on OPTIGA kept open across commands and hibernated when idle
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_SESSION_H_
+#define _OPTIGA_SHELL_SESSION_H_
+
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga/common/optiga_lib_return_codes.h"
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Idle time after which the open application is hibernated, 0 never hibernates */
+#ifndef OPTIGA_SHELL_SESSION_IDLE_MS
+#define OPTIGA_SHELL_SESSION_IDLE_MS        (5000U)
+#endif
+
+/** @brief Restore the application hibernated before a reset on boot, 0 always opens from scratch */
+#ifndef OPTIGA_SHELL_SESSION_RESUME_ON_BOOT
+#define OPTIGA_SHELL_SESSION_RESUME_ON_BOOT (1U)
+#endif
+
+/**
+ * @brief Id of the record in the shell store telling whether OPTIGA holds a hibernated context,
+ * see optiga_shell_store.h. It is set by the first hibernate and cleared by a close or a failed
+ * restore, so the idle hibernates in between do not write it.
+ */
+#ifndef OPTIGA_SHELL_SESSION_RECORD_ID
+#define OPTIGA_SHELL_SESSION_RECORD_ID      (0x21U)
+#endif
+#define OPTIGA_SHELL_SESSION_RECORD_VERSION (1U)
+#define OPTIGA_SHELL_SESSION_RECORD_LENGTH  (2U)
+
+/** @brief Default and largest number of iterations of the boot benchmark */
+#define OPTIGA_SHELL_SESSION_BOOT_BENCH_ITERATIONS      (10U)
+#define OPTIGA_SHELL_SESSION_BOOT_BENCH_MAX_ITERATIONS  (100U)
+
+/** @brief Argument usage of the boot benchmark command, as shown by help */
+#define OPTIGA_SHELL_SESSION_BOOT_BENCH_USAGE   "[--iterations <n>]"
+
+/** @brief Largest idle time accepted by the session command, in milliseconds */
+#define OPTIGA_SHELL_SESSION_MAX_IDLE_MS    (3600000U)
+
+/** @brief Argument usage of the session command, as shown by help */
+#define OPTIGA_SHELL_SESSION_USAGE          "[--idle <msec>]"
+
+/** @brief Returned by #optiga_shell_session_poll if no hibernate is pending */
+#define OPTIGA_SHELL_SESSION_NO_DEADLINE    (0xFFFFFFFFU)
+
+/** @brief State of the application on OPTIGA */
+#define OPTIGA_SHELL_SESSION_CLOSED         (0U)
+#define OPTIGA_SHELL_SESSION_OPEN           (1U)
+#define OPTIGA_SHELL_SESSION_HIBERNATED     (2U)
+
+/** @brief Application life cycle counters since start */
+typedef struct optiga_shell_session_stats
+{
+    uint32_t opens;
+    uint32_t restores;
+    uint32_t hibernates;
+    uint32_t closes;
+    /// Time of the last open and restore, in microseconds
+    uint32_t open_us;
+    uint32_t restore_us;
+} optiga_shell_session_stats_t;
+
+/**
+ * @brief Makes sure the application on OPTIGA is open before an operation.
+ *
+ * Opens the application on first use and restores it after a hibernate, nothing is sent if it
+ * is open already. The application stays open across commands until it is idle for the
+ * configured time, see #optiga_shell_session_poll, or closed with #optiga_shell_session_close.
+ *
+ * @retval #OPTIGA_LIB_SUCCESS  The application is open
+ * @retval Error of optiga_util_open_application() or the pool of util instances otherwise
+ */
+optiga_lib_status_t optiga_shell_session_acquire(void);
+
+/**
+ * @brief Ends a use of the application, the idle time starts from here.
+ */
+void optiga_shell_session_release(void);
+
+/**
+ * @brief Closes the application without saving its context.
+ */
+optiga_lib_status_t optiga_shell_session_close(void);
+
+/**
+ * @brief Records that the application was closed by someone else, e.g. an example which
+ * opens and closes it on its own. The next #optiga_shell_session_acquire opens it again.
+ */
+void optiga_shell_session_forget(void);
+
+/**
+ * @brief Hibernates the application (close with context save) once it was idle long enough.
+ *
+ * Falls back to a plain close if OPTIGA refuses the hibernate, e.g. while the security event
+ * counter is not zero. To be called while the shell waits for input.
+ *
+ * @return Milliseconds until the next hibernate is due, #OPTIGA_SHELL_SESSION_NO_DEADLINE if none
+ */
+uint32_t optiga_shell_session_poll(void);
+
+/**
+ * @brief Boot path restoring the application which was hibernated before the reset.
+ *
+ * If the record in the shell store tells that OPTIGA holds a hibernated context, the application
+ * is restored with it, including the session of the shielded connection, so no fresh open and
+ * no pairing are needed. If the restore fails, the application is opened from scratch. Nothing
+ * is sent if no context was saved, the first command opens the application then.
+ *
+ * @retval #OPTIGA_LIB_SUCCESS  The application is restored, open or left for the first command
+ * @retval Error of #optiga_shell_session_acquire otherwise
+ */
+optiga_lib_status_t optiga_shell_session_resume(void);
+
+/**
+ * @brief Hibernates the open application right away, e.g. before the host powers down.
+ */
+void optiga_shell_session_suspend(void);
+
+/**
+ * @brief Tells whether #optiga_shell_session_resume restored the context of the previous boot.
+ */
+bool_t optiga_shell_session_is_resumed(void);
+
+/**
+ * @brief Sets the idle time before hibernate in milliseconds, 0 never hibernates.
+ */
+void optiga_shell_session_set_idle_ms(uint32_t idle_ms);
+
+/**
+ * @brief Returns the idle time before hibernate in milliseconds.
+ */
+uint32_t optiga_shell_session_get_idle_ms(void);
+
+/**
+ * @brief Returns the state of the application, see #OPTIGA_SHELL_SESSION_OPEN.
+ */
+uint8_t optiga_shell_session_get_state(void);
+
+/**
+ * @brief Copies the life cycle counters.
+ */
+void optiga_shell_session_get_stats(optiga_shell_session_stats_t * p_stats);
+
+/**
+ * @brief Prints the state of the application and its life cycle counters.
+ *
+ * --idle sets the idle time before hibernate, 0 keeps the application open until deinit.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_session(optiga_shell_args_t * p_args);
+
+/**
+ * @brief Compares the boot from scratch (open application) with the boot from a hibernated
+ * context (hibernate, then open application with restore), --iterations times each.
+ *
+ * Prints the min, average and max time of each as CSV and the time the restore saves. Stops at
+ * the first error, e.g. OPTIGA refuses the hibernate while the security event counter is not 0.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_boot_bench(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_SESSION_H_ */
@@ -0,0 +1,233 @@
+/******************************************************************************
+* File Name:   optiga_shell_store.c
+*
+* Description: Records of the shell which must survive a reset, kept in a flash row
+*              of the MCU or in the datastore of the host build.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+
+#include "optiga/pal/pal_os_datastore.h"
+#include "optiga_shell_store.h"
+
+#ifndef OPTIGA_HOST_SIMULATOR
+#include "cyhal.h"
+#endif
+
+static uint32_t optiga_shell_store_writes = 0;
+
+#ifdef OPTIGA_HOST_SIMULATOR
+/*
+ * The host PAL keeps every datastore id in a file, the records are forwarded to it
+ */
+static pal_status_t optiga_shell_store_port_read(uint16_t record_id, uint8_t * p_buffer, uint16_t * p_length)
+{
+    return (pal_os_datastore_read(record_id, p_buffer, p_length));
+}
+
+static pal_status_t optiga_shell_store_port_write(uint16_t record_id, const uint8_t * p_buffer, uint16_t length)
+{
+    return (pal_os_datastore_write(record_id, p_buffer, length));
+}
+#else
+#define OPTIGA_SHELL_STORE_MAGIC            (0x53545231U)
+
+/** @brief Record in the flash row, a zero id marks a free record */
+typedef struct optiga_shell_store_record
+{
+    uint16_t id;
+    uint16_t length;
+    uint8_t data[OPTIGA_SHELL_STORE_RECORD_SIZE];
+} optiga_shell_store_record_t;
+
+/** @brief Layout of the flash row, programmed as a whole */
+typedef union optiga_shell_store_image
+{
+    struct
+    {
+        uint32_t magic;
+        optiga_shell_store_record_t records[OPTIGA_SHELL_STORE_RECORDS];
+    } content;
+    uint32_t words[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)];
+} optiga_shell_store_image_t;
+
+/*
+ * One row of the emulated EEPROM region, which the linker script keeps out of the application
+ * and which programming the application leaves as is
+ */
+CY_SECTION(".cy_em_eeprom") CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+static const uint8_t optiga_shell_store_row[CY_FLASH_SIZEOF_ROW] = {0};
+
+static cyhal_flash_t optiga_shell_store_flash;
+static optiga_shell_store_image_t optiga_shell_store_image;
+static bool_t optiga_shell_store_flash_ready = FALSE;
+static bool_t optiga_shell_store_loaded = FALSE;
+
+/**
+ * Copies the row to RAM on first use. The row is read through the HAL and not through the
+ * const array, whose zero content the compiler may assume.
+ */
+static pal_status_t optiga_shell_store_load(void)
+{
+    if (TRUE == optiga_shell_store_loaded)
+    {
+        return (PAL_STATUS_SUCCESS);
+    }
+    if ((FALSE == optiga_shell_store_flash_ready) &&
+        (CY_RSLT_SUCCESS != cyhal_flash_init(&optiga_shell_store_flash)))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    optiga_shell_store_flash_ready = TRUE;
+    if (CY_RSLT_SUCCESS != cyhal_flash_read(&optiga_shell_store_flash, (uint32_t)optiga_shell_store_row,
+                                            (uint8_t *)&optiga_shell_store_image, sizeof(optiga_shell_store_image)))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    if (OPTIGA_SHELL_STORE_MAGIC != optiga_shell_store_image.content.magic)
+    {
+        memset(&optiga_shell_store_image, 0, sizeof(optiga_shell_store_image));
+        optiga_shell_store_image.content.magic = OPTIGA_SHELL_STORE_MAGIC;
+    }
+    optiga_shell_store_loaded = TRUE;
+    return (PAL_STATUS_SUCCESS);
+}
+
+static optiga_shell_store_record_t * optiga_shell_store_find(uint16_t record_id)
+{
+    uint8_t index;
+
+    for (index = 0; index < OPTIGA_SHELL_STORE_RECORDS; index++)
+    {
+        if (record_id == optiga_shell_store_image.content.records[index].id)
+        {
+            return (&optiga_shell_store_image.content.records[index]);
+        }
+    }
+    return (NULL);
+}
+
+static pal_status_t optiga_shell_store_port_read(uint16_t record_id, uint8_t * p_buffer, uint16_t * p_length)
+{
+    optiga_shell_store_record_t * p_record;
+
+    if (PAL_STATUS_SUCCESS != optiga_shell_store_load())
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    p_record = optiga_shell_store_find(record_id);
+    if ((NULL == p_record) || (p_record->length > *p_length))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    memcpy(p_buffer, p_record->data, p_record->length);
+    *p_length = p_record->length;
+    return (PAL_STATUS_SUCCESS);
+}
+
+static pal_status_t optiga_shell_store_port_write(uint16_t record_id, const uint8_t * p_buffer, uint16_t length)
+{
+    optiga_shell_store_record_t * p_record;
+
+    if ((PAL_STATUS_SUCCESS != optiga_shell_store_load()) || (length > OPTIGA_SHELL_STORE_RECORD_SIZE))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    p_record = optiga_shell_store_find(record_id);
+    if (NULL == p_record)
+    {
+        p_record = optiga_shell_store_find(0);
+        if (NULL == p_record)
+        {
+            return (PAL_STATUS_FAILURE);
+        }
+    }
+    p_record->id = record_id;
+    p_record->length = length;
+    memset(p_record->data, 0, sizeof(p_record->data));
+    memcpy(p_record->data, p_buffer, length);
+
+    if (CY_RSLT_SUCCESS != cyhal_flash_write(&optiga_shell_store_flash, (uint32_t)optiga_shell_store_row,
+                                             optiga_shell_store_image.words))
+    {
+        /*
+         * The row content is unknown now, it is read again on the next access
+         */
+        optiga_shell_store_loaded = FALSE;
+        return (PAL_STATUS_FAILURE);
+    }
+    return (PAL_STATUS_SUCCESS);
+}
+#endif
+
+pal_status_t optiga_shell_store_read(uint16_t record_id, uint8_t * p_buffer, uint16_t * p_length)
+{
+    if ((0U == record_id) || (NULL == p_buffer) || (NULL == p_length))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    return (optiga_shell_store_port_read(record_id, p_buffer, p_length));
+}
+
+pal_status_t optiga_shell_store_write(uint16_t record_id, const uint8_t * p_buffer, uint16_t length)
+{
+    uint8_t current[OPTIGA_SHELL_STORE_RECORD_SIZE];
+    uint16_t current_length = sizeof(current);
+    pal_status_t return_status;
+
+    if ((0U == record_id) || (NULL == p_buffer) || (0U == length) || (OPTIGA_SHELL_STORE_RECORD_SIZE < length))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    if ((PAL_STATUS_SUCCESS == optiga_shell_store_port_read(record_id, current, &current_length)) &&
+        (length == current_length) && (0 == memcmp(current, p_buffer, length)))
+    {
+        return (PAL_STATUS_SUCCESS);
+    }
+    return_status = optiga_shell_store_port_write(record_id, p_buffer, length);
+    if (PAL_STATUS_SUCCESS == return_status)
+    {
+        optiga_shell_store_writes++;
+    }
+    return (return_status);
+}
+
+uint32_t optiga_shell_store_get_writes(void)
+{
+    return (optiga_shell_store_writes);
+}
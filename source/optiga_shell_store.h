@@ -0,0 +1,100 @@
+/******************************************************************************
+* File Name:   optiga_shell_store.h
+*
+* Description: Records of the shell which must survive a reset
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_STORE_H_
+#define _OPTIGA_SHELL_STORE_H_
+
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga/pal/pal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Number of records and largest record of the store on the MCU */
+#ifndef OPTIGA_SHELL_STORE_RECORDS
+#define OPTIGA_SHELL_STORE_RECORDS          (4U)
+#endif
+#ifndef OPTIGA_SHELL_STORE_RECORD_SIZE
+#define OPTIGA_SHELL_STORE_RECORD_SIZE      (64U)
+#endif
+
+/**
+ * @brief Reads a record of the shell which must survive a reset, e.g. the pairing record.
+ *
+ * On the MCU, the records are kept in one row of the emulated EEPROM flash region, as the PAL
+ * datastore of the platform keeps only the ids of the host library and those only in RAM. The
+ * host build keeps them in the file backed pal_os_datastore.
+ *
+ * @param[in]     record_id  Id of the record, a pal_os_datastore id
+ * @param[out]    p_buffer   Data of the record
+ * @param[in,out] p_length   Size of the buffer, then length of the record
+ *
+ * @retval #PAL_STATUS_SUCCESS  The record is read
+ * @retval #PAL_STATUS_FAILURE  There is no such record or it does not fit the buffer
+ */
+pal_status_t optiga_shell_store_read(uint16_t record_id, uint8_t * p_buffer, uint16_t * p_length);
+
+/**
+ * @brief Writes a record of the shell, nothing is written if the record holds the same data.
+ *
+ * The flash row is erased and programmed on each write, so callers write when the value
+ * changes, not on every use.
+ *
+ * @param[in] record_id  Id of the record
+ * @param[in] p_buffer   Data of the record
+ * @param[in] length     Length of the data, 1 to #OPTIGA_SHELL_STORE_RECORD_SIZE
+ *
+ * @retval #PAL_STATUS_SUCCESS  The record holds the data
+ * @retval #PAL_STATUS_FAILURE  The store is full, the length is invalid or the flash write failed
+ */
+pal_status_t optiga_shell_store_write(uint16_t record_id, const uint8_t * p_buffer, uint16_t length);
+
+/**
+ * @brief Number of writes to the flash or the datastore since the start of the shell.
+ */
+uint32_t optiga_shell_store_get_writes(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_STORE_H_ */
@@ -0,0 +1,394 @@
+/******************************************************************************
+* File Name:   optiga_shell_uart.c
+*
+* Description: Receive ring of the shell console filled from the debug UART
+*              interrupt, or from a reader thread of stdin in the host build
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+#include "optiga_shell_uart.h"
+
+#ifdef OPTIGA_HOST_SIMULATOR
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#include "cyhal.h"
+#include "cy_retarget_io.h"
+#endif
+
+#define OPTIGA_SHELL_UART_RX_BUFFER_MASK    (OPTIGA_SHELL_UART_RX_BUFFER_SIZE - 1U)
+
+#if (0U != (OPTIGA_SHELL_UART_RX_BUFFER_SIZE & OPTIGA_SHELL_UART_RX_BUFFER_MASK))
+#error "OPTIGA_SHELL_UART_RX_BUFFER_SIZE must be a power of two"
+#endif
+
+/**
+ * Receive ring. The head is only written by the producer (UART interrupt) and the tail only
+ * by the consumer (shell), both run freely and are masked on access.
+ */
+static uint8_t optiga_shell_uart_rx_buffer[OPTIGA_SHELL_UART_RX_BUFFER_SIZE];
+static uint32_t optiga_shell_uart_rx_head = 0;
+static uint32_t optiga_shell_uart_rx_tail = 0;
+static uint32_t optiga_shell_uart_overflow_count = 0;
+static bool_t optiga_shell_uart_started = FALSE;
+
+static bool_t optiga_shell_uart_is_empty(void)
+{
+    return (__atomic_load_n(&optiga_shell_uart_rx_head, __ATOMIC_ACQUIRE) ==
+            __atomic_load_n(&optiga_shell_uart_rx_tail, __ATOMIC_ACQUIRE));
+}
+
+static bool_t optiga_shell_uart_is_full(void)
+{
+    return ((optiga_shell_uart_rx_head - __atomic_load_n(&optiga_shell_uart_rx_tail, __ATOMIC_ACQUIRE)) >=
+            OPTIGA_SHELL_UART_RX_BUFFER_SIZE);
+}
+
+/**
+ * Producer side, called from the UART interrupt only
+ */
+static void optiga_shell_uart_push(uint8_t data)
+{
+    uint32_t head = optiga_shell_uart_rx_head;
+
+    if (TRUE == optiga_shell_uart_is_full())
+    {
+        optiga_shell_uart_overflow_count++;
+        return;
+    }
+    optiga_shell_uart_rx_buffer[head & OPTIGA_SHELL_UART_RX_BUFFER_MASK] = data;
+    __atomic_store_n(&optiga_shell_uart_rx_head, head + 1U, __ATOMIC_RELEASE);
+}
+
+#ifdef OPTIGA_HOST_SIMULATOR
+/**
+ * The host build has no UART: a reader thread plays the interrupt and feeds stdin into the
+ * ring. A pipe can wait, so the reader blocks on a full ring instead of dropping bytes.
+ */
+static pthread_mutex_t optiga_shell_uart_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t optiga_shell_uart_condition = PTHREAD_COND_INITIALIZER;
+static bool_t optiga_shell_uart_closed = FALSE;
+
+static void * optiga_shell_uart_reader(void * context)
+{
+    uint8_t chunk[64];
+    ssize_t received;
+    ssize_t index;
+
+    (void)context;
+    while (0 != (received = read(STDIN_FILENO, chunk, sizeof(chunk))))
+    {
+        if (0 > received)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            break;
+        }
+        pthread_mutex_lock(&optiga_shell_uart_lock);
+        for (index = 0; index < received; index++)
+        {
+            while (TRUE == optiga_shell_uart_is_full())
+            {
+                pthread_cond_wait(&optiga_shell_uart_condition, &optiga_shell_uart_lock);
+            }
+            optiga_shell_uart_push(chunk[index]);
+            pthread_cond_broadcast(&optiga_shell_uart_condition);
+        }
+        pthread_mutex_unlock(&optiga_shell_uart_lock);
+    }
+    pthread_mutex_lock(&optiga_shell_uart_lock);
+    optiga_shell_uart_closed = TRUE;
+    pthread_cond_broadcast(&optiga_shell_uart_condition);
+    pthread_mutex_unlock(&optiga_shell_uart_lock);
+    return (NULL);
+}
+
+static pal_status_t optiga_shell_uart_port_start(void)
+{
+    pthread_t reader;
+
+    if (0 != pthread_create(&reader, NULL, optiga_shell_uart_reader, NULL))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    pthread_detach(reader);
+    return (PAL_STATUS_SUCCESS);
+}
+
+static void optiga_shell_uart_port_released(void)
+{
+    pthread_mutex_lock(&optiga_shell_uart_lock);
+    pthread_cond_broadcast(&optiga_shell_uart_condition);
+    pthread_mutex_unlock(&optiga_shell_uart_lock);
+}
+
+static void optiga_shell_uart_port_wait(uint32_t timeout_ms)
+{
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(timeout_ms / 1000U);
+    deadline.tv_nsec += (long)((timeout_ms % 1000U) * 1000000U);
+    if (1000000000L <= deadline.tv_nsec)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&optiga_shell_uart_lock);
+    while ((TRUE == optiga_shell_uart_is_empty()) && (FALSE == optiga_shell_uart_closed))
+    {
+        if (OPTIGA_SHELL_UART_WAIT_FOREVER == timeout_ms)
+        {
+            pthread_cond_wait(&optiga_shell_uart_condition, &optiga_shell_uart_lock);
+        }
+        else if (ETIMEDOUT == pthread_cond_timedwait(&optiga_shell_uart_condition, &optiga_shell_uart_lock, &deadline))
+        {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&optiga_shell_uart_lock);
+}
+
+static pal_status_t optiga_shell_uart_port_write(const uint8_t * p_data, uint32_t length)
+{
+    /*
+     * stdout is shared with the logs, writing through it keeps the order
+     */
+    if (length != fwrite(p_data, 1U, length, stdout))
+    {
+        return (PAL_STATUS_FAILURE);
+    }
+    return ((0 == fflush(stdout)) ? PAL_STATUS_SUCCESS : PAL_STATUS_FAILURE);
+}
+
+static bool_t optiga_shell_uart_port_is_closed(void)
+{
+    bool_t closed;
+
+    pthread_mutex_lock(&optiga_shell_uart_lock);
+    closed = optiga_shell_uart_closed;
+    pthread_mutex_unlock(&optiga_shell_uart_lock);
+    return (closed);
+}
+#else
+/**
+ * Drains the hardware FIFO of the debug UART into the ring
+ */
+static void optiga_shell_uart_event(void * callback_arg, cyhal_uart_event_t event)
+{
+    uint8_t data;
+
+    (void)callback_arg;
+    if (0U == ((uint32_t)event & (uint32_t)CYHAL_UART_IRQ_RX_NOT_EMPTY))
+    {
+        return;
+    }
+    while (0U < cyhal_uart_readable(&cy_retarget_io_uart_obj))
+    {
+        if (CY_RSLT_SUCCESS != cyhal_uart_getc(&cy_retarget_io_uart_obj, &data, 0))
+        {
+            break;
+        }
+        optiga_shell_uart_push(data);
+    }
+}
+
+static pal_status_t optiga_shell_uart_port_start(void)
+{
+    cyhal_uart_clear(&cy_retarget_io_uart_obj);
+    cyhal_uart_register_callback(&cy_retarget_io_uart_obj, optiga_shell_uart_event, NULL);
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj,
+                            CYHAL_UART_IRQ_RX_NOT_EMPTY,
+                            OPTIGA_SHELL_UART_IRQ_PRIORITY,
+                            true);
+    return (PAL_STATUS_SUCCESS);
+}
+
+static void optiga_shell_uart_port_released(void)
+{
+}
+
+/**
+ * Low power timer waking the core from the input wait once the timeout elapsed
+ */
+static cyhal_lptimer_t optiga_shell_uart_lptimer;
+static bool_t optiga_shell_uart_lptimer_ready = FALSE;
+
+static void optiga_shell_uart_port_wait(uint32_t timeout_ms)
+{
+    if ((OPTIGA_SHELL_UART_WAIT_FOREVER != timeout_ms) && (FALSE == optiga_shell_uart_lptimer_ready))
+    {
+        if (CY_RSLT_SUCCESS == cyhal_lptimer_init(&optiga_shell_uart_lptimer))
+        {
+            cyhal_lptimer_enable_event(&optiga_shell_uart_lptimer, CYHAL_LPTIMER_COMPARE_MATCH,
+                                       OPTIGA_SHELL_UART_IRQ_PRIORITY, true);
+            optiga_shell_uart_lptimer_ready = TRUE;
+        }
+    }
+    if ((OPTIGA_SHELL_UART_WAIT_FOREVER != timeout_ms) && (TRUE == optiga_shell_uart_lptimer_ready))
+    {
+        /*
+         * The timer runs from the 32768 Hz clock, the delay is limited to its 16 bit match range
+         */
+        timeout_ms = (timeout_ms > 1900U) ? 1900U : timeout_ms;
+        (void)cyhal_lptimer_set_delay(&optiga_shell_uart_lptimer, ((timeout_ms * 32768U) / 1000U) + 1U);
+    }
+
+    /*
+     * The check and the sleep must not be split by the interrupt: with interrupts masked a
+     * pending receive event still wakes the core, and its handler runs once they are unmasked.
+     */
+    __disable_irq();
+    if (TRUE == optiga_shell_uart_is_empty())
+    {
+        __WFI();
+    }
+    __enable_irq();
+}
+
+static pal_status_t optiga_shell_uart_port_write(const uint8_t * p_data, uint32_t length)
+{
+    size_t chunk_length;
+
+    while (0U < length)
+    {
+        chunk_length = length;
+        if (CY_RSLT_SUCCESS != cyhal_uart_write(&cy_retarget_io_uart_obj, (void *)p_data, &chunk_length))
+        {
+            return (PAL_STATUS_FAILURE);
+        }
+        p_data += chunk_length;
+        length -= (uint32_t)chunk_length;
+    }
+    return (PAL_STATUS_SUCCESS);
+}
+
+static bool_t optiga_shell_uart_port_is_closed(void)
+{
+    return (FALSE);
+}
+#endif
+
+pal_status_t optiga_shell_uart_init(void)
+{
+    pal_status_t status = PAL_STATUS_SUCCESS;
+
+    if (FALSE == optiga_shell_uart_started)
+    {
+        status = optiga_shell_uart_port_start();
+        optiga_shell_uart_started = (PAL_STATUS_SUCCESS == status) ? TRUE : FALSE;
+    }
+    return (status);
+}
+
+bool_t optiga_shell_uart_read(uint8_t * p_data)
+{
+    uint32_t tail = optiga_shell_uart_rx_tail;
+
+    if (TRUE == optiga_shell_uart_is_empty())
+    {
+        return (FALSE);
+    }
+    *p_data = optiga_shell_uart_rx_buffer[tail & OPTIGA_SHELL_UART_RX_BUFFER_MASK];
+    __atomic_store_n(&optiga_shell_uart_rx_tail, tail + 1U, __ATOMIC_RELEASE);
+    optiga_shell_uart_port_released();
+    return (TRUE);
+}
+
+uint32_t optiga_shell_uart_read_block(uint8_t * p_data, uint32_t max_length)
+{
+    uint32_t tail = optiga_shell_uart_rx_tail;
+    uint32_t available = __atomic_load_n(&optiga_shell_uart_rx_head, __ATOMIC_ACQUIRE) - tail;
+    uint32_t length = (available < max_length) ? available : max_length;
+    uint32_t first_length = OPTIGA_SHELL_UART_RX_BUFFER_SIZE - (tail & OPTIGA_SHELL_UART_RX_BUFFER_MASK);
+
+    if (0U == length)
+    {
+        return (0U);
+    }
+    /*
+     * The bytes may wrap around the end of the ring
+     */
+    first_length = (first_length < length) ? first_length : length;
+    memcpy(p_data, &optiga_shell_uart_rx_buffer[tail & OPTIGA_SHELL_UART_RX_BUFFER_MASK], first_length);
+    memcpy(&p_data[first_length], optiga_shell_uart_rx_buffer, length - first_length);
+    __atomic_store_n(&optiga_shell_uart_rx_tail, tail + length, __ATOMIC_RELEASE);
+    optiga_shell_uart_port_released();
+    return (length);
+}
+
+bool_t optiga_shell_uart_peek(uint8_t * p_data)
+{
+    if (TRUE == optiga_shell_uart_is_empty())
+    {
+        return (FALSE);
+    }
+    *p_data = optiga_shell_uart_rx_buffer[optiga_shell_uart_rx_tail & OPTIGA_SHELL_UART_RX_BUFFER_MASK];
+    return (TRUE);
+}
+
+void optiga_shell_uart_wait(void)
+{
+    optiga_shell_uart_port_wait(OPTIGA_SHELL_UART_WAIT_FOREVER);
+}
+
+void optiga_shell_uart_wait_timeout(uint32_t timeout_ms)
+{
+    optiga_shell_uart_port_wait(timeout_ms);
+}
+
+bool_t optiga_shell_uart_is_closed(void)
+{
+    return (((TRUE == optiga_shell_uart_port_is_closed()) && (TRUE == optiga_shell_uart_is_empty())) ? TRUE : FALSE);
+}
+
+pal_status_t optiga_shell_uart_write(const uint8_t * p_data, uint32_t length)
+{
+    return (optiga_shell_uart_port_write(p_data, length));
+}
+
+uint32_t optiga_shell_uart_get_overflow_count(void)
+{
+    return (__atomic_load_n(&optiga_shell_uart_overflow_count, __ATOMIC_RELAXED));
+}
@@ -0,0 +1,146 @@
+/******************************************************************************
+* File Name:   optiga_shell_uart.h
+*
+* Description: Interrupt driven receive ring of the shell console UART
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_UART_H_
+#define _OPTIGA_SHELL_UART_H_
+
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga/pal/pal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Size of the receive ring in bytes, must be a power of two */
+#ifndef OPTIGA_SHELL_UART_RX_BUFFER_SIZE
+#define OPTIGA_SHELL_UART_RX_BUFFER_SIZE    (1024U)
+#endif
+
+/** @brief Interrupt priority of the debug UART receive event */
+#ifndef OPTIGA_SHELL_UART_IRQ_PRIORITY
+#define OPTIGA_SHELL_UART_IRQ_PRIORITY      (3U)
+#endif
+
+/**
+ * @brief Starts the interrupt driven reception on the debug UART.
+ *
+ * Every received byte is put into a single producer, single consumer ring by the UART
+ * interrupt, so no byte is lost while the shell executes an example. Calling it again
+ * once the reception runs has no effect.
+ *
+ * @retval PAL_STATUS_SUCCESS  The reception is running
+ * @retval PAL_STATUS_FAILURE  The UART event could not be registered
+ */
+pal_status_t optiga_shell_uart_init(void);
+
+/**
+ * @brief Takes the oldest received byte from the ring without blocking.
+ *
+ * @param[out] p_data  Received byte
+ *
+ * @retval TRUE   A byte was taken
+ * @retval FALSE  The ring is empty
+ */
+bool_t optiga_shell_uart_read(uint8_t * p_data);
+
+/**
+ * @brief Takes up to max_length received bytes from the ring without blocking.
+ * Meant for bulk input such as optiga --hashstream, where a call per byte would cost more
+ * than the copy.
+ * @param[out] p_data      Received bytes
+ * @param[in]  max_length  Size of p_data
+ * @return Number of bytes taken, 0 if the ring is empty
+ */
+uint32_t optiga_shell_uart_read_block(uint8_t * p_data, uint32_t max_length);
+
+/**
+ * @brief Returns the oldest received byte without taking it from the ring.
+ * @param[out] p_data  Received byte
+ * @retval TRUE   A byte is available
+ * @retval FALSE  The ring is empty
+ */
+bool_t optiga_shell_uart_peek(uint8_t * p_data);
+
+/**
+ * @brief Puts the core to sleep until a byte is received.
+ *
+ * Returns immediately if the ring is not empty or the input is closed.
+ */
+void optiga_shell_uart_wait(void);
+
+/** @brief Timeout of #optiga_shell_uart_wait_timeout which never elapses */
+#define OPTIGA_SHELL_UART_WAIT_FOREVER      (0xFFFFFFFFU)
+
+/**
+ * @brief Puts the core to sleep until a byte is received or the timeout elapsed.
+ *
+ * Returns immediately if the ring is not empty or the input is closed. It may return early,
+ * the caller checks its deadline again.
+ *
+ * @param[in] timeout_ms  Longest sleep in milliseconds, #OPTIGA_SHELL_UART_WAIT_FOREVER for none
+ */
+void optiga_shell_uart_wait_timeout(uint32_t timeout_ms);
+
+/**
+ * @brief Tells whether the input is closed and the ring is drained.
+ *
+ * Only the host build has an input stream that ends; the debug UART never closes.
+ */
+bool_t optiga_shell_uart_is_closed(void);
+
+/**
+ * @brief Sends raw bytes on the console, including bytes the logger cannot carry such as 0x00.
+ *
+ * @retval PAL_STATUS_SUCCESS  All bytes were sent
+ * @retval PAL_STATUS_FAILURE  The transmission failed
+ */
+pal_status_t optiga_shell_uart_write(const uint8_t * p_data, uint32_t length);
+
+/**
+ * @brief Number of bytes dropped since start because the ring was full.
+ */
+uint32_t optiga_shell_uart_get_overflow_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_UART_H_ */
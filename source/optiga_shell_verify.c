@@ -0,0 +1,449 @@
+/******************************************************************************
+* File Name:   optiga_shell_verify.c
+*
+* Description: Verification of signatures on the host or on OPTIGA
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+
+#include "mbedtls/pk.h"
+#include "optiga/common/optiga_lib_logger.h"
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_pool.h"
+#include "optiga_shell_request.h"
+#include "optiga_shell_verify.h"
+
+#define OPTIGA_SHELL_VERIFY_SEQUENCE_TAG        (0x30U)
+/** @brief Shortest content length needing the long form of a DER length */
+#define OPTIGA_SHELL_VERIFY_DER_LONG_LENGTH     (0x80U)
+/** @brief Longest AlgorithmIdentifier of #optiga_shell_verify_algorithms */
+#define OPTIGA_SHELL_VERIFY_MAX_ALGORITHM_LENGTH    (22U)
+/** @brief Longest ECDSA signature, R and S of P-521 as DER INTEGERs */
+#define OPTIGA_SHELL_VERIFY_MAX_ECDSA_LENGTH    (139U)
+/** @brief Tag and up to three length bytes of a DER SEQUENCE */
+#define OPTIGA_SHELL_VERIFY_SEQUENCE_HEADER     (4U)
+
+#define OPTIGA_SHELL_VERIFY_ALGORITHM_ECDSA     (0U)
+#define OPTIGA_SHELL_VERIFY_ALGORITHM_RSA       (1U)
+
+/** @brief AlgorithmIdentifier of a SubjectPublicKeyInfo, per key type of OPTIGA */
+typedef struct optiga_shell_verify_algorithm
+{
+    uint8_t key_type;
+    uint8_t length;
+    uint8_t identifier[OPTIGA_SHELL_VERIFY_MAX_ALGORITHM_LENGTH];
+} optiga_shell_verify_algorithm_t;
+
+/** @brief A signature of optiga --verifybench */
+typedef struct optiga_shell_verify_vector
+{
+    const char_t * p_name;
+    uint8_t algorithm;
+    const uint8_t * p_public_key;
+    uint16_t public_key_length;
+    uint8_t key_type;
+    const uint8_t * p_digest;
+    uint8_t digest_length;
+    const uint8_t * p_signature;
+    uint16_t signature_length;
+} optiga_shell_verify_vector_t;
+
+/**
+ * id-ecPublicKey with the named curve, rsaEncryption with NULL parameters. mbedTLS takes public
+ * keys as SubjectPublicKeyInfo, which is this followed by the BIT STRING of OPTIGA.
+ */
+static const optiga_shell_verify_algorithm_t optiga_shell_verify_algorithms[] =
+{
+    {OPTIGA_ECC_CURVE_NIST_P_256, 21, {0x30, 0x13, 0x06, 0x07, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01,
+                                       0x06, 0x08, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x03, 0x01, 0x07}},
+    {OPTIGA_ECC_CURVE_NIST_P_384, 18, {0x30, 0x10, 0x06, 0x07, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01,
+                                       0x06, 0x05, 0x2B, 0x81, 0x04, 0x00, 0x22}},
+    {OPTIGA_ECC_CURVE_NIST_P_521, 18, {0x30, 0x10, 0x06, 0x07, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01,
+                                       0x06, 0x05, 0x2B, 0x81, 0x04, 0x00, 0x23}},
+    {OPTIGA_ECC_CURVE_BRAIN_POOL_P_256R1, 22, {0x30, 0x14, 0x06, 0x07, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01,
+                                               0x06, 0x09, 0x2B, 0x24, 0x03, 0x03, 0x02, 0x08, 0x01, 0x01, 0x07}},
+    {OPTIGA_ECC_CURVE_BRAIN_POOL_P_384R1, 22, {0x30, 0x14, 0x06, 0x07, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01,
+                                               0x06, 0x09, 0x2B, 0x24, 0x03, 0x03, 0x02, 0x08, 0x01, 0x01, 0x0B}},
+    {OPTIGA_ECC_CURVE_BRAIN_POOL_P_512R1, 22, {0x30, 0x14, 0x06, 0x07, 0x2A, 0x86, 0x48, 0xCE, 0x3D, 0x02, 0x01,
+                                               0x06, 0x09, 0x2B, 0x24, 0x03, 0x03, 0x02, 0x08, 0x01, 0x01, 0x0D}},
+    {OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL, 15, {0x30, 0x0D, 0x06, 0x09, 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01,
+                                               0x01, 0x01, 0x05, 0x00}},
+    {OPTIGA_RSA_KEY_2048_BIT_EXPONENTIAL, 15, {0x30, 0x0D, 0x06, 0x09, 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01,
+                                               0x01, 0x01, 0x05, 0x00}},
+};
+
+/**
+ * Key, digest and signature of example_optiga_crypt_ecdsa_verify, the key as BIT STRING
+ */
+static const uint8_t optiga_shell_verify_ecc_public_key[] =
+{
+    0x03, 0x42, 0x00, 0x04,
+    0x8B, 0x88, 0x9C, 0x1D, 0xD6, 0x07, 0x58, 0x2E, 0xD6, 0xF8, 0x2C, 0xC2, 0xD9, 0xBE, 0xD0, 0xFE,
+    0x64, 0xF3, 0x24, 0x5E, 0x94, 0x7D, 0x54, 0xCD, 0x20, 0xDC, 0x58, 0x98, 0xCF, 0x51, 0x31, 0x44,
+    0x22, 0xEA, 0x01, 0xD4, 0x0B, 0x23, 0xB2, 0x45, 0x7C, 0x42, 0xDF, 0x3C, 0xFB, 0x0D, 0x33, 0x10,
+    0xB8, 0x49, 0xB7, 0xAA, 0x0A, 0x85, 0xDE, 0xE7, 0x6A, 0xF1, 0xAC, 0x31, 0x31, 0x1E, 0x8C, 0x4B,
+};
+
+static const uint8_t optiga_shell_verify_ecc_digest[] =
+{
+    0xE9, 0x5F, 0xB3, 0xB1, 0x9F, 0xA4, 0xDD, 0x27, 0xFE, 0xAE, 0xB3, 0x33, 0x40, 0x80, 0xCE, 0x35,
+    0xDF, 0x3E, 0x08, 0xF1, 0x6F, 0x36, 0xF3, 0x24, 0x0E, 0xB0, 0xB3, 0x2F, 0xAB, 0xD0, 0x90, 0xCA,
+};
+
+static const uint8_t optiga_shell_verify_ecc_signature[] =
+{
+    0x02, 0x20,
+    0x39, 0xA4, 0x70, 0xE9, 0x32, 0x30, 0xF5, 0x5F, 0xA4, 0xDF, 0x8A, 0x07, 0x36, 0x58, 0x65, 0xC6,
+    0xE6, 0x1B, 0x07, 0x51, 0xFB, 0xC6, 0x16, 0x05, 0xEB, 0xDF, 0x56, 0x6D, 0xA9, 0x50, 0x3B, 0x24,
+    0x02, 0x1E,
+    0x49, 0x33, 0x6C, 0x07, 0x2B, 0xD0, 0x40, 0x20, 0x0F, 0xD4, 0xE0, 0x7E, 0x67, 0x66, 0xC4, 0xF5,
+    0x7F, 0x98, 0xEC, 0x38, 0xB8, 0xEF, 0x44, 0x8F, 0x6A, 0xE1, 0xFD, 0x1E, 0x92, 0xB4,
+};
+
+/**
+ * Key, digest and signature of example_optiga_crypt_rsa_verify, the key as BIT STRING of
+ * SEQUENCE {INTEGER modulus, INTEGER exponent}
+ */
+static const uint8_t optiga_shell_verify_rsa_public_key[] =
+{
+    0x03, 0x81, 0x8D, 0x00, 0x30, 0x81, 0x89, 0x02, 0x81, 0x81, 0x00,
+    0xA1, 0xD4, 0x6F, 0xBA, 0x23, 0x18, 0xF8, 0xDC, 0xEF, 0x16, 0xC2, 0x80, 0x94, 0x8B, 0x1C, 0xF2,
+    0x79, 0x66, 0xB9, 0xB4, 0x72, 0x25, 0xED, 0x29, 0x89, 0xF8, 0xD7, 0x4B, 0x45, 0xBD, 0x36, 0x04,
+    0x9C, 0x0A, 0xAB, 0x5A, 0xD0, 0xFF, 0x00, 0x35, 0x53, 0xBA, 0x84, 0x3C, 0x8E, 0x12, 0x78, 0x2F,
+    0xC5, 0x87, 0x3B, 0xB8, 0x9A, 0x3D, 0xC8, 0x4B, 0x88, 0x3D, 0x25, 0x66, 0x6C, 0xD2, 0x2B, 0xF3,
+    0xAC, 0xD5, 0xB6, 0x75, 0x96, 0x9F, 0x8B, 0xEB, 0xFB, 0xCA, 0xC9, 0x3F, 0xDD, 0x92, 0x7C, 0x74,
+    0x42, 0xB1, 0x78, 0xB1, 0x0D, 0x1D, 0xFF, 0x93, 0x98, 0xE5, 0x23, 0x16, 0xAA, 0xE0, 0xAF, 0x74,
+    0xE5, 0x94, 0x65, 0x0B, 0xDC, 0x3C, 0x67, 0x02, 0x41, 0xD4, 0x18, 0x68, 0x45, 0x93, 0xCD, 0xA1,
+    0xA7, 0xB9, 0xDC, 0x4F, 0x20, 0xD2, 0xFD, 0xC6, 0xF6, 0x63, 0x44, 0x07, 0x40, 0x03, 0xE2, 0x11,
+    0x02, 0x03, 0x01, 0x00, 0x01,
+};
+
+static const uint8_t optiga_shell_verify_rsa_digest[] =
+{
+    0x91, 0x70, 0x02, 0x48, 0x3F, 0xBD, 0x5F, 0xDD, 0xD5, 0x38, 0xEB, 0xDA, 0x9A, 0x5E, 0x1F, 0x46,
+    0xFC, 0xAD, 0x8F, 0x1E, 0x2C, 0x75, 0xB0, 0x83, 0xD0, 0x71, 0x2B, 0x80, 0xD4, 0xAA, 0xC6, 0x9B,
+};
+
+static const uint8_t optiga_shell_verify_rsa_signature[] =
+{
+    0x5B, 0xDE, 0x46, 0xE4, 0x35, 0x48, 0xF4, 0x81, 0x45, 0x7C, 0x72, 0x31, 0x54, 0x55, 0xE8, 0x9F,
+    0x1D, 0xD0, 0x5D, 0x9D, 0xEC, 0x40, 0xE6, 0x6B, 0x89, 0xF3, 0xBC, 0x52, 0x68, 0xB1, 0xD8, 0x70,
+    0x35, 0x05, 0xFC, 0x98, 0xF6, 0x36, 0x99, 0x24, 0x53, 0xF0, 0x17, 0xB8, 0x9B, 0xD4, 0xA0, 0x5F,
+    0x12, 0x04, 0x8A, 0xA1, 0xA7, 0x96, 0xE6, 0x33, 0xCA, 0x48, 0x84, 0xD9, 0x00, 0xE4, 0xA3, 0x8E,
+    0x2F, 0x6F, 0x3F, 0x6D, 0xE0, 0x1D, 0xF8, 0xEA, 0xE0, 0x95, 0xBA, 0x63, 0x15, 0xED, 0x7B, 0x6A,
+    0xB6, 0x6E, 0x20, 0x17, 0xB5, 0x64, 0xDE, 0x49, 0x64, 0x97, 0xCA, 0x5E, 0x4D, 0x84, 0x63, 0xA0,
+    0xF1, 0x00, 0x6C, 0xEE, 0x70, 0x89, 0xD5, 0x6E, 0xC5, 0x05, 0x31, 0x0D, 0xAA, 0xB7, 0xBA, 0xA0,
+    0xAA, 0xBF, 0x98, 0xE8, 0x39, 0x93, 0x70, 0x07, 0x2D, 0xFF, 0x42, 0xF9, 0xA4, 0x6F, 0x1B, 0x00,
+};
+
+static const optiga_shell_verify_vector_t optiga_shell_verify_vectors[] =
+{
+    {"ecdsa_p256", OPTIGA_SHELL_VERIFY_ALGORITHM_ECDSA,
+     optiga_shell_verify_ecc_public_key, sizeof(optiga_shell_verify_ecc_public_key), OPTIGA_ECC_CURVE_NIST_P_256,
+     optiga_shell_verify_ecc_digest, sizeof(optiga_shell_verify_ecc_digest),
+     optiga_shell_verify_ecc_signature, sizeof(optiga_shell_verify_ecc_signature)},
+    {"rsa1024_sha256", OPTIGA_SHELL_VERIFY_ALGORITHM_RSA,
+     optiga_shell_verify_rsa_public_key, sizeof(optiga_shell_verify_rsa_public_key),
+     OPTIGA_RSA_KEY_1024_BIT_EXPONENTIAL,
+     optiga_shell_verify_rsa_digest, sizeof(optiga_shell_verify_rsa_digest),
+     optiga_shell_verify_rsa_signature, sizeof(optiga_shell_verify_rsa_signature)},
+};
+
+static optiga_shell_request_t optiga_shell_verify_request;
+/** @brief SubjectPublicKeyInfo and ECDSA-Sig-Value given to mbedTLS */
+static uint8_t optiga_shell_verify_key_info[OPTIGA_SHELL_VERIFY_SEQUENCE_HEADER + OPTIGA_SHELL_VERIFY_MAX_ALGORITHM_LENGTH +
+                                            OPTIGA_SHELL_VERIFY_MAX_PUBLIC_KEY_LENGTH];
+static uint8_t optiga_shell_verify_sequence[OPTIGA_SHELL_VERIFY_SEQUENCE_HEADER + OPTIGA_SHELL_VERIFY_MAX_ECDSA_LENGTH];
+/** @brief Signature of the running vector of optiga --verifybench, tampered with on the second run */
+static uint8_t optiga_shell_verify_signature[sizeof(optiga_shell_verify_rsa_signature)];
+
+/**
+ * Writes a DER SEQUENCE header for the content length into the buffer and returns its length
+ */
+static uint16_t optiga_shell_verify_sequence_header(uint8_t * p_buffer, uint16_t content_length)
+{
+    p_buffer[0] = OPTIGA_SHELL_VERIFY_SEQUENCE_TAG;
+    if (content_length < OPTIGA_SHELL_VERIFY_DER_LONG_LENGTH)
+    {
+        p_buffer[1] = (uint8_t)content_length;
+        return (2U);
+    }
+    if (content_length <= 0xFFU)
+    {
+        p_buffer[1] = OPTIGA_SHELL_VERIFY_DER_LONG_LENGTH | 1U;
+        p_buffer[2] = (uint8_t)content_length;
+        return (3U);
+    }
+    p_buffer[1] = OPTIGA_SHELL_VERIFY_DER_LONG_LENGTH | 2U;
+    p_buffer[2] = (uint8_t)(content_length >> 8);
+    p_buffer[3] = (uint8_t)content_length;
+    return (4U);
+}
+
+/**
+ * Parses the public key of OPTIGA format into the mbedTLS context, as SubjectPublicKeyInfo
+ */
+static optiga_lib_status_t optiga_shell_verify_parse_public_key(mbedtls_pk_context * p_context,
+                                                                const public_key_from_host_t * p_public_key)
+{
+    const optiga_shell_verify_algorithm_t * p_algorithm = NULL;
+    uint16_t length;
+    uint8_t index;
+
+    for (index = 0; index < (sizeof(optiga_shell_verify_algorithms) / sizeof(optiga_shell_verify_algorithms[0])); index++)
+    {
+        if (p_public_key->key_type == optiga_shell_verify_algorithms[index].key_type)
+        {
+            p_algorithm = &optiga_shell_verify_algorithms[index];
+            break;
+        }
+    }
+    if (NULL == p_algorithm)
+    {
+        return (OPTIGA_SHELL_VERIFY_ERROR_PUBLIC_KEY);
+    }
+    if (p_public_key->length > OPTIGA_SHELL_VERIFY_MAX_PUBLIC_KEY_LENGTH)
+    {
+        return (OPTIGA_SHELL_VERIFY_ERROR_LENGTH);
+    }
+
+    length = optiga_shell_verify_sequence_header(optiga_shell_verify_key_info,
+                                                 (uint16_t)(p_algorithm->length + p_public_key->length));
+    memcpy(&optiga_shell_verify_key_info[length], p_algorithm->identifier, p_algorithm->length);
+    length += p_algorithm->length;
+    memcpy(&optiga_shell_verify_key_info[length], p_public_key->public_key, p_public_key->length);
+    length += p_public_key->length;
+
+    if (0 != mbedtls_pk_parse_public_key(p_context, optiga_shell_verify_key_info, length))
+    {
+        return (OPTIGA_SHELL_VERIFY_ERROR_PUBLIC_KEY);
+    }
+    return (OPTIGA_LIB_SUCCESS);
+}
+
+static optiga_lib_status_t optiga_shell_verify_host(mbedtls_md_type_t md_type,
+                                                    const uint8_t * p_digest,
+                                                    uint8_t digest_length,
+                                                    const uint8_t * p_signature,
+                                                    uint16_t signature_length,
+                                                    const public_key_from_host_t * p_public_key)
+{
+    optiga_lib_status_t return_status;
+    mbedtls_pk_context context;
+
+    mbedtls_pk_init(&context);
+    do
+    {
+        return_status = optiga_shell_verify_parse_public_key(&context, p_public_key);
+        if (OPTIGA_LIB_SUCCESS != return_status)
+        {
+            break;
+        }
+        if (0 != mbedtls_pk_verify(&context, md_type, p_digest, digest_length, p_signature, signature_length))
+        {
+            return_status = OPTIGA_SHELL_VERIFY_ERROR_SIGNATURE;
+        }
+    } while (FALSE);
+    mbedtls_pk_free(&context);
+    return (return_status);
+}
+
+optiga_lib_status_t optiga_shell_verify_ecdsa(const uint8_t * p_digest,
+                                              uint8_t digest_length,
+                                              const uint8_t * p_signature,
+                                              uint16_t signature_length,
+                                              const public_key_from_host_t * p_public_key,
+                                              uint8_t engine)
+{
+    optiga_lib_status_t return_status;
+    optiga_crypt_t * me;
+    uint16_t header_length;
+
+    if (OPTIGA_SHELL_VERIFY_ENGINE_OPTIGA == engine)
+    {
+        me = optiga_shell_pool_get_crypt(&optiga_shell_verify_request);
+        if (NULL == me)
+        {
+            return (OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT);
+        }
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_verify_request,
+                                                 optiga_crypt_ecdsa_verify(me, p_digest, digest_length,
+                                                                           p_signature, signature_length,
+                                                                           OPTIGA_CRYPT_HOST_DATA, p_public_key));
+        (void)optiga_shell_pool_put_crypt(me);
+        return (return_status);
+    }
+
+    /*
+     * mbedTLS takes the ECDSA-Sig-Value, the INTEGERs of OPTIGA in a SEQUENCE. The digest goes
+     * in as is, like on OPTIGA it is not bound to a hash algorithm.
+     */
+    if (signature_length > OPTIGA_SHELL_VERIFY_MAX_ECDSA_LENGTH)
+    {
+        return (OPTIGA_SHELL_VERIFY_ERROR_LENGTH);
+    }
+    header_length = optiga_shell_verify_sequence_header(optiga_shell_verify_sequence, signature_length);
+    memcpy(&optiga_shell_verify_sequence[header_length], p_signature, signature_length);
+    return (optiga_shell_verify_host(MBEDTLS_MD_NONE, p_digest, digest_length, optiga_shell_verify_sequence,
+                                     (uint16_t)(header_length + signature_length), p_public_key));
+}
+
+optiga_lib_status_t optiga_shell_verify_rsa(optiga_rsa_signature_scheme_t scheme,
+                                            const uint8_t * p_digest,
+                                            uint8_t digest_length,
+                                            const uint8_t * p_signature,
+                                            uint16_t signature_length,
+                                            const public_key_from_host_t * p_public_key,
+                                            uint8_t engine)
+{
+    optiga_lib_status_t return_status;
+    optiga_crypt_t * me;
+    mbedtls_md_type_t md_type;
+
+    if (OPTIGA_SHELL_VERIFY_ENGINE_OPTIGA == engine)
+    {
+        me = optiga_shell_pool_get_crypt(&optiga_shell_verify_request);
+        if (NULL == me)
+        {
+            return (OPTIGA_CRYPT_ERROR_MEMORY_INSUFFICIENT);
+        }
+        return_status = OPTIGA_SHELL_REQUEST_RUN(optiga_shell_verify_request,
+                                                 optiga_crypt_rsa_verify(me, scheme, p_digest, digest_length,
+                                                                         p_signature, signature_length,
+                                                                         OPTIGA_CRYPT_HOST_DATA, p_public_key, 0));
+        (void)optiga_shell_pool_put_crypt(me);
+        return (return_status);
+    }
+
+    switch (scheme)
+    {
+        case OPTIGA_RSASSA_PKCS1_V15_SHA384:
+            md_type = MBEDTLS_MD_SHA384;
+            break;
+        case OPTIGA_RSASSA_PKCS1_V15_SHA512:
+            md_type = MBEDTLS_MD_SHA512;
+            break;
+        default:
+            md_type = MBEDTLS_MD_SHA256;
+            break;
+    }
+    return (optiga_shell_verify_host(md_type, p_digest, digest_length, p_signature, signature_length, p_public_key));
+}
+
+/**
+ * Verifies the signature of the vector in optiga_shell_verify_signature on one engine the given
+ * number of times and returns the average time and the status of the last run
+ */
+static optiga_lib_status_t optiga_shell_verify_time(const optiga_shell_verify_vector_t * p_vector, uint8_t engine,
+                                                    uint32_t iterations, uint32_t * p_average_us)
+{
+    optiga_lib_status_t return_status = OPTIGA_LIB_SUCCESS;
+    public_key_from_host_t public_key;
+    uint32_t total_us = 0;
+    uint32_t start_us;
+    uint32_t index;
+
+    public_key.public_key = (uint8_t *)p_vector->p_public_key;
+    public_key.length = p_vector->public_key_length;
+    public_key.key_type = p_vector->key_type;
+    for (index = 0; index < iterations; index++)
+    {
+        start_us = pal_os_timer_get_time_in_microseconds();
+        if (OPTIGA_SHELL_VERIFY_ALGORITHM_ECDSA == p_vector->algorithm)
+        {
+            return_status = optiga_shell_verify_ecdsa(p_vector->p_digest, p_vector->digest_length,
+                                                      optiga_shell_verify_signature, p_vector->signature_length,
+                                                      &public_key, engine);
+        }
+        else
+        {
+            return_status = optiga_shell_verify_rsa(OPTIGA_RSASSA_PKCS1_V15_SHA256, p_vector->p_digest,
+                                                    p_vector->digest_length, optiga_shell_verify_signature,
+                                                    p_vector->signature_length, &public_key, engine);
+        }
+        total_us += pal_os_timer_get_time_in_microseconds() - start_us;
+    }
+    *p_average_us = total_us / iterations;
+    return (return_status);
+}
+
+void optiga_shell_cmd_verifybench(optiga_shell_args_t * p_args)
+{
+    static const char_t * const signature_names[] = {"valid", "tampered"};
+    const optiga_shell_verify_vector_t * p_vector;
+    optiga_lib_status_t host_status;
+    optiga_lib_status_t optiga_status;
+    uint32_t iterations;
+    uint32_t host_us;
+    uint32_t optiga_us;
+    uint32_t index;
+    uint32_t tampered;
+    char_t line[120];
+
+    if ((FALSE == optiga_shell_args_get_number(p_args, "iterations", OPTIGA_SHELL_VERIFY_BENCH_ITERATIONS, 1,
+                                               OPTIGA_SHELL_VERIFY_BENCH_MAX_ITERATIONS, &iterations)) ||
+        (FALSE == optiga_shell_args_all_used(p_args)))
+    {
+        return;
+    }
+
+    optiga_lib_print_string_with_newline("algorithm,signature,host_us,optiga_us,faster,host_status,optiga_status,"
+                                         "engines_agree");
+    for (index = 0; index < (sizeof(optiga_shell_verify_vectors) / sizeof(optiga_shell_verify_vectors[0])); index++)
+    {
+        p_vector = &optiga_shell_verify_vectors[index];
+        for (tampered = 0; tampered < 2U; tampered++)
+        {
+            /*
+             * The tampered signature differs in its last byte, an ECDSA one stays well-formed
+             */
+            memcpy(optiga_shell_verify_signature, p_vector->p_signature, p_vector->signature_length);
+            optiga_shell_verify_signature[p_vector->signature_length - 1U] ^= (uint8_t)tampered;
+
+            host_status = optiga_shell_verify_time(p_vector, OPTIGA_SHELL_VERIFY_ENGINE_HOST, iterations, &host_us);
+            optiga_status = optiga_shell_verify_time(p_vector, OPTIGA_SHELL_VERIFY_ENGINE_OPTIGA, iterations,
+                                                     &optiga_us);
+            snprintf(line, sizeof(line), "%s,%s,%lu,%lu,%s,0x%04X,0x%04X,%s", p_vector->p_name,
+                     signature_names[tampered], (unsigned long)host_us, (unsigned long)optiga_us,
+                     (host_us <= optiga_us) ? "host" : "optiga", (unsigned int)host_status,
+                     (unsigned int)optiga_status, (host_status == optiga_status) ? "yes" : "no");
+            optiga_lib_print_string_with_newline(line);
+        }
+    }
+}
@@ -0,0 +1,149 @@
+/******************************************************************************
+* File Name:   optiga_shell_verify.h
+*
+* Description: Verification of signatures on the host or on OPTIGA
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_VERIFY_H_
+#define _OPTIGA_SHELL_VERIFY_H_
+
+#include "optiga/optiga_crypt.h"
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga/common/optiga_lib_return_codes.h"
+#include "optiga_shell_args.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Engines of #optiga_shell_verify_ecdsa and #optiga_shell_verify_rsa */
+/// mbedTLS on the host core, the PSoC6 crypto block where mbedTLS is accelerated by it
+#define OPTIGA_SHELL_VERIFY_ENGINE_HOST         (0U)
+/// OPTIGA, the verification queues behind all other commands to the chip
+#define OPTIGA_SHELL_VERIFY_ENGINE_OPTIGA       (1U)
+
+/**
+ * @brief Engine verifying signatures with a public key from the host, unless a command selects
+ * one. A verification needs no secret, so it is kept off the I2C link by default.
+ */
+#ifndef OPTIGA_SHELL_VERIFY_DEFAULT_ENGINE
+#define OPTIGA_SHELL_VERIFY_DEFAULT_ENGINE      OPTIGA_SHELL_VERIFY_ENGINE_HOST
+#endif
+
+/** @brief Longest public key in the BIT STRING format of OPTIGA, an RSA 2048 key */
+#define OPTIGA_SHELL_VERIFY_MAX_PUBLIC_KEY_LENGTH   (300U)
+
+/** @brief The signature does not match, the same status as of OPTIGA */
+#define OPTIGA_SHELL_VERIFY_ERROR_SIGNATURE     (OPTIGA_DEVICE_ERROR | 0x002B)
+/** @brief The host does not know the key type or could not parse the public key */
+#define OPTIGA_SHELL_VERIFY_ERROR_PUBLIC_KEY    (0xF401)
+/** @brief The public key or signature is longer than the host engine takes */
+#define OPTIGA_SHELL_VERIFY_ERROR_LENGTH        (0xF402)
+
+/** @brief Default and largest number of runs per vector and engine of optiga --verifybench */
+#define OPTIGA_SHELL_VERIFY_BENCH_ITERATIONS        (5U)
+#define OPTIGA_SHELL_VERIFY_BENCH_MAX_ITERATIONS    (100U)
+
+/** @brief Argument usage of the verifybench command, as shown by help */
+#define OPTIGA_SHELL_VERIFY_BENCH_USAGE         "[--iterations <n>]"
+
+/**
+ * @brief Verifies an ECDSA signature with a public key from the host, like
+ * optiga_crypt_ecdsa_verify with #OPTIGA_CRYPT_HOST_DATA.
+ *
+ * Both engines take the signature and public key in the format of OPTIGA and return the same
+ * status for the same input.
+ *
+ * @param[in] p_digest          Digest which was signed
+ * @param[in] digest_length     Length of the digest
+ * @param[in] p_signature       The two DER INTEGERs R and S, without SEQUENCE
+ * @param[in] signature_length  Length of the signature
+ * @param[in] p_public_key      Public key as BIT STRING, key_type is the curve
+ * @param[in] engine            #OPTIGA_SHELL_VERIFY_ENGINE_HOST or #OPTIGA_SHELL_VERIFY_ENGINE_OPTIGA
+ *
+ * @retval #OPTIGA_LIB_SUCCESS                      The signature is valid
+ * @retval #OPTIGA_SHELL_VERIFY_ERROR_SIGNATURE     The signature is not valid
+ * @retval #OPTIGA_SHELL_VERIFY_ERROR_PUBLIC_KEY    The host could not use the public key
+ * @retval #OPTIGA_SHELL_VERIFY_ERROR_LENGTH        The input is too long for the host
+ * @retval Error of optiga_crypt otherwise
+ */
+optiga_lib_status_t optiga_shell_verify_ecdsa(const uint8_t * p_digest,
+                                              uint8_t digest_length,
+                                              const uint8_t * p_signature,
+                                              uint16_t signature_length,
+                                              const public_key_from_host_t * p_public_key,
+                                              uint8_t engine);
+
+/**
+ * @brief Verifies an RSA PKCS#1 v1.5 signature with a public key from the host, like
+ * optiga_crypt_rsa_verify with #OPTIGA_CRYPT_HOST_DATA.
+ *
+ * @param[in] scheme            Signature scheme, selects the hash algorithm of the digest
+ * @param[in] p_digest          Digest which was signed
+ * @param[in] digest_length     Length of the digest
+ * @param[in] p_signature       Signature, as long as the modulus
+ * @param[in] signature_length  Length of the signature
+ * @param[in] p_public_key      Public key as BIT STRING, key_type is the RSA key type
+ * @param[in] engine            #OPTIGA_SHELL_VERIFY_ENGINE_HOST or #OPTIGA_SHELL_VERIFY_ENGINE_OPTIGA
+ *
+ * @retval See #optiga_shell_verify_ecdsa
+ */
+optiga_lib_status_t optiga_shell_verify_rsa(optiga_rsa_signature_scheme_t scheme,
+                                            const uint8_t * p_digest,
+                                            uint8_t digest_length,
+                                            const uint8_t * p_signature,
+                                            uint16_t signature_length,
+                                            const public_key_from_host_t * p_public_key,
+                                            uint8_t engine);
+
+/**
+ * @brief Verifies ECDSA P-256 and RSA 1024 signatures of the verify examples on both engines
+ * --iterations times each, a valid and a tampered one per algorithm.
+ *
+ * Prints one CSV line per signature with the average time of each engine, the status of each
+ * engine and whether the engines agree.
+ *
+ * @param[in,out] p_args  Arguments of the command
+ */
+void optiga_shell_cmd_verifybench(optiga_shell_args_t * p_args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_VERIFY_H_ */
@@ -0,0 +1,186 @@
+/******************************************************************************
+* File Name:   optiga_shell_wait.c
+*
+* Description: Completion wait for asynchronous OPTIGA operations which lets the core
+*              sleep until the PAL event delivers the result
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#include <string.h>
+
+#include "optiga/pal/pal_os_timer.h"
+#include "optiga_shell_wait.h"
+
+#ifdef OPTIGA_HOST_SIMULATOR
+#include <pthread.h>
+#include <time.h>
+#else
+#include "cyhal.h"
+#endif
+
+static uint8_t optiga_shell_wait_mode = OPTIGA_SHELL_WAIT_SLEEP;
+static optiga_shell_wait_stats_t optiga_shell_wait_stats;
+
+#ifdef OPTIGA_HOST_SIMULATOR
+static pthread_mutex_t optiga_shell_wait_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t optiga_shell_wait_condition = PTHREAD_COND_INITIALIZER;
+
+static uint64_t optiga_shell_wait_cpu_time_us(void)
+{
+    struct timespec now;
+
+    (void)clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return (((uint64_t)now.tv_sec * 1000000U) + ((uint64_t)now.tv_nsec / 1000U));
+}
+
+/**
+ * Blocks on the condition signalled by the event thread after each callback. The status is
+ * checked under the lock, so a completion between the check and the wait is not missed.
+ * Returns the CPU time of the waiting thread, which is what it did not spend idle.
+ */
+static uint64_t optiga_shell_wait_port_sleep(volatile optiga_lib_status_t * p_status)
+{
+    uint64_t cpu_start_us = optiga_shell_wait_cpu_time_us();
+
+    pthread_mutex_lock(&optiga_shell_wait_lock);
+    while (OPTIGA_LIB_BUSY == *p_status)
+    {
+        (void)pthread_cond_wait(&optiga_shell_wait_condition, &optiga_shell_wait_lock);
+        if (OPTIGA_LIB_BUSY == *p_status)
+        {
+            optiga_shell_wait_stats.wakeups++;
+        }
+    }
+    pthread_mutex_unlock(&optiga_shell_wait_lock);
+    return (optiga_shell_wait_cpu_time_us() - cpu_start_us);
+}
+
+void optiga_shell_wait_notify(void)
+{
+    pthread_mutex_lock(&optiga_shell_wait_lock);
+    (void)pthread_cond_broadcast(&optiga_shell_wait_condition);
+    pthread_mutex_unlock(&optiga_shell_wait_lock);
+}
+#else
+/**
+ * Sleeps until the interrupt which completes the operation. The check and the sleep must not
+ * be split by that interrupt: with interrupts masked a pending interrupt still wakes the core,
+ * and its handler runs once they are unmasked. Returns the time the core was awake.
+ */
+static uint64_t optiga_shell_wait_port_sleep(volatile optiga_lib_status_t * p_status)
+{
+    uint32_t start_us = pal_os_timer_get_time_in_microseconds();
+    uint32_t sleep_start_us;
+    uint64_t sleep_us = 0;
+
+    while (TRUE)
+    {
+        __disable_irq();
+        if (OPTIGA_LIB_BUSY != *p_status)
+        {
+            __enable_irq();
+            break;
+        }
+        sleep_start_us = pal_os_timer_get_time_in_microseconds();
+        __WFI();
+        sleep_us += pal_os_timer_get_time_in_microseconds() - sleep_start_us;
+        __enable_irq();
+        if (OPTIGA_LIB_BUSY == *p_status)
+        {
+            optiga_shell_wait_stats.wakeups++;
+        }
+    }
+    return ((pal_os_timer_get_time_in_microseconds() - start_us) - sleep_us);
+}
+
+void optiga_shell_wait_notify(void)
+{
+}
+#endif
+
+void optiga_shell_wait_for_completion(volatile optiga_lib_status_t * p_status)
+{
+    uint32_t start_us = pal_os_timer_get_time_in_microseconds();
+    uint64_t busy_us;
+
+    if (OPTIGA_SHELL_WAIT_SPIN == optiga_shell_wait_mode)
+    {
+        while (OPTIGA_LIB_BUSY == *p_status)
+        {
+            /*
+             * Wait until the operation is completed
+             */
+        }
+        busy_us = pal_os_timer_get_time_in_microseconds() - start_us;
+    }
+    else
+    {
+        busy_us = optiga_shell_wait_port_sleep(p_status);
+    }
+
+    optiga_shell_wait_stats.waits++;
+    optiga_shell_wait_stats.wait_us += pal_os_timer_get_time_in_microseconds() - start_us;
+    optiga_shell_wait_stats.busy_us += busy_us;
+}
+
+void optiga_shell_wait_set_mode(uint8_t mode)
+{
+    optiga_shell_wait_mode = mode;
+}
+
+uint8_t optiga_shell_wait_get_mode(void)
+{
+    return (optiga_shell_wait_mode);
+}
+
+void optiga_shell_wait_take_stats(optiga_shell_wait_stats_t * p_stats)
+{
+    *p_stats = optiga_shell_wait_stats;
+    memset(&optiga_shell_wait_stats, 0, sizeof(optiga_shell_wait_stats));
+}
+
+uint64_t optiga_shell_wait_get_energy_nj(const optiga_shell_wait_stats_t * p_stats)
+{
+    uint64_t busy_us = (p_stats->busy_us < p_stats->wait_us) ? p_stats->busy_us : p_stats->wait_us;
+    uint64_t idle_us = p_stats->wait_us - busy_us;
+
+    /*
+     * mV * uA = nW, nW * us = 10^-6 nJ
+     */
+    return ((OPTIGA_SHELL_WAIT_SUPPLY_MV *
+             ((OPTIGA_SHELL_WAIT_ACTIVE_UA * busy_us) + (OPTIGA_SHELL_WAIT_SLEEP_UA * idle_us))) / 1000000U);
+}
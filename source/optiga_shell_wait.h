@@ -0,0 +1,131 @@
+/******************************************************************************
+* File Name:   optiga_shell_wait.h
+*
+* Description: Completion wait for asynchronous OPTIGA operations which lets the core
+*              sleep until the PAL event delivers the result
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+#ifndef _OPTIGA_SHELL_WAIT_H_
+#define _OPTIGA_SHELL_WAIT_H_
+
+#include "optiga/common/optiga_lib_common.h"
+#include "optiga/common/optiga_lib_return_codes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief The core sleeps until the completion (default) */
+#define OPTIGA_SHELL_WAIT_SLEEP             (0U)
+/** @brief The core polls the status, for comparison only */
+#define OPTIGA_SHELL_WAIT_SPIN              (1U)
+
+/**
+ * @brief Supply voltage and current of the core, to estimate the energy spent waiting.
+ *
+ * The defaults are rough figures for the CM4 of a PSoC 6 at 100 MHz, replace them with
+ * values measured on the board to get absolute numbers.
+ */
+#ifndef OPTIGA_SHELL_WAIT_SUPPLY_MV
+#define OPTIGA_SHELL_WAIT_SUPPLY_MV         (3300U)
+#endif
+#ifndef OPTIGA_SHELL_WAIT_ACTIVE_UA
+#define OPTIGA_SHELL_WAIT_ACTIVE_UA         (6000U)
+#endif
+#ifndef OPTIGA_SHELL_WAIT_SLEEP_UA
+#define OPTIGA_SHELL_WAIT_SLEEP_UA          (1500U)
+#endif
+
+/** @brief Time spent in #optiga_shell_wait_for_completion since the last reset */
+typedef struct optiga_shell_wait_stats
+{
+    /// Number of waits
+    uint32_t waits;
+    /// Number of times the core woke up without the operation being completed
+    uint32_t wakeups;
+    /// Time from the start to the end of the waits, in microseconds
+    uint64_t wait_us;
+    /// Part of wait_us the core was running, in microseconds
+    uint64_t busy_us;
+} optiga_shell_wait_stats_t;
+
+/**
+ * @brief Waits until the asynchronous operation tracking its status in p_status is completed.
+ *
+ * The status is set by the completion callback, which runs in the PAL event context (the
+ * timer interrupt of the MCU, the event thread of the host build). In the default
+ * #OPTIGA_SHELL_WAIT_SLEEP mode the core sleeps until an interrupt (WFI) or the host thread
+ * blocks until #optiga_shell_wait_notify, instead of polling the status at full power.
+ *
+ * @param[in] p_status  Status of the operation, #OPTIGA_LIB_BUSY while it runs
+ */
+void optiga_shell_wait_for_completion(volatile optiga_lib_status_t * p_status);
+
+/**
+ * @brief Wakes the waiters after a completion callback ran.
+ *
+ * Called by the PAL event context of the host build; not needed on the MCU, where the
+ * interrupt which runs the callback wakes the core.
+ */
+void optiga_shell_wait_notify(void);
+
+/**
+ * @brief Selects #OPTIGA_SHELL_WAIT_SLEEP or #OPTIGA_SHELL_WAIT_SPIN.
+ */
+void optiga_shell_wait_set_mode(uint8_t mode);
+
+/**
+ * @brief Returns the current wait mode.
+ */
+uint8_t optiga_shell_wait_get_mode(void);
+
+/**
+ * @brief Copies the statistics and resets them.
+ */
+void optiga_shell_wait_take_stats(optiga_shell_wait_stats_t * p_stats);
+
+/**
+ * @brief Estimates the energy of the core while waiting, in nanojoule.
+ */
+uint64_t optiga_shell_wait_get_energy_nj(const optiga_shell_wait_stats_t * p_stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _OPTIGA_SHELL_WAIT_H_ */